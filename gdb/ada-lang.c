@@ -62,6 +62,9 @@
 #include "ada-exp.h"
 #include "charset.h"
 #include "ax-gdb.h"
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 
 static struct type *desc_base_type (struct type *);
 
@@ -1650,6 +1653,120 @@ ada_decode_symbol (const struct general_symbol_info *arg)
   return *resultp;
 }
 
+/* Table mapping encoded names to their decoded form, used to avoid
+   re-running ada_decode on every comparison when a lookup name is
+   matched against many symbols.  Decoding is a pure function of the
+   encoded name, so entries are never invalidated; as with
+   decoded_names_store above, the memory is intentionally permanent.
+   Each entry is a single allocation holding the encoded name
+   followed by its decoded form.  */
+static htab_t decoded_name_cache;
+
+/* Hash function for decoded_name_cache.  */
+
+static hashval_t
+hash_decoded_name_entry (const void *p)
+{
+  return htab_hash_string ((const char *) p);
+}
+
+/* Equality function for decoded_name_cache.  KEY is the encoded name
+   being looked up.  */
+
+static int
+eq_decoded_name_entry (const void *entry, const void *key)
+{
+  return strcmp ((const char *) entry, (const char *) key) == 0;
+}
+
+/* Return the decoded form of ENCODED, as for ada_decode, but backed
+   by a cache so that decoding each distinct name happens only once.
+   The result is owned by the cache and is valid for the rest of the
+   session.  */
+
+static const char *
+ada_decode_cached (const char *encoded)
+{
+  if (decoded_name_cache == nullptr)
+    decoded_name_cache = htab_create_alloc (256, hash_decoded_name_entry,
+					    eq_decoded_name_entry, xfree,
+					    xcalloc, xfree);
+
+  void **slot = htab_find_slot (decoded_name_cache, encoded, INSERT);
+  if (*slot == nullptr)
+    {
+      std::string decoded = ada_decode (encoded);
+      size_t encoded_len = strlen (encoded);
+      char *entry = (char *) xmalloc (encoded_len + decoded.size () + 2);
+      memcpy (entry, encoded, encoded_len + 1);
+      memcpy (entry + encoded_len + 1, decoded.c_str (),
+	      decoded.size () + 1);
+      *slot = entry;
+    }
+
+  const char *entry = (const char *) *slot;
+  return entry + strlen (entry) + 1;
+}
+
+/* Table interning the no-wrap, no-operators decoded form of encoded
+   names, for the benefit of the DWARF indexer.  Index shards are
+   finalized on worker threads concurrently, so unlike the tables
+   above, which are only touched on the main thread, this one is
+   protected by a lock.  Entries are laid out as in
+   decoded_name_cache and, likewise, are never released.  */
+static htab_t interned_decoded_names;
+#if CXX_STD_THREAD
+static std::mutex interned_decoded_names_lock;
+#endif
+
+/* See ada-lang.h.  */
+
+const char *
+ada_decode_intern (const char *encoded)
+{
+  {
+#if CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (interned_decoded_names_lock);
+#endif
+    if (interned_decoded_names == nullptr)
+      interned_decoded_names = htab_create_alloc (256,
+						  hash_decoded_name_entry,
+						  eq_decoded_name_entry,
+						  xfree, xcalloc, xfree);
+    else
+      {
+	const char *entry
+	  = (const char *) htab_find (interned_decoded_names, encoded);
+	if (entry != nullptr)
+	  return entry + strlen (entry) + 1;
+      }
+  }
+
+  /* Decode outside the lock -- this is the expensive part, and
+     another thread asking for a different name should not have to
+     wait for it.  */
+  std::string decoded = ada_decode (encoded, false, false);
+  size_t encoded_len = strlen (encoded);
+  gdb::unique_xmalloc_ptr<char> new_entry
+    ((char *) xmalloc (encoded_len + decoded.size () + 2));
+  memcpy (new_entry.get (), encoded, encoded_len + 1);
+  memcpy (new_entry.get () + encoded_len + 1, decoded.c_str (),
+	  decoded.size () + 1);
+
+  {
+#if CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (interned_decoded_names_lock);
+#endif
+    void **slot = htab_find_slot (interned_decoded_names, encoded, INSERT);
+    /* Another thread may have decoded the same name meanwhile; its
+       entry wins and ours is simply dropped.  */
+    if (*slot == nullptr)
+      *slot = new_entry.release ();
+    const char *entry = (const char *) *slot;
+    return entry + strlen (entry) + 1;
+  }
+}
+
 
 
 				/* Arrays */
@@ -5960,7 +6077,7 @@ is_name_suffix (const char *str)
 static int
 is_valid_name_for_wild_match (const char *name0)
 {
-  std::string decoded_name = ada_decode (name0);
+  const char *decoded_name = ada_decode_cached (name0);
   int i;
 
   /* If the decoded name starts with an angle bracket, it means that
@@ -6173,7 +6290,7 @@ ada_lookup_name_info::matches
   if (strncmp (sym_name, text, text_len) == 0)
     match = true;
 
-  std::string decoded_name = ada_decode (sym_name);
+  const char *decoded_name = ada_decode_cached (sym_name);
   if (match && !m_encoded_p)
     {
       /* One needed check before declaring a positive match is to verify
@@ -6206,7 +6323,7 @@ ada_lookup_name_info::matches
       /* Since we are doing wild matching, this means that TEXT
 	 may represent an unqualified symbol name.  We therefore must
 	 also compare TEXT against the unqualified name of the symbol.  */
-      sym_name = ada_unqualified_name (decoded_name.c_str ());
+      sym_name = ada_unqualified_name (decoded_name);
 
       if (strncmp (sym_name, text, text_len) == 0)
 	match = true;
@@ -13051,8 +13168,9 @@ ada_add_global_exceptions (compiled_regex *preg,
 			   lookup_name_info::match_any (),
 			   [&] (const char *search_name)
 			   {
-			     std::string decoded = ada_decode (search_name);
-			     return name_matches_regex (decoded.c_str (), preg);
+			     const char *decoded
+			       = ada_decode_cached (search_name);
+			     return name_matches_regex (decoded, preg);
 			   },
 			   NULL,
 			   SEARCH_GLOBAL_BLOCK | SEARCH_STATIC_BLOCK,
@@ -221,6 +221,12 @@ extern const char *ada_decode_symbol (const struct general_symbol_info *);
 extern std::string ada_decode (const char *name, bool wrap = true,
 			       bool operators = true);
 
+/* Return the decoded form of NAME, as for ada_decode with WRAP and
+   OPERATORS false, interned in a table that lives for the rest of the
+   session.  Decoding each distinct name happens only once.  Unlike
+   ada_decode, this is safe to call from worker threads.  */
+extern const char *ada_decode_intern (const char *name);
+
 extern std::vector<struct block_symbol> ada_lookup_symbol_list
      (const char *, const struct block *, domain_enum);
 
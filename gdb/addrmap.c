@@ -45,6 +45,22 @@ addrmap_fixed::do_find (CORE_ADDR addr) const
   const struct addrmap_transition *bottom = &transitions[0];
   const struct addrmap_transition *top = &transitions[num_transitions - 1];
 
+  if (num_stripes > 0)
+    {
+      /* Use the stripe index to narrow the binary search down to the
+	 transitions falling within ADDR's stripe.  */
+      if (addr < stripe_base)
+	return transitions[0].value;
+
+      size_t stripe = (addr - stripe_base) >> stripe_shift;
+      if (stripe >= num_stripes)
+	stripe = num_stripes - 1;
+
+      bottom = &transitions[stripe_first[stripe]];
+      if (stripe + 1 < num_stripes)
+	top = &transitions[stripe_first[stripe + 1]];
+    }
+
   while (bottom < top)
     {
       /* This needs to round towards top, or else when top = bottom +
@@ -78,6 +94,7 @@ addrmap_fixed::relocate (CORE_ADDR offset)
 
   for (i = 0; i < num_transitions; i++)
     transitions[i].addr += offset;
+  stripe_base += offset;
 }
 
 
@@ -293,6 +310,56 @@ addrmap_fixed::addrmap_fixed (struct obstack *obstack, addrmap_mutable *mut)
 
   /* We should have filled the array.  */
   gdb_assert (num_transitions == transition_count);
+
+  build_stripe_index (obstack);
+}
+
+
+/* Don't bother indexing maps with fewer transitions than this; a
+   plain binary search over so few entries is already cheap.  */
+#define ADDRMAP_MIN_INDEXED_TRANSITIONS 16
+
+/* Cap on the number of stripes, to bound the size of the index for
+   maps whose transitions are spread very unevenly.  */
+#define ADDRMAP_MAX_STRIPES (1 << 20)
+
+/* See addrmap.h.  */
+
+void
+addrmap_fixed::build_stripe_index (struct obstack *obstack)
+{
+  if (num_transitions < ADDRMAP_MIN_INDEXED_TRANSITIONS)
+    return;
+
+  /* Base the stripes on the first real transition rather than the
+     artificial entry at address zero; otherwise all the interesting
+     transitions would land in the final stripe.  */
+  stripe_base = transitions[1].addr;
+  CORE_ADDR span = transitions[num_transitions - 1].addr - stripe_base;
+
+  /* Aim for about one transition per stripe, using a power-of-two
+     stripe width so that a lookup is just a shift.  */
+  size_t target = num_transitions;
+  if (target > ADDRMAP_MAX_STRIPES)
+    target = ADDRMAP_MAX_STRIPES;
+  while ((span >> stripe_shift) >= target)
+    ++stripe_shift;
+  num_stripes = (size_t) (span >> stripe_shift) + 1;
+
+  stripe_first = XOBNEWVEC (obstack, unsigned int, num_stripes);
+
+  /* For each stripe, record the last transition at or below the
+     stripe's first address.  Since TRANSITIONS is sorted, a single
+     walk over it fills the whole index.  */
+  size_t next = 1;
+  for (size_t i = 0; i < num_stripes; i++)
+    {
+      CORE_ADDR stripe_start = stripe_base + ((CORE_ADDR) i << stripe_shift);
+
+      while (next < num_transitions && transitions[next].addr <= stripe_start)
+	next++;
+      stripe_first[i] = next - 1;
+    }
 }
 
 
@@ -476,6 +543,23 @@ test_addrmap ()
   CHECK_ADDRMAP_FIND (map, array, 10, 12, val1);
   CHECK_ADDRMAP_FIND (map, array, 13, 13, val2);
   CHECK_ADDRMAP_FIND (map, array, 14, 19, nullptr);
+
+  /* Create a fixed addrmap with enough transitions that the stripe
+     index is built, and check lookups against the mutable map.  */
+  char big_array[200];
+  auto big_map = gdb::make_unique<struct addrmap_mutable> ();
+  for (unsigned i = 0; i < 200; i += 10)
+    big_map->set_empty (core_addr (&big_array[i]),
+			core_addr (&big_array[i + 4]),
+			&big_array[i]);
+  struct addrmap *big_map2
+    = new (&temp_obstack) addrmap_fixed (&temp_obstack, big_map.get ());
+  SELF_CHECK (big_map2->find (core_addr (&big_array[0]) - 1) == nullptr);
+  for (unsigned i = 0; i < 200; ++i)
+    SELF_CHECK (big_map2->find (core_addr (&big_array[i]))
+		== big_map->find (core_addr (&big_array[i])));
+  SELF_CHECK (big_map2->find (core_addr (&big_array[199]) + 1)
+	      == big_map->find (core_addr (&big_array[199]) + 1));
 }
 
 } // namespace selftests
@@ -153,6 +153,24 @@ private:
      containing ADDR and VALUE.  (Note that this means we always have
      an entry for address 0).  */
   struct addrmap_transition *transitions;
+
+  /* A two-level lookup index over TRANSITIONS, built by the
+     constructor for maps large enough to benefit.  The address range
+     starting at STRIPE_BASE is divided into NUM_STRIPES stripes of
+     1 << STRIPE_SHIFT addresses each, and STRIPE_FIRST[I] is the
+     index of the last transition whose address is at or below the
+     start of stripe I.  A lookup then only has to binary search the
+     few transitions falling within a single stripe, rather than the
+     whole array.  NUM_STRIPES is zero when no index was built.  */
+  size_t num_stripes = 0;
+  CORE_ADDR stripe_base = 0;
+  unsigned int stripe_shift = 0;
+  unsigned int *stripe_first = nullptr;
+
+  /* Build the stripe index over TRANSITIONS, allocating it on
+     OBSTACK.  Called by the constructor, after TRANSITIONS has been
+     filled in.  */
+  void build_stripe_index (struct obstack *obstack);
 };
 
 /* Mutable address maps.  */
@@ -50,6 +50,8 @@
 #include "osabi.h"
 #include "x86-tdep.h"
 #include "amd64-ravenscar-thread.h"
+#include "observable.h"
+#include <unordered_map>
 
 /* Note that the AMD64 architecture was previously known as x86-64.
    The latter is (forever) engraved into the canonical system name as
@@ -2444,6 +2446,116 @@ amd64_analyze_prologue (struct gdbarch *gdbarch,
   return pc;
 }
 
+/* Number of code bytes used to validate a cached prologue analysis.
+   This covers the longest byte sequence amd64_analyze_prologue and
+   its helpers ever decode: up to 19 bytes of stack realignment code
+   followed by `endbr64', `pushq %rbp' and `movq %rsp, %rbp'.  */
+#define AMD64_PROLOGUE_CACHE_BYTES 32
+
+/* One memoized run of amd64_analyze_prologue: the inputs it depends
+   on and the frame cache fields it computes.  */
+
+struct amd64_prologue_cache_entry
+{
+  struct gdbarch *gdbarch;
+
+  /* The CURRENT_PC the analysis was cut off at.  */
+  CORE_ADDR current_pc;
+
+  /* The code bytes the analysis decoded, compared on lookup so that
+     rewritten (e.g. JIT) code is re-analyzed instead of served
+     stale.  */
+  gdb_byte insns[AMD64_PROLOGUE_CACHE_BYTES];
+
+  /* The analysis results; END_PC is the return value.  */
+  CORE_ADDR end_pc;
+  CORE_ADDR sp_offset;
+  CORE_ADDR saved_regs[AMD64_NUM_SAVED_REGS];
+  int saved_sp_reg;
+  int frameless_p;
+};
+
+/* Memoized prologue analyses for one program space, keyed by the
+   function's start PC.  */
+
+struct amd64_prologue_cache
+{
+  std::unordered_map<CORE_ADDR,
+		     std::vector<amd64_prologue_cache_entry>> map;
+};
+
+static const registry<program_space>::key<amd64_prologue_cache>
+  amd64_prologue_cache_key;
+
+/* Memoizing wrapper around amd64_analyze_prologue.  Frames without
+   CFI go through the prologue analyzer on every stop; the decoding
+   only depends on the code bytes, so its results are cached per
+   program space.  CACHE must be freshly initialized, as it is at
+   every call site.  */
+
+static CORE_ADDR
+amd64_analyze_prologue_cached (struct gdbarch *gdbarch, CORE_ADDR pc,
+			       CORE_ADDR current_pc,
+			       struct amd64_frame_cache *cache)
+{
+  gdb_byte insns[AMD64_PROLOGUE_CACHE_BYTES];
+
+  /* If the code bytes cannot be read up front, fall back to the
+     plain analysis, which copes with short reads.  Nothing is worth
+     caching if the analysis cannot get past the first byte.  */
+  if (current_pc <= pc
+      || target_read_code (pc, insns, sizeof insns) != 0)
+    return amd64_analyze_prologue (gdbarch, pc, current_pc, cache);
+
+  amd64_prologue_cache *pcache
+    = amd64_prologue_cache_key.get (current_program_space);
+  if (pcache == nullptr)
+    pcache = amd64_prologue_cache_key.emplace (current_program_space);
+
+  std::vector<amd64_prologue_cache_entry> &entries = pcache->map[pc];
+  for (const amd64_prologue_cache_entry &entry : entries)
+    if (entry.gdbarch == gdbarch
+	&& (entry.current_pc == current_pc
+	    /* A run that was not cut short by its CURRENT_PC is
+	       valid for any stop beyond the analyzed prologue.  */
+	    || (entry.end_pc < entry.current_pc
+		&& entry.end_pc < current_pc))
+	&& memcmp (entry.insns, insns, sizeof insns) == 0)
+      {
+	cache->sp_offset = entry.sp_offset;
+	memcpy (cache->saved_regs, entry.saved_regs,
+		sizeof entry.saved_regs);
+	cache->saved_sp_reg = entry.saved_sp_reg;
+	cache->frameless_p = entry.frameless_p;
+	return entry.end_pc;
+      }
+
+  CORE_ADDR end_pc = amd64_analyze_prologue (gdbarch, pc, current_pc, cache);
+
+  amd64_prologue_cache_entry entry;
+  entry.gdbarch = gdbarch;
+  entry.current_pc = current_pc;
+  memcpy (entry.insns, insns, sizeof insns);
+  entry.end_pc = end_pc;
+  entry.sp_offset = cache->sp_offset;
+  memcpy (entry.saved_regs, cache->saved_regs, sizeof entry.saved_regs);
+  entry.saved_sp_reg = cache->saved_sp_reg;
+  entry.frameless_p = cache->frameless_p;
+  entries.push_back (entry);
+
+  return end_pc;
+}
+
+/* Discard all cached prologue analyses for PSPACE.  */
+
+static void
+amd64_invalidate_prologue_cache (program_space *pspace)
+{
+  amd64_prologue_cache *pcache = amd64_prologue_cache_key.get (pspace);
+  if (pcache != nullptr)
+    pcache->map.clear ();
+}
+
 /* Work around false termination of prologue - GCC PR debug/48827.
 
    START_PC is the first instruction of a function, PC is its minimal already
@@ -2552,8 +2664,8 @@ amd64_skip_prologue (struct gdbarch *gdbarch, CORE_ADDR start_pc)
     }
 
   amd64_init_frame_cache (&cache);
-  pc = amd64_analyze_prologue (gdbarch, start_pc, 0xffffffffffffffffLL,
-			       &cache);
+  pc = amd64_analyze_prologue_cached (gdbarch, start_pc,
+				      0xffffffffffffffffLL, &cache);
   if (cache.frameless_p)
     return start_pc;
 
@@ -2574,8 +2686,8 @@ amd64_frame_cache_1 (frame_info_ptr this_frame,
 
   cache->pc = get_frame_func (this_frame);
   if (cache->pc != 0)
-    amd64_analyze_prologue (gdbarch, cache->pc, get_frame_pc (this_frame),
-			    cache);
+    amd64_analyze_prologue_cached (gdbarch, cache->pc,
+				   get_frame_pc (this_frame), cache);
 
   if (cache->frameless_p)
     {
@@ -3411,6 +3523,20 @@ _initialize_amd64_tdep ()
 			  amd64_none_init_abi);
   gdbarch_register_osabi (bfd_arch_i386, bfd_mach_x64_32, GDB_OSABI_NONE,
 			  amd64_x32_none_init_abi);
+
+  /* The prologue cache verifies the code bytes on every hit, so
+     these observers are only needed to keep it from accumulating
+     entries for unloaded code.  */
+  gdb::observers::new_objfile.attach
+    ([] (struct objfile *objfile)
+     { amd64_invalidate_prologue_cache (objfile->pspace); },
+     "amd64-tdep");
+  gdb::observers::free_objfile.attach
+    ([] (struct objfile *objfile)
+     { amd64_invalidate_prologue_cache (objfile->pspace); },
+     "amd64-tdep");
+  gdb::observers::all_objfiles_removed.attach
+    (amd64_invalidate_prologue_cache, "amd64-tdep");
 }
 
 
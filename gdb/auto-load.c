@@ -36,10 +36,14 @@
 #include "completer.h"
 #include "fnmatch.h"
 #include "top.h"
+#include "maint.h"
 #include "gdbsupport/filestuff.h"
 #include "extension.h"
 #include "gdb/section-scripts.h"
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "gdbsupport/gdb_optional.h"
 #include "gdbsupport/pathstuff.h"
 #include "cli/cli-style.h"
 
@@ -713,6 +717,74 @@ clear_section_scripts (program_space *pspace)
     auto_load_pspace_data.clear (pspace);
 }
 
+/* Cache of directory listings used while probing for auto-load
+   scripts.  Each objfile probes several candidate script names per
+   extension language, and the candidates for objfiles living in the
+   same directory all land in the same few directories.  Reading each
+   directory once and answering the probes from memory replaces
+   thousands of failed opens at startup with one readdir per distinct
+   directory.  The cache is dropped before each prompt, so a script
+   installed while GDB is running is seen by the next command.  */
+
+static std::unordered_map<std::string,
+			  gdb::optional<std::unordered_set<std::string>>>
+  auto_load_listing_cache;
+
+/* Return false if FILENAME is known not to exist, judging from a
+   cached listing of its directory.  Returning true only means the
+   file may exist: directories that cannot be listed (execute-only
+   ones, for instance) are not cached and their candidates must be
+   probed directly.  */
+
+static bool
+auto_load_file_may_exist (const char *filename)
+{
+#ifdef HAVE_DOS_BASED_FILE_SYSTEM
+  /* The listing comparison below is exact, which would wrongly
+     reject candidates differing only in case on case-insensitive
+     file systems.  */
+  return true;
+#else
+  const char *base = lbasename (filename);
+
+  if (base == filename)
+    return true;
+
+  std::string dir (filename, base - filename);
+
+  auto it = auto_load_listing_cache.find (dir);
+  if (it == auto_load_listing_cache.end ())
+    {
+      gdb::optional<std::unordered_set<std::string>> listing;
+      gdb_dir_up dirp (opendir (dir.c_str ()));
+
+      if (dirp != nullptr)
+	{
+	  struct dirent *entry;
+
+	  listing.emplace ();
+	  while ((entry = readdir (dirp.get ())) != nullptr)
+	    listing->insert (entry->d_name);
+	}
+
+      it = auto_load_listing_cache.emplace (std::move (dir),
+					    std::move (listing)).first;
+    }
+
+  if (!it->second.has_value ())
+    return true;
+  return it->second->find (base) != it->second->end ();
+#endif
+}
+
+/* Forget the cached directory listings between commands.  */
+
+static void
+auto_load_before_prompt (const char *current_prompt)
+{
+  auto_load_listing_cache.clear ();
+}
+
 /* Look for the auto-load script in LANGUAGE associated with OBJFILE where
    OBJFILE's gdb_realpath is REALNAME and load it.  Return 1 if we found any
    matching script, return 0 otherwise.  */
@@ -727,7 +799,9 @@ auto_load_objfile_script_1 (struct objfile *objfile, const char *realname,
 
   std::string filename = std::string (realname) + suffix;
 
-  gdb_file_up input = gdb_fopen_cloexec (filename.c_str (), "r");
+  gdb_file_up input;
+  if (auto_load_file_may_exist (filename.c_str ()))
+    input = gdb_fopen_cloexec (filename.c_str (), "r");
   debugfile = filename.c_str ();
 
   auto_load_debug_printf ("Attempted file \"%ps\" %s.",
@@ -758,7 +832,8 @@ auto_load_objfile_script_1 (struct objfile *objfile, const char *realname,
 	  debugfile_holder = dir.get () + filename;
 	  debugfile = debugfile_holder.c_str ();
 
-	  input = gdb_fopen_cloexec (debugfile, "r");
+	  if (auto_load_file_may_exist (debugfile))
+	    input = gdb_fopen_cloexec (debugfile, "r");
 
 	  auto_load_debug_printf ("Attempted file \"%ps\" %s.",
 				  styled_string (file_name_style.style (),
@@ -803,6 +878,10 @@ auto_load_objfile_script_1 (struct objfile *objfile, const char *realname,
 	     compiled in.  And the extension language is required to implement
 	     this function.  */
 	  gdb_assert (sourcer != NULL);
+
+	  /* During startup, attribute the time spent in the script to
+	     it in the "maint time startup" table.  */
+	  scoped_startup_timer timer ("script", debugfile);
 	  sourcer (language, objfile, input.get (), debugfile);
 	}
 
@@ -948,8 +1027,13 @@ source_script_file (struct auto_load_pspace_info *pspace_info,
 
   /* If this file is not currently loaded, load it.  */
   if (opened && !in_hash_table)
-    sourcer (language, objfile, opened->stream.get (),
-	     opened->full_path.get ());
+    {
+      /* During startup, attribute the time spent in the script to it
+	 in the "maint time startup" table.  */
+      scoped_startup_timer timer ("script", opened->full_path.get ());
+      sourcer (language, objfile, opened->stream.get (),
+	       opened->full_path.get ());
+    }
 }
 
 /* Subroutine of source_section_scripts to simplify it.
@@ -1524,6 +1608,8 @@ _initialize_auto_load ()
 				      "auto-load");
   gdb::observers::all_objfiles_removed.attach (clear_section_scripts,
 					       "auto-load");
+  gdb::observers::before_prompt.attach (auto_load_before_prompt,
+					"auto-load");
   add_setshow_boolean_cmd ("gdb-scripts", class_support,
 			   &auto_load_gdb_scripts, _("\
 Enable or disable auto-loading of canned sequences of commands scripts."), _("\
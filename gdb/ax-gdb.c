@@ -459,6 +459,7 @@ gen_frame_args_address (struct agent_expr *ax)
 				 ax->scope, &frame_reg, &frame_offset);
   ax_reg (ax, frame_reg);
   gen_offset (ax, frame_offset);
+  ax->virtual_frame_pointer_used = true;
 }
 
 
@@ -474,6 +475,7 @@ gen_frame_locals_address (struct agent_expr *ax)
 				 ax->scope, &frame_reg, &frame_offset);
   ax_reg (ax, frame_reg);
   gen_offset (ax, frame_offset);
+  ax->virtual_frame_pointer_used = true;
 }
 
 
@@ -2407,6 +2409,319 @@ gen_eval_for_expr (CORE_ADDR scope, struct expression *expr)
   return ax;
 }
 
+/* Helper for ax_eval.  Return the internal register number
+   corresponding to protocol register number REMOTE_REG (what aop_reg
+   operands hold; see ax_reg), or -1 if there is none.  */
+
+static int
+ax_eval_regnum (struct gdbarch *gdbarch, int remote_reg)
+{
+  int count = gdbarch_num_regs (gdbarch) + gdbarch_num_pseudo_regs (gdbarch);
+
+  for (int regnum = 0; regnum < count; regnum++)
+    if (gdbarch_remote_register_number (gdbarch, regnum) == remote_reg)
+      return regnum;
+  return -1;
+}
+
+/* See ax-gdb.h.  */
+
+ULONGEST
+ax_eval (struct agent_expr *aexpr)
+{
+  struct gdbarch *gdbarch = aexpr->gdbarch;
+  enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
+  const gdb_byte *bytes = aexpr->buf.data ();
+  size_t len = aexpr->buf.size ();
+  std::vector<ULONGEST> stack;
+  size_t pc = 0;
+
+  if (len == 0)
+    error (_("Cannot evaluate empty agent expression"));
+
+  /* Fetch an N-byte big-endian operand at PC, advancing PC.  */
+  auto fetch_operand = [&] (int n) -> ULONGEST
+    {
+      if (pc + n > len)
+	error (_("Agent expression is malformed"));
+
+      ULONGEST value = 0;
+      for (int i = 0; i < n; i++)
+	value = (value << 8) | bytes[pc++];
+      return value;
+    };
+
+  auto push = [&] (ULONGEST value)
+    {
+      stack.push_back (value);
+    };
+
+  auto pop = [&] () -> ULONGEST
+    {
+      if (stack.empty ())
+	error (_("Agent expression stack underflow"));
+
+      ULONGEST value = stack.back ();
+      stack.pop_back ();
+      return value;
+    };
+
+  while (1)
+    {
+      if (pc >= len)
+	error (_("Agent expression ran off its end"));
+
+      enum agent_op op = (enum agent_op) bytes[pc++];
+      ULONGEST a, b, arg;
+
+      switch (op)
+	{
+	case aop_add:
+	  b = pop ();
+	  a = pop ();
+	  push (a + b);
+	  break;
+
+	case aop_sub:
+	  b = pop ();
+	  a = pop ();
+	  push (a - b);
+	  break;
+
+	case aop_mul:
+	  b = pop ();
+	  a = pop ();
+	  push (a * b);
+	  break;
+
+	case aop_div_signed:
+	case aop_rem_signed:
+	  b = pop ();
+	  a = pop ();
+	  if (b == 0)
+	    error (_("Division by zero"));
+	  /* Avoid the one overflowing case of signed division.  */
+	  if ((LONGEST) b == -1)
+	    push (op == aop_div_signed ? -a : 0);
+	  else if (op == aop_div_signed)
+	    push ((LONGEST) a / (LONGEST) b);
+	  else
+	    push ((LONGEST) a % (LONGEST) b);
+	  break;
+
+	case aop_div_unsigned:
+	  b = pop ();
+	  a = pop ();
+	  if (b == 0)
+	    error (_("Division by zero"));
+	  push (a / b);
+	  break;
+
+	case aop_rem_unsigned:
+	  b = pop ();
+	  a = pop ();
+	  if (b == 0)
+	    error (_("Division by zero"));
+	  push (a % b);
+	  break;
+
+	case aop_lsh:
+	  b = pop ();
+	  a = pop ();
+	  push (b >= 64 ? 0 : a << b);
+	  break;
+
+	case aop_rsh_signed:
+	  b = pop ();
+	  a = pop ();
+	  if (b >= 64)
+	    push ((LONGEST) a < 0 ? (ULONGEST) -1 : 0);
+	  else
+	    push ((LONGEST) a >> b);
+	  break;
+
+	case aop_rsh_unsigned:
+	  b = pop ();
+	  a = pop ();
+	  push (b >= 64 ? 0 : a >> b);
+	  break;
+
+	case aop_log_not:
+	  a = pop ();
+	  push (a == 0 ? 1 : 0);
+	  break;
+
+	case aop_bit_and:
+	  b = pop ();
+	  a = pop ();
+	  push (a & b);
+	  break;
+
+	case aop_bit_or:
+	  b = pop ();
+	  a = pop ();
+	  push (a | b);
+	  break;
+
+	case aop_bit_xor:
+	  b = pop ();
+	  a = pop ();
+	  push (a ^ b);
+	  break;
+
+	case aop_bit_not:
+	  a = pop ();
+	  push (~a);
+	  break;
+
+	case aop_equal:
+	  b = pop ();
+	  a = pop ();
+	  push (a == b ? 1 : 0);
+	  break;
+
+	case aop_less_signed:
+	  b = pop ();
+	  a = pop ();
+	  push ((LONGEST) a < (LONGEST) b ? 1 : 0);
+	  break;
+
+	case aop_less_unsigned:
+	  b = pop ();
+	  a = pop ();
+	  push (a < b ? 1 : 0);
+	  break;
+
+	case aop_ext:
+	  arg = fetch_operand (1);
+	  a = pop ();
+	  if (arg > 0 && arg < 64)
+	    {
+	      ULONGEST mask = (ULONGEST) 1 << (arg - 1);
+
+	      a &= ((ULONGEST) 1 << arg) - 1;
+	      a = (a ^ mask) - mask;
+	    }
+	  push (a);
+	  break;
+
+	case aop_zero_ext:
+	  arg = fetch_operand (1);
+	  a = pop ();
+	  if (arg < 64)
+	    a &= ((ULONGEST) 1 << arg) - 1;
+	  push (a);
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  {
+	    int size = 1 << (op - aop_ref8);
+	    gdb_byte buf[8];
+
+	    a = pop ();
+	    if (target_read_memory (a, buf, size) != 0)
+	      error (_("Cannot access memory at address %s"),
+		     paddress (gdbarch, a));
+	    push (extract_unsigned_integer (buf, size, byte_order));
+	  }
+	  break;
+
+	case aop_if_goto:
+	  arg = fetch_operand (2);
+	  a = pop ();
+	  if (a != 0)
+	    pc = arg;
+	  break;
+
+	case aop_goto:
+	  pc = fetch_operand (2);
+	  break;
+
+	case aop_const8:
+	  push (fetch_operand (1));
+	  break;
+
+	case aop_const16:
+	  push (fetch_operand (2));
+	  break;
+
+	case aop_const32:
+	  push (fetch_operand (4));
+	  break;
+
+	case aop_const64:
+	  push (fetch_operand (8));
+	  break;
+
+	case aop_reg:
+	  {
+	    int remote_reg = (int) fetch_operand (2);
+	    int regnum = ax_eval_regnum (gdbarch, remote_reg);
+	    ULONGEST value;
+
+	    if (regnum == -1
+		|| (regcache_cooked_read_unsigned (get_current_regcache (),
+						   regnum, &value)
+		    != REG_VALID))
+	      error (_("Agent expression failed to read register %d"),
+		     remote_reg);
+	    push (value);
+	  }
+	  break;
+
+	case aop_end:
+	  if (stack.empty ())
+	    error (_("Agent expression left nothing on its stack"));
+	  return stack.back ();
+
+	case aop_dup:
+	  a = pop ();
+	  push (a);
+	  push (a);
+	  break;
+
+	case aop_pop:
+	  pop ();
+	  break;
+
+	case aop_pick:
+	  arg = fetch_operand (1);
+	  if (arg >= stack.size ())
+	    error (_("Agent expression stack underflow"));
+	  push (stack[stack.size () - 1 - arg]);
+	  break;
+
+	case aop_rot:
+	  {
+	    ULONGEST c = pop ();
+
+	    b = pop ();
+	    a = pop ();
+	    push (c);
+	    push (a);
+	    push (b);
+	  }
+	  break;
+
+	case aop_swap:
+	  b = pop ();
+	  a = pop ();
+	  push (b);
+	  push (a);
+	  break;
+
+	default:
+	  /* The tracing, trace state variable and floating point
+	     bytecodes, and anything we don't recognize.  */
+	  error (_("Agent expression bytecode 0x%x is not supported "
+		   "for host evaluation"), op);
+	}
+    }
+}
+
 agent_expr_up
 gen_trace_for_return_address (CORE_ADDR scope, struct gdbarch *gdbarch,
 			      int trace_string)
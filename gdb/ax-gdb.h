@@ -114,6 +114,14 @@ extern agent_expr_up gen_trace_for_return_address (CORE_ADDR,
 
 extern agent_expr_up gen_eval_for_expr (CORE_ADDR, struct expression *);
 
+/* Evaluate agent expression AEXPR on the host, in the context of the
+   current thread and inferior, and return the value left on top of
+   its stack.  Throws an error if the expression uses a bytecode that
+   cannot be evaluated on the host (such as the tracing operations),
+   or is malformed.  */
+
+extern ULONGEST ax_eval (struct agent_expr *aexpr);
+
 extern void gen_expr (struct expression *exp, union exp_element **pc,
 		      struct agent_expr *ax, struct axs_value *value);
 
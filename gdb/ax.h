@@ -141,6 +141,14 @@ struct agent_expr
        is the value of trace_string.  */
 
     int trace_string = 0;
+
+    /* True if the generated code relies on
+       gdbarch_virtual_frame_pointer, which only approximates the
+       frame base.  Such code is good enough for tracing, but should
+       not be used where an exact value is required, such as
+       host-side evaluation of a breakpoint condition.  */
+
+    bool virtual_frame_pointer_used = false;
   };
 
 /* An agent_expr owning pointer.  */
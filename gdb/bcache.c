@@ -35,8 +35,6 @@ namespace gdb {
 
 struct bstring
 {
-  /* Hash chain.  */
-  struct bstring *next;
   /* Assume the data length is no more than 64k.  */
   unsigned short length;
   /* The half hash hack.  This contains the upper 16 bits of the hash
@@ -56,24 +54,14 @@ struct bstring
 
 /* Growing the bcache's hash table.  */
 
-/* If the average chain length grows beyond this, then we want to
-   resize our hash table.  */
-#define CHAIN_LENGTH_THRESHOLD (5)
+/* The number of slots the table starts out with.  The table size is
+   always a power of two, so that the probe sequence can use masking
+   instead of division.  */
+#define INITIAL_NUM_BUCKETS (1024)
 
 void
 bcache::expand_hash_table ()
 {
-  /* A table of good hash table sizes.  Whenever we grow, we pick the
-     next larger size from this table.  sizes[i] is close to 1 << (i+10),
-     so we roughly double the table size each time.  After we fall off 
-     the end of this table, we just double.  Don't laugh --- there have
-     been executables sighted with a gigabyte of debug info.  */
-  static const unsigned long sizes[] = {
-    1021, 2053, 4099, 8191, 16381, 32771,
-    65537, 131071, 262144, 524287, 1048573, 2097143,
-    4194301, 8388617, 16777213, 33554467, 67108859, 134217757,
-    268435459, 536870923, 1073741827, 2147483659UL
-  };
   unsigned int new_num_buckets;
   struct bstring **new_buckets;
   unsigned int i;
@@ -83,14 +71,11 @@ bcache::expand_hash_table ()
   m_expand_count++;
   m_expand_hash_count += m_unique_count;
 
-  /* Find the next size.  */
-  new_num_buckets = m_num_buckets * 2;
-  for (unsigned long a_size : sizes)
-    if (a_size > m_num_buckets)
-      {
-	new_num_buckets = a_size;
-	break;
-      }
+  /* Double the table size.  Don't laugh --- there have been
+     executables sighted with a gigabyte of debug info.  */
+  new_num_buckets = (m_num_buckets == 0
+		     ? INITIAL_NUM_BUCKETS
+		     : m_num_buckets * 2);
 
   /* Allocate the new table.  */
   {
@@ -103,21 +88,24 @@ bcache::expand_hash_table ()
     m_structure_size += new_size;
   }
 
-  /* Rehash all existing strings.  */
+  /* Rehash all existing strings into the new table.  All entries are
+     unique, so only an empty slot needs to be found for each; no
+     comparisons are necessary.  */
   for (i = 0; i < m_num_buckets; i++)
     {
-      struct bstring *s, *next;
+      struct bstring *s = m_bucket[i];
 
-      for (s = m_bucket[i]; s; s = next)
-	{
-	  struct bstring **new_bucket;
-	  next = s->next;
+      if (s == nullptr)
+	continue;
 
-	  new_bucket = &new_buckets[(this->hash (&s->d.data, s->length)
-				     % new_num_buckets)];
-	  s->next = *new_bucket;
-	  *new_bucket = s;
-	}
+      unsigned long full_hash = this->hash (&s->d.data, s->length);
+      unsigned int mask = new_num_buckets - 1;
+      unsigned int index = full_hash & mask;
+      unsigned int step = ((full_hash * 17) & mask) | 1;
+
+      while (new_buckets[index] != nullptr)
+	index = (index + step) & mask;
+      new_buckets[index] = s;
     }
 
   /* Plug in the new table.  */
@@ -126,6 +114,15 @@ bcache::expand_hash_table ()
   m_num_buckets = new_num_buckets;
 }
 
+/* See bcache.h.  */
+
+void
+bcache::reserve (unsigned long n_entries)
+{
+  while (4 * (m_unique_count + n_entries) >= 3 * m_num_buckets)
+    expand_hash_table ();
+}
+
 
 /* Looking up things in the bcache.  */
 
@@ -160,8 +157,10 @@ bcache::insert (const void *addr, int length, bool *added)
       obstack_init (&m_cache);
     }
 
-  /* If our average chain length is too high, expand the hash table.  */
-  if (m_unique_count >= m_num_buckets * CHAIN_LENGTH_THRESHOLD)
+  /* Keep the table at no more than 75% occupancy.  This also
+     guarantees that there is always at least one empty slot, so the
+     probe loops below terminate.  */
+  if (4 * (m_unique_count + 1) >= 3 * m_num_buckets)
     expand_hash_table ();
 
   m_total_count++;
@@ -170,13 +169,20 @@ bcache::insert (const void *addr, int length, bool *added)
   full_hash = this->hash (addr, length);
 
   half_hash = (full_hash >> 16);
-  hash_index = full_hash % m_num_buckets;
 
-  /* Search the hash m_bucket for a string identical to the caller's.
-     As a short-circuit first compare the upper part of each hash
-     values.  */
-  for (s = m_bucket[hash_index]; s; s = s->next)
+  unsigned int mask = m_num_buckets - 1;
+  unsigned int step = ((full_hash * 17) & mask) | 1;
+
+  hash_index = full_hash & mask;
+
+  /* Probe for a string identical to the caller's, stopping at the
+     first empty slot.  As a short-circuit first compare the upper
+     part of each hash value.  */
+  for (;;)
     {
+      s = m_bucket[hash_index];
+      if (s == nullptr)
+	break;
       if (s->half_hash == half_hash)
 	{
 	  if (s->length == length
@@ -185,9 +191,11 @@ bcache::insert (const void *addr, int length, bool *added)
 	  else
 	    m_half_hash_miss_count++;
 	}
+      hash_index = (hash_index + step) & mask;
     }
 
-  /* The user's string isn't in the list.  Insert it after *ps.  */
+  /* The user's string isn't in the table.  Insert it into the empty
+     slot the probe stopped at.  */
   {
     struct bstring *newobj
       = (struct bstring *) obstack_alloc (&m_cache,
@@ -195,7 +203,6 @@ bcache::insert (const void *addr, int length, bool *added)
 
     memcpy (&newobj->d.data, addr, length);
     newobj->length = length;
-    newobj->next = m_bucket[hash_index];
     newobj->half_hash = half_hash;
     m_bucket[hash_index] = newobj;
 
@@ -259,16 +266,14 @@ void
 bcache::print_statistics (const char *type)
 {
   int occupied_buckets;
-  int max_chain_length;
-  int median_chain_length;
   int max_entry_size;
   int median_entry_size;
 
-  /* Count the number of occupied buckets, tally the various string
-     lengths, and measure chain lengths.  */
+  /* Count the number of occupied buckets and tally the various
+     string lengths.  With open addressing each occupied bucket holds
+     exactly one string.  */
   {
     unsigned int b;
-    int *chain_length = XCNEWVEC (int, m_num_buckets + 1);
     int *entry_size = XCNEWVEC (int, m_unique_count + 1);
     int stringi = 0;
 
@@ -278,38 +283,16 @@ bcache::print_statistics (const char *type)
       {
 	struct bstring *s = m_bucket[b];
 
-	chain_length[b] = 0;
-
-	if (s)
+	if (s != nullptr)
 	  {
 	    occupied_buckets++;
-	    
-	    while (s)
-	      {
-		gdb_assert (b < m_num_buckets);
-		chain_length[b]++;
-		gdb_assert (stringi < m_unique_count);
-		entry_size[stringi++] = s->length;
-		s = s->next;
-	      }
+	    gdb_assert (stringi < m_unique_count);
+	    entry_size[stringi++] = s->length;
 	  }
       }
 
-    /* To compute the median, we need the set of chain lengths
-       sorted.  */
-    std::sort (chain_length, chain_length + m_num_buckets);
     std::sort (entry_size, entry_size + m_unique_count);
 
-    if (m_num_buckets > 0)
-      {
-	max_chain_length = chain_length[m_num_buckets - 1];
-	median_chain_length = chain_length[m_num_buckets / 2];
-      }
-    else
-      {
-	max_chain_length = 0;
-	median_chain_length = 0;
-      }
     if (m_unique_count > 0)
       {
 	max_entry_size = entry_size[m_unique_count - 1];
@@ -321,7 +304,6 @@ bcache::print_statistics (const char *type)
 	median_entry_size = 0;
       }
 
-    xfree (chain_length);
     xfree (entry_size);
   }
 
@@ -367,16 +349,6 @@ Total memory used by bcache, including overhead: %ld\n"),
 	      m_half_hash_miss_count);
   gdb_printf (_("    Hash table population:     "));
   print_percentage (occupied_buckets, m_num_buckets);
-  gdb_printf (_("    Median hash chain length:  %3d\n"),
-	      median_chain_length);
-  gdb_printf (_("    Average hash chain length: "));
-  if (m_num_buckets > 0)
-    gdb_printf ("%3lu\n", m_unique_count / m_num_buckets);
-  else
-    /* i18n: "Average hash chain length: (not applicable)".  */
-    gdb_printf (_("(not applicable)\n"));
-  gdb_printf (_("    Maximum hash chain length: %3d\n"), 
-	      max_chain_length);
   gdb_printf ("\n");
 }
 
@@ -62,56 +62,22 @@
    sharing its space with future duplicates.
 
 
-   Size of bcache VS hashtab:
+   Implementation notes:
 
-   For bcache, the most critical cost is size (or more exactly the
-   overhead added by the bcache).  It turns out that the bcache is
-   remarkably efficient.
+   The strings themselves are stored in an obstack arena, so the only
+   per-string heap overhead is the obstack's, and destroying the
+   bcache is a single obstack_free.  They are looked up through an
+   open-addressed hash table whose slots point into the arena.  The
+   table size is a power of two and is kept below 75% occupancy; a
+   probe uses double hashing, so it touches only the slot array --
+   there are no chain nodes to allocate or to chase through memory.
+   An earlier implementation used chained buckets; the open-addressed
+   table needs no per-string link field, which more than pays for the
+   extra empty slots.
 
-   Assuming a 32-bit system (the hash table slots are 4 bytes),
-   ignoring alignment, and limit strings to 255 bytes (1 byte length)
-   we get ...
+   Speed (the half hash hack):
 
-   bcache: This uses a separate linked list to track the hash chain.
-   The numbers show roughly 100% occupancy of the hash table and an
-   average chain length of 4.  Spreading the slot cost over the 4
-   chain elements:
-
-   4 (slot) / 4 (chain length) + 1 (length) + 4 (chain) = 6 bytes
-
-   hashtab: This uses a more traditional re-hash algorithm where the
-   chain is maintained within the hash table.  The table occupancy is
-   kept below 75% but we'll assume its perfect:
-
-   4 (slot) x 4/3 (occupancy) +  1 (length) = 6 1/3 bytes
-
-   So a perfect hashtab has just slightly larger than an average
-   bcache.
-
-   It turns out that an average hashtab is far worse.  Two things
-   hurt:
-
-   - Hashtab's occupancy is more like 50% (it ranges between 38% and
-   75%) giving a per slot cost of 4x2 vs 4x4/3.
-
-   - the string structure needs to be aligned to 8 bytes which for
-   hashtab wastes 7 bytes, while for bcache wastes only 3.
-
-   This gives:
-
-   hashtab: 4 x 2 + 1 + 7 = 16 bytes
-
-   bcache 4 / 4 + 1 + 4 + 3 = 9 bytes
-
-   The numbers of GDB debugging GDB support this.  ~40% vs ~70% overhead.
-
-
-   Speed of bcache VS hashtab (the half hash hack):
-
-   While hashtab has a typical chain length of 1, bcache has a chain
-   length of round 4.  This means that the bcache will require
-   something like double the number of compares after that initial
-   hash.  In both cases the comparison takes the form:
+   A probe's comparison takes the form:
 
    a.length == b.length && memcmp (a.data, b.data, a.length) == 0
 
@@ -130,10 +96,6 @@
    100% effective (only necessary length and memcmp tests being
    performed).
 
-   Mind you, looking at the wall clock, the same GDB debugging GDB
-   showed only marginal speed up (0.780 vs 0.773s).  Seems GDB is too
-   busy doing something else :-(
-  
 */
 
 namespace gdb {
@@ -154,6 +116,12 @@ struct bcache
 
   const void *insert (const void *addr, int length, bool *added = nullptr);
 
+  /* Pre-size the hash table so that N_ENTRIES more unique strings
+     can be inserted without causing it to grow.  This is useful
+     before interning a batch of strings whose size is known up
+     front.  */
+  void reserve (unsigned long n_entries);
+
   /* Print statistics on this bcache's memory usage and efficacity at
      eliminating duplication.  TYPE should be a string describing the
      kind of data this bcache holds.  Statistics are printed using
@@ -176,11 +144,14 @@ private:
   /* All the bstrings are allocated here.  */
   struct obstack m_cache {};
 
-  /* How many hash buckets we're using.  */
+  /* How many hash buckets we're using.  Always zero or a power of
+     two.  */
   unsigned int m_num_buckets = 0;
 
-  /* Hash buckets.  This table is allocated using malloc, so when we
-     grow the table we can return the old table to the system.  */
+  /* Hash buckets, using open addressing: each slot is either empty
+     or points at a single string in M_CACHE.  This table is
+     allocated using malloc, so when we grow the table we can return
+     the old table to the system.  */
   struct bstring **m_bucket = nullptr;
 
   /* Statistics.  */
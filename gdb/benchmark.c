@@ -0,0 +1,324 @@
+/* GDB microbenchmark harness.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "benchmark.h"
+#include "cli/cli-cmds.h"
+#include "cli/cli-option.h"
+#include "gdbsupport/buildargv.h"
+#include <algorithm>
+#include <chrono>
+
+namespace benchmarks
+{
+
+/* A registered benchmark.  */
+
+struct benchmark
+{
+  std::string name;
+  benchmark_function function;
+};
+
+/* All registered benchmarks, in registration order.  */
+
+static std::vector<benchmark> &all_benchmarks ()
+{
+  static std::vector<benchmark> benchmarks;
+  return benchmarks;
+}
+
+/* Thrown by skip_benchmark.  */
+
+struct benchmark_skipped
+{
+  std::string reason;
+};
+
+/* See benchmark.h.  */
+
+void
+register_benchmark (std::string name, benchmark_function function)
+{
+  auto &benchmarks = all_benchmarks ();
+
+  gdb_assert (std::none_of (benchmarks.begin (), benchmarks.end (),
+			    [&] (const benchmark &b)
+			    { return b.name == name; }));
+
+  benchmarks.push_back ({ std::move (name), std::move (function) });
+}
+
+/* See benchmark.h.  */
+
+void
+skip_benchmark (std::string reason)
+{
+  throw benchmark_skipped { std::move (reason) };
+}
+
+/* See benchmark.h.  */
+
+std::vector<const char *>
+all_benchmark_names ()
+{
+  std::vector<const char *> names;
+
+  names.reserve (all_benchmarks ().size ());
+  for (const benchmark &b : all_benchmarks ())
+    names.push_back (b.name.c_str ());
+
+  return names;
+}
+
+/* Run FUNCTION for N_ITERATIONS and return the elapsed wall-clock
+   time.  */
+
+static std::chrono::steady_clock::duration
+time_iterations (const benchmark_function &function,
+		 unsigned long n_iterations)
+{
+  auto start = std::chrono::steady_clock::now ();
+  function (n_iterations);
+  return std::chrono::steady_clock::now () - start;
+}
+
+/* The measurement result for one benchmark.  */
+
+struct benchmark_result
+{
+  /* The calibrated iteration count, or 0 if the benchmark was
+     skipped.  */
+  unsigned long iterations = 0;
+
+  /* Per-iteration wall-clock time of the fastest repeat.  */
+  double ns_per_iteration = 0;
+
+  /* Why the benchmark was skipped, if it was.  */
+  std::string skip_reason;
+};
+
+/* Measure one benchmark: grow the iteration count until a run takes
+   at least MIN_RUN_TIME, then repeat the measurement N_REPEATS times
+   and keep the fastest, which is the run least disturbed by the rest
+   of the system.  */
+
+static benchmark_result
+measure_benchmark (const benchmark &b)
+{
+  using namespace std::chrono;
+
+  constexpr steady_clock::duration min_run_time = milliseconds (100);
+  constexpr int n_repeats = 3;
+  constexpr unsigned long max_iterations = 1UL << 24;
+
+  benchmark_result result;
+
+  unsigned long n = 1;
+  steady_clock::duration elapsed = time_iterations (b.function, n);
+
+  while (elapsed < min_run_time && n < max_iterations)
+    {
+      n *= 2;
+      elapsed = time_iterations (b.function, n);
+      QUIT;
+    }
+
+  for (int i = 1; i < n_repeats; i++)
+    {
+      elapsed = std::min (elapsed, time_iterations (b.function, n));
+      QUIT;
+    }
+
+  result.iterations = n;
+  result.ns_per_iteration
+    = duration<double, std::nano> (elapsed).count () / n;
+
+  return result;
+}
+
+/* Append RESULT for the benchmark named NAME to the JSON array under
+   construction in OUT.  */
+
+static void
+json_append_result (std::string *out, const char *name,
+		    const benchmark_result &result)
+{
+  if (!out->empty ())
+    *out += ",\n";
+
+  /* Benchmark names and skip reasons contain no characters needing
+     JSON escaping.  */
+  if (result.iterations == 0)
+    string_appendf (*out, "  { \"name\": \"%s\", \"skipped\": \"%s\" }",
+		    name, result.skip_reason.c_str ());
+  else
+    string_appendf (*out,
+		    "  { \"name\": \"%s\", \"iterations\": %lu, "
+		    "\"ns_per_iteration\": %.1f }",
+		    name, result.iterations, result.ns_per_iteration);
+}
+
+/* See benchmark.h.  */
+
+void
+run_benchmarks (gdb::array_view<const char *const> filters, bool json)
+{
+  int ran = 0, skipped = 0;
+  std::string json_body;
+
+  for (const benchmark &b : all_benchmarks ())
+    {
+      if (!filters.empty ())
+	{
+	  bool matched = false;
+	  for (const char *filter : filters)
+	    if (b.name.find (filter) != std::string::npos)
+	      matched = true;
+	  if (!matched)
+	    continue;
+	}
+
+      benchmark_result result;
+      try
+	{
+	  result = measure_benchmark (b);
+	  ran++;
+	}
+      catch (const benchmark_skipped &skip)
+	{
+	  result.skip_reason = skip.reason;
+	  skipped++;
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  result.skip_reason = string_printf (_("error: %s"), ex.what ());
+	  skipped++;
+	}
+
+      if (json)
+	json_append_result (&json_body, b.name.c_str (), result);
+      else if (result.iterations == 0)
+	gdb_printf (_("%-32s skipped: %s\n"), b.name.c_str (),
+		    result.skip_reason.c_str ());
+      else
+	gdb_printf (_("%-32s %14.1f ns/iter  (%lu iterations)\n"),
+		    b.name.c_str (), result.ns_per_iteration,
+		    result.iterations);
+    }
+
+  if (json)
+    gdb_printf ("[\n%s\n]\n", json_body.c_str ());
+  else if (ran == 0 && skipped == 0)
+    gdb_printf (_("No benchmarks matched.\n"));
+  else
+    gdb_printf (_("Ran %d benchmarks, skipped %d.\n"), ran, skipped);
+}
+
+} /* namespace benchmarks */
+
+/* Options for the "maintenance benchmark" command.  */
+
+struct maintenance_benchmark_options
+{
+  bool json = false;
+};
+
+static const gdb::option::option_def maintenance_benchmark_option_defs[] = {
+  gdb::option::flag_option_def<maintenance_benchmark_options> {
+    "json",
+    [] (maintenance_benchmark_options *opt) { return &opt->json; },
+    N_("Print the results as a JSON array."),
+  },
+};
+
+/* Make option groups for the "maintenance benchmark" command.  */
+
+static std::array<gdb::option::option_def_group, 1>
+make_maintenance_benchmark_option_group (maintenance_benchmark_options *opts)
+{
+  return {{
+    {{maintenance_benchmark_option_defs}, opts},
+  }};
+}
+
+/* The "maintenance benchmark" command.  */
+
+static void
+maintenance_benchmark (const char *args, int from_tty)
+{
+  maintenance_benchmark_options opts;
+  auto grp = make_maintenance_benchmark_option_group (&opts);
+  gdb::option::process_options
+    (&args, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_ERROR, grp);
+  const gdb_argv argv (args);
+  benchmarks::run_benchmarks (argv.as_array_view (), opts.json);
+}
+
+/* Completer for the "maintenance benchmark" command.  */
+
+static void
+maintenance_benchmark_completer (cmd_list_element *cmd,
+				 completion_tracker &tracker,
+				 const char *text,
+				 const char *word)
+{
+  auto grp = make_maintenance_benchmark_option_group (nullptr);
+
+  if (gdb::option::complete_options
+	(tracker, &text, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_ERROR, grp))
+    return;
+
+  for (const char *name : benchmarks::all_benchmark_names ())
+    {
+      if (startswith (name, text))
+	tracker.add_completion (make_unique_xstrdup (name));
+    }
+}
+
+/* The "maintenance info benchmarks" command.  */
+
+static void
+maintenance_info_benchmarks (const char *args, int from_tty)
+{
+  gdb_printf (_("Registered benchmarks:\n"));
+  for (const char *name : benchmarks::all_benchmark_names ())
+    gdb_printf (" - %s\n", name);
+}
+
+void _initialize_benchmark ();
+void
+_initialize_benchmark ()
+{
+  cmd_list_element *bench_cmd
+    = add_cmd ("benchmark", class_maintenance, maintenance_benchmark, _("\
+Run microbenchmarks.\n\
+Usage: maintenance benchmark [-json] [FILTER...]\n\
+If FILTERs are given, only run benchmarks whose names contain one of\n\
+them.  Each benchmark is calibrated to a stable iteration count and\n\
+the fastest per-iteration wall-clock time is reported; with -json,\n\
+the results are printed as a JSON array."),
+	       &maintenancelist);
+  set_cmd_completer_handle_brkchars (bench_cmd,
+				     maintenance_benchmark_completer);
+
+  add_cmd ("benchmarks", class_maintenance, maintenance_info_benchmarks,
+	   _("List the registered benchmarks."),
+	   &maintenanceinfolist);
+}
@@ -0,0 +1,66 @@
+/* GDB microbenchmark harness.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "gdbsupport/array-view.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/* The performance counterpart of the selftests: a benchmark performs
+   some operation a requested number of times, and the harness behind
+   "maint benchmark" calibrates the iteration count, repeats the
+   measurement and reports the fastest per-iteration time.  */
+
+namespace benchmarks
+{
+
+/* The type of a benchmark function.  It must perform the measured
+   operation N_ITERATIONS times; any setup done before the iteration
+   loop is not measured.  */
+
+using benchmark_function = std::function<void (unsigned long n_iterations)>;
+
+/* Register FUNCTION as a benchmark under NAME.  */
+
+extern void register_benchmark (std::string name,
+				benchmark_function function);
+
+/* To be called from within a benchmark function: abandon the
+   benchmark because a prerequisite is not met (no program loaded, no
+   live target, ...), reporting REASON in its place.  */
+
+extern void skip_benchmark (std::string reason) ATTRIBUTE_NORETURN;
+
+/* Run the registered benchmarks whose names contain one of FILTERS,
+   or all of them if FILTERS is empty.  Results are printed one line
+   per benchmark, or as a JSON array if JSON is true.  */
+
+extern void run_benchmarks (gdb::array_view<const char *const> filters,
+			    bool json);
+
+/* The names of all registered benchmarks, in registration order.  */
+
+extern std::vector<const char *> all_benchmark_names ();
+
+} /* namespace benchmarks */
+
+#endif /* BENCHMARK_H */
@@ -26,6 +26,7 @@
 #include "addrmap.h"
 #include "gdbtypes.h"
 #include "objfiles.h"
+#include "observable.h"
 
 /* This is used by struct block to store namespace-related info for
    C++ files, namely using declarations and the current namespace in
@@ -120,6 +121,68 @@ block::inlined_p () const
   return function () != nullptr && function ()->is_inlined ();
 }
 
+/* A small per-program-space cache of PC-to-block lookups.  Within one
+   stop, blockvector_for_pc_sect is called many times for the same
+   handful of frame PCs -- once per frame for the sal, the function,
+   the language, and so on -- and each call repeats the compunit
+   search and blockvector binary search.  The cache is direct-mapped
+   and stores negative results too.  */
+
+#define BLOCK_CACHE_SIZE 32
+
+struct block_cache_entry
+{
+  /* The key.  */
+  CORE_ADDR pc;
+  struct obj_section *section;
+
+  /* The result: the blockvector and innermost block containing PC,
+     both NULL if PC is known to have no block.  */
+  const struct blockvector *bl;
+  const struct block *block;
+
+  /* True if this entry is in use.  */
+  bool valid;
+};
+
+struct block_cache
+{
+  struct block_cache_entry entries[BLOCK_CACHE_SIZE] {};
+};
+
+static const registry<program_space>::key<block_cache> block_cache_key;
+
+/* Return the block cache for PSPACE, allocating it if necessary.  */
+
+static struct block_cache *
+get_block_cache (program_space *pspace)
+{
+  block_cache *cache = block_cache_key.get (pspace);
+  if (cache == nullptr)
+    cache = block_cache_key.emplace (pspace);
+  return cache;
+}
+
+/* Return the cache entry for PC.  */
+
+static struct block_cache_entry *
+block_cache_slot (struct block_cache *cache, CORE_ADDR pc)
+{
+  /* Drop the low bits, which rarely distinguish nearby PCs.  */
+  return &cache->entries[(pc >> 2) % BLOCK_CACHE_SIZE];
+}
+
+/* See block.h.  */
+
+void
+invalidate_block_cache (program_space *pspace)
+{
+  block_cache *cache = block_cache_key.get (pspace);
+  if (cache != nullptr)
+    for (block_cache_entry &entry : cache->entries)
+      entry.valid = false;
+}
+
 /* A helper function that checks whether PC is in the blockvector BL.
    It returns the containing block if there is one, or else NULL.  */
 
@@ -181,19 +244,37 @@ blockvector_for_pc_sect (CORE_ADDR pc, struct obj_section *section,
 {
   const struct blockvector *bl;
   const struct block *b;
+  struct block_cache_entry *entry = nullptr;
 
   if (cust == NULL)
     {
+      /* Consult the cache.  This is only valid when the compunit is
+	 not dictated by the caller.  */
+      entry = block_cache_slot (get_block_cache (current_program_space), pc);
+      if (entry->valid && entry->pc == pc && entry->section == section)
+	{
+	  if (entry->bl != nullptr && pblock != nullptr)
+	    *pblock = entry->block;
+	  return entry->bl;
+	}
+
       /* First search all symtabs for one whose file contains our pc */
       cust = find_pc_sect_compunit_symtab (pc, section);
       if (cust == NULL)
-	return 0;
+	{
+	  *entry = { pc, section, nullptr, nullptr, true };
+	  return 0;
+	}
     }
 
   bl = cust->blockvector ();
 
   /* Then search that symtab for the smallest block that wins.  */
   b = find_block_in_blockvector (bl, pc);
+
+  if (entry != nullptr)
+    *entry = { pc, section, b == NULL ? nullptr : bl, b, true };
+
   if (b == NULL)
     return NULL;
 
@@ -832,3 +913,37 @@ make_blockranges (struct objfile *objfile,
   return blr;
 }
 
+/* This module's 'new_objfile' observer.  */
+
+static void
+block_new_objfile_observer (struct objfile *objfile)
+{
+  invalidate_block_cache (objfile->pspace);
+}
+
+/* This module's 'all_objfiles_removed' observer.  */
+
+static void
+block_all_objfiles_removed (program_space *pspace)
+{
+  invalidate_block_cache (pspace);
+}
+
+/* This module's 'free_objfile' observer.  */
+
+static void
+block_free_objfile_observer (struct objfile *objfile)
+{
+  invalidate_block_cache (objfile->pspace);
+}
+
+void _initialize_block ();
+void
+_initialize_block ()
+{
+  gdb::observers::new_objfile.attach (block_new_objfile_observer, "block");
+  gdb::observers::all_objfiles_removed.attach (block_all_objfiles_removed,
+					       "block");
+  gdb::observers::free_objfile.attach (block_free_objfile_observer, "block");
+}
+
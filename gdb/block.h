@@ -450,6 +450,12 @@ extern const struct block *block_for_pc (CORE_ADDR);
 
 extern const struct block *block_for_pc_sect (CORE_ADDR, struct obj_section *);
 
+/* Discard all cached PC-to-block lookups for PSPACE.  This must be
+   called whenever the mapping from addresses to blocks may have
+   changed, e.g. when an objfile is relocated.  */
+
+extern void invalidate_block_cache (struct program_space *pspace);
+
 /* A block iterator.  This structure should be treated as though it
    were opaque; it is only defined here because we want to support
    stack allocation of iterators.  */
@@ -33,6 +33,7 @@
 #include "command.h"
 #include "inferior.h"
 #include "infrun.h"
+#include "process-stratum-target.h"
 #include "gdbthread.h"
 #include "target.h"
 #include "language.h"
@@ -69,6 +70,7 @@
 #include "tid-parse.h"
 #include "cli/cli-style.h"
 #include "cli/cli-decode.h"
+#include "minsyms.h"
 #include <unordered_set>
 
 /* readline include files */
@@ -265,8 +267,48 @@ breakpoint_location_address_str (const bp_location *bl)
 
 static void update_global_location_list (enum ugll_insert_mode);
 
+static void update_global_location_list_1 (enum ugll_insert_mode);
+
 static void update_global_location_list_nothrow (enum ugll_insert_mode);
 
+/* Nesting depth of live scoped_defer_update_global_location_list
+   instances.  While positive, update_global_location_list calls other
+   than UGLL_INSERT ones only record that an update is needed, instead
+   of rebuilding the global location list; the outermost scope runs the
+   recorded update on exit.  */
+static int ugll_defer_depth = 0;
+
+/* True if an update_global_location_list call was postponed while
+   UGLL_DEFER_DEPTH was positive.  */
+static bool ugll_update_pending = false;
+
+/* The strongest insert mode seen among the postponed calls.  Relies on
+   the enumerators of ugll_insert_mode being declared from weakest to
+   strongest.  */
+static enum ugll_insert_mode ugll_pending_insert_mode = UGLL_DONT_INSERT;
+
+/* See breakpoint.h.  */
+
+scoped_defer_update_global_location_list
+::scoped_defer_update_global_location_list ()
+{
+  ugll_defer_depth++;
+}
+
+scoped_defer_update_global_location_list
+::~scoped_defer_update_global_location_list ()
+{
+  gdb_assert (ugll_defer_depth > 0);
+  if (--ugll_defer_depth == 0 && ugll_update_pending)
+    {
+      enum ugll_insert_mode insert_mode = ugll_pending_insert_mode;
+
+      ugll_update_pending = false;
+      ugll_pending_insert_mode = UGLL_DONT_INSERT;
+      update_global_location_list_nothrow (insert_mode);
+    }
+}
+
 static void insert_breakpoint_locations (void);
 
 static void trace_pass_command (const char *, int);
@@ -1052,6 +1094,8 @@ set_breakpoint_location_condition (const char *cond_string, bp_location *loc,
       else
 	{
 	  loc->cond = std::move (new_exp);
+	  loc->cond_host_bytecode.reset ();
+	  loc->cond_host_bytecode_failed = false;
 	  if (loc->disabled_by_cond && loc->enabled)
 	    gdb_printf (_("Breakpoint %d's condition is now valid at "
 			  "location %d, enabling.\n"),
@@ -1108,6 +1152,8 @@ set_breakpoint_condition (struct breakpoint *b, const char *exp,
 	  for (bp_location &loc : b->locations ())
 	    {
 	      loc.cond.reset ();
+	      loc.cond_host_bytecode.reset ();
+	      loc.cond_host_bytecode_failed = false;
 	      if (loc.disabled_by_cond && loc.enabled)
 		gdb_printf (_("Breakpoint %d's condition is now valid at "
 			      "location %d, enabling.\n"),
@@ -2059,6 +2105,69 @@ add_dummy_location (struct breakpoint *b,
    Therefore the hardware watchpoint hit can get safely reset on the
    watchpoint removal from inferior.  */
 
+/* Re-fill B's CACHED_MEM_REGIONS from VAL_CHAIN, the chain of values
+   left behind by evaluating B's watched expression.  The cache is
+   only usable if the expression's value depends on nothing but the
+   contents of memory lvalues in the chain; otherwise it is left
+   empty.  The walk mirrors can_use_hardware_watchpoint, and shares
+   its blind spot for inferior function calls.  */
+
+static void
+update_watched_mem_regions (struct watchpoint *b,
+			    const std::vector<value_ref_ptr> &val_chain)
+{
+  b->cached_mem_regions.clear ();
+
+  gdb_assert (!val_chain.empty ());
+  struct value *head = val_chain[0].get ();
+
+  for (const value_ref_ptr &iter : val_chain)
+    {
+      struct value *v = iter.get ();
+
+      if (v->lval () == lval_memory)
+	{
+	  /* A lazy memory lvalue in the chain is one that GDB never
+	     needed to fetch; it cannot influence the expression's
+	     value.  A lazy HEAD, however, means the value was not
+	     readable, so there are no contents to cache.  */
+	  if (v->lazy ())
+	    {
+	      if (v != head)
+		continue;
+
+	      b->cached_mem_regions.clear ();
+	      return;
+	    }
+
+	  struct type *vtype = check_typedef (v->type ());
+
+	  /* Match the regions update_watchpoint watches: structs and
+	     arrays are only watched when the user asked for them
+	     explicitly.  */
+	  if (v == head
+	      || (vtype->code () != TYPE_CODE_STRUCT
+		  && vtype->code () != TYPE_CODE_ARRAY))
+	    {
+	      gdb::array_view<const gdb_byte> contents = v->contents ();
+
+	      b->cached_mem_regions.emplace_back
+		(v->address (),
+		 gdb::byte_vector (contents.begin (), contents.end ()));
+	    }
+	}
+      else if (v->lval () != not_lval)
+	{
+	  /* Any other lvalue -- a register, an internal or convenience
+	     variable, a value from the history -- can change without
+	     any watched memory changing, so comparing memory contents
+	     cannot prove the expression's value unchanged.  */
+	  b->cached_mem_regions.clear ();
+	  return;
+	}
+    }
+}
+
 static void
 update_watchpoint (struct watchpoint *b, bool reparse)
 {
@@ -2359,6 +2468,16 @@ update_watchpoint (struct watchpoint *b, bool reparse)
 	    bl.loc_type = loc_type;
 	}
 
+      /* For software watchpoints, cache the contents of the watched
+	 memory regions, so that watchpoint_check can cheaply detect
+	 that nothing changed without re-evaluating the expression.
+	 The cache is of no use for hardware watchpoints, which are
+	 only checked when the hardware reports a hit.  */
+      if (b->type == bp_watchpoint)
+	update_watched_mem_regions (b, val_chain);
+      else
+	b->cached_mem_regions.clear ();
+
       /* If a software watchpoint is not watching any memory, then the
 	 above left it without any location set up.  But,
 	 bpstat_stop_status requires a location to be able to report
@@ -2821,6 +2940,95 @@ rethrow_on_target_close_error (const gdb_exception &e)
   throw;
 }
 
+/* Report the failure described by BP_EXCPT to insert software or
+   hardware breakpoint location BL, temporarily disabling shared
+   library breakpoints that can no longer be inserted.  The remaining
+   arguments are as for insert_bp_location.  Returns 0 if the location
+   was disabled instead of reporting an error, 1 otherwise.  */
+
+static int
+report_bp_location_insert_failure (struct bp_location *bl,
+				   const gdb_exception &bp_excpt,
+				   struct ui_file *tmp_error_stream,
+				   int *disabled_breaks,
+				   int *hw_breakpoint_error,
+				   int *hw_bp_error_explained_already)
+{
+  /* Can't set the breakpoint.  */
+  gdb_assert (bl->owner != nullptr);
+
+  /* In some cases, we might not be able to insert a
+     breakpoint in a shared library that has already been
+     removed, but we have not yet processed the shlib unload
+     event.  Unfortunately, some targets that implement
+     breakpoint insertion themselves can't tell why the
+     breakpoint insertion failed (e.g., the remote target
+     doesn't define error codes), so we must treat generic
+     errors as memory errors.  */
+  if (bp_excpt.reason == RETURN_ERROR
+      && (bp_excpt.error == GENERIC_ERROR
+	  || bp_excpt.error == MEMORY_ERROR)
+      && bl->loc_type == bp_loc_software_breakpoint
+      && (solib_name_from_address (bl->pspace, bl->address)
+	  || shared_objfile_contains_address_p (bl->pspace,
+						bl->address)))
+    {
+      /* See also: disable_breakpoints_in_shlibs.  */
+      bl->shlib_disabled = 1;
+      notify_breakpoint_modified (bl->owner);
+      if (!*disabled_breaks)
+	{
+	  gdb_printf (tmp_error_stream,
+		      "Cannot insert breakpoint %d.\n",
+		      bl->owner->number);
+	  gdb_printf (tmp_error_stream,
+		      "Temporarily disabling shared "
+		      "library breakpoints:\n");
+	}
+      *disabled_breaks = 1;
+      gdb_printf (tmp_error_stream,
+		  "breakpoint #%d\n", bl->owner->number);
+      return 0;
+    }
+  else
+    {
+      if (bl->loc_type == bp_loc_hardware_breakpoint)
+	{
+	  *hw_breakpoint_error = 1;
+	  *hw_bp_error_explained_already = bp_excpt.message != NULL;
+	  gdb_printf (tmp_error_stream,
+		      "Cannot insert hardware breakpoint %d%s",
+		      bl->owner->number,
+		      bp_excpt.message ? ":" : ".\n");
+	  if (bp_excpt.message != NULL)
+	    gdb_printf (tmp_error_stream, "%s.\n",
+			bp_excpt.what ());
+	}
+      else
+	{
+	  if (bp_excpt.message == NULL)
+	    {
+	      std::string message
+		= memory_error_message (TARGET_XFER_E_IO,
+					bl->gdbarch, bl->address);
+
+	      gdb_printf (tmp_error_stream,
+			  "Cannot insert breakpoint %d.\n"
+			  "%s\n",
+			  bl->owner->number, message.c_str ());
+	    }
+	  else
+	    {
+	      gdb_printf (tmp_error_stream,
+			  "Cannot insert breakpoint %d: %s\n",
+			  bl->owner->number,
+			  bp_excpt.what ());
+	    }
+	}
+      return 1;
+    }
+}
+
 /* Insert a low-level "breakpoint" of some type.  BL is the breakpoint
    location.  Any error messages are printed to TMP_ERROR_STREAM; and
    DISABLED_BREAKS, and HW_BREAKPOINT_ERROR are used to report problems.
@@ -2855,6 +3063,7 @@ insert_bp_location (struct bp_location *bl,
   bl->target_info.reqstd_address = bl->address;
   bl->target_info.placed_address_space = bl->pspace->aspace;
   bl->target_info.length = bl->length;
+  bl->target_info.pipelined_insert_failed = 0;
 
   /* When working with target-side conditions, we must pass all the conditions
      for the same breakpoint address down to the target since GDB will not
@@ -2988,82 +3197,11 @@ insert_bp_location (struct bp_location *bl,
 	}
 
       if (bp_excpt.reason != 0)
-	{
-	  /* Can't set the breakpoint.  */
-	  gdb_assert (bl->owner != nullptr);
-
-	  /* In some cases, we might not be able to insert a
-	     breakpoint in a shared library that has already been
-	     removed, but we have not yet processed the shlib unload
-	     event.  Unfortunately, some targets that implement
-	     breakpoint insertion themselves can't tell why the
-	     breakpoint insertion failed (e.g., the remote target
-	     doesn't define error codes), so we must treat generic
-	     errors as memory errors.  */
-	  if (bp_excpt.reason == RETURN_ERROR
-	      && (bp_excpt.error == GENERIC_ERROR
-		  || bp_excpt.error == MEMORY_ERROR)
-	      && bl->loc_type == bp_loc_software_breakpoint
-	      && (solib_name_from_address (bl->pspace, bl->address)
-		  || shared_objfile_contains_address_p (bl->pspace,
-							bl->address)))
-	    {
-	      /* See also: disable_breakpoints_in_shlibs.  */
-	      bl->shlib_disabled = 1;
-	      notify_breakpoint_modified (bl->owner);
-	      if (!*disabled_breaks)
-		{
-		  gdb_printf (tmp_error_stream, 
-			      "Cannot insert breakpoint %d.\n", 
-			      bl->owner->number);
-		  gdb_printf (tmp_error_stream, 
-			      "Temporarily disabling shared "
-			      "library breakpoints:\n");
-		}
-	      *disabled_breaks = 1;
-	      gdb_printf (tmp_error_stream,
-			  "breakpoint #%d\n", bl->owner->number);
-	      return 0;
-	    }
-	  else
-	    {
-	      if (bl->loc_type == bp_loc_hardware_breakpoint)
-		{
-		  *hw_breakpoint_error = 1;
-		  *hw_bp_error_explained_already = bp_excpt.message != NULL;
-		  gdb_printf (tmp_error_stream,
-			      "Cannot insert hardware breakpoint %d%s",
-			      bl->owner->number,
-			      bp_excpt.message ? ":" : ".\n");
-		  if (bp_excpt.message != NULL)
-		    gdb_printf (tmp_error_stream, "%s.\n",
-				bp_excpt.what ());
-		}
-	      else
-		{
-		  if (bp_excpt.message == NULL)
-		    {
-		      std::string message
-			= memory_error_message (TARGET_XFER_E_IO,
-						bl->gdbarch, bl->address);
-
-		      gdb_printf (tmp_error_stream,
-				  "Cannot insert breakpoint %d.\n"
-				  "%s\n",
-				  bl->owner->number, message.c_str ());
-		    }
-		  else
-		    {
-		      gdb_printf (tmp_error_stream,
-				  "Cannot insert breakpoint %d: %s\n",
-				  bl->owner->number,
-				  bp_excpt.what ());
-		    }
-		}
-	      return 1;
-
-	    }
-	}
+	return report_bp_location_insert_failure (bl, bp_excpt,
+						  tmp_error_stream,
+						  disabled_breaks,
+						  hw_breakpoint_error,
+						  hw_bp_error_explained_already);
       else
 	bl->inserted = 1;
 
@@ -3266,40 +3404,90 @@ insert_breakpoint_locations (void)
 
   scoped_restore_current_pspace_and_thread restore_pspace_thread;
 
-  for (bp_location *bl : all_bp_locations ())
+  /* Give the targets a chance to pipeline the insertion requests
+     instead of waiting for each reply in turn.  */
+  for (process_stratum_target *target : all_non_exited_process_targets ())
     {
-      if (!should_be_inserted (bl) || (bl->inserted && !bl->needs_update))
-	continue;
+      switch_to_target_no_thread (target);
+      target_breakpoint_batch_begin ();
+    }
 
-      /* There is no point inserting thread-specific breakpoints if
-	 the thread no longer exists.  ALL_BP_LOCATIONS bp_location
-	 has BL->OWNER always non-NULL.  */
-      if (bl->owner->thread != -1
-	  && !valid_global_thread_id (bl->owner->thread))
-	continue;
+  try
+    {
+      for (bp_location *bl : all_bp_locations ())
+	{
+	  if (!should_be_inserted (bl) || (bl->inserted && !bl->needs_update))
+	    continue;
 
-      /* Or inferior specific breakpoints if the inferior no longer
-	 exists.  */
-      if (bl->owner->inferior != -1
-	  && !valid_global_inferior_id (bl->owner->inferior))
-	continue;
+	  /* There is no point inserting thread-specific breakpoints if
+	     the thread no longer exists.  ALL_BP_LOCATIONS bp_location
+	     has BL->OWNER always non-NULL.  */
+	  if (bl->owner->thread != -1
+	      && !valid_global_thread_id (bl->owner->thread))
+	    continue;
 
-      switch_to_program_space_and_thread (bl->pspace);
+	  /* Or inferior specific breakpoints if the inferior no longer
+	     exists.  */
+	  if (bl->owner->inferior != -1
+	      && !valid_global_inferior_id (bl->owner->inferior))
+	    continue;
 
-      /* For targets that support global breakpoints, there's no need
-	 to select an inferior to insert breakpoint to.  In fact, even
-	 if we aren't attached to any process yet, we should still
-	 insert breakpoints.  */
-      if (!gdbarch_has_global_breakpoints (target_gdbarch ())
-	  && (inferior_ptid == null_ptid || !target_has_execution ()))
-	continue;
+	  switch_to_program_space_and_thread (bl->pspace);
 
-      val = insert_bp_location (bl, &tmp_error_stream, &disabled_breaks,
-				    &hw_breakpoint_error, &hw_bp_error_explained_already);
-      if (val)
-	error_flag = val;
+	  /* For targets that support global breakpoints, there's no need
+	     to select an inferior to insert breakpoint to.  In fact, even
+	     if we aren't attached to any process yet, we should still
+	     insert breakpoints.  */
+	  if (!gdbarch_has_global_breakpoints (target_gdbarch ())
+	      && (inferior_ptid == null_ptid || !target_has_execution ()))
+	    continue;
+
+	  val = insert_bp_location (bl, &tmp_error_stream, &disabled_breaks,
+				    &hw_breakpoint_error,
+				    &hw_bp_error_explained_already);
+	  if (val)
+	    error_flag = val;
+	}
+    }
+  catch (const gdb_exception &)
+    {
+      for (process_stratum_target *target : all_non_exited_process_targets ())
+	{
+	  switch_to_target_no_thread (target);
+	  target_breakpoint_batch_done ();
+	}
+      throw;
     }
 
+  for (process_stratum_target *target : all_non_exited_process_targets ())
+    {
+      switch_to_target_no_thread (target);
+      target_breakpoint_batch_done ();
+    }
+
+  /* Resolve insertions whose outcome the target only reported once
+     the batch was finished.  */
+  for (bp_location *bl : all_bp_locations ())
+    if (bl->inserted && bl->target_info.pipelined_insert_failed)
+      {
+	bl->inserted = 0;
+	bl->target_info.pipelined_insert_failed = 0;
+
+	/* The remote target doesn't define error codes; treat the
+	   failure like a generic error, as the synchronous path
+	   does.  */
+	gdb_exception bp_excpt {RETURN_ERROR, GENERIC_ERROR};
+
+	switch_to_program_space_and_thread (bl->pspace);
+	val = report_bp_location_insert_failure (bl, bp_excpt,
+						 &tmp_error_stream,
+						 &disabled_breaks,
+						 &hw_breakpoint_error,
+						 &hw_bp_error_explained_already);
+	if (val)
+	  error_flag = val;
+      }
+
   /* If we failed to insert all locations of a watchpoint, remove
      them, as half-inserted watchpoint is of limited use.  */
   for (breakpoint &bpt : all_breakpoints ())
@@ -5131,6 +5319,58 @@ breakpoint_cond_eval (expression *exp)
   return value_true (exp->evaluate ());
 }
 
+/* Try to evaluate BL's condition as host-side agent expression
+   bytecode, which is much cheaper than walking the condition's
+   expression tree.  The bytecode is compiled on first use and kept
+   on BL.  Return true and set *RESULT if the condition could be
+   evaluated this way; return false to fall back to a full
+   evaluation.  */
+
+static bool
+breakpoint_cond_eval_bytecode (bp_location *bl, bool *result)
+{
+  if (bl->cond_host_bytecode == nullptr)
+    {
+      if (bl->cond_host_bytecode_failed)
+	return false;
+
+      agent_expr_up aexpr = parse_cond_to_aexpr (bl->address,
+						 bl->cond.get ());
+
+      /* Conditions involving locals described by legacy debug info
+	 compile to bytecode that only approximates the frame base;
+	 those need a full evaluation to get exact values.  Also
+	 verify the generated code is sound before trusting it.  */
+      if (aexpr != nullptr && !aexpr->virtual_frame_pointer_used)
+	{
+	  ax_reqs (aexpr.get ());
+	  if (aexpr->flaw == agent_flaw_none)
+	    bl->cond_host_bytecode = std::move (aexpr);
+	}
+
+      if (bl->cond_host_bytecode == nullptr)
+	{
+	  bl->cond_host_bytecode_failed = true;
+	  return false;
+	}
+    }
+
+  try
+    {
+      *result = ax_eval (bl->cond_host_bytecode.get ()) != 0;
+      return true;
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* Fall back to a full evaluation, which either works or
+	 produces a proper error message.  Don't give up on the
+	 bytecode; the error may be transient, e.g. an unreadable
+	 memory reference that the condition does not always
+	 reach.  */
+      return false;
+    }
+}
+
 /* Allocate a new bpstat.  Link it to the FIFO list by BS_LINK_POINTER.  */
 
 bpstat::bpstat (struct bp_location *bl, bpstat ***bs_link_pointer)
@@ -5328,9 +5568,49 @@ watchpoint_check (bpstat *bs)
 	   a mask watchpoint.  */
 	return WP_VALUE_CHANGED;
 
+      /* For a software watchpoint whose value depends only on the
+	 contents of the regions cached in CACHED_MEM_REGIONS, first
+	 compare those raw contents against the inferior.  If no byte
+	 changed, the expression's value cannot have changed either,
+	 and re-evaluating it can be skipped.  Software watchpoints
+	 come through here at every single-step, so this saves
+	 re-evaluating the expression on the overwhelming majority of
+	 steps.  */
+      if (b->type == bp_watchpoint && b->val_valid && b->val != nullptr
+	  && !b->cached_mem_regions.empty ())
+	{
+	  bool changed = false;
+
+	  for (const watch_mem_region &region : b->cached_mem_regions)
+	    {
+	      gdb::byte_vector contents (region.contents.size ());
+
+	      if (target_read_memory (region.addr, contents.data (),
+				      contents.size ()) != 0
+		  || memcmp (contents.data (), region.contents.data (),
+			     contents.size ()) != 0)
+		{
+		  changed = true;
+		  break;
+		}
+	    }
+
+	  if (!changed)
+	    return WP_VALUE_NOT_CHANGED;
+	}
+
+      std::vector<value_ref_ptr> val_chain;
+
       mark = value_mark ();
       fetch_subexp_value (b->exp.get (), b->exp->op.get (), &new_val,
-			  NULL, NULL, false);
+			  NULL, &val_chain, false);
+
+      /* Refresh the contents cache to match the evaluation just done.
+	 This also updates the region addresses, in case the
+	 expression's value now lives somewhere else (e.g. `watch *p'
+	 after P changed).  */
+      if (b->type == bp_watchpoint)
+	update_watched_mem_regions (b, val_chain);
 
       if (b->val_bitsize != 0)
 	new_val = extract_bitfield_from_watchpoint_value (b, new_val);
@@ -5692,7 +5972,19 @@ bpstat_check_breakpoint_conditions (bpstat *bs, thread_info *thread)
 	{
 	  try
 	    {
-	      condition_result = breakpoint_cond_eval (cond);
+	      /* For plain breakpoint conditions, first try the much
+		 cheaper evaluation as host-side bytecode; conditions
+		 it cannot handle fall back to a full evaluation of
+		 the expression tree.  */
+	      bool bytecode_result;
+
+	      if (w == nullptr
+		  && cond == bl->cond.get ()
+		  && breakpoint_cond_eval_bytecode (bs->bp_location_at.get (),
+						    &bytecode_result))
+		condition_result = bytecode_result;
+	      else
+		condition_result = breakpoint_cond_eval (cond);
 	    }
 	  catch (const gdb_exception_error &ex)
 	    {
@@ -7688,6 +7980,10 @@ set_longjmp_breakpoint (struct thread_info *tp, struct frame_id frame)
 {
   int thread = tp->global_num;
 
+  /* This runs on every step/next; rebuild the global location list
+     only once, no matter how many masters are cloned below.  */
+  scoped_defer_update_global_location_list defer;
+
   /* To avoid having to rescan all objfile symbols at every step,
      we maintain a list of continually-inserted but always disabled
      longjmp "master" breakpoints.  Here, we simply create momentary
@@ -7745,6 +8041,10 @@ set_longjmp_breakpoint_for_call_dummy (void)
 {
   breakpoint *retval = nullptr;
 
+  /* Rebuild the global location list only once, no matter how many
+     masters are cloned below.  */
+  scoped_defer_update_global_location_list defer;
+
   for (breakpoint &b : all_breakpoints ())
     if (b.pspace == current_program_space && b.type == bp_longjmp_master)
       {
@@ -7858,6 +8158,8 @@ check_longjmp_breakpoint_for_call_dummy (struct thread_info *tp)
 void
 enable_overlay_breakpoints (void)
 {
+  scoped_defer_update_global_location_list defer;
+
   for (breakpoint &b : all_breakpoints ())
     if (b.type == bp_overlay_event)
       {
@@ -7870,6 +8172,8 @@ enable_overlay_breakpoints (void)
 void
 disable_overlay_breakpoints (void)
 {
+  scoped_defer_update_global_location_list defer;
+
   for (breakpoint &b : all_breakpoints ())
     if (b.type == bp_overlay_event)
       {
@@ -7884,6 +8188,10 @@ disable_overlay_breakpoints (void)
 void
 set_std_terminate_breakpoint (void)
 {
+  /* Rebuild the global location list only once, no matter how many
+     masters are cloned below.  */
+  scoped_defer_update_global_location_list defer;
+
   for (breakpoint &b : all_breakpoints_safe ())
     if (b.pspace == current_program_space
 	&& b.type == bp_std_terminate_master)
@@ -11428,16 +11736,10 @@ force_breakpoint_reinsertion (struct bp_location *bl)
     }
 }
 
-/* Called whether new breakpoints are created, or existing breakpoints
-   deleted, to update the global location list and recompute which
-   locations are duplicate of which.
-
-   The INSERT_MODE flag determines whether locations may not, may, or
-   shall be inserted now.  See 'enum ugll_insert_mode' for more
-   info.  */
+/* Worker for update_global_location_list, which see.  */
 
 static void
-update_global_location_list (enum ugll_insert_mode insert_mode)
+update_global_location_list_1 (enum ugll_insert_mode insert_mode)
 {
   /* Last breakpoint location address that was marked for update.  */
   CORE_ADDR last_addr = 0;
@@ -11786,6 +12088,34 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
     download_tracepoint_locations ();
 }
 
+/* Called whether new breakpoints are created, or existing breakpoints
+   deleted, to update the global location list and recompute which
+   locations are duplicate of which.
+
+   The INSERT_MODE flag determines whether locations may not, may, or
+   shall be inserted now.  See 'enum ugll_insert_mode' for more
+   info.  */
+
+static void
+update_global_location_list (enum ugll_insert_mode insert_mode)
+{
+  if (ugll_defer_depth > 0 && insert_mode != UGLL_INSERT)
+    {
+      /* A scoped_defer_update_global_location_list is live; record the
+	 request and let the outermost scope act on it.  UGLL_INSERT
+	 calls cannot be postponed, as the caller needs the locations
+	 inserted before resuming the inferior.  */
+      ugll_update_pending = true;
+      ugll_pending_insert_mode = std::max (ugll_pending_insert_mode,
+					   insert_mode);
+      breakpoint_debug_printf ("deferred, insert_mode = %s",
+			       ugll_insert_mode_text (insert_mode));
+      return;
+    }
+
+  update_global_location_list_1 (insert_mode);
+}
+
 void
 breakpoint_retire_moribund (void)
 {
@@ -12710,9 +13040,13 @@ delete_breakpoint (struct breakpoint *bpt)
      self-contained, but it's not the case now.
 
      Clear the location linked list first, otherwise, the intrusive_list
-     destructor accesses the locations after they are freed.  */
+     destructor accesses the locations after they are freed.
+
+     Call the worker directly, bypassing any live
+     scoped_defer_update_global_location_list -- the update cannot be
+     postponed past the point the breakpoint is freed.  */
   bpt->clear_locations ();
-  update_global_location_list (UGLL_DONT_INSERT);
+  update_global_location_list_1 (UGLL_DONT_INSERT);
 
   /* On the chance that someone will soon try again to delete this
      same bp, we mark it as deleted before freeing its storage.  */
@@ -13277,12 +13611,132 @@ breakpoint_re_set_one (breakpoint *b)
   b->re_set ();
 }
 
-/* Re-set breakpoint locations for the current program space.
+/* Return true if re-setting B's locations could be affected by the
+   newly-loaded objfile OBJF.  This is an optimization only: it is
+   always correct to return true, the filter merely avoids re-parsing
+   location specs that cannot possibly resolve to anything in OBJF.
+   Used by breakpoint_re_set_new_objfiles, which see.  */
+
+static bool
+breakpoint_plausibly_in_objfile_p (struct breakpoint *b,
+				   struct objfile *objf)
+{
+  location_spec *locspec = b->locspec.get ();
+
+  /* Breakpoints without a location spec (watchpoints, catchpoints,
+     internal breakpoints, ...) have re_set methods with their own
+     dependencies; re-set them unconditionally.  */
+  if (locspec == nullptr)
+    return true;
+
+  const char *function_name;
+  symbol_name_match_type match_type;
+
+  switch (locspec->type ())
+    {
+    case LINESPEC_LOCATION_SPEC:
+      {
+	const linespec_location_spec *ls
+	  = as_linespec_location_spec (locspec);
+
+	function_name = ls->spec_string;
+	match_type = ls->match_type;
+
+	/* Only treat the spec as a plain function name if it doesn't
+	   use any other linespec syntax (address, line number, label,
+	   explicit options, ...).  Anything more complicated is
+	   conservatively re-set.  */
+	if (function_name == nullptr
+	    || strpbrk (function_name, "*+-, \t") != nullptr
+	    || isdigit (function_name[0]))
+	  return true;
+
+	/* A colon that is not part of a C++ '::' scope operator
+	   means a source file or a label is involved.  */
+	for (const char *p = function_name; *p != '\0'; p++)
+	  if (p[0] == ':')
+	    {
+	      if (p[1] == ':')
+		p++;
+	      else
+		return true;
+	    }
+      }
+      break;
+
+    case EXPLICIT_LOCATION_SPEC:
+      {
+	const explicit_location_spec *es
+	  = as_explicit_location_spec (locspec);
+
+	/* Specs naming a source file or a label, or without a
+	   function name, are conservatively re-set.  */
+	if (es->source_filename != nullptr
+	    || es->label_name != nullptr
+	    || es->function_name == nullptr)
+	  return true;
+
+	function_name = es->function_name;
+	match_type = es->func_name_match_type;
+      }
+      break;
+
+    default:
+      /* Address and probe location specs are conservatively
+	 re-set.  */
+      return true;
+    }
+
+  lookup_name_info lookup_name (function_name, match_type, false);
+
+  /* Check the minimal symbols first; this covers objfiles without
+     debug info, and is cheap.  */
+  bool found = false;
+  iterate_over_minimal_symbols (objf, lookup_name,
+				[&] (struct minimal_symbol *msym)
+				{
+				  found = true;
+				  return true;
+				});
+  if (found)
+    return true;
+
+  /* Then consult the index, including any separate debug objfiles:
+     for a stripped library the parent's index is empty and the debug
+     info lives in the .gnu_debuglink/build-id objfile.  This only
+     expands a symtab if the name actually matches, in which case the
+     re-set needs it expanded anyway.  */
+  for (objfile *o : objf->separate_debug_objfiles ())
+    {
+      o->expand_symtabs_matching (NULL, &lookup_name, NULL,
+				  [&] (compunit_symtab *symtab)
+				  {
+				    found = true;
+				    return false;
+				  },
+				  (SEARCH_GLOBAL_BLOCK
+				   | SEARCH_STATIC_BLOCK),
+				  UNDEF_DOMAIN,
+				  FUNCTIONS_DOMAIN);
+      if (found)
+	break;
+    }
+  return found;
+}
+
+/* Worker for breakpoint_re_set and breakpoint_re_set_new_objfiles.
+   Re-set breakpoint locations for the current program space,
+   skipping breakpoints for which FILTER, if non-NULL, returns false.
    Locations bound to other program spaces are left untouched.  */
 
-void
-breakpoint_re_set (void)
+static void
+breakpoint_re_set_1 (gdb::function_view<bool (breakpoint &)> filter)
 {
+  /* Re-setting touches every breakpoint, and re-creating the event
+     master breakpoints below creates several more; rebuild the global
+     location list once at the end instead of once per breakpoint.  */
+  scoped_defer_update_global_location_list defer;
+
   {
     scoped_restore_current_language save_language;
     scoped_restore save_input_radix = make_scoped_restore (&input_radix);
@@ -13308,6 +13762,9 @@ breakpoint_re_set (void)
 
     for (breakpoint &b : all_breakpoints_safe ())
       {
+	if (filter != nullptr && !filter (b))
+	  continue;
+
 	try
 	  {
 	    breakpoint_re_set_one (&b);
@@ -13331,6 +13788,30 @@ breakpoint_re_set (void)
   /* Now we can insert.  */
   update_global_location_list (UGLL_MAY_INSERT);
 }
+
+/* Re-set breakpoint locations for the current program space.
+   Locations bound to other program spaces are left untouched.  */
+
+void
+breakpoint_re_set (void)
+{
+  breakpoint_re_set_1 (nullptr);
+}
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set_new_objfiles (const std::vector<objfile *> &new_objfiles)
+{
+  breakpoint_re_set_1 ([&] (breakpoint &b)
+    {
+      for (objfile *objf : new_objfiles)
+	if (breakpoint_plausibly_in_objfile_p (&b, objf))
+	  return true;
+
+      return false;
+    });
+}
 
 /* Reset the thread number of this breakpoint:
 
@@ -13978,6 +14459,29 @@ insert_single_step_breakpoint (struct gdbarch *gdbarch,
   struct symtab_and_line sal;
   CORE_ADDR pc = next_pc;
 
+  if (tp->control.single_step_breakpoints == NULL
+      && tp->control.cached_single_step_breakpoints != NULL)
+    {
+      /* See whether we can reuse the single-step breakpoint recycled
+	 from the previous step, avoiding removing and re-inserting
+	 the same locations on the target.  Don't reuse it if it has
+	 accumulated many locations (e.g., from stepping through a
+	 long stretch of code); starting afresh is then cheaper than
+	 having other threads keep tripping on the stale ones.  */
+      breakpoint *cached = tp->control.cached_single_step_breakpoints;
+
+      if (cached->gdbarch == gdbarch
+	  && cached->pspace == current_program_space
+	  && std::distance (cached->locations ().begin (),
+			    cached->locations ().end ()) < 32)
+	{
+	  tp->control.single_step_breakpoints = cached;
+	  tp->control.cached_single_step_breakpoints = NULL;
+	}
+      else
+	flush_single_step_breakpoint_cache (tp);
+    }
+
   if (tp->control.single_step_breakpoints == NULL)
     {
       std::unique_ptr<breakpoint> b
@@ -13990,14 +14494,21 @@ insert_single_step_breakpoint (struct gdbarch *gdbarch,
 	= add_to_breakpoint_chain (std::move (b));
     }
 
+  auto *ss_bp
+    = (gdb::checked_static_cast<momentary_breakpoint *>
+       (tp->control.single_step_breakpoints));
+
+  /* If this breakpoint was recycled from the previous step, it may
+     already have an inserted location at PC, e.g., when stepping
+     through a loop; then there is nothing left to do.  */
+  if (breakpoint_has_location_inserted_here (ss_bp, aspace, pc))
+    return;
+
   sal = find_pc_line (pc, 0);
   sal.pc = pc;
   sal.section = find_pc_overlay (pc);
   sal.explicit_pc = 1;
 
-  auto *ss_bp
-    = (gdb::checked_static_cast<momentary_breakpoint *>
-       (tp->control.single_step_breakpoints));
   ss_bp->add_location (sal);
 
   update_global_location_list (UGLL_INSERT);
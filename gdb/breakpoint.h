@@ -28,6 +28,7 @@
 #include "location.h"
 #include <vector>
 #include "gdbsupport/array-view.h"
+#include "gdbsupport/byte-vector.h"
 #include "gdbsupport/filtered-iterator.h"
 #include "gdbsupport/function-view.h"
 #include "gdbsupport/next-iterator.h"
@@ -296,6 +297,12 @@ struct bp_target_info
   /* Flag that is true if the breakpoint should be left in place even
      when GDB is not connected.  */
   int persist;
+
+  /* Set by targets that pipeline breakpoint insertion (see
+     target_ops::breakpoint_batch_begin) when the deferred reply for
+     this location's insertion request reported a failure.  Only
+     meaningful after target_breakpoint_batch_done returns.  */
+  int pipelined_insert_failed;
 };
 
 /* GDB maintains two types of information about each breakpoint (or
@@ -358,6 +365,18 @@ public:
      condition evaluation.  */
   agent_expr_up cond_bytecode;
 
+  /* Conditional expression in agent expression bytecode form, for
+     evaluation on the host.  Evaluating the flat bytecode is much
+     cheaper than walking COND's expression tree, which matters for
+     conditions checked many times.  Lazily compiled the first time
+     the condition is checked; cleared whenever the condition
+     changes.  */
+  agent_expr_up cond_host_bytecode;
+
+  /* True if COND could not be compiled to bytecode usable for host
+     evaluation, so there is no point in trying again.  */
+  bool cond_host_bytecode_failed = false;
+
   /* Signals that the condition has changed since the last time
      we updated the global location list.  This means the condition
      needs to be sent to the target again.  This is used together
@@ -984,6 +1003,24 @@ protected:
 /* An instance of this type is used to represent a watchpoint,
    a.k.a. a data breakpoint.  */
 
+/* A memory region a watched expression depends on, along with a copy
+   of its last-known contents.  Used by software watchpoints to avoid
+   re-evaluating the watched expression at every single-step.  */
+
+struct watch_mem_region
+{
+  watch_mem_region (CORE_ADDR addr_, gdb::byte_vector &&contents_)
+    : addr (addr_), contents (std::move (contents_))
+  {}
+
+  /* The inferior address of the region.  */
+  CORE_ADDR addr;
+
+  /* The region's contents as of the last time the watched expression
+     was evaluated.  */
+  gdb::byte_vector contents;
+};
+
 struct watchpoint : public breakpoint
 {
   using breakpoint::breakpoint;
@@ -1066,6 +1103,14 @@ struct watchpoint : public breakpoint
   /* Whether this hardware watchpoint triggers on writes where the value
      doesn't change.  */
   bool no_change;
+
+  /* For a software watchpoint, the memory regions the watched
+     expression depends on, with their contents as of the last time
+     the expression was evaluated.  Empty if the expression's value
+     may depend on more than the contents of these regions (e.g., on
+     a register), in which case watchpoint_check must always
+     re-evaluate it.  */
+  std::vector<watch_mem_region> cached_mem_regions;
 };
 
 /* Return true if BPT is either a software breakpoint or a hardware
@@ -1504,6 +1549,15 @@ extern void update_breakpoint_locations
 
 extern void breakpoint_re_set (void);
 
+/* Like breakpoint_re_set, but only re-set breakpoints that could
+   plausibly resolve differently now that the objfiles in
+   NEW_OBJFILES have had their symbols loaded or relocated.
+   Breakpoints whose location specs cannot refer to anything in those
+   objfiles are left untouched.  */
+
+extern void breakpoint_re_set_new_objfiles
+  (const std::vector<struct objfile *> &new_objfiles);
+
 extern void breakpoint_re_set_thread (struct breakpoint *);
 
 extern void delete_breakpoint (struct breakpoint *);
@@ -1518,6 +1572,23 @@ struct breakpoint_deleter
 
 typedef std::unique_ptr<struct breakpoint, breakpoint_deleter> breakpoint_up;
 
+/* RAII class used to batch consecutive breakpoint creations into a
+   single rebuild of the global location list.  Useful around code that
+   creates several breakpoints in a row, where each creation would
+   otherwise trigger a full rebuild.  Deleting breakpoints while an
+   instance is live is safe: delete_breakpoint rebuilds the list
+   directly, bypassing the deferral, as its locations must be removed
+   from the list before the breakpoint is freed.  */
+
+class scoped_defer_update_global_location_list
+{
+public:
+  scoped_defer_update_global_location_list ();
+  ~scoped_defer_update_global_location_list ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_defer_update_global_location_list);
+};
+
 extern breakpoint_up set_momentary_breakpoint
   (struct gdbarch *, struct symtab_and_line, struct frame_id, enum bptype);
 
@@ -1304,13 +1304,19 @@ handle_pt_insn_event_flags (struct btrace_thread_info *btinfo,
 #endif /* defined (HAVE_STRUCT_PT_INSN_RESYNCED) */
 }
 
-/* Add function branch trace to BTINFO using DECODER.  */
+/* Add function branch trace to BTINFO using DECODER.
+
+   If RESYNC is true, synchronize the first iteration at SYNC_OFFSET
+   to resume an incremental decode.  If TRACK is true, record each
+   synchronization point in BTINFO->PT_SYNC so the next decode can
+   resume at the last one.  */
 
 static void
 ftrace_add_pt (struct btrace_thread_info *btinfo,
 	       struct pt_insn_decoder *decoder,
 	       int *plevel,
-	       std::vector<unsigned int> &gaps)
+	       std::vector<unsigned int> &gaps,
+	       uint64_t sync_offset, bool resync, bool track)
 {
   struct btrace_function *bfun;
   uint64_t offset;
@@ -1320,7 +1326,13 @@ ftrace_add_pt (struct btrace_thread_info *btinfo,
     {
       struct pt_insn insn;
 
-      status = pt_insn_sync_forward (decoder);
+      if (resync)
+	{
+	  status = pt_insn_sync_set (decoder, sync_offset);
+	  resync = false;
+	}
+      else
+	status = pt_insn_sync_forward (decoder);
       if (status < 0)
 	{
 	  if (status != -pte_eos)
@@ -1329,6 +1341,19 @@ ftrace_add_pt (struct btrace_thread_info *btinfo,
 	  break;
 	}
 
+      /* Remember the synchronization point and how much trace had been
+	 decoded when we reached it.  If more trace arrives, the next
+	 decode picks up from the last one instead of starting over.  */
+      if (track && pt_insn_get_sync_offset (decoder, &offset) == 0)
+	{
+	  btinfo->pt_sync.sync_offset = offset;
+	  btinfo->pt_sync.nfunctions = btinfo->functions.size ();
+	  btinfo->pt_sync.ninsns
+	    = (btinfo->functions.empty ()
+	       ? 0 : btinfo->functions.back ().insn.size ());
+	  btinfo->pt_sync.valid = true;
+	}
+
       for (;;)
 	{
 	  /* Handle events from the previous iteration or synchronization.  */
@@ -1452,9 +1477,27 @@ btrace_compute_ftrace_pt (struct thread_info *tp,
   else
     level = -btinfo->level;
 
+  /* When resuming an incremental decode, decode the accumulated raw
+     trace from the last synchronization point onwards; BTRACE holds
+     only the new suffix, which has been appended to it already.  See
+     btrace_stitch_pt.  */
+  bool resume = btinfo->pt_sync.resume;
+  btinfo->pt_sync.resume = false;
+  uint64_t sync_offset = btinfo->pt_sync.sync_offset;
+
+  const struct btrace_data_pt *source = btrace;
+  if (resume)
+    source = &btinfo->data.variant.pt;
+
+  /* Synchronization points can only be reused if their offsets are
+     relative to the accumulated raw trace.  */
+  bool track = (btinfo->data.format == BTRACE_FORMAT_PT
+		&& btinfo->data.variant.pt.size == source->size);
+  btinfo->pt_sync.valid = false;
+
   pt_config_init(&config);
-  config.begin = btrace->data;
-  config.end = btrace->data + btrace->size;
+  config.begin = source->data;
+  config.end = source->data + source->size;
 
   /* We treat an unknown vendor as 'no errata'.  */
   if (btrace->config.cpu.vendor != CV_UNKNOWN)
@@ -1488,7 +1531,8 @@ btrace_compute_ftrace_pt (struct thread_info *tp,
 	error (_("Failed to configure the Intel Processor Trace decoder: "
 		 "%s."), pt_errstr (pt_errcode (errcode)));
 
-      ftrace_add_pt (btinfo, decoder, &level, gaps);
+      ftrace_add_pt (btinfo, decoder, &level, gaps, sync_offset, resume,
+		     track);
     }
   catch (const gdb_exception &error)
     {
@@ -1781,6 +1825,82 @@ btrace_stitch_bts (struct btrace_data_bts *btrace, struct thread_info *tp)
   return 0;
 }
 
+/* Try to stitch new Intel PT trace in BTRACE onto the trace already
+   decoded for TP.  The aux buffer is circular, so until it wraps for
+   the first time the old raw trace is a prefix of the new one, and
+   only the suffix needs decoding: the decoded trace is rolled back to
+   the last synchronization point of the previous decode and BTRACE is
+   reduced to the bytes not covered by it.  Return 0 on success, -1 if
+   the decode has to start over.  */
+
+static int
+btrace_stitch_pt (struct btrace_data_pt *btrace, struct thread_info *tp)
+{
+  struct btrace_thread_info *btinfo = &tp->btrace;
+
+  if (!btinfo->pt_sync.valid || btinfo->data.format != BTRACE_FORMAT_PT)
+    return -1;
+
+  const struct btrace_data_pt &old = btinfo->data.variant.pt;
+
+  /* Once the buffer wrapped, the old trace is no longer a prefix of
+     the new one.  */
+  if (old.size == 0 || btrace->size < old.size
+      || btinfo->pt_sync.sync_offset >= old.size
+      || memcmp (old.data, btrace->data, old.size) != 0)
+    return -1;
+
+  /* No new trace; leave everything as it is.  */
+  if (btrace->size == old.size)
+    {
+      btrace->size = 0;
+      return 0;
+    }
+
+  DEBUG ("stitching %s new trace bytes at offset %s",
+	 pulongest (btrace->size - old.size), pulongest (old.size));
+
+  /* Make sure btrace frames that may hold a pointer into the decoded
+     trace are destroyed before we truncate it.  */
+  reinit_frame_cache ();
+
+  /* Roll the decoded trace back to the last synchronization point.
+     The decode regenerates it from there, over the extended
+     buffer.  */
+  gdb_assert (btinfo->pt_sync.nfunctions <= btinfo->functions.size ());
+
+  for (size_t i = btinfo->pt_sync.nfunctions;
+       i < btinfo->functions.size (); i++)
+    if (btinfo->functions[i].errcode != 0)
+      btinfo->ngaps--;
+
+  btinfo->functions.resize (btinfo->pt_sync.nfunctions);
+  if (!btinfo->functions.empty ())
+    btinfo->functions.back ().insn.resize (btinfo->pt_sync.ninsns);
+
+  /* Clear segment links that pointed into the removed tail.  */
+  const unsigned int flast = btinfo->functions.size ();
+  for (btrace_function &bfun : btinfo->functions)
+    {
+      if (bfun.next > flast)
+	bfun.next = 0;
+      if (bfun.prev > flast)
+	bfun.prev = 0;
+      if (bfun.up > flast)
+	bfun.up = 0;
+    }
+
+  /* Hand back only the bytes that are not decoded yet.  They are
+     appended to the stored raw trace before the decode.  */
+  size_t delta = btrace->size - old.size;
+  memmove (btrace->data, btrace->data + old.size, delta);
+  btrace->size = delta;
+
+  btinfo->pt_sync.resume = true;
+
+  return 0;
+}
+
 /* Adjust the block trace in order to stitch old and new trace together.
    BTRACE is the new delta trace between the last and the current stop.
    TP is the traced thread.
@@ -1948,8 +2068,11 @@ btrace_fetch (struct thread_info *tp, const struct btrace_cpu *cpu)
 	  /* We failed to read delta trace.  Let's try to read new trace.  */
 	  errcode = target_read_btrace (&btrace, tinfo, BTRACE_READ_NEW);
 
-	  /* If we got any new trace, discard what we have.  */
-	  if (errcode == 0 && !btrace.empty ())
+	  /* If we got any new trace, try to stitch it to what we have;
+	     otherwise, discard what we have.  */
+	  if (errcode == 0 && !btrace.empty ()
+	      && (btrace.format != BTRACE_FORMAT_PT
+		  || btrace_stitch_pt (&btrace.variant.pt, tp) != 0))
 	    btrace_clear (tp);
 	}
 
@@ -1998,6 +2121,8 @@ btrace_clear (struct thread_info *tp)
 
   btinfo->functions.clear ();
   btinfo->ngaps = 0;
+  btinfo->pt_sync.valid = false;
+  btinfo->pt_sync.resume = false;
 
   /* Must clear the maint data before - it depends on BTINFO->DATA.  */
   btrace_maint_clear (btinfo);
@@ -338,6 +338,33 @@ struct btrace_thread_info
   /* The number of gaps in the trace.  */
   unsigned int ngaps;
 
+  /* State for incremental Intel PT decode: the last synchronization
+     point of the previous decode of DATA.  When new trace arrives and
+     the old raw trace is still a prefix of it, the decoded trace is
+     rolled back to this point and the decode resumes here, instead of
+     decoding the entire buffer again.  See btrace_stitch_pt.  */
+  struct
+  {
+    /* The offset in bytes of the synchronization point into the raw
+       trace data.  */
+    uint64_t sync_offset = 0;
+
+    /* The number of entries in FUNCTIONS when the decoder
+       synchronized there.  */
+    size_t nfunctions = 0;
+
+    /* The size of the last function segment's instruction vector at
+       that point, or zero if NFUNCTIONS is zero.  */
+    size_t ninsns = 0;
+
+    /* True if the fields above match the current decoded trace.  */
+    bool valid = false;
+
+    /* True if the next decode should synchronize at SYNC_OFFSET
+       instead of decoding DATA from the beginning.  */
+    bool resume = false;
+  } pt_sync;
+
   /* A bit-vector of btrace_thread_flag.  */
   btrace_thread_flags flags;
 
@@ -383,7 +410,19 @@ extern void btrace_teardown (struct thread_info *);
 extern const char *btrace_decode_error (enum btrace_format format, int errcode);
 
 /* Fetch the branch trace for a single thread.  If CPU is not NULL, assume
-   CPU for trace decode.  */
+   CPU for trace decode.
+
+   The function-level trace is maintained incrementally where the
+   trace format allows it: for BTS via delta reads, for Intel PT by
+   stitching the new raw trace onto the old one, so the per-stop cost
+   is proportional to the new trace, and new function segments are
+   appended to FUNCTIONS with the existing ones left in place.  Aged
+   segments are never evicted from the head: segment numbers and
+   instruction offsets are baked into every segment, link and
+   iterator, so eviction would renumber the entire trace and cost what
+   it is meant to save.  If stitching is not possible (a wrapped PT
+   buffer, a failed delta read), the trace is discarded and decoded
+   from scratch.  */
 extern void btrace_fetch (struct thread_info *,
 			  const struct btrace_cpu *cpu);
 
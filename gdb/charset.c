@@ -466,20 +466,82 @@ host_letter_to_control_character (char c)
 
 /* Public character management functions.  */
 
+/* An open iconv descriptor kept for reuse, with the names it was
+   opened with.  */
+
+struct pooled_iconv_desc
+{
+  std::string to;
+  std::string from;
+  iconv_t desc;
+  bool in_use;
+};
+
+/* Pool of open iconv descriptors.  iconv_open can be more expensive
+   than the conversion itself -- it may search the file system for a
+   conversion module -- and converting each string printed opens and
+   closes a descriptor, so instead descriptors stay open for the rest
+   of the session and are handed out from here.  Only the handful of
+   (TO, FROM) pairs made from the host, target and wide charsets ever
+   occurs, so the pool stays small and a linear scan is fine.  */
+
+static std::vector<pooled_iconv_desc> iconv_desc_pool;
+
+/* Acquire a descriptor converting FROM to TO, reusing a pooled one
+   when possible.  Returns (iconv_t) -1 on failure, like
+   iconv_open.  */
+
+static iconv_t
+acquire_iconv_desc (const char *to, const char *from)
+{
+  for (pooled_iconv_desc &pooled : iconv_desc_pool)
+    if (!pooled.in_use && pooled.to == to && pooled.from == from)
+      {
+	pooled.in_use = true;
+#ifndef PHONY_ICONV
+	/* Drop any shift state left behind by the previous user.
+	   The phony iconv is stateless (and would crash on the null
+	   arguments).  */
+	iconv (pooled.desc, nullptr, nullptr, nullptr, nullptr);
+#endif
+	return pooled.desc;
+      }
+
+  iconv_t desc = iconv_open (to, from);
+  if (desc != (iconv_t) -1)
+    iconv_desc_pool.push_back ({to, from, desc, true});
+  return desc;
+}
+
+/* Return DESC, previously acquired with acquire_iconv_desc, to the
+   pool.  */
+
+static void
+release_iconv_desc (iconv_t desc)
+{
+  for (pooled_iconv_desc &pooled : iconv_desc_pool)
+    if (pooled.in_use && pooled.desc == desc)
+      {
+	pooled.in_use = false;
+	return;
+      }
+  gdb_assert_not_reached ("releasing an unpooled iconv descriptor");
+}
+
 class iconv_wrapper
 {
 public:
 
   iconv_wrapper (const char *to, const char *from)
   {
-    m_desc = iconv_open (to, from);
+    m_desc = acquire_iconv_desc (to, from);
     if (m_desc == (iconv_t) -1)
       perror_with_name (_("Converting character sets"));
   }
 
   ~iconv_wrapper ()
   {
-    iconv_close (m_desc);
+    release_iconv_desc (m_desc);
   }
 
   size_t convert (ICONV_CONST char **inp, size_t *inleft, char **outp,
@@ -593,7 +655,7 @@ wchar_iterator::wchar_iterator (const gdb_byte *input, size_t bytes,
   m_width (width),
   m_out (1)
 {
-  m_desc = iconv_open (INTERMEDIATE_ENCODING, charset);
+  m_desc = acquire_iconv_desc (INTERMEDIATE_ENCODING, charset);
   if (m_desc == (iconv_t) -1)
     perror_with_name (_("Converting character sets"));
 }
@@ -601,7 +663,7 @@ wchar_iterator::wchar_iterator (const gdb_byte *input, size_t bytes,
 wchar_iterator::~wchar_iterator ()
 {
   if (m_desc != (iconv_t) -1)
-    iconv_close (m_desc);
+    release_iconv_desc (m_desc);
 }
 
 int
@@ -195,7 +195,7 @@ cli_ui_out::do_field_fmt (int fldno, int width, ui_align align,
   if (m_suppress_output)
     return;
 
-  std::string str = string_vprintf (format, args);
+  format_buffer str (format, args);
 
   do_field_string (fldno, width, align, fldname, str.c_str (), style);
 }
@@ -225,7 +225,10 @@ cli_ui_out::do_message (const ui_file_style &style,
   if (m_suppress_output)
     return;
 
-  std::string str = string_vprintf (format, args);
+  /* vmessage splits every format string into pieces, so this runs
+     once per piece of every formatted print; formatting into the
+     internal buffer avoids a string allocation per piece.  */
+  format_buffer str (format, args);
   if (!str.empty ())
     {
       ui_file *stream = m_streams.back ();
@@ -45,6 +45,7 @@
 #include "interps.h"
 
 #include "top.h"
+#include "maint.h"
 #include "ui.h"
 #include "cli/cli-decode.h"
 #include "cli/cli-script.h"
@@ -772,6 +773,11 @@ source_script_with_search (const char *file, int from_tty, int search_path)
       tilde_expanded_file = gdb_tilde_expand (file);
       file_to_open = tilde_expanded_file.c_str ();
     }
+  /* While GDB is starting up, attribute the time spent sourcing the
+     script to it in the table shown by "maint time startup".  This
+     records nothing once startup is complete.  */
+  scoped_startup_timer timer ("script", file);
+
   source_script_from_stream (opened->stream.get (), file, file_to_open);
 }
 
@@ -25,6 +25,8 @@
 #include "cli/cli-decode.h"
 #include "cli/cli-style.h"
 #include "gdbsupport/gdb_optional.h"
+#include <algorithm>
+#include <unordered_map>
 
 /* Prototypes for local functions.  */
 
@@ -54,6 +56,28 @@ static int lookup_cmd_composition_1 (const char *text,
 				     struct cmd_list_element **cmd,
 				     struct cmd_list_element *cur_list);
 
+/* A cache of flat, sorted views of the command lists, keyed by the
+   head element of each list.  find_cmd uses these to binary search
+   for a command name instead of walking the list with a strncmp per
+   element, which adds up once user-defined commands and aliases push
+   a list into the thousands of entries.  Any mutation of any command
+   list discards the whole cache; lists barely change after startup,
+   so rebuilding a view on the next lookup is cheap.  */
+
+static std::unordered_map<const cmd_list_element *,
+			  std::vector<cmd_list_element *>> cmd_list_views;
+
+/* Discard all cached command list views.  Called whenever a command
+   is added to or deleted from any list, both because the cached view
+   is stale and because the list's head element -- our map key -- may
+   have changed.  */
+
+static void
+invalidate_cmd_list_views ()
+{
+  cmd_list_views.clear ();
+}
+
 /* Look up a command whose 'subcommands' field is SUBCOMMANDS.  Return the
    command if found, otherwise return NULL.  */
 
@@ -184,6 +208,8 @@ do_add_cmd (const char *name, enum command_class theclass,
   struct cmd_list_element *c = new struct cmd_list_element (name, theclass,
 							    doc);
 
+  invalidate_cmd_list_views ();
+
   /* Turn each alias of the old command into an alias of the new
      command.  */
   c->aliases = delete_cmd (name, list, &c->hook_pre, &c->hookee_pre,
@@ -1439,6 +1465,8 @@ delete_cmd (const char *name, struct cmd_list_element **list,
   *posthookee = NULL;
   previous_chain_ptr = list;
 
+  invalidate_cmd_list_views ();
+
   for (iter = *previous_chain_ptr; iter; iter = *previous_chain_ptr)
     {
       if (strcmp (iter->name, name) == 0)
@@ -2086,22 +2114,41 @@ static struct cmd_list_element *
 find_cmd (const char *command, int len, struct cmd_list_element *clist,
 	  int ignore_help_classes, int *nfound)
 {
-  struct cmd_list_element *found, *c;
-
-  found = NULL;
   *nfound = 0;
-  for (c = clist; c; c = c->next)
-    if (!strncmp (command, c->name, len)
-	&& (!ignore_help_classes || !c->is_command_class_help ()))
-      {
-	found = c;
-	(*nfound)++;
-	if (c->name[len] == '\0')
-	  {
-	    *nfound = 1;
-	    break;
-	  }
-      }
+  if (clist == nullptr)
+    return nullptr;
+
+  std::vector<cmd_list_element *> &view = cmd_list_views[clist];
+  if (view.empty ())
+    for (cmd_list_element *c = clist; c != nullptr; c = c->next)
+      view.push_back (c);
+
+  /* do_add_cmd keeps each list sorted by name, so every element whose
+     name has COMMAND as a prefix occupies a contiguous range that
+     binary search can locate without scanning the rest of the list.
+     An exact match, if present, sorts first within that range.  */
+  auto first = std::lower_bound (view.begin (), view.end (), command,
+				 [len] (const cmd_list_element *c,
+					const char *cmd)
+				 { return strncmp (c->name, cmd, len) < 0; });
+
+  cmd_list_element *found = nullptr;
+  for (auto iter = first;
+       iter != view.end () && strncmp (command, (*iter)->name, len) == 0;
+       ++iter)
+    {
+      cmd_list_element *c = *iter;
+
+      if (ignore_help_classes && c->is_command_class_help ())
+	continue;
+      found = c;
+      (*nfound)++;
+      if (c->name[len] == '\0')
+	{
+	  *nfound = 1;
+	  break;
+	}
+    }
   return found;
 }
 
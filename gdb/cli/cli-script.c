@@ -57,6 +57,9 @@ static void do_document_command (const char *comname, int from_tty,
 
 static const char *read_next_line (std::string &buffer);
 
+static const char *insert_cmd_args_cached (struct command_line *cmd,
+					   std::string *storage);
+
 /* Level of control structure when reading.  */
 static int control_level;
 
@@ -91,6 +94,10 @@ public:
      found in LINE.  */
   std::string insert_args (const char *line) const;
 
+  /* As above, but substitute into the pre-compiled form PIECES of a
+     line instead of re-scanning the line's text.  */
+  std::string insert_args (const std::vector<command_arg_piece> &pieces) const;
+
 private:
   /* Disable copy/assignment.  (Since the elements of A point inside
      COMMAND, copying would need to reconstruct the A vector in the
@@ -525,8 +532,9 @@ execute_control_command_1 (struct command_line *cmd, int from_tty)
     case simple_control:
       {
 	/* A simple command, execute it and return.  */
-	std::string new_line = insert_user_defined_cmd_args (cmd->line);
-	execute_command (new_line.c_str (), from_tty);
+	std::string storage;
+	const char *new_line = insert_cmd_args_cached (cmd, &storage);
+	execute_command (new_line, from_tty);
 	ret = cmd->control_type;
 	break;
       }
@@ -552,8 +560,9 @@ execute_control_command_1 (struct command_line *cmd, int from_tty)
 	print_command_trace ("while %s", cmd->line);
 
 	/* Parse the loop control expression for the while statement.  */
-	std::string new_line = insert_user_defined_cmd_args (cmd->line);
-	expression_up expr = parse_expression (new_line.c_str ());
+	std::string storage;
+	const char *new_line = insert_cmd_args_cached (cmd, &storage);
+	expression_up expr = parse_expression (new_line);
 
 	ret = simple_control;
 	loop = 1;
@@ -614,8 +623,9 @@ execute_control_command_1 (struct command_line *cmd, int from_tty)
 	print_command_trace ("if %s", cmd->line);
 
 	/* Parse the conditional for the if statement.  */
-	std::string new_line = insert_user_defined_cmd_args (cmd->line);
-	expression_up expr = parse_expression (new_line.c_str ());
+	std::string storage;
+	const char *new_line = insert_cmd_args_cached (cmd, &storage);
+	expression_up expr = parse_expression (new_line);
 
 	current = NULL;
 	ret = simple_control;
@@ -655,8 +665,9 @@ execute_control_command_1 (struct command_line *cmd, int from_tty)
       {
 	/* Breakpoint commands list, record the commands in the
 	   breakpoint's command list and return.  */
-	std::string new_line = insert_user_defined_cmd_args (cmd->line);
-	ret = commands_from_control_command (new_line.c_str (), cmd);
+	std::string storage;
+	const char *new_line = insert_cmd_args_cached (cmd, &storage);
+	ret = commands_from_control_command (new_line, cmd);
 	break;
       }
 
@@ -889,6 +900,108 @@ user_args::insert_args (const char *line) const
   return new_line;
 }
 
+/* Compile LINE into PIECES, splitting it at each $argc/$argN
+   reference.  This performs, once, exactly the scanning that
+   insert_args (const char *) performs on every call; the result
+   depends only on LINE, never on the actual arguments, so it can
+   safely be cached on the command_line and reused.  */
+
+static void
+compile_arg_pieces (const char *line, std::vector<command_arg_piece> *pieces)
+{
+  const char *p;
+
+  while ((p = locate_arg (line)))
+    {
+      command_arg_piece piece;
+      piece.text.assign (line, p - line);
+
+      if (p[4] == 'c')
+	{
+	  piece.arg = command_arg_piece::ARG_COUNT;
+	  line = p + 5;
+	}
+      else
+	{
+	  char *tmp;
+	  unsigned long i;
+
+	  errno = 0;
+	  i = strtoul (p + 4, &tmp, 10);
+	  if ((i == 0 && tmp == p + 4) || errno != 0)
+	    /* Not a usable argument number; drop the "$arg" text just
+	       as insert_args (const char *) does and keep scanning
+	       after it.  */
+	    line = p + 4;
+	  else
+	    {
+	      piece.arg = (long) i;
+	      line = tmp;
+	    }
+	}
+
+      pieces->push_back (std::move (piece));
+    }
+
+  /* The literal tail of the line.  */
+  command_arg_piece tail;
+  tail.text = line;
+  pieces->push_back (std::move (tail));
+}
+
+/* See declaration above.  */
+
+std::string
+user_args::insert_args (const std::vector<command_arg_piece> &pieces) const
+{
+  std::string new_line;
+
+  for (const command_arg_piece &piece : pieces)
+    {
+      new_line += piece.text;
+
+      if (piece.arg == command_arg_piece::ARG_COUNT)
+	new_line += std::to_string (m_args.size ());
+      else if (piece.arg >= 0)
+	{
+	  if ((unsigned long) piece.arg >= m_args.size ())
+	    error (_("Missing argument %ld in user function."), piece.arg);
+	  new_line.append (m_args[piece.arg].data (),
+			   m_args[piece.arg].length ());
+	}
+    }
+
+  return new_line;
+}
+
+/* Expand CMD->line as insert_user_defined_cmd_args does, but cache
+   the compiled substitution template on CMD so that repeated
+   executions -- breakpoint command lists, hooks -- skip re-scanning
+   the line.  Returns CMD->line itself when no substitution applies,
+   avoiding a copy; otherwise STORAGE holds the expanded text and the
+   returned pointer refers to it.  */
+
+static const char *
+insert_cmd_args_cached (struct command_line *cmd, std::string *storage)
+{
+  /* If we are not in a user-defined command, treat $argc, $arg0, et
+     cetera as normal convenience variables.  */
+  if (user_args_stack.empty ())
+    return cmd->line;
+
+  if (cmd->compiled_args.empty ())
+    compile_arg_pieces (cmd->line, &cmd->compiled_args);
+
+  /* A line without any $argc/$argN references needs no expansion at
+     all; the compiled form is then just the literal tail.  */
+  if (cmd->compiled_args.size () == 1)
+    return cmd->line;
+
+  const std::unique_ptr<user_args> &args = user_args_stack.back ();
+  *storage = args->insert_args (cmd->compiled_args);
+  return storage->c_str ();
+}
+
 
 /* Read next line from stdin.  Passed to read_command_line_1 and
    recurse_read_control_structure whenever we need to read commands
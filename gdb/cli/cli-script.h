@@ -69,6 +69,24 @@ typedef std::shared_ptr<command_line> counted_command_line;
 /* A unique_ptr specialization for command_line.  */
 typedef std::unique_ptr<command_line, command_lines_deleter> command_line_up;
 
+/* * One piece of the compiled form of a command line's $argc/$argN
+   references: the literal TEXT, followed by the substitution slot
+   ARG.  */
+
+struct command_arg_piece
+{
+  /* Values of ARG that do not name a $argN index.  */
+  enum { ARG_NONE = -1, ARG_COUNT = -2 };
+
+  /* Literal text preceding the substitution.  */
+  std::string text;
+
+  /* The substitution following TEXT: a 0-based $argN index, ARG_COUNT
+     for $argc, or ARG_NONE for no substitution (used by the final
+     piece).  */
+  long arg = ARG_NONE;
+};
+
 /* * Structure for saved commands lines (for breakpoints, defined
    commands, etc).  */
 
@@ -102,6 +120,14 @@ struct command_line
   counted_command_line body_list_0;
   counted_command_line body_list_1;
 
+  /* * Compiled form of LINE's $argc/$argN references, computed the
+     first time this line is executed inside a user-defined command
+     and reused on later executions, so that breakpoint command lists
+     and hooks that run many times do not re-scan the line each time.
+     Empty until computed; a line containing no references compiles to
+     a single ARG_NONE piece.  */
+  std::vector<command_arg_piece> compiled_args;
+
 private:
 
   friend void free_command_lines (struct command_line **);
@@ -30,6 +30,18 @@
 #include "cli/cli-setshow.h"
 #include "cli/cli-utils.h"
 
+/* Incremented every time a "set" command changes a parameter.  */
+
+static unsigned int setshow_generation = 1;
+
+/* See cli/cli-setshow.h.  */
+
+unsigned int
+get_setshow_generation ()
+{
+  return setshow_generation;
+}
+
 /* Return true if the change of command parameter should be notified.  */
 
 static bool
@@ -448,6 +460,9 @@ do_set_command (const char *arg, int from_tty, struct cmd_list_element *c)
       error (_("gdb internal error: bad var_type in do_setshow_command"));
     }
 
+  if (option_changed)
+    ++setshow_generation;
+
   c->func (NULL, from_tty, c);
 
   if (notify_command_param_changed_p (option_changed, c))
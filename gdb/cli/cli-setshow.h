@@ -52,6 +52,12 @@ const char *parse_cli_var_enum (const char **args,
 
 extern void do_set_command (const char *arg, int from_tty,
 			    struct cmd_list_element *c);
+
+/* Return a counter that is incremented every time a "set" command
+   changes a parameter.  Caches of rendered output can compare it
+   against the value recorded at rendering time to tell whether a
+   setting feeding the rendering may have changed since.  */
+extern unsigned int get_setshow_generation ();
 extern void do_show_command (const char *arg, int from_tty,
 			     struct cmd_list_element *c);
 
@@ -34,6 +34,7 @@
 #include "symfile.h"
 #include "objfiles.h"
 #include "gdbsupport/common-utils.h"
+#include "gdbsupport/parallel-for.h"
 #include "coff/internal.h"
 
 #include <ctype.h>
@@ -65,6 +66,23 @@ struct read_pe_section_data
 #define PE_SECTION_INDEX_BSS      2
 #define PE_SECTION_TABLE_SIZE     3
 #define PE_SECTION_INDEX_INVALID -1
+
+/* One export table entry as classified by the parallel scan in
+   read_pe_exported_syms.  SECTIX is an index into the section data
+   table, or one of the markers below.  */
+
+struct parsed_pe_export
+{
+  unsigned long name_rva;	/* RVA of the export's name, or 0.  */
+  unsigned long ordinal;	/* Export ordinal.  */
+  unsigned long func_rva;	/* RVA of the exported function.  */
+  int sectix;			/* Section, or a marker below.  */
+};
+
+/* SECTIX markers: the export forwards to another DLL; the export's
+   RVA falls in no known section.  */
+#define PE_EXPORT_FORWARDED -1
+#define PE_EXPORT_NOT_FOUND -2
 
 /* Get the index of the named section in our own array, which contains
    text, data and bss in that order.  Return PE_SECTION_INDEX_INVALID
@@ -531,30 +549,59 @@ read_pe_exported_syms (minimal_symbol_reader &reader,
 			      " base=%ld\n"), dll_name, nexp, ordbase);
   nbforward = 0;
   nbnormal = 0;
-  /* Iterate through the list of symbols.  */
+
+  /* Classify the export entries on the thread pool.  The workers only
+     read the immutable export data and section table, so this is
+     safe; for the big symbol-less system DLLs this scan is the bulk
+     of the work.  Recording the minimal symbols -- and resolving
+     forwarders, which looks up symbols of other objfiles -- happens
+     serially below, in table order, as before.  */
+  std::vector<parsed_pe_export> parsed (nexp);
+  gdb::parallel_for_each
+    (1024, parsed.data (), parsed.data () + nexp,
+     [&] (parsed_pe_export *start, parsed_pe_export *end)
+     {
+       for (parsed_pe_export *it = start; it < end; ++it)
+	 {
+	   unsigned long idx = it - parsed.data ();
+
+	   /* Pointer to the names vector.  */
+	   it->name_rva = pe_as32 (erva + name_rvas + idx * 4);
+	   /* Retrieve ordinal value.  */
+	   it->ordinal = pe_as16 (erva + ordinals + idx * 2);
+	   /* Pointer to the function address vector.  This is relative
+	      to the ordinal value.  */
+	   it->func_rva = pe_as32 (erva + exp_funcbase + it->ordinal * 4);
+
+	   /* An RVA inside the export section denotes a forwarder;
+	      otherwise find the symbol's section in our own array.  */
+	   if (it->func_rva >= export_rva
+	       && it->func_rva < export_rva + export_size)
+	     it->sectix = PE_EXPORT_FORWARDED;
+	   else
+	     {
+	       it->sectix = PE_EXPORT_NOT_FOUND;
+	       for (int sectix = 0; sectix < otherix; ++sectix)
+		 if (it->func_rva >= section_data[sectix].rva_start
+		     && it->func_rva < section_data[sectix].rva_end)
+		   {
+		     it->sectix = sectix;
+		     break;
+		   }
+	     }
+	 }
+     });
+
+  /* Record the classified entries.  */
   for (i = 0; i < nexp; i++)
     {
-      /* Pointer to the names vector.  */
-      unsigned long name_rva = pe_as32 (erva + name_rvas + i * 4);
-      /* Retrieve ordinal value.  */
-
-      unsigned long ordinal = pe_as16 (erva + ordinals + i * 2);
-
-
-      /* Pointer to the function address vector.  */
-      /* This is relative to ordinal value. */
-      unsigned long func_rva = pe_as32 (erva + exp_funcbase +
-					ordinal * 4);
-
-      /* Find this symbol's section in our own array.  */
-      int sectix = 0;
-      int section_found = 0;
+      const parsed_pe_export &exp = parsed[i];
 
       /* First handle forward cases.  */
-      if (func_rva >= export_rva && func_rva < export_rva + export_size)
+      if (exp.sectix == PE_EXPORT_FORWARDED)
 	{
-	  const char *forward_name = (const char *) (erva + func_rva);
-	  const char *funcname = (const char *) (erva + name_rva);
+	  const char *forward_name = (const char *) (erva + exp.func_rva);
+	  const char *funcname = (const char *) (erva + exp.name_rva);
 	  const char *forward_dll_name = forward_name;
 	  const char *forward_func_name = forward_name;
 	  const char *sep = strrchr (forward_name, '.');
@@ -569,41 +616,29 @@ read_pe_exported_syms (minimal_symbol_reader &reader,
 	      forward_func_name = sep + 1;
 	    }
 	  if (add_pe_forwarded_sym (reader, funcname, forward_dll_name,
-				    forward_func_name, ordinal,
+				    forward_func_name, exp.ordinal,
 				    dll_name, objfile) != 0)
 	    ++nbforward;
-	  continue;
 	}
-
-      for (sectix = 0; sectix < otherix; ++sectix)
+      else if (exp.sectix >= 0)
 	{
-	  if ((func_rva >= section_data[sectix].rva_start)
-	      && (func_rva < section_data[sectix].rva_end))
-	    {
-	      const char *sym_name = (const char *) (erva + name_rva);
+	  const char *sym_name = (const char *) (erva + exp.name_rva);
 
-	      section_found = 1;
-	      add_pe_exported_sym (reader, sym_name, func_rva, ordinal,
-				   &section_data[sectix], dll_name, objfile);
-	      ++nbnormal;
-	      break;
-	    }
+	  add_pe_exported_sym (reader, sym_name, exp.func_rva, exp.ordinal,
+			       &section_data[exp.sectix], dll_name, objfile);
+	  ++nbnormal;
 	}
-      if (!section_found)
+      else if (exp.name_rva == 0)
 	{
-	  const char *funcname = (const char *) (erva + name_rva);
-
-	  if (name_rva == 0)
-	    {
-	      add_pe_exported_sym (reader, NULL, func_rva, ordinal,
-				   &section_data[0], dll_name, objfile);
-	      ++nbnormal;
-	    }
-	  else if (debug_coff_pe_read)
-	    gdb_printf (gdb_stdlog, _("Export name \"%s\" ord. %lu,"
-				      " RVA 0x%lx in dll \"%s\" not handled\n"),
-			funcname, ordinal, func_rva, dll_name);
+	  add_pe_exported_sym (reader, NULL, exp.func_rva, exp.ordinal,
+			       &section_data[0], dll_name, objfile);
+	  ++nbnormal;
 	}
+      else if (debug_coff_pe_read)
+	gdb_printf (gdb_stdlog, _("Export name \"%s\" ord. %lu,"
+				  " RVA 0x%lx in dll \"%s\" not handled\n"),
+		    (const char *) (erva + exp.name_rva), exp.ordinal,
+		    exp.func_rva, dll_name);
     }
 
   if (debug_coff_pe_read)
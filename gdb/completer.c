@@ -1595,6 +1595,16 @@ completion_tracker::add_completions (completion_list &&list)
 
 /* See completer.h.  */
 
+bool
+completion_tracker::full () const
+{
+  if (max_completions < 0)
+    return false;
+  return htab_elements (m_entries_hash.get ()) >= (size_t) max_completions;
+}
+
+/* See completer.h.  */
+
 void
 completion_tracker::remove_completion (const char *name)
 {
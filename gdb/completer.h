@@ -348,6 +348,12 @@ public:
      if NAME is not already in the completion list.  */
   void remove_completion (const char *name);
 
+  /* Return true if the maximum number of completions has already
+     been collected.  Completers iterating over many candidates can
+     use this to stop scanning early, rather than relying on the
+     error thrown by add_completion.  */
+  bool full () const;
+
   /* Set the quote char to be appended after a unique completion is
      added to the input line.  Set to '\0' to clear.  See
      m_quote_char's description.  */
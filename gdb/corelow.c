@@ -49,6 +49,7 @@
 #include "gdbsupport/scoped_fd.h"
 #include "gdbsupport/x86-xstate.h"
 #include "debuginfod-support.h"
+#include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
 #include "gdbcmd.h"
@@ -155,9 +156,21 @@ private: /* per-core data */
      still be useful.  */
   std::vector<mem_range> m_core_unavailable_mappings;
 
+  /* The sections of M_CORE_SECTION_TABLE that have contents, sorted
+     by address for binary-search lookup in xfer_partial.  Large core
+     files can have tens of thousands of load sections, making the
+     generic linear section walk the dominant cost of every memory
+     read.  Left empty if the sections overlap, in which case the
+     linear walk is used instead.  */
+  std::vector<const target_section *> m_core_section_index;
+
   /* Build m_core_file_mappings.  Called from the constructor.  */
   void build_file_mappings ();
 
+  /* Build m_core_section_index.  Called from the constructor, after
+     m_core_section_table is in its final location.  */
+  void build_core_section_index ();
+
   /* Helper method for xfer_partial.  */
   enum target_xfer_status xfer_memory_via_mappings (gdb_byte *readbuf,
 						    const gdb_byte *writebuf,
@@ -196,9 +209,35 @@ core_target::core_target ()
   /* Find the data section */
   m_core_section_table = build_section_table (core_bfd);
 
+  build_core_section_index ();
+
   build_file_mappings ();
 }
 
+/* See description in class.  */
+
+void
+core_target::build_core_section_index ()
+{
+  for (const target_section &ts : m_core_section_table)
+    if ((ts.the_bfd_section->flags & SEC_HAS_CONTENTS) != 0)
+      m_core_section_index.push_back (&ts);
+
+  std::sort (m_core_section_index.begin (), m_core_section_index.end (),
+	     [] (const target_section *lhs, const target_section *rhs)
+	     { return lhs->addr < rhs->addr; });
+
+  /* The binary search assumes the sections don't overlap.  If they
+     do, discard the index; xfer_partial then keeps the linear walk,
+     which preserves the first-in-table-order match.  */
+  for (size_t i = 1; i < m_core_section_index.size (); i++)
+    if (m_core_section_index[i]->addr < m_core_section_index[i - 1]->endaddr)
+      {
+	m_core_section_index.clear ();
+	break;
+      }
+}
+
 /* Construct the target_section_table for file-backed mappings if
    they exist.
 
@@ -1043,11 +1082,83 @@ core_target::xfer_partial (enum target_object object, const char *annex,
 	  {
 	    return ((s->the_bfd_section->flags & SEC_HAS_CONTENTS) != 0);
 	  };
-	xfer_status = section_table_xfer_memory_partial
-			(readbuf, writebuf,
-			 offset, len, xfered_len,
-			 m_core_section_table,
-			 has_contents_cb);
+	if (!m_core_section_index.empty ())
+	  {
+	    /* Binary-search the sorted index for the section
+	       containing OFFSET, instead of walking the whole
+	       section table.  Find the first section starting above
+	       OFFSET; the candidate is the one before it.  */
+	    auto it = std::upper_bound (m_core_section_index.begin (),
+					m_core_section_index.end (), offset,
+					[] (ULONGEST addr,
+					    const target_section *sect)
+					{ return addr < sect->addr; });
+
+	    xfer_status = TARGET_XFER_EOF;
+	    if (it != m_core_section_index.begin ())
+	      {
+		const target_section *p = *(it - 1);
+
+		if (offset < p->endaddr)
+		  {
+		    ULONGEST xfer_len = len;
+
+		    /* Only do up to the end of this section.  */
+		    if (offset + len > p->endaddr)
+		      xfer_len = p->endaddr - offset;
+
+		    struct bfd_section *asect = p->the_bfd_section;
+		    int res;
+
+		    if (writebuf != nullptr)
+		      res = bfd_set_section_contents (asect->owner, asect,
+						      writebuf,
+						      offset - p->addr,
+						      xfer_len);
+#ifdef HAVE_MMAP
+		    else
+		      {
+			/* Serve reads from the mapped core file
+			   contents.  Backtracing every thread of a
+			   big dump issues a flood of small reads;
+			   each then costs a memcpy instead of a file
+			   system round trip.  */
+			bfd_size_type map_size;
+			const gdb_byte *map
+			  = gdb_bfd_map_section (asect, &map_size);
+
+			if (map != nullptr
+			    && offset - p->addr + xfer_len <= map_size)
+			  {
+			    memcpy (readbuf, map + (offset - p->addr),
+				    xfer_len);
+			    res = 1;
+			  }
+			else
+			  res = 0;
+		      }
+#else
+		    else
+		      res = bfd_get_section_contents (asect->owner, asect,
+						      readbuf,
+						      offset - p->addr,
+						      xfer_len);
+#endif
+
+		    if (res != 0)
+		      {
+			*xfered_len = xfer_len;
+			return TARGET_XFER_OK;
+		      }
+		  }
+	      }
+	  }
+	else
+	  xfer_status = section_table_xfer_memory_partial
+			  (readbuf, writebuf,
+			   offset, len, xfered_len,
+			   m_core_section_table,
+			   has_contents_cb);
 	if (xfer_status == TARGET_XFER_OK)
 	  return TARGET_XFER_OK;
 
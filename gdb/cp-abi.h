@@ -138,6 +138,12 @@ extern struct type *value_rtti_type (struct value *value,
 				     int *full, LONGEST *top,
 				     int *using_enc);
 
+/* Discard PSPACE's cache of vtable-address-to-run-time-type lookups.
+   Called whenever the addresses or types it holds may have become
+   stale, for instance when an objfile is relocated.  */
+
+extern void invalidate_rtti_cache (struct program_space *pspace);
+
 /* Compute the offset of the baseclass which is the INDEXth baseclass
    of class TYPE, for value at VALADDR (in host) at ADDRESS (in
    target), offset by EMBEDDED_OFFSET.  VALADDR points to the raw
@@ -99,31 +99,45 @@ copy_string_to_obstack (struct obstack *obstack, const char *string,
    function is conservative; things which it does not recognize are
    assumed to be non-canonical, and the parser will sort them out
    afterwards.  This speeds up the critical path for alphanumeric
-   identifiers.  */
+   identifiers and "::"-qualified sequences of them -- the vast
+   majority of the names seen while reading symbols.  Anything
+   containing template arguments, operators, anonymous namespaces or
+   whitespace still goes through the parser.  */
 
 static int
 cp_already_canonical (const char *string)
 {
-  /* Identifier start character [a-zA-Z_].  */
-  if (!ISIDST (string[0]))
-    return 0;
-
-  /* These are the only two identifiers which canonicalize to other
-     than themselves or an error: unsigned -> unsigned int and
-     signed -> int.  */
-  if (string[0] == 'u' && strcmp (&string[1], "nsigned") == 0)
-    return 0;
-  else if (string[0] == 's' && strcmp (&string[1], "igned") == 0)
-    return 0;
-
-  /* Identifier character [a-zA-Z0-9_].  */
-  while (ISIDNUM (string[1]))
-    string++;
-
-  if (string[1] == '\0')
-    return 1;
-  else
-    return 0;
+  for (;;)
+    {
+      /* Identifier start character [a-zA-Z_].  */
+      if (!ISIDST (string[0]))
+	return 0;
+
+      /* Identifier character [a-zA-Z0-9_].  */
+      const char *start = string;
+      while (ISIDNUM (string[1]))
+	string++;
+      string++;
+
+      /* These are the only two identifiers which canonicalize to
+	 other than themselves or an error: unsigned -> unsigned int
+	 and signed -> int.  Any other keyword appearing as a
+	 component makes the parser fail, which leaves the name
+	 unchanged just as accepting it here would.  */
+      size_t len = string - start;
+      if ((len == 8 && strncmp (start, "unsigned", len) == 0)
+	  || (len == 6 && strncmp (start, "signed", len) == 0))
+	return 0;
+
+      if (string[0] == '\0')
+	return 1;
+
+      /* A "::" and a further component may follow; the parser prints
+	 such a name back with no spaces around the "::".  */
+      if (string[0] != ':' || string[1] != ':')
+	return 0;
+      string += 2;
+    }
 }
 
 /* Inspect the given RET_COMP for its type.  If it is a typedef,
@@ -189,8 +189,6 @@ cp_print_value_fields (struct value *val, struct ui_file *stream,
       vptr_fieldno = get_vptr_fieldno (type, &vptr_basetype);
       for (i = n_baseclasses; i < len; i++)
 	{
-	  const gdb_byte *valaddr = val->contents_for_printing ().data ();
-
 	  /* If requested, skip printing of static fields.  */
 	  if (!options->static_field_print
 	      && type->field (i).is_static ())
@@ -293,6 +291,12 @@ cp_print_value_fields (struct value *val, struct ui_file *stream,
 		{
 		  opts->deref_ref = false;
 
+		  /* Only fetch the contents once a field actually
+		     needs them; with "print -lazy" the other fields
+		     are fetched individually.  */
+		  const gdb_byte *valaddr
+		    = val->contents_for_printing ().data ();
+
 		  v = value_field_bitfield (type, i, valaddr,
 					    val->embedded_offset (), val);
 
@@ -331,6 +335,8 @@ cp_print_value_fields (struct value *val, struct ui_file *stream,
 
 		  if (valprint_check_validity (stream, i_type, i_offset, val))
 		    {
+		      const gdb_byte *valaddr
+			= val->contents_for_printing ().data ();
 		      CORE_ADDR addr;
 
 		      i_offset += val->embedded_offset ();
@@ -25,6 +25,7 @@
 #include "inferior.h"
 #include "splay-tree.h"
 #include "gdbarch.h"
+#include "gdbsupport/byte-vector.h"
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -83,6 +84,14 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* Number of sequential line misses after which the cache starts
+   issuing speculative read-ahead, and the maximum number of lines
+   fetched ahead in one target read.  Walking a structure laid out
+   contiguously in memory then costs one round trip per read-ahead
+   window instead of one per line.  */
+#define DCACHE_PREFETCH_THRESHOLD 2
+#define DCACHE_MAX_PREFETCH 8
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -120,6 +129,18 @@ struct dcache_struct
   /* The process target of last inferior to use the cache or
      nullptr.  */
   process_stratum_target *proc_target;
+
+  /* Read-ahead state: the line address the next miss lands on if the
+     access pattern is sequential, and the length of the current
+     sequential miss run.  */
+  CORE_ADDR next_expected_line;
+  unsigned int seq_run;
+
+  /* Per-session statistics, not reset when the cache contents are
+     invalidated.  */
+  ULONGEST hit_count;
+  ULONGEST miss_count;
+  ULONGEST prefetch_count;
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
@@ -254,6 +275,8 @@ dcache_invalidate (DCACHE *dcache)
   dcache->size = 0;
   dcache->ptid = null_ptid;
   dcache->proc_target = nullptr;
+  dcache->next_expected_line = 0;
+  dcache->seq_run = 0;
 
   if (dcache->line_size != dcache_line_size)
     {
@@ -321,6 +344,11 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
 
   while (len > 0)
     {
+      /* A line split across many memory regions takes one target read
+	 per region; allow the user to bail out with ^C between
+	 them.  */
+      QUIT;
+
       /* Don't overrun if this block is right at the end of the region.  */
       region = lookup_mem_region (memaddr);
       if (region->hi == 0 || memaddr + len < region->hi)
@@ -391,8 +419,64 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
   return db;
 }
 
+/* Speculatively read up to DCACHE_MAX_PREFETCH lines starting at
+   line address ADDR in a single target read, and enter them into the
+   cache.  Stops early at the first line already present, at a memory
+   region boundary, and at regions that must not be read.  Failures
+   are ignored; the lines will simply be read on demand as before.  */
+
+static void
+dcache_prefetch (DCACHE *dcache, CORE_ADDR addr)
+{
+  struct mem_region *region = lookup_mem_region (addr);
+  int nlines = 0;
+
+  /* Don't speculate into regions we wouldn't read for a demand
+     fetch.  */
+  if (region->attrib.mode == MEM_WO || region->attrib.mode == MEM_NONE)
+    return;
+
+  while (nlines < DCACHE_MAX_PREFETCH)
+    {
+      CORE_ADDR line = addr + (CORE_ADDR) nlines * dcache->line_size;
+
+      /* Don't cross into a different memory region.  */
+      if (region->hi != 0 && line + dcache->line_size > region->hi)
+	break;
+
+      /* Overlapping an already cached line means further accesses
+	 are likely hits anyway.  */
+      if (splay_tree_lookup (dcache->tree, (splay_tree_key) line) != NULL)
+	break;
+
+      nlines++;
+    }
+
+  if (nlines == 0)
+    return;
+
+  gdb::byte_vector data ((size_t) nlines * dcache->line_size);
+  if (target_read_raw_memory (addr, data.data (), data.size ()) != 0)
+    return;
+
+  for (int i = 0; i < nlines; i++)
+    {
+      struct dcache_block *db
+	= dcache_alloc (dcache, addr + (CORE_ADDR) i * dcache->line_size);
+
+      memcpy (db->data, data.data () + (size_t) i * dcache->line_size,
+	      dcache->line_size);
+    }
+
+  dcache->prefetch_count += nlines;
+
+  /* A miss right behind the read-ahead window continues the
+     sequential run.  */
+  dcache->next_expected_line = addr + (CORE_ADDR) nlines * dcache->line_size;
+}
+
 /* Using the data cache DCACHE, store in *PTR the contents of the byte at
-   address ADDR in the remote machine.  
+   address ADDR in the remote machine.
 
    Returns 1 for success, 0 for error.  */
 
@@ -403,12 +487,34 @@ dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
 
   if (!db)
     {
+      CORE_ADDR line = MASK (dcache, addr);
+
+      dcache->miss_count++;
+
+      /* Detect runs of sequential line misses.  */
+      if (line == dcache->next_expected_line)
+	dcache->seq_run++;
+      else
+	dcache->seq_run = 0;
+      dcache->next_expected_line = line + dcache->line_size;
+
       db = dcache_alloc (dcache, addr);
 
       if (!dcache_read_line (dcache, db))
 	 return 0;
+
+      /* Grab the byte before prefetching; with a very small cache the
+	 read-ahead allocations could recycle DB.  */
+      *ptr = db->data[XFORM (dcache, addr)];
+
+      if (dcache->seq_run >= DCACHE_PREFETCH_THRESHOLD)
+	dcache_prefetch (dcache, line + dcache->line_size);
+
+      return 1;
     }
 
+  dcache->hit_count++;
+
   *ptr = db->data[XFORM (dcache, addr)];
   return 1;
 }
@@ -459,6 +565,11 @@ dcache_init (void)
   dcache->line_size = dcache_line_size;
   dcache->ptid = null_ptid;
   dcache->proc_target = nullptr;
+  dcache->next_expected_line = 0;
+  dcache->seq_run = 0;
+  dcache->hit_count = 0;
+  dcache->miss_count = 0;
+  dcache->prefetch_count = 0;
 
   return dcache;
 }
@@ -644,6 +755,11 @@ dcache_info_1 (DCACHE *dcache, const char *exp)
     }
 
   gdb_printf (_("Cache state: %d active lines, %d hits\n"), i, refcount);
+
+  gdb_printf (_("Session totals: %s hits, %s misses, %s lines prefetched\n"),
+	      pulongest (dcache->hit_count),
+	      pulongest (dcache->miss_count),
+	      pulongest (dcache->prefetch_count));
 }
 
 static void
@@ -652,6 +768,26 @@ info_dcache_command (const char *exp, int tty)
   dcache_info_1 (target_dcache_get (), exp);
 }
 
+/* See dcache.h.  */
+
+void
+dcache_print_stats (DCACHE *dcache, struct ui_file *stream)
+{
+  if (dcache == NULL || dcache->ptid == null_ptid)
+    {
+      gdb_printf (stream, _("  Data cache not in use.\n"));
+      return;
+    }
+
+  gdb_printf (stream,
+	      _("  Data cache (%s): %s hits, %s misses, "
+		"%s lines prefetched\n"),
+	      target_pid_to_str (dcache->ptid).c_str (),
+	      pulongest (dcache->hit_count),
+	      pulongest (dcache->miss_count),
+	      pulongest (dcache->prefetch_count));
+}
+
 static void
 set_dcache_size (const char *args, int from_tty,
 		 struct cmd_list_element *c)
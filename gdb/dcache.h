@@ -52,4 +52,8 @@ void dcache_update (DCACHE *dcache, enum target_xfer_status status,
 		    CORE_ADDR memaddr, const gdb_byte *myaddr,
 		    ULONGEST len);
 
+/* Print a one-line summary of DCACHE's session statistics to STREAM,
+   for "maint info io-stats".  DCACHE may be NULL.  */
+void dcache_print_stats (DCACHE *dcache, struct ui_file *stream);
+
 #endif /* DCACHE_H */
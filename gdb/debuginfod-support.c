@@ -101,11 +101,26 @@ debuginfod_section_query (const unsigned char *build_id,
 {
   return scoped_fd (-ENOSYS);
 }
+
+void
+debuginfod_debuginfo_prefetch (std::vector<gdb::byte_vector> &&build_ids)
+{
+}
 #define NO_IMPL _("Support for debuginfod is not compiled into GDB.")
 
 #else
 #include <elfutils/debuginfod.h>
 
+#if CXX_STD_THREAD
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#endif
+
 struct user_data
 {
   user_data (const char *desc, const char *fname)
@@ -290,6 +305,247 @@ debuginfod_is_enabled ()
   return true;
 }
 
+/* Background prefetching of debug info files.
+
+   When a burst of new shared libraries needs debug info downloaded, a
+   handful of worker threads fetch the files concurrently, each with a
+   debuginfod client private to that thread.  The downloads land in
+   the client's local cache, so when the main thread later queries one
+   of these build-ids it finds the file locally.  The workers must not
+   touch any other GDB state -- no printing, no quit checking -- and
+   only communicate with the main thread through the queue below.  */
+
+#if CXX_STD_THREAD
+
+/* Maximum number of concurrent background downloads.  Deliberately
+   modest, to be kind to the servers while still hiding most of the
+   round-trip latency.  */
+constexpr size_t prefetch_max_workers = 4;
+
+enum class prefetch_status
+{
+  pending,	/* Not yet picked up by a worker.  */
+  active,	/* A worker is downloading it.  */
+  done		/* Downloaded, claimed by the main thread, or
+		   abandoned.  */
+};
+
+struct prefetch_entry
+{
+  gdb::byte_vector build_id;
+  prefetch_status status = prefetch_status::pending;
+};
+
+/* The queue and the worker bookkeeping, all protected by
+   PREFETCH_LOCK.  The queue is a list because workers keep pointers
+   to entries while downloading them.  */
+
+static std::mutex prefetch_lock;
+static std::condition_variable prefetch_cv;
+static std::list<prefetch_entry> prefetch_queue;
+static std::vector<std::thread> prefetch_threads;
+static size_t prefetch_n_workers = 0;
+
+/* Set to terminate the workers.  It is checked from their progress
+   callbacks, so setting it also aborts downloads in progress.  */
+
+static std::atomic<bool> prefetch_cancel { false };
+
+/* Progress callback for the worker clients.  Workers must not touch
+   the UI, so this only implements cancellation.  */
+
+static int
+prefetch_progressfn (debuginfod_client *c, long cur, long total)
+{
+  return prefetch_cancel ? 1 : 0;
+}
+
+/* Body of a prefetch worker thread.  Repeatedly take a pending entry
+   from the queue and download it, until the queue is drained or the
+   prefetch is cancelled.  */
+
+static void
+prefetch_worker ()
+{
+  debuginfod_client *c = debuginfod_begin ();
+
+  if (c != nullptr)
+    {
+      debuginfod_set_progressfn (c, prefetch_progressfn);
+
+      while (!prefetch_cancel)
+	{
+	  prefetch_entry *entry = nullptr;
+
+	  {
+	    std::lock_guard<std::mutex> guard (prefetch_lock);
+
+	    for (prefetch_entry &e : prefetch_queue)
+	      if (e.status == prefetch_status::pending)
+		{
+		  e.status = prefetch_status::active;
+		  entry = &e;
+		  break;
+		}
+	  }
+	  if (entry == nullptr)
+	    break;
+
+	  char *dname = nullptr;
+	  int fd = debuginfod_find_debuginfo (c, entry->build_id.data (),
+					      entry->build_id.size (),
+					      &dname);
+	  if (fd >= 0)
+	    ::close (fd);
+	  free (dname);
+
+	  {
+	    std::lock_guard<std::mutex> guard (prefetch_lock);
+	    entry->status = prefetch_status::done;
+	  }
+	  prefetch_cv.notify_all ();
+	}
+
+      debuginfod_end (c);
+    }
+
+  {
+    std::lock_guard<std::mutex> guard (prefetch_lock);
+    prefetch_n_workers--;
+  }
+  prefetch_cv.notify_all ();
+}
+
+/* Stop and join the workers before GDB exits, so that their clients
+   are shut down before the at_exit handlers of the libraries used by
+   debuginfod run.  */
+
+static void
+cleanup_prefetch_threads (void *arg)
+{
+  prefetch_cancel = true;
+  for (std::thread &t : prefetch_threads)
+    t.join ();
+  prefetch_threads.clear ();
+}
+
+/* If BUILD_ID is on the prefetch queue, wait until its download has
+   finished, so that the caller's own query hits the client cache.  A
+   still-pending entry is claimed instead: the caller downloads the
+   file itself, with the usual progress output.  */
+
+static void
+prefetch_wait_for (const unsigned char *build_id, int build_id_len)
+{
+  std::unique_lock<std::mutex> guard (prefetch_lock);
+
+  for (prefetch_entry &e : prefetch_queue)
+    {
+      if (e.build_id.size () != (size_t) build_id_len
+	  || memcmp (e.build_id.data (), build_id, build_id_len) != 0)
+	continue;
+
+      if (e.status == prefetch_status::pending)
+	e.status = prefetch_status::done;
+      else
+	while (e.status == prefetch_status::active && !prefetch_cancel)
+	  {
+	    /* The wait must remain interruptible.  On quit, abort the
+	       background downloads and re-raise the quit flag so that
+	       the caller's own download winds down as usual.  */
+	    if (check_quit_flag ())
+	      {
+		prefetch_cancel = true;
+		set_quit_flag ();
+		break;
+	      }
+	    prefetch_cv.wait_for (guard, std::chrono::milliseconds (50));
+	  }
+      break;
+    }
+}
+
+#else /* !CXX_STD_THREAD */
+
+static void
+prefetch_wait_for (const unsigned char *build_id, int build_id_len)
+{
+}
+
+#endif /* CXX_STD_THREAD */
+
+/* See debuginfod-support.h.  */
+
+void
+debuginfod_debuginfo_prefetch (std::vector<gdb::byte_vector> &&build_ids)
+{
+#if CXX_STD_THREAD
+  if (build_ids.empty () || !debuginfod_is_enabled ())
+    return;
+
+  std::lock_guard<std::mutex> guard (prefetch_lock);
+
+  /* With no live workers nothing references the old entries or thread
+     objects; reap them and re-arm cancellation.  */
+  if (prefetch_n_workers == 0)
+    {
+      for (std::thread &t : prefetch_threads)
+	t.join ();
+      prefetch_threads.clear ();
+      prefetch_queue.clear ();
+      prefetch_cancel = false;
+    }
+  else if (prefetch_cancel)
+    return;
+
+  for (gdb::byte_vector &build_id : build_ids)
+    {
+      bool known = false;
+
+      for (const prefetch_entry &e : prefetch_queue)
+	if (e.build_id.size () == build_id.size ()
+	    && memcmp (e.build_id.data (), build_id.data (),
+		       build_id.size ()) == 0)
+	  {
+	    known = true;
+	    break;
+	  }
+      if (known)
+	continue;
+
+      prefetch_queue.emplace_back ();
+      prefetch_queue.back ().build_id = std::move (build_id);
+    }
+
+  size_t n_pending = 0;
+  for (const prefetch_entry &e : prefetch_queue)
+    if (e.status == prefetch_status::pending)
+      n_pending++;
+
+  static bool cleanup_registered = false;
+  if (!cleanup_registered)
+    {
+      make_final_cleanup (cleanup_prefetch_threads, nullptr);
+      cleanup_registered = true;
+    }
+
+  while (prefetch_n_workers < std::min (prefetch_max_workers, n_pending))
+    {
+      try
+	{
+	  prefetch_threads.emplace_back (prefetch_worker);
+	}
+      catch (const std::system_error &)
+	{
+	  /* Thread creation failed; the remaining entries stay
+	     pending and are picked up by the regular queries.  */
+	  break;
+	}
+      prefetch_n_workers++;
+    }
+#endif /* CXX_STD_THREAD */
+}
+
 /* Print the result of the most recent attempted download.  */
 
 static void
@@ -364,6 +620,11 @@ debuginfod_debuginfo_query (const unsigned char *build_id,
   if (c == nullptr)
     return scoped_fd (-ENOMEM);
 
+  /* If this file is being prefetched in the background, wait for that
+     download instead of starting a second one; the query below then
+     finds the file in the client's cache.  */
+  prefetch_wait_for (build_id, build_id_len);
+
   char *dname = nullptr;
   scoped_fd fd;
   gdb::optional<target_terminal::scoped_restore_terminal_state> term_state;
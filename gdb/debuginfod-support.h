@@ -20,6 +20,8 @@
 #define DEBUGINFOD_SUPPORT_H
 
 #include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/byte-vector.h"
+#include <vector>
 
 /* Query debuginfod servers for a source file associated with an
    executable with BUILD_ID.  BUILD_ID can be given as a binary blob or
@@ -105,4 +107,21 @@ extern scoped_fd debuginfod_section_query (const unsigned char *build_id,
 					   const char *section_name,
 					   gdb::unique_xmalloc_ptr<char>
 					     *destname);
+
+/* Start downloading the debug info files for BUILD_IDS in the
+   background.  Each worker thread uses its own debuginfod client, so
+   the downloads proceed concurrently and populate the client's local
+   cache; a later debuginfod_debuginfo_query for one of these build-ids
+   waits for the download it needs (if it is still in flight) and then
+   finds the file in the cache.  This lets GDB overlap the downloads
+   for a burst of new shared libraries with the symbol reading of the
+   libraries that have already arrived.
+
+   This is a hint only: if debuginfod is disabled, GDB was built
+   without thread support, or a worker cannot be created, the later
+   queries simply download the files themselves as usual.  */
+
+extern void debuginfod_debuginfo_prefetch
+  (std::vector<gdb::byte_vector> &&build_ids);
+
 #endif /* DEBUGINFOD_SUPPORT_H */
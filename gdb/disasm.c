@@ -25,6 +25,7 @@
 #include "disasm.h"
 #include "gdbcore.h"
 #include "gdbcmd.h"
+#include "inferior.h"
 #include "dis-asm.h"
 #include "source.h"
 #include "gdbsupport/gdb-safe-ctype.h"
@@ -33,6 +34,8 @@
 #include "valprint.h"
 #include "cli/cli-style.h"
 #include "objfiles.h"
+#include "observable.h"
+#include <unordered_map>
 
 /* Disassemble functions.
    FIXME: We should get rid of all the duplicate code in gdb that does
@@ -97,6 +100,9 @@ set_use_libopcodes_styling (const char *args, int from_tty,
     }
   else
     use_libopcodes_styling = use_libopcodes_styling_option;
+
+  /* The styling engine feeds the rendered-instruction cache.  */
+  gdb_disasm_flush_insn_cache ();
 }
 
 /* This structure is used to store line number information for the
@@ -187,6 +193,96 @@ line_has_code_p (htab_t table, struct symtab *symtab, int line)
   return htab_find (table, &dle) != NULL;
 }
 
+/* A sliding read-ahead window over target code memory.  The opcodes
+   disassemblers fetch a few bytes per call; disassembling a large
+   function one instruction at a time used to issue thousands of small
+   target reads.  Filling this window costs one target read per four
+   kilobytes of code and every read inside it is a memcpy, which makes
+   bulk disassembly of remote and core targets bandwidth-bound instead
+   of call-count-bound.  The window is dropped whenever the inferior
+   resumes or memory is written, so it can never serve stale bytes.  */
+
+struct disasm_code_window
+{
+  /* The inferior the window was read from, or nullptr if the window
+     is invalid.  */
+  struct inferior *inf = nullptr;
+
+  /* The first address covered and the number of valid bytes in DATA;
+     zero if only SKIP_START below is meaningful.  */
+  CORE_ADDR start = 0;
+  unsigned int size = 0;
+
+  /* Start of a stretch where filling the window failed.  Reads in
+     [SKIP_START, SKIP_START + sizeof (DATA)) go straight to the
+     target, so an unreadable tail of a mapping does not cost one
+     failed window fill per instruction.  Only meaningful while
+     SKIP_VALID is true.  */
+  CORE_ADDR skip_start = 0;
+  bool skip_valid = false;
+
+  gdb_byte data[4096];
+};
+
+static disasm_code_window code_window;
+
+/* Invalidate the code read-ahead window.  */
+
+static void
+disasm_invalidate_code_window ()
+{
+  code_window.inf = nullptr;
+  code_window.size = 0;
+  code_window.skip_valid = false;
+}
+
+/* Read LEN bytes of code at MEMADDR into MYADDR through the read-ahead
+   window.  Returns 0 on success, like target_read_code.  */
+
+static int
+disasm_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, unsigned int len)
+{
+  if (len > sizeof (code_window.data))
+    return target_read_code (memaddr, myaddr, len);
+
+  struct inferior *inf = current_inferior ();
+  if (code_window.inf != inf)
+    {
+      disasm_invalidate_code_window ();
+      code_window.inf = inf;
+    }
+
+  if (code_window.size > 0
+      && memaddr >= code_window.start
+      && memaddr - code_window.start + len <= code_window.size)
+    {
+      memcpy (myaddr, code_window.data + (memaddr - code_window.start), len);
+      return 0;
+    }
+
+  if (!code_window.skip_valid
+      || memaddr < code_window.skip_start
+      || memaddr - code_window.skip_start >= sizeof (code_window.data))
+    {
+      if (target_read_code (memaddr, code_window.data,
+			    sizeof (code_window.data)) == 0)
+	{
+	  code_window.start = memaddr;
+	  code_window.size = sizeof (code_window.data);
+	  memcpy (myaddr, code_window.data, len);
+	  return 0;
+	}
+
+      /* The full window is not readable here, perhaps because MEMADDR
+	 is close to the end of a mapping.  */
+      code_window.size = 0;
+      code_window.skip_start = memaddr;
+      code_window.skip_valid = true;
+    }
+
+  return target_read_code (memaddr, myaddr, len);
+}
+
 /* Wrapper of target_read_code.  */
 
 int
@@ -194,7 +290,7 @@ gdb_disassembler_memory_reader::dis_asm_read_memory
   (bfd_vma memaddr, gdb_byte *myaddr, unsigned int len,
    struct disassemble_info *info) noexcept
 {
-  return target_read_code (memaddr, myaddr, len);
+  return disasm_read_code (memaddr, myaddr, len);
 }
 
 /* Wrapper of memory_error.  */
@@ -237,20 +333,61 @@ gdb_disassembler::dis_asm_print_address
       self->fprintf_styled_func (self, dis_style_text, "%s", tmp.c_str ());
     }
   else
-    print_address (self->arch (), addr, self->stream ());
+    {
+      /* PRINT_ADDRESS mixes styled and unstyled output; render it into
+	 a temporary and queue the result as a raw run, to be copied
+	 out verbatim between the surrounding styled runs.  */
+      string_file tmp (self->stream ()->term_out ());
+      print_address (self->arch (), addr, &tmp);
+      self->get_run (ui_file_style (), true).text = tmp.release ();
+    }
+}
+
+/* See disasm.h.  */
+
+gdb_printing_disassembler::styled_run &
+gdb_printing_disassembler::get_run (const ui_file_style &style, bool raw)
+{
+  if (m_num_runs > 0)
+    {
+      styled_run &tail = m_runs[m_num_runs - 1];
+
+      if (!raw && !tail.raw && tail.style == style)
+	return tail;
+    }
+
+  if (m_num_runs == m_runs.size ())
+    m_runs.emplace_back ();
+
+  styled_run &run = m_runs[m_num_runs++];
+  run.style = style;
+  run.raw = raw;
+  run.text.clear ();
+  return run;
 }
 
 /* See disasm.h.  */
 
-ui_file *
-gdb_printing_disassembler::stream_from_gdb_disassemble_info (void *dis_info)
+void
+gdb_printing_disassembler::flush_runs ()
 {
-  gdb_disassemble_info *di = (gdb_disassemble_info *) dis_info;
-  gdb_printing_disassembler *dis
-    = gdb::checked_static_cast<gdb_printing_disassembler *> (di);
-  ui_file *stream = dis->stream ();
-  gdb_assert (stream != nullptr);
-  return stream;
+  ui_file *stream = this->stream ();
+
+  for (size_t i = 0; i < m_num_runs; ++i)
+    {
+      const styled_run &run = m_runs[i];
+
+      /* emit_style_escape elides the escape when the style does not
+	 change and when the stream cannot style at all.  Raw text
+	 carries its own escapes and ends in the default style, so
+	 reset before it to keep the stream's notion of the applied
+	 style accurate.  */
+      stream->emit_style_escape (run.raw ? ui_file_style () : run.style);
+      stream->puts (run.text.c_str ());
+    }
+
+  stream->emit_style_escape (ui_file_style ());
+  m_num_runs = 0;
 }
 
 /* Format disassembler output to STREAM.  */
@@ -259,11 +396,11 @@ int
 gdb_printing_disassembler::fprintf_func (void *dis_info,
 					 const char *format, ...) noexcept
 {
-  ui_file *stream = stream_from_gdb_disassemble_info (dis_info);
+  gdb_printing_disassembler *dis = (gdb_printing_disassembler *) dis_info;
 
   va_list args;
   va_start (args, format);
-  gdb_vprintf (stream, format, args);
+  string_vappendf (dis->get_run (ui_file_style ()).text, format, args);
   va_end (args);
 
   /* Something non -ve.  */
@@ -277,56 +414,56 @@ gdb_printing_disassembler::fprintf_styled_func
   (void *dis_info, enum disassembler_style style,
    const char *format, ...) noexcept
 {
-  ui_file *stream = stream_from_gdb_disassemble_info (dis_info);
   gdb_printing_disassembler *dis = (gdb_printing_disassembler *) dis_info;
 
-  va_list args;
-  va_start (args, format);
-  std::string content = string_vprintf (format, args);
-  va_end (args);
-
   /* Once in a comment then everything should be styled as a comment.  */
   if (style == dis_style_comment_start)
     dis->set_in_comment (true);
   if (dis->in_comment_p ())
     style = dis_style_comment_start;
 
-  /* Now print the content with the correct style.  */
-  const char *txt = content.c_str ();
+  /* Map the libopcodes style onto the user's styling preferences.  */
+  ui_file_style file_style;
   switch (style)
     {
     case dis_style_mnemonic:
     case dis_style_sub_mnemonic:
     case dis_style_assembler_directive:
-      fputs_styled (txt, disasm_mnemonic_style.style (), stream);
+      file_style = disasm_mnemonic_style.style ();
       break;
 
     case dis_style_register:
-      fputs_styled (txt, disasm_register_style.style (), stream);
+      file_style = disasm_register_style.style ();
       break;
 
     case dis_style_immediate:
     case dis_style_address_offset:
-      fputs_styled (txt, disasm_immediate_style.style (), stream);
+      file_style = disasm_immediate_style.style ();
       break;
 
     case dis_style_address:
-      fputs_styled (txt, address_style.style (), stream);
+      file_style = address_style.style ();
       break;
 
     case dis_style_symbol:
-      fputs_styled (txt, function_name_style.style (), stream);
+      file_style = function_name_style.style ();
       break;
 
     case dis_style_comment_start:
-      fputs_styled (txt, disasm_comment_style.style (), stream);
+      file_style = disasm_comment_style.style ();
       break;
 
     case dis_style_text:
-      gdb_puts (txt, stream);
       break;
     }
 
+  /* Append the content to the current instruction's runs; it reaches
+     the stream in one pass when the instruction is complete.  */
+  va_list args;
+  va_start (args, format);
+  string_vappendf (dis->get_run (file_style).text, format, args);
+  va_end (args);
+
   /* Something non -ve.  */
   return 0;
 }
@@ -1103,6 +1240,160 @@ gdb_print_insn_1 (struct gdbarch *gdbarch, CORE_ADDR vma,
 
 bool gdb_disassembler::use_ext_lang_colorization_p = true;
 
+/* Cache of rendered instructions.  Decoding and formatting a single
+   instruction is cheap, but profiling and annotation tools disassemble
+   the same hot ranges over and over, and the libopcodes rendering (plus
+   any extension-language styling) dominates that loop.  The hash of the
+   code bytes is part of the key, so a hit can only ever replay output
+   that the current contents of memory would produce.
+
+   Every consumer that constructs a gdb_disassembler with the standard
+   target memory reader shares this cache: the "disassemble" command,
+   the TUI assembly window (which re-disassembles the same window on
+   every step, via gdb_print_insn), and the record/btrace history
+   printers (via gdb_pretty_print_disassembler).  */
+
+struct insn_cache_key
+{
+  struct gdbarch *arch;
+  struct program_space *pspace;
+  CORE_ADDR addr;
+  /* Whether the output was rendered with styling support.  */
+  bool styled;
+  /* Hash of the code bytes the instruction was rendered from.  */
+  unsigned int code_hash;
+
+  bool operator== (const insn_cache_key &other) const
+  {
+    return (arch == other.arch
+	    && pspace == other.pspace
+	    && addr == other.addr
+	    && styled == other.styled
+	    && code_hash == other.code_hash);
+  }
+};
+
+/* Hash function for insn_cache_key.  */
+
+struct insn_cache_key_hash
+{
+  size_t operator() (const insn_cache_key &key) const
+  {
+    return (std::hash<void *> () (key.arch)
+	    ^ std::hash<CORE_ADDR> () (key.addr)
+	    ^ key.code_hash ^ (key.styled ? 1 : 0));
+  }
+};
+
+/* What the cache remembers about an instruction: the rendered text,
+   the instruction length, and the number of branch delay slot
+   instructions (zero when the disassembler did not say).  */
+
+struct insn_cache_value
+{
+  std::string text;
+  int length;
+  int branch_delay_insns;
+};
+
+/* Bound on the number of cached instructions.  When the limit is hit
+   the whole cache is dropped and rebuilt rather than tracking
+   per-entry ages; a full rebuild is cheap relative to how rarely it
+   happens.  */
+
+#define INSN_CACHE_MAX_SIZE 65536
+
+static std::unordered_map<insn_cache_key, insn_cache_value,
+			  insn_cache_key_hash> insn_cache;
+
+/* See disasm.h.  */
+
+void
+gdb_disasm_flush_insn_cache ()
+{
+  insn_cache.clear ();
+}
+
+/* Compute the hash of the code bytes at ADDR into *HASH and return
+   true.  Return false if the bytes cannot be read, in which case the
+   instruction is simply not cached.  */
+
+static bool
+insn_cache_code_hash (struct gdbarch *gdbarch, CORE_ADDR addr,
+		      unsigned int *hash)
+{
+  /* When the architecture does not say how long its longest
+     instruction is, hash a fixed-size window.  The exact width does
+     not matter for correctness, only that lookup and store use the
+     same bytes.  */
+  int len = (gdbarch_max_insn_length_p (gdbarch)
+	     ? gdbarch_max_insn_length (gdbarch) : 16);
+  gdb_byte buf[32];
+
+  gdb_assert (len <= (int) sizeof (buf));
+  if (disasm_read_code (addr, buf, len) != 0)
+    return false;
+
+  *hash = fast_hash (buf, len);
+  return true;
+}
+
+/* Observers that drop the rendered-instruction cache whenever its
+   inputs may have changed behind our back.  */
+
+static void
+disasm_memory_changed_observer (struct inferior *inferior, CORE_ADDR addr,
+				ssize_t len, const bfd_byte *data)
+{
+  gdb_disasm_flush_insn_cache ();
+  disasm_invalidate_code_window ();
+}
+
+static void
+disasm_free_objfile_observer (struct objfile *objfile)
+{
+  gdb_disasm_flush_insn_cache ();
+  disasm_invalidate_code_window ();
+}
+
+/* New symbols can change how a branch target is symbolized, even when
+   the code bytes themselves are unchanged.  */
+
+static void
+disasm_new_objfile_observer (struct objfile *objfile)
+{
+  gdb_disasm_flush_insn_cache ();
+  disasm_invalidate_code_window ();
+}
+
+static void
+disasm_all_objfiles_removed_observer (program_space *pspace)
+{
+  gdb_disasm_flush_insn_cache ();
+  disasm_invalidate_code_window ();
+}
+
+/* The instruction cache keys on a hash of the current code bytes and
+   needs no flush when the inferior runs; the read-ahead window has no
+   such protection and must not survive a resume.  */
+
+static void
+disasm_target_resumed_observer (ptid_t ptid)
+{
+  disasm_invalidate_code_window ();
+}
+
+/* Drop the read-ahead window between commands.  Some memory writes do
+   not fire the memory_changed observer (replaying a recording, for
+   one), so the window is not allowed to outlive the command that
+   filled it.  */
+
+static void
+disasm_before_prompt_observer (const char *current_gdb_prompt)
+{
+  disasm_invalidate_code_window ();
+}
+
 /* See disasm.h.  */
 
 int
@@ -1113,8 +1404,38 @@ gdb_disassembler::print_insn (CORE_ADDR memaddr,
   m_buffer.clear ();
   this->set_in_comment (false);
 
+  /* Look for a previously rendered copy of this instruction.  Only
+     disassemblers reading target memory can use the cache -- reading
+     the bytes for the key costs no more than the read the
+     disassembler itself is about to do.  */
+  insn_cache_key key;
+  bool key_valid = (m_cacheable
+		    && insn_cache_code_hash (arch (), memaddr,
+					     &key.code_hash));
+  if (key_valid)
+    {
+      key.arch = arch ();
+      key.pspace = current_program_space;
+      key.addr = memaddr;
+      key.styled = m_buffer.term_out ();
+
+      auto it = insn_cache.find (key);
+      if (it != insn_cache.end ())
+	{
+	  gdb_printf (m_dest, "%s", it->second.text.c_str ());
+	  if (branch_delay_insns != NULL)
+	    *branch_delay_insns = it->second.branch_delay_insns;
+	  return it->second.length;
+	}
+    }
+
   int length = gdb_print_insn_1 (arch (), memaddr, &m_di);
 
+  /* Write the accumulated styled runs into M_BUFFER; runs of
+     same-styled fragments are separated by no escape sequences at
+     all.  */
+  flush_runs ();
+
   /* If we have successfully disassembled an instruction, disassembler
      styling using the extension language is on, and libopcodes hasn't
      already styled the output for us, and, if the destination can support
@@ -1152,10 +1473,28 @@ gdb_disassembler::print_insn (CORE_ADDR memaddr,
 	  m_buffer.~string_file ();
 	  new (&m_buffer) string_file (use_libopcodes_for_styling ());
 	  length = gdb_print_insn_1 (arch (), memaddr, &m_di);
+	  flush_runs ();
 	  gdb_assert (length > 0);
 	}
     }
 
+  /* Remember the rendered form for the next time this instruction is
+     disassembled.  */
+  if (key_valid && length > 0)
+    {
+      /* The styling fallback above may have recreated m_buffer with a
+	 different styling mode than the one the key was built from;
+	 file the text under the mode that actually produced it.  */
+      key.styled = m_buffer.term_out ();
+      if (insn_cache.size () >= INSN_CACHE_MAX_SIZE)
+	insn_cache.clear ();
+      insn_cache.emplace (key,
+			  insn_cache_value { m_buffer.string (), length,
+					     (m_di.insn_info_valid
+					      ? m_di.branch_delay_insns
+					      : 0) });
+    }
+
   /* Push any disassemble output to the real destination stream.  We do
      this even if the disassembler reported failure (-1) as the
      disassembler may have printed something to its output stream.  */
@@ -1300,6 +1639,10 @@ get_disassembler_options (struct gdbarch *gdbarch)
 void
 set_disassembler_options (const char *prospective_options)
 {
+  /* The options change what the disassembler prints; previously
+     rendered instructions no longer apply.  */
+  gdb_disasm_flush_insn_cache ();
+
   struct gdbarch *gdbarch = get_current_arch ();
   char **disassembler_options = gdbarch_disassembler_options (gdbarch);
   const disasm_options_and_args_t *valid_options_and_args;
@@ -1516,6 +1859,19 @@ void _initialize_disasm ();
 void
 _initialize_disasm ()
 {
+  gdb::observers::memory_changed.attach (disasm_memory_changed_observer,
+					 "disasm");
+  gdb::observers::free_objfile.attach (disasm_free_objfile_observer,
+				       "disasm");
+  gdb::observers::new_objfile.attach (disasm_new_objfile_observer,
+				      "disasm");
+  gdb::observers::all_objfiles_removed.attach
+    (disasm_all_objfiles_removed_observer, "disasm");
+  gdb::observers::target_resumed.attach (disasm_target_resumed_observer,
+					 "disasm");
+  gdb::observers::before_prompt.attach (disasm_before_prompt_observer,
+					"disasm");
+
   /* Add the command that controls the disassembler options.  */
   set_show_commands set_show_disas_opts
     = add_setshow_string_noescape_cmd ("disassembler-options", no_class,
@@ -21,6 +21,9 @@
 
 #include "dis-asm.h"
 #include "disasm-flags.h"
+#include "ui-style.h"
+
+#include <vector>
 
 struct gdbarch;
 struct ui_out;
@@ -148,13 +151,15 @@ protected:
 
   /* Callback used as the disassemble_info's fprintf_func callback.  The
      DIS_INFO pointer is a pointer to a gdb_printing_disassembler object.
-     Content is written to the m_stream extracted from DIS_INFO.  */
+     Content is accumulated in M_RUNS and reaches m_stream when
+     flush_runs is called.  */
   static int fprintf_func (void *dis_info, const char *format, ...) noexcept
     ATTRIBUTE_PRINTF (2, 3);
 
   /* Callback used as the disassemble_info's fprintf_styled_func callback.
      The DIS_INFO pointer is a pointer to a gdb_printing_disassembler
-     object.  Content is written to the m_stream extracted from DIS_INFO.  */
+     object.  Content is accumulated in M_RUNS and reaches m_stream when
+     flush_runs is called.  */
   static int fprintf_styled_func (void *dis_info,
 				  enum disassembler_style style,
 				  const char *format, ...) noexcept
@@ -170,20 +175,40 @@ protected:
   void set_in_comment (bool c)
   { m_in_comment = c; }
 
-private:
+  /* A single run of same-styled disassembler output, see M_RUNS below.
+     RAW runs hold text with any style escapes already rendered (see
+     gdb_disassembler::dis_asm_print_address) and are copied to the
+     stream verbatim.  */
+  struct styled_run
+  {
+    ui_file_style style;
+    bool raw = false;
+    std::string text;
+  };
+
+  /* Return the run to append text of STYLE to, reusing the last run
+     when the style matches.  */
+  styled_run &get_run (const ui_file_style &style, bool raw = false);
 
-  /* When libopcodes calls the fprintf_func and fprintf_styled_func
-     callbacks, a 'void *' argument is passed.  We arrange, through our
-     call to init_disassemble_info that this argument will be a pointer to
-     a gdb_disassemble_info sub-class, specifically, a
-     gdb_printing_disassembler pointer.  This helper function casts
-     DIS_INFO to the correct type (with some asserts), and then returns the
-     m_stream member variable.  */
-  static ui_file *stream_from_gdb_disassemble_info (void *dis_info);
+  /* Write the accumulated runs of the current instruction to the stream
+     in one pass and forget them.  */
+  void flush_runs ();
+
+private:
 
   /* The stream to which output should be sent.  */
   struct ui_file *m_stream;
 
+  /* Output of the current instruction, accumulated as runs of
+     same-styled text and written to the stream in one pass by
+     flush_runs.  Forwarding each libopcodes token to the stream as it
+     arrived cost a string allocation and a styled write per token.
+     The first M_NUM_RUNS entries are in use; the entries and their
+     strings are reused from instruction to instruction, so a steady
+     disassembly loop does not allocate here at all.  */
+  std::vector<styled_run> m_runs;
+  size_t m_num_runs = 0;
+
   /* Are we inside a comment?  This will be set true if the disassembler
      uses styled output and emits a start of comment character.  It is up
      to the code that uses this disassembler class to reset this flag back
@@ -256,7 +281,12 @@ struct gdb_disassembler : public gdb_printing_disassembler,
 {
   gdb_disassembler (struct gdbarch *gdbarch, struct ui_file *file)
     : gdb_disassembler (gdbarch, file, dis_asm_read_memory)
-  { /* Nothing.  */ }
+  {
+    /* Only disassemblers reading target memory can use the rendered
+       instruction cache; a custom memory reader may see different
+       bytes than the cache key would be computed from.  */
+    m_cacheable = true;
+  }
 
   DISABLE_COPY_AND_ASSIGN (gdb_disassembler);
 
@@ -280,6 +310,10 @@ private:
   /* The stream to which disassembler output will be written.  */
   ui_file *m_dest;
 
+  /* True if print_insn may use the rendered instruction cache.  Set
+     only when the standard target memory reader is in use.  */
+  bool m_cacheable = false;
+
   /* Disassembler output is built up into this buffer.  Whether this
      string_file is created with styling support or not depends on the
      value of use_ext_lang_colorization_p, as well as whether disassembler
@@ -391,6 +425,12 @@ private:
 
 extern int gdb_insn_length (struct gdbarch *gdbarch, CORE_ADDR memaddr);
 
+/* Discard all cached rendered instructions.  Called whenever
+   something that can change disassembler output -- options, the set
+   of registered extension-language disassemblers -- changes.  */
+
+extern void gdb_disasm_flush_insn_cache ();
+
 /* Return the length in bytes of INSN, originally at MEMADDR.  MAX_LEN
    is the size of the buffer containing INSN.  */
 
@@ -109,20 +109,30 @@ displaced_step_buffers::prepare (thread_info *thread, CORE_ADDR &displaced_pc)
   /* Return displaced step buffer address to caller.  */
   displaced_pc = buffer->addr;
 
-  /* Save the original contents of the displaced stepping buffer.  */
-  buffer->saved_copy.resize (len);
-
-  int status = target_read_memory (buffer->addr,
-				    buffer->saved_copy.data (), len);
-  if (status != 0)
-    throw_error (MEMORY_ERROR,
-		 _("Error accessing memory address %s (%s) for "
-		   "displaced-stepping scratch space."),
-		 paddress (arch, buffer->addr), safe_strerror (status));
-
-  displaced_debug_printf ("saved %s: %s",
-			  paddress (arch, buffer->addr),
-			  bytes_to_string (buffer->saved_copy).c_str ());
+  /* Save the original contents of the displaced stepping buffer.
+     Since finish restores the saved contents, once saved, the copy
+     stays valid for the lifetime of the buffer, and further steps
+     through the same buffer can skip re-reading it.  */
+  if (buffer->saved_copy.empty ())
+    {
+      buffer->saved_copy.resize (len);
+
+      int status = target_read_memory (buffer->addr,
+				       buffer->saved_copy.data (), len);
+      if (status != 0)
+	{
+	  buffer->saved_copy.clear ();
+	  throw_error (MEMORY_ERROR,
+		       _("Error accessing memory address %s (%s) for "
+			 "displaced-stepping scratch space."),
+		       paddress (arch, buffer->addr),
+		       safe_strerror (status));
+	}
+
+      displaced_debug_printf ("saved %s: %s",
+			      paddress (arch, buffer->addr),
+			      bytes_to_string (buffer->saved_copy).c_str ());
+    }
 
   /* Save this in a local variable first, so it's released if code below
      throws.  */
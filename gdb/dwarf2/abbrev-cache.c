@@ -21,30 +21,65 @@
 #include "dwarf2/read.h"
 #include "dwarf2/abbrev-cache.h"
 
-/* Hash function for an abbrev table.  */
+/* Hash function for a cache entry.  */
 
 hashval_t
-abbrev_cache::hash_table (const void *item)
+abbrev_cache::hash_entry (const void *item)
 {
-  const struct abbrev_table *table = (const struct abbrev_table *) item;
-  return to_underlying (table->sect_off);
+  const cache_entry *entry = (const cache_entry *) item;
+  return to_underlying (entry->offset);
 }
 
-/* Comparison function for abbrev table.  */
+/* Comparison function for cache entries.  */
 
 int
-abbrev_cache::eq_table (const void *lhs, const void *rhs)
+abbrev_cache::eq_entry (const void *lhs, const void *rhs)
 {
-  const struct abbrev_table *l_table = (const struct abbrev_table *) lhs;
+  const cache_entry *l_entry = (const cache_entry *) lhs;
   const search_key *key = (const search_key *) rhs;
-  return (l_table->section == key->section
-	  && l_table->sect_off == key->offset);
+  return (l_entry->section == key->section
+	  && l_entry->offset == key->offset);
+}
+
+/* Return the raw section bytes that TABLE was parsed from.  */
+
+static gdb::array_view<const gdb_byte>
+abbrev_table_bytes (const abbrev_table *table)
+{
+  const gdb_byte *start = (table->section->buffer
+			   + to_underlying (table->sect_off));
+  return gdb::make_array_view (start, table->raw_size ());
+}
+
+/* Hash function for the content table.  */
+
+hashval_t
+abbrev_cache::hash_content (const void *item)
+{
+  const abbrev_table *table = (const abbrev_table *) item;
+  gdb::array_view<const gdb_byte> bytes = abbrev_table_bytes (table);
+  return fast_hash (bytes.data (), bytes.size ());
+}
+
+/* Comparison function for the content table.  */
+
+int
+abbrev_cache::eq_content (const void *lhs, const void *rhs)
+{
+  const abbrev_table *l_table = (const abbrev_table *) lhs;
+  const abbrev_table *r_table = (const abbrev_table *) rhs;
+  gdb::array_view<const gdb_byte> l_bytes = abbrev_table_bytes (l_table);
+  gdb::array_view<const gdb_byte> r_bytes = abbrev_table_bytes (r_table);
+  return (l_bytes.size () == r_bytes.size ()
+	  && memcmp (l_bytes.data (), r_bytes.data (), l_bytes.size ()) == 0);
 }
 
 abbrev_cache::abbrev_cache ()
-  : m_tables (htab_create_alloc (20, hash_table, eq_table,
-				 htab_delete_entry<abbrev_table>,
-				 xcalloc, xfree))
+  : m_tables (htab_create_alloc (20, hash_entry, eq_entry,
+				 htab_delete_entry<cache_entry>,
+				 xcalloc, xfree)),
+    m_by_content (htab_create_alloc (20, hash_content, eq_content,
+				     nullptr, xcalloc, xfree))
 {
 }
 
@@ -55,11 +90,28 @@ abbrev_cache::add (abbrev_table_up table)
   if (table == nullptr)
     return;
 
-  search_key key = { table->section, table->sect_off };
+  struct dwarf2_section_info *section = table->section;
+  sect_offset offset = table->sect_off;
+
+  /* See if an identical table was already read from some other
+     offset; if so, share it rather than keeping the new copy.  */
+  void **content_slot = htab_find_slot (m_by_content.get (), table.get (),
+					INSERT);
+  abbrev_table *canonical;
+  if (*content_slot == nullptr)
+    {
+      canonical = table.get ();
+      *content_slot = canonical;
+      m_storage.push_back (std::move (table));
+    }
+  else
+    canonical = (abbrev_table *) *content_slot;
+
+  search_key key = { section, offset };
   void **slot = htab_find_slot_with_hash (m_tables.get (), &key,
-					  to_underlying (table->sect_off),
+					  to_underlying (offset),
 					  INSERT);
   /* If this one already existed, then it should have been reused.  */
   gdb_assert (*slot == nullptr);
-  *slot = (void *) table.release ();
+  *slot = (void *) new cache_entry { section, offset, canonical };
 }
@@ -22,7 +22,13 @@
 
 #include "dwarf2/abbrev.h"
 
-/* An abbrev cache holds abbrev tables for easier reuse.  */
+/* An abbrev cache holds abbrev tables for easier reuse.
+
+   Many compilers emit byte-for-byte identical abbrev tables for
+   different CUs, so in addition to mapping each section+offset to a
+   table, the cache dedups tables by content: when a newly-read table
+   has the same raw bytes as one already in the cache, the new copy is
+   dropped and the existing table serves both offsets.  */
 class abbrev_cache
 {
 public:
@@ -36,8 +42,10 @@ public:
   {
     search_key key = { section, offset };
 
-    return (abbrev_table *) htab_find_with_hash (m_tables.get (), &key,
-						 to_underlying (offset));
+    cache_entry *entry
+      = (cache_entry *) htab_find_with_hash (m_tables.get (), &key,
+					     to_underlying (offset));
+    return entry == nullptr ? nullptr : entry->table;
   }
 
   /* Add TABLE to this cache.  Ownership of TABLE is transferred to
@@ -49,8 +57,20 @@ public:
 
 private:
 
-  static hashval_t hash_table (const void *item);
-  static int eq_table (const void *lhs, const void *rhs);
+  /* An entry mapping a section+offset to its (possibly shared)
+     abbrev table.  */
+  struct cache_entry
+  {
+    struct dwarf2_section_info *section;
+    sect_offset offset;
+    abbrev_table *table;
+  };
+
+  static hashval_t hash_entry (const void *item);
+  static int eq_entry (const void *lhs, const void *rhs);
+
+  static hashval_t hash_content (const void *item);
+  static int eq_content (const void *lhs, const void *rhs);
 
   struct search_key
   {
@@ -58,8 +78,15 @@ private:
     sect_offset offset;
   };
 
-  /* Hash table of abbrev tables.  */
+  /* Hash table mapping section+offset to a cache_entry.  */
   htab_up m_tables;
+
+  /* Hash table of canonical abbrev tables, keyed by their raw section
+     bytes.  The tables are owned by m_storage.  */
+  htab_up m_by_content;
+
+  /* Storage for the unique abbrev tables.  */
+  std::vector<abbrev_table_up> m_storage;
 };
 
 #endif /* GDB_DWARF2_ABBREV_CACHE_H */
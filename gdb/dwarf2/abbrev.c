@@ -307,5 +307,8 @@ abbrev_table::read (struct dwarf2_section_info *section,
       abbrev_table->add_abbrev (cur_abbrev);
     }
 
+  abbrev_table->m_raw_size = (abbrev_ptr
+			      - (section->buffer + to_underlying (sect_off)));
+
   return abbrev_table;
 }
@@ -84,6 +84,15 @@ struct abbrev_table
 						       abbrev_number);
   }
 
+  /* Return the number of bytes this table occupies in SECTION, not
+     counting the terminating 0 entry.  Two tables with equal raw
+     sizes and equal raw bytes necessarily hold the same
+     abbreviations.  */
+  size_t raw_size () const
+  {
+    return m_raw_size;
+  }
+
   /* Where the abbrev table came from.
      This is used as a sanity check when the table is used.  */
   const sect_offset sect_off;
@@ -102,6 +111,9 @@ private:
   /* Hash table of abbrevs.  */
   htab_up m_abbrevs;
 
+  /* Number of section bytes the table was parsed from.  */
+  size_t m_raw_size = 0;
+
   /* Storage for the abbrev table.  */
   auto_obstack m_abbrev_obstack;
 };
@@ -22,16 +22,23 @@
 #include "dwarf2/read.h"
 #include "dwarf2/stringify.h"
 #include "dwarf2/index-cache.h"
+#include "dwarf2/dwz.h"
+#include "build-id.h"
 #include "cp-support.h"
 #include "c-lang.h"
 #include "ada-lang.h"
 #include "split-name.h"
 #include "observable.h"
 #include "run-on-main-thread.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/scoped_fd.h"
 #include <algorithm>
 #include "gdbsupport/gdb-safe-ctype.h"
 #include "gdbsupport/selftest.h"
 #include <chrono>
+#include <unordered_map>
 #include <unordered_set>
 #include "cli/cli-cmds.h"
 
@@ -81,10 +88,27 @@ cooked_index_entry::compare (const char *stra, const char *strb,
       return TOLOWER ((unsigned char) c);
     };
 
-  while (*stra != '\0'
-	 && *strb != '\0'
-	 && (munge (*stra) == munge (*strb)))
+  while (true)
     {
+      /* Skip the identical part of the two names cheaply.  MUNGE is a
+	 pure function of its argument, so bytes that are equal before
+	 munging are also equal after, and this avoids two table
+	 lookups per character on the common prefix -- by far the hot
+	 path when sorting or searching a large index.  */
+      while (*stra != '\0' && *stra == *strb)
+	{
+	  ++stra;
+	  ++strb;
+	}
+
+      /* Here the raw bytes differ, or at least one name ended.  The
+	 characters may still munge equally (e.g. they differ only in
+	 case), in which case keep going.  Note that if both names
+	 ended, the munged characters are equal and the test below
+	 stops the loop.  */
+      if (munge (*stra) != munge (*strb) || *stra == '\0')
+	break;
+
       ++stra;
       ++strb;
     }
@@ -259,14 +283,111 @@ cooked_index_shard::finalize ()
 
 /* See cooked-index.h.  */
 
-gdb::unique_xmalloc_ptr<char>
+void
+cooked_index_shard::mark_finalized ()
+{
+  /* Entries deserialized from the index cache skip do_finalize, so
+     the name filter has to be built here instead.  */
+  build_name_filter ();
+
+#if CXX_STD_THREAD
+  std::promise<void> promise;
+  promise.set_value ();
+  m_future = promise.get_future ();
+#else
+  /* The compatibility gdb::future is always ready.  */
+  m_future = gdb::future<void> ();
+#endif
+}
+
+/* Number of 64-bit words per name filter block.  Each block is one
+   cache line.  */
+#define NAME_FILTER_BLOCK_WORDS 8
+
+/* Number of bits each name sets within its block.  */
+#define NAME_FILTER_PROBES 3
+
+/* Hash a name for the shard name filter.  The name is case-folded
+   and truncated at the first '<', which is exactly the part of the
+   name that cooked_index_entry::compare considers significant for a
+   MATCH-mode lookup.  */
+
+static uint64_t
+name_filter_hash (const char *name)
+{
+  /* FNV-1a.  */
+  uint64_t hash = 14695981039346656037ULL;
+  for (; *name != '\0' && *name != '<'; ++name)
+    {
+      hash ^= TOLOWER ((unsigned char) *name);
+      hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+/* See cooked-index.h.  */
+
+void
+cooked_index_shard::build_name_filter ()
+{
+  /* Small shards are cheap to binary search directly.  */
+  if (m_entries.size () < 128)
+    return;
+
+  /* Size the filter at roughly 16 bits per entry, rounding the block
+     count up to a power of two so that block selection is a mask.  */
+  size_t num_blocks = 1;
+  while (num_blocks * NAME_FILTER_BLOCK_WORDS * 64 < m_entries.size () * 16)
+    num_blocks *= 2;
+  m_name_filter.assign (num_blocks * NAME_FILTER_BLOCK_WORDS, 0);
+
+  for (const cooked_index_entry *entry : m_entries)
+    {
+      uint64_t hash = name_filter_hash (entry->canonical);
+      uint64_t *block
+	= &m_name_filter[(hash & (num_blocks - 1)) * NAME_FILTER_BLOCK_WORDS];
+      /* Derive the probe bits from the top of the hash, away from
+	 the bits used to pick the block.  */
+      for (int i = 0; i < NAME_FILTER_PROBES; ++i)
+	{
+	  unsigned bit = (hash >> (37 + 9 * i)) % (NAME_FILTER_BLOCK_WORDS * 64);
+	  block[bit / 64] |= uint64_t (1) << (bit % 64);
+	}
+    }
+}
+
+/* See cooked-index.h.  */
+
+bool
+cooked_index_shard::name_filter_may_contain (const char *name) const
+{
+  size_t num_blocks = m_name_filter.size () / NAME_FILTER_BLOCK_WORDS;
+  uint64_t hash = name_filter_hash (name);
+  const uint64_t *block
+    = &m_name_filter[(hash & (num_blocks - 1)) * NAME_FILTER_BLOCK_WORDS];
+  for (int i = 0; i < NAME_FILTER_PROBES; ++i)
+    {
+      unsigned bit = (hash >> (37 + 9 * i)) % (NAME_FILTER_BLOCK_WORDS * 64);
+      if ((block[bit / 64] & (uint64_t (1) << (bit % 64))) == 0)
+	return false;
+    }
+  return true;
+}
+
+/* See cooked-index.h.  */
+
+const char *
 cooked_index_shard::handle_gnat_encoded_entry (cooked_index_entry *entry,
 					       htab_t gnat_entries)
 {
-  std::string canonical = ada_decode (entry->name, false, false);
-  if (canonical.empty ())
-    return {};
-  std::vector<gdb::string_view> names = split_name (canonical.c_str (),
+  /* Decoding is pure, and distinct entries frequently share a name,
+     so the decoded forms are interned in a table shared by all
+     shards.  This also gives them a lifetime that lets the tail
+     returned below be used as a canonical name directly.  */
+  const char *canonical = ada_decode_intern (entry->name);
+  if (*canonical == '\0')
+    return nullptr;
+  std::vector<gdb::string_view> names = split_name (canonical,
 						    split_style::DOT_STYLE);
   gdb::string_view tail = names.back ();
   names.pop_back ();
@@ -296,7 +417,9 @@ cooked_index_shard::handle_gnat_encoded_entry (cooked_index_entry *entry,
     }
 
   entry->parent_entry = parent;
-  return make_unique_xstrndup (tail.data (), tail.length ());
+  /* The last component extends to the end of the interned name, so it
+     is already NUL-terminated.  */
+  return tail.data ();
 }
 
 /* See cooked-index.h.  */
@@ -350,15 +473,12 @@ cooked_index_shard::do_finalize ()
 	entry->canonical = entry->name;
       else if (entry->per_cu->lang () == language_ada)
 	{
-	  gdb::unique_xmalloc_ptr<char> canon_name
+	  const char *canon_name
 	    = handle_gnat_encoded_entry (entry, gnat_entries.get ());
 	  if (canon_name == nullptr)
 	    entry->canonical = entry->name;
 	  else
-	    {
-	      entry->canonical = canon_name.get ();
-	      m_names.push_back (std::move (canon_name));
-	    }
+	    entry->canonical = canon_name;
 	}
       else if (entry->per_cu->lang () == language_cplus
 	       || entry->per_cu->lang () == language_c)
@@ -398,6 +518,8 @@ cooked_index_shard::do_finalize ()
 	     {
 	       return *a < *b;
 	     });
+
+  build_name_filter ();
 }
 
 /* See cooked-index.h.  */
@@ -411,6 +533,14 @@ cooked_index_shard::find (const std::string &name, bool completing) const
 					      ? cooked_index_entry::COMPLETE
 					      : cooked_index_entry::MATCH);
 
+  /* For an exact-match lookup, the name filter can reject the common
+     case -- a name that appears in no entry -- with a single probe.
+     It does not apply to completion, which matches by prefix.  */
+  if (!completing
+      && !m_name_filter.empty ()
+      && !name_filter_may_contain (name.c_str ()))
+    return range (m_entries.cend (), m_entries.cend ());
+
   auto lower = std::lower_bound (m_entries.cbegin (), m_entries.cend (), name,
 				 [=] (const cooked_index_entry *entry,
 				      const std::string &n)
@@ -443,11 +573,12 @@ cooked_index_shard::wait (bool allow_quit) const
     m_future.wait ();
 }
 
-cooked_index::cooked_index (vec_type &&vec)
+cooked_index::cooked_index (vec_type &&vec, bool already_finalized)
   : m_vector (std::move (vec))
 {
-  for (auto &idx : m_vector)
-    idx->finalize ();
+  if (!already_finalized)
+    for (auto &idx : m_vector)
+      idx->finalize ();
 
   /* ACTIVE_VECTORS is not locked, and this assert ensures that this
      will be caught if ever moved to the background.  */
@@ -646,7 +777,497 @@ cooked_index::maybe_write_index (dwarf2_per_bfd *per_bfd,
   wait ();
 
   /* (maybe) store an index in the cache.  */
-  global_index_cache.store (per_bfd, ctx);
+  global_index_cache.store (per_bfd, ctx, this);
+}
+
+/* The structures below describe the serialized form of a cooked
+   index, as written by cooked_index::write_cache_file.  The format is
+   host-specific -- the cache directory is private to one machine --
+   so scalars are stored in native byte order; the "endianness" field
+   catches accidental sharing.  The layout is:
+
+     cooked_index_cache_header
+     cooked_index_cache_unit[n_units]
+     for each shard:
+       cooked_index_cache_shard
+       cooked_index_cache_transition[n_transitions]
+       cooked_index_cache_entry[n_entries + n_extra_entries]
+     string table
+
+   Entries are numbered globally in file order; parent and "main"
+   references use these numbers.  The "extra" entries of a shard are
+   entries that act only as parents (e.g., the synthesized Ada package
+   entries) and are not part of the sorted lookup array.  */
+
+/* Value of the header's "endianness" field on this host.  */
+#define COOKED_INDEX_CACHE_ENDIAN 0x01020304u
+
+/* Current version of the format.  */
+#define COOKED_INDEX_CACHE_VERSION 1
+
+/* Header of a serialized cooked index.  */
+
+struct cooked_index_cache_header
+{
+  /* Must be COOKED_INDEX_CACHE_MAGIC.  */
+  char magic[8];
+  /* Must be COOKED_INDEX_CACHE_VERSION.  */
+  uint32_t version;
+  /* Must be COOKED_INDEX_CACHE_ENDIAN.  */
+  uint32_t endianness;
+  /* Number of units in the CU/TU list when the index was written.
+     The index is only valid for an identical list.  */
+  uint64_t n_units;
+  /* String table offset of the dwz file's build id, or 0 if there is
+     no dwz file.  */
+  uint64_t dwz_build_id;
+  /* Number of shards.  */
+  uint32_t n_shards;
+  uint32_t pad;
+  /* Offset and size of the string table.  */
+  uint64_t strtab_offset;
+  uint64_t strtab_size;
+};
+
+/* Expected value of cooked_index_cache_header::magic.  */
+static const char cooked_index_cache_magic[8] = "GDBCIDX";
+
+/* Per-unit data.  This preserves the language and unit type that the
+   indexer recorded on each dwarf2_per_cu_data.  */
+
+struct cooked_index_cache_unit
+{
+  /* The DW_UT_* constant, or 0 if never set.  */
+  uint8_t unit_type;
+  /* The gdb language constant, or language_unknown if never set.  */
+  uint8_t lang;
+};
+
+/* Header of one serialized shard.  */
+
+struct cooked_index_cache_shard
+{
+  /* Number of entries in the sorted lookup array.  */
+  uint64_t n_entries;
+  /* Number of trailing parent-only entries.  */
+  uint64_t n_extra_entries;
+  /* Global number of the "main" entry, or ~0.  */
+  uint64_t main_entry;
+  /* Number of addrmap transitions.  */
+  uint64_t n_transitions;
+};
+
+/* One transition of a shard's address map.  */
+
+struct cooked_index_cache_transition
+{
+  /* The address at which the value changes.  */
+  uint64_t addr;
+  /* The index of the new CU in the unit list, or ~0 for no value.  */
+  uint64_t per_cu_index;
+};
+
+/* One serialized index entry.  */
+
+struct cooked_index_cache_entry
+{
+  /* The DIE offset.  */
+  uint64_t die_offset;
+  /* The index of the CU in the unit list.  */
+  uint32_t per_cu_index;
+  /* Global number of the parent entry, or ~0.  */
+  uint32_t parent;
+  /* String table offsets of the name and canonical name.  */
+  uint32_t name;
+  uint32_t canonical;
+  /* The DWARF tag.  */
+  uint16_t tag;
+  /* The cooked_index_flag values.  */
+  uint8_t flags;
+  uint8_t pad[5];
+};
+
+/* A helper that accumulates the serialized form of an index.  */
+
+class cooked_index_cache_builder
+{
+public:
+  cooked_index_cache_builder ()
+  {
+    /* Reserve offset 0 so that it can mean "no string".  */
+    m_strtab += '\0';
+  }
+
+  /* Append the bytes of OBJ to the body.  */
+  template<typename T>
+  void append (const T &obj)
+  {
+    const gdb_byte *bytes = (const gdb_byte *) &obj;
+    m_body.insert (m_body.end (), bytes, bytes + sizeof (T));
+  }
+
+  /* Intern STR in the string table and return its offset.  */
+  uint32_t intern (const char *str)
+  {
+    if (str == nullptr)
+      return 0;
+    auto it = m_offsets.find (str);
+    if (it != m_offsets.end ())
+      return it->second;
+    uint32_t result = (uint32_t) m_strtab.size ();
+    m_strtab.append (str, strlen (str) + 1);
+    m_offsets.emplace (str, result);
+    return result;
+  }
+
+  /* Write the completed index to FILE.  HDR is filled in and written
+     first, followed by the body and the string table.  */
+  void write (FILE *file, cooked_index_cache_header *hdr) const
+  {
+    hdr->strtab_offset = sizeof (*hdr) + m_body.size ();
+    hdr->strtab_size = m_strtab.size ();
+
+    file_write (file, hdr, sizeof (*hdr));
+    file_write (file, m_body.data (), m_body.size ());
+    file_write (file, m_strtab.data (), m_strtab.size ());
+  }
+
+private:
+
+  /* Write SIZE bytes at DATA to FILE, throwing on error.  */
+  static void file_write (FILE *file, const void *data, size_t size)
+  {
+    if (size > 0 && fwrite (data, 1, size, file) != size)
+      error (_("couldn't write to index cache file"));
+  }
+
+  /* The body: everything between the header and the string table.  */
+  std::vector<gdb_byte> m_body;
+  /* The string table.  */
+  std::string m_strtab;
+  /* Map from interned string to its offset in m_strtab.  */
+  std::unordered_map<std::string, uint32_t> m_offsets;
+};
+
+/* See cooked-index.h.  */
+
+void
+cooked_index::write_cache_file (const char *filename,
+				const char *dwz_build_id_str,
+				dwarf2_per_bfd *per_bfd) const
+{
+  /* The entries must be in their final, sorted form.  */
+  wait ();
+
+  cooked_index_cache_builder builder;
+
+  /* Number all the entries, in file order.  Parent entries that are
+     not in any m_entries vector (see handle_gnat_encoded_entry) are
+     collected as "extra" entries of the shard that first references
+     them.  */
+  std::unordered_map<const cooked_index_entry *, uint64_t> numbers;
+  std::vector<std::vector<const cooked_index_entry *>> extras
+    (m_vector.size ());
+  uint64_t next_number = 0;
+  uint64_t n_units = per_bfd->all_units.size ();
+
+  for (size_t i = 0; i < m_vector.size (); ++i)
+    {
+      const cooked_index_shard &shard = *m_vector[i];
+      for (const cooked_index_entry *entry : shard.m_entries)
+	numbers.emplace (entry, next_number++);
+      for (const cooked_index_entry *entry : shard.m_entries)
+	for (const cooked_index_entry *parent = entry->parent_entry;
+	     parent != nullptr;
+	     parent = parent->parent_entry)
+	  {
+	    if (!numbers.emplace (parent, next_number).second)
+	      break;
+	    ++next_number;
+	    extras[i].push_back (parent);
+	  }
+    }
+
+  /* Emit the unit types and languages.  */
+  std::vector<cooked_index_cache_unit> units (n_units);
+  for (auto &unit : units)
+    {
+      unit.unit_type = 0;
+      unit.lang = language_unknown;
+    }
+  for (const auto &item : numbers)
+    {
+      const dwarf2_per_cu_data *per_cu = item.first->per_cu;
+      units[per_cu->index].unit_type = (uint8_t) per_cu->unit_type (false);
+      units[per_cu->index].lang = (uint8_t) per_cu->lang (false);
+    }
+  for (const auto &unit : units)
+    builder.append (unit);
+
+  /* Emit each shard.  */
+  for (size_t i = 0; i < m_vector.size (); ++i)
+    {
+      const cooked_index_shard &shard = *m_vector[i];
+
+      /* Flatten the addrmap into transitions.  */
+      std::vector<cooked_index_cache_transition> transitions;
+      if (shard.m_addrmap != nullptr)
+	shard.m_addrmap->foreach ([&] (CORE_ADDR start_addr, const void *obj)
+	  {
+	    const dwarf2_per_cu_data *per_cu
+	      = static_cast<const dwarf2_per_cu_data *> (obj);
+	    cooked_index_cache_transition transition;
+	    transition.addr = start_addr;
+	    transition.per_cu_index = (per_cu == nullptr
+				       ? ~(uint64_t) 0
+				       : per_cu->index);
+	    transitions.push_back (transition);
+	    return 0;
+	  });
+
+      cooked_index_cache_shard shard_hdr;
+      shard_hdr.n_entries = shard.m_entries.size ();
+      shard_hdr.n_extra_entries = extras[i].size ();
+      shard_hdr.main_entry = (shard.m_main == nullptr
+			      ? ~(uint64_t) 0
+			      : numbers[shard.m_main]);
+      shard_hdr.n_transitions = transitions.size ();
+      builder.append (shard_hdr);
+
+      for (const auto &transition : transitions)
+	builder.append (transition);
+
+      auto emit_entry = [&] (const cooked_index_entry *entry)
+	{
+	  cooked_index_cache_entry e;
+	  memset (&e, 0, sizeof (e));
+	  e.die_offset = to_underlying (entry->die_offset);
+	  e.per_cu_index = entry->per_cu->index;
+	  e.parent = (entry->parent_entry == nullptr
+		      ? ~(uint32_t) 0
+		      : (uint32_t) numbers[entry->parent_entry]);
+	  e.name = builder.intern (entry->name);
+	  e.canonical = builder.intern (entry->canonical);
+	  e.tag = (uint16_t) entry->tag;
+	  e.flags = (uint8_t) (unsigned char) entry->flags;
+	  builder.append (e);
+	};
+
+      for (const cooked_index_entry *entry : shard.m_entries)
+	emit_entry (entry);
+      for (const cooked_index_entry *entry : extras[i])
+	emit_entry (entry);
+    }
+
+  cooked_index_cache_header hdr;
+  memset (&hdr, 0, sizeof (hdr));
+  memcpy (hdr.magic, cooked_index_cache_magic, sizeof (hdr.magic));
+  hdr.version = COOKED_INDEX_CACHE_VERSION;
+  hdr.endianness = COOKED_INDEX_CACHE_ENDIAN;
+  hdr.n_units = n_units;
+  hdr.dwz_build_id = builder.intern (dwz_build_id_str);
+  hdr.n_shards = m_vector.size ();
+
+  /* Write to a temporary file first, so that a partial write can
+     never be mistaken for a valid cache file.  */
+  gdb::char_vector filename_temp = make_temp_filename (filename);
+  scoped_fd out_file_fd = gdb_mkostemp_cloexec (filename_temp.data (),
+						O_BINARY);
+  if (out_file_fd.get () == -1)
+    perror_with_name (("mkstemp"));
+  gdb_file_up out_file = out_file_fd.to_file ("wb");
+  if (out_file == nullptr)
+    error (_("Can't open `%s' for writing"), filename_temp.data ());
+  gdb::unlinker unlink_file (filename_temp.data ());
+
+  builder.write (out_file.get (), &hdr);
+
+  /* Close before renaming; on MS-Windows one cannot rename an open
+     file.  */
+  out_file.reset ();
+  if (rename (filename_temp.data (), filename) != 0)
+    perror_with_name (("rename"));
+  unlink_file.keep ();
+}
+
+/* See cooked-index.h.  */
+
+std::unique_ptr<cooked_index>
+cooked_index::read_cache (dwarf2_per_objfile *per_objfile,
+			  gdb::array_view<const gdb_byte> contents)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  const gdb_byte *data = contents.data ();
+  size_t size = contents.size ();
+  size_t offset = 0;
+
+  /* Consume an object of type T from the contents, returning false if
+     the file is truncated.  */
+  auto extract = [&] (auto *obj) -> bool
+    {
+      if (size - offset < sizeof (*obj) || offset > size)
+	return false;
+      memcpy (obj, data + offset, sizeof (*obj));
+      offset += sizeof (*obj);
+      return true;
+    };
+
+  cooked_index_cache_header hdr;
+  if (!extract (&hdr)
+      || memcmp (hdr.magic, cooked_index_cache_magic,
+		 sizeof (hdr.magic)) != 0
+      || hdr.version != COOKED_INDEX_CACHE_VERSION
+      || hdr.endianness != COOKED_INDEX_CACHE_ENDIAN)
+    return nullptr;
+
+  /* Validate the string table.  Every string reference below is
+     checked against STRTAB_SIZE, and the final NUL guarantees that
+     all of them are terminated within the table.  */
+  if (hdr.strtab_offset > size
+      || hdr.strtab_size > size - hdr.strtab_offset
+      || hdr.strtab_size == 0)
+    return nullptr;
+  const char *strtab = (const char *) data + hdr.strtab_offset;
+  size_t strtab_size = hdr.strtab_size;
+  if (strtab[strtab_size - 1] != '\0')
+    return nullptr;
+
+  auto get_string = [&] (uint64_t str_offset) -> const char *
+    {
+      if (str_offset == 0 || str_offset >= strtab_size)
+	return nullptr;
+      return strtab + str_offset;
+    };
+
+  /* The index is only valid for the exact CU/TU list it was created
+     from.  */
+  if (hdr.n_units != per_bfd->all_units.size ())
+    return nullptr;
+
+  /* Check that the dwz situation matches.  */
+  const char *stored_dwz_id = get_string (hdr.dwz_build_id);
+  const dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+  if ((dwz != nullptr) != (stored_dwz_id != nullptr))
+    return nullptr;
+  if (dwz != nullptr)
+    {
+      const bfd_build_id *dwz_build_id
+	= build_id_bfd_get (dwz->dwz_bfd.get ());
+      if (dwz_build_id == nullptr
+	  || build_id_to_string (dwz_build_id) != stored_dwz_id)
+	return nullptr;
+    }
+
+  /* Restore the per-unit language and unit type.  */
+  for (uint64_t i = 0; i < hdr.n_units; ++i)
+    {
+      cooked_index_cache_unit unit;
+      if (!extract (&unit))
+	return nullptr;
+      dwarf2_per_cu_data *per_cu = per_bfd->all_units[i].get ();
+      if (unit.unit_type != 0)
+	{
+	  per_cu->set_unit_type ((dwarf_unit_type) unit.unit_type);
+	  if (unit.lang != language_unknown)
+	    per_cu->set_lang ((enum language) unit.lang);
+	}
+    }
+
+  /* Recreate the shards.  Parent and "main" references are recorded
+     first and resolved once all entries exist.  */
+  vec_type shards;
+  std::vector<cooked_index_entry *> all;
+  std::vector<uint64_t> parent_ids;
+  std::vector<std::pair<cooked_index_shard *, uint64_t>> mains;
+
+  for (uint32_t i = 0; i < hdr.n_shards; ++i)
+    {
+      cooked_index_cache_shard shard_hdr;
+      if (!extract (&shard_hdr))
+	return nullptr;
+
+      auto shard = std::unique_ptr<cooked_index_shard>
+	(new cooked_index_shard);
+
+      /* Rebuild the address map.  */
+      addrmap_mutable mutable_map;
+      cooked_index_cache_transition transition, next;
+      for (uint64_t j = 0; j < shard_hdr.n_transitions; ++j)
+	{
+	  if (j == 0 && !extract (&transition))
+	    return nullptr;
+	  bool has_next = j + 1 < shard_hdr.n_transitions;
+	  if (has_next && !extract (&next))
+	    return nullptr;
+	  if (transition.per_cu_index != ~(uint64_t) 0)
+	    {
+	      if (transition.per_cu_index >= hdr.n_units)
+		return nullptr;
+	      CORE_ADDR end = (has_next
+			       ? (CORE_ADDR) next.addr - 1
+			       : (CORE_ADDR) -1);
+	      mutable_map.set_empty
+		((CORE_ADDR) transition.addr, end,
+		 per_bfd->all_units[transition.per_cu_index].get ());
+	    }
+	  if (has_next)
+	    transition = next;
+	}
+      shard->install_addrmap (&mutable_map);
+
+      uint64_t n_total = shard_hdr.n_entries + shard_hdr.n_extra_entries;
+      for (uint64_t j = 0; j < n_total; ++j)
+	{
+	  cooked_index_cache_entry e;
+	  if (!extract (&e))
+	    return nullptr;
+	  if (e.per_cu_index >= hdr.n_units)
+	    return nullptr;
+	  const char *name = get_string (e.name);
+	  const char *canonical = get_string (e.canonical);
+	  if (name == nullptr || canonical == nullptr)
+	    return nullptr;
+
+	  cooked_index_entry *entry
+	    = shard->create ((sect_offset) e.die_offset,
+			     (enum dwarf_tag) e.tag,
+			     (enum cooked_index_flag_enum) e.flags,
+			     name, nullptr,
+			     per_bfd->all_units[e.per_cu_index].get ());
+	  entry->canonical = canonical;
+	  if (j < shard_hdr.n_entries)
+	    shard->m_entries.push_back (entry);
+	  all.push_back (entry);
+	  parent_ids.push_back (e.parent == ~(uint32_t) 0
+				? ~(uint64_t) 0
+				: e.parent);
+	}
+
+      if (shard_hdr.main_entry != ~(uint64_t) 0)
+	mains.emplace_back (shard.get (), shard_hdr.main_entry);
+
+      shard->mark_finalized ();
+      shards.push_back (std::move (shard));
+    }
+
+  /* Resolve parent and "main" references.  */
+  for (size_t i = 0; i < all.size (); ++i)
+    {
+      if (parent_ids[i] == ~(uint64_t) 0)
+	continue;
+      if (parent_ids[i] >= all.size ())
+	return nullptr;
+      all[i]->parent_entry = all[parent_ids[i]];
+    }
+  for (const auto &item : mains)
+    {
+      if (item.second >= all.size ())
+	return nullptr;
+      item.first->m_main = all[item.second];
+    }
+
+  return std::unique_ptr<cooked_index>
+    (new cooked_index (std::move (shards), true));
 }
 
 /* Wait for all the index cache entries to be written before gdb
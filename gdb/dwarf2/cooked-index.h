@@ -37,6 +37,7 @@
 
 struct dwarf2_per_cu_data;
 struct dwarf2_per_bfd;
+struct dwarf2_per_objfile;
 struct index_cache_store_context;
 
 /* Flags that describe an entry in the index.  */
@@ -274,6 +275,12 @@ public:
      into the internal table.  */
   void finalize ();
 
+  /* Mark this index as already finalized.  This is used when the
+     entries were deserialized from the index cache, where they are
+     stored post-finalization: canonical names are filled in and the
+     entries are already sorted.  */
+  void mark_finalized ();
+
   /* Wait for this index's finalization to be complete.  */
   void wait (bool allow_quit = true) const;
 
@@ -330,13 +337,24 @@ private:
      not emit the module structure.  However, we need this structure
      to do lookups.  This function recreates that structure for an
      existing entry.  It returns the base name (last element) of the
-     full decoded name.  */
-  gdb::unique_xmalloc_ptr<char> handle_gnat_encoded_entry
+     full decoded name, a pointer into the session-lifetime interned
+     copy of the decoded name, or NULL if the name could not be
+     decoded.  */
+  const char *handle_gnat_encoded_entry
        (cooked_index_entry *entry, htab_t gnat_entries);
 
   /* A helper method that does the work of 'finalize'.  */
   void do_finalize ();
 
+  /* Build the name filter over the (canonicalized) entries.  Called
+     at the end of finalization.  */
+  void build_name_filter ();
+
+  /* Return false if NAME definitely has no matching entry in this
+     shard, true if it might.  Only valid for MATCH-mode lookups, and
+     only once the filter has been built.  */
+  bool name_filter_may_contain (const char *name) const;
+
   /* Storage for the entries.  */
   auto_obstack m_storage;
   /* List of all entries.  */
@@ -348,6 +366,11 @@ private:
   addrmap *m_addrmap = nullptr;
   /* Storage for canonical names.  */
   std::vector<gdb::unique_xmalloc_ptr<char>> m_names;
+  /* A blocked Bloom filter over the names in this shard, used to
+     reject failed lookups without binary searching M_ENTRIES.  Each
+     name sets a few bits within a single cache-line-sized block.
+     Empty when the shard is too small to bother.  */
+  std::vector<uint64_t> m_name_filter;
   /* A future that tracks when the 'finalize' method is done.  Note
      that the 'get' method is never called on this future, only
      'wait'.  */
@@ -367,10 +390,36 @@ public:
      object.  */
   using vec_type = std::vector<std::unique_ptr<cooked_index_shard>>;
 
-  explicit cooked_index (vec_type &&vec);
+  /* If ALREADY_FINALIZED is true, the shards in VEC were deserialized
+     from the index cache in their finalized form, and no finalization
+     pass is started.  */
+  explicit cooked_index (vec_type &&vec, bool already_finalized = false);
   ~cooked_index () override;
   DISABLE_COPY_AND_ASSIGN (cooked_index);
 
+  /* Serialize this index to a flat, memory-mappable file named
+     FILENAME.  The file stores the shards in their final sorted
+     layout, so that reloading it only requires pointer fixups and not
+     a new DWARF scan.  DWZ_BUILD_ID_STR is the build id of the
+     associated dwz file, or nullptr if there is none; it is recorded
+     so that a stale cache file can be detected on load.  This waits
+     for finalization to complete.  PER_BFD supplies the CU/TU list
+     that the serialized CU references are relative to.  */
+  void write_cache_file (const char *filename,
+			 const char *dwz_build_id_str,
+			 dwarf2_per_bfd *per_bfd) const;
+
+  /* Recreate a cooked index from CONTENTS, the memory-mapped contents
+     of a file previously written by write_cache_file.  CONTENTS must
+     remain valid for the lifetime of the result; name strings in the
+     returned index point directly into it.  PER_OBJFILE is used to
+     map serialized CU indices back to dwarf2_per_cu_data objects, so
+     the CU list must have been created already.  Returns nullptr if
+     CONTENTS is invalid or does not match the current CU list.  */
+  static std::unique_ptr<cooked_index>
+    read_cache (dwarf2_per_objfile *per_objfile,
+		gdb::array_view<const gdb_byte> contents);
+
   /* Wait until the finalization of the entire cooked_index is
      done.  */
   void wait () const
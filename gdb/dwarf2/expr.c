@@ -1487,6 +1487,20 @@ dwarf_block_to_sp_offset (struct gdbarch *gdbarch, const gdb_byte *buf,
   return 1;
 }
 
+/* Cache of the most recently computed frame base, for DW_OP_fbreg.
+   Every variable with a frame-relative location re-evaluates the
+   function's DW_AT_frame_base expression, so commands such as "info
+   locals" compute the very same base once per variable.  The frame
+   base is a function of the frame alone, so one cached entry, keyed
+   by frame id and validated against the frame cache generation
+   (which is bumped whenever frames are invalidated), is enough to
+   cover them.  */
+
+static bool frame_base_cache_valid = false;
+static unsigned int frame_base_cache_generation;
+static frame_id frame_base_cache_id;
+static CORE_ADDR frame_base_cache_base;
+
 /* The engine for the expression evaluator.  Using the context in this
    object, evaluate the expression between OP_PTR and OP_END.  */
 
@@ -1809,33 +1823,52 @@ dwarf_expr_context::execute_stack_op (const gdb_byte *op_ptr,
 
 	    op_ptr = safe_read_sleb128 (op_ptr, op_end, &offset);
 
-	    /* Rather than create a whole new context, we simply
-	       backup the current stack locally and install a new empty stack,
-	       then reset it afterwards, effectively erasing whatever the
-	       recursive call put there.  */
-	    std::vector<dwarf_stack_value> saved_stack = std::move (this->m_stack);
-	    this->m_stack.clear ();
-
-	    /* FIXME: cagney/2003-03-26: This code should be using
-	       get_frame_base_address(), and then implement a dwarf2
-	       specific this_base method.  */
-	    this->get_frame_base (&datastart, &datalen);
-	    eval (datastart, datalen);
-	    if (this->m_location == DWARF_VALUE_MEMORY)
-	      result = fetch_address (0);
-	    else if (this->m_location == DWARF_VALUE_REGISTER)
-	      result
-		= read_addr_from_reg (this->m_frame, value_as_long (fetch (0)));
+	    ensure_have_frame (this->m_frame, "DW_OP_fbreg");
+
+	    unsigned int generation = get_frame_cache_generation ();
+	    frame_id fid = get_frame_id (this->m_frame);
+
+	    if (frame_base_cache_valid
+		&& frame_base_cache_generation == generation
+		&& frame_base_cache_id == fid)
+	      result = frame_base_cache_base;
 	    else
-	      error (_("Not implemented: computing frame "
-		       "base using explicit value operator"));
+	      {
+		/* Rather than create a whole new context, we simply
+		   backup the current stack locally and install a new empty
+		   stack, then reset it afterwards, effectively erasing
+		   whatever the recursive call put there.  */
+		std::vector<dwarf_stack_value> saved_stack
+		  = std::move (this->m_stack);
+		this->m_stack.clear ();
+
+		/* FIXME: cagney/2003-03-26: This code should be using
+		   get_frame_base_address(), and then implement a dwarf2
+		   specific this_base method.  */
+		this->get_frame_base (&datastart, &datalen);
+		eval (datastart, datalen);
+		if (this->m_location == DWARF_VALUE_MEMORY)
+		  result = fetch_address (0);
+		else if (this->m_location == DWARF_VALUE_REGISTER)
+		  result = read_addr_from_reg (this->m_frame,
+					       value_as_long (fetch (0)));
+		else
+		  error (_("Not implemented: computing frame "
+			   "base using explicit value operator"));
+
+		/* Restore the content of the original stack.  */
+		this->m_stack = std::move (saved_stack);
+
+		frame_base_cache_generation = generation;
+		frame_base_cache_id = fid;
+		frame_base_cache_base = result;
+		frame_base_cache_valid = true;
+	      }
+
 	    result = result + offset;
 	    result_val = value_from_ulongest (address_type, result);
 	    in_stack_memory = true;
 
-	    /* Restore the content of the original stack.  */
-	    this->m_stack = std::move (saved_stack);
-
 	    this->m_location = DWARF_VALUE_MEMORY;
 	  }
 	  break;
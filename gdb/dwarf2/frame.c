@@ -838,6 +838,164 @@ dwarf2_fetch_cfa_info (struct gdbarch *gdbarch, CORE_ADDR pc,
 }
 
 
+/* A memoized unwind row: everything that executing the CIE and FDE
+   programs up to some PC produces, shorn of per-frame state.  The
+   register rules, CFA rule and return address column stored here
+   depend only on the (immutable) CFI, the architecture and the entry
+   PC, so a row computed for one frame can be reused by every other
+   frame stopped at the same PC, across threads and stops.  */
+
+struct dwarf2_frame_row
+{
+  /* The architecture the row was computed for.  Register-number
+     adjustment and vendor CFI ops are per-arch, so a row computed for
+     one architecture cannot be reused for another.  A null value
+     marks a row that was never (completely) computed.  */
+  struct gdbarch *gdbarch = nullptr;
+
+  /* The unrelocated entry PC that ENTRY_CFA_SP_OFFSET below was
+     computed against, and whether one was known at all.  */
+  ULONGEST entry_pc = 0;
+  int entry_pc_p = 0;
+
+  /* Register rules in effect at the row's PC.  The
+     DW_CFA_remember_state stack is not retained; it only matters
+     while the FDE program runs.  */
+  struct dwarf2_frame_state_reg_info regs;
+
+  /* Return address column from the CIE.  */
+  ULONGEST retaddr_column = 0;
+
+  /* The CFA offset from the stack pointer at function entry, needed
+     by the tail call sniffer.  Only valid if ENTRY_CFA_SP_OFFSET_P.  */
+  LONGEST entry_cfa_sp_offset = 0;
+  int entry_cfa_sp_offset_p = 0;
+
+  /* Producer quirk, see dwarf2_frame_state.  */
+  bool armcc_cfa_offsets_reversed = false;
+};
+
+/* The rows memoized for one objfile, keyed by unrelocated PC.  Kept
+   per-objfile (rather than on the possibly shared comp_unit) so that
+   the expression pointers in the rules can never outlive the section
+   data they point into.  */
+
+struct dwarf2_frame_row_cache
+{
+  std::unordered_map<ULONGEST, dwarf2_frame_row> rows;
+};
+
+static const registry<objfile>::key<dwarf2_frame_row_cache>
+  dwarf2_frame_row_cache_data;
+
+/* Execute the CIE and FDE programs for PC and fill *ROW with the
+   resulting rules.  FDE is PC's FDE, FDE_PC is the relocated initial
+   location that dwarf2_frame_find_fde returned for it, and
+   TEXT_OFFSET is the owning objfile's text section offset.  If
+   ENTRY_PC_P, ENTRY_PC is the function's entry point, used to compute
+   the entry CFA offset.  ROW's cache key fields are left alone.  */
+
+static void
+dwarf2_frame_compute_row (struct dwarf2_fde *fde, struct gdbarch *gdbarch,
+			  CORE_ADDR pc, CORE_ADDR fde_pc,
+			  CORE_ADDR text_offset,
+			  CORE_ADDR entry_pc, int entry_pc_p,
+			  struct dwarf2_frame_row *row)
+{
+  const gdb_byte *instr;
+
+  /* Allocate and initialize the frame state.  */
+  struct dwarf2_frame_state fs (fde_pc, fde->cie);
+
+  /* Check for "quirks" - known bugs in producers.  */
+  dwarf2_frame_find_quirks (&fs, fde);
+
+  /* First decode all the insns in the CIE.  */
+  execute_cfa_program (fde, fde->cie->initial_instructions,
+		       fde->cie->end, gdbarch, pc, &fs, text_offset);
+
+  /* Save the initialized register set.  */
+  fs.initial = fs.regs;
+
+  /* The entry PC won't necessarily be within the range of FDE
+     locations, due to the possibility of the function occupying
+     non-contiguous ranges.  */
+  row->entry_cfa_sp_offset_p = 0;
+  if (entry_pc_p
+      && fde->initial_location <= (unrelocated_addr) (entry_pc - text_offset)
+      && (unrelocated_addr) (entry_pc - text_offset) < fde->end_addr ())
+    {
+      /* Decode the insns in the FDE up to the entry PC.  */
+      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
+				   entry_pc, &fs, text_offset);
+
+      if (fs.regs.cfa_how == CFA_REG_OFFSET
+	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
+	      == gdbarch_sp_regnum (gdbarch)))
+	{
+	  row->entry_cfa_sp_offset = fs.regs.cfa_offset;
+	  row->entry_cfa_sp_offset_p = 1;
+	}
+    }
+  else
+    instr = fde->instructions;
+
+  /* Then decode the insns in the FDE up to our target PC.  */
+  execute_cfa_program (fde, instr, fde->end, gdbarch, pc, &fs, text_offset);
+
+  row->regs = fs.regs;
+  /* The copy above aliased FS's remember/restore stack; FS keeps
+     ownership of it.  */
+  row->regs.prev = nullptr;
+  row->retaddr_column = fs.retaddr_column;
+  row->armcc_cfa_offsets_reversed = fs.armcc_cfa_offsets_reversed;
+}
+
+/* Return the unwind row for PC, computing and memoizing it if it
+   isn't cached yet.  OBJFILE is the objfile whose CFI FDE describes;
+   the remaining arguments are as for dwarf2_frame_compute_row.  The
+   returned row is owned by OBJFILE's cache and is valid until the
+   objfile is destroyed or the row is recomputed for a different
+   architecture or entry PC.  */
+
+static const struct dwarf2_frame_row *
+dwarf2_frame_get_row (struct objfile *objfile, struct dwarf2_fde *fde,
+		      struct gdbarch *gdbarch, CORE_ADDR pc,
+		      CORE_ADDR fde_pc, CORE_ADDR text_offset,
+		      CORE_ADDR entry_pc, int entry_pc_p)
+{
+  dwarf2_frame_row_cache *cache = dwarf2_frame_row_cache_data.get (objfile);
+  if (cache == nullptr)
+    cache = dwarf2_frame_row_cache_data.emplace (objfile);
+
+  /* Key on unrelocated addresses so that relocating the objfile
+     cannot invalidate the cache; the rules themselves contain no
+     relocated addresses.  */
+  ULONGEST key = pc - text_offset;
+  ULONGEST entry_key = entry_pc_p ? entry_pc - text_offset : 0;
+
+  auto it = cache->rows.find (key);
+  if (it != cache->rows.end ()
+      && it->second.gdbarch == gdbarch
+      && it->second.entry_pc == entry_key
+      && it->second.entry_pc_p == entry_pc_p)
+    return &it->second;
+
+  /* Compute into a local first: dwarf2_frame_find_quirks can expand
+     symtabs, and an error thrown mid-computation must not leave a
+     half-written row behind looking valid.  */
+  dwarf2_frame_row row;
+  dwarf2_frame_compute_row (fde, gdbarch, pc, fde_pc, text_offset,
+			    entry_pc, entry_pc_p, &row);
+  row.gdbarch = gdbarch;
+  row.entry_pc = entry_key;
+  row.entry_pc_p = entry_pc_p;
+
+  dwarf2_frame_row &slot = cache->rows[key];
+  slot = std::move (row);
+  return &slot;
+}
+
 /* Custom function data object for architecture specific prev_register
    implementation.  Main purpose of this object is to allow caching of
    expensive data lookups in the prev_register handling.  */
@@ -896,8 +1054,7 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
   const int num_regs = gdbarch_num_cooked_regs (gdbarch);
   struct dwarf2_frame_cache *cache;
   struct dwarf2_fde *fde;
-  CORE_ADDR entry_pc;
-  const gdb_byte *instr;
+  CORE_ADDR entry_pc = 0;
 
   if (*this_cache)
     return (struct dwarf2_frame_cache *) *this_cache;
@@ -931,69 +1088,35 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
 
   CORE_ADDR text_offset = cache->per_objfile->objfile->text_section_offset ();
 
-  /* Allocate and initialize the frame state.  */
-  struct dwarf2_frame_state fs (pc1, fde->cie);
-
   cache->addr_size = fde->cie->addr_size;
 
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (&fs, fde);
-
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       text_offset);
-
-  /* Save the initialized register set.  */
-  fs.initial = fs.regs;
-
-  /* Fetching the entry pc for THIS_FRAME won't necessarily result
-     in an address that's within the range of FDE locations.  This
-     is due to the possibility of the function occupying non-contiguous
-     ranges.  */
-  LONGEST entry_cfa_sp_offset;
-  int entry_cfa_sp_offset_p = 0;
-  if (get_frame_func_if_available (this_frame, &entry_pc)
-      && fde->initial_location <= (unrelocated_addr) (entry_pc - text_offset)
-      && (unrelocated_addr) (entry_pc - text_offset) < fde->end_addr ())
-    {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
-				   entry_pc, &fs, text_offset);
-
-      if (fs.regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
-	{
-	  entry_cfa_sp_offset = fs.regs.cfa_offset;
-	  entry_cfa_sp_offset_p = 1;
-	}
-    }
-  else
-    instr = fde->instructions;
+  int entry_pc_p = get_frame_func_if_available (this_frame, &entry_pc);
 
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       text_offset);
+  /* Look up (or compute) the unwind rules in effect at this PC.  The
+     FDE programs re-execute identically for every frame stopped at
+     the same spot, so the resulting row is shared across frames,
+     threads and stops.  */
+  const struct dwarf2_frame_row *row
+    = dwarf2_frame_get_row (cache->per_objfile->objfile, fde, gdbarch,
+			    get_frame_address_in_block (this_frame), pc1,
+			    text_offset, entry_pc, entry_pc_p);
 
   try
     {
       /* Calculate the CFA.  */
-      switch (fs.regs.cfa_how)
+      switch (row->regs.cfa_how)
 	{
 	case CFA_REG_OFFSET:
-	  cache->cfa = read_addr_from_reg (this_frame, fs.regs.cfa_reg);
-	  if (fs.armcc_cfa_offsets_reversed)
-	    cache->cfa -= fs.regs.cfa_offset;
+	  cache->cfa = read_addr_from_reg (this_frame, row->regs.cfa_reg);
+	  if (row->armcc_cfa_offsets_reversed)
+	    cache->cfa -= row->regs.cfa_offset;
 	  else
-	    cache->cfa += fs.regs.cfa_offset;
+	    cache->cfa += row->regs.cfa_offset;
 	  break;
 
 	case CFA_EXP:
 	  cache->cfa =
-	    execute_stack_op (fs.regs.cfa_exp, fs.regs.cfa_exp_len,
+	    execute_stack_op (row->regs.cfa_exp, row->regs.cfa_exp_len,
 			      cache->addr_size, this_frame, 0, 0,
 			      cache->per_objfile);
 	  break;
@@ -1028,7 +1151,7 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
   {
     int column;		/* CFI speak for "register number".  */
 
-    for (column = 0; column < fs.regs.reg.size (); column++)
+    for (column = 0; column < row->regs.reg.size (); column++)
       {
 	/* Use the GDB register number as the destination index.  */
 	int regnum = dwarf_reg_to_regnum (gdbarch, column);
@@ -1048,16 +1171,17 @@ dwarf2_frame_cache (frame_info_ptr this_frame, void **this_cache)
 	   problems when a debug info register falls outside of the
 	   table.  We need a way of iterating through all the valid
 	   DWARF2 register numbers.  */
-	if (fs.regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
+	if (row->regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	  {
 	    if (cache->reg[regnum].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	      complaint (_("\
 incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 			 gdbarch_register_name (gdbarch, regnum),
-			 paddress (gdbarch, fs.pc));
+			 paddress (gdbarch,
+				   get_frame_address_in_block (this_frame)));
 	  }
 	else
-	  cache->reg[regnum] = fs.regs.reg[column];
+	  cache->reg[regnum] = row->regs.reg[column];
       }
   }
 
@@ -1072,8 +1196,8 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	    || cache->reg[regnum].how == DWARF2_FRAME_REG_RA_OFFSET)
 	  {
 	    const std::vector<struct dwarf2_frame_state_reg> &regs
-	      = fs.regs.reg;
-	    ULONGEST retaddr_column = fs.retaddr_column;
+	      = row->regs.reg;
+	    ULONGEST retaddr_column = row->retaddr_column;
 
 	    /* It seems rather bizarre to specify an "empty" column as
 	       the return adress column.  However, this is exactly
@@ -1082,7 +1206,7 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	       register corresponding to the return address column.
 	       Incidentally, that's how we should treat a return
 	       address column specifying "same value" too.  */
-	    if (fs.retaddr_column < fs.regs.reg.size ()
+	    if (retaddr_column < regs.size ()
 		&& regs[retaddr_column].how != DWARF2_FRAME_REG_UNSPECIFIED
 		&& regs[retaddr_column].how != DWARF2_FRAME_REG_SAME_VALUE)
 	      {
@@ -1095,12 +1219,12 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	      {
 		if (cache->reg[regnum].how == DWARF2_FRAME_REG_RA)
 		  {
-		    cache->reg[regnum].loc.reg = fs.retaddr_column;
+		    cache->reg[regnum].loc.reg = retaddr_column;
 		    cache->reg[regnum].how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 		else
 		  {
-		    cache->retaddr_reg.loc.reg = fs.retaddr_column;
+		    cache->retaddr_reg.loc.reg = retaddr_column;
 		    cache->retaddr_reg.how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 	      }
@@ -1108,12 +1232,14 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
       }
   }
 
-  if (fs.retaddr_column < fs.regs.reg.size ()
-      && fs.regs.reg[fs.retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
+  if (row->retaddr_column < row->regs.reg.size ()
+      && (row->regs.reg[row->retaddr_column].how
+	  == DWARF2_FRAME_REG_UNDEFINED))
     cache->undefined_retaddr = 1;
 
+  LONGEST entry_cfa_sp_offset = row->entry_cfa_sp_offset;
   dwarf2_tailcall_sniffer_first (this_frame, &cache->tailcall_cache,
-				 (entry_cfa_sp_offset_p
+				 (row->entry_cfa_sp_offset_p
 				  ? &entry_cfa_sp_offset : NULL));
 
   return cache;
@@ -1346,7 +1472,11 @@ static const struct frame_unwind dwarf2_frame_unwind =
   dwarf2_frame_prev_register,
   NULL,
   dwarf2_frame_sniffer,
-  dwarf2_frame_dealloc_cache
+  dwarf2_frame_dealloc_cache,
+  NULL,
+  /* The sniffer only looks up the FDE covering the PC, so a rejection
+     holds for every frame at that PC.  */
+  true
 };
 
 static const struct frame_unwind dwarf2_signal_frame_unwind =
@@ -1360,7 +1490,11 @@ static const struct frame_unwind dwarf2_signal_frame_unwind =
   dwarf2_frame_sniffer,
 
   /* TAILCALL_CACHE can never be in such frame to need dealloc_cache.  */
-  NULL
+  NULL,
+  NULL,
+  /* As for dwarf2_frame_unwind: the sniffer depends on the PC
+     alone.  */
+  true
 };
 
 /* Append the DWARF-2 frame unwinders to GDBARCH's list.  */
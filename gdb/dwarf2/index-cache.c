@@ -24,6 +24,8 @@
 #include "cli/cli-cmds.h"
 #include "cli/cli-decode.h"
 #include "command.h"
+#include "dwarf2/cooked-index.h"
+#include "gdbsupport/filestuff.h"
 #include "gdbsupport/scoped_mmap.h"
 #include "gdbsupport/pathstuff.h"
 #include "dwarf2/index-write.h"
@@ -31,6 +33,7 @@
 #include "dwarf2/dwz.h"
 #include "objfiles.h"
 #include "gdbsupport/selftest.h"
+#include <sys/stat.h>
 #include <string>
 #include <stdlib.h>
 
@@ -44,6 +47,34 @@ static bool debug_index_cache = false;
 /* The index cache directory, used for "set/show index-cache directory".  */
 static std::string index_cache_directory;
 
+/* File name suffix used for the serialized cooked index format.  */
+#define COOKED_INDEX_CACHE_SUFFIX ".cooked-index"
+
+/* File name suffix used for demangled-name cache files.  */
+#define DEMANGLED_NAMES_CACHE_SUFFIX ".demangled-names"
+
+/* Possible values for "set index-cache format".  The "cooked" format
+   stores the finalized cooked index directly, so that a cache hit
+   only needs to mmap the file instead of re-indexing; "gdb-index"
+   stores a regular .gdb_index file.
+
+   Because cache hits map the file read-only, concurrent sessions
+   debugging the same binary share the physical pages through the
+   kernel's page cache: only the first session to see a given build id
+   pays the indexing cost, and a warm farm of sessions shares a single
+   in-memory copy of each index.  */
+static const char index_cache_format_cooked[] = "cooked";
+static const char index_cache_format_gdb_index[] = "gdb-index";
+static const char *const index_cache_formats[] =
+{
+  index_cache_format_cooked,
+  index_cache_format_gdb_index,
+  nullptr
+};
+
+/* The format used to store new index cache files.  */
+static const char *index_cache_format = index_cache_format_cooked;
+
 /* See dwarf-index.cache.h.  */
 index_cache global_index_cache;
 
@@ -154,7 +185,8 @@ index_cache_store_context::index_cache_store_context (const index_cache &ic,
 
 void
 index_cache::store (dwarf2_per_bfd *per_bfd,
-		    const index_cache_store_context &ctx)
+		    const index_cache_store_context &ctx,
+		    cooked_index *idx)
 {
   if (!ctx.m_enabled)
     return;
@@ -170,9 +202,30 @@ index_cache::store (dwarf2_per_bfd *per_bfd,
 
       /* Write the index itself to the directory, using the build id as the
 	 filename.  */
-      write_dwarf_index (per_bfd, m_dir.c_str (),
-			 ctx.build_id_str.c_str (), dwz_build_id_ptr,
-			 dw_index_kind::GDB_INDEX);
+      if (index_cache_format == index_cache_format_cooked)
+	{
+	  std::string filename = (m_dir + SLASH_STRING + ctx.build_id_str
+				  + COOKED_INDEX_CACHE_SUFFIX);
+
+	  /* When several GDB sessions index the same binary concurrently
+	     (a CI farm, say), each one builds the index, but only one
+	     store is needed.  Cache files are written to a temporary name
+	     and renamed into place, so if the file exists at all it is
+	     complete and describes the same build id -- skip the redundant
+	     serialization.  */
+	  struct stat st;
+	  if (stat (filename.c_str (), &st) == 0)
+	    index_cache_debug ("index cache file %s already exists, "
+			       "not rewriting it",
+			       filename.c_str ());
+	  else
+	    idx->write_cache_file (filename.c_str (), dwz_build_id_ptr,
+				   per_bfd);
+	}
+      else
+	write_dwarf_index (per_bfd, m_dir.c_str (),
+			   ctx.build_id_str.c_str (), dwz_build_id_ptr,
+			   dw_index_kind::GDB_INDEX);
     }
   catch (const gdb_exception_error &except)
     {
@@ -199,8 +252,9 @@ struct index_cache_resource_mmap final : public index_cache_resource
 /* See dwarf-index-cache.h.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup_index_file (const bfd_build_id *build_id,
+				const char *suffix,
+				std::unique_ptr<index_cache_resource> *resource)
 {
   if (!enabled ())
     return {};
@@ -212,8 +266,8 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       return {};
     }
 
-  /* Compute where we would expect a gdb index file for this build id to be.  */
-  std::string filename = make_index_filename (build_id, INDEX4_SUFFIX);
+  /* Compute where we would expect an index file for this build id to be.  */
+  std::string filename = make_index_filename (build_id, suffix);
 
   try
     {
@@ -245,8 +299,9 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 /* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
 
 gdb::array_view<const gdb_byte>
-index_cache::lookup_gdb_index (const bfd_build_id *build_id,
-			       std::unique_ptr<index_cache_resource> *resource)
+index_cache::lookup_index_file (const bfd_build_id *build_id,
+				const char *suffix,
+				std::unique_ptr<index_cache_resource> *resource)
 {
   return {};
 }
@@ -255,6 +310,85 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 
 /* See dwarf-index-cache.h.  */
 
+gdb::array_view<const gdb_byte>
+index_cache::lookup_gdb_index (const bfd_build_id *build_id,
+			       std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup_index_file (build_id, INDEX4_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_cooked_index (const bfd_build_id *build_id,
+				  std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup_index_file (build_id, COOKED_INDEX_CACHE_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
+gdb::array_view<const gdb_byte>
+index_cache::lookup_demangled_names
+  (const bfd_build_id *build_id,
+   std::unique_ptr<index_cache_resource> *resource)
+{
+  return lookup_index_file (build_id, DEMANGLED_NAMES_CACHE_SUFFIX, resource);
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::store_demangled_names (const bfd_build_id *build_id,
+				    gdb::array_view<const gdb_byte> contents)
+{
+  if (!enabled ())
+    return;
+
+  if (m_dir.empty ())
+    {
+      warning (_("The index cache directory name is empty, skipping store."));
+      return;
+    }
+
+  std::string filename
+    = make_index_filename (build_id, DEMANGLED_NAMES_CACHE_SUFFIX);
+
+  try
+    {
+      /* Try to create the containing directory.  */
+      if (!mkdir_recursive (m_dir.c_str ()))
+	{
+	  warning (_("index cache: could not make cache directory: %s"),
+		   safe_strerror (errno));
+	  return;
+	}
+
+      index_cache_debug ("writing demangled-name cache file %s",
+			 filename.c_str ());
+
+      gdb_file_up file = gdb_fopen_cloexec (filename.c_str (), "wb");
+      if (file == nullptr)
+	{
+	  warning (_("index cache: could not open %s: %s"),
+		   filename.c_str (), safe_strerror (errno));
+	  return;
+	}
+
+      if (fwrite (contents.data (), 1, contents.size (), file.get ())
+	  != contents.size ())
+	warning (_("index cache: could not write %s: %s"),
+		 filename.c_str (), safe_strerror (errno));
+    }
+  catch (const gdb_exception_error &except)
+    {
+      index_cache_debug ("couldn't write %s: %s",
+			 filename.c_str (), except.what ());
+    }
+}
+
+/* See dwarf-index-cache.h.  */
+
 std::string
 index_cache::make_index_filename (const bfd_build_id *build_id,
 				  const char *suffix) const
@@ -405,6 +539,21 @@ _initialize_index_cache ()
 			    &set_index_cache_prefix_list,
 			    &show_index_cache_prefix_list);
 
+  /* set/show index-cache format */
+  add_setshow_enum_cmd ("format", class_files, index_cache_formats,
+			&index_cache_format,
+			_("Set the format used for new index cache files."),
+			_("Show the format used for new index cache files."),
+			_("\
+When set to \"cooked\" (the default), the cache stores the finalized\n\
+cooked index in a memory-mappable form, so that loading it does not\n\
+require re-indexing the debug info.  When set to \"gdb-index\", the\n\
+cache stores a regular .gdb_index file.  Existing cache files in\n\
+either format are still used for lookups."),
+			nullptr, nullptr,
+			&set_index_cache_prefix_list,
+			&show_index_cache_prefix_list);
+
   /* show index-cache stats */
   add_cmd ("stats", class_files, show_index_cache_stats_command,
 	   _("Show some stats about the index cache."),
@@ -24,6 +24,7 @@
 #include "gdbsupport/array-view.h"
 #include "symfile.h"
 
+class cooked_index;
 class dwarf2_per_bfd;
 class index_cache;
 
@@ -76,9 +77,13 @@ public:
   /* Disable the cache.  */
   void disable ();
 
-  /* Store an index for the specified object file in the cache.  */
+  /* Store an index for the specified object file in the cache.  IDX
+     is the cooked index the object file was read with; it is used
+     when the cache is configured to store the serialized cooked index
+     format.  */
   void store (dwarf2_per_bfd *per_bfd,
-	      const index_cache_store_context &);
+	      const index_cache_store_context &,
+	      cooked_index *idx);
 
   /* Look for an index file matching BUILD_ID.  If found, return the contents
      as an array_view and store the underlying resources (allocated memory,
@@ -90,6 +95,22 @@ public:
   lookup_gdb_index (const bfd_build_id *build_id,
 		    std::unique_ptr<index_cache_resource> *resource);
 
+  /* Same, but look for a serialized cooked index file (see
+     cooked_index::write_cache_file) instead of a .gdb_index file.  */
+  gdb::array_view<const gdb_byte>
+  lookup_cooked_index (const bfd_build_id *build_id,
+		       std::unique_ptr<index_cache_resource> *resource);
+
+  /* Same, but look for a demangled-name cache file (see the demangled
+     name cache in symtab.c) instead of a .gdb_index file.  */
+  gdb::array_view<const gdb_byte>
+  lookup_demangled_names (const bfd_build_id *build_id,
+			  std::unique_ptr<index_cache_resource> *resource);
+
+  /* Write CONTENTS as the demangled-name cache file for BUILD_ID.  */
+  void store_demangled_names (const bfd_build_id *build_id,
+			      gdb::array_view<const gdb_byte> contents);
+
   /* Return the number of cache hits.  */
   unsigned int n_hits () const
   { return m_n_hits; }
@@ -114,6 +135,14 @@ public:
 
 private:
 
+  /* Helper for the lookup methods.  Try to mmap the index file for
+     BUILD_ID whose name ends with SUFFIX, handing the mapping to
+     RESOURCE.  Return an empty array view if the file could not be
+     read.  */
+  gdb::array_view<const gdb_byte>
+  lookup_index_file (const bfd_build_id *build_id, const char *suffix,
+		     std::unique_ptr<index_cache_resource> *resource);
+
   /* Compute the absolute filename where the index of the objfile with build
      id BUILD_ID will be stored.  SUFFIX is appended at the end of the
      filename.  */
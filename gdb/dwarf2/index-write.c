@@ -38,6 +38,8 @@
 #include "objfiles.h"
 #include "ada-lang.h"
 #include "dwarf2/tag.h"
+#include "gdbsupport/parallel-for.h"
+#include "gdbsupport/thread-pool.h"
 
 #include <algorithm>
 #include <cmath>
@@ -190,11 +192,18 @@ struct mapped_symtab
     data.resize (1024);
   }
 
-  /* Minimize each entry in the symbol table, removing duplicates.  */
+  /* Minimize each entry in the symbol table, removing duplicates.
+     The entries are independent, so this is done on the thread
+     pool.  */
   void minimize ()
   {
-    for (symtab_index_entry &item : data)
-      item.minimize ();
+    gdb::parallel_for_each (1024, data.begin (), data.end (),
+			    [] (std::vector<symtab_index_entry>::iterator iter,
+				std::vector<symtab_index_entry>::iterator end)
+      {
+	for (; iter != end; ++iter)
+	  iter->minimize ();
+      });
   }
 
   offset_type n_elements = 0;
@@ -1221,37 +1230,56 @@ write_gdbindex (dwarf2_per_bfd *per_bfd, cooked_index *table,
       const auto insertpair = cu_index_htab.emplace (per_cu, counter);
       gdb_assert (insertpair.second);
 
-      /* See enhancement PR symtab/30838.  */
-      gdb_assert (!(per_cu->is_dwz && per_cu->is_debug_types));
-
-      /* The all_units list contains CUs read from the objfile as well as
-	 from the eventual dwz file.  We need to place the entry in the
-	 corresponding index.  */
-      data_buf &cu_list = (per_cu->is_debug_types
-			   ? types_cu_list
-			   : per_cu->is_dwz ? dwz_cu_list : objfile_cu_list);
-      cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
-			   to_underlying (per_cu->sect_off));
-      if (per_cu->is_debug_types)
-	{
-	  signatured_type *sig_type = (signatured_type *) per_cu;
-	  cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
-			       to_underlying (sig_type->type_offset_in_tu));
-	  cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
-			       sig_type->signature);
-	}
-      else
-	cu_list.append_uint (8, BFD_ENDIAN_LITTLE, per_cu->length ());
-
       ++counter;
     }
 
-  write_cooked_index (table, cu_index_htab, &symtab);
+  /* The CU lists and the address map only depend on data that is
+     fixed at this point, so emit them on the thread pool while this
+     thread builds the symbol table.  */
+  gdb::future<void> cu_list_future
+    = gdb::thread_pool::g_thread_pool->post_task
+	([per_bfd, &objfile_cu_list, &types_cu_list, &dwz_cu_list] ()
+    {
+      for (const auto &per_cu_up : per_bfd->all_units)
+	{
+	  dwarf2_per_cu_data *per_cu = per_cu_up.get ();
+
+	  /* See enhancement PR symtab/30838.  */
+	  gdb_assert (!(per_cu->is_dwz && per_cu->is_debug_types));
+
+	  /* The all_units list contains CUs read from the objfile as
+	     well as from the eventual dwz file.  We need to place the
+	     entry in the corresponding index.  */
+	  data_buf &cu_list = (per_cu->is_debug_types
+			       ? types_cu_list
+			       : per_cu->is_dwz ? dwz_cu_list
+			       : objfile_cu_list);
+	  cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
+			       to_underlying (per_cu->sect_off));
+	  if (per_cu->is_debug_types)
+	    {
+	      signatured_type *sig_type = (signatured_type *) per_cu;
+	      cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
+				   to_underlying (sig_type->type_offset_in_tu));
+	      cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
+				   sig_type->signature);
+	    }
+	  else
+	    cu_list.append_uint (8, BFD_ENDIAN_LITTLE, per_cu->length ());
+	}
+    });
 
   /* Dump the address map.  */
   data_buf addr_vec;
-  for (auto map : table->get_addrmaps ())
-    write_address_map (map, addr_vec, cu_index_htab);
+  gdb::future<void> addr_vec_future
+    = gdb::thread_pool::g_thread_pool->post_task
+	([table, &addr_vec, &cu_index_htab] ()
+    {
+      for (auto map : table->get_addrmaps ())
+	write_address_map (map, addr_vec, cu_index_htab);
+    });
+
+  write_cooked_index (table, cu_index_htab, &symtab);
 
   /* Now that we've processed all symbols we can shrink their cu_indices
      lists.  */
@@ -1263,6 +1291,10 @@ write_gdbindex (dwarf2_per_bfd *per_bfd, cooked_index *table,
 
   write_hash_table (&symtab, symtab_vec, constant_pool);
 
+  /* Re-raises any exception from the workers.  */
+  cu_list_future.get ();
+  addr_vec_future.get ();
+
   write_gdbindex_1(out_file, objfile_cu_list, types_cu_list, addr_vec,
 		   symtab_vec, constant_pool);
 
@@ -1300,12 +1332,8 @@ write_debug_names (dwarf2_per_bfd *per_bfd, cooked_index *table,
       dwarf2_per_cu_data *per_cu = per_bfd->all_units[i].get ();
 
       int &this_counter = per_cu->is_debug_types ? types_counter : counter;
-      data_buf &this_list = per_cu->is_debug_types ? types_cu_list : cu_list;
 
       nametable.add_cu (per_cu, this_counter);
-      this_list.append_uint (nametable.dwarf5_offset_size (),
-			     dwarf5_byte_order,
-			     to_underlying (per_cu->sect_off));
       ++this_counter;
     }
 
@@ -1313,11 +1341,35 @@ write_debug_names (dwarf2_per_bfd *per_bfd, cooked_index *table,
   gdb_assert (counter == per_bfd->all_comp_units.size ());
   gdb_assert (types_counter == per_bfd->all_type_units.size ());
 
+  /* The CU lists only depend on data that is fixed at this point, so
+     emit them on the thread pool while this thread fills in the name
+     table.  */
+  const int offset_size = nametable.dwarf5_offset_size ();
+  gdb::future<void> cu_list_future
+    = gdb::thread_pool::g_thread_pool->post_task
+	([per_bfd, &cu_list, &types_cu_list, offset_size,
+	  dwarf5_byte_order] ()
+    {
+      for (const auto &per_cu_up : per_bfd->all_units)
+	{
+	  dwarf2_per_cu_data *per_cu = per_cu_up.get ();
+	  data_buf &this_list = (per_cu->is_debug_types
+				 ? types_cu_list
+				 : cu_list);
+
+	  this_list.append_uint (offset_size, dwarf5_byte_order,
+				 to_underlying (per_cu->sect_off));
+	}
+    });
+
   for (const cooked_index_entry *entry : table->all_entries ())
     nametable.insert (entry);
 
   nametable.build ();
 
+  /* Re-raises any exception from the worker.  */
+  cu_list_future.get ();
+
   /* No addr_vec - DWARF-5 uses .debug_aranges generated by GCC.  */
 
   const offset_type bytes_of_header
@@ -27,9 +27,11 @@
 #include "defs.h"
 #include "dwarf2/leb.h"
 
+/* See leb.h.  */
+
 ULONGEST
-read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
-			  unsigned int *bytes_read_ptr)
+read_unsigned_leb128_slow (bfd *abfd, const gdb_byte *buf,
+			   unsigned int *bytes_read_ptr)
 {
   ULONGEST result;
   unsigned int num_read;
@@ -55,9 +57,11 @@ read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
   return result;
 }
 
+/* See leb.h.  */
+
 LONGEST
-read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
-		    unsigned int *bytes_read_ptr)
+read_signed_leb128_slow (bfd *abfd, const gdb_byte *buf,
+			 unsigned int *bytes_read_ptr)
 {
   ULONGEST result;
   int shift, num_read;
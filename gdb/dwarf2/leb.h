@@ -78,9 +78,67 @@ read_8_bytes (bfd *abfd, const gdb_byte *buf)
   return bfd_get_64 (abfd, buf);
 }
 
-extern LONGEST read_signed_leb128 (bfd *, const gdb_byte *, unsigned int *);
+/* Out-of-line decoders for LEB128 values of arbitrary length; see the
+   inline wrappers below, which are what readers should call.  */
 
-extern ULONGEST read_unsigned_leb128 (bfd *, const gdb_byte *, unsigned int *);
+extern LONGEST read_signed_leb128_slow (bfd *, const gdb_byte *,
+					unsigned int *);
+
+extern ULONGEST read_unsigned_leb128_slow (bfd *, const gdb_byte *,
+					   unsigned int *);
+
+/* Read an unsigned LEB128 value starting at BUF, returning the number
+   of bytes consumed in *BYTES_READ_PTR.
+
+   These functions are called for nearly every attribute of every DIE
+   when scanning .debug_info, and the overwhelming majority of LEB128
+   values there fit in one or two bytes.  Decode those inline and only
+   fall back to the out-of-line loop for longer encodings.  Note that
+   when BUF[0] has its continuation bit set, the value is encoded in
+   at least two bytes, so reading BUF[1] stays within the data.  */
+
+static inline ULONGEST
+read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
+		      unsigned int *bytes_read_ptr)
+{
+  if ((buf[0] & 0x80) == 0)
+    {
+      *bytes_read_ptr = 1;
+      return buf[0];
+    }
+  if ((buf[1] & 0x80) == 0)
+    {
+      *bytes_read_ptr = 2;
+      return (ULONGEST) (buf[0] & 0x7f) | ((ULONGEST) buf[1] << 7);
+    }
+  return read_unsigned_leb128_slow (abfd, buf, bytes_read_ptr);
+}
+
+/* Like read_unsigned_leb128, but for signed values.  */
+
+static inline LONGEST
+read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
+		    unsigned int *bytes_read_ptr)
+{
+  if ((buf[0] & 0x80) == 0)
+    {
+      *bytes_read_ptr = 1;
+      LONGEST result = buf[0] & 0x7f;
+      if ((result & 0x40) != 0)
+	result -= 0x80;
+      return result;
+    }
+  if ((buf[1] & 0x80) == 0)
+    {
+      *bytes_read_ptr = 2;
+      LONGEST result = ((LONGEST) (buf[0] & 0x7f)
+			| ((LONGEST) (buf[1] & 0x7f) << 7));
+      if ((result & 0x2000) != 0)
+	result -= 0x4000;
+      return result;
+    }
+  return read_signed_leb128_slow (abfd, buf, bytes_read_ptr);
+}
 
 /* Read the initial length from a section.  The (draft) DWARF 3
    specification allows the initial length to take up either 4 bytes
@@ -57,6 +57,36 @@ line_header::add_file_name (const char *name,
   m_file_names.emplace_back (name, index, d_index, mod_time, length);
 }
 
+/* See line-header.h.  */
+
+std::unique_ptr<line_header>
+line_header::clone () const
+{
+  std::unique_ptr<line_header> copy (new line_header (m_comp_dir));
+
+  copy->sect_off = sect_off;
+  copy->offset_in_dwz = offset_in_dwz;
+  copy->version = version;
+  copy->minimum_instruction_length = minimum_instruction_length;
+  copy->maximum_ops_per_instruction = maximum_ops_per_instruction;
+  copy->default_is_stmt = default_is_stmt;
+  copy->line_base = line_base;
+  copy->line_range = line_range;
+  copy->opcode_base = opcode_base;
+  if (standard_opcode_lengths != nullptr)
+    {
+      copy->standard_opcode_lengths.reset (new unsigned char[opcode_base]);
+      memcpy (copy->standard_opcode_lengths.get (),
+	      standard_opcode_lengths.get (), opcode_base);
+    }
+  copy->statement_program_start = statement_program_start;
+  copy->statement_program_end = statement_program_end;
+  copy->m_include_dirs = m_include_dirs;
+  copy->m_file_names = m_file_names;
+
+  return copy;
+}
+
 std::string
 line_header::file_file_name (const file_entry &fe) const
 {
@@ -84,6 +84,11 @@ struct line_header
       offset_in_dwz (offset_in_dwz)
   {}
 
+  /* Return a copy of this line header.  This is used by readers that
+     need to keep the file name table past the lifetime of the CU this
+     header was read for.  */
+  std::unique_ptr<line_header> clone () const;
+
   /* Add an entry to the include directory table.  */
   void add_include_dir (const char *include_dir);
 
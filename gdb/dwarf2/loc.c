@@ -41,8 +41,10 @@
 #include "dwarf2/leb.h"
 #include "compile/compile.h"
 #include "gdbsupport/selftest.h"
+#include "observable.h"
 #include <algorithm>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 #include "gdbsupport/underlying.h"
 #include "gdbsupport/byte-vector.h"
@@ -353,18 +355,13 @@ decode_debug_loc_dwo_addresses (dwarf2_per_cu_data *per_cu,
     }
 }
 
-/* A function for dealing with location lists.  Given a
-   symbol baton (BATON) and a pc value (PC), find the appropriate
-   location expression, set *LOCEXPR_LENGTH, and return a pointer
-   to the beginning of the expression.  Returns NULL on failure.
-
-   For now, only return the first matching location expression; there
-   can be more than one in the list.  */
+/* Helper for dwarf2_find_location_expression, below, that performs
+   the actual search through the location list.  */
 
-const gdb_byte *
-dwarf2_find_location_expression (const dwarf2_loclist_baton *baton,
-				 size_t *locexpr_length, const CORE_ADDR pc,
-				 bool at_entry)
+static const gdb_byte *
+dwarf2_find_location_expression_1 (const dwarf2_loclist_baton *baton,
+				   size_t *locexpr_length, const CORE_ADDR pc,
+				   bool at_entry)
 {
   dwarf2_per_objfile *per_objfile = baton->per_objfile;
   struct objfile *objfile = per_objfile->objfile;
@@ -485,6 +482,51 @@ dwarf2_find_location_expression (const dwarf2_loclist_baton *baton,
     }
 }
 
+/* A function for dealing with location lists.  Given a
+   symbol baton (BATON) and a pc value (PC), find the appropriate
+   location expression, set *LOCEXPR_LENGTH, and return a pointer
+   to the beginning of the expression.  Returns NULL on failure.
+
+   For now, only return the first matching location expression; there
+   can be more than one in the list.  */
+
+const gdb_byte *
+dwarf2_find_location_expression (const dwarf2_loclist_baton *baton,
+				 size_t *locexpr_length, const CORE_ADDR pc,
+				 bool at_entry)
+{
+  CORE_ADDR text_offset
+    = baton->per_objfile->objfile->text_section_offset ();
+
+  /* A symbol's location list is typically searched many times in a
+     row for the same PC -- once per access to the symbol while the
+     inferior is stopped at it.  Decode the list just once and replay
+     the result from the cache afterwards.  The text offset takes
+     part in the comparison because the list entries are relative to
+     it; it changes if the objfile is relocated.  */
+  if (baton->cache_valid
+      && baton->cached_pc == pc
+      && baton->cached_at_entry == at_entry
+      && baton->cached_text_offset == text_offset)
+    {
+      *locexpr_length = baton->cached_size;
+      return baton->cached_data;
+    }
+
+  const gdb_byte *data
+    = dwarf2_find_location_expression_1 (baton, locexpr_length, pc,
+					 at_entry);
+
+  baton->cached_pc = pc;
+  baton->cached_at_entry = at_entry;
+  baton->cached_text_offset = text_offset;
+  baton->cached_data = data;
+  baton->cached_size = *locexpr_length;
+  baton->cache_valid = true;
+
+  return data;
+}
+
 /* Implement find_frame_base_location method for LOC_BLOCK functions using
    DWARF expression for its DW_AT_frame_base.  */
 
@@ -1084,6 +1126,62 @@ call_site_find_chain_1 (struct gdbarch *gdbarch, CORE_ADDR caller_pc,
   return retval;
 }
 
+/* One memoized result of call_site_find_chain_1, for a single callee
+   PC and architecture.  A NULL CHAIN records that no valid chain
+   could be constructed - the common and most expensive outcome, as it
+   means the whole call graph search failed.  */
+
+struct call_site_chain_cache_entry
+{
+  CORE_ADDR callee_pc;
+
+  struct gdbarch *gdbarch;
+
+  gdb::unique_xmalloc_ptr<call_site_chain> chain;
+};
+
+/* Cache of call site chains, keyed by the caller PC; the handful of
+   callee PCs seen for one caller are searched linearly.  The chain
+   search is re-run by the tail call sniffer on every stop and can be
+   very costly on deep call graphs, while its result only changes
+   when the symbol data changes, so it is memoized here per program
+   space and flushed whenever objfiles are added, removed or
+   relocated.  */
+
+struct call_site_chain_cache
+{
+  std::unordered_map<CORE_ADDR,
+		     std::vector<call_site_chain_cache_entry>> map;
+};
+
+static const registry<program_space>::key<call_site_chain_cache>
+  call_site_chain_cache_key;
+
+/* Return a freshly xmalloc'd copy of CHAIN.  The cache must keep the
+   master copy because callers of call_site_find_chain take ownership
+   of the returned chain.  */
+
+static gdb::unique_xmalloc_ptr<call_site_chain>
+call_site_chain_dup (const struct call_site_chain *chain)
+{
+  size_t size = (sizeof (*chain)
+		 + sizeof (*chain->call_site) * (chain->length - 1));
+  struct call_site_chain *copy = (struct call_site_chain *) xmalloc (size);
+
+  memcpy (copy, chain, size);
+  return gdb::unique_xmalloc_ptr<call_site_chain> (copy);
+}
+
+/* See loc.h.  */
+
+void
+invalidate_call_site_chain_cache (struct program_space *pspace)
+{
+  call_site_chain_cache *cache = call_site_chain_cache_key.get (pspace);
+  if (cache != nullptr)
+    cache->map.clear ();
+}
+
 /* Create and return call_site_chain for CALLER_PC and CALLEE_PC.  All the
    assumed frames between them use GDBARCH.  If valid call_site_chain cannot be
    constructed return NULL.  */
@@ -1092,6 +1190,21 @@ gdb::unique_xmalloc_ptr<call_site_chain>
 call_site_find_chain (struct gdbarch *gdbarch, CORE_ADDR caller_pc,
 		      CORE_ADDR callee_pc)
 {
+  call_site_chain_cache *cache
+    = call_site_chain_cache_key.get (current_program_space);
+  if (cache == nullptr)
+    cache = call_site_chain_cache_key.emplace (current_program_space);
+
+  std::vector<call_site_chain_cache_entry> &entries
+    = cache->map[caller_pc];
+  for (const call_site_chain_cache_entry &entry : entries)
+    if (entry.callee_pc == callee_pc && entry.gdbarch == gdbarch)
+      {
+	if (entry.chain == nullptr)
+	  return NULL;
+	return call_site_chain_dup (entry.chain.get ());
+      }
+
   gdb::unique_xmalloc_ptr<call_site_chain> retval;
 
   try
@@ -1105,12 +1218,15 @@ call_site_find_chain (struct gdbarch *gdbarch, CORE_ADDR caller_pc,
 	  if (entry_values_debug)
 	    exception_print (gdb_stdout, e);
 
+	  entries.push_back ({ callee_pc, gdbarch, nullptr });
 	  return NULL;
 	}
       else
 	throw;
     }
 
+  entries.push_back ({ callee_pc, gdbarch,
+		       call_site_chain_dup (retval.get ()) });
   return retval;
 }
 
@@ -4118,10 +4234,40 @@ const struct symbol_computed_ops dwarf2_loclist_funcs = {
   loclist_generate_c_location
 };
 
+/* This module's 'new_objfile' observer.  */
+
+static void
+loc_new_objfile_observer (struct objfile *objfile)
+{
+  invalidate_call_site_chain_cache (objfile->pspace);
+}
+
+/* This module's 'all_objfiles_removed' observer.  */
+
+static void
+loc_all_objfiles_removed (program_space *pspace)
+{
+  invalidate_call_site_chain_cache (pspace);
+}
+
+/* This module's 'free_objfile' observer.  */
+
+static void
+loc_free_objfile_observer (struct objfile *objfile)
+{
+  invalidate_call_site_chain_cache (objfile->pspace);
+}
+
 void _initialize_dwarf2loc ();
 void
 _initialize_dwarf2loc ()
 {
+  gdb::observers::new_objfile.attach (loc_new_objfile_observer, "dwarf2loc");
+  gdb::observers::all_objfiles_removed.attach (loc_all_objfiles_removed,
+					       "dwarf2loc");
+  gdb::observers::free_objfile.attach (loc_free_objfile_observer,
+				       "dwarf2loc");
+
   add_setshow_zuinteger_cmd ("entry-values", class_maintenance,
 			     &entry_values_debug,
 			     _("Set entry values and tail call frames "
@@ -199,6 +199,18 @@ struct dwarf2_loclist_baton
   /* Non-zero if the location list lives in .debug_loc.dwo.
      The format of entries in this section are different.  */
   unsigned char from_dwo;
+
+  /* Cache of the most recent search through this location list (see
+     dwarf2_find_location_expression), valid only if CACHE_VALID.
+     CACHED_PC, CACHED_AT_ENTRY and CACHED_TEXT_OFFSET identify the
+     query; CACHED_DATA and CACHED_SIZE hold its result.  These are
+     mutable because the search takes the baton as const.  */
+  mutable CORE_ADDR cached_pc;
+  mutable CORE_ADDR cached_text_offset;
+  mutable const gdb_byte *cached_data;
+  mutable size_t cached_size;
+  mutable bool cached_at_entry;
+  mutable bool cache_valid;
 };
 
 /* The baton used when a dynamic property is an offset to a parent
@@ -270,6 +282,11 @@ struct call_site_chain
 extern gdb::unique_xmalloc_ptr<call_site_chain> call_site_find_chain
   (struct gdbarch *gdbarch, CORE_ADDR caller_pc, CORE_ADDR callee_pc);
 
+/* Discard all cached call site chains for PSPACE.  Called when the
+   symbol data the chains were computed from may have changed.  */
+
+extern void invalidate_call_site_chain_cache (struct program_space *pspace);
+
 /* A helper function to convert a DWARF register to an arch register.
    ARCH is the architecture.
    DWARF_REG is the register.
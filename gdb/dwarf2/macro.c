@@ -32,7 +32,6 @@
 #include "dwarf2/section.h"
 #include "dwarf2/macro.h"
 #include "dwarf2/dwz.h"
-#include "buildsym.h"
 #include "macrotab.h"
 #include "complaints.h"
 #include "objfiles.h"
@@ -46,7 +45,7 @@ dwarf2_macro_malformed_definition_complaint (const char *arg1)
 }
 
 static struct macro_source_file *
-macro_start_file (buildsym_compunit *builder,
+macro_start_file (gdb::function_view<macro_table * ()> get_macro_table,
 		  int file, int line,
 		  struct macro_source_file *current_file,
 		  const struct line_header *lh)
@@ -72,7 +71,7 @@ macro_start_file (buildsym_compunit *builder,
     {
       /* Note: We don't create a macro table for this compilation unit
 	 at all until we actually get a filename.  */
-      struct macro_table *macro_table = builder->get_macro_table ();
+      struct macro_table *macro_table = get_macro_table ();
 
       /* If we have no current file, then this must be the start_file
 	 directive for the compilation unit's main source file.  */
@@ -434,7 +433,7 @@ dwarf_parse_macro_header (const gdb_byte **opcode_definitions,
 
 static void
 dwarf_decode_macro_bytes (dwarf2_per_objfile *per_objfile,
-			  buildsym_compunit *builder,
+			  gdb::function_view<macro_table * ()> get_macro_table,
 			  bfd *abfd,
 			  const gdb_byte *mac_ptr, const gdb_byte *mac_end,
 			  struct macro_source_file *current_file,
@@ -445,7 +444,7 @@ dwarf_decode_macro_bytes (dwarf2_per_objfile *per_objfile,
 			  struct dwarf2_section_info *str_section,
 			  struct dwarf2_section_info *str_offsets_section,
 			  gdb::optional<ULONGEST> str_offsets_base,
-			  htab_t include_hash, struct dwarf2_cu *cu)
+			  htab_t include_hash, bool is_clang)
 {
   struct objfile *objfile = per_objfile->objfile;
   enum dwarf_macro_record_type macinfo_type;
@@ -663,7 +662,7 @@ dwarf_decode_macro_bytes (dwarf2_per_objfile *per_objfile,
 		at_commandline = 0;
 	      }
 	    else
-	      current_file = macro_start_file (builder, file, line,
+	      current_file = macro_start_file (get_macro_table, file, line,
 					       current_file, lh);
 	  }
 	  break;
@@ -672,8 +671,7 @@ dwarf_decode_macro_bytes (dwarf2_per_objfile *per_objfile,
 	  if (! current_file)
 	    complaint (_("macro debug info has an unmatched "
 			 "`close_file' directive"));
-	  else if (current_file->included_by == nullptr
-		   && producer_is_clang (cu))
+	  else if (current_file->included_by == nullptr && is_clang)
 	    {
 	      /* Clang, until the current version, misplaces some macro
 		 definitions - such as ones defined in the command line,
@@ -757,12 +755,14 @@ dwarf_decode_macro_bytes (dwarf2_per_objfile *per_objfile,
 	      {
 		*slot = (void *) new_mac_ptr;
 
-		dwarf_decode_macro_bytes (per_objfile, builder, include_bfd,
-					  new_mac_ptr, include_mac_end,
-					  current_file, lh, section,
-					  section_is_gnu, is_dwz, offset_size,
-					  str_section, str_offsets_section,
-					  str_offsets_base, include_hash, cu);
+		dwarf_decode_macro_bytes (per_objfile, get_macro_table,
+					  include_bfd, new_mac_ptr,
+					  include_mac_end, current_file, lh,
+					  section, section_is_gnu, is_dwz,
+					  offset_size, str_section,
+					  str_offsets_section,
+					  str_offsets_base, include_hash,
+					  is_clang);
 
 		htab_remove_elt (include_hash, (void *) new_mac_ptr);
 	      }
@@ -798,15 +798,17 @@ dwarf_decode_macro_bytes (dwarf2_per_objfile *per_objfile,
     } while (macinfo_type != 0);
 }
 
+/* See macro.h.  */
+
 void
 dwarf_decode_macros (dwarf2_per_objfile *per_objfile,
-		     buildsym_compunit *builder,
+		     gdb::function_view<macro_table * ()> get_macro_table,
 		     const dwarf2_section_info *section,
 		     const struct line_header *lh, unsigned int offset_size,
 		     unsigned int offset, struct dwarf2_section_info *str_section,
 		     struct dwarf2_section_info *str_offsets_section,
 		     gdb::optional<ULONGEST> str_offsets_base,
-		     int section_is_gnu, struct dwarf2_cu *cu)
+		     int section_is_gnu, bool is_clang)
 {
   bfd *abfd;
   const gdb_byte *mac_ptr, *mac_end;
@@ -887,7 +889,7 @@ dwarf_decode_macros (dwarf2_per_objfile *per_objfile,
 	    file = read_unsigned_leb128 (abfd, mac_ptr, &bytes_read);
 	    mac_ptr += bytes_read;
 
-	    current_file = macro_start_file (builder, file, line,
+	    current_file = macro_start_file (get_macro_table, file, line,
 					     current_file, lh);
 	  }
 	  break;
@@ -964,8 +966,9 @@ dwarf_decode_macros (dwarf2_per_objfile *per_objfile,
   mac_ptr = section->buffer + offset;
   slot = htab_find_slot (include_hash.get (), mac_ptr, INSERT);
   *slot = (void *) mac_ptr;
-  dwarf_decode_macro_bytes (per_objfile, builder, abfd, mac_ptr, mac_end,
-			    current_file, lh, section, section_is_gnu, 0,
-			    offset_size, str_section, str_offsets_section,
-			    str_offsets_base, include_hash.get (), cu);
+  dwarf_decode_macro_bytes (per_objfile, get_macro_table, abfd, mac_ptr,
+			    mac_end, current_file, lh, section,
+			    section_is_gnu, 0, offset_size, str_section,
+			    str_offsets_section, str_offsets_base,
+			    include_hash.get (), is_clang);
 }
@@ -20,10 +20,20 @@
 #ifndef GDB_DWARF2_MACRO_H
 #define GDB_DWARF2_MACRO_H
 
-struct buildsym_compunit;
+#include "gdbsupport/function-view.h"
+
+struct macro_table;
+
+/* Decode the macro information starting at OFFSET in SECTION.
+   GET_MACRO_TABLE returns the macro table to fill in; it is not
+   called until a table is actually needed, so that no table is
+   created for macro data that turns out to be empty.  IS_CLANG is the
+   result of producer_is_clang for the CU the macro data belongs
+   to.  */
 
 extern void dwarf_decode_macros (dwarf2_per_objfile *per_objfile,
-				 buildsym_compunit *builder,
+				 gdb::function_view<macro_table * ()>
+				   get_macro_table,
 				 const dwarf2_section_info *section,
 				 const struct line_header *lh,
 				 unsigned int offset_size,
@@ -31,6 +41,6 @@ extern void dwarf_decode_macros (dwarf2_per_objfile *per_objfile,
 				 dwarf2_section_info *str_section,
 				 dwarf2_section_info *str_offsets_section,
 				 gdb::optional<ULONGEST> str_offsets_base,
-				 int section_is_gnu, struct dwarf2_cu *cu);
+				 int section_is_gnu, bool is_clang);
 
 #endif /* GDB_DWARF2_MACRO_H */
@@ -82,6 +82,7 @@
 #include "gdbsupport/hash_enum.h"
 #include "filename-seen-cache.h"
 #include "producer.h"
+#include "macrotab.h"
 #include <fcntl.h>
 #include <algorithm>
 #include <unordered_map>
@@ -89,6 +90,10 @@
 #include "rust-lang.h"
 #include "gdbsupport/pathstuff.h"
 #include "count-one-bits.h"
+#include "observable.h"
+#include "run-on-main-thread.h"
+#include "gdbthread.h"
+#include "inferior.h"
 #include <unordered_set>
 #include "dwarf2/abbrev-cache.h"
 #include "cooked-index.h"
@@ -738,6 +743,36 @@ show_dwarf_max_cache_age (struct ui_file *file, int from_tty,
 		      "DWARF compilation units is %s.\n"),
 	      value);
 }
+
+/* When true, expand_symtabs_matching batches the matching CUs and
+   loads their DIE trees in parallel on the thread pool, before
+   building the symtabs serially.  Symtab construction itself is not
+   thread-safe, so only the reading of the DIEs is parallelized.  */
+static bool dwarf_parallel_expansion = false;
+
+static void
+show_dwarf_parallel_expansion (struct ui_file *file, int from_tty,
+			       struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("Parallel loading of DWARF compilation units "
+		      "during symtab expansion is %s.\n"),
+	      value);
+}
+
+/* When true, GDB keeps expanding likely-needed CUs (the CU containing
+   "main", CUs near the current PC) in the background, one CU per
+   event-loop pass, so that a later first touch of those source files
+   does not stall the CLI.  */
+static bool dwarf_background_expansion = false;
+
+static void
+show_dwarf_background_expansion (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("Background expansion of likely-needed "
+		      "compilation units is %s.\n"),
+	      value);
+}
 
 /* local function prototypes */
 
@@ -986,6 +1021,9 @@ static const char *dwarf2_full_name (const char *name,
 static const char *dwarf2_physname (const char *name, struct die_info *die,
 				    struct dwarf2_cu *cu);
 
+static struct attribute *dw2_linkage_name_attr (struct die_info *die,
+						struct dwarf2_cu *cu);
+
 static struct die_info *dwarf2_extension (struct die_info *die,
 					  struct dwarf2_cu **);
 
@@ -1025,7 +1063,7 @@ static int attr_to_dynamic_prop (const struct attribute *attr,
 
 static struct dwarf_block *dwarf_alloc_block (struct dwarf2_cu *);
 
-static void dwarf_decode_macros (struct dwarf2_cu *, unsigned int, int);
+static void dwarf_defer_macros (struct dwarf2_cu *, unsigned int, int);
 
 static void fill_in_loclist_baton (struct dwarf2_cu *cu,
 				   struct dwarf2_loclist_baton *baton,
@@ -1225,6 +1263,77 @@ dwarf2_per_objfile::relocate (unrelocated_addr addr)
   return gdbarch_adjust_dwarf2_addr (objfile->arch (), tem);
 }
 
+/* See read.h.
+
+   One event of a decoded .debug_line program.  The decoded form of a
+   line program is a vector of these.  Producing it (see
+   decode_line_program) consumes only the program bytes and the
+   architecture's line hooks, while replaying it into a CU's line
+   table (see replay_line_program) consumes only the events -- so the
+   expensive decoding step can be shared by every CU that refers to
+   the same program.  */
+
+struct line_program_event
+{
+  enum event_kind : unsigned char
+    {
+      /* A row of the line number matrix; emitted wherever the state
+	 machine records a line.  */
+      LP_ROW,
+      /* The start of a new sequence; the state machine was reset.  */
+      LP_START_SEQUENCE,
+      /* DW_LNS_set_file.  */
+      LP_SET_FILE,
+      /* A DW_LNE_set_address whose address was 0 or -1, indicating a
+	 function possibly discarded by the linker.  Whether the rest
+	 of the sequence is ignored depends on the CU's low pc, so
+	 that decision is left to replay time.  */
+      LP_BAD_ADDRESS,
+      /* DW_LNE_define_file.  */
+      LP_DEFINE_FILE,
+    };
+
+  enum event_kind kind;
+
+  /* For LP_ROW: true if this row ends a sequence.  */
+  bool end_sequence : 1;
+  /* For LP_ROW: true if this row ends a sequence because of an
+     explicit DW_LNE_end_sequence (as opposed to running off the end
+     of the section), which re-enables recording for the final row.  */
+  bool resume_recording : 1;
+  /* For LP_ROW: true if the machine's op_index was zero.  */
+  bool op_index_is_zero : 1;
+  /* For LP_ROW: whether the line has ever had a non-zero
+     discriminator.  */
+  bool line_has_non_zero_discriminator : 1;
+
+  /* For LP_ROW: the line table flags.  */
+  linetable_entry_flags flags;
+
+  /* For LP_ROW and LP_SET_FILE: the current file index.  */
+  file_name_index file;
+
+  /* For LP_ROW: the line, column and discriminator.  */
+  unsigned int line;
+  unsigned int column;
+  unsigned int discriminator;
+
+  /* For LP_ROW and LP_BAD_ADDRESS: the (adjusted, respectively raw)
+     address.  */
+  unrelocated_addr address;
+
+  /* For LP_BAD_ADDRESS: the offset of the following opcode in the
+     line section, for the complaint.
+     For LP_DEFINE_FILE: the directory index.  */
+  unsigned long misc;
+
+  /* For LP_DEFINE_FILE: the file name (pointing into the line
+     section), modification time and length.  */
+  const char *define_file_name;
+  unsigned int define_file_mod_time;
+  unsigned int define_file_length;
+};
+
 /* Hash function for line_header_hash.  */
 
 static hashval_t
@@ -1349,6 +1458,10 @@ dwarf2_per_objfile::set_symtab (const dwarf2_per_cu_data *per_cu,
     this->m_symtabs.resize (per_cu->index + 1);
   gdb_assert (this->m_symtabs[per_cu->index] == nullptr);
   this->m_symtabs[per_cu->index] = symtab;
+
+  /* This CU's files no longer belong to the unexpanded view.  */
+  this->mapped_filenames_cache.clear ();
+  this->mapped_filenames_cache_valid = false;
 }
 
 /* Try to locate the sections we need for DWARF 2 debugging
@@ -1798,6 +1911,179 @@ dw2_instantiate_symtab (dwarf2_per_cu_data *per_cu,
   return per_objfile->get_symtab (per_cu);
 }
 
+/* Background expansion of likely-needed CUs.
+
+   When enabled, each stop of the inferior enqueues a small, priority
+   ordered set of CUs (the CU containing "main", the CUs covering the
+   addresses around the stop PC).  The queue is then drained one CU
+   per event-loop pass, so that expansion work happens while GDB would
+   otherwise sit idle at the prompt, without making it unresponsive.
+   Symtab construction is not thread-safe, so this always runs on the
+   main thread.  */
+
+struct background_expand_item
+{
+  /* Higher values are expanded first.  */
+  int priority;
+  dwarf2_per_cu_data *per_cu;
+  struct objfile *objfile;
+
+  bool operator< (const background_expand_item &other) const
+  {
+    return priority < other.priority;
+  }
+};
+
+/* Pending CUs, kept as a max-heap ordered by priority.  */
+static std::vector<background_expand_item> background_expand_queue;
+
+/* True if a drain step has been posted to the event loop.  */
+static bool background_expand_posted = false;
+
+/* Add PER_CU from OBJFILE to the background expansion queue.  */
+
+static void
+background_expand_enqueue (int priority, dwarf2_per_cu_data *per_cu,
+			   struct objfile *objfile)
+{
+  if (per_cu == nullptr)
+    return;
+
+  dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+  if (per_objfile == nullptr || per_objfile->symtab_set_p (per_cu))
+    return;
+
+  for (const background_expand_item &item : background_expand_queue)
+    if (item.per_cu == per_cu)
+      return;
+
+  background_expand_queue.push_back ({ priority, per_cu, objfile });
+  std::push_heap (background_expand_queue.begin (),
+		  background_expand_queue.end ());
+}
+
+/* Expand the highest-priority pending CU, then re-post this function
+   if more work remains.  */
+
+static void
+background_expand_step ()
+{
+  if (!dwarf_background_expansion)
+    {
+      background_expand_queue.clear ();
+      background_expand_posted = false;
+      return;
+    }
+
+  while (!background_expand_queue.empty ())
+    {
+      std::pop_heap (background_expand_queue.begin (),
+		     background_expand_queue.end ());
+      background_expand_item item = background_expand_queue.back ();
+      background_expand_queue.pop_back ();
+
+      dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (item.objfile);
+      if (per_objfile == nullptr || per_objfile->symtab_set_p (item.per_cu))
+	continue;
+
+      try
+	{
+	  dwarf_read_debug_printf ("background-expanding CU at offset %s",
+				   sect_offset_str (item.per_cu->sect_off));
+	  dw2_instantiate_symtab (item.per_cu, per_objfile, false);
+	}
+      catch (const gdb_exception &)
+	{
+	  /* Errors will resurface if the CU is ever expanded for
+	     real.  */
+	}
+
+      /* Only one CU per pass; yield to the event loop.  */
+      break;
+    }
+
+  if (!background_expand_queue.empty ())
+    run_on_main_thread (background_expand_step);
+  else
+    background_expand_posted = false;
+}
+
+/* Seed the background expansion queue after a stop.  */
+
+static void
+background_expand_on_normal_stop (struct bpstat *bs, int print_frame)
+{
+  if (!dwarf_background_expansion)
+    return;
+
+  /* Find the PC the inferior stopped at, if there is one.  */
+  CORE_ADDR pc = 0;
+  bool have_pc = false;
+  if (inferior_ptid != null_ptid)
+    {
+      thread_info *thr = inferior_thread ();
+      if (thr->stop_pc_p ())
+	{
+	  pc = thr->stop_pc ();
+	  have_pc = true;
+	}
+    }
+
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+      if (per_objfile == nullptr)
+	continue;
+
+      cooked_index *table
+	= dynamic_cast<cooked_index *>
+	    (per_objfile->per_bfd->index_table.get ());
+      if (table == nullptr)
+	continue;
+
+      if (have_pc)
+	{
+	  /* The index stores unrelocated addresses.  */
+	  CORE_ADDR unrel_pc = pc - objfile->text_section_offset ();
+
+	  /* The CU at the PC itself is usually expanded already by
+	     the time the stop is reported; its neighbours are likely
+	     targets for "up", "next" and stepping into callees.  */
+	  background_expand_enqueue (100, table->lookup (unrel_pc), objfile);
+	  background_expand_enqueue (90, table->lookup (unrel_pc - 16384),
+				     objfile);
+	  background_expand_enqueue (90, table->lookup (unrel_pc + 16384),
+				     objfile);
+	}
+
+      const cooked_index_entry *main_entry = table->get_main ();
+      if (main_entry != nullptr)
+	background_expand_enqueue (50, main_entry->per_cu, objfile);
+    }
+
+  if (!background_expand_queue.empty () && !background_expand_posted)
+    {
+      background_expand_posted = true;
+      run_on_main_thread (background_expand_step);
+    }
+}
+
+/* Forget queued CUs belonging to OBJFILE when it is destroyed.  */
+
+static void
+background_expand_free_objfile (struct objfile *objfile)
+{
+  auto it = std::remove_if (background_expand_queue.begin (),
+			    background_expand_queue.end (),
+			    [=] (const background_expand_item &item)
+			    {
+			      return item.objfile == objfile;
+			    });
+  background_expand_queue.erase (it, background_expand_queue.end ());
+  std::make_heap (background_expand_queue.begin (),
+		  background_expand_queue.end ());
+}
+
 /* See read.h.  */
 
 dwarf2_per_cu_data_up
@@ -3050,6 +3336,209 @@ dw2_expand_symtabs_matching_one
   return true;
 }
 
+/* Read the sections that worker threads may need to touch while
+   loading DIE trees, while still on the main thread -- BFD is not
+   thread-safe.  */
+
+static void
+dwarf2_preread_sections (dwarf2_per_objfile *per_objfile)
+{
+  struct objfile *objfile = per_objfile->objfile;
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  per_bfd->info.read (objfile);
+  per_bfd->abbrev.read (objfile);
+  per_bfd->str.read (objfile);
+  per_bfd->str_offsets.read (objfile);
+  per_bfd->line_str.read (objfile);
+  per_bfd->addr.read (objfile);
+  for (dwarf2_section_info &section : per_bfd->types)
+    section.read (objfile);
+
+  dwz_file *dwz = dwarf2_get_dwz_file (per_bfd);
+  if (dwz != nullptr)
+    {
+      dwz->info.read (objfile);
+      dwz->abbrev.read (objfile);
+      dwz->str.read (objfile);
+      dwz->line.read (objfile);
+    }
+}
+
+/* Helper for dwarf2_predemangle_linkage_names.  Collect into NAMES
+   the linkage names of DIE, its siblings and all their children.  */
+
+static void
+collect_linkage_names (struct die_info *die, struct dwarf2_cu *cu,
+		       std::vector<const char *> *names)
+{
+  for (; die != nullptr; die = die->sibling)
+    {
+      struct attribute *attr = dw2_linkage_name_attr (die, cu);
+      if (attr != nullptr)
+	{
+	  const char *name = attr->as_string ();
+	  if (name != nullptr)
+	    names->push_back (name);
+	}
+
+      if (die->child != nullptr)
+	collect_linkage_names (die->child, cu, names);
+    }
+}
+
+/* Demangle the linkage names of the loaded CUs in TO_EXPAND on the
+   thread pool, filling PER_OBJFILE->demangled_physnames, so that
+   dwarf2_physname finds most of its results already computed when the
+   symtabs are subsequently built (serially) on the main thread.  */
+
+static void
+dwarf2_predemangle_linkage_names
+  (dwarf2_per_objfile *per_objfile,
+   const std::vector<dwarf2_per_cu_data *> &to_expand)
+{
+  std::vector<const char *> names;
+
+  for (dwarf2_per_cu_data *per_cu : to_expand)
+    {
+      dwarf2_cu *cu = per_objfile->get_cu (per_cu);
+      if (cu == nullptr || cu->dies == nullptr)
+	continue;
+
+      /* Skip CUs whose names dwarf2_physname would not demangle.  */
+      if (cu->lang () == language_rust
+	  || cu->language_defn->store_sym_names_in_linkage_form_p ())
+	continue;
+
+      collect_linkage_names (cu->dies, cu, &names);
+    }
+
+  /* Create the cache slots up front, on this thread; the workers each
+     only fill in the values of distinct slots, which is safe.  */
+  using slot_type
+    = std::pair<const gdb::string_view, gdb::unique_xmalloc_ptr<char>>;
+  std::vector<slot_type *> slots;
+  slots.reserve (names.size ());
+  for (const char *name : names)
+    {
+      auto result = per_objfile->demangled_physnames.emplace (name, nullptr);
+      if (result.second)
+	slots.push_back (&*result.first);
+    }
+
+  if (slots.empty ())
+    return;
+
+  using iter_type = std::vector<slot_type *>::iterator;
+
+  gdb::parallel_for_each (10, slots.begin (), slots.end (),
+			  [] (iter_type iter, iter_type end)
+    {
+      for (; iter != end; ++iter)
+	{
+	  /* The key points at a NUL-terminated string in the DWARF
+	     string data; see dwarf2_physname for the flags.  */
+	  (*iter)->second = gdb_demangle ((*iter)->first.data (),
+					  (DMGL_PARAMS | DMGL_ANSI
+					   | DMGL_RET_DROP));
+	}
+    });
+}
+
+/* Expand all the CUs in TO_EXPAND.  When parallel expansion is
+   enabled and worker threads are available, the DIE trees of all the
+   CUs are loaded in parallel on the thread pool first; symtab
+   construction itself is not thread-safe, so the symtabs are then
+   built serially through the existing queue machinery.
+
+   EXPANSION_NOTIFY is called for each newly-expanded symtab; return
+   false if it requested that expansion stop, true otherwise.  */
+
+static bool
+dw2_expand_symtabs_batch
+  (dwarf2_per_objfile *per_objfile,
+   std::vector<dwarf2_per_cu_data *> &&to_expand,
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+{
+  /* Drop CUs that were expanded in the meantime.  */
+  to_expand.erase (std::remove_if (to_expand.begin (), to_expand.end (),
+				   [&] (dwarf2_per_cu_data *per_cu)
+				   {
+				     return per_objfile->symtab_set_p (per_cu);
+				   }),
+		   to_expand.end ());
+
+  if (to_expand.empty ())
+    return true;
+
+  {
+    free_cached_comp_units freer (per_objfile);
+    scoped_restore decrementer = increment_reading_symtab ();
+
+    {
+      dwarf2_queue_guard q_guard (per_objfile);
+
+      /* Queueing everything up front keeps the loaded DIE trees alive
+	 until the whole batch has been processed; see the invariant
+	 described in age_comp_units.  */
+      for (dwarf2_per_cu_data *per_cu : to_expand)
+	queue_comp_unit (per_cu, per_objfile, language_minimal);
+
+      dwarf2_preread_sections (per_objfile);
+
+      using iter_type = std::vector<dwarf2_per_cu_data *>::iterator;
+
+      /* Worker threads must not print, so any errors are collected
+	 and reported once the pool is done.  */
+      std::vector<std::vector<gdb_exception>> all_errors;
+      {
+	complaint_interceptor complaint_handler;
+	all_errors
+	  = gdb::parallel_for_each (1, to_expand.begin (), to_expand.end (),
+				    [=] (iter_type iter, iter_type end)
+	  {
+	    std::vector<gdb_exception> errors;
+	    for (; iter != end; ++iter)
+	      {
+		try
+		  {
+		    load_cu (*iter, per_objfile, false);
+		  }
+		catch (gdb_exception &except)
+		  {
+		    errors.push_back (std::move (except));
+		  }
+	      }
+	    return errors;
+	  });
+      }
+
+      std::unordered_set<gdb_exception> seen_exceptions;
+      for (auto &one_result : all_errors)
+	for (auto &one_exc : one_result)
+	  if (seen_exceptions.insert (one_exc).second)
+	    exception_print (gdb_stderr, one_exc);
+
+      dwarf2_predemangle_linkage_names (per_objfile, to_expand);
+
+      process_queue (per_objfile);
+    }
+
+    per_objfile->age_comp_units ();
+    process_cu_includes (per_objfile);
+  }
+
+  if (expansion_notify != nullptr)
+    for (dwarf2_per_cu_data *per_cu : to_expand)
+      {
+	compunit_symtab *symtab = per_objfile->get_symtab (per_cu);
+	if (symtab != nullptr && !expansion_notify (symtab))
+	  return false;
+      }
+
+  return true;
+}
+
 /* See read.h.  */
 
 void
@@ -3221,6 +3710,33 @@ dwarf2_base_index_functions::find_pc_sect_compunit_symtab
   return result;
 }
 
+void
+dwarf2_base_index_functions::expand_symtabs_for_pcs
+     (struct objfile *objfile, gdb::array_view<const CORE_ADDR> pcs)
+{
+  dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+  CORE_ADDR baseaddr = objfile->text_section_offset ();
+
+  /* Map the PCs to their CUs, dropping duplicates and CUs that are
+     already expanded; backtraces yield many PCs per CU, so the batch
+     is usually much smaller than PCS.  */
+  std::vector<dwarf2_per_cu_data *> to_expand;
+  for (CORE_ADDR pc : pcs)
+    {
+      dwarf2_per_cu_data *data = find_per_cu (per_objfile->per_bfd,
+					      pc - baseaddr);
+      if (data == nullptr || per_objfile->symtab_set_p (data))
+	continue;
+
+      if (std::find (to_expand.begin (), to_expand.end (), data)
+	  == to_expand.end ())
+	to_expand.push_back (data);
+    }
+
+  if (!to_expand.empty ())
+    dw2_expand_symtabs_batch (per_objfile, std::move (to_expand), nullptr);
+}
+
 void
 dwarf2_base_index_functions::map_symbol_filenames
      (struct objfile *objfile,
@@ -3229,6 +3745,17 @@ dwarf2_base_index_functions::map_symbol_filenames
 {
   dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
 
+  /* Serve repeat calls from the cached table; see read.h.  */
+  if (need_fullname && per_objfile->mapped_filenames_cache_valid)
+    {
+      for (const auto &f : per_objfile->mapped_filenames_cache)
+	fun (f.first, f.second);
+      return;
+    }
+
+  if (need_fullname)
+    per_objfile->mapped_filenames_cache.clear ();
+
   /* Use caches to ensure we only call FUN once for each filename.  */
   filename_seen_cache filenames_cache;
   std::unordered_set<quick_file_names *> qfn_cache;
@@ -3271,7 +3798,12 @@ dwarf2_base_index_functions::map_symbol_filenames
 	    }
 
 	  if (!filenames_cache.seen (key))
-	    fun (filename, fullname);
+	    {
+	      if (need_fullname)
+		per_objfile->mapped_filenames_cache.emplace_back
+		  (filename, fullname);
+	      fun (filename, fullname);
+	    }
 	}
 
       quick_file_names *file_data = dw2_get_file_names (per_cu, per_objfile);
@@ -3292,9 +3824,17 @@ dwarf2_base_index_functions::map_symbol_filenames
 	    }
 
 	  if (!filenames_cache.seen (key))
-	    fun (filename, fullname);
+	    {
+	      if (need_fullname)
+		per_objfile->mapped_filenames_cache.emplace_back
+		  (filename, fullname);
+	      fun (filename, fullname);
+	    }
 	}
     }
+
+  if (need_fullname)
+    per_objfile->mapped_filenames_cache_valid = true;
 }
 
 bool
@@ -3377,6 +3917,63 @@ get_gdb_index_contents_from_cache_dwz (objfile *obj, dwz_file *dwz)
   return global_index_cache.lookup_gdb_index (build_id, &dwz->index_cache_res);
 }
 
+/* Try to load a serialized cooked index from the index cache.  On
+   success, install it as PER_OBJFILE's index table and return true.
+   A hit here is cheaper than a .gdb_index hit, because the entries
+   are stored in their finalized form and no re-indexing is needed.  */
+
+static bool
+dwarf2_read_cooked_index_cache (dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  const bfd_build_id *build_id = build_id_bfd_get (per_bfd->obfd);
+  if (build_id == nullptr)
+    return false;
+
+  gdb::array_view<const gdb_byte> contents
+    = global_index_cache.lookup_cooked_index (build_id,
+					      &per_bfd->index_cache_res);
+  if (contents.empty ())
+    return false;
+
+  /* The serialized entries refer to CUs by their position in the unit
+     list, so this must be recreated first.  */
+  create_all_units (per_objfile);
+
+  std::unique_ptr<cooked_index> idx
+    = cooked_index::read_cache (per_objfile, contents);
+  if (idx == nullptr)
+    {
+      /* The cache file is stale or invalid.  Undo create_all_units so
+	 that the normal scan can recreate the unit list.  */
+      per_bfd->all_units.clear ();
+      finalize_all_units (per_bfd);
+      per_bfd->signatured_types.reset ();
+      per_bfd->index_cache_res.reset ();
+      return false;
+    }
+
+  per_bfd->quick_file_names_table
+    = create_quick_file_names_table (per_bfd->all_units.size ());
+
+  cooked_index *vec = idx.get ();
+  per_bfd->index_table = std::move (idx);
+
+  /* This mirrors what dwarf2_build_psymtabs_hard does after
+     indexing.  */
+  const cooked_index_entry *main_entry = vec->get_main ();
+  if (main_entry != nullptr)
+    {
+      enum language lang = main_entry->per_cu->lang ();
+      gdb_assert (!language_requires_canonicalization (lang));
+      const char *full_name = main_entry->full_name (&per_bfd->obstack, true);
+      set_objfile_main_name (per_objfile->objfile, full_name, lang);
+    }
+
+  return true;
+}
+
 static quick_symbol_functions_up make_cooked_index_funcs ();
 
 /* See dwarf2/public.h.  */
@@ -3431,7 +4028,17 @@ dwarf2_initialize_objfile (struct objfile *objfile)
       return;
     }
 
-  /* ... otherwise, try to find the index in the index cache.  */
+  /* ... otherwise, try to find a serialized cooked index in the index
+     cache.  */
+  if (dwarf2_read_cooked_index_cache (per_objfile))
+    {
+      dwarf_read_debug_printf ("found cooked index from cache");
+      global_index_cache.hit ();
+      objfile->qf.push_front (per_bfd->index_table->make_quick_functions ());
+      return;
+    }
+
+  /* ... or a .gdb_index file in the index cache.  */
   if (dwarf2_read_gdb_index (per_objfile,
 			     get_gdb_index_contents_from_cache,
 			     get_gdb_index_contents_from_cache_dwz))
@@ -7155,12 +7762,17 @@ dwarf2_physname (const char *name, struct die_info *die, struct dwarf2_cu *cu)
 	     to look up their definition from their declaration so
 	     the only disadvantage remains the minimal symbol variant
 	     `long name(params)' does not have the proper inferior type.  */
-	  demangled = gdb_demangle (mangled, (DMGL_PARAMS | DMGL_ANSI
-					      | DMGL_RET_DROP));
+	  const auto cached
+	    = cu->per_objfile->demangled_physnames.find (mangled);
+	  if (cached != cu->per_objfile->demangled_physnames.end ())
+	    canon = cached->second.get ();
+	  else
+	    demangled = gdb_demangle (mangled, (DMGL_PARAMS | DMGL_ANSI
+						| DMGL_RET_DROP));
 	}
       if (demangled)
 	canon = demangled.get ();
-      else
+      if (canon == NULL)
 	{
 	  canon = mangled;
 	  need_copy = 0;
@@ -7703,7 +8315,7 @@ read_file_scope (struct die_info *die, struct dwarf2_cu *cu)
       if (dwarf2_attr (die, DW_AT_macro_info, cu))
 	complaint (_("CU refers to both DW_AT_macros and DW_AT_macro_info"));
 
-      dwarf_decode_macros (cu, attr->as_unsigned (), 1);
+      dwarf_defer_macros (cu, attr->as_unsigned (), 1);
     }
   else
     {
@@ -7712,7 +8324,7 @@ read_file_scope (struct die_info *die, struct dwarf2_cu *cu)
 	{
 	  unsigned int macro_offset = attr->as_unsigned ();
 
-	  dwarf_decode_macros (cu, macro_offset, 0);
+	  dwarf_defer_macros (cu, macro_offset, 0);
 	}
     }
 }
@@ -15332,6 +15944,40 @@ read_base_type (struct die_info *die, struct dwarf2_cu *cu)
 	}
     }
 
+  /* Nearly every CU defines the same few base types, so one instance
+     per objfile is kept and shared whenever the type is a pure
+     function of the intern key.  A DIE carrying an attribute that
+     influences construction beyond the key, or that would make
+     set_die_type attach a dynamic property to the shared instance,
+     keeps getting a private type as before, as do the encodings
+     whose construction consults more than the key (fixed-point,
+     complex, and the DW_ATE_address pointer).  */
+  bool internable
+    = ((encoding == DW_ATE_boolean
+	|| encoding == DW_ATE_float
+	|| encoding == DW_ATE_decimal_float
+	|| encoding == DW_ATE_signed
+	|| encoding == DW_ATE_unsigned
+	|| encoding == DW_ATE_signed_char
+	|| encoding == DW_ATE_unsigned_char)
+       && bits != 0
+       && dwarf2_attr (die, DW_AT_alignment, cu) == nullptr
+       && dwarf2_attr (die, DW_AT_bit_size, cu) == nullptr
+       && dwarf2_attr (die, DW_AT_data_bit_offset, cu) == nullptr
+       && dwarf2_attr (die, DW_AT_allocated, cu) == nullptr
+       && dwarf2_attr (die, DW_AT_associated, cu) == nullptr
+       && dwarf2_attr (die, DW_AT_rank, cu) == nullptr
+       && dwarf2_attr (die, DW_AT_data_location, cu) == nullptr);
+
+  base_type_intern_key intern_key {encoding, bits, name, byte_order,
+				   cu->lang ()};
+  if (internable)
+    {
+      auto it = cu->per_objfile->base_type_intern.find (intern_key);
+      if (it != cu->per_objfile->base_type_intern.end ())
+	return set_die_type (die, it->second, cu);
+    }
+
   type_allocator alloc (objfile, cu->lang ());
   switch (encoding)
     {
@@ -15453,6 +16099,9 @@ read_base_type (struct die_info *die, struct dwarf2_cu *cu)
 	}
     }
 
+  if (internable)
+    cu->per_objfile->base_type_intern.emplace (intern_key, type);
+
   return set_die_type (die, type, cu);
 }
 
@@ -16867,6 +17516,18 @@ cooked_index_functions::expand_symtabs_matching
 
   dw_expand_symtabs_matching_file_matcher (per_objfile, file_matcher);
 
+  /* When parallel expansion is enabled, matching CUs are collected
+     first and then expanded as one batch.  */
+  std::vector<dwarf2_per_cu_data *> to_expand;
+  std::unordered_set<dwarf2_per_cu_data *> seen_cus;
+
+  auto collect_one = [&] (dwarf2_per_cu_data *per_cu)
+    {
+      if ((file_matcher == nullptr || per_cu->mark)
+	  && seen_cus.insert (per_cu).second)
+	to_expand.push_back (per_cu);
+    };
+
   /* This invariant is documented in quick-functions.h.  */
   gdb_assert (lookup_name != nullptr || symbol_matcher == nullptr);
   if (lookup_name == nullptr)
@@ -16876,11 +17537,17 @@ cooked_index_functions::expand_symtabs_matching
 	{
 	  QUIT;
 
-	  if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
+	  if (dwarf_parallel_expansion)
+	    collect_one (per_cu);
+	  else if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
+						     file_matcher,
+						     expansion_notify))
 	    return false;
 	}
+
+      if (dwarf_parallel_expansion)
+	return dw2_expand_symtabs_batch (per_objfile, std::move (to_expand),
+					 expansion_notify);
       return true;
     }
 
@@ -16970,13 +17637,20 @@ cooked_index_functions::expand_symtabs_matching
 		continue;
 	    }
 
-	  if (!dw2_expand_symtabs_matching_one (entry->per_cu, per_objfile,
-						file_matcher,
-						expansion_notify))
+	  if (dwarf_parallel_expansion)
+	    collect_one (entry->per_cu);
+	  else if (!dw2_expand_symtabs_matching_one (entry->per_cu,
+						     per_objfile,
+						     file_matcher,
+						     expansion_notify))
 	    return false;
 	}
     }
 
+  if (dwarf_parallel_expansion)
+    return dw2_expand_symtabs_batch (per_objfile, std::move (to_expand),
+				     expansion_notify);
+
   return true;
 }
 
@@ -18121,32 +18795,40 @@ compute_include_file_name (const struct line_header *lh, const file_entry &fe,
   return include_name;
 }
 
-/* State machine to track the state of the line number program.  */
+/* State machine to track the state of the line number program.  The
+   machine only tracks the registers defined by DWARF and emits
+   line_program_events; everything that involves the CU being
+   expanded happens later, in replay_line_program.  */
 
 class lnp_state_machine
 {
 public:
   /* Initialize a machine state for the start of a line number
-     program.  */
-  lnp_state_machine (struct dwarf2_cu *cu, gdbarch *arch, line_header *lh);
-
-  file_entry *current_file ()
-  {
-    /* lh->file_names is 0-based, but the file name numbers in the
-       statement program are 1-based.  */
-    return m_line_header->file_name_at (m_file);
-  }
+     program, emitting events into EVENTS.  */
+  lnp_state_machine (gdbarch *arch, line_header *lh,
+		     std::vector<line_program_event> *events);
 
   /* Record the line in the state machine.  END_SEQUENCE is true if
      we're processing the end of a sequence.  */
   void record_line (bool end_sequence);
 
-  /* Check ADDRESS is -1, or zero and less than UNRELOCATED_LOWPC, and if true
-     nop-out rest of the lines in this sequence.  */
-  void check_line_address (struct dwarf2_cu *cu,
-			   const gdb_byte *line_ptr,
-			   unrelocated_addr unrelocated_lowpc,
-			   unrelocated_addr address);
+  /* ADDRESS was just given to DW_LNE_set_address, and LINE_OFFSET is
+     the offset of the following opcode in the line section.  If
+     ADDRESS is 0 or -1, it may belong to a function discarded by the
+     linker; emit an event so that replay can decide whether to
+     nop-out the rest of the lines in this sequence.  */
+  void check_line_address (unsigned long line_offset,
+			   unrelocated_addr address)
+  {
+    if (address == (unrelocated_addr) 0 || address == (unrelocated_addr) -1)
+      {
+	line_program_event ev {};
+	ev.kind = line_program_event::LP_BAD_ADDRESS;
+	ev.address = address;
+	ev.misc = line_offset;
+	m_events->push_back (ev);
+      }
+  }
 
   void handle_set_discriminator (unsigned int discriminator)
   {
@@ -18213,7 +18895,15 @@ public:
   /* Handle DW_LNE_end_sequence.  */
   void handle_end_sequence ()
   {
-    m_currently_recording_lines = true;
+    m_saw_end_sequence = true;
+  }
+
+  /* Emit an event marking the start of a new sequence.  */
+  void start_sequence ()
+  {
+    line_program_event ev {};
+    ev.kind = line_program_event::LP_START_SEQUENCE;
+    m_events->push_back (ev);
   }
 
   /* Handle DW_LNS_set_prologue_end.  */
@@ -18232,13 +18922,14 @@ private:
       m_line_has_non_zero_discriminator = m_discriminator != 0;
   }
 
-  struct dwarf2_cu *m_cu;
-
   gdbarch *m_gdbarch;
 
   /* The line number header.  */
   line_header *m_line_header;
 
+  /* Where decoded events are emitted.  */
+  std::vector<line_program_event> *m_events;
+
   /* These are part of the standard DWARF line number state machine,
      and initialized according to the DWARF spec.  */
 
@@ -18256,29 +18947,10 @@ private:
 
   /* Additional bits of state we need to track.  */
 
-  /* The last file that we called dwarf2_start_subfile for.
-     This is only used for TLLs.  */
-  unsigned int m_last_file = 0;
-  /* The last file a line number was recorded for.  */
-  struct subfile *m_last_subfile = NULL;
-
-  /* The address of the last line entry.  */
-  unrelocated_addr m_last_address;
-
-  /* Set to true when a previous line at the same address (using
-     m_last_address) had LEF_IS_STMT set in m_flags.  This is reset to false
-     when a line entry at a new address (m_address different to
-     m_last_address) is processed.  */
-  bool m_stmt_at_address = false;
+  /* True if an explicit DW_LNE_end_sequence was seen for the current
+     sequence, as opposed to running off the end of the section.  */
+  bool m_saw_end_sequence = false;
 
-  /* When true, record the lines we decode.  */
-  bool m_currently_recording_lines = true;
-
-  /* The last line and column numbers that were recorded, used to coalesce
-     consecutive entries for the same line/column.  This can happen, for
-     example, when discriminators are present.  PR 17276.  */
-  unsigned int m_last_line = 0;
-  unsigned int m_last_column = 0;
   bool m_line_has_non_zero_discriminator = false;
 };
 
@@ -18319,16 +18991,12 @@ void
 lnp_state_machine::handle_set_file (file_name_index file)
 {
   m_file = file;
+  m_line_has_non_zero_discriminator = m_discriminator != 0;
 
-  const file_entry *fe = current_file ();
-  if (fe == NULL)
-    dwarf2_debug_line_missing_file_complaint ();
-  else
-    {
-      m_last_subfile = m_cu->get_builder ()->get_current_subfile ();
-      m_line_has_non_zero_discriminator = m_discriminator != 0;
-      dwarf2_start_subfile (m_cu, *fe, *m_line_header);
-    }
+  line_program_event ev {};
+  ev.kind = line_program_event::LP_SET_FILE;
+  ev.file = file;
+  m_events->push_back (ev);
 }
 
 void
@@ -18451,140 +19119,44 @@ dwarf_finish_line (struct gdbarch *gdbarch, struct subfile *subfile,
 void
 lnp_state_machine::record_line (bool end_sequence)
 {
-  if (dwarf_line_debug)
-    {
-      gdb_printf (gdb_stdlog,
-		  "Processing actual line %u: file %u,"
-		  " address %s, is_stmt %u, prologue_end %u, discrim %u%s\n",
-		  m_line, m_file,
-		  paddress (m_gdbarch, (CORE_ADDR) m_address),
-		  (m_flags & LEF_IS_STMT) != 0,
-		  (m_flags & LEF_PROLOGUE_END) != 0,
-		  m_discriminator,
-		  (end_sequence ? "\t(end sequence)" : ""));
-    }
-
-  file_entry *fe = current_file ();
-
-  if (fe == NULL)
-    dwarf2_debug_line_missing_file_complaint ();
-  /* For now we ignore lines not starting on an instruction boundary.
-     But not when processing end_sequence for compatibility with the
-     previous version of the code.  */
-  else if (m_op_index == 0 || end_sequence)
-    {
-      /* When we switch files we insert an end maker in the first file,
-	 switch to the second file and add a new line entry.  The
-	 problem is that the end marker inserted in the first file will
-	 discard any previous line entries at the same address.  If the
-	 line entries in the first file are marked as is-stmt, while
-	 the new line in the second file is non-stmt, then this means
-	 the end marker will discard is-stmt lines so we can have a
-	 non-stmt line.  This means that there are less addresses at
-	 which the user can insert a breakpoint.
-
-	 To improve this we track the last address in m_last_address,
-	 and whether we have seen an is-stmt at this address.  Then
-	 when switching files, if we have seen a stmt at the current
-	 address, and we are switching to create a non-stmt line, then
-	 discard the new line.  */
-      bool file_changed
-	= m_last_subfile != m_cu->get_builder ()->get_current_subfile ();
-      bool ignore_this_line
-	= ((file_changed && !end_sequence && m_last_address == m_address
-	    && ((m_flags & LEF_IS_STMT) == 0)
-	    && m_stmt_at_address)
-	   || (!end_sequence && m_line == 0));
-
-      if ((file_changed && !ignore_this_line) || end_sequence)
-	{
-	  dwarf_finish_line (m_gdbarch, m_last_subfile, m_address,
-			     m_currently_recording_lines ? m_cu : nullptr);
-	}
-
-      if (!end_sequence && !ignore_this_line)
-	{
-	  linetable_entry_flags lte_flags = m_flags;
-	  if (producer_is_codewarrior (m_cu))
-	    lte_flags |= LEF_IS_STMT;
-
-	  if (dwarf_record_line_p (m_cu, m_line, m_last_line,
-				   m_column, m_last_column,
-				   m_line_has_non_zero_discriminator,
-				   m_last_subfile))
-	    {
-	      buildsym_compunit *builder = m_cu->get_builder ();
-	      dwarf_record_line_1 (m_gdbarch,
-				   builder->get_current_subfile (),
-				   m_line, m_column, m_address, lte_flags,
-				   m_currently_recording_lines ? m_cu : nullptr);
-	    }
-	  m_last_subfile = m_cu->get_builder ()->get_current_subfile ();
-	  m_last_line = m_line;
-	  m_last_column = m_column;
-	}
-    }
-
-  /* Track whether we have seen any IS_STMT true at m_address in case we
-     have multiple line table entries all at m_address.  */
-  if (m_last_address != m_address)
-    {
-      m_stmt_at_address = false;
-      m_last_address = m_address;
-    }
-  m_stmt_at_address |= (m_flags & LEF_IS_STMT) != 0;
-}
-
-lnp_state_machine::lnp_state_machine (struct dwarf2_cu *cu, gdbarch *arch,
-				      line_header *lh)
-  : m_cu (cu),
-    m_gdbarch (arch),
+  line_program_event ev {};
+  ev.kind = line_program_event::LP_ROW;
+  ev.end_sequence = end_sequence;
+  ev.resume_recording = end_sequence && m_saw_end_sequence;
+  ev.op_index_is_zero = m_op_index == 0;
+  ev.line_has_non_zero_discriminator = m_line_has_non_zero_discriminator;
+  ev.flags = m_flags;
+  ev.file = m_file;
+  ev.line = m_line;
+  ev.column = m_column;
+  ev.discriminator = m_discriminator;
+  ev.address = m_address;
+  m_events->push_back (ev);
+}
+
+lnp_state_machine::lnp_state_machine (gdbarch *arch, line_header *lh,
+				      std::vector<line_program_event> *events)
+  : m_gdbarch (arch),
     m_line_header (lh),
+    m_events (events),
     /* Call `gdbarch_adjust_dwarf2_line' on the initial 0 address as
        if there was a line entry for it so that the backend has a
        chance to adjust it and also record it in case it needs it.
        This is currently used by MIPS code,
        cf. `mips_adjust_dwarf2_line'.  */
     m_address ((unrelocated_addr) gdbarch_adjust_dwarf2_line (arch, 0, 0)),
-    m_flags (lh->default_is_stmt ? LEF_IS_STMT : (linetable_entry_flags) 0),
-    m_last_address (m_address)
+    m_flags (lh->default_is_stmt ? LEF_IS_STMT : (linetable_entry_flags) 0)
 {
+  start_sequence ();
 }
 
-void
-lnp_state_machine::check_line_address (struct dwarf2_cu *cu,
-				       const gdb_byte *line_ptr,
-				       unrelocated_addr unrelocated_lowpc,
-				       unrelocated_addr address)
-{
-  /* Linkers resolve a symbolic relocation referencing a GC'd function to 0 or
-     -1.  If ADDRESS is 0, ignoring the opcode will err if the text section is
-     located at 0x0.  In this case, additionally check that if
-     ADDRESS < UNRELOCATED_LOWPC.  */
-
-  if ((address == (unrelocated_addr) 0 && address < unrelocated_lowpc)
-      || address == (unrelocated_addr) -1)
-    {
-      /* This line table is for a function which has been
-	 GCd by the linker.  Ignore it.  PR gdb/12528 */
-
-      struct objfile *objfile = cu->per_objfile->objfile;
-      long line_offset = line_ptr - get_debug_line_section (cu)->buffer;
-
-      complaint (_(".debug_line address at offset 0x%lx is 0 [in module %s]"),
-		 line_offset, objfile_name (objfile));
-      m_currently_recording_lines = false;
-      /* Note: m_currently_recording_lines is left as false until we see
-	 DW_LNE_end_sequence.  */
-    }
-}
+/* Subroutine of dwarf_decode_lines to simplify it.  Run the line
+   number program in LH, producing its decoded form.  CU is only used
+   for the address size and the line section; the result is valid for
+   any CU referring to the same program.  */
 
-/* Subroutine of dwarf_decode_lines to simplify it.
-   Process the line number information in LH.  */
-
-static void
-dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
-		      unrelocated_addr lowpc)
+static std::unique_ptr<std::vector<line_program_event>>
+decode_line_program (struct line_header *lh, struct dwarf2_cu *cu)
 {
   const gdb_byte *line_ptr, *extended_end;
   const gdb_byte *line_end;
@@ -18593,6 +19165,9 @@ dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
   struct objfile *objfile = cu->per_objfile->objfile;
   bfd *abfd = objfile->obfd.get ();
   struct gdbarch *gdbarch = objfile->arch ();
+  const gdb_byte *section_start = get_debug_line_section (cu)->buffer;
+
+  auto events = gdb::make_unique<std::vector<line_program_event>> ();
 
   line_ptr = lh->statement_program_start;
   line_end = lh->statement_program_end;
@@ -18602,16 +19177,9 @@ dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
     {
       /* The DWARF line number program state machine.  Reset the state
 	 machine at the start of each sequence.  */
-      lnp_state_machine state_machine (cu, gdbarch, lh);
+      lnp_state_machine state_machine (gdbarch, lh, events.get ());
       bool end_sequence = false;
 
-      /* Start a subfile for the current file of the state
-	 machine.  */
-      const file_entry *fe = state_machine.current_file ();
-
-      if (fe != NULL)
-	dwarf2_start_subfile (cu, *fe, *lh);
-
       /* Decode the table.  */
       while (line_ptr < line_end && !end_sequence)
 	{
@@ -18651,7 +19219,7 @@ dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
 		      = cu->header.read_address (abfd, line_ptr, &bytes_read);
 		    line_ptr += bytes_read;
 
-		    state_machine.check_line_address (cu, line_ptr, lowpc,
+		    state_machine.check_line_address (line_ptr - section_start,
 						      address);
 		    state_machine.handle_set_address (address);
 		  }
@@ -18674,7 +19242,17 @@ dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
 		    length =
 		      read_unsigned_leb128 (abfd, line_ptr, &bytes_read);
 		    line_ptr += bytes_read;
-		    lh->add_file_name (cur_file, dindex, mod_time, length);
+
+		    /* The file table is per-CU state, so this is
+		       applied to each CU's line header at replay
+		       time.  */
+		    line_program_event ev {};
+		    ev.kind = line_program_event::LP_DEFINE_FILE;
+		    ev.define_file_name = cur_file;
+		    ev.misc = (unsigned long) dindex;
+		    ev.define_file_mod_time = mod_time;
+		    ev.define_file_length = length;
+		    events->push_back (ev);
 		  }
 		  break;
 		case DW_LNE_set_discriminator:
@@ -18694,7 +19272,7 @@ dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
 		  break;
 		default:
 		  complaint (_("mangled .debug_line section"));
-		  return;
+		  return events;
 		}
 	      /* Make sure that we parsed the extended op correctly.  If e.g.
 		 we expected a different address size than the producer used,
@@ -18702,7 +19280,7 @@ dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
 	      if (line_ptr != extended_end)
 		{
 		  complaint (_("mangled .debug_line section"));
-		  return;
+		  return events;
 		}
 	      break;
 	    case DW_LNS_copy:
@@ -18790,6 +19368,231 @@ dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
 	 in which case we still finish recording the last line).  */
       state_machine.record_line (true);
     }
+
+  return events;
+}
+
+/* Subroutine of dwarf_decode_lines to simplify it.  Replay the
+   decoded line program EVENTS into CU's line table.  LOWPC is the
+   lowest address in CU (or 0 if not known), used to tell whether a
+   zero line address belongs to a function discarded by the
+   linker.  */
+
+static void
+replay_line_program (const std::vector<line_program_event> &events,
+		     struct line_header *lh, struct dwarf2_cu *cu,
+		     unrelocated_addr lowpc)
+{
+  struct objfile *objfile = cu->per_objfile->objfile;
+  struct gdbarch *gdbarch = objfile->arch ();
+  unrelocated_addr initial_address
+    = (unrelocated_addr) gdbarch_adjust_dwarf2_line (gdbarch, 0, 0);
+
+  /* The last file a line number was recorded for.  */
+  struct subfile *last_subfile = nullptr;
+
+  /* The last line and column numbers that were recorded, used to
+     coalesce consecutive entries for the same line/column.  This can
+     happen, for example, when discriminators are present.  PR
+     17276.  */
+  unsigned int last_line = 0;
+  unsigned int last_column = 0;
+
+  /* The address of the last line entry, and whether a line with
+     LEF_IS_STMT has been seen at that address.  */
+  unrelocated_addr last_address = initial_address;
+  bool stmt_at_address = false;
+
+  /* When true, record the lines we replay.  */
+  bool currently_recording_lines = true;
+
+  for (const line_program_event &ev : events)
+    {
+      switch (ev.kind)
+	{
+	case line_program_event::LP_START_SEQUENCE:
+	  {
+	    last_subfile = nullptr;
+	    last_line = 0;
+	    last_column = 0;
+	    last_address = initial_address;
+	    stmt_at_address = false;
+	    currently_recording_lines = true;
+
+	    /* Start a subfile for the initial file of the state
+	       machine.  File name numbers in the statement program
+	       are 1-based.  */
+	    const file_entry *fe = lh->file_name_at ((file_name_index) 1);
+	    if (fe != nullptr)
+	      dwarf2_start_subfile (cu, *fe, *lh);
+	  }
+	  break;
+
+	case line_program_event::LP_SET_FILE:
+	  {
+	    const file_entry *fe = lh->file_name_at (ev.file);
+	    if (fe == nullptr)
+	      dwarf2_debug_line_missing_file_complaint ();
+	    else
+	      {
+		last_subfile = cu->get_builder ()->get_current_subfile ();
+		dwarf2_start_subfile (cu, *fe, *lh);
+	      }
+	  }
+	  break;
+
+	case line_program_event::LP_BAD_ADDRESS:
+	  /* Linkers resolve a symbolic relocation referencing a GC'd
+	     function to 0 or -1.  If the address is 0, ignoring the
+	     sequence will err if the text section is located at 0x0.
+	     In this case, additionally check that the address is less
+	     than LOWPC.  */
+	  if ((ev.address == (unrelocated_addr) 0 && ev.address < lowpc)
+	      || ev.address == (unrelocated_addr) -1)
+	    {
+	      /* This line table is for a function which has been
+		 GCd by the linker.  Ignore it.  PR gdb/12528 */
+	      complaint (_(".debug_line address at offset 0x%lx is 0"
+			   " [in module %s]"),
+			 ev.misc, objfile_name (objfile));
+	      /* Note: CURRENTLY_RECORDING_LINES is left as false
+		 until the end of the sequence.  */
+	      currently_recording_lines = false;
+	    }
+	  break;
+
+	case line_program_event::LP_DEFINE_FILE:
+	  lh->add_file_name (ev.define_file_name, (dir_index) ev.misc,
+			     ev.define_file_mod_time, ev.define_file_length);
+	  break;
+
+	case line_program_event::LP_ROW:
+	  {
+	    /* An explicit DW_LNE_end_sequence re-enables recording
+	       before its row is processed.  */
+	    if (ev.resume_recording)
+	      currently_recording_lines = true;
+
+	    if (dwarf_line_debug)
+	      {
+		gdb_printf (gdb_stdlog,
+			    "Processing actual line %u: file %u,"
+			    " address %s, is_stmt %u, prologue_end %u,"
+			    " discrim %u%s\n",
+			    ev.line, ev.file,
+			    paddress (gdbarch, (CORE_ADDR) ev.address),
+			    (ev.flags & LEF_IS_STMT) != 0,
+			    (ev.flags & LEF_PROLOGUE_END) != 0,
+			    ev.discriminator,
+			    (ev.end_sequence ? "\t(end sequence)" : ""));
+	      }
+
+	    const file_entry *fe = lh->file_name_at (ev.file);
+
+	    if (fe == nullptr)
+	      dwarf2_debug_line_missing_file_complaint ();
+	    /* For now we ignore lines not starting on an instruction
+	       boundary.  But not when processing end_sequence for
+	       compatibility with the previous version of the code.  */
+	    else if (ev.op_index_is_zero || ev.end_sequence)
+	      {
+		/* When we switch files we insert an end maker in the
+		   first file, switch to the second file and add a new
+		   line entry.  The problem is that the end marker
+		   inserted in the first file will discard any
+		   previous line entries at the same address.  If the
+		   line entries in the first file are marked as
+		   is-stmt, while the new line in the second file is
+		   non-stmt, then this means the end marker will
+		   discard is-stmt lines so we can have a non-stmt
+		   line.  This means that there are less addresses at
+		   which the user can insert a breakpoint.
+
+		   To improve this we track the last address in
+		   LAST_ADDRESS, and whether we have seen an is-stmt
+		   at this address.  Then when switching files, if we
+		   have seen a stmt at the current address, and we are
+		   switching to create a non-stmt line, then discard
+		   the new line.  */
+		bool file_changed
+		  = last_subfile != cu->get_builder ()->get_current_subfile ();
+		bool ignore_this_line
+		  = ((file_changed && !ev.end_sequence
+		      && last_address == ev.address
+		      && ((ev.flags & LEF_IS_STMT) == 0)
+		      && stmt_at_address)
+		     || (!ev.end_sequence && ev.line == 0));
+
+		if ((file_changed && !ignore_this_line) || ev.end_sequence)
+		  {
+		    dwarf_finish_line (gdbarch, last_subfile, ev.address,
+				       currently_recording_lines
+				       ? cu : nullptr);
+		  }
+
+		if (!ev.end_sequence && !ignore_this_line)
+		  {
+		    linetable_entry_flags lte_flags = ev.flags;
+		    if (producer_is_codewarrior (cu))
+		      lte_flags |= LEF_IS_STMT;
+
+		    if (dwarf_record_line_p (cu, ev.line, last_line,
+					     ev.column, last_column,
+					     ev.line_has_non_zero_discriminator,
+					     last_subfile))
+		      {
+			buildsym_compunit *builder = cu->get_builder ();
+			dwarf_record_line_1 (gdbarch,
+					     builder->get_current_subfile (),
+					     ev.line, ev.column, ev.address,
+					     lte_flags,
+					     currently_recording_lines
+					     ? cu : nullptr);
+		      }
+		    last_subfile
+		      = cu->get_builder ()->get_current_subfile ();
+		    last_line = ev.line;
+		    last_column = ev.column;
+		  }
+	      }
+
+	    /* Track whether we have seen any LEF_IS_STMT at this
+	       address in case there are multiple line table entries
+	       all at this address.  */
+	    if (last_address != ev.address)
+	      {
+		stmt_at_address = false;
+		last_address = ev.address;
+	      }
+	    stmt_at_address |= (ev.flags & LEF_IS_STMT) != 0;
+	  }
+	  break;
+	}
+    }
+}
+
+/* Subroutine of dwarf_decode_lines to simplify it.  Process the line
+   number information in LH, decoding the line program at most once
+   per objfile and replaying the cached result into CU.  */
+
+static void
+dwarf_decode_lines_1 (struct line_header *lh, struct dwarf2_cu *cu,
+		      unrelocated_addr lowpc)
+{
+  dwarf2_per_bfd *per_bfd = cu->per_objfile->per_bfd;
+
+  line_program_cache_key key;
+  key.section_key = (to_underlying (lh->sect_off)
+		     | ((uint64_t) cu->header.addr_size << 48)
+		     | (lh->offset_in_dwz ? (uint64_t) 1 << 63 : 0));
+  key.arch = cu->per_objfile->objfile->arch ();
+
+  auto it = per_bfd->line_program_cache.find (key);
+  if (it == per_bfd->line_program_cache.end ())
+    it = (per_bfd->line_program_cache
+	  .emplace (key, decode_line_program (lh, cu)).first);
+
+  replay_line_program (*it->second, lh, cu, lowpc);
 }
 
 /* Decode the Line Number Program (LNP) for the given line_header
@@ -21379,12 +22182,55 @@ dwarf_alloc_block (struct dwarf2_cu *cu)
 
 /* Macro support.  */
 
-/* An overload of dwarf_decode_macros that finds the correct section
-   and ensures it is read in before calling the other overload.  */
+/* Compute the macro table for CUST from macro information whose
+   reading was deferred by dwarf_defer_macros.  DATUM is the
+   dwarf2_per_objfile of CUST's objfile.  This is installed on the
+   compunit_symtab with set_lazy_macro_table and so is only called the
+   first time the macro table is actually requested.  */
+
+static struct macro_table *
+dwarf2_read_deferred_macros (compunit_symtab *cust, void *datum)
+{
+  dwarf2_per_objfile *per_objfile = (dwarf2_per_objfile *) datum;
+
+  auto it = per_objfile->deferred_macros.find (cust);
+  if (it == per_objfile->deferred_macros.end ())
+    return nullptr;
+
+  deferred_macro_info info = std::move (it->second);
+  per_objfile->deferred_macros.erase (it);
+
+  /* Create the macro table lazily, the same way buildsym_compunit
+     does: macro data that never mentions a file yields no table at
+     all.  */
+  struct objfile *objfile = per_objfile->objfile;
+  struct macro_table *table = nullptr;
+  auto get_macro_table = [&] () -> macro_table *
+    {
+      if (table == nullptr)
+	table = new_macro_table (&objfile->per_bfd->storage_obstack,
+				 &objfile->per_bfd->string_cache, cust);
+      return table;
+    };
+
+  dwarf_decode_macros (per_objfile, get_macro_table, info.section,
+		       info.lh.get (), info.offset_size, info.offset,
+		       info.str_section, info.str_offsets_section,
+		       info.str_offsets_base, info.section_is_gnu,
+		       info.producer_is_clang);
+
+  return table;
+}
+
+/* Record everything needed to read the macro information of CU at
+   OFFSET later on, and arrange for the actual reading to happen the
+   first time the macro table of CU's compunit_symtab is requested.
+   Decoding macro data is expensive and the result is rarely used, so
+   it is not worth paying for it during CU expansion.  */
 
 static void
-dwarf_decode_macros (struct dwarf2_cu *cu, unsigned int offset,
-		     int section_is_gnu)
+dwarf_defer_macros (struct dwarf2_cu *cu, unsigned int offset,
+		    int section_is_gnu)
 {
   dwarf2_per_objfile *per_objfile = cu->per_objfile;
   struct objfile *objfile = per_objfile->objfile;
@@ -21427,8 +22273,6 @@ dwarf_decode_macros (struct dwarf2_cu *cu, unsigned int offset,
       return;
     }
 
-  buildsym_compunit *builder = cu->get_builder ();
-
   struct dwarf2_section_info *str_offsets_section;
   struct dwarf2_section_info *str_section;
   gdb::optional<ULONGEST> str_offsets_base;
@@ -21447,9 +22291,21 @@ dwarf_decode_macros (struct dwarf2_cu *cu, unsigned int offset,
       str_offsets_base = cu->str_offsets_base;
     }
 
-  dwarf_decode_macros (per_objfile, builder, section, lh,
-		       offset_size, offset, str_section, str_offsets_section,
-		       str_offsets_base, section_is_gnu, cu);
+  compunit_symtab *cust = cu->get_builder ()->get_compunit_symtab ();
+  deferred_macro_info &info = per_objfile->deferred_macros[cust];
+  info.section = section;
+  info.str_section = str_section;
+  info.str_offsets_section = str_offsets_section;
+  info.str_offsets_base = str_offsets_base;
+  /* The CU's line header does not survive past the expansion of the
+     CU, so keep a copy.  */
+  info.lh = lh->clone ();
+  info.offset = offset;
+  info.offset_size = offset_size;
+  info.section_is_gnu = section_is_gnu;
+  info.producer_is_clang = producer_is_clang (cu);
+
+  cust->set_lazy_macro_table (dwarf2_read_deferred_macros, per_objfile);
 }
 
 /* Return the .debug_loc section to use for CU.
@@ -21522,6 +22378,7 @@ fill_in_loclist_baton (struct dwarf2_cu *cu,
   else
     baton->base_address = {};
   baton->from_dwo = cu->dwo_unit != NULL;
+  baton->cache_valid = false;
 }
 
 static void
@@ -21812,11 +22669,22 @@ prepare_one_comp_unit (struct dwarf2_cu *cu, struct die_info *comp_unit_die,
   cu->per_cu->set_lang (lang);
 }
 
+#if CXX_STD_THREAD
+/* Serializes access to m_dwarf2_cus, which worker threads modify
+   while DIE trees are being loaded in parallel (see
+   dw2_expand_symtabs_batch).  */
+static std::mutex dwarf2_cus_lock;
+#endif
+
 /* See read.h.  */
 
 dwarf2_cu *
 dwarf2_per_objfile::get_cu (dwarf2_per_cu_data *per_cu)
 {
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (dwarf2_cus_lock);
+#endif
+
   auto it = m_dwarf2_cus.find (per_cu);
   if (it == m_dwarf2_cus.end ())
     return nullptr;
@@ -21830,7 +22698,11 @@ void
 dwarf2_per_objfile::set_cu (dwarf2_per_cu_data *per_cu,
 			    std::unique_ptr<dwarf2_cu> cu)
 {
-  gdb_assert (this->get_cu (per_cu) == nullptr);
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (dwarf2_cus_lock);
+#endif
+
+  gdb_assert (m_dwarf2_cus.find (per_cu) == m_dwarf2_cus.end ());
 
   m_dwarf2_cus[per_cu] = std::move (cu);
 }
@@ -21885,6 +22757,10 @@ dwarf2_per_objfile::age_comp_units ()
 void
 dwarf2_per_objfile::remove_cu (dwarf2_per_cu_data *per_cu)
 {
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (dwarf2_cus_lock);
+#endif
+
   auto it = m_dwarf2_cus.find (per_cu);
   if (it == m_dwarf2_cus.end ())
     return;
@@ -22114,6 +22990,39 @@ caching, which can slow down startup."),
 			    &set_dwarf_cmdlist,
 			    &show_dwarf_cmdlist);
 
+  add_setshow_boolean_cmd ("parallel-expansion", class_obscure,
+			   &dwarf_parallel_expansion, _("\
+Set whether symtab expansion loads compilation units in parallel."), _("\
+Show whether symtab expansion loads compilation units in parallel."), _("\
+When enabled, commands that expand many symtabs at once (such as\n\
+\"rbreak\") load the debug info of the matching compilation units on\n\
+worker threads before building their symbol tables."),
+			   NULL,
+			   show_dwarf_parallel_expansion,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  add_setshow_boolean_cmd ("background-expansion", class_obscure,
+			   &dwarf_background_expansion, _("\
+Set whether likely-needed compilation units are expanded in the background."),
+			   _("\
+Show whether likely-needed compilation units are expanded in the background."),
+			   _("\
+When enabled, each stop of the inferior queues the compilation units\n\
+around the stop PC and the one containing \"main\" for expansion.  The\n\
+queue is drained one compilation unit per event-loop pass while GDB is\n\
+otherwise idle, hiding most of the expansion latency of a later first\n\
+use of those source files."),
+			   NULL,
+			   show_dwarf_background_expansion,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  gdb::observers::normal_stop.attach (background_expand_on_normal_stop,
+				      "dwarf2-background-expand");
+  gdb::observers::free_objfile.attach (background_expand_free_objfile,
+				       "dwarf2-background-expand");
+
   add_setshow_zuinteger_cmd ("dwarf-read", no_class, &dwarf_read_debug, _("\
 Set debugging of the DWARF reader."), _("\
 Show debugging of the DWARF reader."), _("\
@@ -26,6 +26,7 @@
 #include "dwarf2/cooked-index.h"
 #include "dwarf2/file-and-dir.h"
 #include "dwarf2/index-cache.h"
+#include "dwarf2/line-header.h"
 #include "dwarf2/mapped-index.h"
 #include "dwarf2/section.h"
 #include "dwarf2/cu.h"
@@ -410,6 +411,38 @@ struct signatured_type : public dwarf2_per_cu_data
 
 using signatured_type_up = std::unique_ptr<signatured_type>;
 
+/* One event of a decoded .debug_line program; see read.c.  */
+struct line_program_event;
+
+/* Key for dwarf2_per_bfd::line_program_cache.  A decoded line program
+   is identified by its section offset (plus whether it comes from the
+   dwz file and the address size used to read DW_LNE_set_address, both
+   folded into SECTION_KEY), but its decoded form also depends on the
+   architecture's line adjustment hook, so the arch participates as
+   well.  */
+
+struct line_program_cache_key
+{
+  uint64_t section_key;
+  struct gdbarch *arch;
+
+  bool operator== (const line_program_cache_key &other) const
+  {
+    return section_key == other.section_key && arch == other.arch;
+  }
+};
+
+/* Hash function object for line_program_cache_key.  */
+
+struct line_program_cache_key_hash
+{
+  size_t operator() (const line_program_cache_key &key) const
+  {
+    return (std::hash<uint64_t> () (key.section_key)
+	    ^ std::hash<void *> () (key.arch));
+  }
+};
+
 /* Some DWARF data can be shared across objfiles who share the same BFD,
    this data is stored in this object.
 
@@ -556,6 +589,18 @@ public:
 
   /* The address map that is used by the DWARF index code.  */
   struct addrmap *index_addrmap = nullptr;
+
+  /* Cache of decoded .debug_line programs.  Running the line-number
+     state machine is one of the more expensive steps of CU expansion,
+     and its output does not depend on the CU being expanded, so the
+     decoded events are kept here and replayed into every CU that
+     refers to the same line program -- and, since this structure
+     survives objfile reloads, into every reload of an unchanged
+     objfile.  */
+  std::unordered_map<line_program_cache_key,
+		     std::unique_ptr<std::vector<line_program_event>>,
+		     line_program_cache_key_hash>
+    line_program_cache;
 };
 
 /* An iterator for all_units that is based on index.  This
@@ -649,6 +694,95 @@ struct type_unit_group_unshareable
   struct symtab **symtabs = nullptr;
 };
 
+/* Macro information for one CU, as recorded when the CU was expanded.
+   Reading the macro data itself is deferred until a macro table is
+   first requested for the CU's compunit_symtab; see
+   dwarf_defer_macros and dwarf2_read_deferred_macros in read.c.  */
+
+struct deferred_macro_info
+{
+  /* The section holding the macro data, and the string sections
+     needed to decode it.  These are owned by the per-BFD object (or
+     by a DWO file hanging off of it), so they stay valid as long as
+     the objfile does.  */
+  dwarf2_section_info *section = nullptr;
+  dwarf2_section_info *str_section = nullptr;
+  dwarf2_section_info *str_offsets_section = nullptr;
+
+  /* The str_offsets_base to use, if known.  */
+  gdb::optional<ULONGEST> str_offsets_base;
+
+  /* A copy of the CU's line header.  The CU's own line header is
+     discarded once the CU has been expanded, but the macro reader
+     needs the file name table.  */
+  line_header_up lh;
+
+  /* The offset of the macro data in SECTION, and the DWARF offset
+     size in use there.  */
+  unsigned int offset = 0;
+  unsigned int offset_size = 0;
+
+  /* Non-zero if SECTION uses the .debug_macro format rather than the
+     older .debug_macinfo one.  */
+  int section_is_gnu = 0;
+
+  /* The result of producer_is_clang for the CU.  */
+  bool producer_is_clang = false;
+};
+
+/* Key identifying an interned base type; see
+   dwarf2_per_objfile::base_type_intern.  These are the inputs from
+   which read_base_type builds a simple scalar type, so equal keys
+   yield identical types.  */
+
+struct base_type_intern_key
+{
+  /* The DW_AT_encoding value.  */
+  int encoding;
+
+  /* The size in bits.  */
+  int bits;
+
+  /* The type's name; may be NULL, and is compared by content since
+     equal names are not always the same string.  */
+  const char *name;
+
+  /* The byte order, after applying DW_AT_endianity.  */
+  enum bfd_endian byte_order;
+
+  /* The CU's language, which influences which type code some
+     encodings map to.  */
+  enum language lang;
+
+  bool operator== (const base_type_intern_key &other) const
+  {
+    if (encoding != other.encoding
+	|| bits != other.bits
+	|| byte_order != other.byte_order
+	|| lang != other.lang)
+      return false;
+    if (name == nullptr || other.name == nullptr)
+      return name == other.name;
+    return strcmp (name, other.name) == 0;
+  }
+};
+
+/* Hash function for base_type_intern_key.  */
+
+struct base_type_intern_key_hash
+{
+  size_t operator() (const base_type_intern_key &key) const
+  {
+    size_t result = (key.encoding
+		     + (key.bits << 8)
+		     + ((int) key.byte_order << 20)
+		     + ((int) key.lang << 24));
+    if (key.name != nullptr)
+      result ^= htab_hash_string (key.name);
+    return result;
+  }
+};
+
 /* Collection of data recorded per objfile.
    This hangs off of dwarf2_objfile_data_key.
 
@@ -732,12 +866,48 @@ struct dwarf2_per_objfile
      The mapping is done via (CU/TU + DIE offset) -> type.  */
   htab_up die_type_hash;
 
+  /* Interned simple base types, shared between the CUs of this
+     objfile.  Nearly every CU defines its own "int", "char", and so
+     on; instead one instance per distinct key is kept here and
+     reused, which saves a great deal of obstack memory in large
+     programs.  Only read_base_type touches this, during CU expansion
+     on the main thread.  */
+  std::unordered_map<base_type_intern_key, struct type *,
+		     base_type_intern_key_hash> base_type_intern;
+
   /* Table containing line_header indexed by offset and offset_in_dwz.  */
   htab_up line_header_hash;
 
   /* The CU containing the m_builder in scope.  */
   dwarf2_cu *sym_cu = nullptr;
 
+  /* Macro information whose reading has been deferred, indexed by the
+     compunit_symtab it belongs to.  */
+  std::unordered_map<compunit_symtab *, deferred_macro_info>
+    deferred_macros;
+
+  /* Cached result of map_symbol_filenames over the not-yet-expanded
+     CUs, as deduplicated (filename, fullname) pairs whose strings are
+     owned by the per-CU file-name structures.  Computing the table
+     reads every CU's line-table header, and "info sources" is often
+     repeated; the cache makes later calls immediate.  Invalidated by
+     set_symtab, since expanding a CU removes its files from the
+     unexpanded view.  */
+  std::vector<std::pair<const char *, const char *>> mapped_filenames_cache;
+
+  /* True if MAPPED_FILENAMES_CACHE has been computed.  */
+  bool mapped_filenames_cache_valid = false;
+
+  /* Cache of demangled linkage names.  This is filled in on the
+     thread pool when a batch of CUs is expanded (see
+     dw2_expand_symtabs_batch) and consulted by dwarf2_physname, so
+     that symtab construction finds most results already computed.  A
+     null value records that the name does not demangle.  The keys
+     point into the mapped DWARF sections, which stay valid as long as
+     this object does.  */
+  std::unordered_map<gdb::string_view, gdb::unique_xmalloc_ptr<char>,
+		     gdb::string_view_hash> demangled_physnames;
+
   /* CUs that are queued to be read.  */
   gdb::optional<std::queue<dwarf2_queue_item>> queue;
 
@@ -875,6 +1045,10 @@ struct dwarf2_base_index_functions : public quick_symbol_functions
      CORE_ADDR pc, struct obj_section *section, int warn_if_readin)
        override final;
 
+  void expand_symtabs_for_pcs (struct objfile *objfile,
+			       gdb::array_view<const CORE_ADDR> pcs)
+       override final;
+
   struct compunit_symtab *find_compunit_symtab_by_address
     (struct objfile *objfile, CORE_ADDR address) override
   {
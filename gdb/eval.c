@@ -51,7 +51,7 @@
 CORE_ADDR
 parse_and_eval_address (const char *exp)
 {
-  expression_up expr = parse_expression (exp);
+  shared_expression expr = parse_expression_cached (exp);
 
   return value_as_address (expr->evaluate ());
 }
@@ -61,7 +61,7 @@ parse_and_eval_address (const char *exp)
 LONGEST
 parse_and_eval_long (const char *exp)
 {
-  expression_up expr = parse_expression (exp);
+  shared_expression expr = parse_expression_cached (exp);
 
   return value_as_long (expr->evaluate ());
 }
@@ -69,7 +69,7 @@ parse_and_eval_long (const char *exp)
 struct value *
 parse_and_eval (const char *exp, parser_flags flags)
 {
-  expression_up expr = parse_expression (exp, nullptr, flags);
+  shared_expression expr = parse_expression_cached (exp, flags);
 
   return expr->evaluate ();
 }
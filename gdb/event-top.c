@@ -549,6 +549,8 @@ command_handler (const char *command)
     ;
   if (c[0] != '#')
     {
+      maint_profile_note_command (c);
+
       execute_command (command, ui->instream == ui->stdin_stream);
 
       /* Do any commands attached to breakpoint we stopped at.  */
@@ -609,6 +609,7 @@ program_space::add_target_sections (void *owner,
 	  m_target_sections.push_back (s);
 	  m_target_sections.back ().owner = owner;
 	}
+      mark_target_sections_changed ();
 
       scoped_restore_current_pspace_and_thread restore_pspace_thread;
 
@@ -645,6 +646,7 @@ program_space::add_target_sections (struct objfile *objfile)
       m_target_sections.emplace_back (osect->addr (), osect->endaddr (),
 				      osect->the_bfd_section, (void *) objfile);
     }
+  mark_target_sections_changed ();
 }
 
 /* Remove all target sections owned by OWNER.
@@ -662,6 +664,7 @@ program_space::remove_target_sections (void *owner)
 			      return sect.owner == owner;
 			    });
   m_target_sections.erase (it, m_target_sections.end ());
+  mark_target_sections_changed ();
 
   /* If we don't have any more sections to read memory from,
      remove the file_stratum target from the stack of each
@@ -681,6 +684,48 @@ program_space::remove_target_sections (void *owner)
     }
 }
 
+/* See progspace.h.  */
+
+const std::vector<size_t> &
+program_space::sorted_target_sections ()
+{
+  if (!m_target_sections_index_valid)
+    {
+      m_target_sections_sorted.clear ();
+      m_target_sections_sorted.reserve (m_target_sections.size ());
+
+      /* Empty sections can never satisfy a transfer, so leave them
+	 out.  */
+      for (size_t i = 0; i < m_target_sections.size (); ++i)
+	if (m_target_sections[i].addr < m_target_sections[i].endaddr)
+	  m_target_sections_sorted.push_back (i);
+
+      std::sort (m_target_sections_sorted.begin (),
+		 m_target_sections_sorted.end (),
+		 [this] (size_t lhs, size_t rhs)
+		 {
+		   return m_target_sections[lhs].addr
+		     < m_target_sections[rhs].addr;
+		 });
+
+      /* A linear scan returns the first section in table order that
+	 contains an address.  A binary search cannot reproduce that
+	 if sections overlap, so discard the index in that unusual
+	 case and let callers fall back to scanning.  */
+      for (size_t i = 1; i < m_target_sections_sorted.size (); ++i)
+	if (m_target_sections[m_target_sections_sorted[i]].addr
+	    < m_target_sections[m_target_sections_sorted[i - 1]].endaddr)
+	  {
+	    m_target_sections_sorted.clear ();
+	    break;
+	  }
+
+      m_target_sections_index_valid = true;
+    }
+
+  return m_target_sections_sorted;
+}
+
 /* See exec.h.  */
 
 void
@@ -821,7 +866,8 @@ section_table_xfer_memory_partial (gdb_byte *readbuf, const gdb_byte *writebuf,
 				   ULONGEST *xfered_len,
 				   const target_section_table &sections,
 				   gdb::function_view<bool
-				     (const struct target_section *)> match_cb)
+				     (const struct target_section *)> match_cb,
+				   const std::vector<size_t> *index)
 {
   int res;
   ULONGEST memaddr = offset;
@@ -829,6 +875,47 @@ section_table_xfer_memory_partial (gdb_byte *readbuf, const gdb_byte *writebuf,
 
   gdb_assert (len != 0);
 
+  if (match_cb == nullptr && index != nullptr && !index->empty ())
+    {
+      /* INDEX holds positions into SECTIONS sorted by address, with
+	 no overlaps; binary-search for the last section starting at
+	 or before MEMADDR.  */
+      auto it = std::upper_bound (index->begin (), index->end (), memaddr,
+				  [&sections] (ULONGEST addr, size_t pos)
+				  {
+				    return addr < sections[pos].addr;
+				  });
+      if (it == index->begin ())
+	return TARGET_XFER_EOF;
+
+      const target_section &p = sections[*(it - 1)];
+      if (memaddr >= p.endaddr)
+	return TARGET_XFER_EOF;
+
+      /* If the transfer extends past the section, just do the part
+	 that is within it.  */
+      if (memend > p.endaddr)
+	len = p.endaddr - memaddr;
+
+      struct bfd_section *asect = p.the_bfd_section;
+      bfd *abfd = asect->owner;
+
+      if (writebuf)
+	res = bfd_set_section_contents (abfd, asect, writebuf,
+					memaddr - p.addr, len);
+      else
+	res = bfd_get_section_contents (abfd, asect, readbuf,
+					memaddr - p.addr, len);
+
+      if (res != 0)
+	{
+	  *xfered_len = len;
+	  return TARGET_XFER_OK;
+	}
+      else
+	return TARGET_XFER_EOF;
+    }
+
   for (const target_section &p : sections)
     {
       struct bfd_section *asect = p.the_bfd_section;
@@ -898,9 +985,17 @@ exec_target::xfer_partial (enum target_object object,
   const target_section_table *table = target_get_section_table (this);
 
   if (object == TARGET_OBJECT_MEMORY)
-    return section_table_xfer_memory_partial (readbuf, writebuf,
-					      offset, len, xfered_len,
-					      *table);
+    {
+      /* The exec target's table is the program space's; use its
+	 sorted index to avoid scanning the whole table.  */
+      const std::vector<size_t> *idx = nullptr;
+      if (table == &current_program_space->target_sections ())
+	idx = &current_program_space->sorted_target_sections ();
+
+      return section_table_xfer_memory_partial (readbuf, writebuf,
+						offset, len, xfered_len,
+						*table, nullptr, idx);
+    }
   else
     return TARGET_XFER_E_IO;
 }
@@ -1013,6 +1108,7 @@ set_section_command (const char *args, int from_tty)
 	  long offset = secaddr - p.addr;
 	  p.addr += offset;
 	  p.endaddr += offset;
+	  current_program_space->mark_target_sections_changed ();
 	  if (from_tty)
 	    exec_ops.files_info ();
 	  return;
@@ -1037,6 +1133,7 @@ exec_set_section_address (const char *filename, int index, CORE_ADDR address)
 	{
 	  p.endaddr += address - p.addr;
 	  p.addr = address;
+	  current_program_space->mark_target_sections_changed ();
 	}
     }
 }
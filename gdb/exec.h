@@ -62,6 +62,12 @@ extern enum target_xfer_status
    noted above.  See memory_xfer_partial_1() in target.c for an
    example.
 
+   INDEX is optional; when provided it must hold positions into
+   SECTIONS sorted by address with no overlaps, as returned by
+   program_space::sorted_target_sections, and the section containing
+   OFFSET is then found by binary search instead of scanning the
+   whole table.  It is ignored when MATCH_CB is given.
+
    Return the number of bytes actually transfered, or zero when no
    data is available for the requested range.
 
@@ -78,6 +84,8 @@ extern enum target_xfer_status
 				     const target_section_table &,
 				     gdb::function_view<bool
 				       (const struct target_section *)> match_cb
+					 = nullptr,
+				     const std::vector<size_t> *index
 					 = nullptr);
 
 /* Read from mappable read-only sections of BFD executable files.
@@ -240,6 +240,12 @@ struct expression
 
 typedef std::unique_ptr<expression> expression_up;
 
+/* A parsed expression whose ownership is shared with the
+   parsed-expression cache.  Holders may evaluate the expression but
+   must not modify it.  */
+
+typedef std::shared_ptr<expression> shared_expression;
+
 /* When parsing expressions we track the innermost block that was
    referenced.  */
 
@@ -319,6 +325,18 @@ extern expression_up parse_expression (const char *,
 extern expression_up parse_expression_with_language (const char *string,
 						     enum language lang);
 
+/* Like parse_expression, but first consult a cache of recently
+   parsed expressions.  The cache is keyed on the expression text and
+   everything the parse depends on (language, context block,
+   architecture and FLAGS), and is flushed whenever the set of loaded
+   objfiles changes, so repeatedly evaluating the same expression
+   text, as front ends polling values tend to do, skips the parser.
+   The returned expression may be shared with other callers; it must
+   not be modified.  */
+
+extern shared_expression parse_expression_cached (const char *string,
+						  parser_flags flags = 0);
+
 
 class completion_tracker;
 
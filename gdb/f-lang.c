@@ -1478,7 +1478,10 @@ fortran_undetermined::value_subarray (value *array,
 	  /* If the value we're taking a slice from is not yet loaded, or
 	     the requested slice is outside the values content range then
 	     just create a new lazy value pointing at the memory where the
-	     contents we're looking for exist.  */
+	     contents we're looking for exist.  An already-fetched parent
+	     must keep its recorded bytes -- they may be a value-history
+	     snapshot that no longer matches target memory -- so copy
+	     from them instead.  */
 	  if (array->lazy ()
 	      || (total_offset + array_slice_type->length ()
 		  > check_typedef (array->type ())->length ()))
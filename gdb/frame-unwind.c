@@ -28,7 +28,13 @@
 #include "target.h"
 #include "gdbarch.h"
 #include "dwarf2/frame-tailcall.h"
+#include "maint.h"
 #include "cli/cli-cmds.h"
+#include <chrono>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 struct frame_unwind_table_entry
 {
@@ -117,18 +123,115 @@ frame_unwind_append_unwinder (struct gdbarch *gdbarch,
   (*ip)->unwinder = unwinder;
 }
 
+/* Whether to collect per-unwinder statistics.  */
+static bool maintenance_frame_stats = false;
+
+/* Statistics for one frame unwinder, keyed by frame_unwind::name.
+   The sniffer time is cumulative wall time and includes any nested
+   unwinding a sniffer triggers for outer frames.  */
+
+struct frame_unwind_stats
+{
+  ULONGEST sniffs = 0;
+  ULONGEST accepts = 0;
+  ULONGEST skips = 0;
+  std::chrono::steady_clock::duration time {};
+};
+
+/* Map of unwinder name to its statistics.  std::map both keeps the
+   output sorted and guarantees stable references across insertions
+   from nested unwinds.  */
+static std::map<std::string, frame_unwind_stats> frame_unwind_stat_map;
+
+/* Sniffer failures remembered for the current frame cache
+   generation, keyed by the frame's PC.  When a core has a corrupted
+   stack shared by many threads, the same garbage PCs would otherwise
+   send every thread's frames through the whole sniffer chain before
+   falling back to the heuristic unwinder.  The cache only lives for
+   one stop: it is discarded whenever the frame cache generation
+   changes.  */
+
+struct sniffer_failure_cache
+{
+  unsigned int generation = 0;
+  std::unordered_map<CORE_ADDR,
+		     std::unordered_set<const frame_unwind *>> failures;
+};
+
+static sniffer_failure_cache frame_sniffer_failures;
+
+/* Discard remembered failures from older frame cache generations.
+   Called before every cache access, so a reinit_frame_cache from
+   within a sniffer cannot leave stale entries behind.  */
+
+static void
+sniffer_failure_cache_validate ()
+{
+  unsigned int generation = get_frame_cache_generation ();
+
+  if (frame_sniffer_failures.generation != generation)
+    {
+      frame_sniffer_failures.failures.clear ();
+      frame_sniffer_failures.generation = generation;
+    }
+}
+
+/* Return true if UNWINDER's sniffer is already known to reject
+   frames at PC.  */
+
+static bool
+sniffer_failure_cache_check (CORE_ADDR pc, const struct frame_unwind *unwinder)
+{
+  sniffer_failure_cache_validate ();
+
+  auto iter = frame_sniffer_failures.failures.find (pc);
+  return (iter != frame_sniffer_failures.failures.end ()
+	  && iter->second.count (unwinder) != 0);
+}
+
+/* Remember that UNWINDER's sniffer rejected a frame at PC.  */
+
+static void
+sniffer_failure_cache_record (CORE_ADDR pc, const struct frame_unwind *unwinder)
+{
+  sniffer_failure_cache_validate ();
+
+  frame_sniffer_failures.failures[pc].insert (unwinder);
+}
+
 /* Call SNIFFER from UNWINDER.  If it succeeded set UNWINDER for
    THIS_FRAME and return 1.  Otherwise the function keeps THIS_FRAME
-   unchanged and returns 0.  */
+   unchanged and returns 0.  If the sniffer failed because something
+   it needed was unavailable, and UNAVAILABLE is not null, set
+   *UNAVAILABLE to true.  */
 
 static int
 frame_unwind_try_unwinder (frame_info_ptr this_frame, void **this_cache,
-			  const struct frame_unwind *unwinder)
+			  const struct frame_unwind *unwinder,
+			  bool *unavailable = nullptr)
 {
   int res = 0;
 
+  scoped_command_time time_category (COMMAND_TIME_UNWIND);
+
   unsigned int entry_generation = get_frame_cache_generation ();
 
+  frame_unwind_stats *stats = nullptr;
+  std::chrono::steady_clock::time_point start_time;
+
+  if (maintenance_frame_stats)
+    {
+      stats = &frame_unwind_stat_map[unwinder->name];
+      stats->sniffs++;
+      start_time = std::chrono::steady_clock::now ();
+    }
+
+  auto record_time = [&] ()
+    {
+      if (stats != nullptr)
+	stats->time += std::chrono::steady_clock::now () - start_time;
+    };
+
   frame_prepare_for_sniffer (this_frame, unwinder);
 
   try
@@ -140,6 +243,8 @@ frame_unwind_try_unwinder (frame_info_ptr this_frame, void **this_cache,
     {
       frame_debug_printf ("caught exception: %s", ex.message->c_str ());
 
+      record_time ();
+
       /* Catch all exceptions, caused by either interrupt or error.
 	 Reset *THIS_CACHE, unless something reinitialized the frame
 	 cache meanwhile, in which case THIS_FRAME/THIS_CACHE are now
@@ -156,13 +261,19 @@ frame_unwind_try_unwinder (frame_info_ptr this_frame, void **this_cache,
 	     thus most unwinders aren't able to determine if they're
 	     the best fit.  Keep trying.  Fallback prologue unwinders
 	     should always accept the frame.  */
+	  if (unavailable != nullptr)
+	    *unavailable = true;
 	  return 0;
 	}
       throw;
     }
 
+  record_time ();
+
   if (res)
     {
+      if (stats != nullptr)
+	stats->accepts++;
       frame_debug_printf ("yes");
       return 1;
     }
@@ -204,9 +315,38 @@ frame_unwind_find_by_frame (frame_info_ptr this_frame, void **this_cache)
 				   unwinder_from_target))
     return;
 
+  /* For non-innermost frames, remember per PC which sniffers have
+     already rejected a frame during this stop and skip them.  Only
+     sniffers that declare themselves PC-pure take part; innermost
+     frames are excluded because several sniffers (e.g. the epilogue
+     unwinders) treat them specially.  */
+  CORE_ADDR pc = 0;
+  bool can_cache = (frame_relative_level (this_frame) > 0
+		    && get_frame_pc_if_available (this_frame, &pc));
+
   for (entry = table->list; entry != NULL; entry = entry->next)
-    if (frame_unwind_try_unwinder (this_frame, this_cache, entry->unwinder))
-      return;
+    {
+      bool cacheable = can_cache && entry->unwinder->sniffer_is_pc_pure;
+
+      if (cacheable && sniffer_failure_cache_check (pc, entry->unwinder))
+	{
+	  if (maintenance_frame_stats)
+	    frame_unwind_stat_map[entry->unwinder->name].skips++;
+	  frame_debug_printf ("skipping unwinder \"%s\": already failed at %s",
+			      entry->unwinder->name, hex_string (pc));
+	  continue;
+	}
+
+      bool unavailable = false;
+      if (frame_unwind_try_unwinder (this_frame, this_cache, entry->unwinder,
+				     &unavailable))
+	return;
+
+      /* Do not remember a rejection caused by unavailable memory or
+	 registers; the PC was not what made the sniffer fail.  */
+      if (cacheable && !unavailable)
+	sniffer_failure_cache_record (pc, entry->unwinder);
+    }
 
   internal_error (_("frame_unwind_find_by_frame failed"));
 }
@@ -366,6 +506,56 @@ maintenance_info_frame_unwinders (const char *args, int from_tty)
     }
 }
 
+/* Implement "maintenance info frame-stats" command.  */
+
+static void
+maintenance_info_frame_stats (const char *args, int from_tty)
+{
+  if (!maintenance_frame_stats && frame_unwind_stat_map.empty ())
+    {
+      gdb_printf (_("Frame unwinder statistics collection is disabled; "
+		    "enable it with \"maint set frame-stats on\".\n"));
+      return;
+    }
+
+  ui_out *uiout = current_uiout;
+  ui_out_emit_table table_emitter (uiout, 5, -1, "FrameStats");
+  uiout->table_header (27, ui_left, "name", "Name");
+  uiout->table_header (10, ui_right, "sniffs", "Sniffs");
+  uiout->table_header (10, ui_right, "accepts", "Accepts");
+  uiout->table_header (10, ui_right, "skips", "Skips");
+  uiout->table_header (12, ui_right, "time", "Time (ms)");
+  uiout->table_body ();
+
+  for (const auto &iter : frame_unwind_stat_map)
+    {
+      const frame_unwind_stats &stats = iter.second;
+      std::string time
+	= string_printf ("%.3f",
+			 (std::chrono::duration<double, std::milli>
+			  (stats.time).count ()));
+
+      ui_out_emit_list tuple_emitter (uiout, nullptr);
+      uiout->field_string ("name", iter.first.c_str ());
+      uiout->field_unsigned ("sniffs", stats.sniffs);
+      uiout->field_unsigned ("accepts", stats.accepts);
+      uiout->field_unsigned ("skips", stats.skips);
+      uiout->field_string ("time", time.c_str ());
+      uiout->text ("\n");
+    }
+}
+
+/* Implement "maintenance set frame-stats".  */
+
+static void
+set_maintenance_frame_stats (const char *args, int from_tty,
+			     struct cmd_list_element *c)
+{
+  /* Start every collection from a clean slate.  */
+  if (maintenance_frame_stats)
+    frame_unwind_stat_map.clear ();
+}
+
 void _initialize_frame_unwind ();
 void
 _initialize_frame_unwind ()
@@ -377,4 +567,23 @@ _initialize_frame_unwind ()
 	   _("List the frame unwinders currently in effect, "
 	     "starting with the highest priority."),
 	   &maintenanceinfolist);
+
+  add_setshow_boolean_cmd ("frame-stats", class_maintenance,
+			   &maintenance_frame_stats, _("\
+Set whether to collect per-unwinder statistics."), _("\
+Show whether to collect per-unwinder statistics."), _("\
+When enabled, every sniffer invocation is counted and timed per frame\n\
+unwinder.  Enabling the collection resets the counters.  Use\n\
+\"maint info frame-stats\" to display them."),
+			   set_maintenance_frame_stats,
+			   NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_cmd ("frame-stats",
+	   class_maintenance,
+	   maintenance_info_frame_stats,
+	   _("Show per-unwinder sniffer counts, acceptances, cached skips\n\
+and cumulative sniffer time.  Requires \"maint set frame-stats on\"."),
+	   &maintenanceinfolist);
 }
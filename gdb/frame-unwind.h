@@ -171,6 +171,11 @@ struct frame_unwind
   frame_sniffer_ftype *sniffer;
   frame_dealloc_cache_ftype *dealloc_cache;
   frame_prev_arch_ftype *prev_arch;
+  /* True if SNIFFER's answer depends on nothing but the frame's PC,
+     so that a rejection at some PC may be reused for other frames
+     with the same PC within one stop.  Most sniffers also examine
+     registers or other per-frame state and must leave this unset.  */
+  bool sniffer_is_pc_pure;
 };
 
 /* Register a frame unwinder, _prepending_ it to the front of the
@@ -2108,6 +2108,25 @@ reinit_frame_cache (void)
 {
   ++frame_cache_generation;
 
+  /* Flushes come in bursts: a single resume or stop typically
+     triggers one flush per thread through registers_changed, plus
+     more from the target_changed observer.  After the first flush
+     nothing can reference the cache, so later ones have no frames to
+     tear down; skip the obstack churn.  The generation was still
+     bumped above, and the selected frame is still invalidated in case
+     a frame selection is pending reinflation by level or id.  */
+  if (sentinel_frame == nullptr && htab_elements (frame_stash) == 0)
+    {
+      invalidate_selected_frame ();
+
+      for (frame_info_ptr &iter : frame_info_ptr::frame_list)
+	iter.invalidate ();
+
+      frame_debug_printf ("generation=%d (cache was empty)",
+			  frame_cache_generation);
+      return;
+    }
+
   if (htab_elements (frame_stash) > 0)
     annotate_frames_invalid ();
 
@@ -38,6 +38,7 @@
 #include "gdbsupport/gdb_unlinker.h"
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/scope-exit.h"
+#include "gdbsupport/thread-pool.h"
 
 /* The largest amount of memory to read from the target at once.  We
    must throttle it to limit the amount of memory used by GDB during
@@ -581,7 +582,20 @@ gcore_copy_callback (bfd *obfd, asection *osec)
     return;
 
   size = std::min (total_size, (bfd_size_type) MAX_COPY_BYTES);
+
+  /* Overlap reading the target with writing the output file: while a
+     worker thread writes chunk N to OBFD, the main thread reads chunk
+     N + 1 from the target.  Target access is not thread-safe, so the
+     reads stay on the main thread; the worker only touches OBFD, and
+     at most one write task is in flight at a time.  With no worker
+     threads configured, post_task runs the write inline and this
+     degenerates to the plain serial loop.  */
   gdb::byte_vector memhunk (size);
+  gdb::byte_vector writehunk (size);
+  gdb::future<void> write_done;
+  bool write_pending = false;
+  bool write_failed = false;
+  std::string write_errmsg;
 
   while (total_size > 0)
     {
@@ -597,17 +611,40 @@ gcore_copy_callback (bfd *obfd, asection *osec)
 		   paddress (target_gdbarch (), bfd_section_vma (osec)));
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk.data (),
-				     offset, size))
+
+      /* Wait for the previous chunk to hit the file before reusing
+	 its buffer.  */
+      if (write_pending)
 	{
-	  warning (_("Failed to write corefile contents (%s)."),
-		   bfd_errmsg (bfd_get_error ()));
-	  break;
+	  write_done.wait ();
+	  if (write_failed)
+	    break;
 	}
+      std::swap (memhunk, writehunk);
+
+      file_ptr write_offset = offset;
+      bfd_size_type write_size = size;
+      write_done = gdb::thread_pool::g_thread_pool->post_task
+	([&, write_offset, write_size] ()
+	 {
+	   if (!bfd_set_section_contents (obfd, osec, writehunk.data (),
+					  write_offset, write_size))
+	     {
+	       write_failed = true;
+	       write_errmsg = bfd_errmsg (bfd_get_error ());
+	     }
+	 });
+      write_pending = true;
 
       total_size -= size;
       offset += size;
     }
+
+  if (write_pending)
+    write_done.wait ();
+  if (write_failed)
+    warning (_("Failed to write corefile contents (%s)."),
+	     write_errmsg.c_str ());
 }
 
 /* Callback to copy contents to a particular memory tag section.  */
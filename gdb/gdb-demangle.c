@@ -29,6 +29,7 @@
 #include "gdbcmd.h"
 #include "demangle.h"
 #include "gdb-demangle.h"
+#include "disasm.h"
 #include "language.h"
 
 /* Select the default C++ demangling style to use.  The default is "auto",
@@ -69,6 +70,16 @@ show_asm_demangle (struct ui_file *file, int from_tty,
 	      value);
 }
 
+/* Disassembly cached while the old setting was in force symbolized
+   its branch targets under that setting, so drop it.  */
+
+static void
+set_asm_demangle (const char *args, int from_tty,
+		  struct cmd_list_element *c)
+{
+  gdb_disasm_flush_insn_cache ();
+}
+
 /* String name for the current demangling style.  Set by the
    "set demangle-style" command, printed as part of the output by the
    "show demangle-style" command.  */
@@ -244,7 +255,7 @@ Show demangling of encoded C++/ObjC names when displaying symbols."), NULL,
   add_setshow_boolean_cmd ("asm-demangle", class_support, &asm_demangle, _("\
 Set demangling of C++/ObjC names in disassembly listings."), _("\
 Show demangling of C++/ObjC names in disassembly listings."), NULL,
-			   NULL,
+			   set_asm_demangle,
 			   show_asm_demangle,
 			   &setprintlist, &showprintlist);
 
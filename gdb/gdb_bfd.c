@@ -33,6 +33,7 @@
 #include "gdbsupport/fileio.h"
 #include "inferior.h"
 #include "cli/cli-style.h"
+#include <algorithm>
 #include <unordered_map>
 
 /* An object of this type is stored in the section's user data when
@@ -259,11 +260,25 @@ private:
 
   /* Holds the generated name of the in-memory BFD file.  */
   gdb::unique_xmalloc_ptr<char> m_filename;
+
+  /* Size of the blocks target memory is fetched in.  */
+  static constexpr file_ptr chunk_size = 4096;
+
+  /* Blocks of the file already fetched from the target, keyed by the
+     file offset of the block's first byte.  BFD parses headers and
+     section tables with many small reads; serving them from
+     CHUNK_SIZE blocks avoids a target round trip per read, while
+     still only ever transferring the parts of the image BFD actually
+     looks at.  The file contents are assumed not to change in target
+     memory while this BFD is open, as they already were when the
+     whole image was read up front.  */
+  std::unordered_map<file_ptr, gdb::byte_vector> m_cache;
 };
 
-/* For `gdb_bfd_open_from_target_memory`.  For reading the file, we just need to
-   pass through to target_read_memory and fix up the arguments and return
-   values.  */
+/* For `gdb_bfd_open_from_target_memory`.  For reading the file, we
+   serve each request out of CHUNK_SIZE blocks of target memory,
+   fetching each block with target_read_memory the first time it is
+   touched.  */
 
 file_ptr
 target_buffer::read (struct bfd *abfd, void *buf,
@@ -277,9 +292,36 @@ target_buffer::read (struct bfd *abfd, void *buf,
   if (nbytes == 0)
     return 0;
 
-  int err = target_read_memory (base () + offset, (gdb_byte *) buf, nbytes);
-  if (err)
-    return -1;
+  file_ptr pos = offset;
+  file_ptr left = nbytes;
+  gdb_byte *dest = (gdb_byte *) buf;
+
+  while (left > 0)
+    {
+      file_ptr chunk_start = pos - pos % chunk_size;
+      auto it = m_cache.find (chunk_start);
+
+      if (it == m_cache.end ())
+	{
+	  file_ptr chunk_len = std::min<file_ptr> (chunk_size,
+						   size () - chunk_start);
+	  gdb::byte_vector chunk (chunk_len);
+
+	  if (target_read_memory (base () + chunk_start, chunk.data (),
+				  chunk_len) != 0)
+	    return -1;
+
+	  it = m_cache.emplace (chunk_start, std::move (chunk)).first;
+	}
+
+      file_ptr in_chunk = pos - chunk_start;
+      file_ptr n = std::min<file_ptr> (left, it->second.size () - in_chunk);
+
+      memcpy (dest, it->second.data () + in_chunk, n);
+      pos += n;
+      dest += n;
+      left -= n;
+    }
 
   return nbytes;
 }
@@ -764,6 +806,16 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
 #if HAVE_POSIX_MADVISE
 	      posix_madvise (descriptor->map_addr, descriptor->map_len,
 			     POSIX_MADV_WILLNEED);
+
+	      /* The DWARF scanners walk the debug sections front to
+		 back, so also ask for aggressive sequential readahead
+		 there.  The pages stay mapped afterwards -- symbol
+		 table expansion comes back to them with random
+		 accesses, and whether they may be reclaimed in the
+		 meantime is the kernel's call to make.  */
+	      if (startswith (bfd_section_name (sectp), ".debug"))
+		posix_madvise (descriptor->map_addr, descriptor->map_len,
+			       POSIX_MADV_SEQUENTIAL);
 #endif
 	      goto done;
 	    }
@@ -111,6 +111,14 @@ struct thread_control_state
      another at the instruction after the branch.  */
   struct breakpoint *single_step_breakpoints = nullptr;
 
+  /* A single-step breakpoint recycled from the previous step, kept
+     (still inserted on the target) so that an immediately following
+     software single-step can reuse it instead of removing and
+     re-inserting the very same breakpoint locations.  Flushed
+     whenever the thread is resumed without reusing it, and when a
+     stop is presented to the user.  */
+  struct breakpoint *cached_single_step_breakpoints = nullptr;
+
   /* Range to single step within.
 
      If this is nonzero, respond to a single-step signal by continuing
@@ -655,9 +663,19 @@ extern void delete_step_resume_breakpoint (struct thread_info *);
 /* Delete an exception_resume_breakpoint from the thread database.  */
 extern void delete_exception_resume_breakpoint (struct thread_info *);
 
-/* Delete the single-step breakpoints of thread TP, if any.  */
+/* Delete the single-step breakpoints of thread TP, if any,
+   including recycled ones.  */
 extern void delete_single_step_breakpoints (struct thread_info *tp);
 
+/* Move the single-step breakpoints of thread TP, if any, to TP's
+   single-step breakpoint cache, keeping them inserted on the target
+   so that a following step may reuse them.  */
+extern void recycle_single_step_breakpoints (struct thread_info *tp);
+
+/* Delete the recycled single-step breakpoints of thread TP, if
+   any.  */
+extern void flush_single_step_breakpoint_cache (struct thread_info *tp);
+
 /* Check if the thread has software single stepping breakpoints
    set.  */
 extern int thread_has_single_step_breakpoints_set (struct thread_info *tp);
@@ -45,6 +45,8 @@
 #include "gmp-utils.h"
 #include "rust-lang.h"
 #include "ada-lang.h"
+#include "observable.h"
+#include <unordered_map>
 
 /* The value of an invalid conversion badness.  */
 #define INVALID_CONVERSION 100
@@ -175,6 +177,14 @@ show_strict_type_checking (struct ui_file *file, int from_tty,
   gdb_printf (file, _("Strict type checking is %s.\n"), value);
 }
 
+/* See gdbtypes.h.  */
+
+bool
+strict_type_checking_p ()
+{
+  return strict_type_checking;
+}
+
 
 /* Helper function to initialize a newly allocated type.  Set type code
    to CODE and initialize the type-specific fields accordingly.  */
@@ -4351,6 +4361,62 @@ check_types_worklist (std::vector<type_equality_entry> *worklist,
   return true;
 }
 
+/* Hash function for the memoization table below.  */
+
+struct type_pair_hasher
+{
+  size_t operator() (const std::pair<struct type *, struct type *> &p) const
+  {
+    size_t h = std::hash<struct type *> () (p.first);
+    return h * 31 + std::hash<struct type *> () (p.second);
+  }
+};
+
+typedef std::unordered_map<std::pair<struct type *, struct type *>, bool,
+			   type_pair_hasher> type_equality_cache;
+
+/* Per-program-space memoization of types_deeply_equal results, keyed
+   by the pair of type pointers (stored in a canonical order, since
+   the relation is symmetric).  Comparisons of the same pairs recur
+   during overload resolution and the Python and Guile type
+   comparisons, and each one re-walks the type graphs.  The cache is
+   flushed whenever the program space's objfiles change: the types
+   belong to the objfiles, and loading new symbols can resolve a stub
+   type and so change an answer.  */
+
+static const registry<program_space>::key<type_equality_cache>
+     type_equality_cache_key;
+
+/* Discard the memoized type comparisons of PSPACE, if any.  */
+
+static void
+invalidate_type_equality_cache (program_space *pspace)
+{
+  type_equality_cache *memo = type_equality_cache_key.get (pspace);
+  if (memo != nullptr)
+    memo->clear ();
+}
+
+/* Observer attachments invalidating the memoized comparisons.  */
+
+static void
+type_equality_new_objfile_observer (struct objfile *objfile)
+{
+  invalidate_type_equality_cache (objfile->pspace);
+}
+
+static void
+type_equality_free_objfile_observer (struct objfile *objfile)
+{
+  invalidate_type_equality_cache (objfile->pspace);
+}
+
+static void
+type_equality_all_objfiles_removed (program_space *pspace)
+{
+  invalidate_type_equality_cache (pspace);
+}
+
 /* Return true if types TYPE1 and TYPE2 are equal, as determined by a
    "deep comparison".  Otherwise return false.  */
 
@@ -4365,9 +4431,25 @@ types_deeply_equal (struct type *type1, struct type *type2)
   if (type1 == type2)
     return true;
 
+  std::pair<struct type *, struct type *> key (type1, type2);
+  if (type2 < type1)
+    std::swap (key.first, key.second);
+
+  type_equality_cache *memo
+    = type_equality_cache_key.get (current_program_space);
+  if (memo == nullptr)
+    memo = type_equality_cache_key.emplace (current_program_space);
+
+  auto it = memo->find (key);
+  if (it != memo->end ())
+    return it->second;
+
   gdb::bcache cache;
   worklist.emplace_back (type1, type2);
-  return check_types_worklist (&worklist, &cache);
+  bool result = check_types_worklist (&worklist, &cache);
+
+  (*memo)[key] = result;
+  return result;
 }
 
 /* Allocated status of type TYPE.  Return zero if type TYPE is allocated.
@@ -6238,4 +6320,11 @@ _initialize_gdbtypes ()
 			   NULL, NULL,
 			   show_strict_type_checking,
 			   &setchecklist, &showchecklist);
+
+  gdb::observers::new_objfile.attach (type_equality_new_objfile_observer,
+				      "gdbtypes");
+  gdb::observers::free_objfile.attach (type_equality_free_objfile_observer,
+				       "gdbtypes");
+  gdb::observers::all_objfiles_removed.attach
+    (type_equality_all_objfiles_removed, "gdbtypes");
 }
@@ -2817,6 +2817,11 @@ extern enum bfd_endian type_byte_order (const struct type *type);
 
 extern unsigned int overload_debug;
 
+/* Return true if strict type checking ("set check type on") is in
+   effect.  Argument ranking depends on this setting.  */
+
+extern bool strict_type_checking_p ();
+
 /* Return whether the function type represented by TYPE is marked as unsafe
    to call by the debugger.
 
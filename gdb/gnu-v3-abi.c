@@ -30,9 +30,11 @@
 #include "c-lang.h"
 #include "typeprint.h"
 #include <algorithm>
+#include <unordered_map>
 #include "cli/cli-style.h"
 #include "dwarf2/loc.h"
 #include "inferior.h"
+#include "observable.h"
 
 static struct cp_abi_ops gnu_v3_abi_ops;
 
@@ -300,6 +302,76 @@ gnuv3_get_vtable (struct gdbarch *gdbarch,
 }
 
 
+/* What a vtable revealed about the dynamic type of the objects using
+   it, for the cache below.  */
+
+struct rtti_cache_entry
+{
+  /* The resolved run-time type.  */
+  struct type *type;
+
+  /* The vtable's offset-to-top slot, i.e. the offset from a
+     subobject using this vtable to the top of the complete
+     object.  */
+  LONGEST offset_to_top;
+};
+
+/* A per-program-space cache mapping a vtable's address to the
+   run-time type it identifies.  Every polymorphic value printed under
+   "set print object on" resolves its vtable, and the minimal-symbol
+   lookup, "vtable for ..." name parsing and type lookup that this
+   takes are repeated for each of them, while the distinct vtables
+   number only as many as the program's dynamic classes.  Failed
+   resolutions are not cached -- they can start succeeding once more
+   symbols are loaded.  The cache is flushed when the program space's
+   objfiles change, since both the keys and the cached types belong to
+   them.  */
+
+typedef std::unordered_map<CORE_ADDR, rtti_cache_entry> rtti_cache_map;
+
+static const registry<program_space>::key<rtti_cache_map> rtti_cache_key;
+
+/* Return the RTTI cache for PSPACE, allocating it if necessary.  */
+
+static rtti_cache_map *
+get_rtti_cache (program_space *pspace)
+{
+  rtti_cache_map *cache = rtti_cache_key.get (pspace);
+  if (cache == nullptr)
+    cache = rtti_cache_key.emplace (pspace);
+  return cache;
+}
+
+/* See cp-abi.h.  */
+
+void
+invalidate_rtti_cache (program_space *pspace)
+{
+  rtti_cache_map *cache = rtti_cache_key.get (pspace);
+  if (cache != nullptr)
+    cache->clear ();
+}
+
+/* Observer attachments invalidating the RTTI cache.  */
+
+static void
+rtti_cache_new_objfile_observer (struct objfile *objfile)
+{
+  invalidate_rtti_cache (objfile->pspace);
+}
+
+static void
+rtti_cache_free_objfile_observer (struct objfile *objfile)
+{
+  invalidate_rtti_cache (objfile->pspace);
+}
+
+static void
+rtti_cache_all_objfiles_removed (program_space *pspace)
+{
+  invalidate_rtti_cache (pspace);
+}
+
 static struct type *
 gnuv3_rtti_type (struct value *value,
 		 int *full_p, LONGEST *top_p, int *using_enc_p)
@@ -330,52 +402,67 @@ gnuv3_rtti_type (struct value *value,
   if (vtable == NULL)
     return NULL;
 
-  /* Find the linker symbol for this vtable.  */
-  vtable_symbol
-    = lookup_minimal_symbol_by_pc (vtable->address ()
-				   + vtable->embedded_offset ()).minsym;
-  if (! vtable_symbol)
-    return NULL;
-  
-  /* The symbol's demangled name should be something like "vtable for
-     CLASS", where CLASS is the name of the run-time type of VALUE.
-     If we didn't like this approach, we could instead look in the
-     type_info object itself to get the class name.  But this way
-     should work just as well, and doesn't read target memory.  */
-  vtable_symbol_name = vtable_symbol->demangled_name ();
-  if (vtable_symbol_name == NULL
-      || !startswith (vtable_symbol_name, "vtable for "))
+  CORE_ADDR vtable_addr = vtable->address () + vtable->embedded_offset ();
+
+  /* A vtable identifies its dynamic class once and for all, so see
+     whether this one has been resolved before.  */
+  rtti_cache_map *cache = get_rtti_cache (current_program_space);
+  auto cached = cache->find (vtable_addr);
+  if (cached != cache->end ())
     {
-      warning (_("can't find linker symbol for virtual table for `%s' value"),
-	       TYPE_SAFE_NAME (values_type));
-      if (vtable_symbol_name)
-	warning (_("  found `%s' instead"), vtable_symbol_name);
-      return NULL;
+      run_time_type = cached->second.type;
+      offset_to_top = cached->second.offset_to_top;
     }
-  class_name = vtable_symbol_name + 11;
-
-  /* Strip off @plt and version suffixes.  */
-  atsign = strchr (class_name, '@');
-  if (atsign != NULL)
+  else
     {
-      char *copy;
+      /* Find the linker symbol for this vtable.  */
+      vtable_symbol = lookup_minimal_symbol_by_pc (vtable_addr).minsym;
+      if (! vtable_symbol)
+	return NULL;
+
+      /* The symbol's demangled name should be something like "vtable for
+	 CLASS", where CLASS is the name of the run-time type of VALUE.
+	 If we didn't like this approach, we could instead look in the
+	 type_info object itself to get the class name.  But this way
+	 should work just as well, and doesn't read target memory.  */
+      vtable_symbol_name = vtable_symbol->demangled_name ();
+      if (vtable_symbol_name == NULL
+	  || !startswith (vtable_symbol_name, "vtable for "))
+	{
+	  warning (_("can't find linker symbol for virtual table for "
+		     "`%s' value"),
+		   TYPE_SAFE_NAME (values_type));
+	  if (vtable_symbol_name)
+	    warning (_("  found `%s' instead"), vtable_symbol_name);
+	  return NULL;
+	}
+      class_name = vtable_symbol_name + 11;
 
-      copy = (char *) alloca (atsign - class_name + 1);
-      memcpy (copy, class_name, atsign - class_name);
-      copy[atsign - class_name] = '\0';
-      class_name = copy;
-    }
+      /* Strip off @plt and version suffixes.  */
+      atsign = strchr (class_name, '@');
+      if (atsign != NULL)
+	{
+	  char *copy;
 
-  /* Try to look up the class name as a type name.  */
-  /* FIXME: chastain/2003-11-26: block=NULL is bogus.  See pr gdb/1465.  */
-  run_time_type = cp_lookup_rtti_type (class_name, NULL);
-  if (run_time_type == NULL)
-    return NULL;
+	  copy = (char *) alloca (atsign - class_name + 1);
+	  memcpy (copy, class_name, atsign - class_name);
+	  copy[atsign - class_name] = '\0';
+	  class_name = copy;
+	}
+
+      /* Try to look up the class name as a type name.  */
+      /* FIXME: chastain/2003-11-26: block=NULL is bogus.  See pr gdb/1465.  */
+      run_time_type = cp_lookup_rtti_type (class_name, NULL);
+      if (run_time_type == NULL)
+	return NULL;
 
-  /* Get the offset from VALUE to the top of the complete object.
-     NOTE: this is the reverse of the meaning of *TOP_P.  */
-  offset_to_top
-    = value_as_long (value_field (vtable, vtable_field_offset_to_top));
+      /* Get the offset from VALUE to the top of the complete object.
+	 NOTE: this is the reverse of the meaning of *TOP_P.  */
+      offset_to_top
+	= value_as_long (value_field (vtable, vtable_field_offset_to_top));
+
+      (*cache)[vtable_addr] = { run_time_type, offset_to_top };
+    }
 
   if (full_p)
     *full_p = (- offset_to_top == value->embedded_offset ()
@@ -1613,4 +1700,11 @@ _initialize_gnu_v3_abi ()
 
   register_cp_abi (&gnu_v3_abi_ops);
   set_cp_abi_as_auto_default (gnu_v3_abi_ops.shortname);
+
+  gdb::observers::new_objfile.attach (rtti_cache_new_objfile_observer,
+				      "gnu-v3-abi");
+  gdb::observers::free_objfile.attach (rtti_cache_free_objfile_observer,
+				       "gnu-v3-abi");
+  gdb::observers::all_objfiles_removed.attach (rtti_cache_all_objfiles_removed,
+					       "gnu-v3-abi");
 }
@@ -1299,6 +1299,14 @@ call_function_by_hand_dummy (struct value *function,
      inferior.  That way it breaks when it returns.  */
 
   {
+    /* This block creates several breakpoints (the return breakpoint,
+       the longjmp clones, and possibly a std::terminate breakpoint);
+       rebuild the global location list only once for all of them.
+       The rebuild scales with the total number of breakpoint
+       locations, and pretty printers that call inferior helpers can
+       make thousands of calls per stop.  */
+    scoped_defer_update_global_location_list defer_ugll;
+
     symtab_and_line sal;
     sal.pspace = current_program_space;
     sal.pc = bp_addr;
@@ -1326,22 +1334,22 @@ call_function_by_hand_dummy (struct value *function,
 	  longjmp_b = longjmp_b->related_breakpoint;
 	longjmp_b->related_breakpoint = bpt;
       }
-  }
 
-  /* Create a breakpoint in std::terminate.
-     If a C++ exception is raised in the dummy-frame, and the
-     exception handler is (normally, and expected to be) out-of-frame,
-     the default C++ handler will (wrongly) be called in an inferior
-     function call.  This is wrong, as an exception can be  normally
-     and legally handled out-of-frame.  The confines of the dummy frame
-     prevent the unwinder from finding the correct handler (or any
-     handler, unless it is in-frame).  The default handler calls
-     std::terminate.  This will kill the inferior.  Assert that
-     terminate should never be called in an inferior function
-     call.  Place a momentary breakpoint in the std::terminate function
-     and if triggered in the call, rewind.  */
-  if (unwind_on_terminating_exception_p)
-    set_std_terminate_breakpoint ();
+    /* Create a breakpoint in std::terminate.
+       If a C++ exception is raised in the dummy-frame, and the
+       exception handler is (normally, and expected to be) out-of-frame,
+       the default C++ handler will (wrongly) be called in an inferior
+       function call.  This is wrong, as an exception can be  normally
+       and legally handled out-of-frame.  The confines of the dummy frame
+       prevent the unwinder from finding the correct handler (or any
+       handler, unless it is in-frame).  The default handler calls
+       std::terminate.  This will kill the inferior.  Assert that
+       terminate should never be called in an inferior function
+       call.  Place a momentary breakpoint in the std::terminate function
+       and if triggered in the call, rewind.  */
+    if (unwind_on_terminating_exception_p)
+      set_std_terminate_breakpoint ();
+  }
 
   /* Everything's ready, push all the info needed to restore the
      caller (and identify the dummy-frame) onto the dummy-frame
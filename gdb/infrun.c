@@ -1287,6 +1287,7 @@ follow_exec (ptid_t ptid, const char *exec_file_target)
   th->control.step_resume_breakpoint = nullptr;
   th->control.exception_resume_breakpoint = nullptr;
   th->control.single_step_breakpoints = nullptr;
+  th->control.cached_single_step_breakpoints = nullptr;
   th->control.step_range_start = 0;
   th->control.step_range_end = 0;
 
@@ -2739,6 +2740,11 @@ resume_1 (enum gdb_signal sig)
      use singlestep breakpoint.  */
   gdb_assert (!(thread_has_single_step_breakpoints_set (tp) && step));
 
+  /* If the single-step breakpoints recycled from the previous step
+     were not reused above, this resume doesn't want them; get rid of
+     them before the thread runs again.  */
+  flush_single_step_breakpoint_cache (tp);
+
   /* Decide the set of threads to ask the target to resume.  */
   if (tp->control.trap_expected)
     {
@@ -3792,6 +3798,15 @@ delete_just_stopped_threads_single_step_breakpoints (void)
   for_each_just_stopped_thread (delete_single_step_breakpoints);
 }
 
+/* Recycle the single-step breakpoints of the threads that just
+   stopped, so that a following step can reuse them.  */
+
+static void
+recycle_just_stopped_threads_single_step_breakpoints (void)
+{
+  for_each_just_stopped_thread (recycle_single_step_breakpoints);
+}
+
 /* See infrun.h.  */
 
 void
@@ -5394,6 +5409,12 @@ stop_all_threads (const char *reason, inferior *inf)
 	      update_thread_list ();
 	    }
 
+	  /* Threads to stop, collected per target so that each target
+	     gets a single batched stop request instead of one request
+	     per thread.  */
+	  std::unordered_map<process_stratum_target *, std::vector<ptid_t>>
+	    stop_requests;
+
 	  /* Go through all threads looking for threads that we need
 	     to tell the target to stop.  */
 	  for (thread_info *t : all_non_exited_threads ())
@@ -5420,7 +5441,8 @@ stop_all_threads (const char *reason, inferior *inf)
 		    {
 		      infrun_debug_printf ("  %s executing, need stop",
 					   t->ptid.to_string ().c_str ());
-		      target_stop (t->ptid);
+		      stop_requests[t->inf->process_target ()]
+			.push_back (t->ptid);
 		      t->stop_requested = 1;
 		    }
 		  else
@@ -5443,6 +5465,13 @@ stop_all_threads (const char *reason, inferior *inf)
 		}
 	    }
 
+	  /* Request the stops in one batch per target.  */
+	  for (auto &entry : stop_requests)
+	    {
+	      switch_to_target_no_thread (entry.first);
+	      target_stop_threads (entry.second);
+	    }
+
 	  if (waits_needed == 0)
 	    break;
 
@@ -6532,7 +6561,13 @@ handle_signal_stop (struct execution_control_state *ecs)
 			       ecs->ptid.to_string ().c_str ());
 	}
     }
-  delete_just_stopped_threads_single_step_breakpoints ();
+
+  /* Recycle rather than delete the single-step breakpoints: if we're
+     in the middle of stepping through a loop, the next step will ask
+     for the very same breakpoints again.  If they're not reused,
+     they're flushed when the thread is next resumed, or when the
+     stop is presented to the user.  */
+  recycle_just_stopped_threads_single_step_breakpoints ();
 
   if (ecs->event_thread->stop_signal () == GDB_SIGNAL_TRAP
       && ecs->event_thread->control.trap_expected
@@ -8969,6 +9004,11 @@ normal_stop ()
 	(user_visible_resume_target (finish_ptid), finish_ptid);
     }
 
+  /* If the step that just finished recycled its single-step
+     breakpoints, they won't be reused now that we're presenting the
+     stop to the user; get rid of them.  */
+  for_each_just_stopped_thread (flush_single_step_breakpoint_cache);
+
   /* As we're presenting a stop, and potentially removing breakpoints,
      update the thread list so we can tell whether there are threads
      running on the target.  With target remote, for example, we can
@@ -277,23 +277,19 @@ const struct frame_unwind inline_frame_unwind = {
 
 /* Return non-zero if BLOCK, an inlined function block containing PC,
    has a group of contiguous instructions starting at PC (but not
-   before it).  */
+   before it).  PREV_BLOCK is the block containing PC - 1 in the same
+   blockvector, or NULL if no block does; it does not depend on BLOCK,
+   so the caller looks it up once and shares it across all the inline
+   levels at PC.  */
 
 static int
-block_starting_point_at (CORE_ADDR pc, const struct block *block)
+block_starting_point_at (CORE_ADDR pc, const struct block *block,
+			 const struct block *prev_block)
 {
-  const struct blockvector *bv;
-  const struct block *new_block;
-
-  bv = blockvector_for_pc (pc, NULL);
-  if (bv->map () == nullptr)
-    return 0;
-
-  new_block = (const struct block *) bv->map ()->find (pc - 1);
-  if (new_block == NULL)
+  if (prev_block == NULL)
     return 1;
 
-  if (new_block == block || block->contains (new_block))
+  if (prev_block == block || block->contains (prev_block))
     return 0;
 
   /* The immediately preceding address belongs to a different block,
@@ -350,10 +346,20 @@ skip_inline_frames (thread_info *thread, bpstat *stop_chain)
      cache.  We try not to do more unwinding than absolutely
      necessary, for performance.  */
   CORE_ADDR this_pc = get_frame_pc (get_current_frame ());
-  frame_block = block_for_pc (this_pc);
+  frame_block = nullptr;
+  const struct blockvector *bv = blockvector_for_pc (this_pc, &frame_block);
 
   if (frame_block != NULL)
     {
+      /* The block tree is flattened into the blockvector's address
+	 map when the symtab is built; resolve PC - 1 through it once
+	 here instead of once per inline level below.  Without a map
+	 we cannot tell where a block's instructions start.  */
+      bool have_map = bv->map () != nullptr;
+      const struct block *prev_block = nullptr;
+      if (have_map)
+	prev_block = (const struct block *) bv->map ()->find (this_pc - 1);
+
       cur_block = frame_block;
       while (cur_block->superblock ())
 	{
@@ -362,7 +368,9 @@ skip_inline_frames (thread_info *thread, bpstat *stop_chain)
 	      /* See comments in inline_frame_this_id about this use
 		 of BLOCK_ENTRY_PC.  */
 	      if (cur_block->entry_pc () == this_pc
-		  || block_starting_point_at (this_pc, cur_block))
+		  || (have_map
+		      && block_starting_point_at (this_pc, cur_block,
+						  prev_block)))
 		{
 		  /* Do not skip the inlined frame if execution
 		     stopped in an inlined frame because of a user
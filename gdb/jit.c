@@ -737,12 +737,16 @@ jit_reader_try_read_symtab (gdbarch *gdbarch, jit_code_entry *code_entry,
 }
 
 /* Try to read CODE_ENTRY using BFD.  ENTRY_ADDR is the address of the
-   struct jit_code_entry in the inferior address space.  */
+   struct jit_code_entry in the inferior address space.  ADD_FLAGS is
+   passed on to the symbol file reading machinery; callers registering
+   several entries in a row pass SYMFILE_DEFER_BP_RESET and re-set
+   breakpoints once at the end.  */
 
 static void
 jit_bfd_try_read_symtab (struct jit_code_entry *code_entry,
 			 CORE_ADDR entry_addr,
-			 struct gdbarch *gdbarch)
+			 struct gdbarch *gdbarch,
+			 symfile_add_flags add_flags)
 {
   struct bfd_section *sec;
   struct objfile *objfile;
@@ -794,8 +798,8 @@ JITed symbol file is not an object file, ignoring it.\n"));
 
   /* This call does not take ownership of SAI.  */
   objfile = symbol_file_add_from_bfd (nbfd,
-				      bfd_get_filename (nbfd.get ()), 0,
-				      &sai,
+				      bfd_get_filename (nbfd.get ()),
+				      add_flags, &sai,
 				      OBJF_SHARED | OBJF_NOT_FILENAME, NULL);
 
   add_objfile_entry (objfile, entry_addr, code_entry->symfile_addr,
@@ -805,11 +809,13 @@ JITed symbol file is not an object file, ignoring it.\n"));
 /* This function registers code associated with a JIT code entry.  It uses the
    pointer and size pair in the entry to read the symbol file from the remote
    and then calls symbol_file_add_from_local_memory to add it as though it were
-   a symbol file added by the user.  */
+   a symbol file added by the user.  ADD_FLAGS is passed on to the symbol
+   file reading machinery.  */
 
 static void
 jit_register_code (struct gdbarch *gdbarch,
-		   CORE_ADDR entry_addr, struct jit_code_entry *code_entry)
+		   CORE_ADDR entry_addr, struct jit_code_entry *code_entry,
+		   symfile_add_flags add_flags)
 {
   int success;
 
@@ -820,7 +826,7 @@ jit_register_code (struct gdbarch *gdbarch,
   success = jit_reader_try_read_symtab (gdbarch, code_entry, entry_addr);
 
   if (!success)
-    jit_bfd_try_read_symtab (code_entry, entry_addr, gdbarch);
+    jit_bfd_try_read_symtab (code_entry, entry_addr, gdbarch, add_flags);
 }
 
 /* Look up the objfile with this code entry address.  */
@@ -1161,6 +1167,7 @@ jit_inferior_init (inferior *inf)
   CORE_ADDR cur_entry_addr;
   struct gdbarch *gdbarch = inf->gdbarch;
   program_space *pspace = inf->pspace;
+  int registered = 0;
 
   jit_debug_printf ("called");
 
@@ -1179,18 +1186,20 @@ jit_inferior_init (inferior *inf)
 	continue;
 
       /* Check that the version number agrees with that we support.  */
-      if (descriptor.version != 1)
+      if (descriptor.version != 1 && descriptor.version != 2)
 	{
 	  gdb_printf (gdb_stderr,
 		      _("Unsupported JIT protocol version %ld "
-			"in descriptor (expected 1)\n"),
+			"in descriptor (expected 1 or 2)\n"),
 		      (long) descriptor.version);
 	  continue;
 	}
 
       /* If we've attached to a running program, we need to check the
 	 descriptor to register any functions that were already
-	 generated.  */
+	 generated.  Defer re-setting breakpoints until the whole list
+	 has been read; with many entries, re-setting them once per
+	 entry dominates the time spent here.  */
       for (cur_entry_addr = descriptor.first_entry;
 	   cur_entry_addr != 0;
 	   cur_entry_addr = cur_entry.next_entry)
@@ -1202,9 +1211,14 @@ jit_inferior_init (inferior *inf)
 	  if (jit_find_objf_with_entry_addr (cur_entry_addr) != NULL)
 	    continue;
 
-	  jit_register_code (gdbarch, cur_entry_addr, &cur_entry);
+	  jit_register_code (gdbarch, cur_entry_addr, &cur_entry,
+			     SYMFILE_DEFER_BP_RESET);
+	  registered++;
 	}
     }
+
+  if (registered > 0)
+    breakpoint_re_set ();
 }
 
 /* inferior_created observer.  */
@@ -1269,8 +1283,38 @@ jit_event_handler (gdbarch *gdbarch, objfile *jiter)
     case JIT_REGISTER:
       {
 	jit_code_entry code_entry;
-	jit_read_code_entry (gdbarch, entry_addr, &code_entry);
-	jit_register_code (gdbarch, entry_addr, &code_entry);
+
+	if (descriptor.version >= 2)
+	  {
+	    /* Version 2 of the interface allows batched registration:
+	       RELEVANT_ENTRY points at the first of a chain of
+	       entries, linked through NEXT_ENTRY, that were all added
+	       since the previous event.  Register the whole chain in
+	       this one stop, stopping at the first entry we already
+	       know about, and re-set breakpoints just once for the
+	       lot instead of once per symbol file.  */
+	    int registered = 0;
+
+	    while (entry_addr != 0
+		   && jit_find_objf_with_entry_addr (entry_addr) == nullptr)
+	      {
+		jit_read_code_entry (gdbarch, entry_addr, &code_entry);
+		jit_register_code (gdbarch, entry_addr, &code_entry,
+				   SYMFILE_DEFER_BP_RESET);
+		registered++;
+		entry_addr = code_entry.next_entry;
+	      }
+
+	    jit_debug_printf ("registered batch of %d entries", registered);
+
+	    if (registered > 0)
+	      breakpoint_re_set ();
+	  }
+	else
+	  {
+	    jit_read_code_entry (gdbarch, entry_addr, &code_entry);
+	    jit_register_code (gdbarch, entry_addr, &code_entry, 0);
+	  }
 	break;
       }
 
@@ -645,6 +645,19 @@ inf_has_multiple_threads ()
   return false;
 }
 
+/* A checkpoint is a forked copy of the inferior, and fork already
+   gives us page-level copy-on-write snapshots in the kernel: the
+   checkpoint shares every page with the inferior until one of them
+   writes to it, so fifty checkpoints of a large process cost the page
+   tables plus the pages actually dirtied since each fork, not fifty
+   copies of the address space.  A user-space page store deduplicated
+   by content hash could not do better for unchanged pages and would
+   lose what fork preserves beyond memory -- file descriptors, signal
+   state and the rest of the kernel side of the process, which is what
+   makes restarting a checkpoint reliable.  Where identical pages
+   dirtied to the same content across checkpoints matter, the kernel's
+   same-page merging handles that without our involvement.  */
+
 static void
 checkpoint_command (const char *args, int from_tty)
 {
@@ -402,6 +402,10 @@ macro_define_command (const char *exp, int from_tty)
       macro_define_object (macro_main (macro_user_macros), -1, name.get (),
 			   exp);
     }
+
+  /* The new definition may shadow one that memoized expansions refer
+     to.  */
+  macro_expansion_flush_cache ();
 }
 
 
@@ -416,6 +420,7 @@ macro_undef_command (const char *exp, int from_tty)
   if (name == nullptr)
     error (_("Invalid macro name."));
   macro_undef (macro_main (macro_user_macros), -1, name.get ());
+  macro_expansion_flush_cache ();
 }
 
 
@@ -23,6 +23,8 @@
 #include "macroexp.h"
 #include "macroscope.h"
 #include "c-lang.h"
+#include "observable.h"
+#include <unordered_map>
 
 
 
@@ -1192,6 +1194,134 @@ substitute_args (growable_macro_buffer *dest,
 }
 
 
+/* Memoized macro expansions.
+
+   Fully expanding a macro invocation is expensive: the replacement
+   list is re-tokenized and re-scanned for nested references every
+   time, and configuration macros routinely expand to kilobytes of
+   text.  Identical invocations are re-expanded each time an
+   expression mentioning them is parsed.  The result of a top-level
+   expansion is a pure function of the macro's name and definition,
+   the spelling of its arguments, and the scope used to look up
+   nested references, so it can be cached under that key.
+
+   The cache is flushed whenever an objfile goes away (the definition
+   and source-file pointers in the keys belong to objfiles' macro
+   tables) and whenever the table of user-defined macros changes.  */
+
+struct macro_expansion_key
+{
+  /* The name the macro was invoked by.  The definition alone is not
+     enough: the name is excluded from re-expansion while the
+     replacement list is rescanned, so two macros sharing one
+     definition can still expand differently.  */
+  std::string name;
+
+  /* The macro's definition, and the scope nested references were
+     looked up in.  */
+  const macro_definition *def;
+  const macro_source_file *file;
+  int line;
+
+  /* For a function-like macro, the spelling of the argument list as
+     written, including the parentheses; empty for an object-like
+     macro.  */
+  std::string args;
+
+  bool operator== (const macro_expansion_key &other) const
+  {
+    return (def == other.def
+	    && file == other.file
+	    && line == other.line
+	    && name == other.name
+	    && args == other.args);
+  }
+};
+
+struct macro_expansion_key_hash
+{
+  size_t operator() (const macro_expansion_key &key) const
+  {
+    size_t result = std::hash<const void *> () (key.def);
+    result = result * 31 + std::hash<const void *> () (key.file);
+    result = result * 31 + key.line;
+    result = result * 31 + std::hash<std::string> () (key.name);
+    result = result * 31 + std::hash<std::string> () (key.args);
+    return result;
+  }
+};
+
+/* A cached expansion: the expanded text, and the offset of the last
+   token in it, for splice detection when it is appended to another
+   buffer.  */
+
+struct macro_expansion_result
+{
+  std::string text;
+  int last_token;
+};
+
+static std::unordered_map<macro_expansion_key, macro_expansion_result,
+			  macro_expansion_key_hash> expansion_cache;
+
+/* See macroexp.h.  */
+
+void
+macro_expansion_flush_cache ()
+{
+  expansion_cache.clear ();
+}
+
+/* If the expansion for KEY is in the cache, append it to DEST and
+   return non-zero.  Otherwise return zero and leave DEST unchanged.  */
+
+static int
+append_cached_expansion (growable_macro_buffer *dest,
+			 const macro_expansion_key &key)
+{
+  auto it = expansion_cache.find (key);
+  if (it == expansion_cache.end ())
+    return 0;
+
+  if (!it->second.text.empty ())
+    {
+      shared_macro_buffer src (it->second.text.c_str (),
+			       it->second.text.size ());
+      src.last_token = it->second.last_token;
+      append_tokens_without_splicing (dest, &src);
+    }
+  return 1;
+}
+
+/* Record EXPANSION as the expansion for KEY.  */
+
+static void
+record_expansion (macro_expansion_key &&key,
+		  const growable_macro_buffer &expansion)
+{
+  macro_expansion_result result;
+  if (expansion.len > 0)
+    result.text = std::string (expansion.text, expansion.len);
+  result.last_token = expansion.last_token;
+  expansion_cache.emplace (std::move (key), std::move (result));
+}
+
+/* Append the expansion accumulated in SRC to DEST, taking care not to
+   splice tokens at the boundary.  */
+
+static void
+append_expansion_buffer (growable_macro_buffer *dest,
+			 const growable_macro_buffer &src)
+{
+  if (src.len == 0)
+    return;
+
+  shared_macro_buffer view (src.text, src.len);
+  view.last_token = src.last_token;
+  append_tokens_without_splicing (dest, &view);
+}
+
+
 /* Expand a call to a macro named ID, whose definition is DEF.  Append
    its expansion to DEST.  SRC is the input text following the ID
    token.  We are currently rescanning the expansions of the macros
@@ -1222,10 +1352,24 @@ expand (const char *id,
   /* What kind of macro are we expanding?  */
   if (def->kind == macro_object_like)
     {
+      /* Only top-level expansions are memoized: while rescanning, the
+	 macros named in NO_LOOP are excluded from re-expansion, so the
+	 same invocation can legitimately expand differently there.  */
+      macro_expansion_key key { id, def, scope.file, scope.line,
+				std::string () };
+      if (no_loop == NULL && append_cached_expansion (dest, key))
+	return 1;
+
       shared_macro_buffer replacement_list (def->replacement,
 					    strlen (def->replacement));
 
-      scan (dest, &replacement_list, &new_no_loop, scope);
+      growable_macro_buffer expansion (0);
+      expansion.last_token = 0;
+      scan (&expansion, &replacement_list, &new_no_loop, scope);
+
+      if (no_loop == NULL)
+	record_expansion (std::move (key), expansion);
+      append_expansion_buffer (dest, expansion);
       return 1;
     }
   else if (def->kind == macro_function_like)
@@ -1258,6 +1402,10 @@ expand (const char *id,
 	    }
 	}
 
+      /* Remember where the argument list starts, so that its spelling
+	 can be used as part of the memoization key below.  */
+      const char *args_start = src->text;
+
       std::vector<shared_macro_buffer> argv;
       /* If we couldn't find any argument list, then we don't expand
 	 this macro.  */
@@ -1284,6 +1432,15 @@ expand (const char *id,
 		   id, def->argc, int (argv.size ()));
 	}
 
+      /* As in the object-like case above, only top-level expansions
+	 are memoized.  The argument list had to be gathered either
+	 way, to find where the invocation ends.  */
+      macro_expansion_key key { id, def, scope.file, scope.line,
+				std::string (args_start,
+					     src->text - args_start) };
+      if (no_loop == NULL && append_cached_expansion (dest, key))
+	return 1;
+
       /* Note that we don't expand macro invocations in the arguments
 	 yet --- we let subst_args take care of that.  Parameters that
 	 appear as operands of the stringifying operator "#" or the
@@ -1305,7 +1462,14 @@ expand (const char *id,
 	 `substituted's original text buffer after scanning it so we
 	 can free it.  */
       shared_macro_buffer substituted_src (substituted.text, substituted.len);
-      scan (dest, &substituted_src, &new_no_loop, scope);
+
+      growable_macro_buffer expansion (0);
+      expansion.last_token = 0;
+      scan (&expansion, &substituted_src, &new_no_loop, scope);
+
+      if (no_loop == NULL)
+	record_expansion (std::move (key), expansion);
+      append_expansion_buffer (dest, expansion);
 
       return 1;
     }
@@ -1448,3 +1612,28 @@ macro_expand_next (const char **lexptr, const macro_scope &scope)
       return nullptr;
     }
 }
+
+/* The definition and source-file pointers in the expansion cache keys
+   belong to objfiles' macro tables, so the cache cannot outlive any
+   objfile.  */
+
+static void
+macroexp_free_objfile (struct objfile *objfile)
+{
+  macro_expansion_flush_cache ();
+}
+
+static void
+macroexp_all_objfiles_removed (program_space *pspace)
+{
+  macro_expansion_flush_cache ();
+}
+
+void _initialize_macroexp ();
+void
+_initialize_macroexp ()
+{
+  gdb::observers::free_objfile.attach (macroexp_free_objfile, "macroexp");
+  gdb::observers::all_objfiles_removed.attach (macroexp_all_objfiles_removed,
+					       "macroexp");
+}
@@ -71,6 +71,12 @@ gdb::unique_xmalloc_ptr<char> macro_expand_once (const char *source,
 gdb::unique_xmalloc_ptr<char> macro_expand_next (const char **lexptr,
 						 const macro_scope &scope);
 
+/* Discard all memoized macro expansions.  This must be called
+   whenever the set of macro definitions changes behind the
+   expander's back, for instance when a user-defined macro is added
+   or removed.  */
+void macro_expansion_flush_cache ();
+
 /* Functions to classify characters according to cpp rules.  */
 
 int macro_is_whitespace (int c);
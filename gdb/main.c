@@ -1320,6 +1320,11 @@ captured_main_1 (struct captured_main_args *context)
      read.  */
   init_history ();
 
+  /* Startup is done; stop recording times for "maint time startup"
+     so that scripts sourced later are not mistaken for startup
+     costs.  */
+  maint_startup_timing_complete ();
+
   if (batch_flag)
     {
       int error_status = EXIT_FAILURE;
@@ -22,6 +22,7 @@
 
 #include "defs.h"
 #include "arch-utils.h"
+#include <algorithm>
 #include <ctype.h>
 #include <cmath>
 #include <signal.h>
@@ -40,8 +41,16 @@
 #include "top.h"
 #include "maint.h"
 #include "gdbsupport/selftest.h"
+#include "run-on-main-thread.h"
 #include "inferior.h"
 #include "gdbsupport/thread-pool.h"
+#include "cp-support.h"
+#include <map>
+
+#if defined (HAVE_EXECINFO_H) && defined (HAVE_EXECINFO_BACKTRACE)
+#include <execinfo.h>
+#include <sys/time.h>
+#endif
 
 #include "cli/cli-decode.h"
 #include "cli/cli-utils.h"
@@ -118,6 +127,117 @@ maintenance_time_display (const char *args, int from_tty)
     set_per_command_time (strtol (args, NULL, 10));
 }
 
+/* One startup phase recorded by a scoped_startup_timer.  */
+
+struct startup_time_record
+{
+  /* A short tag saying what NAME is; points to a string literal.  */
+  const char *kind;
+
+  /* The initializer or script the time is attributed to.  */
+  std::string name;
+
+  /* Wall-clock time spent in it.  */
+  std::chrono::steady_clock::duration time;
+};
+
+/* The phases recorded during startup, in execution order.  */
+
+static std::vector<startup_time_record> startup_time_records;
+
+/* True until maint_startup_timing_complete is called; afterwards
+   scoped_startup_timer records nothing, so that scripts sourced from
+   the command line later do not show up as startup costs.  */
+
+static bool recording_startup_times = true;
+
+/* See maint.h.  */
+
+scoped_startup_timer::scoped_startup_timer (const char *kind,
+					    std::string name)
+  : m_kind (kind),
+    m_name (std::move (name)),
+    m_recording (recording_startup_times)
+{
+  if (m_recording)
+    m_start_wall_time = std::chrono::steady_clock::now ();
+}
+
+/* See maint.h.  */
+
+scoped_startup_timer::~scoped_startup_timer ()
+{
+  if (m_recording && recording_startup_times)
+    {
+      std::chrono::steady_clock::duration time
+	= std::chrono::steady_clock::now () - m_start_wall_time;
+      startup_time_records.push_back ({ m_kind, std::move (m_name), time });
+    }
+}
+
+/* See maint.h.  */
+
+void
+maint_startup_timing_complete ()
+{
+  recording_startup_times = false;
+}
+
+/* Implement the "maint time startup" command.  */
+
+static void
+maintenance_time_startup (const char *args, int from_tty)
+{
+  if (startup_time_records.empty ())
+    {
+      gdb_printf (_("No startup times were recorded.\n"));
+      return;
+    }
+
+  /* Sort a copy by decreasing time; the most expensive phases are
+     what the user is after.  Note that a script sourcing another
+     script is attributed the nested script's time as well.  */
+  std::vector<const startup_time_record *> sorted;
+  sorted.reserve (startup_time_records.size ());
+  for (const startup_time_record &rec : startup_time_records)
+    sorted.push_back (&rec);
+  std::stable_sort (sorted.begin (), sorted.end (),
+		    [] (const startup_time_record *lhs,
+			const startup_time_record *rhs)
+		    { return lhs->time > rhs->time; });
+
+  std::chrono::steady_clock::duration total
+    = std::chrono::steady_clock::duration::zero ();
+
+  struct ui_out *uiout = current_uiout;
+  ui_out_emit_table table_emitter (uiout, 3, (int) sorted.size (),
+				   "StartupTimes");
+  uiout->table_header (10, ui_right, "time", "msec");
+  uiout->table_header (6, ui_left, "kind", "Kind");
+  uiout->table_header (40, ui_left, "name", "Name");
+  uiout->table_body ();
+
+  for (const startup_time_record *rec : sorted)
+    {
+      using float_msec = std::chrono::duration<double, std::milli>;
+
+      ui_out_emit_tuple tuple_emitter (uiout, nullptr);
+      uiout->field_string ("time",
+			   string_printf ("%.3f",
+					  float_msec (rec->time).count ()));
+      uiout->field_string ("kind", rec->kind);
+      uiout->field_string ("name", rec->name.c_str ());
+      uiout->text ("\n");
+
+      if (strcmp (rec->kind, "init") == 0)
+	total += rec->time;
+    }
+
+  using float_sec = std::chrono::duration<double>;
+  uiout->message (_("Total time in initializers: %.3f seconds.\n"),
+		  float_sec (total).count ());
+}
+
 static void
 maintenance_space_display (const char *args, int from_tty)
 {
@@ -842,6 +962,342 @@ maintenance_set_profile_cmd (const char *args, int from_tty,
 }
 #endif
 
+/* Sampling self-profiler for "maint profile start/stop".
+
+   While active, an interval timer periodically samples GDB's own
+   call stack from the SIGPROF handler into a preallocated buffer.
+   "maint profile stop" symbolizes the samples and writes them in
+   collapsed-stack format -- one line per unique stack, the frames
+   separated by semicolons and followed by a sample count -- which
+   flamegraph tools consume directly.  Each sample is tagged with the
+   command executing at the time it was taken, and the command
+   appears as the root frame of its stacks, so the cost of a slow
+   command can be read off directly.  */
+
+/* The "maint profile" command list.  */
+static struct cmd_list_element *maintenance_profile_cmdlist;
+
+/* The command line currently executing, as last noted by
+   maint_profile_note_command, or empty between commands.  Kept
+   outside the self-profiler's configure guard because the remote
+   packet accounting also uses it, on every host, to attribute
+   traffic to commands.  */
+
+static std::string current_command_line;
+
+/* See maint.h.  */
+
+const char *
+maint_current_command ()
+{
+  if (current_command_line.empty ())
+    return nullptr;
+  return current_command_line.c_str ();
+}
+
+#if defined (HAVE_EXECINFO_H) && defined (HAVE_EXECINFO_BACKTRACE) \
+  && defined (ITIMER_PROF)
+
+/* Sampling frequency.  ITIMER_PROF counts CPU time, so time spent
+   blocked (at the prompt, or waiting for the target) produces no
+   samples.  */
+#define PROFILE_HZ 250
+
+/* Maximum number of frames kept per sample.  */
+#define PROFILE_MAX_DEPTH 64
+
+/* Size of the sample buffer, in words.  Each sample occupies two
+   header words (frame count and command tag) plus one word per
+   frame.  The buffer is allocated in its entirety up front because
+   the signal handler must not allocate; at PROFILE_HZ and typical
+   stack depths it holds many minutes of samples.  */
+#define PROFILE_BUFFER_WORDS (1 << 21)
+
+/* The sample buffer, and how much of it is used.  Only the SIGPROF
+   handler writes to these while profiling is active.  */
+
+static uintptr_t *profile_buffer;
+static volatile size_t profile_buffer_used;
+
+/* The number of samples discarded because the buffer was full.  */
+
+static volatile unsigned long profile_samples_dropped;
+
+/* Nonzero while the timer is running.  */
+
+static volatile sig_atomic_t profile_active;
+
+/* The names of the commands seen while profiling.  Index 0 is
+   reserved for samples taken outside any command.  The signal
+   handler only reads PROFILE_CURRENT_TAG, never the vector, so the
+   vector can be grown safely between signals.  */
+
+static std::vector<std::string> profile_tag_names;
+static volatile sig_atomic_t profile_current_tag;
+
+/* Where "maint profile stop" will write the collapsed stacks.  */
+
+static std::string profile_filename;
+
+/* The SIGPROF handler: record one sample.  backtrace is safe to
+   call here because "maint profile start" primed it -- only its
+   first call may allocate, while the unwinder support code is
+   loaded.  */
+
+static void
+profile_signal_handler (int sig)
+{
+  if (!profile_active)
+    return;
+
+  void *frames[PROFILE_MAX_DEPTH];
+  int depth = backtrace (frames, PROFILE_MAX_DEPTH);
+
+  /* Skip this handler and the signal trampoline, keeping the
+     interrupted frame innermost.  */
+  int first = depth >= 3 ? 2 : 0;
+  if (depth <= first)
+    return;
+
+  size_t used = profile_buffer_used;
+  if (used + (depth - first) + 2 > PROFILE_BUFFER_WORDS)
+    {
+      ++profile_samples_dropped;
+      return;
+    }
+
+  profile_buffer[used++] = depth - first;
+  profile_buffer[used++] = profile_current_tag;
+  for (int i = first; i < depth; ++i)
+    profile_buffer[used++] = (uintptr_t) frames[i];
+  profile_buffer_used = used;
+}
+
+/* See maint.h.  */
+
+void
+maint_profile_note_command (const char *line)
+{
+  current_command_line = line;
+
+  if (!profile_active)
+    return;
+
+  /* Semicolons separate frames in the collapsed output, so they
+     cannot appear in the tag.  */
+  std::string name (line);
+  for (char &c : name)
+    if (c == ';')
+      c = ',';
+
+  /* Reuse the tag of an earlier invocation of the same command, so
+     that its samples fold together.  */
+  for (size_t i = 1; i < profile_tag_names.size (); ++i)
+    if (profile_tag_names[i] == name)
+      {
+	profile_current_tag = i;
+	return;
+      }
+
+  profile_tag_names.push_back (std::move (name));
+  profile_current_tag = profile_tag_names.size () - 1;
+}
+
+/* Called when a command finishes: attribute subsequent samples to
+   the event loop again.  */
+
+static void
+profile_command_finished ()
+{
+  profile_current_tag = 0;
+}
+
+/* Return a human-readable name for the PC ADDR, given SYMBOL, the
+   corresponding entry of a backtrace_symbols array (of the form
+   "object(mangled+0x10) [0xADDR]"), or NULL if symbolization
+   failed.  */
+
+static std::string
+profile_symbol_name (const char *symbol, uintptr_t addr)
+{
+  if (symbol != nullptr)
+    {
+      const char *open = strchr (symbol, '(');
+      if (open != nullptr)
+	{
+	  const char *end = open + 1;
+	  while (*end != '\0' && *end != '+' && *end != ')')
+	    ++end;
+	  if (end > open + 1)
+	    {
+	      std::string mangled (open + 1, end);
+	      gdb::unique_xmalloc_ptr<char> demangled
+		= gdb_demangle (mangled.c_str (), DMGL_ANSI);
+	      if (demangled != nullptr)
+		return demangled.get ();
+	      return mangled;
+	    }
+	}
+    }
+
+  return hex_string (addr);
+}
+
+/* The "maint profile start" command.  */
+
+static void
+maintenance_profile_start_cmd (const char *args, int from_tty)
+{
+  if (profile_active)
+    error (_("Self-profiling is already active."));
+
+  std::string filename = "gdb.folded";
+  if (args != nullptr && *args != '\0')
+    filename = args;
+
+  if (profile_buffer == nullptr)
+    profile_buffer = XNEWVEC (uintptr_t, PROFILE_BUFFER_WORDS);
+  profile_buffer_used = 0;
+  profile_samples_dropped = 0;
+  profile_tag_names.clear ();
+  profile_tag_names.emplace_back ("<no command>");
+  profile_current_tag = 0;
+  profile_filename = std::move (filename);
+
+  /* Prime backtrace; see profile_signal_handler.  */
+  {
+    void *frames[4];
+    backtrace (frames, ARRAY_SIZE (frames));
+  }
+
+  struct sigaction sa {};
+  sa.sa_handler = profile_signal_handler;
+  sigemptyset (&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  if (sigaction (SIGPROF, &sa, nullptr) != 0)
+    perror_with_name (("sigaction"));
+
+  profile_active = 1;
+
+  struct itimerval timer {};
+  timer.it_interval.tv_usec = 1000000 / PROFILE_HZ;
+  timer.it_value = timer.it_interval;
+  if (setitimer (ITIMER_PROF, &timer, nullptr) != 0)
+    {
+      profile_active = 0;
+      perror_with_name (("setitimer"));
+    }
+
+  if (from_tty)
+    gdb_printf (_("Self-profiling started at %d Hz; "
+		  "\"maintenance profile stop\" will write %s.\n"),
+		PROFILE_HZ, profile_filename.c_str ());
+}
+
+/* The "maint profile stop" command.  */
+
+static void
+maintenance_profile_stop_cmd (const char *args, int from_tty)
+{
+  if (!profile_active)
+    error (_("Self-profiling is not active."));
+
+  struct itimerval timer {};
+  setitimer (ITIMER_PROF, &timer, nullptr);
+  profile_active = 0;
+  signal (SIGPROF, SIG_DFL);
+
+  /* Symbolize each distinct PC once.  */
+  std::map<uintptr_t, std::string> names;
+  size_t used = profile_buffer_used;
+  for (size_t i = 0; i < used; i += profile_buffer[i] + 2)
+    for (size_t j = 0; j < profile_buffer[i]; ++j)
+      names[profile_buffer[i + 2 + j]];
+
+  {
+    std::vector<void *> addrs;
+    addrs.reserve (names.size ());
+    for (const auto &iter : names)
+      addrs.push_back ((void *) iter.first);
+
+    char **symbols = backtrace_symbols (addrs.data (), addrs.size ());
+    size_t idx = 0;
+    for (auto &iter : names)
+      {
+	iter.second = profile_symbol_name (symbols == nullptr
+					   ? nullptr : symbols[idx],
+					   iter.first);
+	++idx;
+      }
+    xfree (symbols);
+  }
+
+  /* Fold identical stacks.  A std::map keeps the output
+     deterministic.  The frames of a sample are stored innermost
+     first, while collapsed-stack format wants the root first.  */
+  std::map<std::string, unsigned long> folded;
+  for (size_t i = 0; i < used; i += profile_buffer[i] + 2)
+    {
+      size_t depth = profile_buffer[i];
+      std::string stack = profile_tag_names[profile_buffer[i + 1]];
+
+      for (size_t j = depth; j-- > 0; )
+	{
+	  stack += ';';
+	  stack += names[profile_buffer[i + 2 + j]];
+	}
+      ++folded[stack];
+    }
+
+  stdio_file out;
+  if (!out.open (profile_filename.c_str (), "w"))
+    perror_with_name (profile_filename.c_str ());
+
+  unsigned long nsamples = 0;
+  for (const auto &iter : folded)
+    {
+      out.printf ("%s %lu\n", iter.first.c_str (), iter.second);
+      nsamples += iter.second;
+    }
+
+  gdb_printf (_("Wrote %lu samples (%lu unique stacks) to %s.\n"),
+	      nsamples, (unsigned long) folded.size (),
+	      profile_filename.c_str ());
+  if (profile_samples_dropped > 0)
+    gdb_printf (_("%lu samples were dropped because the sample "
+		  "buffer was full.\n"),
+		(unsigned long) profile_samples_dropped);
+}
+
+#else /* No self-profiling support.  */
+
+/* See maint.h.  */
+
+void
+maint_profile_note_command (const char *line)
+{
+  current_command_line = line;
+}
+
+static void
+profile_command_finished ()
+{
+}
+
+static void
+maintenance_profile_start_cmd (const char *args, int from_tty)
+{
+  error (_("Self-profiling support is not available on this system."));
+}
+
+static void
+maintenance_profile_stop_cmd (const char *args, int from_tty)
+{
+  error (_("Self-profiling support is not available on this system."));
+}
+
+#endif
+
 static int n_worker_threads = -1;
 
 /* Update the thread pool for the desired number of threads.  */
@@ -852,7 +1308,7 @@ update_thread_pool_size ()
   int n_threads = n_worker_threads;
 
   if (n_threads < 0)
-    n_threads = std::thread::hardware_concurrency ();
+    n_threads = gdb::default_thread_count ();
 
   gdb::thread_pool::g_thread_pool->set_thread_count (n_threads);
 #endif
@@ -902,11 +1358,38 @@ static bool per_command_space;
 
 static bool per_command_symtab;
 
+/* One category of the per-command time breakdown.  */
+
+struct command_time_bucket
+{
+  std::chrono::steady_clock::duration time {};
+  unsigned long count = 0;
+};
+
+/* The breakdown of the current command's time, indexed by
+   command_time_category.  */
+
+static command_time_bucket command_time_buckets[COMMAND_TIME_NCATEGORIES];
+
+/* Bytes exchanged with, and round trips to, the target during the
+   current command.  */
+
+static ULONGEST command_target_io_bytes;
+static ULONGEST command_target_io_round_trips;
+
+/* The innermost live scoped_command_time on the main thread, if
+   any.  */
+
+static scoped_command_time *innermost_command_time;
+
 /* mt per-command commands.  */
 
 static struct cmd_list_element *per_command_setlist;
 static struct cmd_list_element *per_command_showlist;
 
+/* The "maint time" command list.  */
+static struct cmd_list_element *maintenance_time_cmdlist;
+
 /* Set whether to display time statistics to NEW_VALUE
    (non-zero means true).  */
 
@@ -963,6 +1446,11 @@ count_symtabs_and_blocks (int *nr_symtabs_ptr, int *nr_compunit_symtabs_ptr,
 
 scoped_command_stats::~scoped_command_stats ()
 {
+  /* The command is over; attribute any further profiling samples and
+     remote packets to the event loop again.  */
+  profile_command_finished ();
+  current_command_line.clear ();
+
   /* Early exit if we're not reporting any stats.  It can be expensive to
      compute the pre-command values so don't collect them at all if we're
      not reporting stats.  Alas this doesn't work in the startup case because
@@ -995,6 +1483,31 @@ scoped_command_stats::~scoped_command_stats ()
 		  : _("Command execution time: %.6f (cpu), %.6f (wall)\n"),
 		  duration<double> (cmd_time).count (),
 		  duration<double> (wall_time).count ());
+
+      /* Break down where the wall-clock time went, for the
+	 instrumented subsystems that were entered.  These are
+	 self-times -- nested regions are attributed to the innermost
+	 category only.  */
+      static const char *const category_names[COMMAND_TIME_NCATEGORIES]
+	= { "symbol lookup", "target I/O", "frame unwinding", "Python" };
+
+      for (int i = 0; i < COMMAND_TIME_NCATEGORIES; i++)
+	{
+	  const command_time_bucket &bucket = command_time_buckets[i];
+
+	  if (bucket.count == 0)
+	    continue;
+
+	  gdb_printf (gdb_stdlog, _("  %s: %.6f (wall), %lu times"),
+		      category_names[i],
+		      duration<double> (bucket.time).count (),
+		      bucket.count);
+	  if (i == COMMAND_TIME_TARGET_IO)
+	    gdb_printf (gdb_stdlog, _(", %s round trips, %s bytes"),
+			pulongest (command_target_io_round_trips),
+			pulongest (command_target_io_bytes));
+	  gdb_printf (gdb_stdlog, "\n");
+	}
     }
 
   if (m_space_enabled && per_command_space)
@@ -1056,6 +1569,12 @@ scoped_command_stats::scoped_command_stats (bool msg_type)
       m_start_wall_time = steady_clock::now ();
       m_time_enabled = true;
 
+      /* Start the per-category breakdown from a clean slate.  */
+      for (command_time_bucket &bucket : command_time_buckets)
+	bucket = {};
+      command_target_io_bytes = 0;
+      command_target_io_round_trips = 0;
+
       if (per_command_time)
 	print_time (_("command started"));
     }
@@ -1100,6 +1619,50 @@ scoped_command_stats::print_time (const char *msg)
   gdb_printf (gdb_stdlog, "%s.%03d - %s\n", out, (int) millis, msg);
 }
 
+/* See maint.h.  */
+
+scoped_command_time::scoped_command_time (command_time_category category)
+  : m_category (category),
+    m_active (per_command_time && is_main_thread ())
+{
+  if (!m_active)
+    return;
+
+  m_parent = innermost_command_time;
+  innermost_command_time = this;
+  m_start = std::chrono::steady_clock::now ();
+}
+
+scoped_command_time::~scoped_command_time ()
+{
+  if (!m_active)
+    return;
+
+  std::chrono::steady_clock::duration total
+    = std::chrono::steady_clock::now () - m_start;
+
+  command_time_bucket &bucket = command_time_buckets[m_category];
+  bucket.time += total - m_children;
+  bucket.count++;
+
+  if (m_parent != nullptr)
+    m_parent->m_children += total;
+  innermost_command_time = m_parent;
+}
+
+/* See maint.h.  */
+
+void
+command_stats_count_target_io (ULONGEST bytes, bool round_trip)
+{
+  if (!per_command_time || !is_main_thread ())
+    return;
+
+  command_target_io_bytes += bytes;
+  if (round_trip)
+    command_target_io_round_trips++;
+}
+
 /* Handle unknown "mt set per-command" arguments.
    In this case have "mt set per-command on|off" affect every setting.  */
 
@@ -1366,13 +1929,21 @@ displayed following the command's output."),
 			   NULL, NULL,
 			   &per_command_setlist, &per_command_showlist);
 
-  /* This is equivalent to "mt set per-command time on".
-     Kept because some people are used to typing "mt time 1".  */
-  add_cmd ("time", class_maintenance, maintenance_time_display, _("\
+  /* With a numeric argument this is equivalent to "mt set per-command
+     time on".  Kept because some people are used to typing "mt time 1".  */
+  add_prefix_cmd ("time", class_maintenance, maintenance_time_display, _("\
 Set the display of time usage.\n\
 If nonzero, will cause the execution time for each command to be\n\
 displayed, following the command's output."),
-	   &maintenancelist);
+		  &maintenance_time_cmdlist,
+		  1/*allow-unknown*/, &maintenancelist);
+
+  add_cmd ("startup", class_maintenance, maintenance_time_startup, _("\
+List the time spent in each phase of GDB's startup.\n\
+Shows the wall-clock time attributed to each initialization function\n\
+and each script sourced or auto-loaded before the first prompt, most\n\
+expensive first."),
+	   &maintenance_time_cmdlist);
 
   /* This is equivalent to "mt set per-command space on".
      Kept because some people are used to typing "mt space 1".  */
@@ -1446,6 +2017,27 @@ When enabled GDB is profiled."),
 			   &maintenance_set_cmdlist,
 			   &maintenance_show_cmdlist);
 
+  add_basic_prefix_cmd ("profile", class_maintenance, _("\
+Commands for sampling GDB's own call stacks."),
+			&maintenance_profile_cmdlist, 0,
+			&maintenancelist);
+
+  add_cmd ("start", class_maintenance, maintenance_profile_start_cmd, _("\
+Start sampling GDB's own call stacks.\n\
+Usage: maintenance profile start [FILE]\n\
+While sampling is active, GDB's call stack is recorded at regular\n\
+intervals of its own CPU time, and each sample is attributed to the\n\
+command executing when it was taken.  \"maintenance profile stop\"\n\
+writes the samples to FILE (default \"gdb.folded\") in collapsed-stack\n\
+format, suitable for flamegraph tools."),
+	   &maintenance_profile_cmdlist);
+
+  add_cmd ("stop", class_maintenance, maintenance_profile_stop_cmd, _("\
+Stop sampling GDB's own call stacks and write the samples.\n\
+Usage: maintenance profile stop\n\
+The output file was chosen when sampling was started."),
+	   &maintenance_profile_cmdlist);
+
   add_setshow_zuinteger_unlimited_cmd ("worker-threads",
 				       class_maintenance,
 				       &n_worker_threads, _("\
@@ -63,7 +63,102 @@ class scoped_command_stats
   int m_start_nr_blocks;
 };
 
+/* Tell the self-profiler ("maint profile start") that the command
+   LINE is about to execute, so that samples taken while it runs are
+   attributed to it.  Does nothing when profiling is not active.  */
+
+extern void maint_profile_note_command (const char *line);
+
+/* Return the command line currently executing, as last noted by
+   maint_profile_note_command, or NULL between commands.  */
+
+extern const char *maint_current_command ();
+
+/* The categories into which "maint set per-command time" breaks down
+   where a command's time went.  */
+
+enum command_time_category
+{
+  COMMAND_TIME_SYMBOL_LOOKUP,
+  COMMAND_TIME_TARGET_IO,
+  COMMAND_TIME_UNWIND,
+  COMMAND_TIME_PYTHON,
+
+  COMMAND_TIME_NCATEGORIES
+};
+
+/* While an instance of this class is live, elapsed wall-clock time is
+   attributed to CATEGORY in the breakdown that "maint set per-command
+   time" prints when the command finishes.  Regions nest; time covered
+   by an inner region is attributed to the inner region's category
+   only, so the printed self-times do not double-count.  Instances are
+   cheap when the stat is off, and only the main thread records.  */
+
+class scoped_command_time
+{
+ public:
+
+  explicit scoped_command_time (command_time_category category);
+  ~scoped_command_time ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_command_time);
+
+ private:
+
+  command_time_category m_category;
+  /* Whether this region records anything; false off the main thread
+     or when "per-command time" is off.  */
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+  /* Wall-clock time covered by regions nested within this one.  */
+  std::chrono::steady_clock::duration m_children {};
+  /* The region this one is nested within, if any.  */
+  scoped_command_time *m_parent;
+};
+
+/* Count BYTES bytes exchanged with the target toward the current
+   command's breakdown, and one more round trip if ROUND_TRIP is
+   true.  */
+
+extern void command_stats_count_target_io (ULONGEST bytes, bool round_trip);
+
 extern obj_section *maint_obj_section_from_bfd_section (bfd *abfd,
 							asection *asection,
 							objfile *ofile);
+
+/* While an instance of this class is live during startup, the
+   wall-clock time it covers is attributed to NAME in the table shown
+   by "maint time startup".  KIND is a short tag describing what NAME
+   is ("init" for an _initialize_* function, "script" for a sourced or
+   auto-loaded script); it must point to a string literal.  Instances
+   created after startup has completed record nothing.  */
+
+class scoped_startup_timer
+{
+ public:
+
+  scoped_startup_timer (const char *kind, std::string name);
+  ~scoped_startup_timer ();
+
+ private:
+
+  DISABLE_COPY_AND_ASSIGN (scoped_startup_timer);
+
+  /* What is being timed.  */
+  const char *m_kind;
+  std::string m_name;
+
+  /* True if startup timing was still being recorded when this timer
+     was created.  */
+  bool m_recording;
+
+  std::chrono::steady_clock::time_point m_start_wall_time;
+};
+
+/* Called when startup is complete (just before the first prompt is
+   displayed).  Stops the recording of startup times; later
+   scoped_startup_timer instances are ignored.  */
+
+extern void maint_startup_timing_complete ();
+
 #endif /* MAINT_H */
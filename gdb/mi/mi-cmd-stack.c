@@ -608,6 +608,10 @@ list_args_or_locals (const frame_print_options &fp_opts,
 	{
 	  int print_me = 0;
 
+	  /* Formatting a value can involve target reads, so let a
+	     front end interrupt a slow listing between symbols.  */
+	  QUIT;
+
 	  switch (sym->aclass ())
 	    {
 	    default:
@@ -605,6 +605,10 @@ mi_cmd_var_update_iter (struct varobj *var, bool only_floating,
 {
   bool thread_stopped;
 
+  /* Updating a varobj can involve target reads, so let a front end
+     interrupt a slow -var-update between objects.  */
+  QUIT;
+
   int thread_id = varobj_get_thread_id (var);
 
   if (thread_id == -1)
@@ -1071,6 +1071,8 @@ mi_cmd_data_list_register_values (const char *command, const char *const *argv,
 	   regnum < numregs;
 	   regnum++)
 	{
+	  QUIT;
+
 	  if (*(gdbarch_register_name (gdbarch, regnum)) == '\0')
 	    continue;
 
@@ -1197,7 +1199,7 @@ mi_cmd_data_evaluate_expression (const char *command, const char *const *argv,
     error (_("-data-evaluate-expression: "
 	     "Usage: -data-evaluate-expression expression"));
 
-  expression_up expr = parse_expression (argv[0]);
+  shared_expression expr = parse_expression_cached (argv[0]);
 
   val = expr->evaluate ();
 
@@ -2506,7 +2508,7 @@ print_variable_or_computed (const char *expression, enum print_values values)
 
   string_file stb;
 
-  expression_up expr = parse_expression (expression);
+  shared_expression expr = parse_expression_cached (expression);
 
   if (values == PRINT_SIMPLE_VALUES)
     val = expr->evaluate_type ();
@@ -55,6 +55,7 @@
 #include "gdbsupport/gdb-safe-ctype.h"
 #include "gdbsupport/parallel-for.h"
 #include "inferior.h"
+#include "observable.h"
 
 #if CXX_STD_THREAD
 #include <mutex>
@@ -734,6 +735,49 @@ msym_prefer_to_msym_type (lookup_msym_prefer prefer)
   gdb_assert_not_reached ("unhandled lookup_msym_prefer");
 }
 
+/* A cache entry for lookup_minimal_symbol_by_pc_section.  PC-to-symbol
+   lookups cluster heavily around a few addresses (stack sampling,
+   "info symbol", disassembly all resolve the same frames over and
+   over), and each miss scans the minimal symbol tables of every
+   separate-debug objfile.  A small most-recently-used cache in front
+   of the search makes the common repeated lookup O(1).  */
+
+struct minsym_lookup_cache_entry
+{
+  /* The program space the lookup was made in, or NULL if this entry
+     is empty.  */
+  program_space *pspace = nullptr;
+
+  /* The lookup arguments.  SECTION is the section after resolving a
+     NULL input section via find_pc_section.  */
+  CORE_ADDR pc = 0;
+  obj_section *section = nullptr;
+  minimal_symbol_type want_type = mst_unknown;
+
+  /* The cached result, and the closest preceding symbol (the PREVIOUS
+     out parameter of the lookup).  */
+  bound_minimal_symbol result {};
+  bound_minimal_symbol previous {};
+};
+
+#define MINSYM_LOOKUP_CACHE_SIZE 8
+
+static minsym_lookup_cache_entry minsym_lookup_cache[MINSYM_LOOKUP_CACHE_SIZE];
+
+/* The next cache slot to evict, round-robin.  */
+
+static int minsym_lookup_cache_next;
+
+/* See minsyms.h.  */
+
+void
+invalidate_minsym_lookup_cache ()
+{
+  for (minsym_lookup_cache_entry &entry : minsym_lookup_cache)
+    entry = {};
+  minsym_lookup_cache_next = 0;
+}
+
 /* See minsyms.h.
 
    Note that we need to look through ALL the minimal symbol tables
@@ -754,6 +798,7 @@ lookup_minimal_symbol_by_pc_section (CORE_ADDR pc_in, struct obj_section *sectio
   struct minimal_symbol *best_symbol = NULL;
   struct objfile *best_objfile = NULL;
   struct bound_minimal_symbol result;
+  struct bound_minimal_symbol previous_result;
 
   if (previous != nullptr)
     {
@@ -770,6 +815,17 @@ lookup_minimal_symbol_by_pc_section (CORE_ADDR pc_in, struct obj_section *sectio
 
   minimal_symbol_type want_type = msym_prefer_to_msym_type (prefer);
 
+  for (const minsym_lookup_cache_entry &entry : minsym_lookup_cache)
+    if (entry.pspace == current_program_space
+	&& entry.pc == pc_in
+	&& entry.section == section
+	&& entry.want_type == want_type)
+      {
+	if (previous != nullptr)
+	  *previous = entry.previous;
+	return entry.result;
+      }
+
   /* We can not require the symbol found to be in section, because
      e.g. IRIX 6.5 mdebug relies on this code returning an absolute
      symbol - but find_pc_section won't return an absolute section and
@@ -952,17 +1008,14 @@ lookup_minimal_symbol_by_pc_section (CORE_ADDR pc_in, struct obj_section *sectio
 		    hi = best_zero_sized;
 		  else
 		    {
-		      /* If needed record this symbol as the closest
-			 previous symbol.  */
-		      if (previous != nullptr)
+		      /* Record this symbol as the closest previous
+			 symbol.  */
+		      if (previous_result.minsym == nullptr
+			  || (msymbol[hi].unrelocated_address ()
+			      > previous_result.minsym->unrelocated_address ()))
 			{
-			  if (previous->minsym == nullptr
-			      || (msymbol[hi].unrelocated_address ()
-				  > previous->minsym->unrelocated_address ()))
-			    {
-			      previous->minsym = &msymbol[hi];
-			      previous->objfile = objfile;
-			    }
+			  previous_result.minsym = &msymbol[hi];
+			  previous_result.objfile = objfile;
 			}
 		      /* Go on to the next object file.  */
 		      continue;
@@ -987,6 +1040,22 @@ lookup_minimal_symbol_by_pc_section (CORE_ADDR pc_in, struct obj_section *sectio
 
   result.minsym = best_symbol;
   result.objfile = best_objfile;
+
+  if (previous != nullptr)
+    *previous = previous_result;
+
+  /* Record the result, evicting the oldest entry.  */
+  minsym_lookup_cache_entry &entry
+    = minsym_lookup_cache[minsym_lookup_cache_next];
+  minsym_lookup_cache_next
+    = (minsym_lookup_cache_next + 1) % MINSYM_LOOKUP_CACHE_SIZE;
+  entry.pspace = current_program_space;
+  entry.pc = pc_in;
+  entry.section = section;
+  entry.want_type = want_type;
+  entry.result = result;
+  entry.previous = previous_result;
+
   return result;
 }
 
@@ -1354,7 +1423,7 @@ struct computed_hash_values
 /* Build (or rebuild) the minimal symbol hash tables.  This is necessary
    after compacting or sorting the table since the entries move around
    thus causing the internal minimal_symbol pointers to become jumbled.  */
-  
+
 static void
 build_minimal_symbol_hash_tables
   (struct objfile *objfile,
@@ -1363,10 +1432,82 @@ build_minimal_symbol_hash_tables
   int i;
   struct minimal_symbol *msym;
 
-  /* (Re)insert the actual entries.  */
   int mcount = objfile->per_bfd->minimal_symbol_count;
+  minimal_symbol *msymbols = objfile->per_bfd->msymbols.get ();
+
+  /* For large tables, divide the buckets of both hash tables among
+     the worker threads.  Each worker scans the whole symbol array but
+     only links symbols into buckets it owns, so no two threads ever
+     write the same bucket chain or the same symbol field, and since
+     every worker visits the symbols in array order the chains come
+     out identical to a serial build.  Only parallelize when each
+     shard gets a substantial scan.  */
+  size_t n_shards = gdb::thread_pool::g_thread_pool->thread_count ();
+  n_shards = std::min (n_shards, (size_t) mcount / 65536);
+  if (n_shards > 1)
+    {
+      /* Inserting into the demangled table also records the symbol's
+	 language; collect those per shard and merge afterwards to
+	 avoid concurrent writes to the shared bitset.  */
+      std::vector<std::bitset<nr_languages>> shard_languages (n_shards);
+
+      std::vector<gdb::future<void>> futures;
+      for (size_t shard = 0; shard < n_shards; shard++)
+	futures.push_back (gdb::thread_pool::g_thread_pool->post_task
+	  ([&, shard] ()
+	   {
+	     for (int idx = 0; idx < mcount; idx++)
+	       {
+		 minimal_symbol *sym = &msymbols[idx];
+		 unsigned int bucket
+		   = hash_values[idx].minsym_hash % MINIMAL_SYMBOL_HASH_SIZE;
+		 bool demangled
+		   = sym->search_name () != sym->linkage_name ();
+
+		 if (bucket % n_shards == shard)
+		   {
+		     sym->hash_next
+		       = objfile->per_bfd->msymbol_hash[bucket];
+		     objfile->per_bfd->msymbol_hash[bucket] = sym;
+
+		     /* A symbol that does not participate in the
+			demangled table still needs its chain pointer
+			cleared, and has no demangled-bucket owner to
+			do it.  */
+		     if (!demangled)
+		       sym->demangled_hash_next = 0;
+		   }
+
+		 if (demangled)
+		   {
+		     unsigned int dbucket
+		       = (hash_values[idx].minsym_demangled_hash
+			  % MINIMAL_SYMBOL_HASH_SIZE);
+
+		     if (dbucket % n_shards == shard)
+		       {
+			 shard_languages[shard].set (sym->language ());
+			 sym->demangled_hash_next
+			   = objfile->per_bfd->msymbol_demangled_hash[dbucket];
+			 objfile->per_bfd->msymbol_demangled_hash[dbucket]
+			   = sym;
+		       }
+		   }
+	       }
+	   }, gdb::task_priority::high));
+
+      for (auto &fut : futures)
+	fut.wait ();
+
+      for (const auto &langs : shard_languages)
+	objfile->per_bfd->demangled_hash_languages |= langs;
+
+      return;
+    }
+
+  /* (Re)insert the actual entries.  */
   for ((i = 0,
-	msym = objfile->per_bfd->msymbols.get ());
+	msym = msymbols);
        i < mcount;
        i++, msym++)
     {
@@ -1381,6 +1522,83 @@ build_minimal_symbol_hash_tables
     }
 }
 
+/* Sort the minimal symbol table MSYMBOLS, containing MCOUNT entries,
+   by address.  Large tables are sorted in parallel: the array is
+   split into roughly equal chunks that worker threads sort
+   independently, and the sorted chunks are then merged pairwise.
+   std::inplace_merge is stable and adjacent chunks are always merged
+   in array order, so the result is identical to a plain
+   std::sort.  */
+
+static void
+sort_minimal_symbols (struct minimal_symbol *msymbols, int mcount)
+{
+  /* Chunks below this size are cheaper to sort on one thread than to
+     hand out and merge.  */
+  const size_t chunk_size_min = 65536;
+
+  size_t n_threads = gdb::thread_pool::g_thread_pool->thread_count ();
+  size_t n_chunks = std::min ((size_t) mcount / chunk_size_min, n_threads);
+
+  if (n_chunks <= 1)
+    {
+      std::sort (msymbols, msymbols + mcount, minimal_symbol_is_less_than);
+      return;
+    }
+
+  /* Chunk I covers [ bounds[i], bounds[i + 1] ).  */
+  std::vector<size_t> bounds (n_chunks + 1);
+  for (size_t i = 0; i <= n_chunks; i++)
+    bounds[i] = (size_t) mcount * i / n_chunks;
+
+  std::vector<gdb::future<void>> futures;
+  for (size_t i = 0; i < n_chunks; i++)
+    {
+      minimal_symbol *start = msymbols + bounds[i];
+      minimal_symbol *end = msymbols + bounds[i + 1];
+
+      futures.push_back (gdb::thread_pool::g_thread_pool->post_task
+	([=] ()
+	 {
+	   std::sort (start, end, minimal_symbol_is_less_than);
+	 }, gdb::task_priority::high));
+    }
+  for (auto &fut : futures)
+    fut.wait ();
+
+  /* Merge adjacent pairs of sorted chunks until a single sorted run
+     remains.  An odd chunk at the end of a round just moves on to the
+     next round.  */
+  while (bounds.size () > 2)
+    {
+      std::vector<size_t> merged_bounds;
+      merged_bounds.push_back (bounds[0]);
+
+      futures.clear ();
+      size_t i;
+      for (i = 0; i + 2 < bounds.size (); i += 2)
+	{
+	  minimal_symbol *start = msymbols + bounds[i];
+	  minimal_symbol *mid = msymbols + bounds[i + 1];
+	  minimal_symbol *end = msymbols + bounds[i + 2];
+
+	  futures.push_back (gdb::thread_pool::g_thread_pool->post_task
+	    ([=] ()
+	     {
+	       std::inplace_merge (start, mid, end,
+				   minimal_symbol_is_less_than);
+	     }, gdb::task_priority::high));
+	  merged_bounds.push_back (bounds[i + 2]);
+	}
+      if (i + 1 < bounds.size ())
+	merged_bounds.push_back (bounds[i + 1]);
+
+      for (auto &fut : futures)
+	fut.wait ();
+      bounds = std::move (merged_bounds);
+    }
+}
+
 /* Add the minimal symbols in the existing bunches to the objfile's official
    minimal symbol table.  In most cases there is no minimal symbol table yet
    for this objfile, and the existing bunches are used to create one.  Once
@@ -1403,6 +1621,8 @@ minimal_symbol_reader::install ()
       symtab_create_debug_printf ("installing %d minimal symbols of objfile %s",
 				  m_msym_count, objfile_name (m_objfile));
 
+      invalidate_minsym_lookup_cache ();
+
       /* Allocate enough space, into which we will gather the bunches
 	 of new and existing minimal symbols, sort them, and then
 	 compact out the duplicate entries.  Once we have a final
@@ -1438,7 +1658,7 @@ minimal_symbol_reader::install ()
 
       /* Sort the minimal symbols by address.  */
 
-      std::sort (msymbols, msymbols + mcount, minimal_symbol_is_less_than);
+      sort_minimal_symbols (msymbols, mcount);
 
       /* Compact out any duplicates, and free up whatever space we are
 	 no longer using.  */
@@ -1466,6 +1686,10 @@ minimal_symbol_reader::install ()
 
       std::vector<computed_hash_values> hash_values (mcount);
 
+      /* Map the on-disk demangled name cache, if there is one, before
+	 the worker threads start consulting it.  */
+      demangled_names_cache_preload (m_objfile->per_bfd);
+
       msymbols = m_objfile->per_bfd->msymbols.get ();
       /* Arbitrarily require at least 10 elements in a thread.  */
       gdb::parallel_for_each (10, &msymbols[0], &msymbols[mcount],
@@ -1478,8 +1702,20 @@ minimal_symbol_reader::install ()
 	       if (!msym->name_set)
 		 {
 		   /* This will be freed later, by compute_and_set_names.  */
-		   gdb::unique_xmalloc_ptr<char> demangled_name
-		     = symbol_find_demangled_name (msym, msym->linkage_name ());
+		   gdb::unique_xmalloc_ptr<char> demangled_name;
+		   enum language cached_lang;
+		   if (demangled_names_cache_find (m_objfile->per_bfd,
+						   msym->linkage_name (),
+						   &demangled_name,
+						   &cached_lang))
+		     {
+		       if (msym->language () == language_unknown)
+			 msym->m_language = cached_lang;
+		     }
+		   else
+		     demangled_name
+		       = symbol_find_demangled_name (msym,
+						     msym->linkage_name ());
 		   msym->set_demangled_name
 		     (demangled_name.release (),
 		      &m_objfile->per_bfd->storage_obstack);
@@ -1517,7 +1753,7 @@ minimal_symbol_reader::install ()
 		    hash_values[idx].mangled_name_hash);
 	       }
 	   }
-	 });
+	 }, nullptr, gdb::task_priority::high);
 
       build_minimal_symbol_hash_tables (m_objfile, hash_values);
     }
@@ -1709,3 +1945,41 @@ find_minsym_type_and_address (minimal_symbol *msymbol,
       return builtin_type (objfile)->nodebug_unknown_symbol;
     }
 }
+
+/* Discard cached PC lookups when the set of loaded objfiles
+   changes.  */
+
+static void
+minsyms_new_objfile_observer (struct objfile *objfile)
+{
+  invalidate_minsym_lookup_cache ();
+}
+
+/* Likewise when an objfile goes away; the cache holds pointers into
+   the objfile's minimal symbol table.  */
+
+static void
+minsyms_free_objfile_observer (struct objfile *objfile)
+{
+  invalidate_minsym_lookup_cache ();
+}
+
+/* Likewise when all objfiles of a program space are removed.  */
+
+static void
+minsyms_all_objfiles_removed (program_space *pspace)
+{
+  invalidate_minsym_lookup_cache ();
+}
+
+void _initialize_minsyms ();
+void
+_initialize_minsyms ()
+{
+  gdb::observers::new_objfile.attach (minsyms_new_objfile_observer,
+				      "minsyms");
+  gdb::observers::free_objfile.attach (minsyms_free_objfile_observer,
+				       "minsyms");
+  gdb::observers::all_objfiles_removed.attach (minsyms_all_objfiles_removed,
+					       "minsyms");
+}
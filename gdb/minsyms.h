@@ -327,4 +327,10 @@ CORE_ADDR minimal_symbol_upper_bound (struct bound_minimal_symbol minsym);
 type *find_minsym_type_and_address (minimal_symbol *msymbol, objfile *objf,
 				    CORE_ADDR *address_p);
 
+/* Discard any cached results of lookup_minimal_symbol_by_pc_section.
+   This must be called whenever the address ranges of loaded objfiles
+   change, e.g. on relocation.  */
+
+void invalidate_minsym_lookup_cache ();
+
 #endif /* MINSYMS_H */
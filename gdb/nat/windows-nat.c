@@ -72,6 +72,8 @@ static GetThreadDescription_ftype *GetThreadDescription;
 InitializeProcThreadAttributeList_ftype *InitializeProcThreadAttributeList;
 UpdateProcThreadAttribute_ftype *UpdateProcThreadAttribute;
 DeleteProcThreadAttributeList_ftype *DeleteProcThreadAttributeList;
+NtSuspendProcess_ftype *NtSuspendProcess;
+NtResumeProcess_ftype *NtResumeProcess;
 
 /* Note that 'debug_events' must be locally defined in the relevant
    functions.  */
@@ -1139,6 +1141,16 @@ initialize_loadable ()
   if (!GetCurrentConsoleFont)
     GetCurrentConsoleFont = bad_GetCurrentConsoleFont;
 
+  /* These are optional; callers check for NULL before using them.
+     ntdll.dll is mapped into every process, so GetModuleHandle is
+     sufficient.  */
+  hm = GetModuleHandle (TEXT ("ntdll.dll"));
+  if (hm)
+    {
+      GPA (hm, NtSuspendProcess);
+      GPA (hm, NtResumeProcess);
+    }
+
   /* Load optional functions used for retrieving filename information
      associated with the currently debugged process or its dlls.  */
   hm = LoadLibrary (TEXT ("psapi.dll"));
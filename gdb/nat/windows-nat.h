@@ -342,6 +342,8 @@ extern BOOL create_process (const wchar_t *image, wchar_t *command_line,
 #define InitializeProcThreadAttributeList dyn_InitializeProcThreadAttributeList
 #define UpdateProcThreadAttribute dyn_UpdateProcThreadAttribute
 #define DeleteProcThreadAttributeList dyn_DeleteProcThreadAttributeList
+#define NtSuspendProcess		dyn_NtSuspendProcess
+#define NtResumeProcess			dyn_NtResumeProcess
 
 typedef BOOL WINAPI (AdjustTokenPrivileges_ftype) (HANDLE, BOOL,
 						   PTOKEN_PRIVILEGES,
@@ -431,6 +433,20 @@ typedef void WINAPI (DeleteProcThreadAttributeList_ftype)
      (gdb_lpproc_thread_attribute_list lpAttributeList);
 extern DeleteProcThreadAttributeList_ftype *DeleteProcThreadAttributeList;
 
+/* Internal ntdll.dll entry points.  These suspend or resume every
+   thread of the given process in a single kernel call, which is much
+   cheaper than one SuspendThread or ResumeThread round trip per
+   thread when the inferior has many threads.  They may be absent, in
+   which case the pointers are NULL and callers must iterate over the
+   thread list instead.  A non-negative NTSTATUS return indicates
+   success.  */
+
+typedef LONG NTAPI (NtSuspendProcess_ftype) (HANDLE);
+extern NtSuspendProcess_ftype *NtSuspendProcess;
+
+typedef LONG NTAPI (NtResumeProcess_ftype) (HANDLE);
+extern NtResumeProcess_ftype *NtResumeProcess;
+
 /* Return true if it's possible to disable randomization on this
    host.  */
 
@@ -44,12 +44,18 @@
 #include "source.h"
 #include "addrmap.h"
 #include "arch-utils.h"
+#include "cp-abi.h"
+#include "disasm.h"
+#include "dwarf2/index-cache.h"
+#include "dwarf2/loc.h"
 #include "exec.h"
 #include "observable.h"
 #include "complaints.h"
 #include "solist.h"
+#include "solib.h"
 #include "gdb_bfd.h"
 #include "btrace.h"
+#include "minsyms.h"
 #include "gdbsupport/pathstuff.h"
 
 #include <algorithm>
@@ -594,10 +600,17 @@ relocate_one_symbol (struct symbol *sym, struct objfile *objfile,
 
 /* Relocate OBJFILE to NEW_OFFSETS.  There should be OBJFILE->NUM_SECTIONS
    entries in new_offsets.  SEPARATE_DEBUG_OBJFILE is not touched here.
-   Return non-zero iff any change happened.  */
+   Return non-zero iff any change happened.
+
+   Note that most symbol data does not need per-symbol work here:
+   minimal symbols and the psymtab/cooked-index data store unrelocated
+   addresses and are biased by the section offsets at lookup time, so
+   for them a relocation amounts to the offset table swap below.  Only
+   symbols in already-expanded symtabs store absolute addresses and
+   must be rewritten.  */
 
 static int
-objfile_relocate1 (struct objfile *objfile, 
+objfile_relocate1 (struct objfile *objfile,
 		   const section_offsets &new_offsets)
 {
   section_offsets delta (objfile->section_offsets.size ());
@@ -650,6 +663,22 @@ objfile_relocate1 (struct objfile *objfile,
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
 
+  /* Cached PC-to-minimal-symbol lookups are invalid now, too.  */
+  invalidate_minsym_lookup_cache ();
+
+  /* Likewise cached PC-to-block lookups.  */
+  invalidate_block_cache (objfile->pspace);
+
+  /* Cached call site chains are keyed by relocated PCs.  */
+  invalidate_call_site_chain_cache (objfile->pspace);
+
+  /* Cached RTTI lookups are keyed by relocated vtable addresses.  */
+  invalidate_rtti_cache (objfile->pspace);
+
+  /* Cached disassembly embeds symbolized branch targets, which the
+     relocation just moved.  */
+  gdb_disasm_flush_insn_cache ();
+
   /* Update the table in exec_ops, used to read memory.  */
   for (obj_section *s : objfile->sections ())
     {
@@ -676,9 +705,10 @@ void
 objfile_relocate (struct objfile *objfile,
 		  const section_offsets &new_offsets)
 {
-  int changed = 0;
+  std::vector<struct objfile *> changed;
 
-  changed |= objfile_relocate1 (objfile, new_offsets);
+  if (objfile_relocate1 (objfile, new_offsets))
+    changed.push_back (objfile);
 
   for (::objfile *debug_objfile : objfile->separate_debug_objfiles ())
     {
@@ -699,12 +729,17 @@ objfile_relocate (struct objfile *objfile,
 	(debug_objfile->section_offsets.size ());
       relative_addr_info_to_section_offsets (new_debug_offsets, objfile_addrs);
 
-      changed |= objfile_relocate1 (debug_objfile, new_debug_offsets);
+      if (objfile_relocate1 (debug_objfile, new_debug_offsets))
+	changed.push_back (debug_objfile);
     }
 
-  /* Relocate breakpoints as necessary, after things are relocated.  */
-  if (changed)
-    breakpoint_re_set ();
+  /* Relocate breakpoints as necessary, after things are relocated.
+     Relocation only moves symbols that already live in the relocated
+     objfiles, so breakpoints that cannot refer to them do not need to
+     have their location specs re-parsed.  This matters when many
+     overlay symbol files are re-based in a row.  */
+  if (!changed.empty ())
+    breakpoint_re_set_new_objfiles (changed);
 }
 
 /* Rebase (add to the offsets) OBJFILE by SLIDE.  SEPARATE_DEBUG_OBJFILE is
@@ -724,14 +759,17 @@ objfile_rebase1 (struct objfile *objfile, CORE_ADDR slide)
 void
 objfile_rebase (struct objfile *objfile, CORE_ADDR slide)
 {
-  int changed = 0;
+  std::vector<struct objfile *> changed;
 
   for (::objfile *debug_objfile : objfile->separate_debug_objfiles ())
-    changed |= objfile_rebase1 (debug_objfile, slide);
-
-  /* Relocate breakpoints as necessary, after things are relocated.  */
-  if (changed)
-    breakpoint_re_set ();
+    if (objfile_rebase1 (debug_objfile, slide))
+      changed.push_back (debug_objfile);
+
+  /* Relocate breakpoints as necessary, after things are relocated.
+     As in objfile_relocate, only breakpoints that could refer to the
+     moved objfiles need re-setting.  */
+  if (!changed.empty ())
+    breakpoint_re_set_new_objfiles (changed);
 }
 
 /* Return non-zero if OBJFILE has full symbols.  */
@@ -1165,6 +1203,13 @@ find_pc_section (CORE_ADDR pc)
 					bsearch_cmp);
   if (sp != NULL)
     return *sp;
+
+  /* PC may fall inside a shared library whose symbol reading was
+     deferred (see "set solib-defer-symbol-loading").  If reading the
+     symbols now added sections, search the updated map.  */
+  if (solib_read_symbols_for_address (pc))
+    return find_pc_section (pc);
+
   return NULL;
 }
 
@@ -40,6 +40,7 @@
 #include <forward_list>
 
 struct htab;
+struct index_cache_resource;
 struct objfile_data;
 struct partial_symbol;
 
@@ -274,6 +275,37 @@ struct objfile_per_bfd_storage
 
   htab_up demangled_names_hash;
 
+  /* The contents of the on-disk demangled name cache for this BFD, if
+     one was found; see the demangled name cache code in symtab.c.
+     DEMANGLED_NAMES_CACHE_CHECKED is true once a lookup was attempted,
+     whether or not it succeeded, and DEMANGLED_NAMES_CACHE_COUNT holds
+     the number of entries that were loaded.  */
+
+  bool demangled_names_cache_checked = false;
+  gdb::array_view<const gdb_byte> demangled_names_cache;
+  size_t demangled_names_cache_count = 0;
+
+  /* Resource (e.g. mmapped file) backing DEMANGLED_NAMES_CACHE.  */
+
+  std::unique_ptr<index_cache_resource> demangled_names_cache_resource;
+
+  /* Cached result of the symbol reader's sym_offsets method, together
+     with the BFD section indices picked by init_objfile_sect_indices,
+     and the (section index, relocated address) pairs the offsets were
+     computed from.  A shared library is normally mapped at the same
+     base address in every process using it, so when several inferiors
+     load the same library the offsets computed for the first objfile
+     can simply be copied into the others.  See
+     symfile_compute_section_offsets.  */
+
+  std::vector<std::pair<int, CORE_ADDR>> cached_offsets_addrs;
+  section_offsets cached_section_offsets;
+  int cached_sect_index_text = -1;
+  int cached_sect_index_data = -1;
+  int cached_sect_index_bss = -1;
+  int cached_sect_index_rodata = -1;
+  bool section_offsets_cached = false;
+
   /* The per-objfile information about the entry point, the scope (file/func)
      containing the entry point, and the scope of the user's main() func.  */
 
@@ -597,6 +629,9 @@ public:
      struct obj_section *section,
      int warn_if_readin);
 
+  /* See quick_symbol_functions.  */
+  void expand_symtabs_for_pcs (gdb::array_view<const CORE_ADDR> pcs);
+
   /* See quick_symbol_functions.  */
   void map_symbol_filenames (gdb::function_view<symbol_filename_ftype> fun,
 			     bool need_fullname);
@@ -21,6 +21,7 @@
 #include "observable.h"
 #include "command.h"
 #include "gdbcmd.h"
+#include "ui-out.h"
 
 namespace gdb
 {
@@ -30,6 +31,9 @@ namespace observers
 
 bool observer_debug = false;
 
+/* See gdbsupport/observable.h.  */
+bool observer_stats = false;
+
 #define DEFINE_OBSERVABLE(name) decltype (name) name (# name)
 
 DEFINE_OBSERVABLE (normal_stop);
@@ -86,6 +90,56 @@ show_observer_debug (struct ui_file *file, int from_tty,
   gdb_printf (file, _("Observer debugging is %s.\n"), value);
 }
 
+/* Implement "maintenance info observers" command.  */
+
+static void
+maintenance_info_observers (const char *args, int from_tty)
+{
+  if (!gdb::observers::observer_stats)
+    gdb_printf (_("Observer statistics collection is disabled; "
+		  "enable it with \"maint set observer-stats on\".\n"));
+
+  ui_out *uiout = current_uiout;
+  ui_out_emit_table table_emitter (uiout, 5, -1, "Observers");
+  uiout->table_header (34, ui_left, "observable", "Observable");
+  uiout->table_header (27, ui_left, "observer", "Observer");
+  uiout->table_header (8, ui_left, "enabled", "Enabled");
+  uiout->table_header (10, ui_right, "count", "Count");
+  uiout->table_header (12, ui_right, "time", "Time (ms)");
+  uiout->table_body ();
+
+  for (const gdb::observers::observable_base *observable
+	 : gdb::observers::observable_base::all_observables ())
+    for (const auto &state : observable->observers ())
+      {
+	std::string time
+	  = string_printf ("%.3f",
+			   (std::chrono::duration<double, std::milli>
+			    (state.elapsed).count ()));
+
+	ui_out_emit_list tuple_emitter (uiout, nullptr);
+	uiout->field_string ("observable", observable->name ());
+	uiout->field_string ("observer", state.name);
+	uiout->field_string ("enabled", state.enabled ? "yes" : "no");
+	uiout->field_unsigned ("count", state.notify_count);
+	uiout->field_string ("time", time.c_str ());
+	uiout->text ("\n");
+      }
+}
+
+/* Implement "maintenance set observer-stats".  */
+
+static void
+set_observer_stats (const char *args, int from_tty,
+		    struct cmd_list_element *c)
+{
+  /* Start every collection from a clean slate.  */
+  if (gdb::observers::observer_stats)
+    for (gdb::observers::observable_base *observable
+	   : gdb::observers::observable_base::all_observables ())
+      observable->reset_stats ();
+}
+
 void _initialize_observer ();
 void
 _initialize_observer ()
@@ -98,4 +152,24 @@ When non-zero, observer debugging is enabled."),
 			   NULL,
 			   show_observer_debug,
 			   &setdebuglist, &showdebuglist);
+
+  add_setshow_boolean_cmd ("observer-stats", class_maintenance,
+			   &gdb::observers::observer_stats, _("\
+Set whether to collect per-observer statistics."), _("\
+Show whether to collect per-observer statistics."), _("\
+When enabled, every notification delivered to an observer is counted\n\
+and timed.  Enabling the collection resets the counters.  Use\n\
+\"maint info observers\" to display them."),
+			   set_observer_stats,
+			   NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_cmd ("observers",
+	   class_maintenance,
+	   maintenance_info_observers,
+	   _("Show every attached observer per observable, whether it is\n\
+enabled, and its notification count and cumulative callback time.\n\
+The counts and times require \"maint set observer-stats on\"."),
+	   &maintenanceinfolist);
 }
@@ -48,6 +48,7 @@
 #include "source.h"
 #include "objfiles.h"
 #include "user-regs.h"
+#include "observable.h"
 #include <algorithm>
 #include "gdbsupport/gdb_optional.h"
 #include "c-exp.h"
@@ -465,6 +466,122 @@ parse_expression (const char *string, innermost_block_tracker *tracker,
   return exp;
 }
 
+/* The number of entries retained in the parsed-expression cache.  */
+
+#define EXPRESSION_CACHE_SIZE 64
+
+/* An entry in the parsed-expression cache.  The key members record
+   everything the parse depended on; BLOCK is the context block that
+   parse_exp_in_context would have resolved for a null block
+   argument.  */
+
+struct expression_cache_entry
+{
+  std::string text;
+  const struct language_defn *lang;
+  const struct block *block;
+  struct gdbarch *arch;
+  parser_flags flags;
+  shared_expression exp;
+};
+
+/* Recently parsed expressions, most recently used first.  The cache
+   is flushed whenever the set of loaded objfiles changes, because
+   expression trees hold pointers to symbols, types and blocks owned
+   by objfiles.  */
+
+static std::vector<expression_cache_entry> expression_cache;
+
+/* Discard all entries from the parsed-expression cache.  */
+
+static void
+expression_cache_flush ()
+{
+  expression_cache.clear ();
+}
+
+/* Resolve the context block that parse_exp_in_context would use for
+   a parse with a null block argument and FLAGS.  Expressions parsed
+   in different contexts must not share cache entries, as identical
+   text can name different symbols in each.  */
+
+static const struct block *
+expression_cache_context (parser_flags flags)
+{
+  if ((flags & PARSER_LEAVE_BLOCK_ALONE) != 0)
+    return nullptr;
+
+  CORE_ADDR pc;
+  const struct block *block = get_selected_block (&pc);
+
+  if (block == nullptr)
+    {
+      struct symtab_and_line cursal = get_current_source_symtab_and_line ();
+
+      if (cursal.symtab)
+	block = cursal.symtab->compunit ()->blockvector ()->static_block ();
+    }
+
+  return block;
+}
+
+/* See expression.h.  */
+
+shared_expression
+parse_expression_cached (const char *string, parser_flags flags)
+{
+  const struct block *block = expression_cache_context (flags);
+  const struct language_defn *lang = current_language;
+  struct gdbarch *arch = get_current_arch ();
+
+  for (auto it = expression_cache.begin ();
+       it != expression_cache.end ();
+       ++it)
+    if (it->flags == flags
+	&& it->lang == lang
+	&& it->block == block
+	&& it->arch == arch
+	&& it->text == string)
+      {
+	/* Move the entry to the front of the list.  */
+	std::rotate (expression_cache.begin (), it, it + 1);
+	return expression_cache.front ().exp;
+      }
+
+  shared_expression exp = parse_expression (string, nullptr, flags);
+
+  expression_cache.insert (expression_cache.begin (),
+			   { string, lang, block, arch, flags, exp });
+  if (expression_cache.size () > EXPRESSION_CACHE_SIZE)
+    expression_cache.pop_back ();
+
+  return exp;
+}
+
+/* This module's 'new_objfile' observer.  */
+
+static void
+parse_new_objfile_observer (struct objfile *objfile)
+{
+  expression_cache_flush ();
+}
+
+/* This module's 'free_objfile' observer.  */
+
+static void
+parse_free_objfile_observer (struct objfile *objfile)
+{
+  expression_cache_flush ();
+}
+
+/* This module's 'all_objfiles_removed' observer.  */
+
+static void
+parse_all_objfiles_removed (program_space *pspace)
+{
+  expression_cache_flush ();
+}
+
 /* Same as parse_expression, but using the given language (LANG)
    to parse the expression.  */
 
@@ -626,4 +743,9 @@ _initialize_parse ()
 			    NULL,
 			    show_parserdebug,
 			    &setdebuglist, &showdebuglist);
+
+  gdb::observers::new_objfile.attach (parse_new_objfile_observer, "parse");
+  gdb::observers::free_objfile.attach (parse_free_objfile_observer, "parse");
+  gdb::observers::all_objfiles_removed.attach (parse_all_objfiles_removed,
+					       "parse");
 }
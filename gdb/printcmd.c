@@ -52,6 +52,7 @@
 #include "gdbsupport/format.h"
 #include "source.h"
 #include "gdbsupport/byte-vector.h"
+#include <algorithm>
 #include "gdbsupport/gdb_optional.h"
 #include "gdbsupport/gdb-safe-ctype.h"
 #include "gdbsupport/rsp-low.h"
@@ -120,6 +121,17 @@ show_print_symbol_filename (struct ui_file *file, int from_tty,
 	      value);
 }
 
+/* The disassembly cache stores rendered text whose branch targets
+   were symbolized under the settings above, so changing either one
+   must drop it.  */
+
+static void
+set_symbolic_print_setting (const char *args, int from_tty,
+			    struct cmd_list_element *c)
+{
+  gdb_disasm_flush_insn_cache ();
+}
+
 /* Number of auto-display expression currently being displayed.
    So that we can disable it if we get a signal within it.
    -1 when not doing one.  */
@@ -1112,6 +1124,21 @@ do_examine (struct format_data fmt, struct gdbarch *gdbarch, CORE_ADDR addr)
   bool print_range_tag = true;
   uint32_t gsize = gdbarch_memtag_granule_size (gdbarch);
 
+  /* For bulk examines of fixed-size elements, read the requested span
+     ahead in large chunks instead of fetching every element
+     individually; over a remote connection the latter costs one round
+     trip per element.  The bytes are handed to the individual values
+     below as they are formatted, so output is still streamed while
+     later chunks are fetched, and any region the bulk read cannot
+     reach falls back to the usual per-element fetch and its error
+     reporting.  Instruction and string formats fetch variable amounts
+     themselves and are left alone.  */
+  gdb::byte_vector readahead;
+  CORE_ADDR readahead_start = 0;
+  size_t readahead_valid = 0;
+  bool use_readahead = (format != 'i' && format != 's'
+			&& val_type != nullptr && count >= 16);
+
   /* Print as many objects as specified in COUNT, at most maxelts per line,
      with the address of the next one at the start of each line.  */
 
@@ -1176,6 +1203,48 @@ do_examine (struct format_data fmt, struct gdbarch *gdbarch, CORE_ADDR addr)
 	  last_examine_value
 	    = release_value (value_at_lazy (val_type, next_address));
 
+	  if (use_readahead)
+	    {
+	      size_t eltlen = val_type->length ();
+	      CORE_ADDR eaddr = next_address;
+
+	      if (!(eaddr >= readahead_start
+		    && eaddr - readahead_start + eltlen <= readahead_valid))
+		{
+		  /* The element is not covered; refill the buffer with
+		     the next chunk of the remaining span.  */
+		  size_t span = std::min ((size_t) count * eltlen,
+					  (size_t) 65536);
+
+		  readahead.resize (span);
+		  if (target_read_memory (eaddr, readahead.data (), span)
+		      == 0)
+		    {
+		      readahead_start = eaddr;
+		      readahead_valid = span;
+		    }
+		  else
+		    {
+		      /* Part of the remaining span is unreadable.  Let
+			 the per-element fetches run up to the exact
+			 point of failure and report the error as
+			 usual.  */
+		      readahead_valid = 0;
+		      use_readahead = false;
+		    }
+		}
+
+	      if (use_readahead)
+		{
+		  const gdb_byte *bytes
+		    = readahead.data () + (eaddr - readahead_start);
+
+		  gdb::copy (gdb::make_array_view (bytes, eltlen),
+			     last_examine_value->contents_raw ());
+		  last_examine_value->set_lazy (false);
+		}
+	    }
+
 	  print_formatted (last_examine_value.get (), size, &opts, gdb_stdout);
 
 	  /* Display any branch delay slots following the final insn.  */
@@ -1249,6 +1318,17 @@ print_value (value *val, const value_print_options &opts)
      need to load as many array elements as we plan to print.  */
   scoped_array_length_limiting limit_large_arrays (opts.print_max);
 
+  if (opts.lazy_printing)
+    {
+      /* Recording the value in the history would fetch all of its
+	 contents before any output appears, which is exactly what
+	 "print -lazy" is meant to avoid; print without a history
+	 number instead.  */
+      print_formatted (val, 0, &opts, gdb_stdout);
+      gdb_printf ("\n");
+      return;
+    }
+
   int histindex = val->record_latest ();
 
   annotate_value_history_begin (histindex, val->type ());
@@ -2401,14 +2481,17 @@ clear_dangling_display_expressions (struct objfile *objfile)
    struct symbol.  NAME is the name to print; if NULL then VAR's print
    name will be used.  STREAM is the ui_file on which to print the
    value.  INDENT specifies the number of indent levels to print
-   before printing the variable name.
+   before printing the variable name.  If VAL is non-NULL, it is
+   VAR's value in FRAME, already computed (and possibly prefetched)
+   by the caller; otherwise it is read here.
 
    This function invalidates FRAME.  */
 
 void
 print_variable_and_value (const char *name, struct symbol *var,
 			  frame_info_ptr frame,
-			  struct ui_file *stream, int indent)
+			  struct ui_file *stream, int indent,
+			  struct value *val)
 {
 
   if (!name)
@@ -2419,14 +2502,14 @@ print_variable_and_value (const char *name, struct symbol *var,
 
   try
     {
-      struct value *val;
       struct value_print_options opts;
 
       /* READ_VAR_VALUE needs a block in order to deal with non-local
 	 references (i.e. to handle nested functions).  In this context, we
 	 print variables that are local to this frame, so we can avoid passing
 	 a block to it.  */
-      val = read_var_value (var, NULL, frame);
+      if (val == nullptr)
+	val = read_var_value (var, NULL, frame);
       get_user_print_options (&opts);
       opts.deref_ref = true;
       common_val_print_checked (val, stream, indent, &opts, current_language);
@@ -3447,14 +3530,14 @@ offset between the closest earlier symbol and the address is less than\n\
 the specified maximum offset.  The default is \"unlimited\", which tells GDB\n\
 to always print the symbolic form of an address if any symbol precedes\n\
 it.  Zero is equivalent to \"unlimited\"."),
-			    NULL,
+			    set_symbolic_print_setting,
 			    show_max_symbolic_offset,
 			    &setprintlist, &showprintlist);
   add_setshow_boolean_cmd ("symbol-filename", no_class,
 			   &print_symbol_filename, _("\
 Set printing of source filename and line number with <SYMBOL>."), _("\
 Show printing of source filename and line number with <SYMBOL>."), NULL,
-			   NULL,
+			   set_symbolic_print_setting,
 			   show_print_symbol_filename,
 			   &setprintlist, &showprintlist);
 
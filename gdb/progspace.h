@@ -301,14 +301,34 @@ struct program_space
   void clear_target_sections ()
   {
     m_target_sections.clear ();
+    mark_target_sections_changed ();
   }
 
-  /* Return a reference to the M_TARGET_SECTIONS table.  */
+  /* Return a reference to the M_TARGET_SECTIONS table.  Callers that
+     modify entries in place (rather than going through the member
+     functions above) must call mark_target_sections_changed
+     afterwards.  */
   target_section_table &target_sections ()
   {
     return m_target_sections;
   }
 
+  /* Note that the target section table was changed, invalidating the
+     sorted index returned by sorted_target_sections.  */
+  void mark_target_sections_changed ()
+  {
+    m_target_sections_index_valid = false;
+  }
+
+  /* Return positions into the target section table, sorted by
+     address, for binary-searching the table.  Empty sections are left
+     out.  If the table contains overlapping sections, an empty vector
+     is returned instead, since a binary search could not reproduce
+     the first-in-table-order result of a linear scan; callers must
+     then fall back to scanning.  Rebuilt lazily after the table
+     changes.  */
+  const std::vector<size_t> &sorted_target_sections ();
+
   /* Unique ID number.  */
   int num = 0;
 
@@ -381,6 +401,13 @@ private:
   /* The set of target sections matching the sections mapped into
      this program space.  Managed by both exec_ops and solib.c.  */
   target_section_table m_target_sections;
+
+  /* Positions into M_TARGET_SECTIONS sorted by address, maintained by
+     sorted_target_sections.  */
+  std::vector<size_t> m_target_sections_sorted;
+
+  /* True if M_TARGET_SECTIONS_SORTED is up to date.  */
+  bool m_target_sections_index_valid = false;
 };
 
 /* An address space.  It is used for comparing if
@@ -146,6 +146,7 @@ class BaseReference(ABC):
             count = self.child_count()
         if self.children is None:
             self.children = [None] * self.child_count()
+        result = []
         for idx in range(start, start + count):
             if self.children[idx] is None:
                 (name, value) = self.fetch_one_child(idx)
@@ -153,7 +154,15 @@ class BaseReference(ABC):
                 var = VariableReference(name, value)
                 self.children[idx] = var
                 self.by_name[name] = var
-            yield self.children[idx]
+            result.append(self.children[idx])
+        # Formatting the children one at a time would mean one target
+        # round trip per variable.  Batch the reads for the requested
+        # page instead; any values that cannot be read in a batch are
+        # simply fetched when they are formatted.
+        gdb.fetch_lazy_batch(
+            [var.value for var in result if isinstance(var, VariableReference)]
+        )
+        return result
 
     @in_gdb_thread
     def find_child_by_name(self, name):
@@ -41,6 +41,7 @@ class Unwinder(object):
 
         self._name = name
         self._enabled = True
+        self._pc_ranges = None
 
     @property
     def name(self):
@@ -55,6 +56,24 @@ class Unwinder(object):
         if not isinstance(value, bool):
             raise TypeError("incorrect type for enabled attribute: %s" % type(value))
         self._enabled = value
+        update_pc_ranges()
+        gdb.invalidate_cached_frames()
+
+    @property
+    def pc_ranges(self):
+        """The PC ranges this unwinder can possibly claim, or None.
+
+        When not None, this is a list of (start, end) pairs, with end
+        exclusive.  GDB uses the ranges of all registered unwinders to
+        reject frames without calling into Python at all; an unwinder
+        whose pc_ranges is None can claim any frame, which disables
+        that filtering."""
+        return self._pc_ranges
+
+    @pc_ranges.setter
+    def pc_ranges(self, value):
+        self._pc_ranges = value
+        update_pc_ranges()
         gdb.invalidate_cached_frames()
 
     def __call__(self, pending_frame):
@@ -95,6 +114,32 @@ class FrameId(object):
         return self._special
 
 
+def update_pc_ranges():
+    """Recompute the PC-range filter from the registered unwinders.
+
+    Collects the pc_ranges of every enabled unwinder registered
+    globally, in the current progspace, or in one of its objfiles, and
+    pushes the result down to GDB's frame sniffer so that frames no
+    unwinder can claim never enter Python.  If any enabled unwinder
+    does not declare pc_ranges, filtering is disabled.
+
+    This runs automatically when an unwinder is registered or its
+    enabled or pc_ranges attributes are assigned; call it by hand
+    after mutating an unwinder's range list in place."""
+    ranges = []
+    loci = [gdb] + [gdb.current_progspace()] + list(gdb.objfiles())
+    for locus in loci:
+        for unwinder in locus.frame_unwinders:
+            if not unwinder.enabled:
+                continue
+            unwinder_ranges = getattr(unwinder, "pc_ranges", None)
+            if unwinder_ranges is None:
+                gdb._set_unwinder_pc_ranges(None)
+                return
+            ranges.extend(unwinder_ranges)
+    gdb._set_unwinder_pc_ranges(ranges)
+
+
 def register_unwinder(locus, unwinder, replace=False):
     """Register unwinder in given locus.
 
@@ -137,4 +182,5 @@ def register_unwinder(locus, unwinder, replace=False):
                 raise RuntimeError("Unwinder %s already exists." % unwinder.name)
         i += 1
     locus.frame_unwinders.insert(0, unwinder)
+    update_pc_ranges()
     gdb.invalidate_cached_frames()
@@ -652,6 +652,13 @@ disasmpy_set_enabled (PyObject *self, PyObject *args, PyObject *kw)
     }
 
   python_print_insn_enabled = PyObject_IsTrue (newstate);
+
+  /* Registering or unregistering a Python disassembler can change
+     what any instruction disassembles to; previously rendered
+     instructions no longer apply.  This is called on every
+     (un)registration, even when the flag value does not change.  */
+  gdb_disasm_flush_insn_cache ();
+
   Py_RETURN_NONE;
 }
 
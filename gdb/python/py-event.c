@@ -85,6 +85,21 @@ evpy_emit_event (PyObject *event,
 {
   Py_ssize_t i;
 
+  /* If the registry coalesces, queue the event instead of delivering
+     it; the queue is flushed as a single batched event once GDB is
+     about to display a prompt.  EVENT can be NULL for the
+     before_prompt registry, which there is no point in coalescing.  */
+  if (registry->coalesce && event != NULL)
+    {
+      if (registry->pending == NULL)
+	{
+	  registry->pending = PyList_New (0);
+	  if (registry->pending == NULL)
+	    return -1;
+	}
+      return PyList_Append (registry->pending, event);
+    }
+
   /* Create a copy of call back list and use that for
      notifying listeners to avoid skipping callbacks
      in the case of a callback being disconnected during
@@ -114,6 +129,48 @@ evpy_emit_event (PyObject *event,
   return 0;
 }
 
+/* Deliver the events queued on REGISTRY, if any, as a single batched
+   event whose 'events' attribute holds them in emission order.  */
+
+static void
+evpy_flush_one_registry (eventregistry_object *registry)
+{
+  if (registry == nullptr || registry->pending == nullptr
+      || PyList_Size (registry->pending) == 0)
+    return;
+
+  /* Take ownership of the queue so that events emitted by the
+     listeners start a fresh batch.  */
+  gdbpy_ref<> pending (registry->pending);
+  registry->pending = nullptr;
+
+  gdbpy_ref<> batch = create_event_object (&event_object_type);
+  if (batch == nullptr
+      || evpy_add_attribute (batch.get (), "events", pending.get ()) < 0)
+    {
+      gdbpy_print_stack ();
+      return;
+    }
+
+  /* Deliver directly -- going through the coalescing check in
+     evpy_emit_event would just queue the batch again.  */
+  scoped_restore save_coalesce
+    = make_scoped_restore (&registry->coalesce, 0);
+  if (evpy_emit_event (batch.get (), registry) < 0)
+    gdbpy_print_stack ();
+}
+
+/* See py-event.h.  */
+
+void
+evpy_flush_pending_events ()
+{
+#define GDB_PY_DEFINE_EVENT(name)		\
+  evpy_flush_one_registry (gdb_py_events.name);
+#include "py-all-events.def"
+#undef GDB_PY_DEFINE_EVENT
+}
+
 GDBPY_INITIALIZE_FILE (gdbpy_initialize_event);
 
 static gdb_PyGetSetDef event_object_getset[] =
@@ -60,6 +60,7 @@ extern int emit_register_changed_event (frame_info_ptr frame,
 extern int emit_memory_changed_event (CORE_ADDR addr, ssize_t len);
 extern int evpy_emit_event (PyObject *event,
 			    eventregistry_object *registry);
+extern void evpy_flush_pending_events ();
 
 /* Emits a thread exit event for THREAD */
 extern int emit_thread_exit_event (thread_info * thread);
@@ -32,6 +32,16 @@ struct eventregistry_object
   PyObject_HEAD
 
   PyObject *callbacks;
+
+  /* When true, events emitted on this registry are queued rather
+     than delivered immediately, and the queue is handed to the
+     listeners as a single batched event the next time GDB is about
+     to display a prompt.  */
+  int coalesce;
+
+  /* The queue of events accumulated while coalescing, or NULL if
+     none are pending.  Holds strong references.  */
+  PyObject *pending;
 };
 
 /* Struct holding references to event registries both in python and c.
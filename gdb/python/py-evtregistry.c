@@ -90,6 +90,9 @@ create_eventregistry_object (void)
   if (!eventregistry_obj->callbacks)
     return NULL;
 
+  eventregistry_obj->coalesce = 0;
+  eventregistry_obj->pending = NULL;
+
   return eventregistry_obj.release ();
 }
 
@@ -97,9 +100,40 @@ static void
 evregpy_dealloc (PyObject *self)
 {
   Py_XDECREF (((eventregistry_object *) self)->callbacks);
+  Py_XDECREF (((eventregistry_object *) self)->pending);
   Py_TYPE (self)->tp_free (self);
 }
 
+/* Implementation of the get method for the 'coalesce' attribute.  */
+
+static PyObject *
+evregpy_get_coalesce (PyObject *self, void *closure)
+{
+  return PyBool_FromLong (((eventregistry_object *) self)->coalesce);
+}
+
+/* Implementation of the set method for the 'coalesce' attribute.
+   Any events already queued stay queued; they are delivered in a
+   batch at the next prompt even if coalescing is turned off now.  */
+
+static int
+evregpy_set_coalesce (PyObject *self, PyObject *value, void *closure)
+{
+  if (value == NULL)
+    {
+      PyErr_SetString (PyExc_TypeError,
+		       _("cannot delete the coalesce attribute"));
+      return -1;
+    }
+
+  int cmp = PyObject_IsTrue (value);
+  if (cmp < 0)
+    return -1;
+
+  ((eventregistry_object *) self)->coalesce = cmp;
+  return 0;
+}
+
 /* Initialize the Python event registry code.  */
 
 static int CPYCHECKER_NEGATIVE_RESULT_SETS_EXCEPTION
@@ -132,6 +166,14 @@ static PyMethodDef eventregistry_object_methods[] =
   { NULL } /* Sentinel.  */
 };
 
+static gdb_PyGetSetDef eventregistry_object_getset[] =
+{
+  { "coalesce", evregpy_get_coalesce, evregpy_set_coalesce,
+    "Boolean telling whether events on this registry are queued and\n\
+delivered as a single batched event at the next prompt.", NULL },
+  { NULL }  /* Sentinel.  */
+};
+
 PyTypeObject eventregistry_object_type =
 {
   PyVarObject_HEAD_INIT (NULL, 0)
@@ -163,7 +205,7 @@ PyTypeObject eventregistry_object_type =
   0,                                          /* tp_iternext */
   eventregistry_object_methods,               /* tp_methods */
   0,                                          /* tp_members */
-  0,                                          /* tp_getset */
+  eventregistry_object_getset,                /* tp_getset */
   0,                                          /* tp_base */
   0,                                          /* tp_dict */
   0,                                          /* tp_descr_get */
@@ -34,6 +34,7 @@
 #include "python-internal.h"
 #include "gdbsupport/gdb_optional.h"
 #include "cli/cli-style.h"
+#include <vector>
 
 enum mi_print_types
 {
@@ -800,8 +801,6 @@ py_print_frame (PyObject *filter, frame_filter_flags flags,
   if (frame == NULL)
     return EXT_LANG_BT_ERROR;
 
-  symtab_and_line sal = find_frame_sal (frame);
-
   gdbarch = get_frame_arch (frame);
 
   /* stack-list-variables.  */
@@ -891,9 +890,19 @@ py_print_frame (PyObject *filter, frame_filter_flags flags,
 	 print nothing.  */
       if (opts.addressprint && has_addr)
 	{
-	  if (!sal.symtab
-	      || frame_show_address (frame, sal)
-	      || print_what == LOC_AND_ADDRESS)
+	  /* Finding the frame's symtab and line can be costly; skip it
+	     when the address is shown unconditionally.  */
+	  bool show_address = print_what == LOC_AND_ADDRESS;
+
+	  if (!show_address)
+	    {
+	      symtab_and_line sal = find_frame_sal (frame);
+
+	      show_address = (sal.symtab == NULL
+			      || frame_show_address (frame, sal));
+	    }
+
+	  if (show_address)
 	    {
 	      annotate_frame_address ();
 	      out->field_core_addr ("addr", gdbarch, address);
@@ -1024,6 +1033,8 @@ py_print_frame (PyObject *filter, frame_filter_flags flags,
     {
       if (print_location_source)
 	out->text ("\n"); /* Newline after the location source.  */
+
+      symtab_and_line sal = find_frame_sal (frame);
       print_source_lines (sal.symtab, sal.line, sal.line + 1, 0);
     }
 
@@ -1199,6 +1210,33 @@ gdbpy_apply_frame_filter (const struct extension_language_defn *extlang,
   if (iterable == Py_None)
     return EXT_LANG_BT_NO_FILTERS;
 
+  /* The decorators are about to look up symbols for every frame in
+     the slice, one frame at a time.  Expanding the symtabs covering
+     those frames in a single batch up front is much cheaper.  Errors
+     are ignored here; the loop below reports them in a more useful
+     context.  */
+  try
+    {
+      std::vector<CORE_ADDR> pcs;
+      int remaining = frame_high >= 0 ? frame_high + 1 : -1;
+
+      for (frame_info_ptr fi = frame;
+	   fi != nullptr && remaining-- != 0;
+	   fi = get_prev_frame (fi))
+	{
+	  CORE_ADDR pc;
+
+	  QUIT;
+	  if (get_frame_address_in_block_if_available (fi, &pc))
+	    pcs.push_back (pc);
+	}
+
+      expand_symtabs_for_pcs (pcs);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+    }
+
   htab_up levels_printed (htab_create (20,
 				       htab_hash_pointer,
 				       htab_eq_pointer,
@@ -551,6 +551,11 @@ infpy_read_memory (PyObject *self, PyObject *args, PyObject *kw)
 
   try
     {
+      /* Allow other Python threads to run while the target does the
+	 read; for a remote target this can block on the connection
+	 for a while.  */
+      gdbpy_allow_threads allow_threads;
+
       /* Use this scoped-restore because we want to be able to read
 	 memory from an unwinder.  */
       scoped_restore_current_inferior_for_memory restore_inferior
@@ -569,6 +574,102 @@ infpy_read_memory (PyObject *self, PyObject *args, PyObject *kw)
   return gdbpy_buffer_to_membuf (std::move (buffer), addr, length);
 }
 
+/* Implementation of Inferior.read_memory_v (ranges).  RANGES is a
+   sequence of (address, length) pairs.  All the reads are performed
+   in one call into GDB, so a Python data-structure walker can batch
+   its fetches instead of paying the call overhead per read.  Returns
+   a list with one buffer object per pair, in the same order.
+   Returns NULL on error, with a Python exception set; no partial
+   result list is returned.  */
+static PyObject *
+infpy_read_memory_v (PyObject *self, PyObject *args, PyObject *kw)
+{
+  inferior_object *inf = (inferior_object *) self;
+  PyObject *ranges_obj;
+  static const char *keywords[] = { "ranges", NULL };
+
+  INFPY_REQUIRE_VALID (inf);
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "O", keywords,
+					&ranges_obj))
+    return NULL;
+
+  gdbpy_ref<> seq (PySequence_Fast (ranges_obj,
+				    _("ranges must be a sequence")));
+  if (seq == NULL)
+    return NULL;
+
+  Py_ssize_t len = PySequence_Fast_GET_SIZE (seq.get ());
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> ranges;
+  ranges.reserve (len);
+
+  for (Py_ssize_t i = 0; i < len; i++)
+    {
+      PyObject *item = PySequence_Fast_GET_ITEM (seq.get (), i);
+      PyObject *addr_obj, *length_obj;
+
+      if (!PyTuple_Check (item) || PyTuple_GET_SIZE (item) != 2)
+	{
+	  PyErr_SetString (PyExc_TypeError,
+			   _("each range must be an (address, length) "
+			     "tuple"));
+	  return NULL;
+	}
+
+      addr_obj = PyTuple_GET_ITEM (item, 0);
+      length_obj = PyTuple_GET_ITEM (item, 1);
+
+      CORE_ADDR addr, length;
+      if (get_addr_from_python (addr_obj, &addr) < 0
+	  || get_addr_from_python (length_obj, &length) < 0)
+	return NULL;
+
+      ranges.emplace_back (addr, length);
+    }
+
+  std::vector<gdb::unique_xmalloc_ptr<gdb_byte>> buffers (len);
+
+  try
+    {
+      /* Allow other Python threads to run while the target performs
+	 the whole batch of reads.  */
+      gdbpy_allow_threads allow_threads;
+
+      /* Use this scoped-restore because we want to be able to read
+	 memory from an unwinder.  */
+      scoped_restore_current_inferior_for_memory restore_inferior
+	(inf->inferior);
+
+      for (Py_ssize_t i = 0; i < len; i++)
+	{
+	  buffers[i].reset ((gdb_byte *) xmalloc (ranges[i].second));
+	  read_memory (ranges[i].first, buffers[i].get (),
+		       ranges[i].second);
+	}
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  gdbpy_ref<> result (PyList_New (len));
+  if (result == NULL)
+    return NULL;
+
+  for (Py_ssize_t i = 0; i < len; i++)
+    {
+      PyObject *membuf = gdbpy_buffer_to_membuf (std::move (buffers[i]),
+						 ranges[i].first,
+						 ranges[i].second);
+      if (membuf == NULL)
+	return NULL;
+
+      PyList_SET_ITEM (result.get (), i, membuf);
+    }
+
+  return result.release ();
+}
+
 /* Implementation of Inferior.write_memory (address, buffer [, length]).
    Writes the contents of BUFFER (a Python object supporting the read
    buffer protocol) at ADDRESS in the inferior's memory.  Write LENGTH
@@ -682,6 +783,10 @@ infpy_search_memory (PyObject *self, PyObject *args, PyObject *kw)
 
   try
     {
+      /* Allow other Python threads to run while the target scans its
+	 memory; searching a large region can take a while.  */
+      gdbpy_allow_threads allow_threads;
+
       /* It's probably not too important to avoid invalidating the
 	 frame cache when searching memory, but this scoped-restore is
 	 still used here, just to keep the code similar to other code
@@ -1066,6 +1171,11 @@ Return true if this inferior is valid, false if not." },
     METH_VARARGS | METH_KEYWORDS,
     "read_memory (address, length) -> buffer\n\
 Return a buffer object for reading from the inferior's memory." },
+  { "read_memory_v", (PyCFunction) infpy_read_memory_v,
+    METH_VARARGS | METH_KEYWORDS,
+    "read_memory_v (ranges) -> list of buffers\n\
+Read several (address, length) ranges from the inferior's memory in\n\
+one call and return a list with one buffer object per range." },
   { "write_memory", (PyCFunction) infpy_write_memory,
     METH_VARARGS | METH_KEYWORDS,
     "write_memory (address, buffer [, length])\n\
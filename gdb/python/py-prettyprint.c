@@ -25,7 +25,10 @@
 #include "extension-priv.h"
 #include "python.h"
 #include "python-internal.h"
+#include "cli/cli-setshow.h"
 #include "cli/cli-style.h"
+#include "observable.h"
+#include <algorithm>
 
 extern PyTypeObject printer_object_type;
 
@@ -45,6 +48,85 @@ enum gdbpy_string_repr_result
    printing.  */
 const struct value_print_options *gdbpy_current_print_options;
 
+/* The number of entries retained in the to_string memo.  */
+
+#define PP_MEMO_SIZE 64
+
+/* A memoized to_string result.  Within one stop, a printer class
+   applied to the same value (identified by program space, address and
+   type) produces the same string, so the target-encoded bytes of the
+   result are kept until the inferior resumes or its memory is
+   written.  PRINTER_CLASS is compared for identity only; no reference
+   to it is held.  Printers may consult the prevailing print options
+   via gdb.print_options, so the options that can differ from one
+   print command to the next within a stop -- PRINT_MAX, FORMAT,
+   SUMMARY and DEREF_REF -- are part of the key; the remaining options
+   mirror global settings, which are handled by discarding the whole
+   memo whenever a "set" command changes a parameter.  */
+
+struct pp_memo_entry
+{
+  struct program_space *pspace;
+  CORE_ADDR address;
+  struct type *type;
+  PyTypeObject *printer_class;
+  unsigned int print_max;
+  int format;
+  bool summary;
+  bool deref_ref;
+  std::string repr;
+};
+
+/* Memoized to_string results, most recently used first.  */
+
+static std::vector<pp_memo_entry> pp_memo;
+
+/* Value of get_setshow_generation () when the memo was last known to
+   be consistent with the global settings.  */
+
+static unsigned int pp_memo_generation;
+
+/* Discard all memoized to_string results.  */
+
+static void
+pp_memo_flush ()
+{
+  pp_memo.clear ();
+}
+
+/* This module's 'target_resumed' observer.  */
+
+static void
+pp_memo_target_resumed (ptid_t ptid)
+{
+  pp_memo_flush ();
+}
+
+/* This module's 'memory_changed' observer.  */
+
+static void
+pp_memo_memory_changed (struct inferior *inferior, CORE_ADDR addr,
+			ssize_t len, const bfd_byte *data)
+{
+  pp_memo_flush ();
+}
+
+/* This module's 'free_objfile' observer.  */
+
+static void
+pp_memo_free_objfile (struct objfile *objfile)
+{
+  pp_memo_flush ();
+}
+
+/* This module's 'all_objfiles_removed' observer.  */
+
+static void
+pp_memo_all_objfiles_removed (program_space *pspace)
+{
+  pp_memo_flush ();
+}
+
 /* Helper function for find_pretty_printer which iterates over a list,
    calls each function and inspects output.  This will return a
    printer object if one recognizes VALUE.  If no printer is found, it
@@ -277,10 +359,12 @@ print_stack_unless_memory_error (struct ui_file *stream)
 }
 
 /* Helper for gdbpy_apply_val_pretty_printer which calls to_string and
-   formats the result.  */
+   formats the result.  VALUE is the value PRINTER was selected for,
+   or NULL if it is not known; when non-null it is used to memoize the
+   string representation for the duration of the stop.  */
 
 static enum gdbpy_string_repr_result
-print_string_repr (PyObject *printer, const char *hint,
+print_string_repr (PyObject *printer, struct value *value, const char *hint,
 		   struct ui_file *stream, int recurse,
 		   const struct value_print_options *options,
 		   const struct language_defn *language,
@@ -289,6 +373,48 @@ print_string_repr (PyObject *printer, const char *hint,
   struct value *replacement = NULL;
   enum gdbpy_string_repr_result result = string_repr_ok;
 
+  /* See whether this printer's string representation was already
+     computed during this stop.  VALUE is null when the printer was
+     returned for a child with no underlying value.  */
+  PyTypeObject *printer_class = Py_TYPE (printer);
+  bool memoizable = (value != nullptr
+		     && value->lval () == lval_memory
+		     && value->address () != 0);
+
+  /* A "set" command may have changed a global print setting since the
+     memoized strings were produced.  */
+  if (pp_memo_generation != get_setshow_generation ())
+    {
+      pp_memo_flush ();
+      pp_memo_generation = get_setshow_generation ();
+    }
+
+  if (memoizable)
+    for (auto it = pp_memo.begin (); it != pp_memo.end (); ++it)
+      if (it->pspace == current_program_space
+	  && it->address == value->address ()
+	  && it->type == value->type ()
+	  && it->printer_class == printer_class
+	  && it->print_max == options->print_max
+	  && it->format == options->format
+	  && it->summary == options->summary
+	  && it->deref_ref == options->deref_ref)
+	{
+	  /* Move the entry to the front of the list.  */
+	  std::rotate (pp_memo.begin (), it, it + 1);
+
+	  const std::string &repr = pp_memo.front ().repr;
+
+	  if (hint && !strcmp (hint, "string"))
+	    language->printstr (stream,
+				builtin_type (gdbarch)->builtin_char,
+				(const gdb_byte *) repr.data (),
+				repr.size (), NULL, 0, options);
+	  else
+	    gdb_puts (repr.c_str (), stream);
+	  return string_repr_ok;
+	}
+
   gdbpy_ref<> py_str = pretty_print_one_value (printer, &replacement);
   if (py_str != NULL)
     {
@@ -328,6 +454,19 @@ print_string_repr (PyObject *printer, const char *hint,
 				    length, NULL, 0, options);
 	      else
 		gdb_puts (output, stream);
+
+	      if (memoizable)
+		{
+		  pp_memo.insert (pp_memo.begin (),
+				  { current_program_space,
+				    value->address (), value->type (),
+				    printer_class, options->print_max,
+				    options->format, options->summary,
+				    options->deref_ref,
+				    std::string (output, length) });
+		  if (pp_memo.size () > PP_MEMO_SIZE)
+		    pp_memo.pop_back ();
+		}
 	    }
 	  else
 	    {
@@ -353,8 +492,8 @@ print_string_repr (PyObject *printer, const char *hint,
 }
 
 static enum ext_lang_rc
-gdbpy_apply_pretty_printer(PyObject *printer, struct ui_file *stream,
-			   int recurse,
+gdbpy_apply_pretty_printer(PyObject *printer, struct value *value,
+			   struct ui_file *stream, int recurse,
 			   const struct value_print_options *options,
 			   const struct language_defn *language,
 			   struct gdbarch *gdbarch);
@@ -533,8 +672,8 @@ print_children (PyObject *printer, const char *hint,
       else if (PyObject_HasAttr (py_v, gdbpy_to_string_cst)
 	       || PyObject_HasAttr (py_v, gdbpy_children_cst))
 	{
-	  gdbpy_apply_pretty_printer(py_v, stream, recurse + 1, options,
-				     language, gdbarch);
+	  gdbpy_apply_pretty_printer(py_v, nullptr, stream, recurse + 1,
+				     options, language, gdbarch);
 	}
       else
 	{
@@ -626,12 +765,13 @@ gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   scoped_restore set_options = make_scoped_restore (&gdbpy_current_print_options,
 						    options);
 
-  return gdbpy_apply_pretty_printer(printer.get (), stream, recurse, options, language, gdbarch);
+  return gdbpy_apply_pretty_printer(printer.get (), value, stream, recurse,
+				    options, language, gdbarch);
 }
 
 static enum ext_lang_rc
-gdbpy_apply_pretty_printer(PyObject *printer, struct ui_file *stream,
-			   int recurse,
+gdbpy_apply_pretty_printer(PyObject *printer, struct value *value,
+			   struct ui_file *stream, int recurse,
 			   const struct value_print_options *options,
 			   const struct language_defn *language,
 			   struct gdbarch *gdbarch)
@@ -642,7 +782,7 @@ gdbpy_apply_pretty_printer(PyObject *printer, struct ui_file *stream,
   gdb::unique_xmalloc_ptr<char> hint (gdbpy_get_display_hint (printer));
 
   /* Print the section */
-  print_result = print_string_repr (printer, hint.get (), stream,
+  print_result = print_string_repr (printer, value, hint.get (), stream,
 				    recurse, options, language, gdbarch);
   if (print_result != string_repr_error)
     print_children (printer, hint.get (), stream, recurse, options,
@@ -862,6 +1002,15 @@ PyTypeObject printer_object_type =
 static int
 gdbpy_initialize_prettyprint ()
 {
+  gdb::observers::target_resumed.attach (pp_memo_target_resumed,
+					 "py-prettyprint");
+  gdb::observers::memory_changed.attach (pp_memo_memory_changed,
+					 "py-prettyprint");
+  gdb::observers::free_objfile.attach (pp_memo_free_objfile,
+				       "py-prettyprint");
+  gdb::observers::all_objfiles_removed.attach (pp_memo_all_objfiles_removed,
+					       "py-prettyprint");
+
   if (PyType_Ready (&printer_object_type) < 0)
     return -1;
   return gdb_pymodule_addobject (gdb_module, "ValuePrinter",
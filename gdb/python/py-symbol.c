@@ -463,6 +463,121 @@ gdbpy_lookup_symbol (PyObject *self, PyObject *args, PyObject *kw)
   return ret_tuple.release ();
 }
 
+/* Implementation of
+   gdb.lookup_symbols (names [, block] [, domain]) -> list.
+
+   Looks up each name in NAMES as gdb.lookup_symbol would, but in a
+   single call, and returns a list of (symbol, is_field_of_this)
+   tuples in the same order as NAMES.  Callers that resolve many
+   names at once avoid crossing the extension-language boundary for
+   every name, and any compunit expanded by an earlier lookup is
+   reused by the later ones.  */
+
+PyObject *
+gdbpy_lookup_symbols (PyObject *self, PyObject *args, PyObject *kw)
+{
+  int domain = VAR_DOMAIN;
+  static const char *keywords[] = { "names", "block", "domain", NULL };
+  PyObject *names_obj;
+  PyObject *block_obj = NULL;
+  const struct block *block = NULL;
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "O|O!i", keywords,
+					&names_obj,
+					&block_object_type, &block_obj,
+					&domain))
+    return NULL;
+
+  gdbpy_ref<> seq (PySequence_Fast (names_obj,
+				    _("names must be a sequence")));
+  if (seq == nullptr)
+    return NULL;
+
+  Py_ssize_t len = PySequence_Fast_GET_SIZE (seq.get ());
+  std::vector<gdb::unique_xmalloc_ptr<char>> names;
+  names.reserve (len);
+  for (Py_ssize_t i = 0; i < len; i++)
+    {
+      PyObject *item = PySequence_Fast_GET_ITEM (seq.get (), i);
+      gdb::unique_xmalloc_ptr<char> name
+	= python_string_to_host_string (item);
+      if (name == nullptr)
+	return NULL;
+      names.push_back (std::move (name));
+    }
+
+  if (block_obj)
+    block = block_object_to_block (block_obj);
+  else
+    {
+      frame_info_ptr selected_frame;
+
+      try
+	{
+	  selected_frame = get_selected_frame (_("No frame selected."));
+	  block = get_frame_block (selected_frame, NULL);
+	}
+      catch (const gdb_exception &except)
+	{
+	  GDB_PY_HANDLE_EXCEPTION (except);
+	}
+    }
+
+  std::vector<struct symbol *> symbols (len, nullptr);
+  std::vector<bool> is_a_field (len, false);
+
+  try
+    {
+      for (Py_ssize_t i = 0; i < len; i++)
+	{
+	  struct field_of_this_result is_a_field_of_this;
+
+	  symbols[i] = lookup_symbol (names[i].get (), block,
+				      (domain_enum) domain,
+				      &is_a_field_of_this).symbol;
+	  is_a_field[i] = is_a_field_of_this.type != NULL;
+	}
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  gdbpy_ref<> return_list (PyList_New (len));
+  if (return_list == NULL)
+    return NULL;
+
+  for (Py_ssize_t i = 0; i < len; i++)
+    {
+      PyObject *sym_obj;
+
+      if (symbols[i] != nullptr)
+	{
+	  sym_obj = symbol_to_symbol_object (symbols[i]);
+	  if (sym_obj == nullptr)
+	    return NULL;
+	}
+      else
+	{
+	  sym_obj = Py_None;
+	  Py_INCREF (Py_None);
+	}
+
+      gdbpy_ref<> item (PyTuple_New (2));
+      if (item == NULL)
+	{
+	  Py_DECREF (sym_obj);
+	  return NULL;
+	}
+      PyTuple_SET_ITEM (item.get (), 0, sym_obj);
+      PyTuple_SET_ITEM (item.get (), 1,
+			PyBool_FromLong (is_a_field[i]));
+      PyList_SET_ITEM (return_list.get (), i, item.release ());
+    }
+
+  return return_list.release ();
+}
+
 /* Implementation of
    gdb.lookup_global_symbol (name [, domain]) -> symbol or None.  */
 
@@ -791,6 +791,92 @@ pyuw_prev_register (frame_info_ptr this_frame, void **cache_ptr,
   return frame_unwind_got_optimized (this_frame, regnum);
 }
 
+/* Optional PC-range filter for the Python unwinders.  When active,
+   frames whose PC falls outside every range are rejected without
+   entering Python at all.  The ranges are pushed down from Python
+   (gdb.unwinder recomputes them whenever the set of registered
+   unwinders changes); an unwinder that declares no ranges makes
+   filtering impossible and deactivates this.  The program space the
+   ranges were computed for is recorded so that the filter is only
+   applied there.  */
+
+struct pyuw_pc_range
+{
+  CORE_ADDR start;
+  /* Exclusive.  */
+  CORE_ADDR end;
+};
+
+static std::vector<pyuw_pc_range> pyuw_pc_ranges;
+static bool pyuw_pc_filter_active = false;
+static struct program_space *pyuw_pc_filter_pspace = nullptr;
+
+/* Implement gdb._set_unwinder_pc_ranges.  RANGES is None, to disable
+   filtering, or a sequence of (START, END) pairs with END exclusive.
+   An empty sequence is a valid filter that rejects every frame (no
+   enabled unwinder can claim anything).  */
+
+PyObject *
+gdbpy_set_unwinder_pc_ranges (PyObject *self, PyObject *args)
+{
+  PyObject *ranges_obj;
+
+  if (!PyArg_ParseTuple (args, "O", &ranges_obj))
+    return nullptr;
+
+  if (ranges_obj == Py_None)
+    {
+      pyuw_pc_filter_active = false;
+      pyuw_pc_ranges.clear ();
+      Py_RETURN_NONE;
+    }
+
+  gdbpy_ref<> seq (PySequence_Fast (ranges_obj,
+				    _("ranges must be a sequence")));
+  if (seq == nullptr)
+    return nullptr;
+
+  Py_ssize_t len = PySequence_Fast_GET_SIZE (seq.get ());
+  std::vector<pyuw_pc_range> new_ranges;
+  new_ranges.reserve (len);
+  for (Py_ssize_t i = 0; i < len; i++)
+    {
+      PyObject *item = PySequence_Fast_GET_ITEM (seq.get (), i);
+
+      if (!PyTuple_Check (item) || PyTuple_GET_SIZE (item) != 2)
+	{
+	  PyErr_SetString (PyExc_TypeError,
+			   _("each range must be a (start, end) tuple"));
+	  return nullptr;
+	}
+
+      pyuw_pc_range range;
+      if (get_addr_from_python (PyTuple_GET_ITEM (item, 0),
+				&range.start) < 0
+	  || get_addr_from_python (PyTuple_GET_ITEM (item, 1),
+				   &range.end) < 0)
+	return nullptr;
+      new_ranges.push_back (range);
+    }
+
+  pyuw_pc_ranges = std::move (new_ranges);
+  pyuw_pc_filter_active = true;
+  pyuw_pc_filter_pspace = current_program_space;
+  Py_RETURN_NONE;
+}
+
+/* Deactivate the PC-range filter.  Called when an objfile goes away:
+   its unwinders disappear with it and the ranges may no longer
+   reflect the registered set.  Python reactivates the filter the
+   next time an unwinder is registered.  */
+
+static void
+pyuw_free_objfile_observer (struct objfile *objfile)
+{
+  pyuw_pc_filter_active = false;
+  pyuw_pc_ranges.clear ();
+}
+
 /* Frame sniffer dispatch.  */
 
 static int
@@ -802,6 +888,29 @@ pyuw_sniffer (const struct frame_unwind *self, frame_info_ptr this_frame,
   if (gdb_python_module == NULL)
     return 0;
 
+  /* Reject out-of-range frames before acquiring the GIL and building
+     any Python objects.  */
+  if (pyuw_pc_filter_active
+      && current_program_space == pyuw_pc_filter_pspace)
+    {
+      CORE_ADDR pc = get_frame_pc (this_frame);
+      bool in_range = false;
+
+      for (const pyuw_pc_range &range : pyuw_pc_ranges)
+	if (pc >= range.start && pc < range.end)
+	  {
+	    in_range = true;
+	    break;
+	  }
+
+      if (!in_range)
+	{
+	  pyuw_debug_printf ("frame=%d, pc outside unwinder ranges",
+			     frame_relative_level (this_frame));
+	  return 0;
+	}
+    }
+
   struct gdbarch *gdbarch = (struct gdbarch *) (self->unwind_data);
   cached_frame_info *cached_frame;
 
@@ -812,17 +921,54 @@ pyuw_sniffer (const struct frame_unwind *self, frame_info_ptr this_frame,
 		     paddress (gdbarch, get_frame_sp (this_frame)),
 		     paddress (gdbarch, get_frame_pc (this_frame)));
 
-  /* Create PendingFrame instance to pass to sniffers.  */
-  pending_frame_object *pfo = PyObject_New (pending_frame_object,
-					    &pending_frame_object_type);
-  gdbpy_ref<> pyo_pending_frame ((PyObject *) pfo);
-  if (pyo_pending_frame == NULL)
+  /* The PendingFrame instance to pass to the sniffers.  Creating a
+     fresh wrapper per frame is measurable on deep backtraces, so the
+     object from the previous call is kept and reused whenever we hold
+     the only reference to it.  If an unwinder stashed a reference,
+     the stashed object must stay invalidated, so a fresh one is
+     allocated and the old one is left to its holders.  A fresh one is
+     likewise used if this sniffer is somehow reentered.  */
+  static PyObject *cached_pending_frame = nullptr;
+  static bool pending_frame_in_use = false;
+
+  gdbpy_ref<> fresh_pending_frame;
+  PyObject *pyo_pending_frame;
+
+  if (!pending_frame_in_use
+      && cached_pending_frame != nullptr
+      && Py_REFCNT (cached_pending_frame) == 1)
+    pyo_pending_frame = cached_pending_frame;
+  else
     {
-      gdbpy_print_stack ();
-      return 0;
+      pending_frame_object *pfo = PyObject_New (pending_frame_object,
+						&pending_frame_object_type);
+      if (pfo == nullptr)
+	{
+	  gdbpy_print_stack ();
+	  return 0;
+	}
+      pfo->gdbarch = gdbarch;
+      pfo->frame_info = nullptr;
+
+      if (pending_frame_in_use)
+	{
+	  /* Reentered: do not disturb the cached object, it is the
+	     outer call's pending frame.  */
+	  fresh_pending_frame = gdbpy_ref<> ((PyObject *) pfo);
+	  pyo_pending_frame = fresh_pending_frame.get ();
+	}
+      else
+	{
+	  Py_XDECREF (cached_pending_frame);
+	  cached_pending_frame = (PyObject *) pfo;
+	  pyo_pending_frame = cached_pending_frame;
+	}
     }
+
+  pending_frame_object *pfo = (pending_frame_object *) pyo_pending_frame;
   pfo->gdbarch = gdbarch;
-  pfo->frame_info = nullptr;
+  scoped_restore mark_in_use = make_scoped_restore (&pending_frame_in_use,
+						    true);
   scoped_restore invalidate_frame = make_scoped_restore (&pfo->frame_info,
 							 this_frame);
 
@@ -847,7 +993,7 @@ pyuw_sniffer (const struct frame_unwind *self, frame_info_ptr this_frame,
   /* A (gdb.UnwindInfo, str) tuple, or None.  */
   gdbpy_ref<> pyo_execute_ret
     (PyObject_CallFunctionObjArgs (pyo_execute.get (),
-				   pyo_pending_frame.get (), NULL));
+				   pyo_pending_frame, NULL));
   if (pyo_execute_ret == nullptr)
     {
       /* If the unwinder is cancelled due to a Ctrl-C, then propagate
@@ -997,6 +1143,8 @@ void _initialize_py_unwind ();
 void
 _initialize_py_unwind ()
 {
+  gdb::observers::free_objfile.attach (pyuw_free_objfile_observer,
+				       "py-unwind");
   add_setshow_boolean_cmd
       ("py-unwind", class_maintenance, &pyuw_debug,
 	_("Set Python unwinder debugging."),
@@ -1414,7 +1414,13 @@ valpy_fetch_lazy (PyObject *self, PyObject *args)
   try
     {
       if (value->lazy ())
-	value->fetch_lazy ();
+	{
+	  /* Allow other Python threads to run while the target
+	     fetches the contents.  */
+	  gdbpy_allow_threads allow_threads;
+
+	  value->fetch_lazy ();
+	}
     }
   catch (const gdb_exception &except)
     {
@@ -2135,6 +2141,51 @@ gdbpy_history_count (PyObject *self, PyObject *args)
   return gdb_py_object_from_ulongest (value_history_count ()).release ();
 }
 
+/* Fetch the contents of a sequence of lazy gdb.Value objects.  Lazy
+   memory lvalues are read from the target in a single batched
+   request; any other lazy values are fetched individually.  Values
+   that are not lazy are ignored.  */
+
+PyObject *
+gdbpy_fetch_lazy_batch (PyObject *self, PyObject *args)
+{
+  PyObject *sequence;
+
+  if (!PyArg_ParseTuple (args, "O", &sequence))
+    return nullptr;
+
+  gdbpy_ref<> seq (PySequence_Fast (sequence,
+				    _("argument must be a sequence")));
+  if (seq == nullptr)
+    return nullptr;
+
+  Py_ssize_t len = PySequence_Fast_GET_SIZE (seq.get ());
+  std::vector<struct value *> vals;
+  vals.reserve (len);
+  for (Py_ssize_t i = 0; i < len; i++)
+    {
+      PyObject *item = PySequence_Fast_GET_ITEM (seq.get (), i);
+      struct value *value = convert_value_from_python (item);
+      if (value == nullptr)
+	return nullptr;
+      vals.push_back (value);
+    }
+
+  try
+    {
+      /* Allow other Python threads to run while reading from the
+	 target.  */
+      gdbpy_allow_threads allow_threads;
+      value::fetch_lazy_batch (vals);
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  Py_RETURN_NONE;
+}
+
 /* Return the value of a convenience variable.  */
 PyObject *
 gdbpy_convenience_variable (PyObject *self, PyObject *args)
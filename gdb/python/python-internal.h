@@ -264,6 +264,9 @@ gdb_PyArg_ParseTupleAndKeywords (PyObject *args, PyObject *kw,
 #include "command.h"
 #include "breakpoint.h"
 
+/* For scoped_command_time.  */
+#include "maint.h"
+
 enum gdbpy_iter_kind { iter_keys, iter_values, iter_items };
 
 struct block;
@@ -400,11 +403,14 @@ extern enum ext_lang_rc gdbpy_get_matching_xmethod_workers
 PyObject *gdbpy_history (PyObject *self, PyObject *args);
 PyObject *gdbpy_add_history (PyObject *self, PyObject *args);
 extern PyObject *gdbpy_history_count (PyObject *self, PyObject *args);
+extern PyObject *gdbpy_fetch_lazy_batch (PyObject *self, PyObject *args);
 PyObject *gdbpy_convenience_variable (PyObject *self, PyObject *args);
 PyObject *gdbpy_set_convenience_variable (PyObject *self, PyObject *args);
 PyObject *gdbpy_breakpoints (PyObject *, PyObject *);
 PyObject *gdbpy_frame_stop_reason_string (PyObject *, PyObject *);
 PyObject *gdbpy_lookup_symbol (PyObject *self, PyObject *args, PyObject *kw);
+PyObject *gdbpy_lookup_symbols (PyObject *self, PyObject *args, PyObject *kw);
+PyObject *gdbpy_set_unwinder_pc_ranges (PyObject *self, PyObject *args);
 PyObject *gdbpy_lookup_global_symbol (PyObject *self, PyObject *args,
 				      PyObject *kw);
 PyObject *gdbpy_lookup_static_symbol (PyObject *self, PyObject *args,
@@ -715,6 +721,10 @@ class gdbpy_enter
   /* An optional is used here because we don't want to call
      PyErr_Fetch too early.  */
   gdb::optional<gdbpy_err_fetch> m_error;
+
+  /* Attribute the time spent in the Python layer to the per-command
+     breakdown.  */
+  scoped_command_time m_command_time { COMMAND_TIME_PYTHON };
 };
 
 /* Like gdbpy_enter, but takes a varobj.  This is a subclass just to
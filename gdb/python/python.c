@@ -1161,6 +1161,11 @@ gdbpy_before_prompt_hook (const struct extension_language_defn *extlang,
 
   gdbpy_enter enter_py;
 
+  /* The prompt is where event bursts (shared library loads, thread
+     creation) have quiesced; deliver whatever the coalescing
+     registries have queued up.  */
+  evpy_flush_pending_events ();
+
   if (!evregpy_no_listeners_p (gdb_py_events.before_prompt)
       && evpy_emit_event (NULL, gdb_py_events.before_prompt) < 0)
     return EXT_LANG_RC_ERROR;
@@ -2539,6 +2544,14 @@ PyMethodDef python_GdbMethods[] =
     "Add a value to the value history list" },
   { "history_count", gdbpy_history_count, METH_NOARGS,
     "Return an integer, the number of values in GDB's value history" },
+  { "_set_unwinder_pc_ranges", gdbpy_set_unwinder_pc_ranges, METH_VARARGS,
+    "_set_unwinder_pc_ranges (ranges) -> None.\n\
+Internal function used by gdb.unwinder to push the PC-range filter of\n\
+the registered unwinders down to the frame sniffer." },
+  { "fetch_lazy_batch", gdbpy_fetch_lazy_batch, METH_VARARGS,
+    "fetch_lazy_batch (values) -> None.\n\
+Fetch the contents of a sequence of lazy gdb.Value objects, batching\n\
+the underlying target reads where possible." },
   { "execute", (PyCFunction) execute_gdb_command, METH_VARARGS | METH_KEYWORDS,
     "execute (command [, from_tty] [, to_string]) -> [String]\n\
 Evaluate command, a string, as a gdb CLI command.  Optionally returns\n\
@@ -2596,6 +2609,12 @@ Return a Type corresponding to the given name." },
 Return a tuple with the symbol corresponding to the given name (or None) and\n\
 a boolean indicating if name is a field of the current implied argument\n\
 `this' (when the current language is object-oriented)." },
+  { "lookup_symbols", (PyCFunction) gdbpy_lookup_symbols,
+    METH_VARARGS | METH_KEYWORDS,
+    "lookup_symbols (names [, block] [, domain]) -> list\n\
+Look up every name in the sequence names as lookup_symbol would, in a\n\
+single call, and return a list of (symbol, is_field_of_this) tuples in\n\
+the same order as names." },
   { "lookup_global_symbol", (PyCFunction) gdbpy_lookup_global_symbol,
     METH_VARARGS | METH_KEYWORDS,
     "lookup_global_symbol (name [, domain]) -> symbol\n\
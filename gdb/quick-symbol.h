@@ -195,6 +195,17 @@ struct quick_symbol_functions
     (struct objfile *objfile, struct bound_minimal_symbol msymbol,
      CORE_ADDR pc, struct obj_section *section, int warn_if_readin) = 0;
 
+  /* Expand the symtabs covering each PC in PCS.  The PCS are
+     relocated addresses believed to fall within OBJFILE.  This is a
+     batching hint: readers that can expand several compilation units
+     more cheaply as one batch than one at a time should do so here.
+     The default does nothing, leaving expansion to the usual lazy
+     path.  */
+  virtual void expand_symtabs_for_pcs (struct objfile *objfile,
+				       gdb::array_view<const CORE_ADDR> pcs)
+  {
+  }
+
   /* Return the comp unit from OBJFILE that contains a symbol at
      ADDRESS.  Return NULL if there is no such comp unit.  Unlike
      find_pc_sect_compunit_symtab, any sort of symbol (not just text
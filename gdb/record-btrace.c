@@ -44,8 +44,10 @@
 #include "cli/cli-style.h"
 #include "async-event.h"
 #include <forward_list>
+#include <map>
 #include "objfiles.h"
 #include "interps.h"
+#include "gdbsupport/parallel-for.h"
 
 static const target_info record_btrace_target_info = {
   "record-btrace",
@@ -2955,6 +2957,179 @@ cmd_record_btrace_start (const char *args, int from_tty)
     }
 }
 
+/* A function's identity for "record btrace profile".  Function
+   segments belonging to the same function carry the same symbol and
+   minimal symbol; either or both may be NULL.  */
+
+typedef std::pair<const struct minimal_symbol *, const struct symbol *>
+  btrace_profile_key;
+
+/* The counters aggregated per function for "record btrace profile".  */
+
+struct btrace_profile_counts
+{
+  /* The number of recorded invocations.  */
+  ULONGEST calls = 0;
+
+  /* The number of recorded instructions executed in the function
+     itself, and including all functions called from it.  A recursive
+     invocation is counted once.  */
+  ULONGEST exclusive = 0;
+  ULONGEST inclusive = 0;
+};
+
+typedef std::map<btrace_profile_key, btrace_profile_counts>
+  btrace_profile_map;
+
+/* One function segment's contribution to the profile: its instruction
+   count and the distinct functions on its call stack.  */
+
+struct btrace_profile_contrib
+{
+  ULONGEST ninsns = 0;
+  bool new_call = false;
+
+  /* The segment's own function, followed by the distinct functions on
+     its caller chain.  Empty for gaps.  */
+  std::vector<btrace_profile_key> stack;
+};
+
+/* Return the name to print for a profiled function.  */
+
+static const char *
+btrace_profile_function_name (const btrace_profile_key &key)
+{
+  if (key.second != nullptr)
+    return key.second->print_name ();
+  else if (key.first != nullptr)
+    return key.first->print_name ();
+  else
+    return "??";
+}
+
+/* The "record btrace profile" command.  */
+
+static void
+cmd_record_btrace_profile (const char *args, int from_tty)
+{
+  if (args != NULL && *args != 0)
+    error (_("Invalid argument."));
+
+  struct btrace_thread_info *btinfo = require_btrace ();
+  const std::vector<btrace_function> &functions = btinfo->functions;
+
+  /* Collect each segment's instruction count and call stack on the
+     thread pool; the workers only read the decoded trace.  The
+     aggregation into the per-function table happens serially
+     below.  */
+  std::vector<btrace_profile_contrib> contribs (functions.size ());
+
+  const btrace_function *first = functions.data ();
+  gdb::parallel_for_each
+    (256, first, first + functions.size (),
+     [&] (const btrace_function *begin, const btrace_function *end)
+     {
+       for (const btrace_function *bfun = begin; bfun < end; ++bfun)
+	 {
+	   btrace_profile_contrib &contrib = contribs[bfun - first];
+
+	   if (bfun->errcode != 0 || bfun->insn.empty ())
+	     continue;
+
+	   contrib.ninsns = bfun->insn.size ();
+	   contrib.new_call = bfun->prev == 0;
+	   contrib.stack.emplace_back (bfun->msym, bfun->sym);
+
+	   /* Walk the caller chain, collecting each function once
+	      even if it appears recursively.  Callers precede their
+	      callees in the trace, so insisting on strictly
+	      decreasing segment numbers terminates the walk even if
+	      gap bridging produced an unusual link.  */
+	   unsigned int number = bfun->number;
+	   for (unsigned int up = bfun->up; up != 0 && up < number;
+		number = up, up = functions[up - 1].up)
+	     {
+	       const btrace_function &caller = functions[up - 1];
+	       btrace_profile_key key (caller.msym, caller.sym);
+
+	       if (std::find (contrib.stack.begin (),
+			      contrib.stack.end (), key)
+		   == contrib.stack.end ())
+		 contrib.stack.push_back (key);
+	     }
+	 }
+     });
+
+  btrace_profile_map counts;
+  ULONGEST total = 0;
+
+  for (const btrace_profile_contrib &contrib : contribs)
+    {
+      if (contrib.ninsns == 0)
+	continue;
+
+      total += contrib.ninsns;
+
+      btrace_profile_counts &self = counts[contrib.stack.front ()];
+      self.exclusive += contrib.ninsns;
+      if (contrib.new_call)
+	self.calls += 1;
+
+      for (const btrace_profile_key &key : contrib.stack)
+	counts[key].inclusive += contrib.ninsns;
+    }
+
+  if (total == 0)
+    error (_("No trace."));
+
+  /* Sort by exclusive count, largest first.  */
+  std::vector<const btrace_profile_map::value_type *> rows;
+  rows.reserve (counts.size ());
+  for (const btrace_profile_map::value_type &it : counts)
+    rows.push_back (&it);
+
+  std::sort (rows.begin (), rows.end (),
+	     [] (const btrace_profile_map::value_type *lhs,
+		 const btrace_profile_map::value_type *rhs)
+	     {
+	       if (lhs->second.exclusive != rhs->second.exclusive)
+		 return lhs->second.exclusive > rhs->second.exclusive;
+	       return lhs->second.inclusive > rhs->second.inclusive;
+	     });
+
+  struct ui_out *uiout = current_uiout;
+  ui_out_emit_table table_emitter (uiout, 6, rows.size (),
+				   "BtraceProfileTable");
+
+  uiout->table_header (10, ui_right, "calls", _("Calls"));
+  uiout->table_header (14, ui_right, "insns", _("Insns"));
+  uiout->table_header (6, ui_right, "percent", _("Insns%"));
+  uiout->table_header (14, ui_right, "incl-insns", _("Incl.Insns"));
+  uiout->table_header (6, ui_right, "incl-percent", _("Incl%"));
+  uiout->table_header (1, ui_left, "function", _("Function"));
+  uiout->table_body ();
+
+  for (const btrace_profile_map::value_type *row : rows)
+    {
+      ui_out_emit_tuple tuple_emitter (uiout, NULL);
+
+      uiout->field_unsigned ("calls", row->second.calls);
+      uiout->field_unsigned ("insns", row->second.exclusive);
+      uiout->field_fmt ("percent", "%.2f",
+			100.0 * row->second.exclusive / total);
+      uiout->field_unsigned ("incl-insns", row->second.inclusive);
+      uiout->field_fmt ("incl-percent", "%.2f",
+			100.0 * row->second.inclusive / total);
+      uiout->field_string ("function",
+			   btrace_profile_function_name (row->first),
+			   function_name_style.style ());
+      uiout->text ("\n");
+    }
+
+  uiout->message (_("Profiled %s instructions in %s functions.\n"),
+		  pulongest (total), pulongest (rows.size ()));
+}
+
 /* The "show record btrace replay-memory-access" command.  */
 
 static void
@@ -3121,6 +3296,16 @@ This format may not be available on all processors."),
 	     &record_btrace_cmdlist);
   add_alias_cmd ("pt", record_btrace_pt_cmd, class_obscure, 1, &record_cmdlist);
 
+  add_cmd ("profile", class_obscure, cmd_record_btrace_profile, _("\
+Print an aggregated per-function profile of the recorded trace.\n\n\
+For each function, print the number of recorded invocations, the number\n\
+of recorded instructions executed in the function itself together with\n\
+the percentage of the trace this represents, and the same two figures\n\
+including all functions called from it.  A function appearing\n\
+recursively on a call stack is counted once.  Functions are sorted by\n\
+their own instruction count, largest first."),
+	   &record_btrace_cmdlist);
+
   add_setshow_prefix_cmd ("btrace", class_support,
 			  _("Set record options."),
 			  _("Show record options."),
@@ -41,8 +41,14 @@
 #include "async-event.h"
 #include "valprint.h"
 #include "interps.h"
+#include "exceptions.h"
+#include "objfiles.h"
+#include "gdbsupport/buildargv.h"
 
 #include <signal.h>
+#include <algorithm>
+#include <map>
+#include <vector>
 
 /* This module implements "target record-full", also known as "process
    record and replay".  This target sits on top of a "normal" target
@@ -148,6 +154,9 @@ struct record_full_entry
 {
   struct record_full_entry *prev;
   struct record_full_entry *next;
+  /* The arena segment this entry (and any out-of-line value payload
+     following it) was carved out of.  */
+  struct record_full_segment *seg;
   enum record_full_type type;
   union
   {
@@ -380,7 +389,97 @@ static void record_full_goto_insn (struct record_full_entry *entry,
 				   enum exec_direction_kind dir);
 
 /* Alloc and free functions for record_full_reg, record_full_mem, and
-   record_full_end entries.  */
+   record_full_end entries.
+
+   Entries are carved out of fixed-size arena segments instead of
+   being malloc'd one by one; a long recording creates millions of
+   entries, and the per-block malloc overhead (plus a second block for
+   any out-of-line value payload) used to dominate the memory the log
+   really needs.  Each segment counts the entries living in it and is
+   freed wholesale once the last one is released.  The log only ever
+   shrinks at its ends -- the oldest instructions are trimmed to honor
+   the insn-number limit, and re-recording after replay truncates the
+   tail -- so segments empty out in rough allocation order and little
+   memory lingers.  */
+
+/* Usable payload bytes per arena segment.  */
+#define RECORD_FULL_SEGMENT_SIZE (64 * 1024)
+
+struct record_full_segment
+{
+  /* Number of entries allocated in DATA that have not been released
+     yet.  */
+  size_t live;
+  /* Bytes of DATA handed out so far.  */
+  size_t used;
+  gdb_byte data[RECORD_FULL_SEGMENT_SIZE];
+};
+
+/* The segment new entries are carved out of.  */
+static struct record_full_segment *record_full_cur_segment;
+
+/* Alloc a zeroed record entry with PAYLOAD extra bytes following it
+   for an out-of-line value.  */
+
+static struct record_full_entry *
+record_full_entry_alloc (size_t payload)
+{
+  size_t size = align_up (sizeof (struct record_full_entry) + payload,
+			  alignof (struct record_full_entry));
+  struct record_full_segment *seg = record_full_cur_segment;
+
+  /* An entry too large for a shared segment (a big user write, or a
+     syscall recording a large buffer) gets a dedicated segment of the
+     required size.  It is not installed as the current segment, so
+     nothing else is carved out of it and it is freed as soon as its
+     one entry is released.  */
+  if (size > RECORD_FULL_SEGMENT_SIZE)
+    {
+      seg = ((struct record_full_segment *)
+	     xmalloc (offsetof (struct record_full_segment, data) + size));
+      seg->live = 1;
+      seg->used = size;
+
+      struct record_full_entry *rec = (struct record_full_entry *) seg->data;
+      memset (rec, 0, size);
+      rec->seg = seg;
+      return rec;
+    }
+
+  if (seg == NULL || RECORD_FULL_SEGMENT_SIZE - seg->used < size)
+    {
+      seg = XNEW (struct record_full_segment);
+      seg->live = 0;
+      seg->used = 0;
+      record_full_cur_segment = seg;
+    }
+
+  struct record_full_entry *rec
+    = (struct record_full_entry *) (seg->data + seg->used);
+  memset (rec, 0, size);
+  seg->used += size;
+  seg->live++;
+  rec->seg = seg;
+  return rec;
+}
+
+/* Release REC back to its arena segment, freeing the segment if REC
+   was the last entry living in it.  */
+
+static void
+record_full_entry_free (struct record_full_entry *rec)
+{
+  struct record_full_segment *seg = rec->seg;
+
+  gdb_assert (seg->live > 0);
+  if (--seg->live == 0)
+    {
+      if (seg == record_full_cur_segment)
+	seg->used = 0;
+      else
+	xfree (seg);
+    }
+}
 
 /* Alloc a record_full_reg record entry.  */
 
@@ -389,13 +488,17 @@ record_full_reg_alloc (struct regcache *regcache, int regnum)
 {
   struct record_full_entry *rec;
   struct gdbarch *gdbarch = regcache->arch ();
+  int len = register_size (gdbarch, regnum);
+  size_t payload = 0;
 
-  rec = XCNEW (struct record_full_entry);
+  if (len > sizeof (rec->u.reg.u.buf))
+    payload = len;
+  rec = record_full_entry_alloc (payload);
   rec->type = record_full_reg;
   rec->u.reg.num = regnum;
-  rec->u.reg.len = register_size (gdbarch, regnum);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
+  rec->u.reg.len = len;
+  if (payload != 0)
+    rec->u.reg.u.ptr = (gdb_byte *) (rec + 1);
 
   return rec;
 }
@@ -406,9 +509,7 @@ static inline void
 record_full_reg_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_reg);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_mem record entry.  */
@@ -417,13 +518,16 @@ static inline struct record_full_entry *
 record_full_mem_alloc (CORE_ADDR addr, int len)
 {
   struct record_full_entry *rec;
+  size_t payload = 0;
 
-  rec = XCNEW (struct record_full_entry);
+  if (len > sizeof (rec->u.mem.u.buf))
+    payload = len;
+  rec = record_full_entry_alloc (payload);
   rec->type = record_full_mem;
   rec->u.mem.addr = addr;
   rec->u.mem.len = len;
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
+  if (payload != 0)
+    rec->u.mem.u.ptr = (gdb_byte *) (rec + 1);
 
   return rec;
 }
@@ -434,9 +538,7 @@ static inline void
 record_full_mem_release (struct record_full_entry *rec)
 {
   gdb_assert (rec->type == record_full_mem);
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_end record entry.  */
@@ -446,7 +548,7 @@ record_full_end_alloc (void)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
+  rec = record_full_entry_alloc (0);
   rec->type = record_full_end;
 
   return rec;
@@ -457,7 +559,7 @@ record_full_end_alloc (void)
 static inline void
 record_full_end_release (struct record_full_entry *rec)
 {
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Free one record entry, any type.
@@ -697,6 +799,107 @@ record_full_check_insn_num (void)
     }
 }
 
+/* An address range excluded from per-instruction recording, set up
+   with "record full exclude-range" or "record full exclude-file".
+   END is exclusive.  SPEC is what the user typed, for "info
+   record".  */
+
+struct record_full_exclude_range
+{
+  CORE_ADDR start;
+  CORE_ADDR end;
+  std::string spec;
+};
+
+static std::vector<record_full_exclude_range> record_full_exclude_ranges;
+
+/* While the PC is inside an excluded range the executed instructions
+   are not recorded one by one.  Instead the whole stretch is folded
+   into a single log entry whose register values are captured when the
+   range is entered, so reverse execution steps over it as one unit
+   and restores the registers the excluded code found on entry.
+   Memory changed by the excluded code is deliberately not logged --
+   that is what makes the exclusion cheap -- so such changes are not
+   undone when replaying backward across the stretch.
+
+   The entry under construction is kept on this pending list until the
+   PC leaves the range (or a stop is reported to the user), at which
+   point it is linked into the log.  The swap-based replay mechanism
+   then works unchanged: the entry's recorded values are the
+   range-entry register values, and the first backward replay across
+   it deposits the range-exit values for later redo.  */
+
+static struct record_full_entry *record_full_exclude_head = NULL;
+static struct record_full_entry *record_full_exclude_tail = NULL;
+
+/* Return true if PC falls inside an excluded range.  */
+
+static bool
+record_full_pc_excluded_p (CORE_ADDR pc)
+{
+  for (const record_full_exclude_range &range : record_full_exclude_ranges)
+    if (pc >= range.start && pc < range.end)
+      return true;
+
+  return false;
+}
+
+/* Start summarizing execution inside an excluded range: capture the
+   current value of every register as the undo record of the pending
+   summary entry.  No-op if a summary is already pending.  */
+
+static void
+record_full_exclude_start (struct regcache *regcache)
+{
+  if (record_full_exclude_head != NULL)
+    return;
+
+  record_full_arch_list_head = NULL;
+  record_full_arch_list_tail = NULL;
+
+  for (int i = 0; i < gdbarch_num_regs (regcache->arch ()); i++)
+    {
+      if (record_full_arch_list_add_reg (regcache, i))
+	{
+	  record_full_list_release (record_full_arch_list_tail);
+	  error (_("Process record: failed to record execution log."));
+	}
+    }
+
+  record_full_exclude_head = record_full_arch_list_head;
+  record_full_exclude_tail = record_full_arch_list_tail;
+}
+
+/* Link the pending excluded-range summary into the log as a single
+   instruction.  No-op if no summary is pending.  */
+
+static void
+record_full_exclude_finish (void)
+{
+  if (record_full_exclude_head == NULL)
+    return;
+
+  record_full_arch_list_head = record_full_exclude_head;
+  record_full_arch_list_tail = record_full_exclude_tail;
+  record_full_exclude_head = NULL;
+  record_full_exclude_tail = NULL;
+
+  if (record_full_arch_list_add_end ())
+    {
+      record_full_list_release (record_full_arch_list_tail);
+      error (_("Process record: failed to record execution log."));
+    }
+
+  record_full_list->next = record_full_arch_list_head;
+  record_full_arch_list_head->prev = record_full_list;
+  record_full_list = record_full_arch_list_tail;
+
+  if (record_full_insn_num == record_full_insn_max_num)
+    record_full_list_release_first ();
+  else
+    record_full_insn_num++;
+}
+
 /* Before inferior step (when GDB record the running message, inferior
    only can step), GDB will call this function to record the values to
    record_full_list.  This function will call gdbarch_process_record to
@@ -709,6 +912,22 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
   int ret;
   struct gdbarch *gdbarch = regcache->arch ();
 
+  if (!record_full_exclude_ranges.empty ())
+    {
+      /* Instructions inside an excluded range are folded into one
+	 pending summary entry instead of being recorded one by one.
+	 Any signal delivered there is left unrecorded; a signal that
+	 stops the inferior still reaches the user, it is just not
+	 redelivered when replaying across the summary.  */
+      if (record_full_pc_excluded_p (regcache_read_pc (regcache)))
+	{
+	  record_full_exclude_start (regcache);
+	  return;
+	}
+
+      record_full_exclude_finish ();
+    }
+
   try
     {
       record_full_arch_list_head = NULL;
@@ -810,6 +1029,213 @@ record_full_gdb_operation_disable_set (void)
 static enum target_stop_reason record_full_stop_reason
   = TARGET_STOPPED_BY_NO_REASON;
 
+/* Scratch state for long seeks through the execution log ("record
+   goto", "record save").  Applying a log entry swaps its saved values
+   with the current target state, so a seek across a million
+   instructions used to cost millions of register and memory round
+   trips to the target.  During a seek the swaps are made against this
+   cache instead, and only the final value of each register and byte
+   of memory touched is written back to the target, once, when the
+   seek is done.  The entries still see exactly the values the target
+   would have returned, so the log contents after the seek are
+   unchanged.  */
+
+class record_full_seek_state
+{
+public:
+  explicit record_full_seek_state (struct regcache *regcache)
+    : m_regcache (regcache)
+  {}
+
+  ~record_full_seek_state ()
+  {
+    /* Bring the target up to date even if the seek was cut short by
+       an error.  */
+    try
+      {
+	flush ();
+      }
+    catch (const gdb_exception &ex)
+      {
+	exception_print (gdb_stderr, ex);
+      }
+  }
+
+  DISABLE_COPY_AND_ASSIGN (record_full_seek_state);
+
+  /* Read the current value of register REGNUM into BUF.  */
+  void read_register (int regnum, gdb_byte *buf);
+
+  /* Record BUF as the new value of register REGNUM.  */
+  void write_register (int regnum, const gdb_byte *buf);
+
+  /* Read LEN current bytes of memory at ADDR into BUF.  Returns
+     non-zero on failure, like record_read_memory.  */
+  int read_memory (struct gdbarch *gdbarch, CORE_ADDR addr,
+		   gdb_byte *buf, int len);
+
+  /* Record BUF as the new contents of [ADDR, ADDR + LEN).  */
+  void write_memory (CORE_ADDR addr, const gdb_byte *buf, int len);
+
+  /* Write every accumulated register and memory change to the
+     target.  */
+  void flush ();
+
+private:
+  /* Cached target memory, in aligned blocks.  A byte is read from
+     the target at most once and written back at most once.  */
+  struct mem_block
+  {
+    gdb::byte_vector data;
+    /* Which bytes of DATA hold the current memory contents.  */
+    std::vector<bool> valid;
+    /* Which bytes of DATA the target has not seen yet.  */
+    std::vector<bool> dirty;
+  };
+
+  static constexpr int block_size = 4096;
+
+  /* Return the block holding ADDR, creating it if necessary, and set
+     *BASE to its starting address.  */
+  mem_block &get_block (CORE_ADDR addr, CORE_ADDR *base)
+  {
+    *base = addr & ~(CORE_ADDR) (block_size - 1);
+    mem_block &block = m_mem[*base];
+    if (block.data.empty ())
+      {
+	block.data.resize (block_size);
+	block.valid.resize (block_size);
+	block.dirty.resize (block_size);
+      }
+    return block;
+  }
+
+  struct regcache *m_regcache;
+  /* Final value of each register written so far.  */
+  std::map<int, gdb::byte_vector> m_regs;
+  std::map<CORE_ADDR, mem_block> m_mem;
+};
+
+void
+record_full_seek_state::read_register (int regnum, gdb_byte *buf)
+{
+  auto it = m_regs.find (regnum);
+  if (it != m_regs.end ())
+    memcpy (buf, it->second.data (), it->second.size ());
+  else
+    m_regcache->cooked_read (regnum, buf);
+}
+
+void
+record_full_seek_state::write_register (int regnum, const gdb_byte *buf)
+{
+  int len = register_size (m_regcache->arch (), regnum);
+  gdb::byte_vector &val = m_regs[regnum];
+
+  val.resize (len);
+  memcpy (val.data (), buf, len);
+}
+
+int
+record_full_seek_state::read_memory (struct gdbarch *gdbarch,
+				     CORE_ADDR addr, gdb_byte *buf, int len)
+{
+  while (len > 0)
+    {
+      CORE_ADDR base;
+      mem_block &block = get_block (addr, &base);
+      int offs = addr - base;
+      int chunk = std::min (len, block_size - offs);
+
+      /* Fill any bytes of the range we have not seen yet from the
+	 target.  */
+      int i = 0;
+      while (i < chunk)
+	{
+	  if (block.valid[offs + i])
+	    {
+	      i++;
+	      continue;
+	    }
+	  int j = i + 1;
+	  while (j < chunk && !block.valid[offs + j])
+	    j++;
+	  if (record_read_memory (gdbarch, base + offs + i,
+				  block.data.data () + offs + i, j - i))
+	    return 1;
+	  for (int k = i; k < j; k++)
+	    block.valid[offs + k] = true;
+	  i = j;
+	}
+
+      memcpy (buf, block.data.data () + offs, chunk);
+      buf += chunk;
+      addr += chunk;
+      len -= chunk;
+    }
+  return 0;
+}
+
+void
+record_full_seek_state::write_memory (CORE_ADDR addr, const gdb_byte *buf,
+				      int len)
+{
+  while (len > 0)
+    {
+      CORE_ADDR base;
+      mem_block &block = get_block (addr, &base);
+      int offs = addr - base;
+      int chunk = std::min (len, block_size - offs);
+
+      memcpy (block.data.data () + offs, buf, chunk);
+      for (int i = 0; i < chunk; i++)
+	{
+	  block.valid[offs + i] = true;
+	  block.dirty[offs + i] = true;
+	}
+      buf += chunk;
+      addr += chunk;
+      len -= chunk;
+    }
+}
+
+void
+record_full_seek_state::flush ()
+{
+  for (const auto &reg : m_regs)
+    m_regcache->cooked_write (reg.first, reg.second.data ());
+  m_regs.clear ();
+
+  for (const auto &pair : m_mem)
+    {
+      const mem_block &block = pair.second;
+
+      if (block.dirty.empty ())
+	continue;
+
+      /* Write back each run of dirty bytes with a single call.  */
+      int i = 0;
+      while (i < block_size)
+	{
+	  if (!block.dirty[i])
+	    {
+	      i++;
+	      continue;
+	    }
+	  int j = i + 1;
+	  while (j < block_size && block.dirty[j])
+	    j++;
+	  if (target_write_memory (pair.first + i,
+				   block.data.data () + i, j - i))
+	    warning (_("Process record: error writing memory at "
+		       "addr = %s len = %d."),
+		     paddress (m_regcache->arch (), pair.first + i), j - i);
+	  i = j;
+	}
+    }
+  m_mem.clear ();
+}
+
 /* Execute one instruction from the record log.  Each instruction in
    the log will be represented by an arbitrary sequence of register
    entries and memory entries, followed by an 'end' entry.  */
@@ -817,7 +1243,8 @@ static enum target_stop_reason record_full_stop_reason
 static inline void
 record_full_exec_insn (struct regcache *regcache,
 		       struct gdbarch *gdbarch,
-		       struct record_full_entry *entry)
+		       struct record_full_entry *entry,
+		       record_full_seek_state *seek = nullptr)
 {
   switch (entry->type)
     {
@@ -832,8 +1259,18 @@ record_full_exec_insn (struct regcache *regcache,
 		      host_address_to_string (entry),
 		      entry->u.reg.num);
 
-	regcache->cooked_read (entry->u.reg.num, reg.data ());
-	regcache->cooked_write (entry->u.reg.num, record_full_get_loc (entry));
+	if (seek != nullptr)
+	  {
+	    seek->read_register (entry->u.reg.num, reg.data ());
+	    seek->write_register (entry->u.reg.num,
+				  record_full_get_loc (entry));
+	  }
+	else
+	  {
+	    regcache->cooked_read (entry->u.reg.num, reg.data ());
+	    regcache->cooked_write (entry->u.reg.num,
+				    record_full_get_loc (entry));
+	  }
 	memcpy (record_full_get_loc (entry), reg.data (), entry->u.reg.len);
       }
       break;
@@ -853,15 +1290,35 @@ record_full_exec_insn (struct regcache *regcache,
 			  paddress (gdbarch, entry->u.mem.addr),
 			  entry->u.mem.len);
 
-	    if (record_read_memory (gdbarch,
-				    entry->u.mem.addr, mem.data (),
-				    entry->u.mem.len))
+	    int read_failed;
+	    if (seek != nullptr)
+	      read_failed = seek->read_memory (gdbarch, entry->u.mem.addr,
+					       mem.data (),
+					       entry->u.mem.len);
+	    else
+	      read_failed = record_read_memory (gdbarch,
+						entry->u.mem.addr,
+						mem.data (),
+						entry->u.mem.len);
+
+	    if (read_failed)
 	      entry->u.mem.mem_entry_not_accessible = 1;
 	    else
 	      {
-		if (target_write_memory (entry->u.mem.addr, 
-					 record_full_get_loc (entry),
-					 entry->u.mem.len))
+		/* In a seek the write is deferred; failures are
+		   reported when the seek state is flushed.  */
+		int write_failed = 0;
+		if (seek != nullptr)
+		  seek->write_memory (entry->u.mem.addr,
+				      record_full_get_loc (entry),
+				      entry->u.mem.len);
+		else
+		  write_failed
+		    = target_write_memory (entry->u.mem.addr,
+					   record_full_get_loc (entry),
+					   entry->u.mem.len);
+
+		if (write_failed)
 		  {
 		    entry->u.mem.mem_entry_not_accessible = 1;
 		    if (record_debug)
@@ -997,6 +1454,11 @@ record_full_base_target::close ()
 
   record_full_list_release (record_full_list);
 
+  /* Release a pending excluded-range summary, if any.  */
+  record_full_list_release (record_full_exclude_tail);
+  record_full_exclude_head = NULL;
+  record_full_exclude_tail = NULL;
+
   /* Release record_full_core_regbuf.  */
   if (record_full_core_regbuf)
     {
@@ -1470,6 +1932,12 @@ record_full_base_target::wait (ptid_t ptid, struct target_waitstatus *status,
   return_ptid = record_full_wait_1 (this, ptid, status, options);
   if (status->kind () != TARGET_WAITKIND_IGNORE)
     {
+      /* If we stopped inside an excluded range, the pending summary
+	 must make it into the log before the user can replay; it
+	 holds the registers needed to get back to where the range was
+	 entered.  */
+      record_full_exclude_finish ();
+
       /* We're reporting a stop.  Make sure any spurious
 	 target_wait(WNOHANG) doesn't advance the target until the
 	 core wants us resumed again.  */
@@ -1943,6 +2411,18 @@ record_full_base_target::info_record ()
   /* Display max log size.  */
   gdb_printf (_("Max logged instructions is %u.\n"),
 	      record_full_insn_max_num);
+
+  /* Display the excluded address ranges.  */
+  if (!record_full_exclude_ranges.empty ())
+    {
+      gdb_printf (_("Address ranges excluded from recording:\n"));
+      for (const record_full_exclude_range &range
+	     : record_full_exclude_ranges)
+	gdb_printf (_("  %s - %s (%s)\n"),
+		    paddress (target_gdbarch (), range.start),
+		    paddress (target_gdbarch (), range.end),
+		    range.spec.c_str ());
+    }
 }
 
 bool
@@ -2556,6 +3036,11 @@ record_full_base_target::save_record (const char *recfilename)
   scoped_restore restore_operation_disable
     = record_full_gdb_operation_disable_set ();
 
+  /* Batch the target accesses of the two full passes over the log
+     below; the final state is written back when SEEK goes out of
+     scope.  */
+  record_full_seek_state seek (regcache);
+
   /* Reverse execute to the begin of record list.  */
   while (1)
     {
@@ -2563,7 +3048,7 @@ record_full_base_target::save_record (const char *recfilename)
       if (record_full_list == &record_full_first)
 	break;
 
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
+      record_full_exec_insn (regcache, gdbarch, record_full_list, &seek);
 
       if (record_full_list->prev)
 	record_full_list = record_full_list->prev;
@@ -2696,7 +3181,7 @@ record_full_base_target::save_record (const char *recfilename)
 	}
 
       /* Execute entry.  */
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
+      record_full_exec_insn (regcache, gdbarch, record_full_list, &seek);
 
       if (record_full_list->next)
 	record_full_list = record_full_list->next;
@@ -2711,7 +3196,7 @@ record_full_base_target::save_record (const char *recfilename)
       if (record_full_list == cur_record_full_list)
 	break;
 
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
+      record_full_exec_insn (regcache, gdbarch, record_full_list, &seek);
 
       if (record_full_list->prev)
 	record_full_list = record_full_list->prev;
@@ -2736,6 +3221,7 @@ record_full_goto_insn (struct record_full_entry *entry,
     = record_full_gdb_operation_disable_set ();
   struct regcache *regcache = get_current_regcache ();
   struct gdbarch *gdbarch = regcache->arch ();
+  record_full_seek_state seek (regcache);
 
   /* Assume everything is valid: we will hit the entry,
      and we will not hit the end of the recording.  */
@@ -2745,7 +3231,7 @@ record_full_goto_insn (struct record_full_entry *entry,
 
   do
     {
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
+      record_full_exec_insn (regcache, gdbarch, record_full_list, &seek);
       if (dir == EXEC_REVERSE)
 	record_full_list = record_full_list->prev;
       else
@@ -2761,6 +3247,75 @@ cmd_record_full_start (const char *args, int from_tty)
   execute_command ("target record-full", from_tty);
 }
 
+/* Implement the "record full exclude-range" command.  */
+
+static void
+cmd_record_full_exclude_range (const char *args, int from_tty)
+{
+  if (args == NULL || *args == '\0')
+    error (_("Argument required (start and end address)."));
+
+  gdb_argv argv (args);
+
+  if (argv.count () != 2)
+    error (_("Usage: record full exclude-range START END"));
+
+  CORE_ADDR start = parse_and_eval_address (argv[0]);
+  CORE_ADDR end = parse_and_eval_address (argv[1]);
+
+  if (start >= end)
+    error (_("Invalid address range."));
+
+  record_full_exclude_ranges.push_back ({ start, end, std::string (args) });
+}
+
+/* Implement the "record full exclude-file" command.  Exclude the code
+   sections of every loaded objfile whose file name matches.  */
+
+static void
+cmd_record_full_exclude_file (const char *args, int from_tty)
+{
+  if (args == NULL || *args == '\0')
+    error (_("Argument required (file name)."));
+
+  int nranges = 0;
+
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      const char *name = objfile_name (objfile);
+
+      if (strcmp (name, args) != 0
+	  && strcmp (lbasename (name), args) != 0)
+	continue;
+
+      for (obj_section *osect : objfile->sections ())
+	{
+	  if ((osect->the_bfd_section->flags & SEC_CODE) == 0
+	      || osect->addr () >= osect->endaddr ())
+	    continue;
+
+	  record_full_exclude_ranges.push_back ({ osect->addr (),
+						  osect->endaddr (),
+						  std::string (args) });
+	  nranges++;
+	}
+    }
+
+  if (nranges == 0)
+    error (_("No code sections found for `%s'."), args);
+
+  gdb_printf (_("Excluded %d code section%s of `%s' from recording.\n"),
+	      nranges, nranges == 1 ? "" : "s", args);
+}
+
+/* Implement the "record full exclude-delete" command.  */
+
+static void
+cmd_record_full_exclude_delete (const char *args, int from_tty)
+{
+  record_full_exclude_ranges.clear ();
+}
+
 static void
 set_record_full_insn_max_num (const char *args, int from_tty,
 			      struct cmd_list_element *c)
@@ -2886,6 +3441,30 @@ Argument is filename.  File must be created with 'record save'."),
 	       &record_full_cmdlist);
   set_cmd_completer (record_full_restore_cmd, filename_completer);
 
+  add_cmd ("exclude-range", class_obscure, cmd_record_full_exclude_range,
+	   _("Exclude an address range from per-instruction recording.\n\
+Usage: record full exclude-range START END\n\
+Instructions executed between START (inclusive) and END (exclusive) are\n\
+folded into a single log entry that restores the registers on reverse\n\
+execution.  Memory changed by excluded code is not logged and is not\n\
+undone when replaying backward across it."),
+	   &record_full_cmdlist);
+
+  cmd_list_element *record_full_exclude_file_cmd
+    = add_cmd ("exclude-file", class_obscure, cmd_record_full_exclude_file,
+	       _("Exclude an object file's code from per-instruction \
+recording.\n\
+Usage: record full exclude-file FILENAME\n\
+Excludes the code sections of every loaded object file whose name or\n\
+base name matches FILENAME, as \"record full exclude-range\" would."),
+	       &record_full_cmdlist);
+  set_cmd_completer (record_full_exclude_file_cmd, filename_completer);
+
+  add_cmd ("exclude-delete", class_obscure, cmd_record_full_exclude_delete,
+	   _("Delete all recording exclusions.\n\
+Usage: record full exclude-delete"),
+	   &record_full_cmdlist);
+
   /* Deprecate the old version without "full" prefix.  */
   c = add_alias_cmd ("restore", record_full_restore_cmd, class_obscure, 1,
 		     &record_cmdlist);
@@ -584,6 +584,45 @@ registers_changed (void)
   registers_changed_ptid (nullptr, minus_one_ptid);
 }
 
+/* Counters behind "maint print register-fetch-stats": how many times
+   the target was asked for a single register and for all registers
+   since GDB started.  */
+
+static ULONGEST single_register_fetches;
+static ULONGEST full_register_fetches;
+
+/* See regcache.h.  */
+
+void
+record_register_fetch (int regnum)
+{
+  if (regnum == -1)
+    full_register_fetches++;
+  else
+    single_register_fetches++;
+}
+
+/* Implement "maint print register-fetch-stats".  Besides the session
+   totals, print the counts accumulated since the command was last
+   run, so running it at two points -- say, at consecutive stops --
+   shows the fetches spent in between.  */
+
+static void
+maintenance_print_register_fetch_stats (const char *args, int from_tty)
+{
+  static ULONGEST last_single, last_full;
+
+  gdb_printf (_("Single-register fetches: %s (%s since last shown)\n"),
+	      pulongest (single_register_fetches),
+	      pulongest (single_register_fetches - last_single));
+  gdb_printf (_("Full fetches (all registers): %s (%s since last shown)\n"),
+	      pulongest (full_register_fetches),
+	      pulongest (full_register_fetches - last_full));
+
+  last_single = single_register_fetches;
+  last_full = full_register_fetches;
+}
+
 void
 regcache::raw_update (int regnum)
 {
@@ -2162,6 +2201,13 @@ _initialize_regcache ()
 		     class_maintenance, 0);
   deprecate_cmd (c, "maintenance flush register-cache");
 
+  add_cmd ("register-fetch-stats", class_maintenance,
+	   maintenance_print_register_fetch_stats, _("\
+Print statistics about register fetches from the target.\n\
+Shows how often the target was asked for a single register and for\n\
+all registers, both in total and since the command was last run."),
+	   &maintenanceprintlist);
+
 #if GDB_SELF_TEST
   selftests::register_test ("get_thread_arch_aspace_regcache",
 			    selftests::get_thread_arch_aspace_regcache_test);
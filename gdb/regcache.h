@@ -497,6 +497,11 @@ extern void registers_changed_ptid (process_stratum_target *target,
    the cache.  */
 extern void registers_changed_thread (thread_info *thread);
 
+/* Count one register fetch sent to the target, for "maint print
+   register-fetch-stats".  REGNUM is the register that was requested,
+   or -1 for all of them.  Called by target_fetch_registers.  */
+extern void record_register_fetch (int regnum);
+
 /* An abstract base class for register dump.  */
 
 class register_dump
@@ -39,6 +39,7 @@
 #include "solib.h"
 #include "cli/cli-decode.h"
 #include "cli/cli-setshow.h"
+#include "target-connection.h"
 #include "target-descriptions.h"
 #include "gdb_bfd.h"
 #include "gdbsupport/filestuff.h"
@@ -56,6 +57,7 @@
 #include "serial.h"
 
 #include "gdbcore.h"
+#include "maint.h"
 
 #include "remote-fileio.h"
 #include "gdbsupport/fileio.h"
@@ -76,6 +78,7 @@
 #include "gdbsupport/search.h"
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <unordered_map>
 #include "async-event.h"
 #include "gdbsupport/selftest.h"
@@ -302,6 +305,21 @@ enum {
      packets and the tag violation stop replies.  */
   PACKET_memory_tagging_feature,
 
+  /* Support the 'x' packet: binary memory reads.  */
+  PACKET_x,
+
+  /* Support the qThreadRegisters packet: batched register fetches
+     for several threads in one round trip.  */
+  PACKET_qThreadRegisters,
+
+  /* Support the qTBufferBin packet: trace buffer reads with escaped
+     binary data instead of hex.  */
+  PACKET_qTBufferBin,
+
+  /* Support the vstopped-batch feature: several stop replies per
+     vStopped response.  */
+  PACKET_vstopped_batch_feature,
+
   PACKET_MAX
 };
 
@@ -331,6 +349,34 @@ struct vCont_action_support
 
 #define MAXTHREADLISTRESULTS 32
 
+/* Data for one block of the vFile:pread readahead cache.  */
+
+struct readahead_cache_block
+{
+  /* The file descriptor for the file this block caches.  -1 if the
+     block is invalid.  */
+  int fd = -1;
+
+  /* The offset into the file that the block's buffer corresponds
+     to.  */
+  ULONGEST offset = 0;
+
+  /* The buffer holding the block contents.  */
+  gdb::byte_vector buf;
+
+  /* Tick of the last access, for LRU replacement.  */
+  ULONGEST last_used = 0;
+};
+
+/* Number of blocks in the vFile:pread readahead cache.  BFD
+   alternates between distant areas of a binary while parsing it --
+   e.g., the ELF header, the section header table near the end of the
+   file, and section contents in between -- so a handful of blocks
+   replaced in LRU order avoids refetching data that a single-block
+   cache would have already discarded.  */
+
+#define READAHEAD_CACHE_BLOCKS 4
+
 /* Data for the vFile:pread readahead cache.  */
 
 struct readahead_cache
@@ -345,16 +391,15 @@ struct readahead_cache
      read, or 0 if the request can't be served from the cache.  */
   int pread (int fd, gdb_byte *read_buf, size_t len, ULONGEST offset);
 
-  /* The file descriptor for the file that is being cached.  -1 if the
-     cache is invalid.  */
-  int fd = -1;
+  /* Return the block to fill for a new read, evicting the least
+     recently used valid block if necessary.  */
+  readahead_cache_block *block_to_fill ();
 
-  /* The offset into the file that the cache buffer corresponds
-     to.  */
-  ULONGEST offset = 0;
+  /* The cache blocks.  */
+  readahead_cache_block blocks[READAHEAD_CACHE_BLOCKS];
 
-  /* The buffer holding the cache contents.  */
-  gdb::byte_vector buf;
+  /* Access tick, incremented on every lookup.  */
+  ULONGEST tick = 0;
 
   /* Cache hit and miss counters.  */
   ULONGEST hit_count = 0;
@@ -423,6 +468,12 @@ public: /* data */
      packets.  */
   gdb::char_vector buf;
 
+  /* A persistent buffer used by putpkt_binary to frame outgoing
+     packets, kept here to avoid allocating a fresh buffer for every
+     packet sent.  Grown on demand; its contents are only meaningful
+     during a single putpkt_binary call.  */
+  gdb::char_vector framing_buf;
+
   /* True if we're going through initial connection setup (finding out
      about the remote side's threads, relocating symbols, etc.).  */
   bool starting_up = false;
@@ -507,6 +558,16 @@ public: /* data */
   bool use_threadinfo_query = false;
   bool use_threadextra_query = false;
 
+  /* The qXfer:threads document that update_thread_list last
+     synchronized GDB's thread list with.  If a newly fetched document
+     is byte-for-byte identical to this one, the target's thread list
+     (including each thread's name, core and handle) is unchanged and
+     both the XML parse and the reconciliation against GDB's thread
+     list can be skipped.  Cleared whenever GDB's own thread list
+     changes behind update_thread_list's back, so that the next update
+     does a full reconciliation.  */
+  std::string last_threads_xml;
+
   threadref echo_nextthread {};
   threadref nextthread {};
   threadref resultthreadlist[MAXTHREADLISTRESULTS] {};
@@ -531,6 +592,39 @@ public: /* data */
      file descriptor at a time.  */
   struct readahead_cache readahead_cache;
 
+  /* Counts of packets sent to and received from the target over this
+     connection, for "maint info io-stats".  Notifications count as
+     received packets; retransmissions of a single packet count
+     once.  */
+  ULONGEST packets_sent = 0;
+  ULONGEST packets_received = 0;
+
+  /* The packet whose reply has not been read yet, for the accounting
+     behind "maint info packet-stats": the name it is accounted under,
+     the command it was attributed to, and when it was sent.
+     PENDING_STATS_PACKET is empty when no reply is outstanding.  When
+     packets are pipelined (breakpoint insertion batches), only the
+     most recently sent one is timed.  */
+  std::string pending_stats_packet;
+  std::string pending_stats_command;
+  std::chrono::steady_clock::time_point pending_stats_send_time;
+
+  /* Breakpoint locations whose Z0 insertion packet has been sent but
+     whose reply has not been read yet, in sending order.  Only
+     non-empty between breakpoint_batch_begin and
+     breakpoint_batch_done; the pointers are owned by the breakpoint
+     module and stay valid for at least that long.  */
+  std::vector<struct bp_target_info *> pending_z0_inserts;
+
+  /* True while insert_breakpoint may pipeline Z0 packets, i.e.
+     between breakpoint_batch_begin and breakpoint_batch_done.  */
+  bool z0_batching = false;
+
+  /* True while the Z0 packet of a pipelined insertion is being sent.
+     Keeps putpkt_binary from trying to flush the very queue the
+     outgoing packet belongs to.  */
+  bool sending_pipelined_z0 = false;
+
   /* The list of already fetched and acknowledged stop events.  This
      queue is used for notification Stop, and other notifications
      don't need queue for their events, because the notification
@@ -727,6 +821,10 @@ public:
   int remove_breakpoint (struct gdbarch *, struct bp_target_info *,
 			 enum remove_bp_reason) override;
 
+  void breakpoint_batch_begin () override;
+  void breakpoint_batch_done () override;
+
+  void flush_pending_breakpoint_inserts ();
 
   bool stopped_by_sw_breakpoint () override;
   bool supports_stopped_by_sw_breakpoint () override;
@@ -789,6 +887,8 @@ public:
 
   void stop (ptid_t) override;
 
+  void stop_threads (gdb::array_view<const ptid_t>) override;
+
   void interrupt () override;
 
   void pass_ctrlc () override;
@@ -1084,6 +1184,7 @@ public: /* Remote specific methods.  */
   void remote_parse_stop_reply (const char *buf, stop_reply *event);
 
   void remote_stop_ns (ptid_t ptid);
+  void remote_stop_ns_batch (gdb::array_view<const ptid_t> ptids);
   void remote_interrupt_as ();
   void remote_interrupt_ns ();
 
@@ -1154,7 +1255,9 @@ public: /* Remote specific methods.  */
   int fetch_register_using_p (struct regcache *regcache,
 			      packet_reg *reg);
   int send_g_packet ();
-  void process_g_packet (struct regcache *regcache);
+  void process_g_packet (struct regcache *regcache,
+			 const char *g_data = nullptr);
+  bool fetch_registers_batched (struct regcache *regcache);
   void fetch_registers_using_g (struct regcache *regcache);
   int store_register_using_P (const struct regcache *regcache,
 			      packet_reg *reg);
@@ -1334,6 +1437,155 @@ is_remote_target (process_stratum_target *target)
   return as_remote_target (target) != nullptr;
 }
 
+/* See remote.h.  */
+
+void
+remote_print_io_stats (struct ui_file *stream)
+{
+  for (process_stratum_target *target : all_non_exited_process_targets ())
+    {
+      remote_target *remote = as_remote_target (target);
+      if (remote == nullptr)
+	continue;
+
+      remote_state *rs = remote->get_remote_state ();
+      gdb_printf (stream,
+		  _("  Connection %d (%s): %s packets sent, "
+		    "%s packets received\n"),
+		  target->connection_number,
+		  make_target_connection_string (target).c_str (),
+		  pulongest (rs->packets_sent),
+		  pulongest (rs->packets_received));
+    }
+}
+
+/* Always-on accounting of remote protocol traffic, for "maint info
+   packet-stats".  Unlike "set debug remote", which logs every packet
+   and is unusable on chatty sessions, this only aggregates: one
+   bucket per (command, packet name) pair, cheap enough to leave
+   permanently enabled.  The table is global rather than part of
+   remote_state so that it survives reconnects.  */
+
+struct packet_stat
+{
+  /* Number of packets sent, i.e. round trips.  */
+  ULONGEST count = 0;
+
+  /* Payload bytes sent and received, excluding framing.  */
+  ULONGEST bytes_sent = 0;
+  ULONGEST bytes_received = 0;
+
+  /* Round-trip latency histogram: under 0.1ms, 1ms, 10ms, 100ms, and
+     the rest.  The latency of a packet whose reply is deferred, such
+     as vCont, includes the time the inferior spent running.  */
+  ULONGEST latency[5] = {};
+
+  /* Sum of the round-trip latencies, for computing the average.  */
+  std::chrono::steady_clock::duration total_latency {};
+};
+
+/* The statistics, indexed by the command that was executing when the
+   packet was sent and then by packet name.  An ordered map, so that
+   "maint info packet-stats" prints in a stable order.  */
+
+static std::map<std::string, std::map<std::string, packet_stat>>
+  packet_stats_table;
+
+/* Return the name under which the packet in BUF, of CNT bytes, is
+   accounted: the packet name for 'q'/'Q'/'v' packets (keeping the
+   second component of qXfer and vFile packets, as in "qXfer:threads",
+   since those behave like distinct packet types), the type-qualified
+   letter for 'Z'/'z' packets, and the leading character otherwise.  */
+
+static std::string
+packet_stats_name (const char *buf, int cnt)
+{
+  if (cnt <= 0)
+    return "(empty)";
+
+  char first = buf[0];
+
+  if (first == 'q' || first == 'Q' || first == 'v')
+    {
+      int len = 1;
+      while (len < cnt
+	     && (isalnum ((unsigned char) buf[len])
+		 || buf[len] == '_' || buf[len] == '-'))
+	len++;
+
+      if (len == 5 && len < cnt && buf[len] == ':'
+	  && (startswith (buf, "qXfer") || startswith (buf, "vFile")))
+	{
+	  len++;
+	  while (len < cnt && buf[len] != ':' && buf[len] != ';')
+	    len++;
+	}
+
+      return std::string (buf, len);
+    }
+
+  if ((first == 'Z' || first == 'z') && cnt >= 2)
+    return std::string (buf, 2);
+
+  return std::string (buf, 1);
+}
+
+/* The "maint info packet-stats" command.  */
+
+static void
+maintenance_info_packet_stats (const char *args, int from_tty)
+{
+  bool printed = false;
+
+  for (const auto &per_command : packet_stats_table)
+    {
+      if (args != nullptr
+	  && strstr (per_command.first.c_str (), args) == nullptr)
+	continue;
+
+      if (printed)
+	gdb_printf ("\n");
+      printed = true;
+
+      gdb_printf (_("Command \"%s\":\n"), per_command.first.c_str ());
+      gdb_printf ("  %-22s %8s %11s %11s %7s %7s %7s %7s %7s %9s\n",
+		  "Packet", "Count", "Sent", "Recvd",
+		  "<0.1ms", "<1ms", "<10ms", "<100ms", "more", "Avg (ms)");
+
+      for (const auto &per_packet : per_command.second)
+	{
+	  const packet_stat &stat = per_packet.second;
+
+	  gdb_printf ("  %-22s %8s %11s %11s",
+		      per_packet.first.c_str (),
+		      pulongest (stat.count),
+		      pulongest (stat.bytes_sent),
+		      pulongest (stat.bytes_received));
+
+	  ULONGEST replies = 0;
+	  for (int i = 0; i < 5; i++)
+	    {
+	      gdb_printf (" %7s", pulongest (stat.latency[i]));
+	      replies += stat.latency[i];
+	    }
+
+	  if (replies > 0)
+	    {
+	      double ms = (std::chrono::duration<double, std::milli>
+			   (stat.total_latency).count ());
+	      gdb_printf (" %9.3f", ms / replies);
+	    }
+	  else
+	    gdb_printf (" %9s", "-");
+
+	  gdb_printf ("\n");
+	}
+    }
+
+  if (!printed)
+    gdb_printf (_("No remote packets have been recorded.\n"));
+}
+
 /* Per-program-space data key.  */
 static const registry<program_space>::key<char, gdb::xfree_deleter<char>>
   remote_pspace_data;
@@ -2748,6 +3000,11 @@ remote_target::remote_add_thread (ptid_t ptid, bool running, bool executing,
   else
     thread = add_thread (this, ptid);
 
+  /* GDB's thread list no longer matches the thread list document
+     last fetched from the target; make sure the next thread list
+     update does a full reconciliation.  */
+  rs->last_threads_xml.clear ();
+
   /* We start by assuming threads are resumed.  That state then gets updated
      when we process a matching stop reply.  */
   get_remote_thread_info (thread)->set_resumed ();
@@ -3900,6 +4157,15 @@ struct threads_listing_context
 
   /* The threads found on the remote target.  */
   std::vector<thread_item> items;
+
+  /* The qXfer:threads document ITEMS was parsed from, when the list
+     was fetched that way.  */
+  std::string threads_xml;
+
+  /* True if the target sent the same qXfer:threads document as on the
+     previous fetch.  ITEMS is then left empty, since the thread list
+     is already known to be in sync.  */
+  bool unchanged = false;
 };
 
 static int
@@ -4035,8 +4301,23 @@ remote_target::remote_get_threads_with_qxfer (threads_listing_context *context)
 
       if (xml && (*xml)[0] != '\0')
 	{
-	  gdb_xml_parse_quick (_("threads"), "threads.dtd",
-			       threads_elements, xml->data (), context);
+	  struct remote_state *rs = get_remote_state ();
+
+	  /* With thousands of threads the document is large, and both
+	     parsing it and reconciling the result against GDB's
+	     thread list are expensive.  If it is identical to the
+	     document we last synchronized with, the target's thread
+	     list has not changed at all; tell the caller so it can
+	     skip both.  */
+	  if (!rs->last_threads_xml.empty ()
+	      && rs->last_threads_xml == xml->data ())
+	    context->unchanged = true;
+	  else
+	    {
+	      context->threads_xml = xml->data ();
+	      gdb_xml_parse_quick (_("threads"), "threads.dtd",
+				   threads_elements, xml->data (), context);
+	    }
 	}
 
       return 1;
@@ -4116,6 +4397,11 @@ remote_target::update_thread_list ()
     {
       got_list = 1;
 
+      /* The target sent the same thread list document as last time,
+	 so GDB's thread list is already in sync with it.  */
+      if (context.unchanged)
+	return;
+
       if (context.items.empty ()
 	  && remote_thread_always_alive (inferior_ptid))
 	{
@@ -4176,6 +4462,12 @@ remote_target::update_thread_list ()
 	      info->thread_handle = std::move (item.thread_handle);
 	    }
 	}
+
+      /* Remember the document we just synchronized with.  Done last,
+	 so that the invalidation in remote_add_thread, called while
+	 reconciling above, does not discard it.  */
+      get_remote_state ()->last_threads_xml
+	= std::move (context.threads_xml);
     }
 
   if (!got_list)
@@ -5598,6 +5890,13 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
   { "memory-tagging", PACKET_DISABLE, remote_supported_packet,
     PACKET_memory_tagging_feature },
+  { "binary-upload", PACKET_DISABLE, remote_supported_packet, PACKET_x },
+  { "thread-registers", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qThreadRegisters },
+  { "binary-trace-buffer", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qTBufferBin },
+  { "vstopped-batch", PACKET_DISABLE, remote_supported_packet,
+    PACKET_vstopped_batch_feature },
 };
 
 static char *remote_support_xml;
@@ -5705,6 +6004,10 @@ remote_target::remote_query_supported ()
 	  != AUTO_BOOLEAN_FALSE)
 	remote_query_supported_append (&q, "memory-tagging+");
 
+      if (m_features.packet_set_cmd_state (PACKET_vstopped_batch_feature)
+	  != AUTO_BOOLEAN_FALSE)
+	remote_query_supported_append (&q, "vstopped-batch+");
+
       /* Keep this one last to work around a gdbserver <= 7.10 bug in
 	 the qSupported:xmlRegisters=i386 handling.  */
       if (remote_support_xml != NULL
@@ -7105,115 +7408,165 @@ remote_target::has_pending_events ()
 
 void
 remote_target::remote_stop_ns (ptid_t ptid)
+{
+  remote_stop_ns_batch (gdb::make_array_view (&ptid, 1));
+}
+
+/* Batch version of remote_stop_ns.  Stops all the threads matched by
+   the ptids in PTIDS, packing as many `t' actions as fit into each
+   vCont packet, so that stopping N threads costs a handful of round
+   trips to the stub instead of N.  */
+
+void
+remote_target::remote_stop_ns_batch (gdb::array_view<const ptid_t> ptids)
 {
   struct remote_state *rs = get_remote_state ();
-  char *p = rs->buf.data ();
-  char *endp = p + get_remote_packet_size ();
 
   /* If any thread that needs to stop was resumed but pending a vCont
      resume, generate a phony stop_reply.  However, first check
-     whether the thread wasn't resumed with a signal.  Generating a
+     whether any thread was resumed with a signal.  Generating a
      phony stop in that case would result in losing the signal.  */
   bool needs_commit = false;
-  for (thread_info *tp : all_non_exited_threads (this, ptid))
+  for (const ptid_t &ptid : ptids)
     {
-      remote_thread_info *remote_thr = get_remote_thread_info (tp);
-
-      if (remote_thr->get_resume_state ()
-	  == resume_state::RESUMED_PENDING_VCONT)
+      for (thread_info *tp : all_non_exited_threads (this, ptid))
 	{
-	  const resumed_pending_vcont_info &info
-	    = remote_thr->resumed_pending_vcont_info ();
-	  if (info.sig != GDB_SIGNAL_0)
+	  remote_thread_info *remote_thr = get_remote_thread_info (tp);
+
+	  if (remote_thr->get_resume_state ()
+	      == resume_state::RESUMED_PENDING_VCONT)
 	    {
-	      /* This signal must be forwarded to the inferior.  We
-		 could commit-resume just this thread, but its simpler
-		 to just commit-resume everything.  */
-	      needs_commit = true;
-	      break;
+	      const resumed_pending_vcont_info &info
+		= remote_thr->resumed_pending_vcont_info ();
+	      if (info.sig != GDB_SIGNAL_0)
+		{
+		  /* This signal must be forwarded to the inferior.  We
+		     could commit-resume just this thread, but its simpler
+		     to just commit-resume everything.  */
+		  needs_commit = true;
+		  break;
+		}
 	    }
 	}
+
+      if (needs_commit)
+	break;
     }
 
   if (needs_commit)
     commit_resumed ();
   else
-    for (thread_info *tp : all_non_exited_threads (this, ptid))
-      {
-	remote_thread_info *remote_thr = get_remote_thread_info (tp);
+    for (const ptid_t &ptid : ptids)
+      for (thread_info *tp : all_non_exited_threads (this, ptid))
+	{
+	  remote_thread_info *remote_thr = get_remote_thread_info (tp);
 
-	if (remote_thr->get_resume_state ()
-	    == resume_state::RESUMED_PENDING_VCONT)
-	  {
-	    remote_debug_printf ("Enqueueing phony stop reply for thread pending "
-				 "vCont-resume (%d, %ld, %s)", tp->ptid.pid(),
-				 tp->ptid.lwp (),
-				 pulongest (tp->ptid.tid ()));
-
-	    /* Check that the thread wasn't resumed with a signal.
-	       Generating a phony stop would result in losing the
-	       signal.  */
-	    const resumed_pending_vcont_info &info
-	      = remote_thr->resumed_pending_vcont_info ();
-	    gdb_assert (info.sig == GDB_SIGNAL_0);
-
-	    stop_reply *sr = new stop_reply ();
-	    sr->ptid = tp->ptid;
-	    sr->rs = rs;
-	    sr->ws.set_stopped (GDB_SIGNAL_0);
-	    sr->arch = tp->inf->gdbarch;
-	    sr->stop_reason = TARGET_STOPPED_BY_NO_REASON;
-	    sr->watch_data_address = 0;
-	    sr->core = 0;
-	    this->push_stop_reply (sr);
-
-	    /* Pretend that this thread was actually resumed on the
-	       remote target, then stopped.  If we leave it in the
-	       RESUMED_PENDING_VCONT state and the commit_resumed
-	       method is called while the stop reply is still in the
-	       queue, we'll end up reporting a stop event to the core
-	       for that thread while it is running on the remote
-	       target... that would be bad.  */
-	    remote_thr->set_resumed ();
-	  }
-      }
+	  if (remote_thr->get_resume_state ()
+	      == resume_state::RESUMED_PENDING_VCONT)
+	    {
+	      remote_debug_printf ("Enqueueing phony stop reply for thread pending "
+				   "vCont-resume (%d, %ld, %s)", tp->ptid.pid(),
+				   tp->ptid.lwp (),
+				   pulongest (tp->ptid.tid ()));
+
+	      /* Check that the thread wasn't resumed with a signal.
+		 Generating a phony stop would result in losing the
+		 signal.  */
+	      const resumed_pending_vcont_info &info
+		= remote_thr->resumed_pending_vcont_info ();
+	      gdb_assert (info.sig == GDB_SIGNAL_0);
+
+	      stop_reply *sr = new stop_reply ();
+	      sr->ptid = tp->ptid;
+	      sr->rs = rs;
+	      sr->ws.set_stopped (GDB_SIGNAL_0);
+	      sr->arch = tp->inf->gdbarch;
+	      sr->stop_reason = TARGET_STOPPED_BY_NO_REASON;
+	      sr->watch_data_address = 0;
+	      sr->core = 0;
+	      this->push_stop_reply (sr);
+
+	      /* Pretend that this thread was actually resumed on the
+		 remote target, then stopped.  If we leave it in the
+		 RESUMED_PENDING_VCONT state and the commit_resumed
+		 method is called while the stop reply is still in the
+		 queue, we'll end up reporting a stop event to the core
+		 for that thread while it is running on the remote
+		 target... that would be bad.  */
+	      remote_thr->set_resumed ();
+	    }
+	}
 
   if (!rs->supports_vCont.t)
     error (_("Remote server does not support stopping threads"));
 
-  if (ptid == minus_one_ptid
-      || (!m_features.remote_multi_process_p () && ptid.is_pid ()))
-    p += xsnprintf (p, endp - p, "vCont;t");
-  else
+  char *p = rs->buf.data ();
+  char *endp = p + get_remote_packet_size ();
+  p += xsnprintf (p, endp - p, "vCont");
+  int nactions = 0;
+
+  /* Send the packet built up in rs->buf so far.  In non-stop, we get
+     an immediate OK reply.  The stop replies will come in
+     asynchronously by notification.  */
+  auto send_packet = [&] ()
     {
-      ptid_t nptid;
+      putpkt (rs->buf);
+      getpkt (&rs->buf);
+      if (strcmp (rs->buf.data (), "OK") != 0)
+	error (_("Stopping threads failed: %s"), rs->buf.data ());
 
-      p += xsnprintf (p, endp - p, "vCont;t:");
+      p = rs->buf.data ();
+      endp = p + get_remote_packet_size ();
+      p += xsnprintf (p, endp - p, "vCont");
+      nactions = 0;
+    };
 
-      if (ptid.is_pid ())
-	  /* All (-1) threads of process.  */
-	nptid = ptid_t (ptid.pid (), -1);
+  for (const ptid_t &ptid : ptids)
+    {
+      char action[64];
+      char *q = action;
+      char *action_endp = action + sizeof (action);
+
+      if (ptid == minus_one_ptid
+	  || (!m_features.remote_multi_process_p () && ptid.is_pid ()))
+	q += xsnprintf (q, action_endp - q, ";t");
       else
 	{
-	  /* Small optimization: if we already have a stop reply for
-	     this thread, no use in telling the stub we want this
-	     stopped.  */
-	  if (peek_stop_reply (ptid))
-	    return;
+	  ptid_t nptid;
 
-	  nptid = ptid;
+	  q += xsnprintf (q, action_endp - q, ";t:");
+
+	  if (ptid.is_pid ())
+	    /* All (-1) threads of process.  */
+	    nptid = ptid_t (ptid.pid (), -1);
+	  else
+	    {
+	      /* Small optimization: if we already have a stop reply for
+		 this thread, no use in telling the stub we want this
+		 stopped.  */
+	      if (peek_stop_reply (ptid))
+		continue;
+
+	      nptid = ptid;
+	    }
+
+	  q = write_ptid (q, action_endp, nptid);
 	}
 
-      write_ptid (p, endp, nptid);
+      /* Flush the packet if this action (and the terminating null)
+	 would overflow it.  */
+      size_t len = q - action;
+      if (p + len >= endp && nactions > 0)
+	send_packet ();
+
+      memcpy (p, action, len);
+      p += len;
+      *p = '\0';
+      nactions++;
     }
 
-  /* In non-stop, we get an immediate OK reply.  The stop reply will
-     come in asynchronously by notification.  */
-  putpkt (rs->buf);
-  getpkt (&rs->buf);
-  if (strcmp (rs->buf.data (), "OK") != 0)
-    error (_("Stopping %s failed: %s"), target_pid_to_str (ptid).c_str (),
-	   rs->buf.data ());
+  if (nactions > 0)
+    send_packet ();
 }
 
 /* All-stop version of target_interrupt.  Sends a break or a ^C to
@@ -7284,6 +7637,25 @@ remote_target::stop (ptid_t ptid)
     }
 }
 
+/* Implement the to_stop_threads function for the remote targets.  */
+
+void
+remote_target::stop_threads (gdb::array_view<const ptid_t> ptids)
+{
+  REMOTE_SCOPED_DEBUG_ENTER_EXIT;
+
+  if (target_is_non_stop_p ())
+    remote_stop_ns_batch (ptids);
+  else
+    {
+      /* We don't currently have a way to transparently pause the
+	 remote target in all-stop mode.  Interrupt it instead.  It is
+	 undefined which thread reports the interrupt, so one request
+	 covers the whole batch.  */
+      remote_interrupt_as ();
+    }
+}
+
 /* Implement the to_interrupt function for the remote targets.  */
 
 void
@@ -8087,8 +8459,35 @@ remote_target::remote_notif_get_pending_events (const notif_client *nc)
 	  getpkt (&rs->buf);
 	  if (strcmp (rs->buf.data (), "OK") == 0)
 	    break;
-	  else
-	    remote_notif_ack (this, nc, rs->buf.data ());
+
+	  char *p = rs->buf.data ();
+
+	  /* With the vstopped-batch feature, one reply may carry
+	     several stop replies, separated by '|'.  All but the
+	     last are parsed and pushed directly; the last one goes
+	     through the regular ack path, which continues the
+	     sequence with another ack packet.  */
+	  if (nc == &notif_client_stop)
+	    {
+	      char *bar;
+
+	      while ((bar = strchr (p, '|')) != NULL)
+		{
+		  *bar = '\0';
+
+		  struct stop_reply *stop_reply
+		    = (struct stop_reply *) remote_notif_parse (this, nc, p);
+
+		  if (stop_reply->ws.kind () != TARGET_WAITKIND_IGNORE)
+		    push_stop_reply (stop_reply);
+		  else
+		    delete stop_reply;
+
+		  p = bar + 1;
+		}
+	    }
+
+	  remote_notif_ack (this, nc, p);
 	}
     }
   else
@@ -8638,23 +9037,28 @@ remote_target::send_g_packet ()
 }
 
 void
-remote_target::process_g_packet (struct regcache *regcache)
+remote_target::process_g_packet (struct regcache *regcache,
+				 const char *g_data)
 {
   struct gdbarch *gdbarch = regcache->arch ();
   struct remote_state *rs = get_remote_state ();
   remote_arch_state *rsa = rs->get_remote_arch_state (gdbarch);
   int i, buf_len;
-  char *p;
+  const char *p;
   char *regs;
 
-  buf_len = strlen (rs->buf.data ());
+  /* By default, parse the reply in the packet buffer; a batched
+     fetch passes the per-thread data explicitly.  */
+  if (g_data == nullptr)
+    g_data = rs->buf.data ();
+
+  buf_len = strlen (g_data);
 
   /* Further sanity checks, with knowledge of the architecture.  */
   if (buf_len > 2 * rsa->sizeof_g_packet)
     error (_("Remote 'g' packet reply is too long (expected %ld bytes, got %d "
 	     "bytes): %s"),
-	   rsa->sizeof_g_packet, buf_len / 2,
-	   rs->buf.data ());
+	   rsa->sizeof_g_packet, buf_len / 2, g_data);
 
   /* Save the size of the packet sent to us by the target.  It is used
      as a heuristic when determining the max size of packets that the
@@ -8704,7 +9108,7 @@ remote_target::process_g_packet (struct regcache *regcache)
      hex characters.  Suck them all up, then supply them to the
      register cacheing/storage mechanism.  */
 
-  p = rs->buf.data ();
+  p = g_data;
   for (i = 0; i < rsa->sizeof_g_packet; i++)
     {
       if (p[0] == 0 || p[1] == 0)
@@ -8725,12 +9129,12 @@ remote_target::process_g_packet (struct regcache *regcache)
 
       if (r->in_g_packet)
 	{
-	  if ((r->offset + reg_size) * 2 > strlen (rs->buf.data ()))
+	  if ((r->offset + reg_size) * 2 > buf_len)
 	    /* This shouldn't happen - we adjusted in_g_packet above.  */
 	    internal_error (_("unexpected end of 'g' packet reply"));
-	  else if (rs->buf[r->offset * 2] == 'x')
+	  else if (g_data[r->offset * 2] == 'x')
 	    {
-	      gdb_assert (r->offset * 2 < strlen (rs->buf.data ()));
+	      gdb_assert (r->offset * 2 < buf_len);
 	      /* The register isn't available, mark it as such (at
 		 the same time setting the value to zero).  */
 	      regcache->raw_supply (r->regnum, NULL);
@@ -8741,9 +9145,129 @@ remote_target::process_g_packet (struct regcache *regcache)
     }
 }
 
+/* Fetch the registers of several stopped threads in one round trip,
+   using the qThreadRegisters packet.  REGCACHE's thread is batched
+   together with other same-process threads whose registers have not
+   been fetched yet, up to what fits in one packet; the extra replies
+   are supplied straight into those threads' register caches, so their
+   later fetches are free.  Returns false if the packet is unsupported
+   or not worthwhile, in which case the caller falls back to 'g'.  */
+
+bool
+remote_target::fetch_registers_batched (struct regcache *regcache)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (m_features.packet_support (PACKET_qThreadRegisters) != PACKET_ENABLE)
+    return false;
+
+  /* In non-stop mode other threads may be running, and their
+     registers can't be read.  */
+  if (target_is_non_stop_p ())
+    return false;
+
+  struct gdbarch *gdbarch = regcache->arch ();
+  remote_arch_state *rsa = rs->get_remote_arch_state (gdbarch);
+
+  /* Estimate how many per-thread replies fit in one packet: the 'g'
+     data plus a thread id and separators.  */
+  long per_thread = 2 * rsa->sizeof_g_packet + 32;
+  long max_threads = ((long) get_remote_packet_size () - 32) / per_thread;
+  if (max_threads < 2)
+    return false;
+
+  /* Find the first register carried by the 'g' packet; its cache
+     status tells whether a thread's registers were already
+     fetched.  */
+  int probe_regnum = -1;
+  for (int i = 0; i < gdbarch_num_regs (gdbarch); i++)
+    if (rsa->regs[i].in_g_packet)
+      {
+	probe_regnum = rsa->regs[i].regnum;
+	break;
+      }
+  if (probe_regnum == -1)
+    return false;
+
+  ptid_t req_ptid = regcache->ptid ();
+  std::vector<ptid_t> ptids;
+  ptids.push_back (req_ptid);
+  for (thread_info *tp : all_non_exited_threads (this))
+    {
+      if ((long) ptids.size () >= max_threads)
+	break;
+      if (tp->ptid == req_ptid || tp->ptid.pid () != req_ptid.pid ())
+	continue;
+
+      struct regcache *other
+	= get_thread_arch_regcache (this, tp->ptid, gdbarch);
+      if (other->get_register_status (probe_regnum) != REG_UNKNOWN)
+	continue;
+
+      ptids.push_back (tp->ptid);
+    }
+
+  /* A single thread gains nothing over a plain 'g' packet.  */
+  if (ptids.size () < 2)
+    return false;
+
+  /* Build and send "qThreadRegisters:ptid,ptid,...".  */
+  char *p = rs->buf.data ();
+  char *endp = p + get_remote_packet_size ();
+  strcpy (p, "qThreadRegisters:");
+  p += strlen (p);
+  for (size_t ix = 0; ix < ptids.size (); ix++)
+    {
+      if (ix > 0)
+	*p++ = ',';
+      p = write_ptid (p, endp, ptids[ix]);
+    }
+  *p = '\0';
+
+  putpkt (rs->buf);
+  getpkt (&rs->buf);
+  if (rs->buf[0] == '\0' || rs->buf[0] == 'E')
+    return false;
+
+  /* The reply is a series of "ptid=g-data" entries separated by
+     semicolons; threads the stub could not read are omitted.  */
+  bool req_supplied = false;
+  char *entry = rs->buf.data ();
+  while (*entry != '\0')
+    {
+      char *next = strchr (entry, ';');
+      if (next != nullptr)
+	*next++ = '\0';
+
+      const char *rest;
+      ptid_t ptid = read_ptid (entry, &rest);
+      if (*rest != '=')
+	error (_("Malformed qThreadRegisters reply: %s"), entry);
+      const char *g_data = rest + 1;
+
+      if (ptid == req_ptid)
+	{
+	  process_g_packet (regcache, g_data);
+	  req_supplied = true;
+	}
+      else if (this->find_thread (ptid) != nullptr)
+	process_g_packet (get_thread_arch_regcache (this, ptid, gdbarch),
+			  g_data);
+
+      if (next == nullptr)
+	break;
+      entry = next;
+    }
+
+  return req_supplied;
+}
+
 void
 remote_target::fetch_registers_using_g (struct regcache *regcache)
 {
+  if (fetch_registers_batched (regcache))
+    return;
+
   send_g_packet ();
   process_g_packet (regcache);
 }
@@ -9353,32 +9877,56 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   int todo_units;
   int decoded_bytes;
 
+  /* Binary memory reads ('x' packets) carry one byte per memory
+     byte, rather than two hex characters, so twice as many units fit
+     in a packet.  The packet is only used when the stub advertised
+     the "binary-upload" feature.  */
+  bool use_binary = m_features.packet_support (PACKET_x) == PACKET_ENABLE;
+
   buf_size_bytes = get_memory_read_packet_size ();
   /* The packet buffer will be large enough for the payload;
      get_memory_packet_size ensures this.  */
 
   /* Number of units that will fit.  */
-  todo_units = std::min (len_units,
-			 (ULONGEST) (buf_size_bytes / unit_size) / 2);
+  if (use_binary)
+    todo_units = std::min (len_units, (ULONGEST) buf_size_bytes / unit_size);
+  else
+    todo_units = std::min (len_units,
+			   (ULONGEST) (buf_size_bytes / unit_size) / 2);
 
-  /* Construct "m"<memaddr>","<len>".  */
+  /* Construct "m"<memaddr>","<len>" (or the 'x' equivalent).  */
   memaddr = remote_address_masked (memaddr);
   p = rs->buf.data ();
-  *p++ = 'm';
+  *p++ = use_binary ? 'x' : 'm';
   p += hexnumstr (p, (ULONGEST) memaddr);
   *p++ = ',';
   p += hexnumstr (p, (ULONGEST) todo_units);
   *p = '\0';
   putpkt (rs->buf);
-  getpkt (&rs->buf);
+  int packet_len = getpkt (&rs->buf);
+  if (packet_len < 0)
+    return TARGET_XFER_E_IO;
   if (rs->buf[0] == 'E'
       && isxdigit (rs->buf[1]) && isxdigit (rs->buf[2])
       && rs->buf[3] == '\0')
     return TARGET_XFER_E_IO;
-  /* Reply describes memory byte by byte, each byte encoded as two hex
-     characters.  */
-  p = rs->buf.data ();
-  decoded_bytes = hex2bin (p, myaddr, todo_units * unit_size);
+  if (use_binary)
+    {
+      /* Reply is "b" followed by the escaped binary data.  */
+      if (rs->buf[0] != 'b')
+	error (_("Unknown remote x reply: %s"), rs->buf.data ());
+      decoded_bytes
+	= remote_unescape_input ((const gdb_byte *) rs->buf.data () + 1,
+				 packet_len - 1, myaddr,
+				 todo_units * unit_size);
+    }
+  else
+    {
+      /* Reply describes memory byte by byte, each byte encoded as two
+	 hex characters.  */
+      p = rs->buf.data ();
+      decoded_bytes = hex2bin (p, myaddr, todo_units * unit_size);
+    }
   /* Return what we have.  Let higher layers handle partial reads.  */
   *xfered_len_units = (ULONGEST) (decoded_bytes / unit_size);
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
@@ -9719,8 +10267,12 @@ remote_target::putpkt_binary (const char *buf, int cnt)
   struct remote_state *rs = get_remote_state ();
   int i;
   unsigned char csum = 0;
-  gdb::def_vector<char> data (cnt + 6);
-  char *buf2 = data.data ();
+
+  scoped_command_time time_category (COMMAND_TIME_TARGET_IO);
+
+  if (rs->framing_buf.size () < (size_t) cnt + 6)
+    rs->framing_buf.resize ((size_t) cnt + 6);
+  char *buf2 = rs->framing_buf.data ();
 
   int ch;
   int tcount = 0;
@@ -9742,6 +10294,12 @@ remote_target::putpkt_binary (const char *buf, int cnt)
 	       "and then try again."));
     }
 
+  /* If breakpoint insertions are being pipelined, their replies must
+     be collected before an unrelated packet goes out, as the stub
+     replies strictly in request order.  */
+  if (!rs->pending_z0_inserts.empty () && !rs->sending_pipelined_z0)
+    flush_pending_breakpoint_inserts ();
+
   /* Copy the packet into buffer BUF2, encapsulating it
      and giving it a checksum.  */
 
@@ -9757,6 +10315,25 @@ remote_target::putpkt_binary (const char *buf, int cnt)
   *p++ = tohex ((csum >> 4) & 0xf);
   *p++ = tohex (csum & 0xf);
 
+  rs->packets_sent++;
+  command_stats_count_target_io (p - buf2, true);
+
+  /* Account the packet to the executing command for "maint info
+     packet-stats", and remember it so that getpkt can match up the
+     reply.  */
+  rs->pending_stats_packet = packet_stats_name (buf, cnt);
+  rs->pending_stats_command
+    = (maint_current_command () != nullptr
+       ? maint_current_command () : "(event loop)");
+  rs->pending_stats_send_time = std::chrono::steady_clock::now ();
+
+  {
+    packet_stat &stat = (packet_stats_table[rs->pending_stats_command]
+			 [rs->pending_stats_packet]);
+    stat.count++;
+    stat.bytes_sent += cnt;
+  }
+
   /* Send it over and over until we get a positive ack.  */
 
   while (1)
@@ -10061,6 +10638,8 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
   int timeout;
   int val = -1;
 
+  scoped_command_time time_category (COMMAND_TIME_TARGET_IO);
+
   strcpy (buf->data (), "timeout");
 
   if (forever)
@@ -10137,6 +10716,35 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
       /* If we got an ordinary packet, return that to our caller.  */
       if (c == '$')
 	{
+	  rs->packets_received++;
+	  command_stats_count_target_io (val, false);
+
+	  /* Fold the reply into the packet-stats entry of the packet
+	     it answers.  */
+	  if (!rs->pending_stats_packet.empty ())
+	    {
+	      packet_stat &stat
+		= (packet_stats_table[rs->pending_stats_command]
+		   [rs->pending_stats_packet]);
+	      stat.bytes_received += val;
+
+	      std::chrono::steady_clock::duration latency
+		= std::chrono::steady_clock::now ()
+		  - rs->pending_stats_send_time;
+	      stat.total_latency += latency;
+
+	      ULONGEST usec
+		= (std::chrono::duration_cast<std::chrono::microseconds>
+		   (latency).count ());
+	      int bucket = 0;
+	      for (ULONGEST limit = 100; bucket < 4 && usec >= limit;
+		   limit *= 10)
+		bucket++;
+	      stat.latency[bucket]++;
+
+	      rs->pending_stats_packet.clear ();
+	    }
+
 	  if (remote_debug)
 	    {
 	      int max_chars;
@@ -10173,6 +10781,9 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
 	{
 	  gdb_assert (c == '%');
 
+	  rs->packets_received++;
+	  command_stats_count_target_io (val, false);
+
 	  remote_debug_printf_nofunc
 	    ("  Notification received: %s",
 	     escape_buffer (buf->data (), val).c_str ());
@@ -10729,6 +11340,22 @@ remote_target::insert_breakpoint (struct gdbarch *gdbarch,
       if (can_run_breakpoint_commands ())
 	remote_add_target_side_commands (gdbarch, bp_tgt, p);
 
+      if (rs->z0_batching)
+	{
+	  /* Pipelined mode: send the packet without waiting for the
+	     reply, and optimistically report success.  The replies are
+	     matched to the requests, in order, when the batch is
+	     finished (or when another packet has to go out), and a
+	     failure noticed then is flagged in BP_TGT.  */
+	  bp_tgt->pipelined_insert_failed = 0;
+
+	  scoped_restore restore_sending
+	    = make_scoped_restore (&rs->sending_pipelined_z0, true);
+	  putpkt (rs->buf);
+	  rs->pending_z0_inserts.push_back (bp_tgt);
+	  return 0;
+	}
+
       putpkt (rs->buf);
       getpkt (&rs->buf);
 
@@ -10787,6 +11414,76 @@ remote_target::remove_breakpoint (struct gdbarch *gdbarch,
   return memory_remove_breakpoint (this, gdbarch, bp_tgt, reason);
 }
 
+/* Read the replies for all pipelined Z0 insertion packets that are
+   still in flight, in sending order, flagging failed insertions in
+   their bp_target_info.  */
+
+void
+remote_target::flush_pending_breakpoint_inserts ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (rs->pending_z0_inserts.empty ())
+    return;
+
+  /* Steal the queue up front: getpkt can throw, and the replies of a
+     dead connection are never going to arrive.  */
+  std::vector<struct bp_target_info *> pending
+    = std::move (rs->pending_z0_inserts);
+  rs->pending_z0_inserts.clear ();
+
+  /* Use a separate buffer; the caller may be in the middle of sending
+     a packet held in RS->buf.  */
+  gdb::char_vector reply (get_remote_packet_size ());
+
+  for (size_t i = 0; i < pending.size (); i++)
+    {
+      try
+	{
+	  getpkt (&reply);
+	}
+      catch (const gdb_exception &)
+	{
+	  /* Assume the insertions whose replies never arrived
+	     failed.  */
+	  for (size_t j = i; j < pending.size (); j++)
+	    pending[j]->pipelined_insert_failed = 1;
+	  throw;
+	}
+
+      if (m_features.packet_ok (reply, PACKET_Z0) != PACKET_OK)
+	pending[i]->pipelined_insert_failed = 1;
+    }
+}
+
+/* Implement the "breakpoint_batch_begin" target_ops method.  */
+
+void
+remote_target::breakpoint_batch_begin ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  /* Only pipeline insertions once Z0 support has been confirmed, so
+     that the probing logic in insert_breakpoint still sees its reply
+     synchronously.  Also require no-ack mode: with acknowledgments
+     enabled, the ack handling in putpkt_binary would treat a pending
+     reply as a duplicate response and discard it.  */
+  if (rs->noack_mode
+      && m_features.packet_support (PACKET_Z0) == PACKET_ENABLE)
+    rs->z0_batching = true;
+}
+
+/* Implement the "breakpoint_batch_done" target_ops method.  */
+
+void
+remote_target::breakpoint_batch_done ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  rs->z0_batching = false;
+  flush_pending_breakpoint_inserts ();
+}
+
 static enum Z_packet_type
 watchpoint_to_Z_packet (int type)
 {
@@ -12384,7 +13081,8 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
 void
 readahead_cache::invalidate ()
 {
-  this->fd = -1;
+  for (readahead_cache_block &block : this->blocks)
+    block.fd = -1;
 }
 
 /* See declaration.h.  */
@@ -12392,8 +13090,9 @@ readahead_cache::invalidate ()
 void
 readahead_cache::invalidate_fd (int fd)
 {
-  if (this->fd == fd)
-    this->fd = -1;
+  for (readahead_cache_block &block : this->blocks)
+    if (block.fd == fd)
+      block.fd = -1;
 }
 
 /* Set the filesystem remote_hostio functions that take FILENAME
@@ -12569,22 +13268,42 @@ int
 readahead_cache::pread (int fd, gdb_byte *read_buf, size_t len,
 			ULONGEST offset)
 {
-  if (this->fd == fd
-      && this->offset <= offset
-      && offset < this->offset + this->buf.size ())
-    {
-      ULONGEST max = this->offset + this->buf.size ();
+  for (readahead_cache_block &block : this->blocks)
+    if (block.fd == fd
+	&& block.offset <= offset
+	&& offset < block.offset + block.buf.size ())
+      {
+	ULONGEST max = block.offset + block.buf.size ();
 
-      if (offset + len > max)
-	len = max - offset;
+	if (offset + len > max)
+	  len = max - offset;
 
-      memcpy (read_buf, &this->buf[offset - this->offset], len);
-      return len;
-    }
+	memcpy (read_buf, &block.buf[offset - block.offset], len);
+	block.last_used = ++this->tick;
+	return len;
+      }
 
   return 0;
 }
 
+/* See declaration.h.  */
+
+readahead_cache_block *
+readahead_cache::block_to_fill ()
+{
+  readahead_cache_block *lru = &this->blocks[0];
+
+  for (readahead_cache_block &block : this->blocks)
+    {
+      if (block.fd == -1)
+	return &block;
+      if (block.last_used < lru->last_used)
+	lru = &block;
+    }
+
+  return lru;
+}
+
 /* Implementation of to_fileio_pread.  */
 
 int
@@ -12610,20 +13329,22 @@ remote_target::remote_hostio_pread (int fd, gdb_byte *read_buf, int len,
   remote_debug_printf ("readahead cache miss %s",
 		       pulongest (cache->miss_count));
 
-  cache->fd = fd;
-  cache->offset = offset;
-  cache->buf.resize (get_remote_packet_size ());
+  readahead_cache_block *block = cache->block_to_fill ();
+  block->fd = fd;
+  block->offset = offset;
+  block->buf.resize (get_remote_packet_size ());
+  block->last_used = ++cache->tick;
 
-  ret = remote_hostio_pread_vFile (cache->fd, &cache->buf[0],
-				   cache->buf.size (),
-				   cache->offset, remote_errno);
+  ret = remote_hostio_pread_vFile (block->fd, &block->buf[0],
+				   block->buf.size (),
+				   block->offset, remote_errno);
   if (ret <= 0)
     {
-      cache->invalidate_fd (fd);
+      block->fd = -1;
       return ret;
     }
 
-  cache->buf.resize (ret);
+  block->buf.resize (ret);
   return cache->pread (fd, read_buf, len, offset);
 }
 
@@ -13874,6 +14595,38 @@ remote_target::get_raw_trace_data (gdb_byte *buf, ULONGEST offset, LONGEST len)
   char *p;
   int rslt;
 
+  if (m_features.packet_support (PACKET_qTBufferBin) == PACKET_ENABLE)
+    {
+      /* The stub can send the data as escaped binary, which halves
+	 the transfer size compared to hex.  */
+      p = rs->buf.data ();
+      strcpy (p, "qTBufferBin:");
+      p += strlen (p);
+      p += hexnumstr (p, offset);
+      *p++ = ',';
+      p += hexnumstr (p, len);
+      *p++ = '\0';
+
+      putpkt (rs->buf);
+      int packet_len = getpkt (&rs->buf);
+      if (packet_len < 0)
+	return -1;
+
+      reply = rs->buf.data ();
+
+      /* 'l' by itself means we're at the end of the buffer and
+	 there is nothing more to get.  */
+      if (reply[0] == 'l' && packet_len == 1)
+	return 0;
+
+      if (reply[0] == 'b')
+	return remote_unescape_input ((const gdb_byte *) reply + 1,
+				      packet_len - 1, buf, len);
+
+      /* Something went wrong, flag as an error.  */
+      return -1;
+    }
+
   p = rs->buf.data ();
   strcpy (p, "qTBuffer:");
   p += strlen (p);
@@ -15376,6 +16129,18 @@ response packet.  GDB supplies the initial `$' character, and the\n\
 terminating `#' character and checksum."),
 	   &maintenancelist);
 
+  add_cmd ("packet-stats", class_maintenance,
+	   maintenance_info_packet_stats, _("\
+Show remote protocol traffic broken down by command and packet type.\n\
+Usage: maintenance info packet-stats [FILTER]\n\
+For each command that has sent remote protocol packets, print per\n\
+packet type the number of packets sent, the payload bytes sent and\n\
+received, and a round-trip latency histogram.  This accounting is\n\
+always on and, unlike \"set debug remote\", aggregates rather than\n\
+logs, so it stays usable on packet-heavy sessions.  With an argument,\n\
+print only the commands whose line contains FILTER."),
+	   &maintenanceinfolist);
+
   set_show_commands remotebreak_cmds
     = add_setshow_boolean_cmd ("remotebreak", no_class, &remote_break, _("\
 Set whether to send break if interrupted."), _("\
@@ -15473,6 +16238,18 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
 
   add_packet_config_cmd (PACKET_X, "X", "binary-download", 1);
 
+  add_packet_config_cmd (PACKET_x, "x", "binary-upload", 0);
+
+  add_packet_config_cmd (PACKET_qThreadRegisters, "qThreadRegisters",
+			 "thread-registers", 0);
+
+  add_packet_config_cmd (PACKET_qTBufferBin, "qTBufferBin",
+			 "binary-trace-buffer", 0);
+
+  add_packet_config_cmd (PACKET_vstopped_batch_feature,
+			 "vstopped-batch-feature",
+			 "vstopped-batch-feature", 0);
+
   add_packet_config_cmd (PACKET_vCont, "vCont", "verbose-resume", 0);
 
   add_packet_config_cmd (PACKET_QPassSignals, "QPassSignals", "pass-signals",
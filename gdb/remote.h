@@ -121,4 +121,10 @@ extern void send_remote_packet (gdb::array_view<const char> &buf,
 
 extern bool is_remote_target (process_stratum_target *target);
 
+/* Print packet counts for every live remote connection to STREAM, for
+   "maint info io-stats".  Prints nothing if no remote target is
+   connected.  */
+
+extern void remote_print_io_stats (struct ui_file *stream);
+
 #endif
@@ -53,6 +53,13 @@
 
 bool debug_solib;
 
+/* If true, symbols are not read when a shared library is loaded;
+   instead each library's symbols are read the first time an address
+   inside it is looked up (see solib_read_symbols_for_address).  This
+   makes attaching to a process with very many shared libraries
+   return to the prompt much faster.  */
+static bool solib_defer_symbol_loading = false;
+
 /* If non-empty, this is a search path for loading non-absolute shared library
    symbol files.  This takes precedence over the environment variables PATH
    and LD_LIBRARY_PATH.  */
@@ -739,6 +746,30 @@ solib_read_symbols (struct so_list *so, symfile_add_flags flags)
   return false;
 }
 
+/* Ask the kernel to start reading the files backing the shared
+   libraries in SOS into the page cache.  Symbol reading itself is
+   strictly serial across libraries -- objfile creation mutates global
+   state and BFD is not thread-safe -- but it is internally threaded
+   and fault-driven, so when many libraries arrive in one burst the
+   readahead issued here overlaps the disk I/O for the later
+   libraries with the scanning of the earlier ones.  This is advice
+   only; any failure is ignored.  */
+
+static void
+solib_prefetch_files (const std::vector<struct so_list *> &sos)
+{
+#ifdef POSIX_FADV_WILLNEED
+  for (const struct so_list *so : sos)
+    {
+      scoped_fd fd (gdb_open_cloexec (bfd_get_filename (so->abfd),
+				      O_RDONLY, 0));
+
+      if (fd.get () >= 0)
+	posix_fadvise (fd.get (), 0, 0, POSIX_FADV_WILLNEED);
+    }
+#endif
+}
+
 /* Return true if KNOWN->objfile is used by any other so_list object
    in the list of shared libraries.  Return false otherwise.  */
 
@@ -1018,11 +1049,58 @@ solib_add (const char *pattern, int from_tty, int readsyms)
   {
     bool any_matches = false;
     bool loaded_any_symbols = false;
+    std::vector<struct objfile *> new_objfiles;
     symfile_add_flags add_flags = SYMFILE_DEFER_BP_RESET;
 
     if (from_tty)
 	add_flags |= SYMFILE_VERBOSE;
 
+    /* When more than one library is about to be read, prime the page
+       cache for all of them up front, so reading the first overlaps
+       with the disk I/O for the rest.  Likewise, start downloading
+       any debug info those libraries will need from debuginfod in the
+       background, so the downloads overlap with the symbol reading of
+       the libraries that have already arrived.  */
+    {
+      std::vector<struct so_list *> pending;
+      std::vector<gdb::byte_vector> debug_ids;
+
+      for (struct so_list *gdb : current_program_space->solibs ())
+	if ((!pattern || re_exec (gdb->so_name))
+	    && ((readsyms
+		 && (pattern != NULL || from_tty
+		     || !solib_defer_symbol_loading))
+		|| libpthread_solib_p (gdb))
+	    && !gdb->symbols_loaded
+	    && gdb->abfd != NULL)
+	  {
+	    pending.push_back (gdb);
+
+	    /* Mirror the conditions under which symbol reading would
+	       query debuginfod: the library has no debug info of its
+	       own, no separate debug file is installed for its build
+	       id, but it does have one.  The build id bytes are copied
+	       because the downloads may outlive this solib.  */
+	    if (bfd_get_section_by_name (gdb->abfd, ".debug_info") == NULL)
+	      {
+		const struct bfd_build_id *build_id
+		  = build_id_bfd_get (gdb->abfd);
+
+		if (build_id != nullptr
+		    && (build_id_to_debug_bfd (build_id->size,
+					       build_id->data)
+			== nullptr))
+		  debug_ids.emplace_back (build_id->data,
+					  build_id->data + build_id->size);
+	      }
+	  }
+
+      if (pending.size () > 1)
+	solib_prefetch_files (pending);
+      if (debug_ids.size () > 1)
+	debuginfod_debuginfo_prefetch (std::move (debug_ids));
+    }
+
     for (struct so_list *gdb : current_program_space->solibs ())
       if (! pattern || re_exec (gdb->so_name))
 	{
@@ -1030,9 +1108,16 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 	     only if READSYMS is set.  However, we're making a small
 	     exception for the pthread library, because we sometimes
 	     need the library symbols to be loaded in order to provide
-	     thread support (x86-linux for instance).  */
+	     thread support (x86-linux for instance).
+
+	     When deferred loading is enabled and this is an automatic
+	     load (no pattern, not typed by the user), leave the
+	     symbols unread; they are read the first time an address
+	     inside the library is looked up.  */
 	  const int add_this_solib =
-	    (readsyms || libpthread_solib_p (gdb));
+	    ((readsyms
+	      && (pattern != NULL || from_tty || !solib_defer_symbol_loading))
+	     || libpthread_solib_p (gdb));
 
 	  any_matches = true;
 	  if (add_this_solib)
@@ -1046,12 +1131,20 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 				gdb->so_name);
 		}
 	      else if (solib_read_symbols (gdb, add_flags))
-		loaded_any_symbols = true;
+		{
+		  loaded_any_symbols = true;
+		  if (gdb->objfile != nullptr)
+		    new_objfiles.push_back (gdb->objfile);
+		}
 	    }
 	}
 
+    /* Only re-set breakpoints that could plausibly resolve to
+       something in the just-loaded objfiles; re-parsing every
+       breakpoint against every objfile on each shared library load
+       gets expensive when many libraries are involved.  */
     if (loaded_any_symbols)
-      breakpoint_re_set ();
+      breakpoint_re_set_new_objfiles (new_objfiles);
 
     if (from_tty && pattern && ! any_matches)
       gdb_printf
@@ -1210,6 +1303,52 @@ solib_name_from_address (struct program_space *pspace, CORE_ADDR address)
 
 /* See solib.h.  */
 
+bool
+solib_read_symbols_for_address (CORE_ADDR address)
+{
+  /* Reading symbols triggers further address lookups; don't
+     recurse.  */
+  static bool reading_deferred_symbols = false;
+
+  if (!solib_defer_symbol_loading || reading_deferred_symbols)
+    return false;
+
+  struct so_list *so = nullptr;
+  for (struct so_list *iter : current_program_space->solibs ())
+    if (!iter->symbols_loaded && solib_contains_address_p (iter, address))
+      {
+	so = iter;
+	break;
+      }
+
+  if (so == nullptr)
+    return false;
+
+  scoped_restore restore_reading
+    = make_scoped_restore (&reading_deferred_symbols, true);
+
+  /* An error while reading is reported by solib_read_symbols; the
+     library then simply stays without symbols, as it would after the
+     same error on an eager load.  */
+  solib_read_symbols (so, SYMFILE_DEFER_BP_RESET);
+  if (!so->symbols_loaded)
+    return false;
+
+  if (so->objfile != nullptr)
+    {
+      std::vector<struct objfile *> new_objfiles { so->objfile };
+
+      breakpoint_re_set_new_objfiles (new_objfiles);
+    }
+
+  /* Deliberately no reinit_frame_cache here: this can trigger in the
+     middle of unwinding a frame, and the frames built so far remain
+     usable; the cache is rebuilt at the next stop anyway.  */
+  return true;
+}
+
+/* See solib.h.  */
+
 bool
 solib_keep_data_in_core (CORE_ADDR vaddr, unsigned long size)
 {
@@ -1538,6 +1677,16 @@ show_auto_solib_add (struct ui_file *file, int from_tty,
 	      value);
 }
 
+static void
+show_solib_defer_symbol_loading (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  gdb_printf (file,
+	      _("Deferring of shared library symbol loading is %s.\n"),
+	      value);
+}
+
 
 /* Lookup the value for a specific symbol from dynamic symbol table.  Look
    up symbol from ABFD.  MATCH_SYM is a callback function to determine
@@ -1842,6 +1991,21 @@ inferior.  Otherwise, symbols must be loaded manually, using \
 			   show_auto_solib_add,
 			   &setlist, &showlist);
 
+  add_setshow_boolean_cmd ("solib-defer-symbol-loading", class_support,
+			   &solib_defer_symbol_loading, _("\
+Set deferring of shared library symbol loading."), _("\
+Show deferring of shared library symbol loading."), _("\
+If \"on\", symbols of a newly loaded shared library are not read when\n\
+the library is loaded; instead they are read the first time an address\n\
+inside the library is looked up.  This makes attaching to a process\n\
+with very many shared libraries return to the prompt much faster, at\n\
+the cost of symbols appearing only as the libraries are touched.\n\
+Libraries requested explicitly with the `sharedlibrary' command are\n\
+still loaded immediately.  Off by default."),
+			   NULL,
+			   show_solib_defer_symbol_loading,
+			   &setlist, &showlist);
+
   set_show_commands sysroot_cmds
     = add_setshow_optional_filename_cmd ("sysroot", class_support,
 					 &gdb_sysroot, _("\
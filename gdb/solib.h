@@ -67,6 +67,13 @@ extern const char *solib_name_from_address (struct program_space *, CORE_ADDR);
 
 extern bool solib_contains_address_p (const struct so_list *, CORE_ADDR);
 
+/* If "set solib-defer-symbol-loading" is in effect and ADDRESS falls
+   inside a shared library whose symbols have not been read yet, read
+   them now.  Returns true if symbols were read, in which case an
+   address lookup that previously failed may now succeed.  */
+
+extern bool solib_read_symbols_for_address (CORE_ADDR address);
+
 /* Return whether the data starting at VADDR, size SIZE, must be kept
    in a core file for shared libraries loaded before "gcore" is used
    to be handled correctly when the core file is loaded.  This only
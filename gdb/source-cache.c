@@ -26,6 +26,12 @@
 #include "objfiles.h"
 #include "exec.h"
 #include "cli/cli-cmds.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/thread-pool.h"
+#include "run-on-main-thread.h"
+#include "observable.h"
+#include <mutex>
 
 #ifdef HAVE_SOURCE_HIGHLIGHT
 /* If Gnulib redirects 'open' and 'close' to its replacements
@@ -189,6 +195,153 @@ get_language_name (enum language lang)
   return nullptr;
 }
 
+/* Serializes use of the Source Highlight library.  It is not
+   documented to be thread-safe, and styling runs on worker
+   threads.  */
+
+static std::mutex highlight_mutex;
+
+/* Style CONTENTS, the text of FULLNAME, which is in language
+   LANG_NAME, using the Source Highlight library.  On success return
+   true and store the result in *STYLED.  This is safe to call from a
+   worker thread.  */
+
+static bool
+highlight_source_text (const std::string &fullname,
+		       const std::string &contents,
+		       const std::string &lang_name,
+		       std::string *styled)
+{
+  std::lock_guard<std::mutex> guard (highlight_mutex);
+
+  /* The global source highlight object, or null if one was
+     never constructed.  This is stored here rather than in
+     the class so that we don't need to include anything or do
+     conditional compilation in source-cache.h.  */
+  static srchilite::SourceHighlight *highlighter;
+
+  try
+    {
+      if (highlighter == nullptr)
+	{
+	  highlighter = new srchilite::SourceHighlight ("esc.outlang");
+	  highlighter->setStyleFile ("esc.style");
+
+#ifdef USE_RELATIVE_SRC_HIGHLIGHT
+	  std::string data_dir = gdb_datadir;
+	  data_dir += "/../source-highlight";
+	  highlighter->setDataDir (data_dir);
+#endif
+	}
+
+      std::istringstream input (contents);
+      std::ostringstream output;
+      highlighter->highlight (input, output, lang_name, fullname);
+      *styled = output.str ();
+      return true;
+    }
+  catch (...)
+    {
+      /* Source Highlight will throw an exception if
+	 highlighting fails.  One possible reason it can fail
+	 is if the language is unknown -- which matters to gdb
+	 because Rust support wasn't added until after 3.1.8.
+	 Ignore exceptions here and fall back to
+	 un-highlighted text. */
+      return false;
+    }
+}
+
+/* Name of the on-disk cache file holding the styled text of FULLNAME
+   with modification time MTIME, or the empty string if the cache
+   directory cannot be determined.  The mtime is part of the name, so
+   a changed file simply gets a new cache file and the stale one is
+   never read again.  */
+
+static std::string
+styled_cache_file_name (const std::string &fullname, time_t mtime)
+{
+  std::string dir = get_standard_cache_dir ();
+  if (dir.empty ())
+    return dir;
+  return string_printf ("%s/styled-source/%08x-%lx.esc", dir.c_str (),
+			fast_hash (fullname.c_str (), fullname.size ()),
+			(unsigned long) mtime);
+}
+
+/* Try to read previously styled text from CACHE_NAME into *CONTENTS.
+   The first line of a cache file holds the source file name, which
+   guards against hash collisions in the cache file name; it must
+   equal FULLNAME.  Returns true on success.  */
+
+static bool
+read_styled_cache_file (const std::string &cache_name,
+			const std::string &fullname,
+			std::string *contents)
+{
+  if (cache_name.empty ())
+    return false;
+
+  scoped_fd fd (gdb_open_cloexec (cache_name, O_RDONLY | O_BINARY, 0));
+  if (fd.get () < 0)
+    return false;
+
+  struct stat st;
+  if (fstat (fd.get (), &st) < 0)
+    return false;
+
+  std::string text;
+  text.resize (st.st_size);
+  if (myread (fd.get (), &text[0], text.size ()) < 0)
+    return false;
+
+  size_t eol = text.find ('\n');
+  if (eol == std::string::npos
+      || text.compare (0, eol, fullname) != 0)
+    return false;
+
+  *contents = text.substr (eol + 1);
+  return true;
+}
+
+/* Write STYLED, the styled text of FULLNAME, to the cache file
+   CACHE_NAME.  Best effort; failures just mean the text is styled
+   again next time.  The file is written under a temporary name and
+   renamed into place so that a reader never sees a partial file.  */
+
+static void
+write_styled_cache_file (const std::string &cache_name,
+			 const std::string &fullname,
+			 const std::string &styled)
+{
+  if (cache_name.empty ())
+    return;
+
+  std::string dir = cache_name.substr (0, cache_name.rfind ('/'));
+  if (!mkdir_recursive (dir.c_str ()))
+    return;
+
+  std::string tmp_name = cache_name + ".tmp";
+  gdb_file_up out = gdb_fopen_cloexec (tmp_name, "wb");
+  if (out == nullptr)
+    return;
+
+  if (fwrite (fullname.c_str (), 1, fullname.size (), out.get ())
+      != fullname.size ()
+      || fwrite ("\n", 1, 1, out.get ()) != 1
+      || fwrite (styled.c_str (), 1, styled.size (), out.get ())
+      != styled.size ())
+    {
+      out.reset ();
+      unlink (tmp_name.c_str ());
+      return;
+    }
+
+  out.reset ();
+  if (rename (tmp_name.c_str (), cache_name.c_str ()) != 0)
+    unlink (tmp_name.c_str ());
+}
+
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 
 /* See source-cache.h.  */
@@ -228,6 +381,14 @@ source_cache::ensure (struct symtab *s)
       return false;
     }
 
+#ifdef HAVE_SOURCE_HIGHLIGHT
+  /* Set when a background styling task should be started for the new
+     cache entry once it has been installed below.  */
+  unsigned int style_task_id = 0;
+  std::string style_cache_name;
+  std::string style_lang_name;
+#endif
+
   if (source_styling && gdb_stdout->can_emit_style_escape ())
     {
 #ifdef HAVE_SOURCE_HIGHLIGHT
@@ -235,41 +396,32 @@ source_cache::ensure (struct symtab *s)
       const char *lang_name = get_language_name (s->language ());
       if (lang_name != nullptr && use_gnu_source_highlight)
 	{
-	  /* The global source highlight object, or null if one was
-	     never constructed.  This is stored here rather than in
-	     the class so that we don't need to include anything or do
-	     conditional compilation in source-cache.h.  */
-	  static srchilite::SourceHighlight *highlighter;
-
-	  try
-	    {
-	      if (highlighter == nullptr)
-		{
-		  highlighter = new srchilite::SourceHighlight ("esc.outlang");
-		  highlighter->setStyleFile ("esc.style");
-
-#ifdef USE_RELATIVE_SRC_HIGHLIGHT
-		  std::string data_dir = gdb_datadir;
-		  data_dir += "/../source-highlight";
-		  highlighter->setDataDir (data_dir);
-#endif
-		}
-
-	      std::istringstream input (contents);
-	      std::ostringstream output;
-	      highlighter->highlight (input, output, lang_name, fullname);
-	      contents = output.str ();
-	      already_styled = true;
-	    }
-	  catch (...)
+	  /* The modification time of the file keys the on-disk cache
+	     of styled text.  */
+	  time_t mtime = 0;
+	  struct stat st;
+	  if (stat (fullname.c_str (), &st) == 0)
+	    mtime = st.st_mtime;
+
+	  style_cache_name = styled_cache_file_name (fullname, mtime);
+	  if (read_styled_cache_file (style_cache_name, fullname, &contents))
+	    already_styled = true;
+	  else
 	    {
-	      /* Source Highlight will throw an exception if
-		 highlighting fails.  One possible reason it can fail
-		 is if the language is unknown -- which matters to gdb
-		 because Rust support wasn't added until after 3.1.8.
-		 Ignore exceptions here and fall back to
-		 un-highlighted text. */
+	      /* Styling a large file can block the prompt for
+		 seconds, so run it on a worker thread; the unstyled
+		 text is shown immediately and the styled text is
+		 swapped in when ready (see apply_styled_text).  */
+	      static unsigned int next_style_task = 1;
+	      style_task_id = next_style_task++;
+	      style_lang_name = lang_name;
 	    }
+
+	  /* Either the cache already provided styled text, or a
+	     styling task is about to be queued; if the task fails,
+	     apply_styled_text falls back to the extension
+	     languages.  */
+	  already_styled = true;
 	}
 
       if (!already_styled)
@@ -292,11 +444,98 @@ source_cache::ensure (struct symtab *s)
       m_source_map.erase (iter);
     }
 
+#ifdef HAVE_SOURCE_HIGHLIGHT
+  if (style_task_id != 0)
+    {
+      source_text &entry = m_source_map.back ();
+      entry.style_task = style_task_id;
+
+      /* Everything the worker needs is copied; it must not touch GDB
+	 state.  The result is posted back to the main thread.  */
+      std::string task_fullname = entry.fullname;
+      std::string task_contents = entry.contents;
+      unsigned int task_id = style_task_id;
+      std::string task_cache_name = std::move (style_cache_name);
+      std::string task_lang = std::move (style_lang_name);
+
+      gdb::thread_pool::g_thread_pool->post_task
+	([this, task_fullname, task_contents, task_id, task_cache_name,
+	  task_lang] ()
+	 {
+	   std::string styled;
+	   bool ok = highlight_source_text (task_fullname, task_contents,
+					    task_lang, &styled);
+	   run_on_main_thread ([this, task_fullname, task_id,
+				task_cache_name, ok,
+				styled = std::move (styled)] () mutable
+	     {
+	       this->apply_styled_text (task_fullname, task_id,
+					task_cache_name, ok,
+					std::move (styled));
+	     });
+	 });
+    }
+#endif /* HAVE_SOURCE_HIGHLIGHT */
+
   return true;
 }
 
 /* See source-cache.h.  */
 
+void
+source_cache::apply_styled_text (const std::string &fullname,
+				 unsigned int task_id,
+				 const std::string &cache_name,
+				 bool success, std::string &&styled)
+{
+  if (!success)
+    {
+      /* GNU Source Highlight could not style the file -- for example
+	 a language its installed version does not know.  Fall back to
+	 the extension languages, as the foreground path does when
+	 Source Highlight is not usable at all.  */
+      for (source_text &item : m_source_map)
+	if (item.fullname == fullname && item.style_task == task_id)
+	  {
+	    item.style_task = 0;
+
+	    gdb::optional<std::string> ext_contents
+	      = ext_lang_colorize (fullname, item.contents);
+	    if (ext_contents.has_value ())
+	      {
+		item.contents = std::move (*ext_contents);
+
+		/* Let any TUI source window showing the file re-fetch
+		   the now styled text.  */
+		gdb::observers::styling_changed.notify ();
+	      }
+	    break;
+	  }
+      return;
+    }
+
+#ifdef HAVE_SOURCE_HIGHLIGHT
+  /* Save the result even if the cache entry was evicted or flushed in
+     the meantime; the styling work is done and the next display of
+     the file can pick it up from disk.  */
+  write_styled_cache_file (cache_name, fullname, styled);
+#endif
+
+  for (source_text &item : m_source_map)
+    if (item.fullname == fullname && item.style_task == task_id)
+      {
+	item.style_task = 0;
+	item.contents = std::move (styled);
+
+	/* Let any TUI source window showing the file re-fetch the now
+	   styled text.  */
+	gdb::observers::styling_changed.notify ();
+	break;
+      }
+}
+
+/* See source-cache.h.  */
+
 bool
 source_cache::get_line_charpos (struct symtab *s,
 				const std::vector<off_t> **offsets)
@@ -77,6 +77,11 @@ private:
     std::string fullname;
     /* The contents of the file.  */
     std::string contents;
+    /* When non-zero, a styling task with this id is running on a
+       worker thread and CONTENTS is still the unstyled text; the
+       styled text is swapped in by apply_styled_text when the task
+       finishes.  */
+    unsigned int style_task = 0;
   };
 
   /* A helper function for get_source_lines reads a source file.
@@ -89,6 +94,16 @@ private:
      into both caches.  Returns false on error.  */
   bool ensure (struct symtab *s);
 
+  /* Called on the main thread when a background styling task
+     finishes.  Installs STYLED as the contents of the entry for
+     FULLNAME, provided the entry still exists and still waits for
+     task TASK_ID, and saves the result in the on-disk cache file
+     CACHE_NAME.  SUCCESS is false when styling failed, in which case
+     the unstyled text simply stays in place.  */
+  void apply_styled_text (const std::string &fullname, unsigned int task_id,
+			  const std::string &cache_name, bool success,
+			  std::string &&styled);
+
   /* The contents of the source text cache.  */
   std::vector<source_text> m_source_map;
 
@@ -57,6 +57,8 @@
 #include "cli/cli-style.h"
 #include "gdbsupport/buildargv.h"
 
+#include <unordered_map>
+
 /* The possible choices of "set print frame-arguments", and the value
    of this setting.  */
 
@@ -188,6 +190,7 @@ struct backtrace_cmd_options
   bool full = false;
   bool no_filters = false;
   bool hide = false;
+  bool summary = false;
 };
 
 using bt_flag_option_def
@@ -211,6 +214,13 @@ static const gdb::option::option_def backtrace_command_option_defs[] = {
     [] (backtrace_cmd_options *opt) { return &opt->hide; },
     N_("Causes Python frame filter elided frames to not be printed."),
   },
+
+  bt_flag_option_def {
+    "summary",
+    [] (backtrace_cmd_options *opt) { return &opt->summary; },
+    N_("Print only frame addresses and function names, resolved from minimal\n\
+symbols without reading full debug information."),
+  },
 };
 
 /* Prototypes for local functions.  */
@@ -1977,6 +1987,47 @@ static frame_command_helper <info_frame_command_core> info_frame_cmd;
 static frame_command_helper <frame_command_core> frame_cmd;
 static frame_command_helper <select_frame_command_core> select_frame_cmd;
 
+/* Print a one-line summary of FRAME: its level, address and function
+   name, the latter resolved from minimal symbols alone.  Unlike
+   print_frame_info this never reads full debug symbols, so it cannot
+   print source locations or arguments, but it also cannot trigger
+   the expansion of any compunit's symtab.  */
+
+static void
+print_frame_summary (frame_info_ptr frame)
+{
+  struct ui_out *uiout = current_uiout;
+  struct gdbarch *gdbarch = get_frame_arch (frame);
+  CORE_ADDR pc = 0;
+  int pc_p = get_frame_pc_if_available (frame, &pc);
+
+  ui_out_emit_tuple tuple_emitter (uiout, "frame");
+
+  uiout->text ("#");
+  uiout->field_fmt_signed (2, ui_left, "level", frame_relative_level (frame));
+
+  if (pc_p)
+    uiout->field_core_addr ("addr", gdbarch, pc);
+  else
+    uiout->field_string ("addr", "<unavailable>", metadata_style.style ());
+  uiout->text (" in ");
+
+  /* Use the address in the block, not the return address, so that a
+     call at the very end of a function still resolves to it.  */
+  const char *funname = "??";
+  CORE_ADDR block_pc;
+  if (get_frame_address_in_block_if_available (frame, &block_pc))
+    {
+      struct bound_minimal_symbol msymbol
+	= lookup_minimal_symbol_by_pc (block_pc);
+
+      if (msymbol.minsym != nullptr)
+	funname = msymbol.minsym->print_name ();
+    }
+  uiout->field_string ("func", funname, function_name_style.style ());
+  uiout->text (" ()\n");
+}
+
 /* Print briefly all stack frames or just the innermost COUNT_EXP
    frames.  */
 
@@ -2022,7 +2073,9 @@ backtrace_command_1 (const frame_print_options &fp_opts,
   if (fp_opts.print_raw_frame_arguments)
     flags |= PRINT_RAW_FRAME_ARGUMENTS;
 
-  if (!bt_opts.no_filters)
+  /* A summary backtrace deliberately bypasses the frame filters;
+     running them would read exactly the symbols it avoids.  */
+  if (!bt_opts.no_filters && !bt_opts.summary)
     {
       enum ext_lang_frame_args arg_type;
 
@@ -2048,7 +2101,8 @@ backtrace_command_1 (const frame_print_options &fp_opts,
 
   /* Run the inbuilt backtrace if there are no filters registered, or
      "-no-filters" has been specified from the command.  */
-  if (bt_opts.no_filters || result == EXT_LANG_BT_NO_FILTERS)
+  if (bt_opts.no_filters || bt_opts.summary
+      || result == EXT_LANG_BT_NO_FILTERS)
     {
       frame_info_ptr trailing;
 
@@ -2065,6 +2119,36 @@ backtrace_command_1 (const frame_print_options &fp_opts,
       else
 	trailing = get_current_frame ();
 
+      /* Unwind the whole batch of frames first and hand their PCs to
+	 the symbol readers in one go, so that the symtabs the print
+	 loop below will need can be expanded as a batch instead of
+	 one lookup at a time.  Unwind errors are ignored here; the
+	 print loop reports them better.  A summary backtrace never
+	 needs the symtabs at all.  */
+      if (!bt_opts.summary)
+	{
+	  try
+	    {
+	      std::vector<CORE_ADDR> pcs;
+	      int remaining = count;
+
+	      for (fi = trailing; fi != nullptr && remaining--;
+		   fi = get_prev_frame (fi))
+		{
+		  QUIT;
+
+		  CORE_ADDR pc;
+		  if (get_frame_address_in_block_if_available (fi, &pc))
+		    pcs.push_back (pc);
+		}
+
+	      expand_symtabs_for_pcs (pcs);
+	    }
+	  catch (const gdb_exception_error &ex)
+	    {
+	    }
+	}
+
       for (fi = trailing; fi && count--; fi = get_prev_frame (fi))
 	{
 	  QUIT;
@@ -2074,9 +2158,14 @@ backtrace_command_1 (const frame_print_options &fp_opts,
 	     hand, perhaps the code does or could be fixed to make sure
 	     the frame->prev field gets set to NULL in that case).  */
 
-	  print_frame_info (fp_opts, fi, 1, LOCATION, 1, 0);
-	  if ((flags & PRINT_LOCALS) != 0)
-	    print_frame_local_vars (fi, false, NULL, NULL, 1, gdb_stdout);
+	  if (bt_opts.summary)
+	    print_frame_summary (fi);
+	  else
+	    {
+	      print_frame_info (fp_opts, fi, 1, LOCATION, 1, 0);
+	      if ((flags & PRINT_LOCALS) != 0)
+		print_frame_local_vars (fi, false, NULL, NULL, 1, gdb_stdout);
+	    }
 
 	  /* Save the last frame to check for error conditions.  */
 	  trailing = fi;
@@ -2146,6 +2235,11 @@ parse_backtrace_qualifiers (const char *arg,
 	  if (bt_cmd_opts != nullptr)
 	    bt_cmd_opts->hide = true;
 	}
+      else if (startswith ("summary", this_arg))
+	{
+	  if (bt_cmd_opts != nullptr)
+	    bt_cmd_opts->summary = true;
+	}
       else
 	{
 	  /* Not a recognized qualifier, so stop.  */
@@ -2202,7 +2296,7 @@ backtrace_command_completer (struct cmd_list_element *ignore,
       if (*p == '\0')
 	{
 	  static const char *const backtrace_cmd_qualifier_choices[] = {
-	    "full", "no-filters", "hide", nullptr,
+	    "full", "no-filters", "hide", "summary", nullptr,
 	  };
 	  complete_on_enum (tracker, backtrace_cmd_qualifier_choices,
 			    text, text);
@@ -2283,6 +2377,10 @@ struct print_variable_and_value_data
   struct ui_file *stream;
   int values_printed;
 
+  /* Values computed up front by prefetch_frame_var_values, or NULL.  */
+  const std::unordered_map<struct symbol *, struct value *> *prefetched
+    = nullptr;
+
   void operator() (const char *print_name, struct symbol *sym);
 };
 
@@ -2310,7 +2408,15 @@ print_variable_and_value_data::operator() (const char *print_name,
       return;
     }
 
-  print_variable_and_value (print_name, sym, frame, stream, num_tabs);
+  struct value *val = nullptr;
+  if (prefetched != nullptr)
+    {
+      auto it = prefetched->find (sym);
+      if (it != prefetched->end ())
+	val = it->second;
+    }
+
+  print_variable_and_value (print_name, sym, frame, stream, num_tabs, val);
 
   /* print_variable_and_value invalidates FRAME.  */
   frame = NULL;
@@ -2318,6 +2424,63 @@ print_variable_and_value_data::operator() (const char *print_name,
   values_printed = 1;
 }
 
+/* Compute the values of the variables that the locals (or, with ARGS
+   true, arguments) iterator will print for FRAME, applying the same
+   filters as print_variable_and_value_data, and fetch the lazy ones
+   in one batch (see value::fetch_lazy_batch).  This saves one target
+   round trip per variable on remote targets.  Values that cannot be
+   computed are simply left out; printing recomputes them and reports
+   the error.  */
+
+static std::unordered_map<struct symbol *, struct value *>
+prefetch_frame_var_values (frame_info_ptr frame,
+			   const struct print_variable_and_value_data &cb_data,
+			   const struct block *block, bool args)
+{
+  std::unordered_map<struct symbol *, struct value *> values;
+  std::vector<value *> lazy_vals;
+
+  auto collect = [&] (const char *print_name, struct symbol *sym)
+    {
+      if (cb_data.preg.has_value ()
+	  && cb_data.preg->exec (sym->natural_name (), 0, NULL, 0) != 0)
+	return;
+      if (cb_data.treg.has_value ()
+	  && !treg_matches_sym_type_name (*cb_data.treg, sym))
+	return;
+      if (language_def (sym->language ())->symbol_printing_suppressed (sym))
+	return;
+
+      try
+	{
+	  struct value *val = read_var_value (sym, NULL, frame);
+
+	  values[sym] = val;
+	  if (val->lazy ())
+	    lazy_vals.push_back (val);
+	}
+      catch (const gdb_exception_error &except)
+	{
+	}
+    };
+
+  if (args)
+    iterate_over_block_arg_vars (block, collect);
+  else
+    iterate_over_block_local_vars (block, collect);
+
+  try
+    {
+      value::fetch_lazy_batch (lazy_vals);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      /* Values left lazy are fetched individually when printed.  */
+    }
+
+  return values;
+}
+
 /* Prepares the regular expression REG from REGEXP.
    If REGEXP is NULL, it results in an empty regular expression.  */
 
@@ -2384,6 +2547,10 @@ print_frame_local_vars (frame_info_ptr frame,
   scoped_restore_selected_frame restore_selected_frame;
   select_frame (frame);
 
+  std::unordered_map<struct symbol *, struct value *> prefetched
+    = prefetch_frame_var_values (frame, cb_data, block, false);
+  cb_data.prefetched = &prefetched;
+
   iterate_over_block_local_vars (block, cb_data);
 
   if (!cb_data.values_printed && !quiet)
@@ -2544,6 +2711,10 @@ print_frame_arg_vars (frame_info_ptr frame,
   cb_data.stream = stream;
   cb_data.values_printed = 0;
 
+  std::unordered_map<struct symbol *, struct value *> prefetched
+    = prefetch_frame_var_values (frame, cb_data, func->value_block (), true);
+  cb_data.prefetched = &prefetched;
+
   iterate_over_block_arg_vars (func->value_block (), cb_data);
 
   /* do_print_variable_and_value invalidates FRAME.  */
@@ -3460,6 +3631,7 @@ For backward compatibility, the following qualifiers are supported:\n\
    full       - same as -full option.\n\
    no-filters - same as -no-filters option.\n\
    hide       - same as -hide.\n\
+   summary    - same as -summary.\n\
 \n\
 With a negative COUNT, print outermost -COUNT frames."),
 			       backtrace_opts);
@@ -469,6 +469,19 @@ objfile::find_pc_sect_compunit_symtab (struct bound_minimal_symbol msymbol,
   return retval;
 }
 
+void
+objfile::expand_symtabs_for_pcs (gdb::array_view<const CORE_ADDR> pcs)
+{
+  if (debug_symfile)
+    gdb_printf (gdb_stdlog,
+		"qf->expand_symtabs_for_pcs (%s, %s PCs)\n",
+		objfile_debug_name (this),
+		pulongest (pcs.size ()));
+
+  for (const auto &iter : qf_require_partial_symbols ())
+    iter->expand_symtabs_for_pcs (this, pcs);
+}
+
 void
 objfile::map_symbol_filenames (gdb::function_view<symbol_filename_ftype> fun,
 			       bool need_fullname)
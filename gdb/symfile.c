@@ -68,6 +68,13 @@
 #include <ctype.h>
 #include <chrono>
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#include "gdbsupport/event-loop.h"
+#endif
 
 int (*deprecated_ui_load_progress_hook) (const char *section,
 					 unsigned long num);
@@ -867,6 +874,59 @@ init_entry_point_info (struct objfile *objfile)
     }
 }
 
+/* Compute OBJFILE's section offsets for the relocated addresses ADDRS
+   by calling the symbol reader's sym_offsets method, reusing a
+   previously computed table when possible.
+
+   A shared library is normally mapped at the same base address in
+   every process using it, so when debugging several inferiors the
+   same offsets are recomputed for every objfile sharing the library's
+   BFD.  Cache the computed table in the per-BFD storage, keyed on the
+   addresses it was computed from, and copy it into later objfiles
+   whose addresses match.  Reuse is restricted to shared library
+   objfiles because sym_offsets can have side effects for other kinds
+   of files (see the relocatable case in default_symfile_offsets).  */
+
+static void
+symfile_compute_section_offsets (struct objfile *objfile,
+				 const section_addr_info &addrs)
+{
+  struct objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+
+  /* Only the BFD section index and the relocated address of each
+     entry feed into the computed offsets, so they make up the cache
+     key.  */
+  std::vector<std::pair<int, CORE_ADDR>> key;
+  key.reserve (addrs.size ());
+  for (const other_sections &sect : addrs)
+    key.emplace_back (sect.sectindex, sect.addr);
+
+  if ((objfile->flags & OBJF_SHARED) != 0
+      && per_bfd->section_offsets_cached
+      && key == per_bfd->cached_offsets_addrs)
+    {
+      objfile->section_offsets = per_bfd->cached_section_offsets;
+      objfile->sect_index_text = per_bfd->cached_sect_index_text;
+      objfile->sect_index_data = per_bfd->cached_sect_index_data;
+      objfile->sect_index_bss = per_bfd->cached_sect_index_bss;
+      objfile->sect_index_rodata = per_bfd->cached_sect_index_rodata;
+      return;
+    }
+
+  (*objfile->sf->sym_offsets) (objfile, addrs);
+
+  if ((objfile->flags & OBJF_SHARED) != 0)
+    {
+      per_bfd->section_offsets_cached = true;
+      per_bfd->cached_offsets_addrs = std::move (key);
+      per_bfd->cached_section_offsets = objfile->section_offsets;
+      per_bfd->cached_sect_index_text = objfile->sect_index_text;
+      per_bfd->cached_sect_index_data = objfile->sect_index_data;
+      per_bfd->cached_sect_index_bss = objfile->sect_index_bss;
+      per_bfd->cached_sect_index_rodata = objfile->sect_index_rodata;
+    }
+}
+
 /* Process a symbol file, as either the main file or as a dynamically
    loaded file.
 
@@ -962,7 +1022,7 @@ syms_from_objfile_1 (struct objfile *objfile,
   (*objfile->sf->sym_init) (objfile);
   clear_complaints ();
 
-  (*objfile->sf->sym_offsets) (objfile, *addrs);
+  symfile_compute_section_offsets (objfile, *addrs);
 
   read_symbols (objfile, add_flags);
 
@@ -1236,6 +1296,58 @@ symbol_file_clear (int from_tty)
 
 bool separate_debug_file_debug = false;
 
+/* Cache of the directory-existence probes made while looking for
+   separate debug files.  The lookup tries a handful of candidate
+   paths per objfile, and when many objfiles are processed in one
+   command most of those candidates sit in the same few nonexistent
+   directories (/usr/lib/debug/... and friends).  Remembering which
+   directories are absent turns the repeated failed opens -- which can
+   be slow on network file systems -- into one stat per directory.
+   The cache is dropped before each prompt, so debug files installed
+   while GDB is running are picked up by the next command.  */
+
+static std::unordered_map<std::string, bool> debug_dir_exists_cache;
+
+/* Return true if the directory part of NAME is known not to exist.
+   Unknown directories are probed once and remembered.  */
+
+static bool
+separate_debug_file_dir_missing_p (const std::string &name)
+{
+  /* Only local paths can be probed with stat.  */
+  if (is_target_filename (name.c_str ()))
+    return false;
+
+  size_t len = name.size ();
+  while (len > 0 && !IS_DIR_SEPARATOR (name[len - 1]))
+    len--;
+  /* No directory part, or the root directory.  */
+  if (len <= 1)
+    return false;
+
+  std::string dir = name.substr (0, len - 1);
+
+  auto it = debug_dir_exists_cache.find (dir);
+  if (it == debug_dir_exists_cache.end ())
+    {
+      struct stat st;
+      bool exists = (stat (dir.c_str (), &st) == 0
+		     && S_ISDIR (st.st_mode));
+
+      it = debug_dir_exists_cache.emplace (std::move (dir), exists).first;
+    }
+
+  return !it->second;
+}
+
+/* Forget the cached directory probes between commands.  */
+
+static void
+symfile_before_prompt (const char *current_prompt)
+{
+  debug_dir_exists_cache.clear ();
+}
+
 static int
 separate_debug_file_exists (const std::string &name, unsigned long crc,
 			    struct objfile *parent_objfile,
@@ -1255,6 +1367,16 @@ separate_debug_file_exists (const std::string &name, unsigned long crc,
   if (filename_cmp (name.c_str (), objfile_name (parent_objfile)) == 0)
     return 0;
 
+  if (separate_debug_file_dir_missing_p (name))
+    {
+      if (separate_debug_file_debug)
+	gdb_printf (gdb_stdlog,
+		    _("  Trying %s... no, directory known absent.\n"),
+		    name.c_str ());
+
+      return 0;
+    }
+
   if (separate_debug_file_debug)
     {
       gdb_printf (gdb_stdlog, _("  Trying %s..."), name.c_str ());
@@ -2453,6 +2575,237 @@ remove_symbol_file_command (const char *args, int from_tty)
   clear_symtab_users (0);
 }
 
+/* Watching objfile backing files for modification.
+
+   By default reread_symbols stats the backing file of every objfile
+   to find the ones that were rebuilt since their symbols were read.
+   With many shared libraries, or with files on a slow network file
+   system, those stat calls dominate the cost of every "run".
+
+   When "maint set symbol-reread-watching on" is in effect (and the
+   host supports inotify), GDB instead watches the directories that
+   contain the backing files and learns about rebuilds from the
+   kernel, so each reread check only stats the files that actually
+   changed.  The watches are placed on the containing directories
+   rather than on the files themselves because a rebuild typically
+   replaces a file by renaming a new one over it, which a watch on
+   the old inode would never report.
+
+   This is off by default because inotify only reports modifications
+   made through this host's kernel: on a network file system a
+   rebuild performed on another machine produces no event, and GDB
+   would silently keep the stale symbols.  */
+
+static bool symbol_reread_watching = false;
+
+#ifdef HAVE_SYS_INOTIFY_H
+
+/* The inotify descriptor, or -1 if it has not been created yet.  */
+
+static int reread_watch_fd = -1;
+
+/* Set when events may have been lost: the kernel queue overflowed, a
+   watched directory disappeared, or a watch could not be placed.
+   The next reread_symbols drops all watches and falls back to a full
+   stat pass, then starts over.  */
+
+static bool reread_watch_unreliable = false;
+
+/* A watched directory and the file names within it that we care
+   about.  PATH retains its trailing directory separator so that full
+   names can be formed by simple concatenation.  */
+
+struct reread_watched_dir
+{
+  std::string path;
+  std::unordered_set<std::string> names;
+};
+
+/* Active watches, by inotify watch descriptor and by directory.  */
+
+static std::unordered_map<int, reread_watched_dir> reread_watches;
+static std::unordered_map<std::string, int> reread_watch_dirs;
+
+/* Full names of watched files reported modified since they were last
+   stat'ed by reread_symbols.  */
+
+static std::unordered_set<std::string> reread_watch_changed;
+
+/* Cache of gdb_realpath results for watched files, so that resolving
+   symbolic links does not reintroduce per-file system calls on every
+   reread check.  */
+
+static std::unordered_map<std::string, std::string> reread_watch_realpaths;
+
+/* Drop all watches and forget everything we learned from them.  The
+   next reread_symbols stats every objfile again, as if watching had
+   just been enabled.  */
+
+static void
+reread_watch_reset ()
+{
+  if (reread_watch_fd >= 0)
+    {
+      delete_file_handler (reread_watch_fd);
+      close (reread_watch_fd);
+      reread_watch_fd = -1;
+    }
+  reread_watches.clear ();
+  reread_watch_dirs.clear ();
+  reread_watch_changed.clear ();
+  reread_watch_realpaths.clear ();
+  reread_watch_unreliable = false;
+}
+
+/* Event-loop callback: drain the inotify descriptor and record which
+   watched files were touched.  */
+
+static void
+reread_watch_handler (int error, gdb_client_data client_data)
+{
+  alignas (struct inotify_event) char buf[4096];
+
+  for (;;)
+    {
+      ssize_t len = read (reread_watch_fd, buf, sizeof (buf));
+      if (len <= 0)
+	break;
+
+      for (char *p = buf; p < buf + len; )
+	{
+	  struct inotify_event *ev = (struct inotify_event *) p;
+	  p += sizeof (*ev) + ev->len;
+
+	  if ((ev->mask & IN_Q_OVERFLOW) != 0)
+	    {
+	      reread_watch_unreliable = true;
+	      continue;
+	    }
+
+	  auto it = reread_watches.find (ev->wd);
+	  if (it == reread_watches.end ())
+	    continue;
+
+	  if ((ev->mask & (IN_IGNORED | IN_UNMOUNT)) != 0)
+	    {
+	      /* The directory went away or the kernel dropped the
+		 watch; the state of everything under it is now
+		 unknown.  */
+	      reread_watch_dirs.erase (it->second.path);
+	      reread_watches.erase (it);
+	      reread_watch_unreliable = true;
+	      continue;
+	    }
+
+	  if (ev->len == 0)
+	    continue;
+
+	  if (it->second.names.find (ev->name) != it->second.names.end ())
+	    reread_watch_changed.insert (it->second.path + ev->name);
+	}
+    }
+}
+
+/* Start watching the directory entry for PATH if it is not watched
+   already.  Return true if it was already being watched, meaning any
+   change since the previous reread check would have been reported.  */
+
+static bool
+reread_watch_add_entry (const std::string &path)
+{
+  if (reread_watch_fd < 0)
+    {
+      reread_watch_fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+      if (reread_watch_fd < 0)
+	{
+	  reread_watch_unreliable = true;
+	  return false;
+	}
+      add_file_handler (reread_watch_fd, reread_watch_handler, nullptr,
+			"symbol-reread-watch");
+    }
+
+  const char *cpath = path.c_str ();
+  const char *base = lbasename (cpath);
+  if (base == cpath)
+    return false;
+
+  std::string dir (cpath, base - cpath);
+
+  int wd;
+  auto dit = reread_watch_dirs.find (dir);
+  if (dit == reread_watch_dirs.end ())
+    {
+      wd = inotify_add_watch (reread_watch_fd, dir.c_str (),
+			      (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM
+			       | IN_CREATE | IN_DELETE | IN_ATTRIB));
+      if (wd < 0)
+	{
+	  reread_watch_unreliable = true;
+	  return false;
+	}
+      reread_watches[wd].path = dir;
+      reread_watch_dirs.emplace (std::move (dir), wd);
+    }
+  else
+    wd = dit->second;
+
+  return !reread_watches[wd].names.insert (base).second;
+}
+
+/* Ensure the backing file FILENAME is watched, and return true if it
+   has been watched since the previous reread check and no
+   modification was reported, i.e. the caller may skip statting it.
+   A false result means the caller must stat the file as usual.  */
+
+static bool
+reread_watch_unchanged_p (const char *filename)
+{
+  /* If FILENAME is a symbolic link, the rebuild may replace either
+     the link or its target, so watch the directory entries of both.
+     (A retargeted link in an intermediate directory component is
+     still missed; so is any modification made by another host on a
+     network file system, which is why this is all opt-in.)  */
+  auto rit = reread_watch_realpaths.find (filename);
+  if (rit == reread_watch_realpaths.end ())
+    {
+      gdb::unique_xmalloc_ptr<char> real = gdb_realpath (filename);
+      rit = (reread_watch_realpaths.emplace (filename, real.get ())
+	     .first);
+    }
+  const std::string &real = rit->second;
+
+  bool watched = reread_watch_add_entry (filename);
+  if (real != filename)
+    watched = reread_watch_add_entry (real) && watched;
+
+  bool changed = (reread_watch_changed.erase (filename) != 0);
+  if (real != filename)
+    changed = (reread_watch_changed.erase (real) != 0) || changed;
+
+  return watched && !changed;
+}
+
+#endif /* HAVE_SYS_INOTIFY_H */
+
+/* Implement "maint set symbol-reread-watching".  */
+
+static void
+maint_set_symbol_reread_watching (const char *args, int from_tty,
+				  struct cmd_list_element *c)
+{
+#ifndef HAVE_SYS_INOTIFY_H
+  if (symbol_reread_watching)
+    {
+      symbol_reread_watching = false;
+      error (_("Watching symbol files is not supported on this host."));
+    }
+#else
+  if (!symbol_reread_watching)
+    reread_watch_reset ();
+#endif
+}
+
 /* Re-read symbols if a symbol-file has changed.  */
 
 void
@@ -2467,6 +2820,18 @@ reread_symbols (int from_tty)
      indicate when the executable was last reloaded.  */
   reopen_exec_file ();
 
+#ifdef HAVE_SYS_INOTIFY_H
+  if (symbol_reread_watching && reread_watch_fd >= 0)
+    {
+      /* Collect any events still queued in the kernel, then, if some
+	 may have been lost, drop the watches so that this pass stats
+	 everything and watching starts afresh.  */
+      reread_watch_handler (0, nullptr);
+      if (reread_watch_unreliable)
+	reread_watch_reset ();
+    }
+#endif
+
   for (objfile *objfile : current_program_space->objfiles ())
     {
       if (objfile->obfd.get () == NULL)
@@ -2488,6 +2853,22 @@ reread_symbols (int from_tty)
       if (objfile->obfd.get ()->flags & BFD_IN_MEMORY)
 	continue;
 
+#ifdef HAVE_SYS_INOTIFY_H
+      if (symbol_reread_watching)
+	{
+	  /* Members of an archive share the archive's backing file,
+	     so that is the file to watch (and to stat below).  */
+	  const char *watch_name;
+	  if (objfile->obfd->my_archive)
+	    watch_name = bfd_get_filename (objfile->obfd->my_archive);
+	  else
+	    watch_name = objfile_name (objfile);
+
+	  if (reread_watch_unchanged_p (watch_name))
+	    continue;
+	}
+#endif
+
       struct stat new_statbuf;
       int res = bfd_stat (objfile->obfd.get (), &new_statbuf);
       if (res != 0)
@@ -3854,6 +4235,7 @@ _initialize_symfile ()
   struct cmd_list_element *c;
 
   gdb::observers::free_objfile.attach (symfile_free_objfile, "symfile");
+  gdb::observers::before_prompt.attach (symfile_before_prompt, "symfile");
 
 #define READNOW_READNEVER_HELP \
   "The '-readnow' option will cause GDB to read the entire symbol file\n\
@@ -3974,6 +4356,19 @@ Show printing of separate debug info file search debug."), _("\
 When on, GDB prints the searched locations while looking for separate debug \
 info files."), NULL, NULL, &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("symbol-reread-watching", class_maintenance,
+			   &symbol_reread_watching, _("\
+Set whether to watch symbol files for changes instead of polling."), _("\
+Show whether to watch symbol files for changes instead of polling."), _("\
+When enabled, GDB asks the operating system to report modifications of\n\
+symbol files and only re-checks the files that were reported changed,\n\
+instead of checking the timestamp of every file before each run.  This\n\
+is unsafe on network file systems, where changes made by other hosts\n\
+are not reported.  Not every host supports watching files."),
+			   maint_set_symbol_reread_watching, NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
 #if GDB_SELF_TEST
   selftests::register_test
     ("filename_language", selftests::filename_language::test_filename_language);
@@ -378,6 +378,7 @@ maintenance_print_symbols (const char *args, int from_tty)
 {
   struct ui_file *outfile = gdb_stdout;
   char *address_arg = NULL, *source_arg = NULL, *objfile_arg = NULL;
+  bool expand_arg = false;
   int i, outfile_idx;
 
   dont_repeat ();
@@ -392,6 +393,8 @@ maintenance_print_symbols (const char *args, int from_tty)
 	    error (_("Missing pc value"));
 	  address_arg = argv[++i];
 	}
+      else if (strcmp (argv[i], "-expand") == 0)
+	expand_arg = true;
       else if (strcmp (argv[i], "-source") == 0)
 	{
 	  if (argv[i + 1] == NULL)
@@ -460,6 +463,27 @@ maintenance_print_symbols (const char *args, int from_tty)
 	  if (!print_for_objfile)
 	    continue;
 
+	  /* Normally only compunits that happen to have been expanded
+	     already are dumped; with -expand, read in the rest first.
+	     When a source file was named, only the matching compunits
+	     are expanded.  */
+	  if (expand_arg)
+	    {
+	      if (source_arg != NULL)
+		objfile->expand_symtabs_matching
+		  ([&] (const char *filename, bool basenames)
+		   {
+		     return compare_filenames_for_search (filename,
+							  source_arg);
+		   },
+		   NULL, NULL, NULL,
+		   SEARCH_GLOBAL_BLOCK | SEARCH_STATIC_BLOCK,
+		   UNDEF_DOMAIN,
+		   ALL_DOMAIN);
+	      else
+		objfile->expand_all_symtabs ();
+	    }
+
 	  for (compunit_symtab *cu : objfile->compunits ())
 	    {
 	      for (symtab *s : cu->filetabs ())
@@ -1052,12 +1076,15 @@ _initialize_symmisc ()
   add_cmd ("symbols", class_maintenance, maintenance_print_symbols, _("\
 Print dump of current symbol definitions.\n\
 Usage: mt print symbols [-pc ADDRESS] [--] [OUTFILE]\n\
-       mt print symbols [-objfile OBJFILE] [-source SOURCE] [--] [OUTFILE]\n\
+       mt print symbols [-objfile OBJFILE] [-source SOURCE] [-expand] [--] [OUTFILE]\n\
 Entries in the full symbol table are dumped to file OUTFILE,\n\
 or the terminal if OUTFILE is unspecified.\n\
 If ADDRESS is provided, dump only the symbols for the file with code at that address.\n\
 If SOURCE is provided, dump only that file's symbols.\n\
-If OBJFILE is provided, dump only that object file's symbols."),
+If OBJFILE is provided, dump only that object file's symbols.\n\
+With -expand, first read in any symbol tables that are not yet expanded,\n\
+instead of dumping only what has been expanded so far; with -source,\n\
+only the matching symbol tables are read in."),
 	   &maintenanceprintlist);
 
   add_cmd ("msymbols", class_maintenance, maintenance_print_msymbols, _("\
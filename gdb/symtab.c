@@ -28,6 +28,7 @@
 #include "symfile.h"
 #include "objfiles.h"
 #include "gdbcmd.h"
+#include "maint.h"
 #include "gdbsupport/gdb_regex.h"
 #include "expression.h"
 #include "language.h"
@@ -41,6 +42,8 @@
 #include "go-lang.h"
 #include "p-lang.h"
 #include "addrmap.h"
+#include "build-id.h"
+#include "dwarf2/index-cache.h"
 #include "cli/cli-utils.h"
 #include "cli/cli-style.h"
 #include "cli/cli-cmds.h"
@@ -70,6 +73,10 @@
 #include "filename-seen-cache.h"
 #include "arch-utils.h"
 #include <algorithm>
+#include <unordered_set>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 #include "gdbsupport/gdb_string_view.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/common-utils.h"
@@ -122,10 +129,24 @@ static const registry<program_space>::key<main_info> main_progspace_key;
 
 /* The default symbol cache size.
    There is no extra cpu cost for large N (except when flushing the cache,
-   which is rare).  The value here is just a first attempt.  A better default
-   value may be higher or lower.  A prime number can make up for a bad hash
-   computation, so that's why the number is what it is.  */
-#define DEFAULT_SYMBOL_CACHE_SIZE 1021
+   which is rare).  The old default of 1021 was too small for large
+   programs, where the hit rate collapsed; measurements favor a few
+   thousand slots.  The slots are grouped into buckets of
+   SYMBOL_CACHE_ASSOC entries, and a prime number of buckets can make
+   up for a bad hash computation, so the value is chosen to keep the
+   bucket count (SIZE / SYMBOL_CACHE_ASSOC) prime.  */
+#define DEFAULT_SYMBOL_CACHE_SIZE 8186
+
+/* The associativity of the symbol cache.  Each hash value maps to a
+   bucket of this many slots; on a miss the least recently used slot
+   of the bucket is evicted, so two hot symbols whose hashes collide
+   no longer evict each other.  */
+#define SYMBOL_CACHE_ASSOC 2
+
+/* The number of locks the slots of a cache are striped over, so that
+   threads can use the symbol cache concurrently.  A bucket's lock is
+   chosen by its index.  */
+#define SYMBOL_CACHE_NUM_SHARDS 16
 
 /* The maximum symbol cache size.
    There's no method to the decision of what value to use here, other than
@@ -152,6 +173,11 @@ struct symbol_cache_slot
 {
   enum symbol_cache_slot_state state;
 
+  /* Timestamp of the last hit or store, drawn from the cache's
+     NEXT_AGE counter.  The oldest slot of a bucket is the one that is
+     evicted.  */
+  unsigned int age;
+
   /* The objfile that was current when the symbol was looked up.
      This is only needed for global blocks, but for simplicity's sake
      we allocate the space for both.  If data shows the extra space used
@@ -196,11 +222,21 @@ symbol_cache_clear_slot (struct symbol_cache_slot *slot)
 
 struct block_symbol_cache
 {
-  unsigned int hits;
-  unsigned int misses;
-  unsigned int collisions;
-
-  /* SYMBOLS is a variable length array of this size.
+  /* The counters are atomic so that several threads can update them
+     concurrently; they are only statistics, so relaxed accuracy under
+     contention would be acceptable anyway.  The containing struct is
+     allocated with xcalloc, whose zero fill is a valid initial value
+     for these.  */
+  std::atomic<unsigned int> hits;
+  std::atomic<unsigned int> misses;
+  std::atomic<unsigned int> collisions;
+
+  /* Source of the age stamps recorded in the slots.  */
+  std::atomic<unsigned int> next_age;
+
+  /* SYMBOLS is a variable length array of this size.  The size is
+     always a multiple of SYMBOL_CACHE_ASSOC; each group of
+     SYMBOL_CACHE_ASSOC consecutive slots forms one bucket.
      One can imagine that in general one cache (global/static) should be a
      fraction of the size of the other, but there's no data at the moment
      on which to decide.  */
@@ -244,6 +280,15 @@ struct symbol_cache
 
   struct block_symbol_cache *global_symbols = nullptr;
   struct block_symbol_cache *static_symbols = nullptr;
+
+#if CXX_STD_THREAD
+  /* The buckets are striped over these locks so that several threads
+     can look up and record symbols concurrently.  A bucket's lock is
+     its index modulo SYMBOL_CACHE_NUM_SHARDS; the global and static
+     caches share the locks, which is harmless since the locks are
+     never nested.  */
+  std::mutex shards[SYMBOL_CACHE_NUM_SHARDS];
+#endif
 };
 
 /* Program space key for finding its symbol cache.  */
@@ -552,6 +597,178 @@ compare_glob_filenames_for_search (const char *filename,
   }
 }
 
+/* Return true if symtab S matches the search name NAME.  BASE_NAME is
+   lbasename (NAME), and REAL_PATH is as for
+   iterate_over_some_symtabs.  */
+
+static bool
+symtab_matches_filename (struct symtab *s, const char *name,
+			 const char *base_name, const char *real_path)
+{
+  if (compare_filenames_for_search (s->filename, name))
+    return true;
+
+  /* Before we invoke realpath, which can get expensive when many
+     files are involved, do a quick comparison of the basenames.  */
+  if (!basenames_may_differ
+      && FILENAME_CMP (base_name, lbasename (s->filename)) != 0)
+    return false;
+
+  if (compare_filenames_for_search (symtab_to_fullname (s), name))
+    return true;
+
+  /* If the user gave us an absolute path, try to find the file in
+     this symtab and use its absolute path.  */
+  if (real_path != NULL)
+    {
+      const char *fullname = symtab_to_fullname (s);
+
+      gdb_assert (IS_ABSOLUTE_PATH (real_path));
+      gdb_assert (IS_ABSOLUTE_PATH (name));
+      gdb::unique_xmalloc_ptr<char> fullname_real_path
+	= gdb_realpath (fullname);
+      if (FILENAME_CMP (real_path, fullname_real_path.get ()) == 0)
+	return true;
+    }
+
+  return false;
+}
+
+/* An entry in the filename index: all the expanded symtabs whose
+   filename has a given basename.  */
+
+struct filename_index_entry
+{
+  explicit filename_index_entry (const char *basename_)
+    : basename (basename_)
+  {}
+
+  /* The basename.  This points into a symtab's filename, which lives
+     at least as long as the index does.  */
+  const char *basename;
+
+  /* The symtabs, in the order they were indexed.  */
+  std::vector<symtab *> symtabs;
+};
+
+/* Hash function for the filename index, compatible with
+   FILENAME_CMP.  */
+
+static hashval_t
+hash_filename_index_entry (const void *p)
+{
+  return filename_hash (((const struct filename_index_entry *) p)->basename);
+}
+
+/* Equality function for the filename index.  */
+
+static int
+eq_filename_index_entry (const void *a, const void *b)
+{
+  return filename_eq (((const struct filename_index_entry *) a)->basename,
+		      ((const struct filename_index_entry *) b)->basename);
+}
+
+/* Deletion function for the filename index.  */
+
+static void
+delete_filename_index_entry (void *p)
+{
+  delete (struct filename_index_entry *) p;
+}
+
+/* A per-program-space index mapping basenames to expanded symtabs,
+   used by iterate_over_symtabs so that file lookups only compare the
+   symtabs whose basename matches, instead of walking every symtab of
+   every objfile.  The index is maintained incrementally: newly
+   expanded compunits are prepended to their objfile's list (see
+   add_compunit_symtab_to_objfile), so a rescan only has to visit the
+   compunits added since the last lookup.  The whole index is dropped
+   whenever the program space's objfiles change.  */
+
+struct filename_symtab_index
+{
+  filename_symtab_index ()
+    : table (htab_create_alloc (256, hash_filename_index_entry,
+				eq_filename_index_entry,
+				delete_filename_index_entry,
+				xcalloc, xfree))
+  {}
+
+  /* Map from basename to filename_index_entry.  */
+  htab_up table;
+
+  /* For each objfile, the head of its compunit list when it was last
+     scanned.  */
+  std::unordered_map<struct objfile *, struct compunit_symtab *> scanned;
+};
+
+/* Program space key for finding the filename index.  */
+
+static const registry<program_space>::key<filename_symtab_index>
+  filename_symtab_index_key;
+
+/* Add symtab S to INDEX.  */
+
+static void
+filename_index_add_symtab (struct filename_symtab_index *index,
+			   struct symtab *s)
+{
+  struct filename_index_entry search (lbasename (s->filename));
+  void **slot = htab_find_slot (index->table.get (), &search, INSERT);
+
+  if (*slot == NULL)
+    *slot = new filename_index_entry (search.basename);
+  ((struct filename_index_entry *) *slot)->symtabs.push_back (s);
+}
+
+/* Return the filename index of PSPACE, creating and updating it as
+   necessary.  */
+
+static struct filename_symtab_index *
+get_filename_symtab_index (struct program_space *pspace)
+{
+  struct filename_symtab_index *index
+    = filename_symtab_index_key.get (pspace);
+
+  if (index == NULL)
+    index = filename_symtab_index_key.emplace (pspace);
+
+  for (objfile *objfile : pspace->objfiles ())
+    {
+      auto it = index->scanned.find (objfile);
+      compunit_symtab *stop
+	= it == index->scanned.end () ? nullptr : it->second;
+
+      if (objfile->compunit_symtabs == stop)
+	continue;
+
+      for (compunit_symtab *cust = objfile->compunit_symtabs;
+	   cust != stop; cust = cust->next)
+	{
+	  /* Skip included compunits.  */
+	  if (cust->user != nullptr)
+	    continue;
+
+	  for (symtab *s : cust->filetabs ())
+	    filename_index_add_symtab (index, s);
+	}
+
+      index->scanned[objfile] = objfile->compunit_symtabs;
+    }
+
+  return index;
+}
+
+/* Drop the filename index of PSPACE.  This is called when the program
+   space's objfiles change.  */
+
+static void
+filename_symtab_index_flush (struct program_space *pspace)
+{
+  filename_symtab_index_key.clear (pspace);
+}
+
 /* Check for a symtab of a specific name by searching some symtabs.
    This is a helper function for callbacks of iterate_over_symtabs.
 
@@ -584,44 +801,9 @@ iterate_over_some_symtabs (const char *name,
 
       for (symtab *s : cust->filetabs ())
 	{
-	  if (compare_filenames_for_search (s->filename, name))
-	    {
-	      if (callback (s))
-		return true;
-	      continue;
-	    }
-
-	  /* Before we invoke realpath, which can get expensive when many
-	     files are involved, do a quick comparison of the basenames.  */
-	  if (! basenames_may_differ
-	      && FILENAME_CMP (base_name, lbasename (s->filename)) != 0)
-	    continue;
-
-	  if (compare_filenames_for_search (symtab_to_fullname (s), name))
-	    {
-	      if (callback (s))
-		return true;
-	      continue;
-	    }
-
-	  /* If the user gave us an absolute path, try to find the file in
-	     this symtab and use its absolute path.  */
-	  if (real_path != NULL)
-	    {
-	      const char *fullname = symtab_to_fullname (s);
-
-	      gdb_assert (IS_ABSOLUTE_PATH (real_path));
-	      gdb_assert (IS_ABSOLUTE_PATH (name));
-	      gdb::unique_xmalloc_ptr<char> fullname_real_path
-		= gdb_realpath (fullname);
-	      fullname = fullname_real_path.get ();
-	      if (FILENAME_CMP (real_path, fullname) == 0)
-		{
-		  if (callback (s))
-		    return true;
-		  continue;
-		}
-	    }
+	  if (symtab_matches_filename (s, name, base_name, real_path)
+	      && callback (s))
+	    return true;
 	}
     }
 
@@ -649,12 +831,42 @@ iterate_over_symtabs (const char *name,
       gdb_assert (IS_ABSOLUTE_PATH (real_path.get ()));
     }
 
-  for (objfile *objfile : current_program_space->objfiles ())
+  /* When basenames are reliable, consult the filename index so that
+     only the symtabs whose basename matches are compared, instead of
+     walking every symtab of every objfile.  */
+  if (!basenames_may_differ)
     {
-      if (iterate_over_some_symtabs (name, real_path.get (),
-				     objfile->compunit_symtabs, NULL,
-				     callback))
-	return;
+      struct filename_symtab_index *index
+	= get_filename_symtab_index (current_program_space);
+      struct filename_index_entry search (lbasename (name));
+      struct filename_index_entry *entry
+	= ((struct filename_index_entry *)
+	   htab_find (index->table.get (), &search));
+
+      if (entry != NULL)
+	{
+	  /* Iterate by position: the callback could expand further
+	     symtabs and grow the vector.  */
+	  for (size_t i = 0; i < entry->symtabs.size (); ++i)
+	    {
+	      symtab *s = entry->symtabs[i];
+
+	      if (symtab_matches_filename (s, name, search.basename,
+					   real_path.get ())
+		  && callback (s))
+		return;
+	    }
+	}
+    }
+  else
+    {
+      for (objfile *objfile : current_program_space->objfiles ())
+	{
+	  if (iterate_over_some_symtabs (name, real_path.get (),
+					 objfile->compunit_symtabs, NULL,
+					 callback))
+	    return;
+	}
     }
 
   /* Same search rules as above apply here, but now we look thru the
@@ -869,6 +1081,270 @@ free_demangled_name_entry (void *data)
   e->~demangled_name_entry();
 }
 
+/* On-disk cache of demangled names.
+
+   Demangling every symbol of a big C++ program is a sizable part of
+   symbol reading time, and the result depends only on the mangled
+   names, so it is shared across sessions through a file in the index
+   cache directory, keyed by the bfd's build-id.  The file layout is:
+
+     [0, 8)	magic ("GDBdmngl")
+     [8, 12)	format version (1)
+     [12, 16)	number of entries N
+     [16, 16 + 12 * N)
+		N records of three unsigned 32-bit words each: the
+		offset of the mangled name, the offset of the demangled
+		name (~0 if the name does not demangle), and the
+		language that was recorded for the entry
+     ...	string blob; the offsets above are relative to its
+		start, and every string is NUL-terminated
+
+   All words are little-endian, and the records are sorted by the
+   strcmp order of their mangled names, so that lookups can binary
+   search the file directly from the mapping.  */
+
+#define DEMANGLED_NAMES_CACHE_MAGIC "GDBdmngl"
+#define DEMANGLED_NAMES_CACHE_VERSION 1
+#define DEMANGLED_NAMES_CACHE_HEADER_SIZE 16
+#define DEMANGLED_NAMES_CACHE_RECORD_SIZE 12
+
+/* Read a 32-bit word of the demangled name cache.  */
+
+static uint32_t
+demangled_names_cache_get_u32 (const gdb_byte *p)
+{
+  return extract_unsigned_integer (p, 4, BFD_ENDIAN_LITTLE);
+}
+
+/* Append VAL to BUFFER as a 32-bit cache word.  */
+
+static void
+demangled_names_cache_put_u32 (std::vector<gdb_byte> &buffer, uint32_t val)
+{
+  size_t offset = buffer.size ();
+  buffer.resize (offset + 4);
+  store_unsigned_integer (buffer.data () + offset, 4, BFD_ENDIAN_LITTLE, val);
+}
+
+/* Try to load the on-disk demangled name cache for PER_BFD.  On
+   success, PER_BFD->demangled_names_cache is left referring to the
+   validated file contents.  */
+
+static void
+load_demangled_names_cache (objfile_per_bfd_storage *per_bfd)
+{
+  per_bfd->demangled_names_cache_checked = true;
+
+  if (per_bfd->get_bfd () == nullptr)
+    return;
+
+  const bfd_build_id *build_id = build_id_bfd_get (per_bfd->get_bfd ());
+  if (build_id == nullptr)
+    return;
+
+  gdb::array_view<const gdb_byte> contents
+    = global_index_cache.lookup_demangled_names
+	(build_id, &per_bfd->demangled_names_cache_resource);
+
+  /* Validate the file before trusting its offsets.  */
+  if (contents.size () < DEMANGLED_NAMES_CACHE_HEADER_SIZE
+      || memcmp (contents.data (), DEMANGLED_NAMES_CACHE_MAGIC, 8) != 0
+      || (demangled_names_cache_get_u32 (contents.data () + 8)
+	  != DEMANGLED_NAMES_CACHE_VERSION))
+    return;
+
+  size_t count = demangled_names_cache_get_u32 (contents.data () + 12);
+  size_t blob_offset = (DEMANGLED_NAMES_CACHE_HEADER_SIZE
+			+ count * DEMANGLED_NAMES_CACHE_RECORD_SIZE);
+  if (count == 0
+      || blob_offset >= contents.size ()
+      /* Every string in the blob is NUL-terminated, so in particular
+	 the file must end with a NUL.  */
+      || contents[contents.size () - 1] != '\0')
+    return;
+
+  per_bfd->demangled_names_cache = contents;
+  per_bfd->demangled_names_cache_count = count;
+}
+
+/* See symtab.h.  */
+
+void
+demangled_names_cache_preload (objfile_per_bfd_storage *per_bfd)
+{
+  if (!per_bfd->demangled_names_cache_checked)
+    load_demangled_names_cache (per_bfd);
+}
+
+/* See symtab.h.  */
+
+bool
+demangled_names_cache_find (objfile_per_bfd_storage *per_bfd,
+			    const char *mangled,
+			    gdb::unique_xmalloc_ptr<char> *demangled,
+			    enum language *lang)
+{
+  gdb::array_view<const gdb_byte> cache = per_bfd->demangled_names_cache;
+  if (cache.empty ())
+    return false;
+
+  size_t count = per_bfd->demangled_names_cache_count;
+  const gdb_byte *records = cache.data () + DEMANGLED_NAMES_CACHE_HEADER_SIZE;
+  size_t blob_offset = (DEMANGLED_NAMES_CACHE_HEADER_SIZE
+			+ count * DEMANGLED_NAMES_CACHE_RECORD_SIZE);
+  const char *blob = (const char *) cache.data () + blob_offset;
+  size_t blob_size = cache.size () - blob_offset;
+
+  size_t lo = 0;
+  size_t hi = count;
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+      const gdb_byte *rec = records + mid * DEMANGLED_NAMES_CACHE_RECORD_SIZE;
+      uint32_t mangled_offset = demangled_names_cache_get_u32 (rec);
+
+      if (mangled_offset >= blob_size)
+	{
+	  /* Corrupted file; pretend the name is not there.  The cache
+	     is not cleared here because this function can run on
+	     several threads at once.  */
+	  return false;
+	}
+
+      int cmp = strcmp (blob + mangled_offset, mangled);
+      if (cmp == 0)
+	{
+	  uint32_t demangled_offset = demangled_names_cache_get_u32 (rec + 4);
+	  uint32_t lang_word = demangled_names_cache_get_u32 (rec + 8);
+
+	  if (lang_word >= nr_languages
+	      || (demangled_offset != (uint32_t) -1
+		  && demangled_offset >= blob_size))
+	    return false;
+
+	  if (demangled_offset == (uint32_t) -1)
+	    demangled->reset (nullptr);
+	  else
+	    *demangled = make_unique_xstrdup (blob + demangled_offset);
+	  *lang = (enum language) lang_word;
+	  return true;
+	}
+      else if (cmp < 0)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  return false;
+}
+
+/* Write PER_BFD's demangled name hash table out to the on-disk cache,
+   if it has more entries than the cache file it was seeded from.  */
+
+static void
+store_demangled_names_cache (objfile_per_bfd_storage *per_bfd)
+{
+  if (per_bfd->demangled_names_hash == nullptr
+      || per_bfd->get_bfd () == nullptr)
+    return;
+
+  size_t count = htab_elements (per_bfd->demangled_names_hash.get ());
+  if (count == 0
+      || count <= per_bfd->demangled_names_cache_count
+      || count >= (uint32_t) -1)
+    return;
+
+  const bfd_build_id *build_id = build_id_bfd_get (per_bfd->get_bfd ());
+  if (build_id == nullptr)
+    return;
+
+  /* Collect the entries and sort them by mangled name.  The mangled
+     strings in the hash table are always NUL-terminated; see
+     compute_and_set_names.  */
+  std::vector<const demangled_name_entry *> entries;
+  entries.reserve (count);
+  htab_traverse_noresize (per_bfd->demangled_names_hash.get (),
+			  [] (void **slot, void *data) -> int
+			  {
+			    auto *vec
+			      = ((std::vector<const demangled_name_entry *> *)
+				 data);
+			    vec->push_back ((const demangled_name_entry *)
+					    *slot);
+			    return 1;
+			  },
+			  &entries);
+  std::sort (entries.begin (), entries.end (),
+	     [] (const demangled_name_entry *a, const demangled_name_entry *b)
+	     {
+	       return strcmp (a->mangled.data (), b->mangled.data ()) < 0;
+	     });
+
+  std::vector<gdb_byte> buffer;
+  std::vector<gdb_byte> blob;
+
+  buffer.reserve (DEMANGLED_NAMES_CACHE_HEADER_SIZE
+		  + count * DEMANGLED_NAMES_CACHE_RECORD_SIZE);
+  buffer.insert (buffer.end (), DEMANGLED_NAMES_CACHE_MAGIC,
+		 DEMANGLED_NAMES_CACHE_MAGIC + 8);
+  demangled_names_cache_put_u32 (buffer, DEMANGLED_NAMES_CACHE_VERSION);
+  demangled_names_cache_put_u32 (buffer, count);
+
+  for (const demangled_name_entry *entry : entries)
+    {
+      const char *mangled = entry->mangled.data ();
+      size_t mangled_offset = blob.size ();
+      blob.insert (blob.end (), mangled, mangled + strlen (mangled) + 1);
+
+      size_t demangled_offset = (size_t) (uint32_t) -1;
+      if (entry->demangled != nullptr)
+	{
+	  const char *demangled = entry->demangled.get ();
+	  demangled_offset = blob.size ();
+	  blob.insert (blob.end (), demangled,
+		       demangled + strlen (demangled) + 1);
+	}
+
+      if (blob.size () >= (uint32_t) -1)
+	{
+	  /* Too big for the 32-bit offsets; don't cache.  */
+	  return;
+	}
+
+      demangled_names_cache_put_u32 (buffer, mangled_offset);
+      demangled_names_cache_put_u32 (buffer, demangled_offset);
+      demangled_names_cache_put_u32 (buffer, entry->language);
+    }
+
+  buffer.insert (buffer.end (), blob.begin (), blob.end ());
+  global_index_cache.store_demangled_names (build_id, buffer);
+
+  /* Remember what was written, in case this per-BFD is visited again
+     before GDB exits.  */
+  per_bfd->demangled_names_cache_count = count;
+}
+
+/* Write out the demangled name caches of all objfiles when GDB exits.
+   This is done once at exit rather than when each objfile goes away so
+   that repeatedly re-run programs do not rewrite the same file over
+   and over in a single session.  */
+
+static void
+symtab_store_demangled_names_caches (int)
+{
+  if (!global_index_cache.enabled ())
+    return;
+
+  /* Several objfiles (e.g. in different program spaces) can share a
+     per-BFD object, so visit each one only once.  */
+  std::unordered_set<objfile_per_bfd_storage *> seen;
+
+  for (struct program_space *pspace : program_spaces)
+    for (objfile *objf : pspace->objfiles ())
+      if (objf->per_bfd != nullptr && seen.insert (objf->per_bfd).second)
+	store_demangled_names_cache (objf->per_bfd);
+}
+
 /* Create the hash table used for demangled names.  Each hash entry is
    a pair of strings; one for the mangled name and one for the demangled
    name.  The entry is hashed via just the mangled name.  */
@@ -1005,8 +1481,22 @@ general_symbol_info::compute_and_set_names (gdb::string_view linkage_name,
 	linkage_name_copy = linkage_name;
 
       if (demangled_name.get () == nullptr)
-	 demangled_name
-	   = symbol_find_demangled_name (this, linkage_name_copy.data ());
+	{
+	  /* Consult the on-disk cache before demangling from
+	     scratch.  */
+	  enum language cached_lang;
+	  demangled_names_cache_preload (per_bfd);
+	  if (demangled_names_cache_find (per_bfd,
+					  linkage_name_copy.data (),
+					  &demangled_name, &cached_lang))
+	    {
+	      if (language () == language_unknown)
+		m_language = cached_lang;
+	    }
+	  else
+	    demangled_name
+	      = symbol_find_demangled_name (this, linkage_name_copy.data ());
+	}
 
       /* Suppose we have demangled_name==NULL, copy_name==0, and
 	 linkage_name_copy==linkage_name.  In this case, we already have the
@@ -1310,6 +1800,11 @@ symbol_cache_byte_size (unsigned int size)
 static void
 resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
 {
+  /* Round up to a whole number of buckets.  */
+  if (new_size != 0)
+    new_size = ((new_size + SYMBOL_CACHE_ASSOC - 1)
+		/ SYMBOL_CACHE_ASSOC * SYMBOL_CACHE_ASSOC);
+
   /* If there's no change in size, don't do anything.
      All caches have the same size, so we can just compare with the size
      of the global symbols cache.  */
@@ -1423,26 +1918,55 @@ symbol_cache_lookup (struct symbol_cache *cache,
     }
 
   hash = hash_symbol_entry (objfile_context, name, domain);
-  slot = bsc->symbols + hash % bsc->size;
+
+  unsigned int bucket = hash % (bsc->size / SYMBOL_CACHE_ASSOC);
+  slot = bsc->symbols + bucket * SYMBOL_CACHE_ASSOC;
 
   *bsc_ptr = bsc;
-  *slot_ptr = slot;
 
-  if (eq_symbol_entry (slot, objfile_context, name, domain))
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard
+    (cache->shards[bucket % SYMBOL_CACHE_NUM_SHARDS]);
+#endif
+
+  /* Probe the ways of the bucket, remembering the best eviction
+     victim as we go: an unused slot if there is one, else the least
+     recently used slot.  */
+  struct symbol_cache_slot *victim = slot;
+  for (unsigned int way = 0; way < SYMBOL_CACHE_ASSOC; ++way)
     {
-      symbol_lookup_debug_printf ("%s block symbol cache hit%s for %s, %s",
-				  block == GLOBAL_BLOCK ? "Global" : "Static",
-				  slot->state == SYMBOL_SLOT_NOT_FOUND
-				  ? " (not found)" : "", name,
-				  domain_name (domain));
-      ++bsc->hits;
-      if (slot->state == SYMBOL_SLOT_NOT_FOUND)
-	return SYMBOL_LOOKUP_FAILED;
-      return slot->value.found;
+      struct symbol_cache_slot *probe = slot + way;
+
+      if (eq_symbol_entry (probe, objfile_context, name, domain))
+	{
+	  symbol_lookup_debug_printf
+	    ("%s block symbol cache hit%s for %s, %s",
+	     block == GLOBAL_BLOCK ? "Global" : "Static",
+	     probe->state == SYMBOL_SLOT_NOT_FOUND
+	     ? " (not found)" : "", name,
+	     domain_name (domain));
+	  ++bsc->hits;
+	  probe->age = ++bsc->next_age;
+	  *slot_ptr = probe;
+	  if (probe->state == SYMBOL_SLOT_NOT_FOUND)
+	    return SYMBOL_LOOKUP_FAILED;
+	  return probe->value.found;
+	}
+
+      if (probe->state == SYMBOL_SLOT_UNUSED)
+	{
+	  if (victim->state != SYMBOL_SLOT_UNUSED)
+	    victim = probe;
+	}
+      else if (victim->state != SYMBOL_SLOT_UNUSED
+	       && probe->age < victim->age)
+	victim = probe;
     }
 
   /* Symbol is not present in the cache.  */
 
+  *slot_ptr = victim;
+
   symbol_lookup_debug_printf ("%s block symbol cache miss for %s, %s",
 			      block == GLOBAL_BLOCK ? "Global" : "Static",
 			      name, domain_name (domain));
@@ -1456,7 +1980,8 @@ symbol_cache_lookup (struct symbol_cache *cache,
    necessarily the objfile the symbol was found in.  */
 
 static void
-symbol_cache_mark_found (struct block_symbol_cache *bsc,
+symbol_cache_mark_found (struct symbol_cache *cache,
+			 struct block_symbol_cache *bsc,
 			 struct symbol_cache_slot *slot,
 			 struct objfile *objfile_context,
 			 struct symbol *symbol,
@@ -1464,12 +1989,20 @@ symbol_cache_mark_found (struct block_symbol_cache *bsc,
 {
   if (bsc == NULL)
     return;
+
+#if CXX_STD_THREAD
+  size_t bucket = (slot - bsc->symbols) / SYMBOL_CACHE_ASSOC;
+  std::lock_guard<std::mutex> guard
+    (cache->shards[bucket % SYMBOL_CACHE_NUM_SHARDS]);
+#endif
+
   if (slot->state != SYMBOL_SLOT_UNUSED)
     {
       ++bsc->collisions;
       symbol_cache_clear_slot (slot);
     }
   slot->state = SYMBOL_SLOT_FOUND;
+  slot->age = ++bsc->next_age;
   slot->objfile_context = objfile_context;
   slot->value.found.symbol = symbol;
   slot->value.found.block = block;
@@ -1480,19 +2013,28 @@ symbol_cache_mark_found (struct block_symbol_cache *bsc,
    if it's not needed to distinguish lookups (STATIC_BLOCK).  */
 
 static void
-symbol_cache_mark_not_found (struct block_symbol_cache *bsc,
+symbol_cache_mark_not_found (struct symbol_cache *cache,
+			     struct block_symbol_cache *bsc,
 			     struct symbol_cache_slot *slot,
 			     struct objfile *objfile_context,
 			     const char *name, domain_enum domain)
 {
   if (bsc == NULL)
     return;
+
+#if CXX_STD_THREAD
+  size_t bucket = (slot - bsc->symbols) / SYMBOL_CACHE_ASSOC;
+  std::lock_guard<std::mutex> guard
+    (cache->shards[bucket % SYMBOL_CACHE_NUM_SHARDS]);
+#endif
+
   if (slot->state != SYMBOL_SLOT_UNUSED)
     {
       ++bsc->collisions;
       symbol_cache_clear_slot (slot);
     }
   slot->state = SYMBOL_SLOT_NOT_FOUND;
+  slot->age = ++bsc->next_age;
   slot->objfile_context = objfile_context;
   slot->value.not_found.name = xstrdup (name);
   slot->value.not_found.domain = domain;
@@ -1522,8 +2064,18 @@ symbol_cache_flush (struct program_space *pspace)
       && cache->static_symbols->misses == 0)
     return;
 
-  gdb_assert (cache->global_symbols->size == symbol_cache_size);
-  gdb_assert (cache->static_symbols->size == symbol_cache_size);
+  /* The sizes requested by the user are rounded up to whole buckets,
+     so only check that the two caches agree.  */
+  gdb_assert (cache->global_symbols->size == cache->static_symbols->size);
+
+#if CXX_STD_THREAD
+  /* Hold all the shard locks while clearing.  They are always taken
+     in index order, so this cannot deadlock.  */
+  std::vector<std::unique_lock<std::mutex>> guards;
+  guards.reserve (SYMBOL_CACHE_NUM_SHARDS);
+  for (std::mutex &shard : cache->shards)
+    guards.emplace_back (shard);
+#endif
 
   for (pass = 0; pass < 2; ++pass)
     {
@@ -1538,15 +2090,17 @@ symbol_cache_flush (struct program_space *pspace)
   cache->global_symbols->hits = 0;
   cache->global_symbols->misses = 0;
   cache->global_symbols->collisions = 0;
+  cache->global_symbols->next_age = 0;
   cache->static_symbols->hits = 0;
   cache->static_symbols->misses = 0;
   cache->static_symbols->collisions = 0;
+  cache->static_symbols->next_age = 0;
 }
 
 /* Dump CACHE.  */
 
 static void
-symbol_cache_dump (const struct symbol_cache *cache)
+symbol_cache_dump (struct symbol_cache *cache)
 {
   int pass;
 
@@ -1556,6 +2110,13 @@ symbol_cache_dump (const struct symbol_cache *cache)
       return;
     }
 
+#if CXX_STD_THREAD
+  std::vector<std::unique_lock<std::mutex>> guards;
+  guards.reserve (SYMBOL_CACHE_NUM_SHARDS);
+  for (std::mutex &shard : cache->shards)
+    guards.emplace_back (shard);
+#endif
+
   for (pass = 0; pass < 2; ++pass)
     {
       const struct block_symbol_cache *bsc
@@ -1660,9 +2221,9 @@ symbol_cache_stats (struct symbol_cache *cache)
 	gdb_printf ("Static block cache stats:\n");
 
       gdb_printf ("  size:       %u\n", bsc->size);
-      gdb_printf ("  hits:       %u\n", bsc->hits);
-      gdb_printf ("  misses:     %u\n", bsc->misses);
-      gdb_printf ("  collisions: %u\n", bsc->collisions);
+      gdb_printf ("  hits:       %u\n", bsc->hits.load ());
+      gdb_printf ("  misses:     %u\n", bsc->misses.load ());
+      gdb_printf ("  collisions: %u\n", bsc->collisions.load ());
     }
 }
 
@@ -1696,6 +2257,7 @@ static void
 symtab_new_objfile_observer (struct objfile *objfile)
 {
   symbol_cache_flush (objfile->pspace);
+  filename_symtab_index_flush (objfile->pspace);
 }
 
 /* This module's 'all_objfiles_removed' observer.  */
@@ -1704,6 +2266,7 @@ static void
 symtab_all_objfiles_removed (program_space *pspace)
 {
   symbol_cache_flush (pspace);
+  filename_symtab_index_flush (pspace);
 
   /* Forget everything we know about the main function.  */
   set_main_name (pspace, nullptr, language_unknown);
@@ -1715,6 +2278,7 @@ static void
 symtab_free_objfile_observer (struct objfile *objfile)
 {
   symbol_cache_flush (objfile->pspace);
+  filename_symtab_index_flush (objfile->pspace);
 }
 
 /* See symtab.h.  */
@@ -1948,6 +2512,7 @@ lookup_symbol_in_language (const char *name, const struct block *block,
 			   struct field_of_this_result *is_a_field_of_this)
 {
   SYMBOL_LOOKUP_SCOPED_DEBUG_ENTER_EXIT;
+  scoped_command_time time_category (COMMAND_TIME_SYMBOL_LOOKUP);
 
   demangle_result_storage storage;
   const char *modified_name = demangle_for_lookup (name, lang, storage);
@@ -2592,9 +3157,10 @@ lookup_global_or_static_symbol (const char *name,
        objfile);
 
   if (result.symbol != NULL)
-    symbol_cache_mark_found (bsc, slot, objfile, result.symbol, result.block);
+    symbol_cache_mark_found (cache, bsc, slot, objfile, result.symbol,
+			     result.block);
   else
-    symbol_cache_mark_not_found (bsc, slot, objfile, name, domain);
+    symbol_cache_mark_not_found (cache, bsc, slot, objfile, name, domain);
 
   return result;
 }
@@ -2950,6 +3516,27 @@ find_pc_compunit_symtab (CORE_ADDR pc)
 
 /* See symtab.h.  */
 
+void
+expand_symtabs_for_pcs (gdb::array_view<const CORE_ADDR> pcs)
+{
+  /* Group the PCs by objfile so that each symbol reader sees its PCs
+     as a single batch.  */
+  std::unordered_map<struct objfile *, std::vector<CORE_ADDR>> by_objfile;
+
+  for (CORE_ADDR pc : pcs)
+    {
+      struct obj_section *section = find_pc_mapped_section (pc);
+
+      if (section != nullptr && section->objfile != nullptr)
+	by_objfile[section->objfile].push_back (pc);
+    }
+
+  for (auto &iter : by_objfile)
+    iter.first->expand_symtabs_for_pcs (iter.second);
+}
+
+/* See symtab.h.  */
+
 struct symbol *
 find_symbol_at_address (CORE_ADDR address)
 {
@@ -4873,14 +5460,11 @@ global_symbol_searcher::add_matching_msymbols
 
 /* See symtab.h.  */
 
-std::vector<symbol_search>
-global_symbol_searcher::search () const
+void
+global_symbol_searcher::compile_regexps
+	(gdb::optional<compiled_regex> *preg,
+	 gdb::optional<compiled_regex> *treg) const
 {
-  gdb::optional<compiled_regex> preg;
-  gdb::optional<compiled_regex> treg;
-
-  gdb_assert (m_kind != ALL_DOMAIN);
-
   if (m_symbol_name_regexp != NULL)
     {
       const char *symbol_name_regexp = m_symbol_name_regexp;
@@ -4921,17 +5505,30 @@ global_symbol_searcher::search () const
 
       int cflags = REG_NOSUB | (case_sensitivity == case_sensitive_off
 				? REG_ICASE : 0);
-      preg.emplace (symbol_name_regexp, cflags,
-		    _("Invalid regexp"));
+      preg->emplace (symbol_name_regexp, cflags,
+		     _("Invalid regexp"));
     }
 
   if (m_symbol_type_regexp != NULL)
     {
       int cflags = REG_NOSUB | (case_sensitivity == case_sensitive_off
 				? REG_ICASE : 0);
-      treg.emplace (m_symbol_type_regexp, cflags,
-		    _("Invalid regexp"));
+      treg->emplace (m_symbol_type_regexp, cflags,
+		     _("Invalid regexp"));
     }
+}
+
+/* See symtab.h.  */
+
+std::vector<symbol_search>
+global_symbol_searcher::search () const
+{
+  gdb::optional<compiled_regex> preg;
+  gdb::optional<compiled_regex> treg;
+
+  gdb_assert (m_kind != ALL_DOMAIN);
+
+  compile_regexps (&preg, &treg);
 
   bool found_msymbol = false;
   std::set<symbol_search> result_set;
@@ -4972,6 +5569,75 @@ global_symbol_searcher::search () const
 
 /* See symtab.h.  */
 
+void
+global_symbol_searcher::search_each
+	(gdb::function_view<bool (const symbol_search &)> callback) const
+{
+  gdb::optional<compiled_regex> preg;
+  gdb::optional<compiled_regex> treg;
+
+  gdb_assert (m_kind != ALL_DOMAIN);
+
+  compile_regexps (&preg, &treg);
+
+  /* The per-objfile result sets below are each capped at
+     M_MAX_SEARCH_RESULTS by the add_matching_* functions; REMAINING
+     enforces the limit across objfiles.  */
+  size_t remaining = m_max_search_results;
+
+  bool found_msymbol = false;
+  std::set<symbol_search> result_set;
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      /* Expand symtabs within objfile that possibly contain matching
+	 symbols.  */
+      found_msymbol |= expand_symtabs (objfile, preg);
+
+      /* Find matching symbols within OBJFILE and deliver them right
+	 away, in the sorted order provided by the set, rather than
+	 accumulating every objfile's matches for a global sort.  */
+      bool more = add_matching_symbols (objfile, preg, treg, &result_set);
+      for (const symbol_search &ss : result_set)
+	{
+	  if (remaining == 0 || !callback (ss))
+	    return;
+	  remaining--;
+	}
+      result_set.clear ();
+
+      if (!more)
+	return;
+    }
+
+  /* If there are no debug symbols, then add matching minsyms.  But if the
+     user wants to see symbols matching a type regexp, then never give a
+     minimal symbol, as we assume that a minimal symbol does not have a
+     type.  */
+  if ((found_msymbol || (filenames.empty () && m_kind == VARIABLES_DOMAIN))
+      && !m_exclude_minsyms
+      && !treg.has_value ())
+    {
+      gdb_assert (m_kind == VARIABLES_DOMAIN || m_kind == FUNCTIONS_DOMAIN);
+      std::vector<symbol_search> msym_results;
+      for (objfile *objfile : current_program_space->objfiles ())
+	{
+	  bool more = add_matching_msymbols (objfile, preg, &msym_results);
+	  for (const symbol_search &ss : msym_results)
+	    {
+	      if (remaining == 0 || !callback (ss))
+		return;
+	      remaining--;
+	    }
+	  msym_results.clear ();
+
+	  if (!more)
+	    return;
+	}
+    }
+}
+
+/* See symtab.h.  */
+
 std::string
 symbol_to_info_string (struct symbol *sym, int block,
 		       enum search_domain kind)
@@ -5092,12 +5758,18 @@ print_msymbol_info (struct bound_minimal_symbol msymbol)
 /* This is the guts of the commands "info functions", "info types", and
    "info variables".  It calls search_symbols to find all matches and then
    print_[m]symbol_info to print out some useful information about the
-   matches.  */
+   matches.  LIMIT caps the number of symbols printed; UINT_MAX means no
+   limit.  When STREAM is true the results are printed incrementally, one
+   objfile at a time, instead of being collected and sorted globally
+   first; this bounds the memory used and gets the first line of output
+   out quickly, at the cost of the output only being sorted within each
+   objfile.  */
 
 static void
 symtab_symbol_info (bool quiet, bool exclude_minsyms,
 		    const char *regexp, enum search_domain kind,
-		    const char *t_regexp, int from_tty)
+		    const char *t_regexp, unsigned int limit,
+		    bool stream, int from_tty)
 {
   static const char * const classnames[] =
     {"variable", "function", "type", "module"};
@@ -5112,10 +5784,14 @@ symtab_symbol_info (bool quiet, bool exclude_minsyms,
   global_symbol_searcher spec (kind, regexp);
   spec.set_symbol_type_regexp (t_regexp);
   spec.set_exclude_minsyms (exclude_minsyms);
-  std::vector<symbol_search> symbols = spec.search ();
+  if (limit != UINT_MAX)
+    spec.set_max_search_results (limit);
 
-  if (!quiet)
+  auto print_header = [&] ()
     {
+      if (quiet)
+	return;
+
       if (regexp != NULL)
 	{
 	  if (t_regexp != NULL)
@@ -5137,9 +5813,9 @@ symtab_symbol_info (bool quiet, bool exclude_minsyms,
 	  else
 	    gdb_printf (_("All defined %ss:\n"), classnames[kind]);
 	}
-    }
+    };
 
-  for (const symbol_search &p : symbols)
+  auto print_one = [&] (const symbol_search &p)
     {
       QUIT;
 
@@ -5162,18 +5838,37 @@ symtab_symbol_info (bool quiet, bool exclude_minsyms,
 	  last_filename
 	    = symtab_to_filename_for_display (p.symbol->symtab ());
 	}
+      return true;
+    };
+
+  if (stream)
+    {
+      /* Print the header up front; in streaming mode we do not want to
+	 wait for the whole search before the first line of output.  */
+      print_header ();
+      spec.search_each (print_one);
+    }
+  else
+    {
+      std::vector<symbol_search> symbols = spec.search ();
+
+      print_header ();
+      for (const symbol_search &p : symbols)
+	print_one (p);
     }
 }
 
 /* Structure to hold the values of the options used by the 'info variables'
-   and 'info functions' commands.  These correspond to the -q, -t, and -n
-   options.  */
+   and 'info functions' commands.  These correspond to the -q, -t, -n,
+   -limit, and -stream options.  */
 
 struct info_vars_funcs_options
 {
   bool quiet = false;
   bool exclude_minsyms = false;
   std::string type_regexp;
+  unsigned int limit = UINT_MAX;
+  bool stream = false;
 };
 
 /* The options used by the 'info variables' and 'info functions'
@@ -5199,6 +5894,21 @@ static const gdb::option::option_def info_vars_funcs_options_defs[] = {
     [] (info_vars_funcs_options *opt) { return &opt->type_regexp; },
     nullptr, /* show_cmd_cb */
     nullptr /* set_doc */
+  },
+
+  gdb::option::uinteger_option_def<info_vars_funcs_options> {
+    "limit",
+    [] (info_vars_funcs_options *opt) { return &opt->limit; },
+    uinteger_unlimited_literals,
+    nullptr, /* show_cmd_cb */
+    nullptr /* set_doc */
+  },
+
+  gdb::option::boolean_option_def<info_vars_funcs_options> {
+    "stream",
+    [] (info_vars_funcs_options *opt) { return &opt->stream; },
+    nullptr, /* show_cmd_cb */
+    nullptr /* set_doc */
   }
 };
 
@@ -5243,7 +5953,7 @@ info_variables_command (const char *args, int from_tty)
   symtab_symbol_info
     (opts.quiet, opts.exclude_minsyms, args, VARIABLES_DOMAIN,
      opts.type_regexp.empty () ? nullptr : opts.type_regexp.c_str (),
-     from_tty);
+     opts.limit, opts.stream, from_tty);
 }
 
 /* Implement the 'info functions' command.  */
@@ -5262,17 +5972,20 @@ info_functions_command (const char *args, int from_tty)
   symtab_symbol_info
     (opts.quiet, opts.exclude_minsyms, args, FUNCTIONS_DOMAIN,
      opts.type_regexp.empty () ? nullptr : opts.type_regexp.c_str (),
-     from_tty);
+     opts.limit, opts.stream, from_tty);
 }
 
-/* Holds the -q option for the 'info types' command.  */
+/* Holds the -q, -limit and -stream options for the 'info types' and
+   'info modules' commands.  */
 
 struct info_types_options
 {
   bool quiet = false;
+  unsigned int limit = UINT_MAX;
+  bool stream = false;
 };
 
-/* The options used by the 'info types' command.  */
+/* The options used by the 'info types' and 'info modules' commands.  */
 
 static const gdb::option::option_def info_types_options_defs[] = {
   gdb::option::boolean_option_def<info_types_options> {
@@ -5280,6 +5993,21 @@ static const gdb::option::option_def info_types_options_defs[] = {
     [] (info_types_options *opt) { return &opt->quiet; },
     nullptr, /* show_cmd_cb */
     nullptr /* set_doc */
+  },
+
+  gdb::option::uinteger_option_def<info_types_options> {
+    "limit",
+    [] (info_types_options *opt) { return &opt->limit; },
+    uinteger_unlimited_literals,
+    nullptr, /* show_cmd_cb */
+    nullptr /* set_doc */
+  },
+
+  gdb::option::boolean_option_def<info_types_options> {
+    "stream",
+    [] (info_types_options *opt) { return &opt->stream; },
+    nullptr, /* show_cmd_cb */
+    nullptr /* set_doc */
   }
 };
 
@@ -5303,7 +6031,8 @@ info_types_command (const char *args, int from_tty)
     (&args, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_OPERAND, grp);
   if (args != nullptr && *args == '\0')
     args = nullptr;
-  symtab_symbol_info (opts.quiet, false, args, TYPES_DOMAIN, NULL, from_tty);
+  symtab_symbol_info (opts.quiet, false, args, TYPES_DOMAIN, NULL,
+		      opts.limit, opts.stream, from_tty);
 }
 
 /* Command completer for 'info types' command.  */
@@ -5336,7 +6065,7 @@ info_modules_command (const char *args, int from_tty)
   if (args != nullptr && *args == '\0')
     args = nullptr;
   symtab_symbol_info (opts.quiet, true, args, MODULES_DOMAIN, NULL,
-		      from_tty);
+		      opts.limit, opts.stream, from_tty);
 }
 
 /* Implement the 'info main' command.  */
@@ -5745,6 +6474,9 @@ add_symtab_completions (struct compunit_symtab *cust,
       const struct block *b = cust->blockvector ()->block (i);
       for (struct symbol *sym : block_iterator_range (b))
 	{
+	  if (tracker.full ())
+	    return;
+
 	  if (completion_skip_symbol (mode, sym))
 	    continue;
 
@@ -5843,6 +6575,9 @@ default_collect_symbol_completion_matches_break_on
 	    {
 	      QUIT;
 
+	      if (tracker.full ())
+		return;
+
 	      if (completion_skip_symbol (mode, msymbol))
 		continue;
 
@@ -5864,19 +6599,24 @@ default_collect_symbol_completion_matches_break_on
     }
 
   /* Look through the partial symtabs for all symbols which begin by
-     matching SYM_TEXT.  Expand all CUs that you find to the list.  */
-  expand_symtabs_matching (NULL,
-			   lookup_name,
-			   NULL,
-			   [&] (compunit_symtab *symtab) /* expansion notify */
-			     {
-			       add_symtab_completions (symtab,
-						       tracker, mode, lookup_name,
-						       sym_text, word, code);
-			       return true;
-			     },
-			   SEARCH_GLOBAL_BLOCK | SEARCH_STATIC_BLOCK,
-			   ALL_DOMAIN);
+     matching SYM_TEXT.  Expand all CUs that you find to the list.
+     Stop expanding as soon as the tracker is full; there is no point
+     reading in symtabs whose contents could not be reported
+     anyway.  */
+  if (!tracker.full ())
+    expand_symtabs_matching (NULL,
+			     lookup_name,
+			     NULL,
+			     [&] (compunit_symtab *symtab) /* expansion notify */
+			       {
+				 add_symtab_completions (symtab,
+							 tracker, mode,
+							 lookup_name,
+							 sym_text, word, code);
+				 return !tracker.full ();
+			       },
+			     SEARCH_GLOBAL_BLOCK | SEARCH_STATIC_BLOCK,
+			     ALL_DOMAIN);
 
   /* Search upwards from currently selected frame (so that we can
      complete on local vars).  Also catch fields of types defined in
@@ -6901,8 +7641,13 @@ _initialize_symtab ()
   c = add_info ("variables", info_variables_command,
 		info_print_args_help (_("\
 All global and static variable names or those matching REGEXPs.\n\
-Usage: info variables [-q] [-n] [-t TYPEREGEXP] [NAMEREGEXP]\n\
-Prints the global and static variables.\n"),
+Usage: info variables [-q] [-n] [-limit LIMIT] [-stream] [-t TYPEREGEXP]\n\
+       [NAMEREGEXP]\n\
+Prints the global and static variables.\n\
+The -limit flag caps the number of variables printed; LIMIT can be\n\
+\"unlimited\".  The -stream flag prints results objfile by objfile as\n\
+they are found, instead of sorting them globally first; this bounds\n\
+memory usage when the result list is very large.\n"),
 				      _("global and static variables"),
 				      true));
   set_cmd_completer_handle_brkchars (c, info_vars_funcs_command_completer);
@@ -6910,17 +7655,25 @@ Prints the global and static variables.\n"),
   c = add_info ("functions", info_functions_command,
 		info_print_args_help (_("\
 All function names or those matching REGEXPs.\n\
-Usage: info functions [-q] [-n] [-t TYPEREGEXP] [NAMEREGEXP]\n\
-Prints the functions.\n"),
+Usage: info functions [-q] [-n] [-limit LIMIT] [-stream] [-t TYPEREGEXP]\n\
+       [NAMEREGEXP]\n\
+Prints the functions.\n\
+The -limit flag caps the number of functions printed; LIMIT can be\n\
+\"unlimited\".  The -stream flag prints results objfile by objfile as\n\
+they are found, instead of sorting them globally first; this bounds\n\
+memory usage when the result list is very large.\n"),
 				      _("functions"),
 				      true));
   set_cmd_completer_handle_brkchars (c, info_vars_funcs_command_completer);
 
   c = add_info ("types", info_types_command, _("\
 All type names, or those matching REGEXP.\n\
-Usage: info types [-q] [REGEXP]\n\
+Usage: info types [-q] [-limit LIMIT] [-stream] [REGEXP]\n\
 Print information about all types matching REGEXP, or all types if no\n\
-REGEXP is given.  The optional flag -q disables printing of headers."));
+REGEXP is given.  The optional flag -q disables printing of headers.\n\
+The -limit flag caps the number of types printed; LIMIT can be\n\
+\"unlimited\".  The -stream flag prints results objfile by objfile as\n\
+they are found, instead of sorting them globally first."));
   set_cmd_completer_handle_brkchars (c, info_types_command_completer);
 
   const auto info_sources_opts
@@ -7072,4 +7825,6 @@ the use of prologue scanners."),
   gdb::observers::all_objfiles_removed.attach (symtab_all_objfiles_removed,
 					       "symtab");
   gdb::observers::free_objfile.attach (symtab_free_objfile_observer, "symtab");
+  gdb::observers::gdb_exiting.attach (symtab_store_demangled_names_caches,
+				      "symtab");
 }
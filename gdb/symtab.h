@@ -45,6 +45,7 @@ class frame_info_ptr;
 struct symbol;
 struct obstack;
 struct objfile;
+struct objfile_per_bfd_storage;
 struct block;
 struct blockvector;
 struct axs_value;
@@ -647,6 +648,24 @@ extern CORE_ADDR get_symbol_address (const struct symbol *sym);
 extern gdb::unique_xmalloc_ptr<char> symbol_find_demangled_name
      (struct general_symbol_info *gsymbol, const char *mangled);
 
+/* Make sure the on-disk demangled name cache for PER_BFD, if there is
+   one, has been looked up and mapped.  This must be called (once, on
+   the main thread) before demangled_names_cache_find may be used.  */
+
+extern void demangled_names_cache_preload (objfile_per_bfd_storage *per_bfd);
+
+/* Look up MANGLED in the on-disk demangled name cache for PER_BFD.
+   If an entry is found, return true and set *DEMANGLED (to nullptr if
+   the cached entry says the name does not demangle) and *LANG.  This
+   only reads the mapped cache file, so after a call to
+   demangled_names_cache_preload it is safe to use from multiple
+   threads concurrently.  */
+
+extern bool demangled_names_cache_find (objfile_per_bfd_storage *per_bfd,
+					const char *mangled,
+					gdb::unique_xmalloc_ptr<char> *demangled,
+					enum language *lang);
+
 /* Return true if NAME matches the "search" name of GSYMBOL, according
    to the symbol's language.  */
 extern bool symbol_matches_search_name
@@ -1800,6 +1819,15 @@ using symtab_range = next_range<symtab>;
    where "foo.c(cu)" and "bar.c(cu)" are struct compunit_symtab objects,
    and the files foo.c, etc. are struct symtab objects.  */
 
+struct compunit_symtab;
+
+/* A function used to compute the macro table of a compunit_symtab the
+   first time it is requested.  See
+   compunit_symtab::set_lazy_macro_table.  */
+
+typedef struct macro_table *(*lazy_compute_macros_fn)
+  (struct compunit_symtab *cust, void *datum);
+
 struct compunit_symtab
 {
   struct objfile *objfile () const
@@ -1896,8 +1924,16 @@ struct compunit_symtab
     m_epilogue_unwind_valid = epilogue_unwind_valid;
   }
 
-  struct macro_table *macro_table () const
+  struct macro_table *macro_table ()
   {
+    if (m_macro_table == nullptr && m_lazy_macros_fn != nullptr)
+      {
+	/* Clear the function first so that it is called at most
+	   once, even if it returns NULL.  */
+	lazy_compute_macros_fn fn = m_lazy_macros_fn;
+	m_lazy_macros_fn = nullptr;
+	m_macro_table = fn (this, m_lazy_macros_datum);
+      }
     return m_macro_table;
   }
 
@@ -1906,6 +1942,17 @@ struct compunit_symtab
     m_macro_table = macro_table;
   }
 
+  /* Arrange for FN (this, DATUM) to supply this compunit's macro
+     table the first time it is requested.  FN is only called if no
+     macro table has been set by then.  This lets debug readers defer
+     reading macro information until it is actually used.  */
+
+  void set_lazy_macro_table (lazy_compute_macros_fn fn, void *datum)
+  {
+    m_lazy_macros_fn = fn;
+    m_lazy_macros_datum = datum;
+  }
+
   /* Make PRIMARY_FILETAB the primary filetab of this compunit symtab.
 
      PRIMARY_FILETAB must already be a filetab of this compunit symtab.  */
@@ -1982,6 +2029,12 @@ struct compunit_symtab
      the given compilation unit, but it currently is.  */
   struct macro_table *m_macro_table;
 
+  /* If M_MACRO_TABLE is NULL and this is not, this function is called
+     to compute the macro table the first time it is requested.
+     M_LAZY_MACROS_DATUM is passed to the function.  */
+  lazy_compute_macros_fn m_lazy_macros_fn;
+  void *m_lazy_macros_datum;
+
   /* If non-NULL, then this points to a NULL-terminated vector of
      included compunits.  When searching the static or global
      block of this compunit, the corresponding block of all
@@ -2284,6 +2337,14 @@ extern struct compunit_symtab *find_pc_compunit_symtab (CORE_ADDR);
 extern struct compunit_symtab *
   find_pc_sect_compunit_symtab (CORE_ADDR, struct obj_section *);
 
+/* Expand the symtabs containing each PC in PCS, batching the PCs that
+   fall in the same objfile so its symbol reader can expand them as
+   one batch.  Purely an optimization hint ahead of per-PC lookups
+   such as find_pc_line; lookups that follow behave the same whether
+   or not it was called.  */
+
+extern void expand_symtabs_for_pcs (gdb::array_view<const CORE_ADDR> pcs);
+
 extern bool find_pc_line_pc_range (CORE_ADDR, CORE_ADDR *, CORE_ADDR *);
 
 extern void reread_symbols (int from_tty);
@@ -2588,6 +2649,20 @@ public:
      removed.  */
   std::vector<symbol_search> search () const;
 
+  /* Like search, but deliver the results incrementally: the matches
+     from each objfile are sorted and deduplicated within that objfile
+     and passed to CALLBACK as soon as the objfile has been processed,
+     so only a single objfile's matches are ever held in memory.  This
+     is intended for printing very large result lists, where the
+     all-objfiles sort performed by search would require a huge
+     intermediate vector and delay the first line of output.  Unlike
+     search, a symbol that appears in several objfiles may be reported
+     once per objfile.  Matching minimal symbols, if any, are
+     delivered after all debug symbols.  CALLBACK should return false
+     to stop the search early.  */
+  void search_each (gdb::function_view<bool (const symbol_search &)>
+		      callback) const;
+
   /* The set of source files to search in for matching symbols.  This is
      currently public so that it can be populated after this object has
      been constructed.  */
@@ -2617,6 +2692,12 @@ private:
      of SIZE_MAX, there is no "unlimited".  */
   size_t m_max_search_results = SIZE_MAX;
 
+  /* Compile M_SYMBOL_NAME_REGEXP and M_SYMBOL_TYPE_REGEXP into *PREG
+     and *TREG respectively, leaving them empty when the corresponding
+     regexp was not given.  Throws an error for an invalid regexp.  */
+  void compile_regexps (gdb::optional<compiled_regex> *preg,
+			gdb::optional<compiled_regex> *treg) const;
+
   /* Expand symtabs in OBJFILE that match PREG, are of type M_KIND.  Return
      true if any msymbols were seen that we should later consider adding to
      the results list.  */
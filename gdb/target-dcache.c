@@ -19,6 +19,7 @@
 #include "target-dcache.h"
 #include "gdbcmd.h"
 #include "progspace.h"
+#include "remote.h"
 #include "cli/cli-cmds.h"
 
 /* The target dcache is kept per-address-space.  This key lets us
@@ -163,6 +164,15 @@ maint_flush_dcache_command (const char *command, int from_tty)
     gdb_printf (_("The dcache was flushed.\n"));
 }
 
+/* Implement the 'maint info io-stats' command.  */
+
+static void
+maint_info_io_stats_command (const char *command, int from_tty)
+{
+  dcache_print_stats (target_dcache_get (), gdb_stdout);
+  remote_print_io_stats (gdb_stdout);
+}
+
 void _initialize_target_dcache ();
 void
 _initialize_target_dcache ()
@@ -197,4 +207,13 @@ Force gdb to flush its target memory data cache.\n\
 The dcache caches all target memory accesses where possible, this\n\
 includes the stack-cache and the code-cache."),
 	   &maintenanceflushlist);
+
+  add_cmd ("io-stats", class_maintenance, maint_info_io_stats_command,
+	   _("\
+Show statistics about GDB's target I/O.\n\
+\n\
+This prints the target memory data cache's hit and miss counts, and,\n\
+for each live remote connection, the number of packets sent to and\n\
+received from the target."),
+	   &maintenanceinfolist);
 }
@@ -237,6 +237,16 @@ target_debug_print_const_gdb_byte_vector_r (const gdb::byte_vector &vector)
   target_debug_print_gdb_array_view_const_gdb_byte (vector);
 }
 
+static void
+target_debug_print_gdb_array_view_const_ptid_t (gdb::array_view<const ptid_t> ptids)
+{
+  gdb_puts ("{", gdb_stdlog);
+
+  for (const ptid_t &ptid : ptids)
+    gdb_printf (gdb_stdlog, " %s", ptid.to_string ().c_str ());
+  gdb_puts (" }", gdb_stdlog);
+}
+
 static void
 target_debug_print_gdb_byte_vector_r (gdb::byte_vector &vector)
 {
@@ -42,6 +42,8 @@ struct dummy_target : public target_ops
   void files_info () override;
   int insert_breakpoint (struct gdbarch *arg0, struct bp_target_info *arg1) override;
   int remove_breakpoint (struct gdbarch *arg0, struct bp_target_info *arg1, enum remove_bp_reason arg2) override;
+  void breakpoint_batch_begin () override;
+  void breakpoint_batch_done () override;
   bool stopped_by_sw_breakpoint () override;
   bool supports_stopped_by_sw_breakpoint () override;
   bool stopped_by_hw_breakpoint () override;
@@ -91,6 +93,7 @@ struct dummy_target : public target_ops
   thread_info *thread_handle_to_thread_info (const gdb_byte *arg0, int arg1, inferior *arg2) override;
   gdb::array_view<const_gdb_byte> thread_info_to_thread_handle (struct thread_info *arg0) override;
   void stop (ptid_t arg0) override;
+  void stop_threads (gdb::array_view<const ptid_t> arg0) override;
   void interrupt () override;
   void pass_ctrlc () override;
   void rcmd (const char *arg0, struct ui_file *arg1) override;
@@ -217,6 +220,8 @@ struct debug_target : public target_ops
   void files_info () override;
   int insert_breakpoint (struct gdbarch *arg0, struct bp_target_info *arg1) override;
   int remove_breakpoint (struct gdbarch *arg0, struct bp_target_info *arg1, enum remove_bp_reason arg2) override;
+  void breakpoint_batch_begin () override;
+  void breakpoint_batch_done () override;
   bool stopped_by_sw_breakpoint () override;
   bool supports_stopped_by_sw_breakpoint () override;
   bool stopped_by_hw_breakpoint () override;
@@ -266,6 +271,7 @@ struct debug_target : public target_ops
   thread_info *thread_handle_to_thread_info (const gdb_byte *arg0, int arg1, inferior *arg2) override;
   gdb::array_view<const_gdb_byte> thread_info_to_thread_handle (struct thread_info *arg0) override;
   void stop (ptid_t arg0) override;
+  void stop_threads (gdb::array_view<const ptid_t> arg0) override;
   void interrupt () override;
   void pass_ctrlc () override;
   void rcmd (const char *arg0, struct ui_file *arg1) override;
@@ -665,6 +671,46 @@ debug_target::remove_breakpoint (struct gdbarch *arg0, struct bp_target_info *ar
   return result;
 }
 
+void
+target_ops::breakpoint_batch_begin ()
+{
+  this->beneath ()->breakpoint_batch_begin ();
+}
+
+void
+dummy_target::breakpoint_batch_begin ()
+{
+}
+
+void
+debug_target::breakpoint_batch_begin ()
+{
+  gdb_printf (gdb_stdlog, "-> %s->breakpoint_batch_begin (...)\n", this->beneath ()->shortname ());
+  this->beneath ()->breakpoint_batch_begin ();
+  gdb_printf (gdb_stdlog, "<- %s->breakpoint_batch_begin (", this->beneath ()->shortname ());
+  gdb_puts (")\n", gdb_stdlog);
+}
+
+void
+target_ops::breakpoint_batch_done ()
+{
+  this->beneath ()->breakpoint_batch_done ();
+}
+
+void
+dummy_target::breakpoint_batch_done ()
+{
+}
+
+void
+debug_target::breakpoint_batch_done ()
+{
+  gdb_printf (gdb_stdlog, "-> %s->breakpoint_batch_done (...)\n", this->beneath ()->shortname ());
+  this->beneath ()->breakpoint_batch_done ();
+  gdb_printf (gdb_stdlog, "<- %s->breakpoint_batch_done (", this->beneath ()->shortname ());
+  gdb_puts (")\n", gdb_stdlog);
+}
+
 bool
 target_ops::stopped_by_sw_breakpoint ()
 {
@@ -1920,6 +1966,28 @@ debug_target::stop (ptid_t arg0)
   gdb_puts (")\n", gdb_stdlog);
 }
 
+void
+target_ops::stop_threads (gdb::array_view<const ptid_t> arg0)
+{
+  this->beneath ()->stop_threads (arg0);
+}
+
+void
+dummy_target::stop_threads (gdb::array_view<const ptid_t> arg0)
+{
+  default_stop_threads (this, arg0);
+}
+
+void
+debug_target::stop_threads (gdb::array_view<const ptid_t> arg0)
+{
+  gdb_printf (gdb_stdlog, "-> %s->stop_threads (...)\n", this->beneath ()->shortname ());
+  this->beneath ()->stop_threads (arg0);
+  gdb_printf (gdb_stdlog, "<- %s->stop_threads (", this->beneath ()->shortname ());
+  target_debug_print_gdb_array_view_const_ptid_t (arg0);
+  gdb_puts (")\n", gdb_stdlog);
+}
+
 void
 target_ops::interrupt ()
 {
@@ -1410,6 +1410,30 @@ target_section_by_addr (struct target_ops *target, CORE_ADDR addr)
   if (table == NULL)
     return NULL;
 
+  /* When this is the program space's table, use its sorted index
+     rather than scanning the whole table.  */
+  if (table == &current_program_space->target_sections ())
+    {
+      const std::vector<size_t> &index
+	= current_program_space->sorted_target_sections ();
+
+      if (!index.empty ())
+	{
+	  auto it = std::upper_bound (index.begin (), index.end (), addr,
+				      [table] (CORE_ADDR lhs, size_t pos)
+				      {
+					return lhs < (*table)[pos].addr;
+				      });
+	  if (it == index.begin ())
+	    return NULL;
+
+	  const target_section &secp = (*table)[*(it - 1)];
+	  if (addr < secp.endaddr)
+	    return &secp;
+	  return NULL;
+	}
+    }
+
   for (const target_section &secp : *table)
     {
       if (addr >= secp.addr && addr < secp.endaddr)
@@ -1579,9 +1603,12 @@ memory_xfer_partial_1 (struct target_ops *ops, enum target_object object,
 	  && (bfd_section_flags (secp->the_bfd_section) & SEC_READONLY))
 	{
 	  const target_section_table *table = target_get_section_table (ops);
+	  const std::vector<size_t> *index = nullptr;
+	  if (table == &current_program_space->target_sections ())
+	    index = &current_program_space->sorted_target_sections ();
 	  return section_table_xfer_memory_partial (readbuf, writebuf,
 						    memaddr, len, xfered_len,
-						    *table);
+						    *table, nullptr, index);
 	}
     }
 
@@ -1805,6 +1832,78 @@ target_read_memory (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len)
     return -1;
 }
 
+/* See target.h.  */
+
+int
+target_read_memory_vector (gdb::array_view<memory_read_request> requests)
+{
+  /* Sort positions rather than the requests themselves, so the
+     caller's order is preserved.  */
+  std::vector<size_t> order (requests.size ());
+  for (size_t i = 0; i < order.size (); ++i)
+    order[i] = i;
+  std::sort (order.begin (), order.end (),
+	     [&requests] (size_t lhs, size_t rhs)
+	     {
+	       return requests[lhs].addr < requests[rhs].addr;
+	     });
+
+  size_t i = 0;
+  while (i < order.size ())
+    {
+      /* Each run is a separate target read; let the user interrupt a
+	 large batch between runs.  */
+      QUIT;
+
+      if (requests[order[i]].len == 0)
+	{
+	  i++;
+	  continue;
+	}
+
+      /* Extend the run over all following requests that overlap or
+	 adjoin it.  No gap is ever bridged, so we never touch memory
+	 the caller did not ask for.  */
+      CORE_ADDR lo = requests[order[i]].addr;
+      CORE_ADDR hi = lo + requests[order[i]].len;
+      size_t j = i + 1;
+      while (j < order.size () && requests[order[j]].addr <= hi)
+	{
+	  hi = std::max (hi, (CORE_ADDR) (requests[order[j]].addr
+					  + requests[order[j]].len));
+	  j++;
+	}
+
+      if (j == i + 1)
+	{
+	  /* A lone range; read straight into the caller's buffer.  */
+	  int res = target_read_memory (lo, requests[order[i]].buf, hi - lo);
+	  if (res != 0)
+	    return res;
+	}
+      else
+	{
+	  /* Read the whole run once and scatter it.  */
+	  gdb::byte_vector buf (hi - lo);
+
+	  int res = target_read_memory (lo, buf.data (), hi - lo);
+	  if (res != 0)
+	    return res;
+
+	  for (size_t k = i; k < j; ++k)
+	    {
+	      memory_read_request &req = requests[order[k]];
+
+	      memcpy (req.buf, buf.data () + (req.addr - lo), req.len);
+	    }
+	}
+
+      i = j;
+    }
+
+  return 0;
+}
+
 /* See target/target.h.  */
 
 int
@@ -2422,6 +2521,22 @@ target_remove_breakpoint (struct gdbarch *gdbarch,
   return target->remove_breakpoint (gdbarch, bp_tgt, reason);
 }
 
+/* See target.h.  */
+
+void
+target_breakpoint_batch_begin (void)
+{
+  current_inferior ()->top_target ()->breakpoint_batch_begin ();
+}
+
+/* See target.h.  */
+
+void
+target_breakpoint_batch_done (void)
+{
+  current_inferior ()->top_target ()->breakpoint_batch_done ();
+}
+
 static void
 info_target_command (const char *args, int from_tty)
 {
@@ -3807,6 +3922,36 @@ target_stop (ptid_t ptid)
   current_inferior ()->top_target ()->stop (ptid);
 }
 
+/* See target.h.  */
+
+void
+target_stop_threads (gdb::array_view<const ptid_t> ptids)
+{
+  process_stratum_target *proc_target = current_inferior ()->process_target ();
+
+  gdb_assert (!proc_target->commit_resumed_state);
+
+  if (!may_stop)
+    {
+      warning (_("May not interrupt or stop the target, ignoring attempt"));
+      return;
+    }
+
+  current_inferior ()->top_target ()->stop_threads (ptids);
+}
+
+/* See target.h.  */
+
+void
+default_stop_threads (struct target_ops *self,
+		      gdb::array_view<const ptid_t> ptids)
+{
+  target_ops *top = current_inferior ()->top_target ();
+
+  for (const ptid_t &ptid : ptids)
+    top->stop (ptid);
+}
+
 void
 target_interrupt ()
 {
@@ -3943,6 +4088,7 @@ target_options_to_string (target_wait_flags target_options)
 void
 target_fetch_registers (struct regcache *regcache, int regno)
 {
+  record_register_fetch (regno);
   current_inferior ()->top_target ()->fetch_registers (regcache, regno);
   if (targetdebug)
     regcache->debug_print_register ("target_fetch_registers", regno);
@@ -302,6 +302,38 @@ struct memory_read_result
 extern std::vector<memory_read_result> read_memory_robust
     (struct target_ops *ops, const ULONGEST offset, const LONGEST len);
 
+/* One range of a vectored memory read: LEN bytes at ADDR, to be
+   placed at BUF.  */
+
+struct memory_read_request
+{
+  memory_read_request (CORE_ADDR addr_, ULONGEST len_, gdb_byte *buf_)
+    : addr (addr_),
+      len (len_),
+      buf (buf_)
+  {
+  }
+
+  /* First address to read.  */
+  CORE_ADDR addr;
+  /* Number of bytes to read.  */
+  ULONGEST len;
+  /* Where to put them.  */
+  gdb_byte *buf;
+};
+
+/* Read several, possibly discontiguous, ranges of target memory in
+   one call.  The ranges are sorted and overlapping or adjoining
+   ranges are merged, so each contiguous run costs one traversal of
+   the target stack -- and, on remote targets, one packet -- no
+   matter how many requests it covers.  Gaps between ranges are never
+   read.  Returns 0 on success, or the first error encountered, as
+   for target_read_memory; on error the contents of the buffers of
+   unprocessed ranges are undefined.  */
+
+extern int target_read_memory_vector
+    (gdb::array_view<memory_read_request> requests);
+
 /* Request that OPS transfer up to LEN addressable units from BUF to the
    target's OBJECT.  When writing to a memory object, the addressable unit
    size is architecture dependent and can be found using
@@ -527,6 +559,22 @@ struct target_ops
 				 enum remove_bp_reason)
       TARGET_DEFAULT_NORETURN (noprocess ());
 
+    /* Begin a sequence of breakpoint insertions.  Between this call
+       and the matching breakpoint_batch_done call, the target may
+       pipeline insertion requests: insert_breakpoint then reports
+       success without waiting for the target's reply, and a failure
+       discovered later is flagged in the corresponding
+       bp_target_info's pipelined_insert_failed instead.  */
+    virtual void breakpoint_batch_begin ()
+      TARGET_DEFAULT_IGNORE ();
+
+    /* Finish a sequence of breakpoint insertions, collecting the
+       outcome of any insertion request still in flight.  On return,
+       pipelined_insert_failed is valid in every bp_target_info
+       inserted since breakpoint_batch_begin.  */
+    virtual void breakpoint_batch_done ()
+      TARGET_DEFAULT_IGNORE ();
+
     /* Returns true if the target stopped because it executed a
        software breakpoint.  This is necessary for correct background
        execution / non-stop mode operation, and for correct PC
@@ -688,6 +736,13 @@ struct target_ops
       TARGET_DEFAULT_RETURN (gdb::array_view<const gdb_byte> ());
     virtual void stop (ptid_t)
       TARGET_DEFAULT_IGNORE ();
+    /* Ask the target to stop all the threads in PTIDS.  The default
+       implementation requests the stops one at a time, via
+       target_stop; targets that can request several stops in a single
+       operation override this.  Like stop, this does not wait for the
+       stops to take effect.  */
+    virtual void stop_threads (gdb::array_view<const ptid_t> ptids)
+      TARGET_DEFAULT_FUNC (default_stop_threads);
     virtual void interrupt ()
       TARGET_DEFAULT_IGNORE ();
     virtual void pass_ctrlc ()
@@ -1667,6 +1722,18 @@ extern int target_remove_breakpoint (struct gdbarch *gdbarch,
 				     struct bp_target_info *bp_tgt,
 				     enum remove_bp_reason reason);
 
+/* Begin a sequence of breakpoint insertions, during which the target
+   may pipeline insertion requests.  See
+   target_ops::breakpoint_batch_begin.  */
+
+extern void target_breakpoint_batch_begin (void);
+
+/* Finish a sequence of breakpoint insertions, collecting the outcome
+   of any insertion request still in flight.  See
+   target_ops::breakpoint_batch_done.  */
+
+extern void target_breakpoint_batch_done (void);
+
 /* Return true if the target stack has a non-default
   "terminal_ours" method.  */
 
@@ -1815,6 +1882,18 @@ extern void target_update_thread_list (void);
 
 extern void target_stop (ptid_t ptid);
 
+/* Like target_stop, but requests stops for all the threads in PTIDS
+   at once, letting targets that are able to batch the requests do so.
+   This function is asynchronous as well.  */
+
+extern void target_stop_threads (gdb::array_view<const ptid_t> ptids);
+
+/* The default implementation of to_stop_threads; requests the stops
+   one ptid at a time through target_stop.  */
+
+extern void default_stop_threads (struct target_ops *self,
+				  gdb::array_view<const ptid_t> ptids);
+
 /* Interrupt the target.  Unlike target_stop, this does not specify
    which thread/process reports the stop.  For most target this acts
    like raising a SIGINT, though that's not absolutely required.  This
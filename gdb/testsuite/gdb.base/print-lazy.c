@@ -0,0 +1,88 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <stdio.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/* Big enough that each half spans whole pages on any common page
+   size, so the struct can be made to straddle a mapped/unmapped
+   boundary.  */
+#define HALF_SIZE (64 * 1024)
+
+struct straddle
+{
+  unsigned char readable[HALF_SIZE];
+  unsigned char unreadable[HALF_SIZE];
+};
+
+struct straddle *g_straddle;
+
+struct small
+{
+  int a;
+  int b;
+  int c;
+} g_small = { 1, 2, 3 };
+
+void
+breakpt (void)
+{
+}
+
+int
+main (void)
+{
+#ifndef _WIN32
+  /* Without mmap there is no way to set up the straddling struct;
+     leave G_STRADDLE null and let the test detect it.  */
+  size_t pg_size = getpagesize ();
+  char *p;
+
+  if (HALF_SIZE % pg_size != 0)
+    {
+      /* Page size does not divide the halves; leave G_STRADDLE null
+	 and let the test detect it.  */
+      breakpt ();
+      return EXIT_SUCCESS;
+    }
+
+  p = mmap (0, 2 * HALF_SIZE, PROT_READ | PROT_WRITE,
+	    MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (p == MAP_FAILED)
+    {
+      perror ("mmap");
+      return EXIT_FAILURE;
+    }
+
+  if (munmap (p + HALF_SIZE, HALF_SIZE) == -1)
+    {
+      perror ("munmap");
+      return EXIT_FAILURE;
+    }
+
+  g_straddle = (struct straddle *) p;
+  g_straddle->readable[0] = 42;
+#endif
+
+  breakpt ();
+
+  return EXIT_SUCCESS;
+}
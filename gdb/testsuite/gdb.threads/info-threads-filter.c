@@ -0,0 +1,96 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <pthread.h>
+#include <assert.h>
+
+static volatile int alpha_started;
+static volatile int beta_started;
+static volatile int done;
+
+/* The workers busy-wait in distinct functions, so that each thread's
+   innermost frame names the function the "-frame" filter looks
+   for.  */
+
+static void
+alpha_spin (void)
+{
+  alpha_started = 1;
+  while (!done)
+    ;
+}
+
+static void
+beta_spin (void)
+{
+  beta_started = 1;
+  while (!done)
+    ;
+}
+
+static void *
+alpha_func (void *arg)
+{
+  pthread_setname_np (pthread_self (), "alpha");
+  alpha_spin ();
+  return NULL;
+}
+
+static void *
+beta_func (void *arg)
+{
+  pthread_setname_np (pthread_self (), "beta");
+  beta_spin ();
+  return NULL;
+}
+
+static void
+all_threads_ready (void)
+{
+}
+
+int
+main (int argc, char **argv)
+{
+  pthread_t alpha, beta;
+  int res;
+
+  alarm (60);
+
+  pthread_setname_np (pthread_self (), "main");
+
+  res = pthread_create (&alpha, NULL, alpha_func, NULL);
+  assert (res == 0);
+  res = pthread_create (&beta, NULL, beta_func, NULL);
+  assert (res == 0);
+
+  while (!alpha_started || !beta_started)
+    usleep (1);
+
+  all_threads_ready ();
+
+  done = 1;
+
+  res = pthread_join (alpha, NULL);
+  assert (res == 0);
+  res = pthread_join (beta, NULL);
+  assert (res == 0);
+
+  return 0;
+}
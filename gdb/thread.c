@@ -46,10 +46,12 @@
 #include "thread-fsm.h"
 #include "tid-parse.h"
 #include <algorithm>
+#include <unordered_map>
 #include "gdbsupport/gdb_optional.h"
 #include "inline-frame.h"
 #include "stack.h"
 #include "interps.h"
+#include "objfiles.h"
 
 /* See gdbthread.h.  */
 
@@ -120,7 +122,33 @@ void
 delete_single_step_breakpoints (struct thread_info *tp)
 {
   if (tp != NULL)
-    delete_thread_breakpoint (&tp->control.single_step_breakpoints);
+    {
+      delete_thread_breakpoint (&tp->control.single_step_breakpoints);
+      delete_thread_breakpoint (&tp->control.cached_single_step_breakpoints);
+    }
+}
+
+/* See gdbthread.h.  */
+
+void
+recycle_single_step_breakpoints (struct thread_info *tp)
+{
+  if (tp == NULL || tp->control.single_step_breakpoints == NULL)
+    return;
+
+  delete_thread_breakpoint (&tp->control.cached_single_step_breakpoints);
+  tp->control.cached_single_step_breakpoints
+    = tp->control.single_step_breakpoints;
+  tp->control.single_step_breakpoints = NULL;
+}
+
+/* See gdbthread.h.  */
+
+void
+flush_single_step_breakpoint_cache (struct thread_info *tp)
+{
+  if (tp != NULL)
+    delete_thread_breakpoint (&tp->control.cached_single_step_breakpoints);
 }
 
 /* Delete the breakpoint pointed at by BP_P at the next stop, if
@@ -179,6 +207,7 @@ clear_thread_inferior_resources (struct thread_info *tp)
   delete_at_next_stop (&tp->control.step_resume_breakpoint);
   delete_at_next_stop (&tp->control.exception_resume_breakpoint);
   delete_at_next_stop (&tp->control.single_step_breakpoints);
+  delete_at_next_stop (&tp->control.cached_single_step_breakpoints);
 
   delete_longjmp_breakpoint_at_next_stop (tp->global_num);
 
@@ -1064,19 +1093,111 @@ thread_target_id_str (thread_info *tp)
     return target_id;
 }
 
+/* The options for the "info threads" command.  */
+
+struct info_threads_opts
+{
+  /* For "-gid".  */
+  bool show_global_ids = false;
+
+  /* For "-name".  */
+  std::string name_regexp;
+
+  /* For "-running" and "-stopped".  */
+  bool show_running = false;
+  bool show_stopped = false;
+
+  /* For "-frame".  */
+  std::string frame_regexp;
+
+  /* Returns true if any of the thread filters above is in effect.  */
+  bool filtered_p () const
+  {
+    return (show_running || show_stopped
+	    || !name_regexp.empty () || !frame_regexp.empty ());
+  }
+};
+
+/* Helper for print_thread_info_1.  Returns true if TP passes the
+   filters requested by OPTS.  NAME_RE and FRAME_RE are the compiled
+   forms of OPTS's name and frame regexps.  Checking the frame filter
+   may switch to TP in order to look at its selected frame.  */
+
+static bool
+thread_matches_filters (thread_info *tp, const info_threads_opts &opts,
+			const gdb::optional<compiled_regex> &name_re,
+			const gdb::optional<compiled_regex> &frame_re)
+{
+  if (opts.show_running && tp->state != THREAD_RUNNING)
+    return false;
+  if (opts.show_stopped && tp->state != THREAD_STOPPED)
+    return false;
+
+  if (name_re.has_value ())
+    {
+      const char *name = thread_name (tp);
+
+      if (name == nullptr || name_re->exec (name, 0, nullptr, 0) != 0)
+	return false;
+    }
+
+  if (frame_re.has_value ())
+    {
+      /* A running thread has no frame to look at.  */
+      if (tp->state == THREAD_RUNNING)
+	return false;
+
+      switch_to_thread (tp);
+
+      gdb::unique_xmalloc_ptr<char> funname;
+      try
+	{
+	  frame_info_ptr frame = get_selected_frame (nullptr);
+	  enum language funlang;
+	  struct symbol *func;
+
+	  funname = find_frame_funname (frame, &funlang, &func);
+	}
+      catch (const gdb_exception_error &)
+	{
+	  /* A thread whose frame cannot be determined cannot match.  */
+	  return false;
+	}
+
+      if (funname == nullptr
+	  || frame_re->exec (funname.get (), 0, nullptr, 0) != 0)
+	return false;
+    }
+
+  return true;
+}
+
 /* Like print_thread_info, but in addition, GLOBAL_IDS indicates
    whether REQUESTED_THREADS is a list of global or per-inferior
-   thread ids.  */
+   thread ids, and OPTS carries the display and filter options.  */
 
 static void
 print_thread_info_1 (struct ui_out *uiout, const char *requested_threads,
 		     int global_ids, int pid,
-		     int show_global_ids)
+		     const info_threads_opts &opts)
 {
   int default_inf_num = current_inferior ()->num;
+  int show_global_ids = opts.show_global_ids;
 
   update_thread_list ();
 
+  /* Compile the filter regexps once, up front; the filters are then
+     applied while iterating over the threads, so that threads
+     filtered out are never formatted at all.  */
+  gdb::optional<compiled_regex> name_re;
+  gdb::optional<compiled_regex> frame_re;
+  if (!opts.name_regexp.empty ())
+    name_re.emplace (opts.name_regexp.c_str (), REG_NOSUB,
+		     _("Invalid regexp"));
+  if (!opts.frame_regexp.empty ())
+    frame_re.emplace (opts.frame_regexp.c_str (), REG_NOSUB,
+		      _("Invalid regexp"));
+
   /* Whether we saw any thread.  */
   bool any_thread = false;
   /* Whether the current thread is exited.  */
@@ -1095,6 +1216,12 @@ print_thread_info_1 (struct ui_out *uiout, const char *requested_threads,
     /* We'll be switching threads temporarily below.  */
     scoped_restore_current_thread restore_thread;
 
+    /* For the CLI, the target id strings are computed once by the
+       column-sizing pass below and reused when the rows are emitted.
+       Querying the target for every thread's name and extra info a
+       second time gets noticeable with many threads.  */
+    std::unordered_map<thread_info *, std::string> target_id_strs;
+
     if (uiout->is_mi_like_p ())
       list_emitter.emplace (uiout, "threads");
     else
@@ -1114,24 +1241,30 @@ print_thread_info_1 (struct ui_out *uiout, const char *requested_threads,
 				      global_ids, pid, tp))
 	      continue;
 
+	    if (!thread_matches_filters (tp, opts, name_re, frame_re))
+	      continue;
+
 	    /* Switch inferiors so we're looking at the right
 	       target stack.  */
 	    switch_to_inferior_no_thread (tp->inf);
 
-	    target_id_col_width
-	      = std::max (target_id_col_width,
-			  thread_target_id_str (tp).size ());
+	    std::string &target_id = target_id_strs[tp];
+	    target_id = thread_target_id_str (tp);
+	    target_id_col_width = std::max (target_id_col_width,
+					    target_id.size ());
 
 	    ++n_threads;
 	  }
 
 	if (n_threads == 0)
 	  {
-	    if (requested_threads == NULL || *requested_threads == '\0')
-	      uiout->message (_("No threads.\n"));
-	    else
+	    if (requested_threads != NULL && *requested_threads != '\0')
 	      uiout->message (_("No threads match '%s'.\n"),
 			      requested_threads);
+	    else if (opts.filtered_p ())
+	      uiout->message (_("No threads match the filter.\n"));
+	    else
+	      uiout->message (_("No threads.\n"));
 	    return;
 	  }
 
@@ -1165,6 +1298,9 @@ print_thread_info_1 (struct ui_out *uiout, const char *requested_threads,
 				    global_ids, pid, tp))
 	    continue;
 
+	  if (!thread_matches_filters (tp, opts, name_re, frame_re))
+	    continue;
+
 	  ui_out_emit_tuple tuple_emitter (uiout, NULL);
 
 	  if (!uiout->is_mi_like_p ())
@@ -1204,7 +1340,12 @@ print_thread_info_1 (struct ui_out *uiout, const char *requested_threads,
 	    }
 	  else
 	    {
-	      uiout->field_string ("target-id", thread_target_id_str (tp));
+	      auto it = target_id_strs.find (tp);
+
+	      if (it != target_id_strs.end ())
+		uiout->field_string ("target-id", it->second);
+	      else
+		uiout->field_string ("target-id", thread_target_id_str (tp));
 	    }
 
 	  if (tp->state == THREAD_RUNNING)
@@ -1259,16 +1400,10 @@ void
 print_thread_info (struct ui_out *uiout, const char *requested_threads,
 		   int pid)
 {
-  print_thread_info_1 (uiout, requested_threads, 1, pid, 0);
-}
+  info_threads_opts opts;
 
-/* The options for the "info threads" command.  */
-
-struct info_threads_opts
-{
-  /* For "-gid".  */
-  bool show_global_ids = false;
-};
+  print_thread_info_1 (uiout, requested_threads, 1, pid, opts);
+}
 
 static const gdb::option::option_def info_threads_option_defs[] = {
 
@@ -1278,6 +1413,32 @@ static const gdb::option::option_def info_threads_option_defs[] = {
     N_("Show global thread IDs."),
   },
 
+  gdb::option::string_option_def<info_threads_opts> {
+    "name",
+    [] (info_threads_opts *opts) { return &opts->name_regexp; },
+    nullptr, /* show_cmd_cb */
+    N_("Only display threads whose name matches REGEXP."),
+  },
+
+  gdb::option::flag_option_def<info_threads_opts> {
+    "running",
+    [] (info_threads_opts *opts) { return &opts->show_running; },
+    N_("Only display running threads."),
+  },
+
+  gdb::option::flag_option_def<info_threads_opts> {
+    "stopped",
+    [] (info_threads_opts *opts) { return &opts->show_stopped; },
+    N_("Only display stopped threads."),
+  },
+
+  gdb::option::string_option_def<info_threads_opts> {
+    "frame",
+    [] (info_threads_opts *opts) { return &opts->frame_regexp; },
+    nullptr, /* show_cmd_cb */
+    N_("Only display threads stopped in a function matching REGEXP."),
+  },
+
 };
 
 /* Create an option_def_group for the "info threads" options, with
@@ -1304,7 +1465,7 @@ info_threads_command (const char *arg, int from_tty)
   gdb::option::process_options
     (&arg, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_ERROR, grp);
 
-  print_thread_info_1 (current_uiout, arg, 0, -1, it_opts.show_global_ids);
+  print_thread_info_1 (current_uiout, arg, 0, -1, it_opts);
 }
 
 /* Completer for the "info threads" command.  */
@@ -1625,6 +1786,78 @@ make_thread_apply_options_def_group (qcs_flags *flags)
   return {{thr_qcs_flags_option_defs}, flags};
 }
 
+/* If CMD is a backtrace-style command and the target is not live,
+   walk every stack in THREADS once up front, collecting the frame
+   PCs, and expand the symtabs covering them in one batch per program
+   space.  Unwinding needs no full symbols, so this pass is cheap; the
+   batch expansion can read the debug info of many CUs in parallel
+   (see "maint set dwarf parallel-expansion"), where symbolizing the
+   frames while printing would fault in one CU at a time.  */
+
+static void
+thread_apply_prefetch_symtabs (const char *cmd,
+			       const std::vector<thread_info_ref> &threads)
+{
+  if (target_has_execution ())
+    return;
+
+  /* Only do the extra stack walk for commands that will symbolize
+     many frames anyway.  */
+  const char *end = cmd;
+  while (*end != '\0' && !isspace (*end))
+    end++;
+  std::string verb (cmd, end - cmd);
+  if (verb != "backtrace" && verb != "bt" && verb != "where")
+    return;
+
+  /* The PCs seen on the threads' stacks, grouped by the program space
+     the thread runs in.  There are rarely more than a couple of
+     program spaces, so a flat vector is fine.  */
+  std::vector<std::pair<program_space *, std::vector<CORE_ADDR>>> pspace_pcs;
+
+  auto pcs_for = [&pspace_pcs] (program_space *pspace)
+      -> std::vector<CORE_ADDR> &
+    {
+      for (auto &entry : pspace_pcs)
+	if (entry.first == pspace)
+	  return entry.second;
+      pspace_pcs.emplace_back (pspace, std::vector<CORE_ADDR> ());
+      return pspace_pcs.back ().second;
+    };
+
+  scoped_restore_current_thread restore_thread;
+
+  for (const thread_info_ref &thr : threads)
+    {
+      if (!switch_to_thread_if_alive (thr.get ()))
+	continue;
+
+      std::vector<CORE_ADDR> &pcs = pcs_for (thr->inf->pspace);
+
+      try
+	{
+	  for (frame_info_ptr frame = get_current_frame ();
+	       frame;
+	       frame = get_prev_frame (frame))
+	    {
+	      CORE_ADDR pc;
+
+	      if (get_frame_pc_if_available (frame, &pc))
+		pcs.push_back (pc);
+	    }
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  /* A thread whose stack cannot be walked will fail again in
+	     the real pass, which is where it gets reported.  */
+	}
+    }
+
+  for (const auto &entry : pspace_pcs)
+    for (objfile *objf : entry.first->objfiles ())
+      objf->expand_symtabs_for_pcs (entry.second);
+}
+
 /* Apply a GDB command to a list of threads.  List syntax is a whitespace
    separated list of numbers, or ranges, or the keyword `all'.  Ranges consist
    of two numbers separated by a hyphen.  Examples:
@@ -1671,6 +1904,8 @@ thread_apply_all_command (const char *cmd, int from_tty)
 		      : tp_array_compar_descending);
       std::sort (thr_list_cpy.begin (), thr_list_cpy.end (), sorter);
 
+      thread_apply_prefetch_symtabs (cmd, thr_list_cpy);
+
       scoped_restore_current_thread restore_thread;
 
       for (thread_info_ref &thr : thr_list_cpy)
@@ -53,6 +53,7 @@
 #include "frame.h"
 #include "gdbsupport/gdb_select.h"
 #include "gdbsupport/scope-exit.h"
+#include "gdbsupport/scoped-arena.h"
 #include "gdbarch.h"
 #include "gdbsupport/pathstuff.h"
 #include "cli/cli-style.h"
@@ -467,6 +468,11 @@ execute_command (const char *p, int from_tty)
   auto cleanup_if_error = make_scope_exit (bpstat_clear_actions);
   scoped_value_mark cleanup = prepare_execute_command ();
 
+  /* Short-lived scratch allocations made anywhere below -- via
+     gdb::arena_allocator -- are pooled here and released wholesale
+     when the command finishes.  */
+  gdb::scoped_arena command_arena;
+
   /* This can happen when command_line_input hits end of file.  */
   if (p == NULL)
     {
@@ -32,6 +32,7 @@
 #include "xml-tdesc.h"
 #include "target-descriptions.h"
 #include "gdbsupport/pathstuff.h"
+#include "gdbsupport/scoped_mmap.h"
 #include <algorithm>
 
 #ifndef O_LARGEFILE
@@ -423,20 +424,113 @@ static int cur_data_size;
 int trace_regblock_size;
 static std::string trace_tdesc;
 
+#ifdef HAVE_SYS_MMAN_H
+/* A read-only mapping of the whole trace file, when the host supports
+   it.  While valid, reads are served from the mapping instead of
+   going through the file descriptor, so walking the blocks of a
+   traceframe costs no syscalls.  */
+static scoped_mmap trace_map;
+#endif
+
+/* The size of the trace file, and the current logical read position
+   within it.  The read position is maintained by tfile_seek,
+   tfile_skip and tfile_read whether or not the file is mapped.  */
+static off_t trace_file_size;
+static off_t trace_read_offset;
+
+/* One entry of the traceframe index: everything "tfind" needs in
+   order to match a frame without touching the file.  */
+
+struct tfile_traceframe
+{
+  /* Offset of the frame's header in the file.  */
+  off_t offset;
+  /* Number of the tracepoint that collected the frame.  */
+  int tpnum;
+  /* Size of the frame's data, excluding the header.  */
+  unsigned int data_size;
+};
+
+/* The traceframe index, in file order, built once when the file is
+   opened.  */
+static std::vector<tfile_traceframe> trace_frame_index;
+
 static void tfile_append_tdesc_line (const char *line);
 static void tfile_interp_line (const char *line,
 			       struct uploaded_tp **utpp,
 			       struct uploaded_tsv **utsvp);
+static void build_trace_frame_index ();
 
-/* Read SIZE bytes into READBUF from the trace frame, starting at
-   TRACE_FD's current position.  Note that this call `read'
-   underneath, hence it advances the file's seek position.  Throws an
-   error if the `read' syscall fails, or less than SIZE bytes are
-   read.  */
+/* Return true if the trace file contents are memory-mapped.  */
+
+static bool
+tfile_mapped_p ()
+{
+#ifdef HAVE_SYS_MMAN_H
+  return trace_map.get () != MAP_FAILED;
+#else
+  return false;
+#endif
+}
+
+/* If the trace file is mapped, return a pointer to SIZE bytes of its
+   contents at the current read position and skip past them;
+   otherwise return NULL and leave the position unchanged.  Throws an
+   error if fewer than SIZE bytes are left in the file.  */
+
+static const gdb_byte *
+tfile_access (int size)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (tfile_mapped_p ())
+    {
+      if (trace_read_offset + size > trace_file_size)
+	error (_("Premature end of file while reading trace file"));
+
+      const gdb_byte *result
+	= (const gdb_byte *) trace_map.get () + trace_read_offset;
+      trace_read_offset += size;
+      return result;
+    }
+#endif
+  return nullptr;
+}
+
+/* Set the current read position to OFFSET from the start of the
+   trace file.  */
+
+static void
+tfile_seek (off_t offset)
+{
+  if (!tfile_mapped_p ())
+    lseek (trace_fd, offset, SEEK_SET);
+  trace_read_offset = offset;
+}
+
+/* Advance the current read position by AMOUNT bytes.  */
+
+static void
+tfile_skip (off_t amount)
+{
+  if (!tfile_mapped_p ())
+    lseek (trace_fd, amount, SEEK_CUR);
+  trace_read_offset += amount;
+}
+
+/* Read SIZE bytes into READBUF from the trace file, starting at the
+   current read position, and advance the position.  Throws an error
+   if the read fails, or less than SIZE bytes are read.  */
 
 static void
 tfile_read (gdb_byte *readbuf, int size)
 {
+  const gdb_byte *mapped = tfile_access (size);
+  if (mapped != nullptr)
+    {
+      memcpy (readbuf, mapped, size);
+      return;
+    }
+
   int gotten;
 
   gotten = read (trace_fd, readbuf, size);
@@ -444,6 +538,7 @@ tfile_read (gdb_byte *readbuf, int size)
     perror_with_name (trace_filename.get ());
   else if (gotten < size)
     error (_("Premature end of file while reading trace file"));
+  trace_read_offset += size;
 }
 
 /* Open the tfile target.  */
@@ -481,6 +576,7 @@ tfile_target_open (const char *arg, int from_tty)
 
   trace_filename = std::move (filename);
   trace_fd = scratch_chan;
+  trace_read_offset = 0;
 
   /* Make sure this is clear.  */
   trace_tdesc.clear ();
@@ -543,6 +639,20 @@ tfile_target_open (const char *arg, int from_tty)
 	 traceframes.  */
       if (trace_regblock_size == 0)
 	error (_("No register block size recorded in trace file"));
+
+      trace_file_size = lseek (trace_fd, 0, SEEK_END);
+      lseek (trace_fd, trace_frames_offset, SEEK_SET);
+      trace_read_offset = trace_frames_offset;
+
+#ifdef HAVE_SYS_MMAN_H
+      /* Map the whole file.  If the mapping fails, everything below
+	 falls back to reading through the file descriptor.  */
+      if (trace_file_size > 0)
+	trace_map.reset (nullptr, trace_file_size, PROT_READ, MAP_PRIVATE,
+			 trace_fd, 0);
+#endif
+
+      build_trace_frame_index ();
     }
   catch (const gdb_exception &ex)
     {
@@ -608,6 +718,50 @@ tfile_interp_line (const char *line, struct uploaded_tp **utpp,
     warning (_("Ignoring trace file definition \"%s\""), line);
 }
 
+/* Scan the traceframe section of the file once and record, for every
+   frame, its offset, tracepoint number and data size.  "tfind" then
+   iterates over this index in memory instead of re-walking the file
+   on every search.  If the file is truncated, the frames that could
+   be indexed remain usable.  */
+
+static void
+build_trace_frame_index ()
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (target_gdbarch ());
+  off_t offset = trace_frames_offset;
+
+  trace_frame_index.clear ();
+
+  try
+    {
+      while (1)
+	{
+	  gdb_byte header[4];
+	  short tpnum;
+	  unsigned int data_size;
+
+	  tfile_seek (offset);
+	  tfile_read (header, 2);
+	  tpnum = (short) extract_signed_integer (header, 2, byte_order);
+	  if (tpnum == 0)
+	    break;
+
+	  tfile_read (header, 4);
+	  data_size = (unsigned int) extract_unsigned_integer (header, 4,
+							       byte_order);
+
+	  trace_frame_index.push_back ({ offset, tpnum, data_size });
+	  offset += 2 + 4 + (off_t) data_size;
+	}
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      warning (_("Trace file is truncated; "
+		 "%s complete traceframes are usable."),
+	       pulongest (trace_frame_index.size ()));
+    }
+}
+
 /* Close the trace file and generally clean up.  */
 
 void
@@ -618,6 +772,12 @@ tfile_target::close ()
   switch_to_no_thread ();	/* Avoid confusion from thread stuff.  */
   exit_inferior (current_inferior ());
 
+#ifdef HAVE_SYS_MMAN_H
+  trace_map.reset ();
+#endif
+  trace_frame_index.clear ();
+  trace_file_size = 0;
+
   ::close (trace_fd);
   trace_fd = -1;
   trace_filename.reset ();
@@ -639,53 +799,37 @@ tfile_target::get_tracepoint_status (tracepoint *tp, struct uploaded_tp *utp)
      trace files, so nothing to do here.  */
 }
 
-/* Given the position of a traceframe in the file, figure out what
-   address the frame was collected at.  This would normally be the
-   value of a collected PC register, but if not available, we
-   improvise.  */
+/* Given a traceframe, figure out what address the frame was
+   collected at.  This would normally be the value of a collected PC
+   register, but if not available, we improvise.  */
 
 static CORE_ADDR
-tfile_get_traceframe_address (off_t tframe_offset)
+tfile_get_traceframe_address (const tfile_traceframe &tframe)
 {
   CORE_ADDR addr = 0;
-  short tpnum;
   struct tracepoint *tp;
-  off_t saved_offset = cur_offset;
 
   /* FIXME dig pc out of collected registers.  */
 
   /* Fall back to using tracepoint address.  */
-  lseek (trace_fd, tframe_offset, SEEK_SET);
-  tfile_read ((gdb_byte *) &tpnum, 2);
-  tpnum = (short) extract_signed_integer ((gdb_byte *) &tpnum, 2,
-					  gdbarch_byte_order
-					      (target_gdbarch ()));
-
-  tp = get_tracepoint_by_number_on_target (tpnum);
+  tp = get_tracepoint_by_number_on_target (tframe.tpnum);
   /* FIXME this is a poor heuristic if multiple locations.  */
   if (tp != nullptr && tp->has_locations ())
     addr = tp->first_loc ().address;
 
-  /* Restore our seek position.  */
-  cur_offset = saved_offset;
-  lseek (trace_fd, cur_offset, SEEK_SET);
   return addr;
 }
 
-/* Given a type of search and some parameters, scan the collection of
-   traceframes in the file looking for a match.  When found, return
-   both the traceframe and tracepoint number, otherwise -1 for
-   each.  */
+/* Given a type of search and some parameters, scan the traceframe
+   index looking for a match.  When found, return both the traceframe
+   and tracepoint number, otherwise -1 for each.  */
 
 int
 tfile_target::trace_find (enum trace_find_type type, int num,
 			  CORE_ADDR addr1, CORE_ADDR addr2, int *tpp)
 {
-  short tpnum;
   int tfnum = 0, found = 0;
-  unsigned int data_size;
   struct tracepoint *tp;
-  off_t offset, tframe_offset;
   CORE_ADDR tfaddr;
 
   if (num == -1)
@@ -695,24 +839,8 @@ tfile_target::trace_find (enum trace_find_type type, int num,
       return -1;
     }
 
-  lseek (trace_fd, trace_frames_offset, SEEK_SET);
-  offset = trace_frames_offset;
-  while (1)
+  for (const tfile_traceframe &tframe : trace_frame_index)
     {
-      tframe_offset = offset;
-      tfile_read ((gdb_byte *) &tpnum, 2);
-      tpnum = (short) extract_signed_integer ((gdb_byte *) &tpnum, 2,
-					      gdbarch_byte_order
-						  (target_gdbarch ()));
-      offset += 2;
-      if (tpnum == 0)
-	break;
-      tfile_read ((gdb_byte *) &data_size, 4);
-      data_size = (unsigned int) extract_unsigned_integer
-				     ((gdb_byte *) &data_size, 4,
-				      gdbarch_byte_order (target_gdbarch ()));
-      offset += 4;
-
       if (type == tfind_number)
 	{
 	  /* Looking for a specific trace frame.  */
@@ -727,22 +855,22 @@ tfile_target::trace_find (enum trace_find_type type, int num,
 	      switch (type)
 		{
 		case tfind_pc:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
+		  tfaddr = tfile_get_traceframe_address (tframe);
 		  if (tfaddr == addr1)
 		    found = 1;
 		  break;
 		case tfind_tp:
 		  tp = get_tracepoint (num);
-		  if (tp && tpnum == tp->number_on_target)
+		  if (tp && tframe.tpnum == tp->number_on_target)
 		    found = 1;
 		  break;
 		case tfind_range:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
+		  tfaddr = tfile_get_traceframe_address (tframe);
 		  if (addr1 <= tfaddr && tfaddr <= addr2)
 		    found = 1;
 		  break;
 		case tfind_outside:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
+		  tfaddr = tfile_get_traceframe_address (tframe);
 		  if (!(addr1 <= tfaddr && tfaddr <= addr2))
 		    found = 1;
 		  break;
@@ -755,15 +883,14 @@ tfile_target::trace_find (enum trace_find_type type, int num,
       if (found)
 	{
 	  if (tpp)
-	    *tpp = tpnum;
-	  cur_offset = offset;
-	  cur_data_size = data_size;
+	    *tpp = tframe.tpnum;
+	  /* The frame's data follows the 2-byte tracepoint number and
+	     the 4-byte data size of its header.  */
+	  cur_offset = tframe.offset + 2 + 4;
+	  cur_data_size = tframe.data_size;
 
 	  return tfnum;
 	}
-      /* Skip past the traceframe's data.  */
-      lseek (trace_fd, data_size, SEEK_CUR);
-      offset += data_size;
       /* Update our own count of traceframes.  */
       ++tfnum;
     }
@@ -786,7 +913,7 @@ traceframe_walk_blocks (gdb::function_view<bool (char)> callback, int pos)
   /* Iterate through a traceframe's blocks, looking for a block of the
      requested type.  */
 
-  lseek (trace_fd, cur_offset + pos, SEEK_SET);
+  tfile_seek (cur_offset + pos);
   while (pos < cur_data_size)
     {
       unsigned short mlen;
@@ -802,21 +929,21 @@ traceframe_walk_blocks (gdb::function_view<bool (char)> callback, int pos)
       switch (block_type)
 	{
 	case 'R':
-	  lseek (trace_fd, cur_offset + pos + trace_regblock_size, SEEK_SET);
+	  tfile_skip (trace_regblock_size);
 	  pos += trace_regblock_size;
 	  break;
 	case 'M':
-	  lseek (trace_fd, cur_offset + pos + 8, SEEK_SET);
+	  tfile_skip (8);
 	  tfile_read ((gdb_byte *) &mlen, 2);
 	  mlen = (unsigned short)
 		extract_unsigned_integer ((gdb_byte *) &mlen, 2,
 					  gdbarch_byte_order
 					      (target_gdbarch ()));
-	  lseek (trace_fd, mlen, SEEK_CUR);
+	  tfile_skip (mlen);
 	  pos += (8 + 2 + mlen);
 	  break;
 	case 'V':
-	  lseek (trace_fd, cur_offset + pos + 4 + 8, SEEK_SET);
+	  tfile_skip (4 + 8);
 	  pos += (4 + 8);
 	  break;
 	default:
@@ -858,9 +985,17 @@ tfile_target::fetch_registers (struct regcache *regcache, int regno)
 
   if (traceframe_find_block_type ('R', 0) >= 0)
     {
-      gdb_byte *regs = (gdb_byte *) alloca (trace_regblock_size);
+      /* Serve the register block straight out of the file mapping if
+	 there is one, copying it only as a fallback.  */
+      const gdb_byte *regs = tfile_access (trace_regblock_size);
+
+      if (regs == nullptr)
+	{
+	  gdb_byte *regs_buf = (gdb_byte *) alloca (trace_regblock_size);
 
-      tfile_read (regs, trace_regblock_size);
+	  tfile_read (regs_buf, trace_regblock_size);
+	  regs = regs_buf;
+	}
 
       for (regn = 0; regn < gdbarch_num_regs (gdbarch); regn++)
 	{
@@ -967,7 +1102,7 @@ tfile_target::xfer_partial (enum target_object object,
 		amt = len;
 
 	      if (maddr != offset)
-		lseek (trace_fd, offset - maddr, SEEK_CUR);
+		tfile_skip (offset - maddr);
 	      tfile_read (readbuf, amt);
 	      *xfered_len = amt;
 	      return TARGET_XFER_OK;
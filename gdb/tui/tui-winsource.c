@@ -598,7 +598,8 @@ void
 tui_source_window_base::set_is_exec_point_at (struct tui_line_or_address l,
 					      int column_no)
 {
-  bool changed = false;
+  /* The lines whose rendering is affected by this update.  */
+  std::vector<int> dirty_lines;
   int i;
 
   i = 0;
@@ -616,20 +617,40 @@ tui_source_window_base::set_is_exec_point_at (struct tui_line_or_address l,
 	new_state = false;
       if (new_state != m_content[i].is_exec_point)
 	{
-	  changed = true;
+	  dirty_lines.push_back (i);
 	  m_content[i].is_exec_point = new_state;
           m_content[i].exec_column = l.loa == LOA_LINE ? column_no : 0;
 	}
       else if (new_state && m_content[i].is_exec_point && l.loa == LOA_LINE
 	       && m_content[i].exec_column != column_no)
 	{
-          changed = true;
+	  dirty_lines.push_back (i);
           m_content[i].exec_column = column_no;
 	}
       i++;
     }
-  if (changed)
-    refill ();
+
+  if (!dirty_lines.empty ())
+    {
+      /* The window still shows the same page and only the
+	 execution-point marking of DIRTY_LINES changed, so repaint
+	 just those lines instead of reloading the source and
+	 redrawing the whole window, which is what refill would do.
+	 If the pad has not been created yet we cannot repaint
+	 anything; fall back to the full reload.  */
+      if (m_pad == nullptr)
+	refill ();
+      else
+	{
+	  for (int lineno : dirty_lines)
+	    {
+	      wmove (m_pad.get (), lineno, 0);
+	      wclrtoeol (m_pad.get ());
+	      show_source_line (lineno);
+	    }
+	  update_exec_info (true);
+	}
+    }
 }
 
 /* See tui-winsource.h.  */
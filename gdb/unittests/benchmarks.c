@@ -0,0 +1,141 @@
+/* Initial microbenchmarks for GDB, the GNU debugger.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "benchmark.h"
+#include "frame.h"
+#include "gdbcore.h"
+#include "minsyms.h"
+#include "objfiles.h"
+#include "symtab.h"
+#include "target.h"
+#include "value.h"
+
+namespace benchmarks {
+
+/* Parse and evaluate a small constant expression.  */
+
+static void
+parse_and_eval_benchmark (unsigned long n_iterations)
+{
+  for (unsigned long i = 0; i < n_iterations; i++)
+    {
+      /* Release the values of each iteration, or they would
+	 accumulate until the end of the command.  */
+      scoped_value_mark mark;
+
+      parse_and_eval ("(1 + 2 * 3 - 4) / 5");
+    }
+}
+
+/* Resolve PCs sampled from the loaded minimal symbols back to
+   symbols.  */
+
+static void
+minsym_lookup_by_pc_benchmark (unsigned long n_iterations)
+{
+  std::vector<CORE_ADDR> pcs;
+
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      for (minimal_symbol *msym : objfile->msymbols ())
+	{
+	  pcs.push_back (msym->value_address (objfile));
+	  if (pcs.size () == 256)
+	    break;
+	}
+      if (pcs.size () == 256)
+	break;
+    }
+
+  if (pcs.empty ())
+    skip_benchmark (_("no minimal symbols are loaded"));
+
+  for (unsigned long i = 0; i < n_iterations; i++)
+    lookup_minimal_symbol_by_pc (pcs[i % pcs.size ()]);
+}
+
+/* Look up a global symbol by name.  Alternating between a name that
+   exists and one that does not exercises both the lookup cache and
+   the full index scan a miss requires.  */
+
+static void
+symbol_lookup_benchmark (unsigned long n_iterations)
+{
+  if (current_program_space->symfile_object_file == nullptr)
+    skip_benchmark (_("no symbol file is loaded"));
+
+  for (unsigned long i = 0; i < n_iterations; i++)
+    lookup_symbol (i % 2 == 0 ? "main" : "symbol_that_does_not_exist",
+		   nullptr, VAR_DOMAIN, nullptr);
+}
+
+/* Read a small block of target memory over and over; with the code or
+   stack cache enabled this measures the dcache hit path, otherwise
+   the raw target read path.  */
+
+static void
+target_read_memory_benchmark (unsigned long n_iterations)
+{
+  if (!target_has_memory ())
+    skip_benchmark (_("no target with memory"));
+  if (current_program_space->symfile_object_file == nullptr)
+    skip_benchmark (_("no symbol file is loaded"));
+
+  CORE_ADDR addr = entry_point_address ();
+  gdb_byte buf[64];
+
+  for (unsigned long i = 0; i < n_iterations; i++)
+    if (target_read_memory (addr, buf, sizeof (buf)) != 0)
+      skip_benchmark (_("cannot read memory at the entry point"));
+}
+
+/* Unwind one frame from scratch: sniff the current frame and compute
+   its caller.  */
+
+static void
+frame_unwind_benchmark (unsigned long n_iterations)
+{
+  if (!target_has_stack ())
+    skip_benchmark (_("no running target with a stack"));
+
+  for (unsigned long i = 0; i < n_iterations; i++)
+    {
+      reinit_frame_cache ();
+      get_prev_frame (get_current_frame ());
+    }
+}
+
+} /* namespace benchmarks */
+
+void _initialize_benchmarks ();
+void
+_initialize_benchmarks ()
+{
+  benchmarks::register_benchmark ("parse-and-eval",
+				  benchmarks::parse_and_eval_benchmark);
+  benchmarks::register_benchmark
+    ("minsym-lookup-by-pc", benchmarks::minsym_lookup_by_pc_benchmark);
+  benchmarks::register_benchmark ("symbol-lookup",
+				  benchmarks::symbol_lookup_benchmark);
+  benchmarks::register_benchmark ("target-read-memory",
+				  benchmarks::target_read_memory_benchmark);
+  benchmarks::register_benchmark ("frame-unwind",
+				  benchmarks::frame_unwind_benchmark);
+}
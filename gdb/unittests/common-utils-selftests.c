@@ -77,6 +77,31 @@ string_vprintf_tests ()
   test_format_func (format);
 }
 
+/* Wrap format_buffer in a format_func, so that it can be exercised
+   with the same tests as string_printf.  The large-string tests
+   overflow the internal buffer and cover the heap fallback.  */
+
+static std::string ATTRIBUTE_PRINTF (1, 2)
+format_buffer_wrapper (const char *fmt, ...)
+{
+  va_list vp;
+
+  va_start (vp, fmt);
+  format_buffer buf (fmt, vp);
+  va_end (vp);
+
+  SELF_CHECK (buf.size () == strlen (buf.c_str ()));
+  SELF_CHECK (buf.empty () == (buf.size () == 0));
+
+  return std::string (buf.c_str (), buf.size ());
+}
+
+static void
+format_buffer_tests ()
+{
+  test_format_func (format_buffer_wrapper);
+}
+
 /* Type of both 'string_appendf' and the 'string_vappendf_wrapper'
    function below.  Used to run the same tests against both
    string_appendf and string_vappendf.  */
@@ -134,6 +159,7 @@ _initialize_common_utils_selftests ()
 {
   selftests::register_test ("string_printf", selftests::string_printf_tests);
   selftests::register_test ("string_vprintf", selftests::string_vprintf_tests);
+  selftests::register_test ("format_buffer", selftests::format_buffer_tests);
   selftests::register_test ("string_appendf", selftests::string_appendf_tests);
   selftests::register_test ("string_vappendf",
 			    selftests::string_vappendf_tests);
@@ -0,0 +1,103 @@
+/* Self tests for scoped_arena for GDB, the GNU debugger.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "gdbsupport/selftest.h"
+#include "gdbsupport/scoped-arena.h"
+
+namespace selftests {
+namespace scoped_arena_tests {
+
+/* Appends its tag to a log on destruction, to observe destruction
+   order.  */
+
+struct tagged
+{
+  tagged (std::vector<int> *log, int tag)
+    : m_log (log), m_tag (tag)
+  {}
+
+  ~tagged ()
+  { m_log->push_back (m_tag); }
+
+private:
+  std::vector<int> *m_log;
+  int m_tag;
+};
+
+static void
+run_tests ()
+{
+  /* Entering a scope installs the arena as current; leaving it
+     restores whatever was current before (possibly the arena of the
+     command running this test).  */
+  gdb::scoped_arena *prev = gdb::scoped_arena::current ();
+  {
+    gdb::scoped_arena outer;
+    SELF_CHECK (gdb::scoped_arena::current () == &outer);
+    {
+      gdb::scoped_arena inner;
+      SELF_CHECK (gdb::scoped_arena::current () == &inner);
+    }
+    SELF_CHECK (gdb::scoped_arena::current () == &outer);
+
+    /* Raw allocations are usable and distinct.  */
+    int *a = (int *) outer.allocate (sizeof (int));
+    int *b = (int *) outer.allocate (sizeof (int));
+    SELF_CHECK (a != b);
+    *a = 1;
+    *b = 2;
+    SELF_CHECK (*a == 1 && *b == 2);
+  }
+  SELF_CHECK (gdb::scoped_arena::current () == prev);
+
+  /* Emplaced objects are destroyed newest-first when the arena goes
+     out of scope.  */
+  std::vector<int> log;
+  {
+    gdb::scoped_arena arena;
+    arena.emplace<tagged> (&log, 1);
+    arena.emplace<tagged> (&log, 2);
+    arena.emplace<tagged> (&log, 3);
+    SELF_CHECK (log.empty ());
+  }
+  SELF_CHECK (log == std::vector<int> ({3, 2, 1}));
+
+  /* A container using arena_allocator draws from the current arena;
+     the blocks discarded as it grows are reclaimed wholesale with the
+     arena.  */
+  {
+    gdb::scoped_arena arena;
+    std::vector<int, gdb::arena_allocator<int>> vec;
+    for (int i = 0; i < 100; i++)
+      vec.push_back (i);
+    SELF_CHECK (vec.size () == 100 && vec[99] == 99);
+  }
+}
+
+} /* namespace scoped_arena_tests */
+} /* namespace selftests */
+
+void _initialize_scoped_arena_selftests ();
+void
+_initialize_scoped_arena_selftests ()
+{
+  selftests::register_test ("scoped_arena",
+			    selftests::scoped_arena_tests::run_tests);
+}
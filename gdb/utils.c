@@ -1685,9 +1685,29 @@ pager_file::puts (const char *linebuffer)
 	    }
 	  else
 	    {
-	      m_wrap_buffer.push_back (*lineptr);
-	      chars_printed++;
-	      lineptr++;
+	      /* An ordinary character starts a run of them; copy the
+		 whole run at once rather than byte by byte.  The run
+		 ends at the next character needing special handling,
+		 and is capped so that the line-overflow check below
+		 still fires at exactly the column it used to.  */
+	      size_t run = strcspn (lineptr, "\n\t\r\033");
+
+	      /* An unrecognized escape sequence is printed as an
+		 ordinary character, so the run may legitimately start
+		 with one of the stop characters.  */
+	      if (run == 0)
+		run = 1;
+
+	      if (chars_per_line != UINT_MAX)
+		{
+		  size_t room = (chars_printed < chars_per_line
+				 ? chars_per_line - chars_printed : 1);
+		  run = std::min (run, room);
+		}
+
+	      m_wrap_buffer.append (lineptr, run);
+	      chars_printed += run;
+	      lineptr += run;
 	    }
 
 	  if (chars_printed >= chars_per_line)
@@ -242,10 +242,23 @@ value_subscripted_rvalue (struct value *array, LONGEST index,
 
   if (is_dynamic_type (elt_type))
     {
-      CORE_ADDR address;
+      CORE_ADDR address = array->address () + elt_offs;
+
+      /* If the element's bytes have already been fetched as part of
+	 the array, resolve from them; this matters when the element
+	 type has a variant part (a Rust enum, say), where resolving
+	 from the address alone costs a target read of the
+	 discriminant for every element.  For a lazy array each
+	 element still only reads its discriminant, not the whole
+	 element.  */
+      gdb::array_view<const gdb_byte> elt_view;
+      if (!array->lazy ()
+	  && array->entirely_available ()
+	  && !array->optimized_out ()
+	  && elt_offs + elt_size <= array->contents ().size ())
+	elt_view = array->contents ().slice (elt_offs, elt_size);
 
-      address = array->address () + elt_offs;
-      elt_type = resolve_dynamic_type (elt_type, {}, address);
+      elt_type = resolve_dynamic_type (elt_type, elt_view, address);
     }
 
   return value_from_component (array, elt_type, elt_offs);
@@ -42,6 +42,7 @@
 #include "gdbtypes.h"
 #include "gdbsupport/byte-vector.h"
 #include "typeprint.h"
+#include <algorithm>
 
 /* Local functions.  */
 
@@ -3200,6 +3201,60 @@ find_oload_champ_namespace_loop (gdb::array_view<value *> args,
     }
 }
 
+/* One argument's contribution to an overload-resolution cache key.
+   The argument's type, whether it is an rvalue and whether it is a
+   literal integer zero are the only properties of an argument value
+   that rank_function inspects.  */
+
+struct oload_cache_arg
+{
+  struct type *type;
+  bool rvalue;
+  bool zero;
+
+  bool operator== (const oload_cache_arg &other) const
+  {
+    return (type == other.type
+	    && rvalue == other.rvalue
+	    && zero == other.zero);
+  }
+};
+
+/* A memoized overload resolution.  CANDIDATES identifies the
+   candidate set: the fn_fieldlist pointer for methods, or the list
+   of function symbols otherwise.  */
+
+struct oload_cache_entry
+{
+  std::vector<const void *> candidates;
+  std::vector<oload_cache_arg> args;
+  size_t num_fns;
+  bool strict;
+
+  /* The memoized results of find_oload_champ.  */
+  int champ;
+  badness_vector champ_bv;
+};
+
+/* The number of entries retained in the overload-resolution cache.  */
+
+#define OLOAD_CACHE_SIZE 256
+
+/* Memoized overload resolutions, most recently used first.  The
+   cache is flushed whenever the set of loaded objfiles changes,
+   because the keys and the ranks refer to types and symbols owned by
+   objfiles.  */
+
+static std::vector<oload_cache_entry> oload_cache;
+
+/* Discard all entries from the overload-resolution cache.  */
+
+static void
+oload_cache_flush ()
+{
+  oload_cache.clear ();
+}
+
 /* Look for a function to take ARGS.  Find the best match from among
    the overloaded methods or functions given by METHODS or FUNCTIONS
    or XMETHODS, respectively.  One, and only one of METHODS, FUNCTIONS
@@ -3233,6 +3288,59 @@ find_oload_champ (gdb::array_view<value *> args,
   gdb_assert ((methods != NULL) + (functions != NULL) + (xmethods != NULL)
 	      == 1);
 
+  /* See whether this resolution has been memoized.  Xmethod workers
+     are transient objects and cannot serve as keys; with overload
+     debugging enabled, run the full resolution so the ranks are
+     printed.  */
+  std::vector<const void *> cache_cands;
+  std::vector<oload_cache_arg> cache_args;
+  bool strict = strict_type_checking_p ();
+  bool cacheable = xmethods == NULL && !overload_debug;
+
+  if (cacheable)
+    {
+      if (methods != NULL)
+	cache_cands.push_back (methods);
+      else
+	for (size_t ix = 0; ix < num_fns; ix++)
+	  cache_cands.push_back (functions[ix]);
+
+      cache_args.reserve (args.size ());
+      for (value *arg : args)
+	{
+	  oload_cache_arg key;
+
+	  key.type = arg->type ();
+	  key.rvalue = arg->lval () == not_lval;
+	  key.zero = false;
+	  if (key.type->code () == TYPE_CODE_INT)
+	    {
+	      /* Deciding whether a lazy value is a literal zero would
+		 fetch it; skip the cache instead.  */
+	      if (arg->lazy ())
+		{
+		  cacheable = false;
+		  break;
+		}
+	      key.zero = value_as_long (arg) == 0;
+	    }
+	  cache_args.push_back (key);
+	}
+    }
+
+  if (cacheable)
+    for (auto it = oload_cache.begin (); it != oload_cache.end (); ++it)
+      if (it->num_fns == num_fns
+	  && it->strict == strict
+	  && it->candidates == cache_cands
+	  && it->args == cache_args)
+	{
+	  /* Move the entry to the front of the list.  */
+	  std::rotate (oload_cache.begin (), it, it + 1);
+	  *oload_champ_bv = oload_cache.front ().champ_bv;
+	  return oload_cache.front ().champ;
+	}
+
   /* Consider each candidate in turn.  */
   for (size_t ix = 0; ix < num_fns; ix++)
     {
@@ -3332,6 +3440,15 @@ find_oload_champ (gdb::array_view<value *> args,
 		    oload_champ, oload_ambiguous);
     }
 
+  if (cacheable)
+    {
+      oload_cache.insert (oload_cache.begin (),
+			  { std::move (cache_cands), std::move (cache_args),
+			    num_fns, strict, oload_champ, *oload_champ_bv });
+      if (oload_cache.size () > OLOAD_CACHE_SIZE)
+	oload_cache.pop_back ();
+    }
+
   return oload_champ;
 }
 
@@ -4091,6 +4208,12 @@ value_slice (struct value *array, int lowbound, int length)
     slice_type->set_code (array_type->code ());
 
     if (array->lval () == lval_memory && array->lazy ())
+      /* The parent's contents were never fetched -- and a huge
+	 array's rarely are -- so defer reading the slice until it is
+	 actually needed, instead of fetching the whole parent now.
+	 An already-fetched parent keeps the copying path below: its
+	 recorded bytes (for instance a value-history snapshot) may
+	 differ from current target memory.  */
       slice = value::allocate_lazy (slice_type);
     else
       {
@@ -4185,10 +4308,39 @@ cast_into_complex (struct type *type, struct value *val)
     error (_("cannot cast non-number to complex"));
 }
 
+/* This module's 'new_objfile' observer.  */
+
+static void
+valops_new_objfile_observer (struct objfile *objfile)
+{
+  oload_cache_flush ();
+}
+
+/* This module's 'free_objfile' observer.  */
+
+static void
+valops_free_objfile_observer (struct objfile *objfile)
+{
+  oload_cache_flush ();
+}
+
+/* This module's 'all_objfiles_removed' observer.  */
+
+static void
+valops_all_objfiles_removed (program_space *pspace)
+{
+  oload_cache_flush ();
+}
+
 void _initialize_valops ();
 void
 _initialize_valops ()
 {
+  gdb::observers::new_objfile.attach (valops_new_objfile_observer, "valops");
+  gdb::observers::free_objfile.attach (valops_free_objfile_observer, "valops");
+  gdb::observers::all_objfiles_removed.attach (valops_all_objfiles_removed,
+					       "valops");
+
   add_setshow_boolean_cmd ("overload-resolution", class_support,
 			   &overload_resolution, _("\
 Set overload resolution in evaluating C++ functions."), _("\
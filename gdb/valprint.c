@@ -36,6 +36,7 @@
 #include <ctype.h>
 #include <algorithm>
 #include "gdbsupport/byte-vector.h"
+#include "gdbsupport/scoped-arena.h"
 #include "cli/cli-option.h"
 #include "gdbarch.h"
 #include "cli/cli-style.h"
@@ -45,6 +46,7 @@
 #include "inferior.h"
 #include "gdbsupport/selftest.h"
 #include "selftest-arch.h"
+#include "gdbsupport/parallel-for.h"
 
 /* Maximum number of wchars returned from wchar_iterate.  */
 #define MAX_WCHARS 4
@@ -79,6 +81,21 @@ struct converted_character
   int repeat_count;
 };
 
+/* A vector of converted characters whose scratch storage comes from
+   the arena of the enclosing command, when one is in scope.  */
+
+typedef std::vector<converted_character,
+		    gdb::arena_allocator<converted_character>>
+  converted_character_vector;
+
+/* Like gdb::byte_vector, but drawing scratch storage from the arena
+   of the enclosing command, when one is in scope.  */
+
+typedef std::vector<gdb_byte,
+		    gdb::default_init_allocator<gdb_byte,
+						gdb::arena_allocator<gdb_byte>>>
+  arena_byte_vector;
+
 /* Command lists for set/show print raw.  */
 struct cmd_list_element *setprintrawlist;
 struct cmd_list_element *showprintrawlist;
@@ -129,6 +146,7 @@ struct value_print_options user_print_options =
   true,				/* symbol_print */
   PRINT_MAX_DEPTH_DEFAULT,	/* max_depth */
   1,				/* zero_value_print */
+  false,			/* lazy_printing */
 };
 
 /* Initialize *OPTS to be a copy of the user print options.  */
@@ -1024,6 +1042,23 @@ generic_value_print (struct value *val, struct ui_file *stream, int recurse,
     }
 }
 
+/* Return true if fetching VAL should be deferred because of the
+   "print -lazy" option in OPTIONS, so that the field printers fetch
+   its members individually as each one is reached.  */
+
+static bool
+defer_fetch_for_lazy_printing (struct value *val,
+			       const struct value_print_options *options)
+{
+  if (!options->lazy_printing
+      || !val->lazy ()
+      || val->lval () != lval_memory)
+    return false;
+
+  enum type_code code = check_typedef (val->type ())->code ();
+  return code == TYPE_CODE_STRUCT || code == TYPE_CODE_UNION;
+}
+
 /* Print using the given LANGUAGE the value VAL onto stream STREAM according
    to OPTIONS.
 
@@ -1042,7 +1077,7 @@ common_val_print (struct value *value, struct ui_file *stream, int recurse,
        get a fixed representation of our value.  */
     value = ada_to_fixed_value (value);
 
-  if (value->lazy ())
+  if (value->lazy () && !defer_fetch_for_lazy_printing (value, options))
     value->fetch_lazy ();
 
   struct value_print_options local_opts = *options;
@@ -1131,6 +1166,12 @@ value_check_printable (struct value *val, struct ui_file *stream,
       return 0;
     }
 
+  /* Deciding whether a deferred value is entirely optimized out or
+     unavailable would fetch all of its contents; let the field
+     printers report problems piecewise instead.  */
+  if (defer_fetch_for_lazy_printing (val, options))
+    return 1;
+
   if (val->entirely_optimized_out ())
     {
       if (options->summary && !val_print_scalar_type_p (val->type ()))
@@ -1661,7 +1702,7 @@ print_octal_chars (struct ui_file *stream, const gdb_byte *valaddr,
 static bool
 maybe_negate_by_bytes (const gdb_byte *bytes, unsigned len,
 		       enum bfd_endian byte_order,
-		       gdb::byte_vector *out_vec)
+		       arena_byte_vector *out_vec)
 {
   gdb_byte sign_byte;
   gdb_assert (len > 0);
@@ -1721,7 +1762,7 @@ print_decimal_chars (struct ui_file *stream, const gdb_byte *valaddr,
   int dummy;
   int flip;
 
-  gdb::byte_vector negated_bytes;
+  arena_byte_vector negated_bytes;
   if (is_signed
       && maybe_negate_by_bytes (valaddr, len, byte_order, &negated_bytes))
     {
@@ -1733,7 +1774,8 @@ print_decimal_chars (struct ui_file *stream, const gdb_byte *valaddr,
      as the base 16 number, which is 2 digits per byte.  */
 
   decimal_len = len * 2 * 2;
-  std::vector<unsigned char> digits (decimal_len, 0);
+  std::vector<unsigned char, gdb::arena_allocator<unsigned char>>
+    digits (decimal_len, 0);
 
   /* Ok, we have an unknown number of bytes of data to be printed in
    * decimal.
@@ -1952,6 +1994,249 @@ value_is_zero (struct value *v)
   return true;
 }
 
+/* Return the number of consecutive equal elements, including the
+   first one, in the array of LEN elements of ELTLEN bytes each at
+   BASE, starting at element IDX.  The elements repeat for as long as
+   the buffer equals itself shifted by one element, so the bulk of
+   the work can be done by memcmp over large chunks, which the C
+   library implements with vector instructions.  */
+
+static unsigned int
+count_repeated_elements (const gdb_byte *base, size_t eltlen,
+			 unsigned int idx, unsigned int len)
+{
+  const gdb_byte *start = base + (size_t) idx * eltlen;
+  size_t overlap = (size_t) (len - idx - 1) * eltlen;
+  size_t pos = 0;
+
+  while (pos < overlap)
+    {
+      size_t chunk = std::min (overlap - pos, (size_t) 4096);
+
+      if (memcmp (start + pos, start + pos + eltlen, chunk) == 0)
+	pos += chunk;
+      else
+	{
+	  while (start[pos] == start[pos + eltlen])
+	    pos++;
+	  break;
+	}
+    }
+
+  return 1 + pos / eltlen;
+}
+
+/* An array element (or run of repeated elements) that survived
+   repeat compression and will actually be printed.  Used by
+   value_print_array_elements_parallel, below.  */
+
+struct array_emit_elt
+{
+  /* Index of the first element of the run, relative to the start of
+     the array.  */
+  unsigned int index;
+
+  /* Number of repetitions detected.  */
+  unsigned int reps;
+
+  /* The formatted text of the element, filled in by a worker
+     thread.  */
+  std::string text;
+};
+
+/* Helper for value_print_array_elements.  Print the elements of VAL,
+   formatting them on worker threads, when VAL is a large array of a
+   plain floating-point type.  Converting the element bytes to text
+   dominates the cost of printing such arrays, and depends only on
+   the bytes themselves, so it can be farmed out; the repeat
+   compression pass and the actual output stay on the calling thread,
+   and emit the runs in order.  Return false, without printing
+   anything, if VAL is not suitable, in which case the caller should
+   print it serially.  */
+
+static bool
+value_print_array_elements_parallel (struct value *val,
+				     struct ui_file *stream, int recurse,
+				     const struct value_print_options *options,
+				     unsigned int i)
+{
+  struct type *type = check_typedef (val->type ());
+  struct type *elttype = type->target_type ();
+  struct type *real_elttype = check_typedef (elttype);
+
+  /* Only handle plain floating-point elements printed in their
+     natural format.  These cover the large numeric arrays where
+     formatting time dominates, and their textual form is a pure
+     function of the element bytes, computed below with
+     target_float_to_string.  */
+  if (real_elttype->code () != TYPE_CODE_FLT
+      || options->format != 0
+      || options->output_format != 0
+      || type->bit_stride () != 0)
+    return false;
+
+  /* All elements must be present in the contents buffer, both so
+     that the repeat scan does not need the per-element availability
+     checks of the serial loop and so that every element has bytes to
+     format.  */
+  if (val->lazy ()
+      || val->limited_length () != 0
+      || !val->entirely_available ()
+      || val->optimized_out ())
+    return false;
+
+  LONGEST low_bound, high_bound;
+  if (!get_array_bounds (type, &low_bound, &high_bound)
+      || low_bound > high_bound)
+    return false;
+  unsigned int len = high_bound - low_bound + 1;
+
+  /* Leave small arrays, and large arrays of which only a small
+     print_max prefix will be printed, to the serial path; for those
+     the extra bookkeeping would cost more than it saves.  */
+  if (i >= len || len - i < 10000 || options->print_max < 10000)
+    return false;
+
+  ULONGEST eltlen = real_elttype->length ();
+  unsigned int bit_stride = 8 * eltlen;
+
+  struct type *index_type = type->index_type ();
+  if (index_type->code () == TYPE_CODE_RANGE)
+    index_type = index_type->target_type ();
+
+  /* First pass: run the repeat compression from the serial loop in
+     value_print_array_elements, recording the element runs that will
+     be printed and capturing their bytes for the worker threads.  */
+
+  std::vector<array_emit_elt> records;
+  gdb::byte_vector elt_bytes;
+  unsigned int things_printed = 0;
+  unsigned int idx = i;
+
+  const gdb_byte *contents = val->contents ().data ();
+
+  for (; idx < len && things_printed < options->print_max; idx++)
+    {
+      QUIT;
+
+      const gdb_byte *valaddr = contents + (size_t) idx * eltlen;
+
+      /* If requested, skip printing of zero value fields.  All bytes
+	 of the element are zero iff the first byte is zero and the
+	 element equals itself shifted by one byte.  */
+      if (!options->zero_value_print
+	  && valaddr[0] == 0
+	  && (eltlen == 1
+	      || memcmp (valaddr, valaddr + 1, eltlen - 1) == 0))
+	continue;
+
+      unsigned int reps = 1;
+      /* Only check for reps if repeat_count_threshold is not set to
+	 UINT_MAX (unlimited).  */
+      if (options->repeat_count_threshold < UINT_MAX)
+	reps = count_repeated_elements (contents, eltlen, idx, len);
+
+      if (records.empty ())
+	{
+	  /* Check that formatting this element type with
+	     target_float_to_string reproduces the serial output
+	     exactly.  A pretty-printer matching the element type, or
+	     a language with its own floating-point syntax, would make
+	     the two differ; in that case print serially.  */
+	  scoped_value_mark free_values;
+	  struct value *element
+	    = val->from_component_bitsize (elttype, bit_stride * idx,
+					   bit_stride);
+	  string_file check;
+	  common_val_print (element, &check, recurse + 1, options,
+			    current_language);
+	  if (check.string () != target_float_to_string (valaddr,
+							 real_elttype))
+	    return false;
+	}
+
+      elt_bytes.insert (elt_bytes.end (), valaddr, valaddr + eltlen);
+      records.push_back ({idx, reps, {}});
+
+      if (reps > options->repeat_count_threshold)
+	{
+	  idx += reps - 1;
+	  things_printed += options->repeat_count_threshold;
+	}
+      else
+	things_printed++;
+    }
+
+  /* Second pass: format the recorded elements in parallel.  Each
+     worker only reads the captured bytes and writes the text of its
+     own records.  */
+
+  array_emit_elt *first = records.data ();
+  gdb::parallel_for_each (1024, first, first + records.size (),
+			  [&] (array_emit_elt *start, array_emit_elt *end)
+    {
+      for (array_emit_elt *r = start; r < end; ++r)
+	{
+	  const gdb_byte *bytes = elt_bytes.data () + (r - first) * eltlen;
+	  r->text = target_float_to_string (bytes, real_elttype);
+	}
+    });
+
+  /* Third pass: emit the formatted runs, in order, with the same
+     decorations as the serial loop.  */
+
+  annotate_array_section_begin (i, elttype);
+
+  bool need_comma = i != 0;
+  for (const array_emit_elt &r : records)
+    {
+      QUIT;
+
+      if (need_comma)
+	{
+	  if (options->prettyformat_arrays)
+	    {
+	      gdb_printf (stream, ",\n");
+	      print_spaces (2 + 2 * recurse, stream);
+	    }
+	  else
+	    gdb_printf (stream, ", ");
+	}
+      else if (options->prettyformat_arrays)
+	{
+	  gdb_printf (stream, "\n");
+	  print_spaces (2 + 2 * recurse, stream);
+	}
+      stream->wrap_here (2 + 2 * recurse);
+      maybe_print_array_index (index_type, r.index + low_bound,
+			       stream, options);
+
+      gdb_puts (r.text.c_str (), stream);
+
+      if (r.reps > options->repeat_count_threshold)
+	{
+	  annotate_elt_rep (r.reps);
+	  gdb_printf (stream, " %p[<repeats %u times>%p]",
+		      metadata_style.style ().ptr (), r.reps, nullptr);
+	  annotate_elt_rep_end ();
+	}
+      else
+	annotate_elt ();
+
+      need_comma = true;
+    }
+  annotate_array_section_end ();
+  if (idx < len)
+    gdb_printf (stream, "...");
+  if (options->prettyformat_arrays)
+    {
+      gdb_printf (stream, "\n");
+      print_spaces (2 * recurse, stream);
+    }
+
+  return true;
+}
+
 /* See valprint.h.  */
 
 void
@@ -1960,6 +2245,9 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
 			    const struct value_print_options *options,
 			    unsigned int i)
 {
+  if (value_print_array_elements_parallel (val, stream, recurse, options, i))
+    return;
+
   unsigned int things_printed = 0;
   unsigned len;
   struct type *elttype, *index_type;
@@ -1999,6 +2287,18 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
       len = 0;
     }
 
+  /* When all of the array's bytes are present in the contents
+     buffer, detect repeats directly on the buffer; that is much
+     faster than extracting and comparing a value for every
+     element.  */
+  const gdb_byte *contig = nullptr;
+  if (!val->lazy ()
+      && type->bit_stride () == 0
+      && val->limited_length () == 0
+      && val->entirely_available ()
+      && !val->optimized_out ())
+    contig = val->contents ().data ();
+
   annotate_array_section_begin (i, elttype);
 
   bool need_comma = i != 0;
@@ -2037,7 +2337,12 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
       reps = 1;
       /* Only check for reps if repeat_count_threshold is not set to
 	 UINT_MAX (unlimited).  */
-      if (options->repeat_count_threshold < UINT_MAX)
+      if (options->repeat_count_threshold < UINT_MAX && contig != nullptr)
+	{
+	  reps = count_repeated_elements (contig, bit_stride / 8, i, len);
+	  rep1 = i + reps;
+	}
+      else if (options->repeat_count_threshold < UINT_MAX)
 	{
 	  bool unavailable = element->entirely_unavailable ();
 	  bool available = element->entirely_available ();
@@ -2304,7 +2609,7 @@ generic_emit_char (int c, struct type *type, struct ui_file *stream,
 
 static int
 count_next_character (wchar_iterator *iter,
-		      std::vector<converted_character> *vec)
+		      converted_character_vector *vec)
 {
   struct converted_character *current;
 
@@ -2399,7 +2704,7 @@ count_next_character (wchar_iterator *iter,
 
 static void
 print_converted_chars_to_obstack (struct obstack *obstack,
-				  const std::vector<converted_character> &chars,
+				  const converted_character_vector &chars,
 				  int quote_char, int width,
 				  enum bfd_endian byte_order,
 				  const struct value_print_options *options,
@@ -2556,6 +2861,42 @@ print_converted_chars_to_obstack (struct obstack *obstack,
     }
 }
 
+/* Helper for generic_printstr.  Return the length, in characters of
+   WIDTH bytes each, of the null-terminated string at STRING,
+   counting the terminating null character.  */
+
+static unsigned int
+find_string_terminator (const gdb_byte *string, int width)
+{
+  /* The terminator is WIDTH zero bytes, which look the same in
+     either byte order, so candidate zero bytes can be found with
+     memchr, which the C library implements with vector
+     instructions.  */
+  const gdb_byte *p = string;
+
+  for (;;)
+    {
+      QUIT;
+
+      p = (const gdb_byte *) memchr (p, 0, PTRDIFF_MAX);
+      gdb_assert (p != nullptr);
+
+      /* Check whether the character containing the zero byte is zero
+	 throughout.  */
+      size_t char_index = (p - string) / width;
+      const gdb_byte *chr = string + char_index * width;
+
+      int j;
+      for (j = 0; j < width; j++)
+	if (chr[j] != 0)
+	  break;
+      if (j == width)
+	return char_index + 1;
+
+      p = chr + width;
+    }
+}
+
 /* Print the character string STRING, printing at most LENGTH
    characters.  LENGTH is -1 if the string is nul terminated.  TYPE is
    the type of each character.  OPTIONS holds the printing options;
@@ -2580,17 +2921,7 @@ generic_printstr (struct ui_file *stream, struct type *type,
   struct converted_character *last;
 
   if (length == -1)
-    {
-      unsigned long current_char = 1;
-
-      for (i = 0; current_char; ++i)
-	{
-	  QUIT;
-	  current_char = extract_unsigned_integer (string + i * width,
-						   width, byte_order);
-	}
-      length = i;
-    }
+    length = find_string_terminator (string, width);
 
   /* If the string was not truncated due to `set print elements', and
      the last byte of it is a null, we don't print that, in
@@ -2610,7 +2941,7 @@ generic_printstr (struct ui_file *stream, struct type *type,
 
   /* Arrange to iterate over the characters, in wchar_t form.  */
   wchar_iterator iter (string, length * width, encoding, width);
-  std::vector<converted_character> converted_chars;
+  converted_character_vector converted_chars;
 
   /* Convert characters until the string is over or the maximum
      number of printed characters has been reached.  */
@@ -3029,6 +3360,18 @@ static const gdb::option::option_def value_print_option_defs[] = {
        "is set to \"elements\"."),
   },
 
+  boolean_option_def {
+    "lazy",
+    [] (value_print_options *opt) { return &opt->lazy_printing; },
+    NULL, /* show_cmd_cb */
+    N_("Set whether to fetch aggregate members on demand."),
+    N_("Show whether to fetch aggregate members on demand."),
+    N_("If set, the members of a structure or union residing in memory\n\
+are read and formatted one at a time as they are printed, so output\n\
+starts before the whole object has been fetched.  Such a print does\n\
+not enter the value into the value history.")
+  },
+
   pinteger_option_def {
     "max-depth",
     [] (value_print_options *opt) { return &opt->max_depth; },
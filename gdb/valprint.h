@@ -120,6 +120,12 @@ struct value_print_options
 
   /* If true, print fields with a zero value.  */
   bool zero_value_print;
+
+  /* If true, fetch the fields of a memory-resident aggregate on
+     demand as each one is printed, instead of reading the whole
+     object before any output appears.  Set by "print -lazy"; such a
+     print does not record the value in the value history.  */
+  bool lazy_printing;
 };
 
 /* The value to use for `print_max_chars' to follow `print_max'.  */
@@ -934,10 +934,28 @@ value::allocate_contents (bool check_size)
 	    check_type_length_before_alloc (enc_type);
 	}
 
-      m_contents.reset ((gdb_byte *) xzalloc (len));
+      m_contents.reset ((gdb_byte *) xzalloc (len),
+			gdb::xfree_deleter<gdb_byte> ());
     }
 }
 
+/* See value.h.  */
+
+void
+value::unshare_contents ()
+{
+  if (m_contents == nullptr || m_contents.use_count () == 1)
+    return;
+
+  ULONGEST length = m_limited_length;
+  if (length == 0)
+    length = enclosing_type ()->length ();
+
+  gdb_byte *unshared = (gdb_byte *) xmalloc (length);
+  memcpy (unshared, m_contents.get (), length);
+  m_contents.reset (unshared, gdb::xfree_deleter<gdb_byte> ());
+}
+
 /* Allocate a value and its contents for type TYPE.  If CHECK_SIZE is true,
    then apply the usual max-value-size checks.  */
 
@@ -1011,6 +1029,7 @@ value::contents_raw ()
   int unit_size = gdbarch_addressable_memory_unit_size (arch ());
 
   allocate_contents (true);
+  unshare_contents ();
 
   ULONGEST length = type ()->length ();
   return gdb::make_array_view
@@ -1021,6 +1040,7 @@ gdb::array_view<gdb_byte>
 value::contents_all_raw ()
 {
   allocate_contents (true);
+  unshare_contents ();
 
   ULONGEST length = enclosing_type ()->length ();
   return gdb::make_array_view (m_contents.get (), length);
@@ -1192,9 +1212,14 @@ value::contents_copy_raw (struct value *dst, LONGEST dst_offset,
   gdb::array_view<gdb_byte> dst_contents
     = dst->contents_all_raw ().slice (dst_offset * unit_size,
 				      copy_length * unit_size);
+  /* Build the source view directly over the buffer instead of using
+     contents_all_raw, so that copying out of a value whose buffer is
+     shared (see value::copy) does not force a private copy.  */
+  allocate_contents (true);
   gdb::array_view<const gdb_byte> src_contents
-    = contents_all_raw ().slice (src_offset * unit_size,
-				 copy_length * unit_size);
+    = gdb::make_array_view (m_contents.get (),
+			    enclosing_type ()->length ())
+	.slice (src_offset * unit_size, copy_length * unit_size);
   gdb::copy (src_contents, dst_contents);
 
   /* Copy the meta-data, adjusted.  */
@@ -1261,7 +1286,21 @@ value::contents_copy (struct value *dst, LONGEST dst_offset,
 gdb::array_view<const gdb_byte>
 value::contents ()
 {
-  gdb::array_view<const gdb_byte> result = contents_writeable ();
+  if (m_lazy)
+    fetch_lazy ();
+
+  /* Read through the buffer directly rather than going through
+     contents_writeable, so that reading the contents of a value whose
+     buffer is shared (see value::copy) does not force a private
+     copy.  */
+  allocate_contents (true);
+
+  int unit_size = gdbarch_addressable_memory_unit_size (arch ());
+  ULONGEST length = type ()->length ();
+  gdb::array_view<const gdb_byte> result
+    = gdb::make_array_view (m_contents.get () + m_embedded_offset * unit_size,
+			    length);
+
   require_not_optimized_out ();
   require_available ();
   return result;
@@ -1520,19 +1559,12 @@ value::copy () const
       && !(val->entirely_optimized_out ()
 	   || val->entirely_unavailable ()))
     {
-      ULONGEST length = val->m_limited_length;
-      if (length == 0)
-	length = val->enclosing_type ()->length ();
-
       gdb_assert (m_contents != nullptr);
-      const auto &arg_view
-	= gdb::make_array_view (m_contents.get (), length);
-
-      val->allocate_contents (false);
-      gdb::array_view<gdb_byte> val_contents
-	= val->contents_all_raw ().slice (0, length);
 
-      gdb::copy (arg_view, val_contents);
+      /* Share the contents buffer rather than duplicating it.  The
+	 buffer is copied lazily, if and when either value is written
+	 to (see unshare_contents).  */
+      val->m_contents = m_contents;
     }
 
   if (val->lval () == lval_computed)
@@ -1659,6 +1691,143 @@ value::set_component_location (const struct value *whole)
 
 /* Access to the value history.  */
 
+/* The anonymous temporary file backing spilled value history
+   contents, and the offset at which the next spilled contents will
+   be written.  Created on first use; the operating system reclaims
+   it when GDB exits.  Space is never reclaimed within a session,
+   but it is also never duplicated: a history value keeps its file
+   offset forever, so spilling it again after it was read back does
+   not grow the file.  */
+static FILE *value_history_spill_file;
+static LONGEST value_history_spill_next_offset;
+
+/* Maximum number of bytes of value contents the value history keeps
+   resident; -1 means unlimited.  When the limit is exceeded, the
+   contents of the oldest history entries are spilled to
+   VALUE_HISTORY_SPILL_FILE.  */
+static int max_value_history_size = -1;
+
+/* See value.h.  */
+
+ULONGEST
+value::history_spillable_length () const
+{
+  /* Only a plain resident buffer is worth spilling.  A shared buffer
+     (see value::copy) would stay alive through the other reference,
+     and a value that something other than the history still
+     references may have its contents read directly, without going
+     through access_value_history.  */
+  if (m_contents == nullptr
+      || m_lazy
+      || m_reference_count > 1
+      || m_contents.use_count () > 1)
+    return 0;
+
+  ULONGEST length = m_limited_length;
+  if (length == 0)
+    length = enclosing_type ()->length ();
+  return length;
+}
+
+/* See value.h.  */
+
+bool
+value::spill_to_history_file ()
+{
+  gdb_assert (m_in_history);
+
+  ULONGEST length = history_spillable_length ();
+  if (length == 0)
+    return false;
+
+  if (value_history_spill_file == nullptr)
+    {
+      value_history_spill_file = tmpfile ();
+      if (value_history_spill_file == nullptr)
+	return false;
+    }
+
+  if (m_history_spill_offset < 0)
+    {
+      /* This value has not been spilled before; append its contents
+	 to the file.  Values already spilled once keep their old
+	 file copy, which is still valid because history values never
+	 change.  */
+      if (value_history_spill_next_offset > LONG_MAX - (LONGEST) length
+	  || fseek (value_history_spill_file,
+		    (long) value_history_spill_next_offset, SEEK_SET) != 0
+	  || fwrite (m_contents.get (), 1, length,
+		     value_history_spill_file) != length)
+	return false;
+
+      m_history_spill_offset = value_history_spill_next_offset;
+      value_history_spill_next_offset += length;
+    }
+
+  m_contents.reset ();
+  return true;
+}
+
+/* See value.h.  */
+
+void
+value::fetch_from_history_file ()
+{
+  if (m_history_spill_offset < 0 || m_contents != nullptr)
+    return;
+
+  ULONGEST length = m_limited_length;
+  if (length == 0)
+    length = enclosing_type ()->length ();
+
+  gdb_byte *buf = (gdb_byte *) xmalloc (length);
+  if (fseek (value_history_spill_file, (long) m_history_spill_offset,
+	     SEEK_SET) != 0
+      || fread (buf, 1, length, value_history_spill_file) != length)
+    {
+      xfree (buf);
+      error (_("Failed to read value contents back from the value "
+	       "history spill file."));
+    }
+  m_contents.reset (buf, gdb::xfree_deleter<gdb_byte> ());
+}
+
+/* If the contents kept resident by the value history exceed
+   max-value-history-size, spill the contents of the oldest entries
+   to the history spill file until the total is back under the
+   limit.  The most recent entries are never spilled, because the
+   value just recorded may still be referenced by raw pointers in
+   the code that recorded it.  */
+
+static void
+value_history_enforce_limit ()
+{
+  if (max_value_history_size < 0)
+    return;
+
+  /* Number of trailing entries exempt from spilling.  */
+  const size_t keep = 10;
+
+  if (value_history.size () <= keep)
+    return;
+
+  ULONGEST resident = 0;
+  for (const value_ref_ptr &val : value_history)
+    resident += val->history_spillable_length ();
+
+  for (size_t i = 0;
+       (i < value_history.size () - keep
+	&& resident > (ULONGEST) max_value_history_size);
+       i++)
+    {
+      value *val = value_history[i].get ();
+      ULONGEST length = val->history_spillable_length ();
+
+      if (length != 0 && val->spill_to_history_file ())
+	resident -= length;
+    }
+}
+
 /* Record a new value in the value history.
    Returns the absolute history index of the entry.  */
 
@@ -1700,6 +1869,8 @@ value::record_latest ()
 
   value_history.push_back (release_value (this));
 
+  value_history_enforce_limit ();
+
   return value_history.size ();
 }
 
@@ -1727,6 +1898,8 @@ access_value_history (int num)
 
   absnum--;
 
+  value_history[absnum]->fetch_from_history_file ();
+
   return value_history[absnum]->copy ();
 }
 
@@ -2934,8 +3107,21 @@ value::set_enclosing_type (struct type *new_encl_type)
   if (new_encl_type->length () > enclosing_type ()->length ())
     {
       check_type_length_before_alloc (new_encl_type);
-      m_contents.reset ((gdb_byte *) xrealloc (m_contents.release (),
-					       new_encl_type->length ()));
+
+      /* The old buffer may be shared with another value (see
+	 value::copy), so grow into a fresh private buffer rather
+	 than reallocating in place.  */
+      gdb_byte *grown = (gdb_byte *) xzalloc (new_encl_type->length ());
+      if (m_contents != nullptr)
+	{
+	  /* The old buffer may be shorter than the old enclosing type
+	     if only part of a large array was loaded.  */
+	  ULONGEST old_length = m_limited_length;
+	  if (old_length == 0)
+	    old_length = enclosing_type ()->length ();
+	  memcpy (grown, m_contents.get (), old_length);
+	}
+      m_contents.reset (grown, gdb::xfree_deleter<gdb_byte> ());
     }
 
   m_enclosing_type = new_encl_type;
@@ -4041,6 +4227,79 @@ value::fetch_lazy ()
   set_lazy (false);
 }
 
+/* See value.h.  */
+
+void
+value::fetch_lazy_batch (gdb::array_view<value *> vals)
+{
+  std::vector<value *> batch;
+  std::vector<memory_read_request> requests;
+
+  for (value *val : vals)
+    {
+      if (val == nullptr || !val->lazy ())
+	continue;
+
+      /* Only plain memory lvalues can be folded into the batched
+	 read; registers, bitfields, computed and zero values go the
+	 ordinary way.  Targets whose addressable unit is not the
+	 byte are excluded as well, since the batched read counts in
+	 bytes.  */
+      if (val->m_is_zero
+	  || val->bitsize () != 0
+	  || val->lval () != lval_memory
+	  || (gdbarch_addressable_memory_unit_size (val->type ()->arch ())
+	      != 1))
+	{
+	  val->fetch_lazy ();
+	  continue;
+	}
+
+      struct type *type = check_typedef (val->enclosing_type ());
+
+      /* This mirrors the length computation in fetch_lazy_memory.  */
+      LONGEST len = 0;
+      if (val->m_limited_length > 0)
+	len = val->m_limited_length;
+      else if (type->length () > 0)
+	len = type_length_units (type);
+
+      val->allocate_contents (true);
+      gdb_assert (val->m_optimized_out.empty ());
+      gdb_assert (val->m_unavailable.empty ());
+
+      if (len <= 0)
+	{
+	  /* Nothing to read; the value is fetched anyway -- all 0
+	     bytes of it.  */
+	  val->set_lazy (false);
+	  continue;
+	}
+
+      batch.push_back (val);
+      requests.emplace_back (val->address (), len,
+			     val->contents_all_raw ().data ());
+    }
+
+  if (requests.empty ())
+    return;
+
+  if (target_read_memory_vector (requests) == 0)
+    {
+      for (value *val : batch)
+	val->set_lazy (false);
+    }
+  else
+    {
+      /* Something in the batch was unreadable.  Fetch each value
+	 individually instead; read_value_memory then records
+	 per-value unavailability just as an unbatched fetch
+	 would.  */
+      for (value *val : batch)
+	val->fetch_lazy ();
+    }
+}
+
 /* Implementation of the convenience function $_isvoid.  */
 
 static struct value *
@@ -4318,6 +4577,18 @@ prevents future values, larger than this size, from being allocated."),
 			    set_max_value_size,
 			    show_max_value_size,
 			    &setlist, &showlist);
+  add_setshow_zuinteger_unlimited_cmd ("max-value-history-size",
+				       class_support,
+				       &max_value_history_size, _("\
+Set maximum bytes of value history contents kept in memory."), _("\
+Show maximum bytes of value history contents kept in memory."), _("\
+When the value contents recorded in the value history exceed this many\n\
+bytes, the contents of the oldest history entries are spilled to a\n\
+temporary file, and are read back transparently when those entries are\n\
+accessed again.  'unlimited' (the default) keeps all contents in\n\
+memory."),
+				       NULL, NULL, &setlist, &showlist);
+
   set_show_commands vsize_limit
     = add_setshow_zuinteger_unlimited_cmd ("varsize-limit", class_support,
 					   &max_value_size, _("\
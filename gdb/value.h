@@ -247,6 +247,14 @@ public:
   void set_embedded_offset (LONGEST val)
   { m_embedded_offset = val; }
 
+  /* If this value is an array that was loaded only partially, because
+     it is larger than max-value-size, return the number of octets of
+     contents that were actually loaded; otherwise, return 0.  Code
+     that scans the contents buffer directly must not read past this
+     limit.  */
+  ULONGEST limited_length () const
+  { return m_limited_length; }
+
   /* If false, contents of this value are in the contents field.  If
      true, contents are in inferior.  If the lval field is lval_memory,
      the contents are in inferior memory at location.address plus offset.
@@ -412,6 +420,15 @@ public:
      it.  */
   void fetch_lazy ();
 
+  /* Load the contents of all the lazy values in VALS, batching the
+     fetches.  Plain memory lvalues are coalesced into a single
+     vectored target read (see target_read_memory_vector); other
+     kinds of value are fetched individually.  If the batched read
+     fails, every value it covered falls back to an individual fetch,
+     so per-value unavailability is reported exactly as it would be
+     by fetch_lazy.  */
+  static void fetch_lazy_batch (gdb::array_view<value *> vals);
+
   /* Compare LENGTH bytes of this value's contents starting at OFFSET1
      with LENGTH bytes of VAL2's contents starting at OFFSET2.
 
@@ -612,6 +629,24 @@ public:
      in the history.  The value is removed from the value chain.  */
   int record_latest ();
 
+  /* Return the number of bytes of contents that spilling this value
+     to the value history spill file would release, or 0 if the value
+     cannot usefully be spilled: because it has no resident contents,
+     because its contents buffer is shared with another value, or
+     because something other than the value history still references
+     it and might read the contents directly.  */
+  ULONGEST history_spillable_length () const;
+
+  /* Spill the contents of this value, which must be recorded in the
+     value history, to the history spill file and release the
+     in-memory buffer.  Return true on success.  */
+  bool spill_to_history_file ();
+
+  /* If the contents of this value were spilled to the history spill
+     file and are not resident, load them back.  Throws an error if
+     the spill file cannot be read.  */
+  void fetch_from_history_file ();
+
 private:
 
   /* Type of value; either not an lval, or one of the various
@@ -762,8 +797,14 @@ private:
   /* Actual contents of the value.  Target byte-order.
 
      May be nullptr if the value is lazy or is entirely optimized out.
-     Guaranteed to be non-nullptr otherwise.  */
-  gdb::unique_xmalloc_ptr<gdb_byte> m_contents;
+     Guaranteed to be non-nullptr otherwise.
+
+     The buffer is reference-counted, and copying a value (see
+     value::copy) shares the buffer between the old and new values
+     rather than duplicating it.  Any code about to write through the
+     buffer must call unshare_contents first; the non-const contents
+     accessors take care of that.  */
+  std::shared_ptr<gdb_byte> m_contents;
 
   /* Unavailable ranges in CONTENTS.  We mark unavailable ranges,
      rather than available, since the common and default case is for a
@@ -790,6 +831,14 @@ private:
      loaded from the inferior.  */
   ULONGEST m_limited_length = 0;
 
+  /* If the value is recorded in the value history and its contents
+     have been spilled to the history spill file, the offset of the
+     contents in that file; otherwise -1.  The file copy stays valid
+     even after the contents are loaded back, because history values
+     never change, so re-spilling the value can simply drop the
+     buffer again.  */
+  LONGEST m_history_spill_offset = -1;
+
   /* Allocate a value and its contents for type TYPE.  If CHECK_SIZE
      is true, then apply the usual max-value-size checks.  */
   static struct value *allocate (struct type *type, bool check_size);
@@ -814,6 +863,11 @@ private:
      checks.  */
   void allocate_contents (bool check_size);
 
+  /* If this value's contents buffer is shared with another value
+     (see value::copy), replace it with a private copy, so that it
+     can be written to without disturbing the other value.  */
+  void unshare_contents ();
+
   /* Helper function for value_contents_eq.  The only difference is that
      this function is bit rather than byte based.
 
@@ -1537,7 +1591,8 @@ extern void print_variable_and_value (const char *name,
 				      struct symbol *var,
 				      frame_info_ptr frame,
 				      struct ui_file *stream,
-				      int indent);
+				      int indent,
+				      struct value *val = nullptr);
 
 extern void typedef_print (struct type *type, struct symbol *news,
 			   struct ui_file *stream);
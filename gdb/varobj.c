@@ -23,6 +23,7 @@
 #include "gdbcmd.h"
 #include "block.h"
 #include "valprint.h"
+#include "cli/cli-setshow.h"
 #include "gdbsupport/gdb_regex.h"
 
 #include "varobj.h"
@@ -493,6 +494,7 @@ varobj_set_display_format (struct varobj *var,
     {
       var->print_value = varobj_value_get_print_value (var->value.get (),
 						       var->format, var);
+      var->print_value_generation = get_setshow_generation ();
     }
 
   return var->format;
@@ -1263,7 +1265,31 @@ install_new_value (struct varobj *var, struct value *value, bool initial)
   std::string print_value;
   if (value != NULL && !value->lazy ()
       && var->dynamic->pretty_printer == NULL)
-    print_value = varobj_value_get_print_value (value, var->format, var);
+    {
+      /* If the new value describes the same location and type as the
+	 old one and its bytes compare equal, rendering it again would
+	 reproduce the previous string; reuse that instead of
+	 re-formatting.  This keeps a large watch window from
+	 re-rendering every entry on each step when nothing
+	 changed.  The rendering also depends on global print settings
+	 (output radix, "set print" options and the like), so the old
+	 string is only good if no "set" command has changed a
+	 parameter since it was produced.  */
+      if (!initial && !var->updated
+	  && var->print_value_generation == get_setshow_generation ()
+	  && var->value != NULL && !var->value->lazy ()
+	  && !var->print_value.empty ()
+	  && value->lval () == lval_memory
+	  && var->value->lval () == lval_memory
+	  && value->address () == var->value->address ()
+	  && value->type () == var->value->type ()
+	  && value->limited_length () == 0
+	  && var->value->limited_length () == 0
+	  && value->contents_eq (var->value.get ()))
+	print_value = var->print_value;
+      else
+	print_value = varobj_value_get_print_value (value, var->format, var);
+    }
 
   /* If the type is changeable, compare the old and the new values.
      If this is the initial assignment, we don't have any old value
@@ -1338,6 +1364,7 @@ install_new_value (struct varobj *var, struct value *value, bool initial)
 	changed = true;
     }
   var->print_value = print_value;
+  var->print_value_generation = get_setshow_generation ();
 
   gdb_assert (var->value == nullptr || var->value->type ());
 
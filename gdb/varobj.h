@@ -146,6 +146,12 @@ struct varobj
   /* Last print value.  */
   std::string print_value;
 
+  /* Value of get_setshow_generation () when PRINT_VALUE was rendered.
+     If a "set" command has changed a parameter since then, the string
+     may no longer match what rendering would produce today and must
+     not be reused.  */
+  unsigned int print_value_generation = 0;
+
   /* Is this variable frozen.  Frozen variables are never implicitly
      updated by -var-update * 
      or -var-update <direct-or-indirect-parent>.  */
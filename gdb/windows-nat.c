@@ -44,6 +44,8 @@
 #include <cygwin/version.h>
 #endif
 #include <algorithm>
+#include <map>
+#include <unordered_map>
 #include <vector>
 #include <queue>
 
@@ -84,6 +86,8 @@
 
 using namespace windows_nat;
 
+static void windows_flush_memory_region_map ();
+
 /* Maintain a linked list of "so" information.  */
 struct windows_solib
 {
@@ -105,6 +109,8 @@ struct windows_per_inferior : public windows_process_info
   void handle_unload_dll () override;
   bool handle_access_violation (const EXCEPTION_RECORD *rec) override;
 
+  void suspend_all_threads ();
+
 
   int have_saved_context = 0;	/* True if we've saved context from a
 				   cygwin signal.  */
@@ -115,6 +121,28 @@ struct windows_per_inferior : public windows_process_info
 
   std::vector<std::unique_ptr<windows_thread_info>> thread_list;
 
+  /* Index of THREAD_LIST keyed by thread id.  thread_rec runs several
+     times per debug event, and a conditional breakpoint in a hot loop
+     generates many thousands of events, so keep the lookup cheap even
+     with a large number of threads.  */
+  std::unordered_map<DWORD, windows_thread_info *> thread_id_map;
+
+  /* True if every thread was suspended by a single NtSuspendProcess
+     call in suspend_all_threads, in which case windows_continue can
+     undo it with a single NtResumeProcess call when resuming all
+     threads.  */
+  bool process_suspended = false;
+
+  /* Range of inferior memory written since the last resume, for which
+     an instruction cache flush is still pending.  The inferior's
+     threads are all stopped while GDB writes its memory, so the flush
+     can be deferred to windows_continue and issued once for the union
+     of the written ranges; toggling hundreds of breakpoints would
+     otherwise issue one FlushInstructionCache call per write.  */
+  bool icache_flush_pending = false;
+  ULONGEST icache_flush_start = 0;
+  ULONGEST icache_flush_end = 0;
+
   /* Counts of things.  */
   int saw_create = 0;
   int open_process_used = 0;
@@ -211,6 +239,15 @@ enum
 	| CONTEXT_SEGMENTS | CONTEXT_DEBUG_REGISTERS \
 	| CONTEXT_EXTENDED_REGISTERS
 
+/* The parts of the context needed for general-purpose register
+   access, plus the debug registers, which save_debug_registers
+   mirrors on every context load.  The floating point and extended
+   state is the bulk of the kernel's context copy and is fetched
+   lazily, only when a register living there is actually wanted.  */
+
+#define CONTEXT_DEBUGGER_DR_BASIC (CONTEXT_CONTROL | CONTEXT_INTEGER \
+	| CONTEXT_SEGMENTS | CONTEXT_DEBUG_REGISTERS)
+
 #define DR6_CLEAR_VALUE 0xffff0ff0
 
 /* The string sent by cygwin when it processes a signal.
@@ -356,6 +393,12 @@ struct windows_nat_target final : public x86_nat_target<inf_child_target>
     return disable_randomization_available ();
   }
 
+  /* Async support.  Debug events are waited for on a dedicated worker
+     thread (see process_thread); it signals M_WAIT_EVENT when an
+     event arrives, and the main thread's event loop watches the
+     corresponding file descriptor.  GDB therefore stays responsive to
+     MI and DAP requests while the inferior runs.  */
+
   bool can_async_p () override
   {
     return true;
@@ -386,6 +429,12 @@ private:
   BOOL windows_continue (DWORD continue_status, int id, int killed,
 			 bool last_call = false);
 
+  /* Fold a burst of consecutive DLL load/unload events into the
+     load event that is about to be reported, so that the core
+     updates the shared library list and re-checks breakpoints once
+     per burst instead of once per DLL.  */
+  void coalesce_dll_events ();
+
   /* Helper function to start process_thread.  */
   static DWORD WINAPI process_thread_starter (LPVOID self);
 
@@ -425,6 +474,12 @@ private:
   /* True if a debug event is pending.  */
   std::atomic<bool> m_debug_event_pending { false };
 
+  /* If true, the next windows_continue must not call
+     ContinueDebugEvent: while coalescing DLL events, either the last
+     debug event was already continued, or it has not been reported
+     to the core yet.  */
+  bool m_skip_continue_event = false;
+
   /* True if currently in async mode.  */
   bool m_is_async = false;
 };
@@ -554,39 +609,70 @@ windows_thread_info *
 windows_per_inferior::thread_rec
      (ptid_t ptid, thread_disposition_type disposition)
 {
-  for (auto &th : thread_list)
-    if (th->tid == ptid.lwp ())
-      {
-	if (!th->suspended)
-	  {
-	    switch (disposition)
-	      {
-	      case DONT_INVALIDATE_CONTEXT:
-		/* Nothing.  */
-		break;
-	      case INVALIDATE_CONTEXT:
-		if (ptid.lwp () != current_event.dwThreadId)
-		  th->suspend ();
-		th->reload_context = true;
-		break;
-	      case DONT_SUSPEND:
-		th->reload_context = true;
-		th->suspended = -1;
-		break;
-	      }
-	  }
-	return th.get ();
-      }
+  auto it = thread_id_map.find ((DWORD) ptid.lwp ());
+  if (it == thread_id_map.end ())
+    return NULL;
 
-  return NULL;
+  windows_thread_info *th = it->second;
+  if (!th->suspended)
+    {
+      switch (disposition)
+	{
+	case DONT_INVALIDATE_CONTEXT:
+	  /* Nothing.  */
+	  break;
+	case INVALIDATE_CONTEXT:
+	  if (ptid.lwp () != current_event.dwThreadId)
+	    th->suspend ();
+	  th->reload_context = true;
+	  break;
+	case DONT_SUSPEND:
+	  th->reload_context = true;
+	  th->suspended = -1;
+	  break;
+	}
+    }
+  return th;
+}
+
+/* Artificially suspend every thread of the inferior.  Where available
+   this is done with a single NtSuspendProcess call rather than one
+   SuspendThread round trip per thread, which makes a visible
+   difference when the inferior has very many threads.  The bulk path
+   requires that no thread is already artificially suspended, since
+   NtSuspendProcess would push such a thread's suspend count beyond
+   what resume undoes.  */
+
+void
+windows_per_inferior::suspend_all_threads ()
+{
+  bool bulk = NtSuspendProcess != nullptr && handle != NULL;
+
+  if (bulk)
+    for (auto &th : thread_list)
+      if (th->suspended != 0)
+	{
+	  bulk = false;
+	  break;
+	}
+
+  if (bulk && NtSuspendProcess (handle) >= 0)
+    {
+      for (auto &th : thread_list)
+	th->suspended = 1;
+      process_suspended = true;
+    }
+  else
+    for (auto &th : thread_list)
+      th->suspend ();
 }
 
 template<typename Getter, typename Context>
 static void
 save_debug_registers (windows_thread_info *th, Context &context,
-		      Getter fGetThreadContext)
+		      Getter fGetThreadContext, DWORD context_flags)
 {
-  context.ContextFlags = CONTEXT_DEBUGGER_DR;
+  context.ContextFlags = context_flags;
   CHECK (fGetThreadContext (th->h, &context));
   /* Copy dr values from that thread.
      But only if there were not modified since last stop.
@@ -602,6 +688,72 @@ save_debug_registers (windows_thread_info *th, Context &context,
     }
 }
 
+/* Make sure the parts of TH's context selected by WANTED_FLAGS have
+   been fetched for the current stop, reloading the context from the
+   inferior if necessary.  Parts are only ever added to an
+   already-fetched context, so the write-back at resume time (see
+   set_continue_debug_registers) covers every part fetched here.  */
+
+static void
+windows_ensure_context (windows_thread_info *th, DWORD wanted_flags)
+{
+  DWORD fetched_flags = 0;
+
+  if (!th->reload_context)
+    {
+#ifdef __x86_64__
+      if (windows_process.wow64_process)
+	fetched_flags = th->wow64_context.ContextFlags;
+      else
+#endif
+	fetched_flags = th->context.ContextFlags;
+    }
+
+  if ((wanted_flags & ~fetched_flags) == 0)
+    return;
+
+#ifdef __CYGWIN__
+  if (windows_process.have_saved_context)
+    {
+      /* Lie about where the program actually is stopped since
+	 cygwin has informed us that we should consider the signal
+	 to have occurred at another location which is stored in
+	 "saved_context.  */
+      memcpy (&th->context, &windows_process.saved_context,
+	      __COPY_CONTEXT_SIZE);
+      windows_process.have_saved_context = 0;
+    }
+  else
+#endif
+#ifdef __x86_64__
+  if (windows_process.wow64_process)
+    save_debug_registers (th, th->wow64_context, Wow64GetThreadContext,
+			  wanted_flags | fetched_flags);
+  else
+#endif
+    save_debug_registers (th, th->context, GetThreadContext,
+			  wanted_flags | fetched_flags);
+
+  th->reload_context = false;
+}
+
+/* Return the CONTEXT_* flags covering register number R of GDBARCH,
+   or all of CONTEXT_DEBUGGER_DR when R is negative.  The floating
+   point and extended state is by far the largest part of the
+   kernel's context copy, and workloads such as backtracing every
+   thread read little beyond the PC, SP and frame pointer of each, so
+   it pays to leave that state unfetched until it is wanted.  */
+
+static DWORD
+windows_context_flags_for_register (struct gdbarch *gdbarch, int r)
+{
+  int fp0 = gdbarch_fp0_regnum (gdbarch);
+
+  if (r >= 0 && fp0 >= 0 && r < fp0)
+    return CONTEXT_DEBUGGER_DR_BASIC;
+  return CONTEXT_DEBUGGER_DR;
+}
+
 template<typename Setter, typename Context>
 static void
 set_continue_debug_registers (windows_thread_info *th, Context &context,
@@ -702,6 +854,7 @@ windows_nat_target::add_thread (ptid_t ptid, HANDLE h, void *tlb,
 #endif
   th = new windows_thread_info (ptid.lwp (), h, base);
   windows_process.thread_list.emplace_back (th);
+  windows_process.thread_id_map[th->tid] = th;
 
   /* Add this new thread to the list of threads.
 
@@ -727,6 +880,7 @@ windows_init_thread_list (void)
 {
   DEBUG_EVENTS ("called");
   windows_process.thread_list.clear ();
+  windows_process.thread_id_map.clear ();
 }
 
 /* Delete a thread from the list of threads.
@@ -763,6 +917,7 @@ windows_nat_target::delete_thread (ptid_t ptid, DWORD exit_code,
 
   if (iter != windows_process.thread_list.end ())
     windows_process.thread_list.erase (iter);
+  windows_process.thread_id_map.erase (id);
 }
 
 /* Fetches register number R from the given windows_thread_info,
@@ -854,29 +1009,8 @@ windows_nat_target::fetch_registers (struct regcache *regcache, int r)
   if (th == NULL)
     return;
 
-  if (th->reload_context)
-    {
-#ifdef __CYGWIN__
-      if (windows_process.have_saved_context)
-	{
-	  /* Lie about where the program actually is stopped since
-	     cygwin has informed us that we should consider the signal
-	     to have occurred at another location which is stored in
-	     "saved_context.  */
-	  memcpy (&th->context, &windows_process.saved_context,
-		  __COPY_CONTEXT_SIZE);
-	  windows_process.have_saved_context = 0;
-	}
-      else
-#endif
-#ifdef __x86_64__
-      if (windows_process.wow64_process)
-	save_debug_registers (th, th->wow64_context, Wow64GetThreadContext);
-      else
-#endif
-	save_debug_registers (th, th->context, GetThreadContext);
-      th->reload_context = false;
-    }
+  windows_ensure_context
+    (th, windows_context_flags_for_register (regcache->arch (), r));
 
   if (r < 0)
     for (r = 0; r < gdbarch_num_regs (regcache->arch()); r++)
@@ -920,6 +1054,13 @@ windows_nat_target::store_registers (struct regcache *regcache, int r)
   if (th == NULL)
     return;
 
+  /* Only the fetched parts of the context are written back at resume
+     time, so make sure the part R lives in is among them.  Insist on
+     the full context here: once every part has been fetched, no later
+     fetch can reload the context and lose the value collected into it
+     below.  */
+  windows_ensure_context (th, CONTEXT_DEBUGGER_DR);
+
   if (r < 0)
     for (r = 0; r < gdbarch_num_regs (regcache->arch ()); r++)
       windows_store_one_register (regcache, th, r);
@@ -1583,6 +1724,32 @@ windows_nat_target::windows_continue (DWORD continue_status, int id,
       return TRUE;
     }
 
+  /* The inferior is about to run; its address space layout may
+     change.  */
+  windows_flush_memory_region_map ();
+
+  /* Flush the instruction cache once for everything written since the
+     last stop, before any thread gets to run again.  */
+  if (windows_process.icache_flush_pending)
+    {
+      FlushInstructionCache
+	(windows_process.handle,
+	 (LPCVOID) (uintptr_t) windows_process.icache_flush_start,
+	 (SIZE_T) (windows_process.icache_flush_end
+		   - windows_process.icache_flush_start));
+      windows_process.icache_flush_pending = false;
+    }
+
+  /* If every thread was suspended by a single NtSuspendProcess call
+     and all of them are being resumed, undo the suspension with a
+     single NtResumeProcess call instead of one ResumeThread round
+     trip per thread.  The per-thread bookkeeping still happens in the
+     loop below.  */
+  bool bulk_resume = (id == -1 && windows_process.process_suspended
+		      && NtResumeProcess != nullptr
+		      && NtResumeProcess (windows_process.handle) >= 0);
+  windows_process.process_suspended = false;
+
   for (auto &th : windows_process.thread_list)
     if (id == -1 || id == (int) th->tid)
       {
@@ -1594,7 +1761,15 @@ windows_nat_target::windows_continue (DWORD continue_status, int id,
 #endif
 	  set_continue_debug_registers (th.get (), th->context,
 					SetThreadContext, killed);
-	th->resume ();
+	if (bulk_resume)
+	  {
+	    /* The kernel-side resume already happened; just do the
+	       bookkeeping that resume would have done.  */
+	    th->stopped_at_software_breakpoint = false;
+	    th->suspended = 0;
+	  }
+	else
+	  th->resume ();
       }
     else
       {
@@ -1606,7 +1781,9 @@ windows_nat_target::windows_continue (DWORD continue_status, int id,
   gdb::optional<unsigned> err;
   do_synchronously ([&] ()
     {
-      if (!continue_last_debug_event (continue_status, debug_events))
+      if (m_skip_continue_event)
+	m_skip_continue_event = false;
+      else if (!continue_last_debug_event (continue_status, debug_events))
 	err = (unsigned) GetLastError ();
       /* On the last call, do not block waiting for an event that will
 	 never come.  */
@@ -1781,6 +1958,114 @@ windows_nat_target::pass_ctrlc ()
   interrupt ();
 }
 
+/* How many milliseconds to wait for a further DLL event before
+   deciding that a burst of DLL loads has quiesced.  */
+#define DLL_EVENT_COALESCE_TIMEOUT 5
+
+/* A DLL load event rarely comes alone: process launch and a
+   LoadLibrary call on a DLL with dependencies each generate a burst
+   of consecutive load events, and reporting every one separately
+   makes the core update the shared library list, read symbols and
+   re-check breakpoints once per DLL.  Keep handling DLL load/unload
+   events for as long as more of them arrive promptly, so that a
+   single load event is reported for the whole burst once it quiesces
+   or a different kind of event shows up.  */
+
+void
+windows_nat_target::coalesce_dll_events ()
+{
+  DEBUG_EVENT *current_event = &windows_process.current_event;
+
+  /* With "set stop-on-solib-events 1", every load must be reported
+     individually.  Don't coalesce when stepping a specific thread
+     either, as the pending-stop machinery may be in use.  */
+  if (stop_on_solib_events != 0
+      || windows_process.desired_stop_thread_id != -1)
+    return;
+
+  while (1)
+    {
+      DEBUG_EVENT next;
+      bool got_event = false;
+      gdb::optional<unsigned> err;
+
+      do_synchronously ([&] ()
+	{
+	  if (!continue_last_debug_event (DBG_CONTINUE, debug_events))
+	    err = (unsigned) GetLastError ();
+	  else
+	    got_event = wait_for_debug_event (&next,
+					      DLL_EVENT_COALESCE_TIMEOUT);
+	  return false;
+	});
+
+      if (err.has_value ())
+	{
+	  /* Report what we have; the next windows_continue will
+	     error out if the inferior is truly gone.  */
+	  DEBUG_EVENTS ("ContinueDebugEvent failed, error %u: %s",
+			*err, strwinerror (*err));
+	  break;
+	}
+
+      if (!got_event)
+	{
+	  /* The burst has quiesced, and the inferior is running
+	     because the last event was already continued.  Suspend
+	     its threads so the stop we're about to present is a real
+	     stop; the next windows_continue resumes them, and must
+	     not continue the last debug event again.  */
+	  windows_process.suspend_all_threads ();
+	  m_skip_continue_event = true;
+	  break;
+	}
+
+      if (next.dwDebugEventCode == LOAD_DLL_DEBUG_EVENT
+	  && next.dwProcessId == current_event->dwProcessId)
+	{
+	  *current_event = next;
+	  CloseHandle (current_event->u.LoadDll.hFile);
+	  try
+	    {
+	      windows_process.dll_loaded_event ();
+	    }
+	  catch (const gdb_exception &ex)
+	    {
+	      exception_print (gdb_stderr, ex);
+	    }
+	}
+      else if (next.dwDebugEventCode == UNLOAD_DLL_DEBUG_EVENT
+	       && next.dwProcessId == current_event->dwProcessId)
+	{
+	  *current_event = next;
+	  try
+	    {
+	      windows_process.handle_unload_dll ();
+	    }
+	  catch (const gdb_exception &ex)
+	    {
+	      exception_print (gdb_stderr, ex);
+	    }
+	}
+      else
+	{
+	  /* A different kind of event ends the burst.  Leave it
+	     pending so the next wait picks it up; until then, it
+	     also keeps the inferior's threads frozen while the
+	     coalesced load event is being reported.  */
+	  do_synchronously ([&] ()
+	    {
+	      m_last_debug_event = next;
+	      m_debug_event_pending = true;
+	      serial_event_set (m_wait_event);
+	      return false;
+	    });
+	  m_skip_continue_event = true;
+	  break;
+	}
+    }
+}
+
 /* Get the next event from the child.  Returns the thread ptid.  */
 
 ptid_t
@@ -1939,6 +2224,7 @@ windows_nat_target::get_windows_debug_event
 	{
 	  exception_print (gdb_stderr, ex);
 	}
+      coalesce_dll_events ();
       ourstatus->set_loaded ();
       thread_id = current_event->dwThreadId;
       break;
@@ -1959,6 +2245,7 @@ windows_nat_target::get_windows_debug_event
 	{
 	  exception_print (gdb_stderr, ex);
 	}
+      coalesce_dll_events ();
       ourstatus->set_loaded ();
       thread_id = current_event->dwThreadId;
       break;
@@ -2110,6 +2397,7 @@ windows_nat_target::do_initial_windows_stuff (DWORD pid, bool attaching)
 
   windows_process.last_sig = GDB_SIGNAL_0;
   windows_process.open_process_used = 0;
+  windows_flush_memory_region_map ();
   for (i = 0;
        i < sizeof (windows_process.dr) / sizeof (windows_process.dr[0]);
        i++)
@@ -3468,6 +3756,71 @@ windows_nat_target::mourn_inferior ()
   inf_child_target::mourn_inferior ();
 }
 
+/* A cached VirtualQueryEx snapshot of one region of the inferior's
+   address space.  Region layout and protections cannot change while
+   the inferior is stopped, so the cache stays valid until the next
+   windows_continue, which flushes it.  */
+
+struct windows_memory_region
+{
+  /* One past the last address of the region.  */
+  CORE_ADDR end;
+
+  /* True if ReadProcessMemory can be expected to succeed on the
+     region.  */
+  bool readable;
+};
+
+/* The cached regions, keyed by base address.  Filled lazily, one
+   VirtualQueryEx per region per stop.  */
+
+static std::map<CORE_ADDR, windows_memory_region> memory_region_map;
+
+/* Forget the cached regions.  Called whenever the inferior gets a
+   chance to run, or when a new inferior is started or attached.  */
+
+static void
+windows_flush_memory_region_map ()
+{
+  memory_region_map.clear ();
+}
+
+/* Find (querying and caching if necessary) the region containing
+   ADDR, setting *END and *READABLE.  Returns false if VirtualQueryEx
+   has no answer for ADDR, e.g. beyond the highest user address.  */
+
+static bool
+windows_memory_region_at (CORE_ADDR addr, CORE_ADDR *end, bool *readable)
+{
+  auto it = memory_region_map.upper_bound (addr);
+  if (it != memory_region_map.begin ())
+    {
+      const auto &prev = *std::prev (it);
+
+      if (addr < prev.second.end)
+	{
+	  *end = prev.second.end;
+	  *readable = prev.second.readable;
+	  return true;
+	}
+    }
+
+  MEMORY_BASIC_INFORMATION mbi;
+  if (VirtualQueryEx (windows_process.handle, (LPCVOID) (uintptr_t) addr,
+		      &mbi, sizeof (mbi)) != sizeof (mbi))
+    return false;
+
+  CORE_ADDR base = (CORE_ADDR) (uintptr_t) mbi.BaseAddress;
+  bool is_readable = (mbi.State == MEM_COMMIT
+		      && mbi.Protect != PAGE_NOACCESS
+		      && (mbi.Protect & PAGE_GUARD) == 0);
+
+  *end = base + mbi.RegionSize;
+  *readable = is_readable;
+  memory_region_map[base] = { *end, is_readable };
+  return true;
+}
+
 /* Helper for windows_xfer_partial that handles memory transfers.
    Arguments are like target_xfer_partial.  */
 
@@ -3488,11 +3841,59 @@ windows_xfer_memory (gdb_byte *readbuf, const gdb_byte *writebuf,
 				    len, &done);
       if (!success)
 	lasterror = GetLastError ();
-      FlushInstructionCache (windows_process.handle,
-			     (LPCVOID) (uintptr_t) memaddr, len);
+
+      /* Defer the instruction cache flush until the inferior is
+	 resumed; see windows_per_inferior::icache_flush_pending.  */
+      if (!windows_process.icache_flush_pending)
+	{
+	  windows_process.icache_flush_pending = true;
+	  windows_process.icache_flush_start = memaddr;
+	  windows_process.icache_flush_end = memaddr + len;
+	}
+      else
+	{
+	  windows_process.icache_flush_start
+	    = std::min (windows_process.icache_flush_start, memaddr);
+	  windows_process.icache_flush_end
+	    = std::max (windows_process.icache_flush_end, memaddr + len);
+	}
     }
   else
     {
+      /* Clamp the request to the run of readable regions containing
+	 MEMADDR.  This answers requests for unreadable memory with no
+	 syscall at all, and keeps a large request ending in
+	 unreadable memory from failing outright and being re-split
+	 into small pieces by the generic retry logic; the cached
+	 region map makes both checks one VirtualQueryEx per region
+	 per stop.  */
+      CORE_ADDR region_end;
+      bool readable;
+
+      if (windows_memory_region_at (memaddr, &region_end, &readable))
+	{
+	  if (!readable)
+	    {
+	      *xfered_len = 0;
+	      return TARGET_XFER_E_IO;
+	    }
+
+	  while (region_end < memaddr + len)
+	    {
+	      CORE_ADDR next_end;
+	      bool next_readable;
+
+	      if (!windows_memory_region_at (region_end, &next_end,
+					     &next_readable)
+		  || !next_readable)
+		break;
+	      region_end = next_end;
+	    }
+
+	  if (memaddr + len > region_end)
+	    len = region_end - memaddr;
+	}
+
       DEBUG_MEM ("read target memory, %s bytes at %s",
 		 pulongest (len), core_addr_to_string (memaddr));
       success = ReadProcessMemory (windows_process.handle,
@@ -43,6 +43,8 @@
 #include "observable.h"
 #include "gdbsupport/gdb_optional.h"
 
+#include <unordered_map>
+
 #define CYGWIN_DLL_NAME "cygwin1.dll"
 
 /* Windows signal numbers differ between MinGW flavors and between
@@ -401,6 +403,48 @@ windows_get_tlb_type (struct gdbarch *gdbarch)
   return tib_ptr_type;
 }
 
+/* Per-thread snapshot of the thread information block, filled lazily
+   on first use and flushed when the target resumes.  The TEB (and the
+   PEB reachable from it) are kernel-maintained structures that cannot
+   change while the inferior is stopped, while "info w32
+   thread-information-block", "info proc" and inspection scripts read
+   the same pages over and over.  */
+
+struct tib_snapshot
+{
+  /* Address of the thread information block.  */
+  CORE_ADDR base;
+
+  /* The first FULL_TIB_SIZE bytes at BASE.  */
+  gdb_byte data[FULL_TIB_SIZE];
+};
+
+static std::unordered_map<ptid_t, tib_snapshot> tib_snapshots;
+
+/* Return the thread information block snapshot for PTID, reading it
+   from the target if it is not in the cache yet.  Returns nullptr if
+   the block's address or contents cannot be read.  */
+
+static const tib_snapshot *
+get_tib_snapshot (ptid_t ptid)
+{
+  auto it = tib_snapshots.find (ptid);
+  if (it != tib_snapshots.end ())
+    return &it->second;
+
+  CORE_ADDR base;
+  if (target_get_tib_address (ptid, &base) == 0)
+    return nullptr;
+
+  tib_snapshot snapshot;
+  snapshot.base = base;
+  if (target_read (current_inferior ()->top_target (), TARGET_OBJECT_MEMORY,
+		   NULL, snapshot.data, base, FULL_TIB_SIZE) != FULL_TIB_SIZE)
+    return nullptr;
+
+  return &tib_snapshots.emplace (ptid, snapshot).first->second;
+}
+
 /* The $_tlb convenience variable is a bit special.  We don't know
    for sure the type of the value until we actually have a chance to
    fetch the data.  The type can change depending on gdbarch, so it is
@@ -412,12 +456,12 @@ windows_get_tlb_type (struct gdbarch *gdbarch)
 static void
 tlb_value_read (struct value *val)
 {
-  CORE_ADDR tlb;
   struct type *type = check_typedef (val->type ());
 
-  if (!target_get_tib_address (inferior_ptid, &tlb))
+  const tib_snapshot *snapshot = get_tib_snapshot (inferior_ptid);
+  if (snapshot == nullptr)
     error (_("Unable to read tlb"));
-  store_typed_address (val->contents_raw ().data (), type, tlb);
+  store_typed_address (val->contents_raw ().data (), type, snapshot->base);
 }
 
 /* This function implements the lval_computed support for writing a
@@ -458,8 +502,7 @@ tlb_make_value (struct gdbarch *gdbarch, struct internalvar *var, void *ignore)
 static int
 display_one_tib (ptid_t ptid)
 {
-  gdb_byte *tib = NULL;
-  gdb_byte *index;
+  const gdb_byte *index;
   CORE_ADDR thread_local_base;
   ULONGEST i, val, max, max_name, size, tib_size;
   ULONGEST sizeof_ptr = gdbarch_ptr_bit (target_gdbarch ());
@@ -485,31 +528,22 @@ display_one_tib (ptid_t ptid)
       tib_size = FULL_TIB_SIZE;
       max = tib_size / size;
     }
-  
-  tib = (gdb_byte *) alloca (tib_size);
-
-  if (target_get_tib_address (ptid, &thread_local_base) == 0)
-    {
-      gdb_printf (_("Unable to get thread local base for %s\n"),
-		  target_pid_to_str (ptid).c_str ());
-      return -1;
-    }
 
-  if (target_read (current_inferior ()->top_target (), TARGET_OBJECT_MEMORY,
-		   NULL, tib, thread_local_base, tib_size) != tib_size)
+  const tib_snapshot *snapshot = get_tib_snapshot (ptid);
+  if (snapshot == nullptr)
     {
       gdb_printf (_("Unable to read thread information "
-		    "block for %s at address %s\n"),
-		  target_pid_to_str (ptid).c_str (), 
-		  paddress (target_gdbarch (), thread_local_base));
+		    "block for %s\n"),
+		  target_pid_to_str (ptid).c_str ());
       return -1;
     }
+  thread_local_base = snapshot->base;
 
   gdb_printf (_("Thread Information Block %s at %s\n"),
 	      target_pid_to_str (ptid).c_str (),
 	      paddress (target_gdbarch (), thread_local_base));
 
-  index = (gdb_byte *) tib;
+  index = snapshot->data;
 
   /* All fields have the size of a pointer, this allows to iterate 
      using the same for loop for both layouts.  */
@@ -812,13 +846,14 @@ windows_info_proc (struct gdbarch *gdbarch, const char *args,
   bool want_cwd = what == IP_MINIMAL || what == IP_CWD || what == IP_ALL;
   bool want_exe = what == IP_MINIMAL || what == IP_EXE || what == IP_ALL;
   gdb::optional<std::string> cmd_str, cwd_str, exe_str;
-  CORE_ADDR tlb;
+  const tib_snapshot *snapshot = nullptr;
   gdb_byte buf[8];
-  if ((want_cmd || want_cwd || want_exe)
-      && target_get_tib_address (inferior_ptid, &tlb)
-      && !target_read_memory (tlb + peb_offset, buf, ptr_bytes))
+  if (want_cmd || want_cwd || want_exe)
+    snapshot = get_tib_snapshot (inferior_ptid);
+  if (snapshot != nullptr)
     {
-      CORE_ADDR peb = extract_unsigned_integer (buf, ptr_bytes, byte_order);
+      CORE_ADDR peb = extract_unsigned_integer (snapshot->data + peb_offset,
+						ptr_bytes, byte_order);
       if (!target_read_memory (peb + pp_offset, buf, ptr_bytes))
 	{
 	  CORE_ADDR pp = extract_unsigned_integer (buf, ptr_bytes, byte_order);
@@ -1779,4 +1814,11 @@ even if their meaning is unknown."),
      isn't initialized yet.  At this point, we're quite sure there
      isn't another convenience variable of the same name.  */
   create_internalvar_type_lazy ("_tlb", &tlb_funcs, NULL);
+
+  /* The thread information block snapshots are only valid while the
+     inferior is stopped.  */
+  gdb::observers::target_resumed.attach
+    ([] (ptid_t) { tib_snapshots.clear (); }, "windows-tdep");
+  gdb::observers::inferior_exit.attach
+    ([] (inferior *) { tib_snapshots.clear (); }, "windows-tdep");
 }
@@ -63,10 +63,24 @@ tdesc_parse_xml (const char *document, xml_fetch_another fetcher)
    of it here, so that if we parse the same XML document again we can
    return the same "struct target_desc *"; if they are not singletons,
    then we will create unnecessary duplicate gdbarches.  See
-   gdbarch_list_lookup_by_info.  */
+   gdbarch_list_lookup_by_info.
+
+   Keys are the text of each description after XInclude expansion;
+   documents that contain no XInclude directives are therefore keyed
+   by their own text.  */
 
 static std::unordered_map<std::string, target_desc_up> xml_cache;
 
+/* A non-owning index of the same descriptions, keyed by the raw text
+   of top-level documents that contained XInclude directives.
+   Expanding such a document re-fetches every included document from
+   the target, so this index lets a later identical fetch map the
+   top-level document straight to its description without touching the
+   target again.  The values point into XML_CACHE, which never
+   discards entries.  */
+
+static std::unordered_map<std::string, const target_desc *> raw_xml_cache;
+
 /* Callback data for target description parsing.  */
 
 struct tdesc_parsing_data
@@ -620,6 +634,25 @@ tdesc_parse_xml (const char *document, xml_fetch_another fetcher)
 {
   struct tdesc_parsing_data data;
 
+  /* Check for an exact match on the unexpanded document first.  A
+     top-level document we have resolved before maps straight to its
+     description: through RAW_XML_CACHE if it contained XInclude
+     directives, or through XML_CACHE itself if it did not (expansion
+     then left the document unchanged, so it is its own key).  This
+     lets a reconnect to an identical target reuse the description
+     without re-fetching any included documents and without running
+     either expat pass, leaving only the transfer of the top-level
+     document itself.  */
+  {
+    const auto raw_it = raw_xml_cache.find (document);
+    if (raw_it != raw_xml_cache.end ())
+      return raw_it->second;
+
+    const auto it = xml_cache.find (document);
+    if (it != xml_cache.end ())
+      return it->second.get ();
+  }
+
   /* Expand all XInclude directives.  */
   std::string expanded_text;
 
@@ -635,7 +668,14 @@ tdesc_parse_xml (const char *document, xml_fetch_another fetcher)
      previously parsed.  */
   const auto it = xml_cache.find (expanded_text);
   if (it != xml_cache.end ())
-    return it->second.get ();
+    {
+      /* Getting here means DOCUMENT contained XInclude directives
+	 (otherwise the raw check above would have found it), so index
+	 its unexpanded form too, to short-circuit the next identical
+	 fetch before it re-reads the included documents.  */
+      raw_xml_cache.emplace (document, it->second.get ());
+      return it->second.get ();
+    }
 
   memset (&data, 0, sizeof (struct tdesc_parsing_data));
   target_desc_up description = allocate_target_description ();
@@ -645,6 +685,8 @@ tdesc_parse_xml (const char *document, xml_fetch_another fetcher)
 			   tdesc_elements, expanded_text.c_str (), &data) == 0)
     {
       /* Parsed successfully.  */
+      if (expanded_text != document)
+	raw_xml_cache.emplace (document, data.tdesc);
       xml_cache.emplace (std::move (expanded_text), std::move (description));
       return data.tdesc;
     }
@@ -84,6 +84,13 @@ struct thread_info
 
 extern std::list<thread_info *> all_threads;
 
+/* Incremented whenever a thread is added to or removed from
+   ALL_THREADS, and whenever threads are resumed, since a running
+   thread can change its target-visible properties (name, core).
+   Comparing snapshots of this counter tells cheaply whether a
+   previously computed view of the thread list may be stale.  */
+extern unsigned int threads_generation;
+
 void remove_thread (struct thread_info *thread);
 struct thread_info *add_thread (ptid_t ptid, void *target_data);
 
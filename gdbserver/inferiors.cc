@@ -23,9 +23,19 @@
 #include "gdbthread.h"
 #include "dll.h"
 
+#include <unordered_map>
+
 std::list<process_info *> all_processes;
 std::list<thread_info *> all_threads;
 
+/* See gdbthread.h.  */
+unsigned int threads_generation = 1;
+
+/* A map of ptid_t to thread_info*, for average O(1) ptid_t lookup.
+   With thousands of threads, walking ALL_THREADS for every lookup
+   makes event handling quadratic.  */
+static std::unordered_map<ptid_t, thread_info *> ptid_thread_map;
+
 /* The current process.  */
 static process_info *current_process_;
 
@@ -44,6 +54,8 @@ add_thread (ptid_t thread_id, void *target_data)
   thread_info *new_thread = new thread_info (thread_id, target_data);
 
   all_threads.push_back (new_thread);
+  ptid_thread_map[thread_id] = new_thread;
+  threads_generation++;
 
   if (current_thread == NULL)
     switch_to_thread (new_thread);
@@ -65,9 +77,11 @@ get_first_thread (void)
 struct thread_info *
 find_thread_ptid (ptid_t ptid)
 {
-  return find_thread ([&] (thread_info *thread) {
-    return thread->id == ptid;
-  });
+  auto it = ptid_thread_map.find (ptid);
+  if (it == ptid_thread_map.end ())
+    return NULL;
+
+  return it->second;
 }
 
 /* Find a thread associated with the given PROCESS, or NULL if no
@@ -103,6 +117,8 @@ remove_thread (struct thread_info *thread)
 
   discard_queued_stop_replies (ptid_of (thread));
   all_threads.remove (thread);
+  ptid_thread_map.erase (thread->id);
+  threads_generation++;
   if (current_thread == thread)
     switch_to_thread (nullptr);
   free_one_thread (thread);
@@ -131,6 +147,8 @@ clear_inferiors (void)
 {
   for_each_thread (free_one_thread);
   all_threads.clear ();
+  ptid_thread_map.clear ();
+  threads_generation++;
 
   clear_dlls ();
 
@@ -62,6 +62,8 @@
 #endif
 #include "nat/linux-namespaces.h"
 
+#include <unordered_map>
+
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
 #endif
@@ -381,6 +383,13 @@ linux_pid_exe_is_elf_64_file (int pid, unsigned int *machine)
   return elf_64_file_p (file, machine);
 }
 
+/* A map of LWP ID to lwp_info*, for average O(1) lookup in
+   find_lwp_pid.  LWP IDs are unique system-wide on GNU/Linux, and
+   every LWP goes through add_lwp/delete_lwp.  Without this, each
+   waitpid event costs a walk over all threads, which is quadratic
+   when stopping a process with thousands of them.  */
+static std::unordered_map<long, lwp_info *> lwpid_lwp_map;
+
 void
 linux_process_target::delete_lwp (lwp_info *lwp)
 {
@@ -388,6 +397,7 @@ linux_process_target::delete_lwp (lwp_info *lwp)
 
   threads_debug_printf ("deleting %ld", lwpid_of (thr));
 
+  lwpid_lwp_map.erase (lwpid_of (thr));
   remove_thread (thr);
 
   low_delete_thread (lwp->arch_private);
@@ -910,6 +920,7 @@ linux_process_target::add_lwp (ptid_t ptid)
   lwp_info *lwp = new lwp_info;
 
   lwp->thread = add_thread (ptid, lwp);
+  lwpid_lwp_map[ptid.lwp ()] = lwp;
 
   low_new_thread (lwp);
 
@@ -1735,15 +1746,12 @@ struct lwp_info *
 find_lwp_pid (ptid_t ptid)
 {
   long lwp = ptid.lwp () != 0 ? ptid.lwp () : ptid.pid ();
-  thread_info *thread = find_thread ([lwp] (thread_info *thr_arg)
-    {
-      return thr_arg->id.lwp () == lwp;
-    });
+  auto it = lwpid_lwp_map.find (lwp);
 
-  if (thread == NULL)
+  if (it == lwpid_lwp_map.end ())
     return NULL;
 
-  return get_thread_lwp (thread);
+  return it->second;
 }
 
 /* Return the number of known LWPs in the tgid given by PID.  */
@@ -6545,13 +6553,13 @@ read_link_map (std::string &document, CORE_ADDR lmid, CORE_ADDR lm_addr,
     }
 }
 
-/* Construct qXfer:libraries-svr4:read reply.  */
+/* Helper for linux_process_target::qxfer_libraries_svr4.  Build into
+   DOCUMENT the library list for the current process, restricted to the
+   namespace window described by ANNEX, if any.  Return false on
+   failure.  */
 
-int
-linux_process_target::qxfer_libraries_svr4 (const char *annex,
-					    unsigned char *readbuf,
-					    unsigned const char *writebuf,
-					    CORE_ADDR offset, int len)
+static bool
+linux_qxfer_libraries_svr4_proper (const char *annex, std::string &document)
 {
   struct process_info_private *const priv = current_process ()->priv;
   char filename[PATH_MAX];
@@ -6559,11 +6567,6 @@ linux_process_target::qxfer_libraries_svr4 (const char *annex,
   unsigned int machine;
   CORE_ADDR lmid = 0, lm_addr = 0, lm_prev = 0;
 
-  if (writebuf != NULL)
-    return -2;
-  if (readbuf == NULL)
-    return -1;
-
   pid = lwpid_of (current_thread);
   xsnprintf (filename, sizeof filename, "/proc/%d/exe", pid);
   is_elf64 = elf_64_file_p (filename, &machine);
@@ -6609,7 +6612,7 @@ linux_process_target::qxfer_libraries_svr4 (const char *annex,
       annex = decode_address_to_semicolon (addrp, sep + 1);
     }
 
-  std::string document = "<library-list-svr4 version=\"1.0\"";
+  document = "<library-list-svr4 version=\"1.0\"";
 
   /* When the starting LM_ADDR is passed in the annex, only traverse that
      namespace, which is assumed to be identified by LMID.
@@ -6639,7 +6642,7 @@ linux_process_target::qxfer_libraries_svr4 (const char *annex,
 	 for this inferior - do not retry it.  Report it to GDB as
 	 E01, see for the reasons at the GDB solib-svr4.c side.  */
       if (r_debug == (CORE_ADDR) -1)
-	return -1;
+	return false;
 
       /* Terminate the header if we end up with an empty list.  */
       if (r_debug == 0)
@@ -6713,13 +6716,46 @@ linux_process_target::qxfer_libraries_svr4 (const char *annex,
 
   document += "</library-list-svr4>";
 
-  int document_len = document.length ();
-  if (offset < document_len)
-    document_len -= offset;
-  else
-    document_len = 0;
-  if (len > document_len)
-    len = document_len;
+  return true;
+}
+
+/* Construct qXfer:libraries-svr4:read reply.  */
+
+int
+linux_process_target::qxfer_libraries_svr4 (const char *annex,
+					    unsigned char *readbuf,
+					    unsigned const char *writebuf,
+					    CORE_ADDR offset, int len)
+{
+  /* Building the document walks the inferior's entire link map, one
+     memory read per field, and GDB fetches the result in PacketSize
+     chunks, so regenerating it for every chunk would traverse the link
+     map once per chunk.  As with handle_qxfer_threads, generate
+     everything when a read starts at offset 0 and serve successive
+     reads from the cached copy.  */
+  static std::string document;
+
+  if (writebuf != NULL)
+    return -2;
+  if (readbuf == NULL)
+    return -1;
+
+  if (offset == 0
+      && !linux_qxfer_libraries_svr4_proper (annex, document))
+    {
+      document.clear ();
+      return -1;
+    }
+
+  if (offset >= document.length ())
+    {
+      /* We're out of data.  */
+      document.clear ();
+      return 0;
+    }
+
+  if (len > (LONGEST) (document.length () - offset))
+    len = document.length () - offset;
 
   memcpy (readbuf, document.data () + offset, len);
 
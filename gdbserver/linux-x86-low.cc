@@ -1224,16 +1224,25 @@ amd64_install_fast_tracepoint_jump_pad (CORE_ADDR tpoint, CORE_ADDR tpaddr,
   i += push_opcode (&buf[i], "48 89 44 24 08"); /* mov %rax,0x8(%rsp) */
   append_insns (&buildaddr, i, buf);
 
-  /* spin-lock.  */
+  /* spin-lock.  On contention, wait with PAUSE on a plain read
+     instead of retrying the locked cmpxchg directly; hammering a
+     bus-locked read-modify-write from many cores keeps stealing the
+     cache line from the lock holder and serializes the whole
+     machine.  */
   i = 0;
   i += push_opcode (&buf[i], "48 be");		/* movl <lockaddr>,%rsi */
   memcpy (&buf[i], (void *) &lockaddr, 8);
   i += 8;
   i += push_opcode (&buf[i], "48 89 e1");       /* mov %rsp,%rcx */
-  i += push_opcode (&buf[i], "31 c0");		/* xor %eax,%eax */
+  i += push_opcode (&buf[i], "31 c0");		/* again: xor %eax,%eax */
   i += push_opcode (&buf[i], "f0 48 0f b1 0e"); /* lock cmpxchg %rcx,(%rsi) */
   i += push_opcode (&buf[i], "48 85 c0");	/* test %rax,%rax */
-  i += push_opcode (&buf[i], "75 f4");		/* jne <again> */
+  i += push_opcode (&buf[i], "74 0a");		/* je <acquired> */
+  i += push_opcode (&buf[i], "f3 90");		/* wait: pause */
+  i += push_opcode (&buf[i], "48 83 3e 00");	/* cmpq $0x0,(%rsi) */
+  i += push_opcode (&buf[i], "75 f8");		/* jne <wait> */
+  i += push_opcode (&buf[i], "eb ea");		/* jmp <again> */
+						/* acquired: */
   append_insns (&buildaddr, i, buf);
 
   /* Set up the gdb_collect call.  */
@@ -1404,16 +1413,27 @@ i386_install_fast_tracepoint_jump_pad (CORE_ADDR tpoint, CORE_ADDR tpaddr,
   append_insns (&buildaddr, i, buf);
 
   /* spin-lock.  Note this is using cmpxchg, which leaves i386 behind.
-     If we cared for it, this could be using xchg alternatively.  */
+     If we cared for it, this could be using xchg alternatively.  On
+     contention, wait with PAUSE on a plain read instead of retrying
+     the locked cmpxchg directly, as the bus-locked read-modify-write
+     keeps stealing the cache line from the lock holder.  */
 
   i = 0;
-  i += push_opcode (&buf[i], "31 c0");		/* xor %eax,%eax */
+  i += push_opcode (&buf[i], "31 c0");		/* again: xor %eax,%eax */
   i += push_opcode (&buf[i], "f0 0f b1 25");    /* lock cmpxchg
 						   %esp,<lockaddr> */
   memcpy (&buf[i], (void *) &lockaddr, 4);
   i += 4;
   i += push_opcode (&buf[i], "85 c0");		/* test %eax,%eax */
-  i += push_opcode (&buf[i], "75 f2");		/* jne <again> */
+  i += push_opcode (&buf[i], "74 0d");		/* je <acquired> */
+  i += push_opcode (&buf[i], "f3 90");		/* wait: pause */
+  i += push_opcode (&buf[i], "83 3d");		/* cmpl $0x0,<lockaddr> */
+  memcpy (&buf[i], (void *) &lockaddr, 4);
+  i += 4;
+  buf[i++] = 0x00;
+  i += push_opcode (&buf[i], "75 f5");		/* jne <wait> */
+  i += push_opcode (&buf[i], "eb e5");		/* jmp <again> */
+						/* acquired: */
   append_insns (&buildaddr, i, buf);
 
 
@@ -66,11 +66,43 @@ notif_write_event (struct notif_server *notif, char *own_buf)
       struct notif_event *event = notif->queue.front ();
 
       notif->write (event, own_buf);
+      notif->in_flight = 1;
     }
   else
     write_ok (own_buf);
 }
 
+/* Write as many queued events of NOTIF as fit into one reply to
+   OWN_BUF, separated by '|', and record how many were written so
+   that the next ack dequeues them all.  Must only be called with a
+   non-empty queue, and when GDB has advertised the "vstopped-batch"
+   feature.  */
+
+static void
+notif_write_event_batch (struct notif_server *notif, char *own_buf)
+{
+  char evbuf[PBUFSIZ];
+  int len = 0;
+  int count = 0;
+
+  for (struct notif_event *event : notif->queue)
+    {
+      notif->write (event, evbuf);
+      int evlen = strlen (evbuf);
+
+      if (count > 0 && len + 1 + evlen > PBUFSIZ - 16)
+	break;
+
+      if (count > 0)
+	own_buf[len++] = '|';
+      memcpy (own_buf + len, evbuf, evlen + 1);
+      len += evlen;
+      count++;
+    }
+
+  notif->in_flight = count;
+}
+
 /* Handle the ack in buffer OWN_BUF,and packet length is PACKET_LEN.
    Return 1 if the ack is handled, and return 0 if the contents
    in OWN_BUF is not a ack.  */
@@ -78,6 +110,7 @@ notif_write_event (struct notif_server *notif, char *own_buf)
 int
 handle_notif_ack (char *own_buf, int packet_len)
 {
+  client_state &cs = get_client_state ();
   size_t i;
   struct notif_server *np;
 
@@ -95,20 +128,28 @@ handle_notif_ack (char *own_buf, int packet_len)
 
   np = notifs[i];
 
-  /* If we're waiting for GDB to acknowledge a pending event,
-     consider that done.  */
-  if (!np->queue.empty ())
+  /* If we're waiting for GDB to acknowledge pending events, consider
+     that done.  A single ack covers every event written into the
+     previous reply.  */
+  int acked = 0;
+  while (acked < np->in_flight && !np->queue.empty ())
     {
       struct notif_event *head = np->queue.front ();
       np->queue.pop_front ();
 
-      remote_debug_printf ("%s: acking %d", np->ack_name,
-			   (int) np->queue.size ());
-
       delete head;
+      acked++;
     }
+  np->in_flight = 1;
 
-  notif_write_event (np, own_buf);
+  if (acked > 0)
+    remote_debug_printf ("%s: acking %d, %d left", np->ack_name,
+			 acked, (int) np->queue.size ());
+
+  if (cs.vstopped_batch && !np->queue.empty ())
+    notif_write_event_batch (np, own_buf);
+  else
+    notif_write_event (np, own_buf);
 
   return 1;
 }
@@ -143,6 +184,8 @@ notif_push (struct notif_server *np, struct notif_event *new_event)
       char buf[PBUFSIZ];
       char *p = buf;
 
+      np->in_flight = 1;
+
       xsnprintf (p, PBUFSIZ, "%s:", np->notif_name);
       p += strlen (p);
 
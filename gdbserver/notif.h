@@ -52,6 +52,12 @@ typedef struct notif_server
      deque'ed only when the ack from GDB arrives.  */
   std::list<notif_event *> queue;
 
+  /* Number of events from QUEUE written into the last notification
+     or ack reply sent to GDB; a single ack dequeues them all.  More
+     than one event per reply is only sent when GDB advertised the
+     "vstopped-batch" feature.  */
+  int in_flight = 1;
+
   /* Write event EVENT to OWN_BUF.  */
   void (*write) (struct notif_event *event, char *own_buf);
 } *notif_server_p;
@@ -264,7 +264,7 @@ in_queued_stop_replies (ptid_t ptid)
 
 struct notif_server notif_stop =
 {
-  "vStopped", "Stop", {}, vstop_notif_reply,
+  "vStopped", "Stop", {}, 1, vstop_notif_reply,
 };
 
 static int
@@ -1718,6 +1718,15 @@ handle_qxfer_threads (const char *annex,
 {
   static std::string result;
 
+  /* Generating the document pauses every thread and queries its name,
+     core and handle, which gets expensive with thousands of threads.
+     Keep the last document generated; while no thread has been added,
+     removed or resumed since, it is still accurate and can be resent
+     as-is.  Only do this in all-stop mode: in non-stop, threads may
+     be running and changing their properties at any time.  */
+  static std::string cached_result;
+  static unsigned int cached_generation = 0;
+
   if (writebuf != NULL)
     return -2;
 
@@ -1728,12 +1737,25 @@ handle_qxfer_threads (const char *annex,
     {
       /* When asked for data at offset 0, generate everything and store into
 	 'result'.  Successive reads will be served off 'result'.  */
-      result.clear ();
+      if (!non_stop
+	  && cached_generation == threads_generation
+	  && !cached_result.empty ())
+	result = cached_result;
+      else
+	{
+	  result.clear ();
 
-      bool res = handle_qxfer_threads_proper (&result);
+	  bool res = handle_qxfer_threads_proper (&result);
 
-      if (!res)
-	return -1;
+	  if (!res)
+	    return -1;
+
+	  if (!non_stop)
+	    {
+	      cached_result = result;
+	      cached_generation = threads_generation;
+	    }
+	}
     }
 
   if (offset >= result.length ())
@@ -2353,6 +2375,12 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 		     events.  */
 		  report_no_resumed = true;
 		}
+	      else if (feature == "vstopped-batch+")
+		{
+		  /* GDB accepts several stop replies per vStopped
+		     response.  */
+		  cs.vstopped_batch = 1;
+		}
 	      else if (feature == "memory-tagging+")
 		{
 		  /* GDB supports memory tagging features.  */
@@ -2375,7 +2403,8 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	       "PacketSize=%x;QPassSignals+;QProgramSignals+;"
 	       "QStartupWithShell+;QEnvironmentHexEncoded+;"
 	       "QEnvironmentReset+;QEnvironmentUnset+;"
-	       "QSetWorkingDir+",
+	       "QSetWorkingDir+;binary-upload+;thread-registers+;"
+	       "vstopped-batch+",
 	       PBUFSIZ - 1);
 
       if (target_supports_catch_syscall ())
@@ -2447,6 +2476,7 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	  strcat (own_buf, ";EnableDisableTracepoints+");
 	  strcat (own_buf, ";QTBuffer:size+");
 	  strcat (own_buf, ";tracenz+");
+	  strcat (own_buf, ";binary-trace-buffer+");
 	}
 
       if (target_supports_hardware_single_step ()
@@ -2669,6 +2699,15 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
   if (handle_qxfer (own_buf, packet_len, new_packet_len_p))
     return;
 
+  /* The qTBufferBin reply may contain NUL bytes, so it cannot go
+     through the string-based tracepoint query path.  */
+  if (target_supports_tracepoints ()
+      && startswith (own_buf, "qTBufferBin:"))
+    {
+      *new_packet_len_p = handle_qtbufferbin (own_buf);
+      return;
+    }
+
   if (target_supports_tracepoints () && handle_tracepoint_query (own_buf))
     return;
 
@@ -2697,6 +2736,54 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       return;
     }
 
+  if (startswith (own_buf, "qThreadRegisters:"))
+    {
+      require_running_or_return (own_buf);
+
+      /* Parse the thread id list up front; the reply is built in
+	 OWN_BUF and would clobber it.  */
+      std::vector<ptid_t> ptids;
+      const char *p = own_buf + strlen ("qThreadRegisters:");
+      while (*p != '\0')
+	{
+	  ptids.push_back (read_ptid (p, &p));
+	  if (*p == ',')
+	    p++;
+	}
+
+      /* Reply with a "ptid=g-data" entry per readable thread,
+	 separated by semicolons, for as many threads as fit.  */
+      char *out = own_buf;
+      char *out_end = own_buf + PBUFSIZ;
+      for (ptid_t ptid : ptids)
+	{
+	  thread_info *thread = find_thread_ptid (ptid);
+	  if (thread == NULL)
+	    continue;
+
+	  struct regcache *regcache = get_thread_regcache (thread, 1);
+	  int data_len = 2 * regcache->tdesc->registers_size;
+
+	  /* 32 covers the thread id, the separators and the
+	     terminating NUL.  */
+	  if (out + data_len + 32 > out_end)
+	    break;
+
+	  if (out != own_buf)
+	    *out++ = ';';
+	  out = write_ptid (out, ptid);
+	  *out++ = '=';
+	  registers_to_string (regcache, out);
+	  out += data_len;
+	}
+
+      if (out == own_buf)
+	write_enn (own_buf);
+      else
+	*out = '\0';
+      return;
+    }
+
   /* Otherwise we didn't know what packet it was.  Say we didn't
      understand it.  */
   own_buf[0] = 0;
@@ -2892,6 +2979,10 @@ resume (struct thread_resume *actions, size_t num_actions)
       enable_async_io ();
     }
 
+  /* Running threads may change their properties, invalidating any
+     cached view of the thread list.  */
+  threads_generation++;
+
   the_target->resume (actions, num_actions);
 
   if (non_stop)
@@ -4254,6 +4345,28 @@ process_serial_event (void)
 	  bin2hex (mem_buf, cs.own_buf, res);
       }
       break;
+    case 'x':
+      {
+	require_running_or_break (cs.own_buf);
+	decode_m_packet (&cs.own_buf[1], &mem_addr, &len);
+	int res = gdb_read_memory (mem_addr, mem_buf, len);
+	if (res < 0)
+	  write_enn (cs.own_buf);
+	else
+	  {
+	    /* The reply is the marker 'b' followed by the memory
+	       contents in escaped binary.  Units that don't fit once
+	       escaped are simply dropped; GDB retries the rest.  */
+	    cs.own_buf[0] = 'b';
+	    int out_len_units;
+	    new_packet_len
+	      = remote_escape_output (mem_buf, res, 1,
+				      (unsigned char *) &cs.own_buf[1],
+				      &out_len_units, PBUFSIZ - 2);
+	    new_packet_len++;
+	  }
+      }
+      break;
     case 'M':
       require_running_or_break (cs.own_buf);
       decode_M_packet (&cs.own_buf[1], &mem_addr, &len, &mem_buf);
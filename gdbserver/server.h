@@ -192,6 +192,10 @@ struct client_state
   /* If true, memory tagging features are supported.  */
   bool memory_tagging_feature = false;
 
+  /* If true, GDB accepts several stop replies per notification ack
+     response, separated by '|'.  */
+  int vstopped_batch = 0;
+
 };
 
 client_state &get_client_state ();
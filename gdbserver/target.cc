@@ -217,6 +217,7 @@ target_continue_no_signal (ptid_t ptid)
   resume_info.thread = ptid;
   resume_info.kind = resume_continue;
   resume_info.sig = GDB_SIGNAL_0;
+  threads_generation++;
   the_target->resume (&resume_info, 1);
 }
 
@@ -230,6 +231,7 @@ target_continue (ptid_t ptid, enum gdb_signal signal)
   resume_info.thread = ptid;
   resume_info.kind = resume_continue;
   resume_info.sig = gdb_signal_to_host (signal);
+  threads_generation++;
   the_target->resume (&resume_info, 1);
 }
 
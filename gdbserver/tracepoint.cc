@@ -4024,6 +4024,62 @@ cmd_qtbuffer (char *own_buf)
   bin2hex (tbp, own_buf, num);
 }
 
+/* Like cmd_qtbuffer, but reply with escaped binary data instead of
+   hex, roughly halving the transfer size.  The reply may contain NUL
+   bytes, so return the reply length instead of relying on the
+   string-based query path.  */
+
+int
+handle_qtbufferbin (char *own_buf)
+{
+  ULONGEST offset, num, tot;
+  unsigned char *tbp;
+  const char *packet = own_buf;
+  int out_len;
+
+  packet += strlen ("qTBufferBin:");
+
+  packet = unpack_varlen_hex (packet, &offset);
+  ++packet; /* skip a comma */
+  unpack_varlen_hex (packet, &num);
+
+  trace_debug ("Want to get trace buffer, %d bytes at offset 0x%s",
+	       (int) num, phex_nz (offset, 0));
+
+  tot = (trace_buffer_hi - trace_buffer_lo) - free_space ();
+
+  /* If we're right at the end, reply specially that we're done.  */
+  if (offset == tot)
+    {
+      strcpy (own_buf, "l");
+      return 1;
+    }
+
+  /* Object to any other out-of-bounds request.  */
+  if (offset > tot)
+    {
+      write_enn (own_buf);
+      return strlen (own_buf);
+    }
+
+  /* Compute the pointer corresponding to the given offset, accounting
+     for wraparound.  */
+  tbp = trace_buffer_start + offset;
+  if (tbp >= trace_buffer_wrap)
+    tbp -= (trace_buffer_wrap - trace_buffer_lo);
+
+  /* Trim to the remaining bytes if we're close to the end.  */
+  if (num > tot - offset)
+    num = tot - offset;
+
+  /* The escaping truncates the output to whatever fits in the
+     packet.  */
+  own_buf[0] = 'b';
+  return 1 + remote_escape_output (tbp, num, 1,
+				   (unsigned char *) own_buf + 1,
+				   &out_len, PBUFSIZ - 16);
+}
+
 static void
 cmd_bigqtbuffer_circular (char *own_buf)
 {
@@ -77,6 +77,7 @@ void stop_tracing (void);
 
 int handle_tracepoint_general_set (char *own_buf);
 int handle_tracepoint_query (char *own_buf);
+int handle_qtbufferbin (char *own_buf);
 
 int tracepoint_finished_step (struct thread_info *tinfo, CORE_ADDR stop_pc);
 int tracepoint_was_hit (struct thread_info *tinfo, CORE_ADDR stop_pc);
@@ -154,6 +154,52 @@ string_vappendf (std::string &str, const char *fmt, va_list args)
   return str;
 }
 
+/* See documentation in common-utils.h.  */
+
+format_buffer::format_buffer (const char *fmt, ...)
+{
+  va_list vp;
+
+  va_start (vp, fmt);
+  format (fmt, vp);
+  va_end (vp);
+}
+
+/* See documentation in common-utils.h.  */
+
+format_buffer::format_buffer (const char *fmt, va_list args)
+{
+  format (fmt, args);
+}
+
+/* See documentation in common-utils.h.  */
+
+void
+format_buffer::format (const char *fmt, va_list args)
+{
+  va_list vp;
+  int size;
+
+  /* Keep a copy in case the result does not fit and ARGS has to be
+     walked a second time.  */
+  va_copy (vp, args);
+
+  size = vsnprintf (m_buf, sizeof (m_buf), fmt, args);
+  gdb_assert (size >= 0);
+
+  if ((size_t) size < sizeof (m_buf))
+    m_str = m_buf;
+  else
+    {
+      m_heap.reset ((char *) xmalloc (size + 1));
+      vsnprintf (m_heap.get (), size + 1, fmt, vp);
+      m_str = m_heap.get ();
+    }
+
+  m_size = size;
+  va_end (vp);
+}
+
 char *
 savestring (const char *ptr, size_t len)
 {
@@ -412,6 +458,33 @@ fromhex (int a)
     error (_("Invalid hex digit %d"), a);
 }
 
+/* VALUES[C] holds the value of hex digit C, or -1 if C is not a hex
+   digit.  Decoding through it avoids the range tests of fromhex for
+   each nibble; the remote protocol's hex payloads funnel through
+   hex2bin.  */
+
+struct hex_value_table
+{
+  hex_value_table ()
+  {
+    for (int c = 0; c < 256; c++)
+      {
+	if (c >= '0' && c <= '9')
+	  values[c] = c - '0';
+	else if (c >= 'a' && c <= 'f')
+	  values[c] = c - 'a' + 10;
+	else if (c >= 'A' && c <= 'F')
+	  values[c] = c - 'A' + 10;
+	else
+	  values[c] = -1;
+      }
+  }
+
+  signed char values[256];
+};
+
+static const hex_value_table hex_values;
+
 /* See gdbsupport/common-utils.h.  */
 
 int
@@ -427,7 +500,17 @@ hex2bin (const char *hex, gdb_byte *bin, int count)
 	     Return the count that has been converted so far.  */
 	  return i;
 	}
-      *bin++ = fromhex (hex[0]) * 16 + fromhex (hex[1]);
+
+      int high = hex_values.values[(unsigned char) hex[0]];
+      int low = hex_values.values[(unsigned char) hex[1]];
+
+      if (high < 0 || low < 0)
+	{
+	  /* Let fromhex report the offending digit.  */
+	  *bin++ = fromhex (hex[0]) * 16 + fromhex (hex[1]);
+	}
+      else
+	*bin++ = high * 16 + low;
       hex += 2;
     }
   return i;
@@ -68,6 +68,54 @@ std::string &string_appendf (std::string &dest, const char* fmt, ...)
 std::string &string_vappendf (std::string &dest, const char* fmt, va_list args)
   ATTRIBUTE_PRINTF (2, 0);
 
+/* The result of formatting a printf-style string into a small
+   internal buffer, falling back to the heap only when the result does
+   not fit.  Use this instead of string_printf on hot paths: the
+   common case performs no allocation.  The formatted string lives
+   only as long as the object, so this is a poor fit for anything but
+   immediate consumption.  */
+
+class format_buffer
+{
+public:
+  format_buffer (const char *fmt, ...)
+    ATTRIBUTE_PRINTF (2, 3);
+
+  /* Like the above, but takes a va_list.  */
+  format_buffer (const char *fmt, va_list args)
+    ATTRIBUTE_PRINTF (2, 0);
+
+  DISABLE_COPY_AND_ASSIGN (format_buffer);
+
+  /* The formatted string, always NUL-terminated.  */
+  const char *c_str () const
+  { return m_str; }
+
+  /* The length of the formatted string, not counting the terminating
+     NUL.  */
+  size_t size () const
+  { return m_size; }
+
+  bool empty () const
+  { return m_size == 0; }
+
+private:
+  /* Format ARGS per FMT into M_BUF, or into M_HEAP if the result is
+     too long.  */
+  void format (const char *fmt, va_list args)
+    ATTRIBUTE_PRINTF (2, 0);
+
+  /* Points to either M_BUF or M_HEAP.  */
+  char *m_str;
+  size_t m_size;
+
+  /* Set only when the result did not fit into M_BUF.  */
+  gdb::unique_xmalloc_ptr<char> m_heap;
+
+  /* Large enough for nearly every message GDB produces piecemeal.  */
+  char m_buf[192];
+};
+
 /* Make a copy of the string at PTR with LEN characters
    (and add a null character at the end in the copy).
    Uses malloc to get the space.  Returns the address of the copy.  */
@@ -47,7 +47,7 @@ AC_DEFUN([GDB_AC_COMMON], [
 		   termios.h dnl
 		   dlfcn.h dnl
 		   linux/elf.h proc_service.h dnl
-		   poll.h sys/poll.h sys/select.h)
+		   poll.h sys/poll.h sys/select.h sys/epoll.h sched.h)
 
   AC_FUNC_MMAP
   AC_FUNC_FORK
@@ -85,6 +85,26 @@ struct file_handler
    not useable with all kinds of files.  We probe that whenever a new
    file handler is added.  */
 static bool use_poll = true;
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+
+/* On Linux, the poll path is accelerated with epoll: the set of
+   monitored descriptors is registered with the kernel once, and
+   epoll_wait only returns the descriptors that are ready instead of
+   having the kernel (and us) scan the whole set on every iteration.
+   This matters when many targets are connected, each with its own
+   event source.  The masks and the dispatch through handle_file_event
+   stay in poll terms.
+
+   Not every file type supports epoll -- plain files do not -- so the
+   first failing registration permanently falls back to poll.  */
+static bool use_epoll = true;
+
+/* The epoll instance, created when the first file handler is added,
+   or -1.  */
+static int epoll_fd = -1;
+#endif /* HAVE_SYS_EPOLL_H */
 #endif
 
 #ifdef USE_WIN32API
@@ -307,6 +327,66 @@ add_file_handler (int fd, handler_func *proc, gdb_client_data client_data,
    EXCEPTION.  PROC is the procedure that will be called when an event
    occurs for FD.  CLIENT_DATA is the argument to pass to PROC.  */
 
+#if defined (HAVE_POLL) && defined (HAVE_SYS_EPOLL_H)
+
+/* Try to register FILE_PTR with the epoll instance, creating the
+   instance on first use.  Return true on success.  On failure --
+   epoll does not support all file types, plain files among them --
+   permanently fall back to poll, moving every handler that was
+   registered with epoll to the pollfd array, and return false; the
+   caller then adds FILE_PTR to the pollfd array as usual.  */
+
+static bool
+epoll_add_file (file_handler *file_ptr)
+{
+  if (epoll_fd == -1)
+    epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+
+  if (epoll_fd >= 0)
+    {
+      struct epoll_event ev {};
+      ev.events = EPOLLIN;
+      ev.data.ptr = file_ptr;
+      if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, file_ptr->fd, &ev) == 0)
+	return true;
+    }
+
+  use_epoll = false;
+  if (epoll_fd >= 0)
+    {
+      close (epoll_fd);
+      epoll_fd = -1;
+    }
+
+  /* No pollfd entries have been created while epoll was in use.  */
+  gdb_assert (gdb_notifier.poll_fds == NULL);
+
+  int n_others = gdb_notifier.num_fds - 1;
+  if (n_others > 0)
+    {
+      gdb_notifier.poll_fds
+	= (struct pollfd *) xmalloc (n_others * sizeof (struct pollfd));
+
+      int i = 0;
+      for (file_handler *p = gdb_notifier.first_file_handler;
+	   p != NULL;
+	   p = p->next_file)
+	{
+	  if (p == file_ptr)
+	    continue;
+	  (gdb_notifier.poll_fds + i)->fd = p->fd;
+	  (gdb_notifier.poll_fds + i)->events = p->mask;
+	  (gdb_notifier.poll_fds + i)->revents = 0;
+	  i++;
+	}
+      gdb_assert (i == n_others);
+    }
+
+  return false;
+}
+
+#endif /* HAVE_POLL && HAVE_SYS_EPOLL_H */
+
 static void
 create_file_handler (int fd, int mask, handler_func * proc,
 		     gdb_client_data client_data, std::string &&name,
@@ -329,6 +409,7 @@ create_file_handler (int fd, int mask, handler_func * proc,
     {
       file_ptr = new file_handler;
       file_ptr->fd = fd;
+      file_ptr->mask = mask;
       file_ptr->ready_mask = 0;
       file_ptr->next_file = gdb_notifier.first_file_handler;
       gdb_notifier.first_file_handler = file_ptr;
@@ -337,17 +418,26 @@ create_file_handler (int fd, int mask, handler_func * proc,
       if (use_poll)
 	{
 	  gdb_notifier.num_fds++;
-	  if (gdb_notifier.poll_fds)
-	    gdb_notifier.poll_fds =
-	      (struct pollfd *) xrealloc (gdb_notifier.poll_fds,
-					  (gdb_notifier.num_fds
-					   * sizeof (struct pollfd)));
+#ifdef HAVE_SYS_EPOLL_H
+	  if (use_epoll && epoll_add_file (file_ptr))
+	    {
+	      /* Monitored by epoll; no pollfd entry is needed.  */
+	    }
 	  else
-	    gdb_notifier.poll_fds =
-	      XNEW (struct pollfd);
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->fd = fd;
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->events = mask;
-	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->revents = 0;
+#endif /* HAVE_SYS_EPOLL_H */
+	    {
+	      if (gdb_notifier.poll_fds)
+		gdb_notifier.poll_fds =
+		  (struct pollfd *) xrealloc (gdb_notifier.poll_fds,
+					      (gdb_notifier.num_fds
+					       * sizeof (struct pollfd)));
+	      else
+		gdb_notifier.poll_fds =
+		  XNEW (struct pollfd);
+	      (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->fd = fd;
+	      (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->events = mask;
+	      (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->revents = 0;
+	    }
 	}
       else
 #endif /* HAVE_POLL */
@@ -425,6 +515,16 @@ delete_file_handler (int fd)
     return;
 
 #ifdef HAVE_POLL
+#ifdef HAVE_SYS_EPOLL_H
+  if (use_poll && use_epoll)
+    {
+      /* A close of FD would have removed the registration already, in
+	 which case this simply fails; ignore that.  */
+      epoll_ctl (epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+      gdb_notifier.num_fds--;
+    }
+  else
+#endif /* HAVE_SYS_EPOLL_H */
   if (use_poll)
     {
       int j;
@@ -606,6 +706,47 @@ gdb_wait_for_event (int block)
       else
 	timeout = 0;
 
+#ifdef HAVE_SYS_EPOLL_H
+      if (use_epoll)
+	{
+	  struct epoll_event events[8];
+
+	  num_found = epoll_wait (epoll_fd, events,
+				  ARRAY_SIZE (events), timeout);
+
+	  /* Don't print anything if we get out of epoll_wait because
+	     of a signal.  */
+	  if (num_found == -1 && errno != EINTR)
+	    perror_with_name (("epoll_wait"));
+
+	  if (num_found <= 0)
+	    return 0;
+
+	  /* We always run just one handler and go back to polling, in
+	     case the handler changes the notifier list.  To level the
+	     fairness across the ready descriptors, rotate which of
+	     them is served first.  */
+	  static unsigned int next_epoll_index;
+	  struct epoll_event *ev = &events[next_epoll_index++ % num_found];
+	  file_ptr = (file_handler *) ev->data.ptr;
+
+	  /* Translate the epoll events to the poll terms
+	     handle_file_event expects.  */
+	  int mask = 0;
+	  if ((ev->events & EPOLLIN) != 0)
+	    mask |= POLLIN;
+	  if ((ev->events & EPOLLPRI) != 0)
+	    mask |= POLLPRI;
+	  if ((ev->events & EPOLLHUP) != 0)
+	    mask |= POLLHUP;
+	  if ((ev->events & EPOLLERR) != 0)
+	    mask |= POLLERR;
+
+	  handle_file_event (file_ptr, mask);
+	  return 1;
+	}
+#endif /* HAVE_SYS_EPOLL_H */
+
       num_found = poll (gdb_notifier.poll_fds,
 			(unsigned long) gdb_notifier.num_fds, timeout);
 
@@ -21,6 +21,7 @@
 #define COMMON_OBSERVABLE_H
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <vector>
 
@@ -42,6 +43,11 @@ namespace observers
 
 extern bool observer_debug;
 
+/* When true, notify() counts and times each observer call; the
+   results are displayed by "maint info observers".  */
+
+extern bool observer_stats;
+
 /* An observer is an entity which is interested in being notified
    when GDB reaches certain states, or certain events occur in GDB.
    The entity being observed is called the observable.  To receive
@@ -78,8 +84,65 @@ namespace detail
   };
 }
 
+/* The non-template base class of all observables.  It lets generic
+   code -- the "maint info observers" command -- enumerate every
+   observable and inspect the state of its attached observers without
+   knowing the notification's argument types.  */
+
+class observable_base
+{
+public:
+  /* The externally visible state of one attached observer.  */
+  struct observer_state
+  {
+    /* The observer's name, as passed to attach.  */
+    const char *name;
+
+    /* Whether the observer is currently notified; see enable.  */
+    bool enabled;
+
+    /* The number of notifications delivered to the observer, and the
+       time spent in its callback, while observer_stats was on.  */
+    unsigned long notify_count;
+    std::chrono::steady_clock::duration elapsed;
+  };
+
+  DISABLE_COPY_AND_ASSIGN (observable_base);
+
+  /* The name of this observable.  */
+  const char *name () const
+  { return m_name; }
+
+  /* Return the state of all attached observers, in notification
+     order.  */
+  virtual std::vector<observer_state> observers () const = 0;
+
+  /* Reset the notification counts and times of all attached
+     observers.  */
+  virtual void reset_stats () = 0;
+
+  /* All observables, in definition order.  */
+  static std::vector<observable_base *> &all_observables ()
+  {
+    static std::vector<observable_base *> instances;
+    return instances;
+  }
+
+protected:
+  explicit observable_base (const char *name)
+    : m_name (name)
+  {
+    all_observables ().push_back (this);
+  }
+
+  /* Observables are global and are never destroyed.  */
+  ~observable_base () = default;
+
+  const char *m_name;
+};
+
 template<typename... T>
-class observable
+class observable : public observable_base
 {
 public:
   typedef std::function<void (T...)> func_type;
@@ -96,11 +159,20 @@ private:
     func_type func;
     const char *name;
     std::vector<const struct token *> dependencies;
+
+    /* A disabled observer stays attached, keeping its place in the
+       notification order, but is skipped by notify.  */
+    bool enabled = true;
+
+    /* Statistics collected while observer_stats is on; mutable
+       because notify is const.  */
+    mutable unsigned long notify_count = 0;
+    mutable std::chrono::steady_clock::duration elapsed {};
   };
 
 public:
   explicit observable (const char *name)
-    : m_name (name)
+    : observable_base (name)
   {
   }
 
@@ -154,6 +226,15 @@ public:
     m_observers.erase (iter, m_observers.end ());
   }
 
+  /* Enable or disable the observers associated with T.  A disabled
+     observer stays attached, but notify skips it.  */
+  void enable (const token &t, bool state)
+  {
+    for (observer &o : m_observers)
+      if (o.token == &t)
+	o.enabled = state;
+  }
+
   /* Notify all observers that are attached to this observable.  */
   void notify (T... args) const
   {
@@ -161,16 +242,46 @@ public:
 
     for (auto &&e : m_observers)
       {
+	if (!e.enabled)
+	  continue;
+
 	OBSERVER_SCOPED_DEBUG_START_END ("calling observer %s of observable %s",
 					 e.name, m_name);
-	e.func (args...);
+	if (observer_stats)
+	  {
+	    auto start = std::chrono::steady_clock::now ();
+	    e.func (args...);
+	    e.elapsed += std::chrono::steady_clock::now () - start;
+	    e.notify_count++;
+	  }
+	else
+	  e.func (args...);
+      }
+  }
+
+  /* See observable_base.  */
+  std::vector<observer_state> observers () const override
+  {
+    std::vector<observer_state> result;
+    result.reserve (m_observers.size ());
+    for (const observer &o : m_observers)
+      result.push_back ({ o.name, o.enabled, o.notify_count, o.elapsed });
+    return result;
+  }
+
+  /* See observable_base.  */
+  void reset_stats () override
+  {
+    for (observer &o : m_observers)
+      {
+	o.notify_count = 0;
+	o.elapsed = {};
       }
   }
 
 private:
 
   std::vector<observer> m_observers;
-  const char *m_name;
 
   /* Helper method for topological sort using depth-first search algorithm.
 
@@ -21,6 +21,8 @@
 #define GDBSUPPORT_PARALLEL_FOR_H
 
 #include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <type_traits>
 #include "gdbsupport/invoke-result.h"
 #include "gdbsupport/thread-pool.h"
@@ -49,10 +51,11 @@ public:
 
   /* Post the Ith task to a background thread, and store a future for
      later.  */
-  void post (size_t i, std::function<T ()> task)
+  void post (size_t i, std::function<T ()> task, task_priority priority)
   {
     m_futures[i]
-      = gdb::thread_pool::g_thread_pool->post_task (std::move (task));
+      = gdb::thread_pool::g_thread_pool->post_task (std::move (task),
+						    priority);
   }
 
   /* Invoke TASK in the current thread, then compute all the results
@@ -97,10 +100,11 @@ public:
   /* This specialization does not compute results.  */
   typedef void result_type;
 
-  void post (size_t i, std::function<void ()> task)
+  void post (size_t i, std::function<void ()> task, task_priority priority)
   {
     m_futures[i]
-      = gdb::thread_pool::g_thread_pool->post_task (std::move (task));
+      = gdb::thread_pool::g_thread_pool->post_task (std::move (task),
+						    priority);
   }
 
   result_type finish (gdb::function_view<void ()> task)
@@ -125,6 +129,126 @@ private:
   std::vector<gdb::future<void>> m_futures;
 };
 
+/* A helper for the dynamically scheduled mode of parallel_for, where
+   each worker claims chunks of the range until it is exhausted and
+   produces one result per chunk.  There is a specialization for
+   'void', below.  */
+template<typename T>
+struct par_for_dynamic_accumulator
+{
+public:
+
+  explicit par_for_dynamic_accumulator (size_t n_threads)
+    : m_futures (n_threads)
+  {
+  }
+
+  /* The result type that is accumulated.  */
+  typedef std::vector<T> result_type;
+
+  /* Build a worker function: repeatedly claim a chunk [begin, end)
+     of element indices with CLAIM, which returns false once the
+     range is exhausted, and collect one CALLBACK result per
+     chunk.  */
+  template<typename Claim, typename RandomIt, typename Callback>
+  std::function<std::vector<T> ()> make_worker (Claim claim, RandomIt first,
+						Callback callback)
+  {
+    return [=] ()
+      {
+	std::vector<T> result;
+	size_t begin, end;
+	while (claim (&begin, &end))
+	  result.push_back (callback (first + begin, first + end));
+	return result;
+      };
+  }
+
+  /* Post the Ith worker to a background thread, and store a future
+     for later.  */
+  void post (size_t i, std::function<std::vector<T> ()> task,
+	     task_priority priority)
+  {
+    m_futures[i]
+      = gdb::thread_pool::g_thread_pool->post_task (std::move (task),
+						    priority);
+  }
+
+  /* Invoke TASK in the current thread, then gather the results of
+     all the chunks, from all workers, into a single result vector,
+     which is returned.  */
+  result_type finish (gdb::function_view<std::vector<T> ()> task)
+  {
+    result_type result = task ();
+
+    for (auto &future : m_futures)
+      {
+	std::vector<T> r = future.get ();
+	result.insert (result.end (),
+		       std::make_move_iterator (r.begin ()),
+		       std::make_move_iterator (r.end ()));
+      }
+
+    return result;
+  }
+
+private:
+
+  /* A vector of futures coming from the workers run in the
+     background.  */
+  std::vector<gdb::future<std::vector<T>>> m_futures;
+};
+
+/* See the generic template.  */
+template<>
+struct par_for_dynamic_accumulator<void>
+{
+public:
+
+  explicit par_for_dynamic_accumulator (size_t n_threads)
+    : m_futures (n_threads)
+  {
+  }
+
+  /* This specialization does not compute results.  */
+  typedef void result_type;
+
+  /* See the generic template.  */
+  template<typename Claim, typename RandomIt, typename Callback>
+  std::function<void ()> make_worker (Claim claim, RandomIt first,
+				      Callback callback)
+  {
+    return [=] ()
+      {
+	size_t begin, end;
+	while (claim (&begin, &end))
+	  callback (first + begin, first + end);
+      };
+  }
+
+  void post (size_t i, std::function<void ()> task, task_priority priority)
+  {
+    m_futures[i]
+      = gdb::thread_pool::g_thread_pool->post_task (std::move (task),
+						    priority);
+  }
+
+  result_type finish (gdb::function_view<void ()> task)
+  {
+    task ();
+
+    for (auto &future : m_futures)
+      {
+	/* Use 'get' and not 'wait', to propagate any exception.  */
+	future.get ();
+      }
+  }
+
+private:
+
+  std::vector<gdb::future<void>> m_futures;
+};
+
 }
 
 /* A very simple "parallel for".  This splits the range of iterators
@@ -141,7 +265,12 @@ private:
 
    If the function returns a non-void type, then a vector of the
    results is returned.  The size of the resulting vector depends on
-   the number of threads that were used.  */
+   the number of threads that were used.
+
+   PRIORITY is the priority at which the subrange tasks are posted to
+   the thread pool; a caller that is blocked waiting for the result
+   may use task_priority::high so that queued background tasks do not
+   delay it.  */
 
 template<class RandomIt, class RangeFunction>
 typename gdb::detail::par_for_accumulator<
@@ -149,7 +278,8 @@ typename gdb::detail::par_for_accumulator<
   >::result_type
 parallel_for_each (unsigned n, RandomIt first, RandomIt last,
 		   RangeFunction callback,
-		   gdb::function_view<size_t(RandomIt)> task_size = nullptr)
+		   gdb::function_view<size_t(RandomIt)> task_size = nullptr,
+		   task_priority priority = task_priority::normal)
 {
   using result_type
     = typename gdb::invoke_result<RangeFunction, RandomIt, RandomIt>::type;
@@ -161,43 +291,111 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
   size_t n_worker_threads = thread_pool::g_thread_pool->thread_count ();
   size_t n_threads = n_worker_threads;
   size_t n_elements = last - first;
-  size_t elts_per_thread = 0;
-  size_t elts_left_over = 0;
-  size_t total_size = 0;
-  size_t size_per_thread = 0;
-  size_t max_element_size = n_elements == 0 ? 1 : SIZE_MAX / n_elements;
 
-  if (n_threads > 1)
+  if (task_size == nullptr)
     {
-      if (task_size != nullptr)
+      /* Require that there should be at least N elements in a
+	 thread.  */
+      gdb_assert (n > 0);
+      if (n_threads > 1 && n_elements / n_threads < n)
+	n_threads = std::max (n_elements / n, (size_t) 1);
+
+      if (n_threads > 1)
 	{
-	  gdb_assert (n == 1);
-	  for (RandomIt i = first; i != last; ++i)
+	  /* Scheduling is dynamic: every worker, and the main thread,
+	     repeatedly claims the next chunk of the range from a
+	     shared cursor, so a worker that draws expensive elements
+	     simply claims fewer chunks while the others keep going,
+	     instead of still running long after the rest have
+	     finished.  A chunk is 1/(4 * n_threads) of what remains,
+	     but at least N elements: chunks start large, keeping the
+	     claiming overhead low, and shrink towards the end of the
+	     range, evening out the finish times.  */
+	  std::atomic<size_t> cursor (0);
+
+	  auto claim = [&cursor, n_elements, n_threads, n]
+	    (size_t *out_begin, size_t *out_end) -> bool
+	    {
+	      size_t begin = cursor.load (std::memory_order_relaxed);
+	      while (begin < n_elements)
+		{
+		  size_t chunk = std::max ((n_elements - begin)
+					   / (4 * n_threads),
+					   (size_t) n);
+		  size_t end = std::min (begin + chunk, n_elements);
+		  if (cursor.compare_exchange_weak (begin, end))
+		    {
+		      *out_begin = begin;
+		      *out_end = end;
+		      return true;
+		    }
+		}
+	      return false;
+	    };
+
+	  if (parallel_for_each_debug)
 	    {
-	      size_t element_size = task_size (i);
-	      gdb_assert (element_size > 0);
-	      if (element_size > max_element_size)
-		/* We could start scaling here, but that doesn't seem to be
-		   worth the effort.  */
-		element_size = max_element_size;
-	      size_t prev_total_size = total_size;
-	      total_size += element_size;
-	      /* Check for overflow.  */
-	      gdb_assert (prev_total_size < total_size);
+	      debug_printf (_("Parallel for: n_elements: %zu\n"), n_elements);
+	      debug_printf (_("Parallel for: dynamic chunks of at least %u"
+			      " elements on %zu threads\n"),
+			    n, n_threads);
 	    }
-	  size_per_thread = total_size / n_threads;
+
+	  gdb::detail::par_for_dynamic_accumulator<result_type> results
+	    (n_threads - 1);
+
+	  for (size_t i = 0; i < n_threads - 1; ++i)
+	    results.post (i, results.make_worker (claim, first, callback),
+			  priority);
+
+	  /* The main thread claims chunks like any other worker.  */
+	  auto worker = results.make_worker (claim, first, callback);
+	  return results.finish (worker);
+	}
+
+      /* Not enough elements for more than one thread; process the
+	 whole range here.  */
+      if (parallel_for_each_debug)
+	{
+	  debug_printf (_("Parallel for: n_elements: %zu\n"), n_elements);
+	  debug_printf (_("Parallel for: elements on main thread\t\t: %zu\n"),
+			n_elements);
 	}
-      else
+
+      gdb::detail::par_for_accumulator<result_type> results (0);
+      return results.finish ([=] ()
+	{
+	  return callback (first, last);
+	});
+    }
+
+  /* With TASK_SIZE, the range is instead partitioned up front into
+     one size-balanced subrange per thread.  The callback may do
+     expensive once-per-subrange work -- the DWARF indexer builds an
+     index shard for each subrange it is handed -- so the number of
+     subranges is kept at the thread count instead of chunking the
+     range dynamically.  */
+  size_t total_size = 0;
+  size_t size_per_thread = 0;
+  size_t max_element_size = n_elements == 0 ? 1 : SIZE_MAX / n_elements;
+
+  if (n_threads > 1)
+    {
+      gdb_assert (n == 1);
+      for (RandomIt i = first; i != last; ++i)
 	{
-	  /* Require that there should be at least N elements in a
-	     thread.  */
-	  gdb_assert (n > 0);
-	  if (n_elements / n_threads < n)
-	    n_threads = std::max (n_elements / n, (size_t) 1);
-	  elts_per_thread = n_elements / n_threads;
-	  elts_left_over = n_elements % n_threads;
-	  /* n_elements == n_threads * elts_per_thread + elts_left_over. */
+	  size_t element_size = task_size (i);
+	  gdb_assert (element_size > 0);
+	  if (element_size > max_element_size)
+	    /* We could start scaling here, but that doesn't seem to be
+	       worth the effort.  */
+	    element_size = max_element_size;
+	  size_t prev_total_size = total_size;
+	  total_size += element_size;
+	  /* Check for overflow.  */
+	  gdb_assert (prev_total_size < total_size);
 	}
+      size_per_thread = total_size / n_threads;
     }
 
   size_t count = n_threads == 0 ? 0 : n_threads - 1;
@@ -206,16 +404,8 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
   if (parallel_for_each_debug)
     {
       debug_printf (_("Parallel for: n_elements: %zu\n"), n_elements);
-      if (task_size != nullptr)
-	{
-	  debug_printf (_("Parallel for: total_size: %zu\n"), total_size);
-	  debug_printf (_("Parallel for: size_per_thread: %zu\n"), size_per_thread);
-	}
-      else
-	{
-	  debug_printf (_("Parallel for: minimum elements per thread: %u\n"), n);
-	  debug_printf (_("Parallel for: elts_per_thread: %zu\n"), elts_per_thread);
-	}
+      debug_printf (_("Parallel for: total_size: %zu\n"), total_size);
+      debug_printf (_("Parallel for: size_per_thread: %zu\n"), size_per_thread);
     }
 
   size_t remaining_size = total_size;
@@ -223,27 +413,16 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
     {
       RandomIt end;
       size_t chunk_size = 0;
-      if (task_size == nullptr)
+      RandomIt j;
+      for (j = first; j < last && chunk_size < size_per_thread; ++j)
 	{
-	  end = first + elts_per_thread;
-	  if (i < elts_left_over)
-	    /* Distribute the leftovers over the worker threads, to avoid having
-	       to handle all of them in a single thread.  */
-	    end++;
-	}
-      else
-	{
-	  RandomIt j;
-	  for (j = first; j < last && chunk_size < size_per_thread; ++j)
-	    {
-	      size_t element_size = task_size (j);
-	      if (element_size > max_element_size)
-		element_size = max_element_size;
-	      chunk_size += element_size;
-	    }
-	  end = j;
-	  remaining_size -= chunk_size;
+	  size_t element_size = task_size (j);
+	  if (element_size > max_element_size)
+	    element_size = max_element_size;
+	  chunk_size += element_size;
 	}
+      end = j;
+      remaining_size -= chunk_size;
 
       /* This case means we don't have enough elements to really
 	 distribute them.  Rather than ever submit a task that does
@@ -263,36 +442,24 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
 	}
 
       if (parallel_for_each_debug)
-	{
-	  debug_printf (_("Parallel for: elements on worker thread %i\t: %zu"),
-			i, (size_t)(end - first));
-	  if (task_size != nullptr)
-	    debug_printf (_("\t(size: %zu)"), chunk_size);
-	  debug_printf (_("\n"));
-	}
+	debug_printf (_("Parallel for: elements on worker thread %i\t: %zu"
+			"\t(size: %zu)\n"),
+		      i, (size_t)(end - first), chunk_size);
       results.post (i, [=] ()
-	{ return callback (first, end); });
+	{ return callback (first, end); }, priority);
       first = end;
     }
 
   for (int i = count; i < n_worker_threads; ++i)
     if (parallel_for_each_debug)
-      {
-	debug_printf (_("Parallel for: elements on worker thread %i\t: 0"), i);
-	if (task_size != nullptr)
-	  debug_printf (_("\t(size: 0)"));
-	debug_printf (_("\n"));
-      }
+      debug_printf (_("Parallel for: elements on worker thread %i\t: 0"
+		      "\t(size: 0)\n"), i);
 
   /* Process all the remaining elements in the main thread.  */
   if (parallel_for_each_debug)
-    {
-      debug_printf (_("Parallel for: elements on main thread\t\t: %zu"),
-		    (size_t)(last - first));
-      if (task_size != nullptr)
-	debug_printf (_("\t(size: %zu)"), remaining_size);
-      debug_printf (_("\n"));
-    }
+    debug_printf (_("Parallel for: elements on main thread\t\t: %zu"
+		    "\t(size: %zu)\n"),
+		  (size_t)(last - first), remaining_size);
   return results.finish ([=] ()
     {
       return callback (first, last);
@@ -309,7 +476,8 @@ typename gdb::detail::par_for_accumulator<
   >::result_type
 sequential_for_each (unsigned n, RandomIt first, RandomIt last,
 		     RangeFunction callback,
-		     gdb::function_view<size_t(RandomIt)> task_size = nullptr)
+		     gdb::function_view<size_t(RandomIt)> task_size = nullptr,
+		     task_priority priority = task_priority::normal)
 {
   using result_type = typename gdb::invoke_result<RangeFunction, RandomIt, RandomIt>::type;
 
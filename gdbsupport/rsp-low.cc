@@ -125,6 +125,28 @@ hex2str (const char *hex, int count)
   return ret;
 }
 
+/* PAIRS[B] holds the two-character hex encoding of byte B.  Encoding
+   through it emits a byte pair per input byte instead of computing
+   and storing the nibbles separately, which matters because every
+   'm'/'X'/'g' payload on the remote protocol's hex path funnels
+   through bin2hex.  */
+
+struct hex_pair_table
+{
+  hex_pair_table ()
+  {
+    for (int b = 0; b < 256; b++)
+      {
+	pairs[b][0] = hexchars[b >> 4];
+	pairs[b][1] = hexchars[b & 0xf];
+      }
+  }
+
+  char pairs[256][2];
+};
+
+static const hex_pair_table hex_pairs;
+
 /* See rsp-low.h.  */
 
 int
@@ -134,8 +156,8 @@ bin2hex (const gdb_byte *bin, char *hex, int count)
 
   for (i = 0; i < count; i++)
     {
-      *hex++ = tohex ((*bin >> 4) & 0xf);
-      *hex++ = tohex (*bin++ & 0xf);
+      memcpy (hex, hex_pairs.pairs[*bin++], 2);
+      hex += 2;
     }
   *hex = 0;
   return i;
@@ -146,13 +168,13 @@ bin2hex (const gdb_byte *bin, char *hex, int count)
 std::string
 bin2hex (const gdb_byte *bin, int count)
 {
-  std::string ret;
+  std::string ret (count * 2, '\0');
+  char *hex = &ret[0];
 
-  ret.reserve (count * 2);
   for (int i = 0; i < count; ++i)
     {
-      ret += tohex ((*bin >> 4) & 0xf);
-      ret += tohex (*bin++ & 0xf);
+      memcpy (hex, hex_pairs.pairs[*bin++], 2);
+      hex += 2;
     }
 
   return ret;
@@ -0,0 +1,171 @@
+/* Scoped bump allocator for transient objects.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMMON_SCOPED_ARENA_H
+#define COMMON_SCOPED_ARENA_H
+
+#include "gdbsupport/gdb_obstack.h"
+#include <type_traits>
+
+namespace gdb
+{
+
+/* An arena for objects that all become garbage at the same time,
+   typically at the end of a command.  Allocation bumps a pointer in
+   an obstack; nothing is freed until the arena goes out of scope.
+   Unlike a bare obstack, objects created with emplace have their
+   destructors run, newest first, when the arena is destroyed.
+
+   While a scoped_arena is in scope it is the "current" arena of its
+   thread, available through scoped_arena::current; arena_allocator
+   below uses that to route container scratch storage into the arena
+   of the enclosing command without threading the arena through every
+   signature.  Nothing allocated from an inner arena may escape to an
+   outer scope.  */
+
+class scoped_arena
+{
+public:
+  scoped_arena ()
+    : m_prev (current ())
+  {
+    current_arena () = this;
+  }
+
+  ~scoped_arena ()
+  {
+    /* Destroy in reverse order of construction, before the obstack
+       member releases the storage.  */
+    for (destructor_record *r = m_destructors; r != nullptr; r = r->next)
+      r->destroy (r->object);
+
+    current_arena () = m_prev;
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_arena);
+
+  /* The innermost arena in scope on the calling thread, or nullptr if
+     there is none.  */
+  static scoped_arena *current ()
+  { return current_arena (); }
+
+  /* Allocate SIZE bytes, suitably aligned for any built-in type.  The
+     memory lives until the arena goes out of scope.  */
+  void *allocate (size_t size)
+  { return obstack_alloc (&m_obstack, size); }
+
+  /* Construct a T from ARGS in the arena.  Its destructor, if any,
+     runs when the arena goes out of scope.  */
+  template<typename T, typename... Args>
+  T *emplace (Args &&... args)
+  {
+    T *object = obstack_new<T> (&m_obstack, std::forward<Args> (args)...);
+
+    if (!std::is_trivially_destructible<T>::value)
+      {
+	destructor_record *record
+	  = XOBNEW (&m_obstack, destructor_record);
+	record->destroy = [] (void *obj) { ((T *) obj)->~T (); };
+	record->object = object;
+	record->next = m_destructors;
+	m_destructors = record;
+      }
+
+    return object;
+  }
+
+private:
+  /* How to destroy one emplaced object.  */
+  struct destructor_record
+  {
+    void (*destroy) (void *object);
+    void *object;
+    destructor_record *next;
+  };
+
+  static scoped_arena *&current_arena ()
+  {
+    static thread_local scoped_arena *arena;
+    return arena;
+  }
+
+  /* Emplaced objects with non-trivial destructors, newest first.  The
+     records live in the obstack too.  */
+  destructor_record *m_destructors = nullptr;
+
+  auto_obstack m_obstack;
+
+  /* The arena this one shadows, restored on destruction.  */
+  scoped_arena *const m_prev;
+};
+
+/* A minimal standard allocator drawing from the current scoped_arena.
+   The arena is captured when the allocator is constructed; when no
+   arena is in scope, the allocator falls back to the heap.  Only use
+   this for containers that do not outlive the arena that was current
+   at their construction.  */
+
+template<typename T>
+class arena_allocator
+{
+public:
+  using value_type = T;
+
+  arena_allocator () noexcept
+    : m_arena (scoped_arena::current ())
+  {}
+
+  template<typename U>
+  arena_allocator (const arena_allocator<U> &other) noexcept
+    : m_arena (other.arena ())
+  {}
+
+  T *allocate (size_t count)
+  {
+    if (m_arena != nullptr)
+      return (T *) m_arena->allocate (count * sizeof (T));
+    return (T *) xmalloc (count * sizeof (T));
+  }
+
+  void deallocate (T *ptr, size_t count)
+  {
+    if (m_arena == nullptr)
+      xfree (ptr);
+    /* Arena memory is reclaimed wholesale when the arena goes out of
+       scope.  */
+  }
+
+  scoped_arena *arena () const noexcept
+  { return m_arena; }
+
+  template<typename U>
+  bool operator== (const arena_allocator<U> &other) const noexcept
+  { return m_arena == other.arena (); }
+
+  template<typename U>
+  bool operator!= (const arena_allocator<U> &other) const noexcept
+  { return m_arena != other.arena (); }
+
+private:
+  scoped_arena *m_arena;
+};
+
+} /* namespace gdb */
+
+#endif /* COMMON_SCOPED_ARENA_H */
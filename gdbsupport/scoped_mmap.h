@@ -69,6 +69,15 @@ public:
     m_mem = mmap (addr, m_length, prot, flags, fd, offset);
   }
 
+  /* Unmap the current mapping, if any, leaving this object empty.  */
+  void reset () noexcept
+  {
+    destroy ();
+
+    m_length = 0;
+    m_mem = MAP_FAILED;
+  }
+
   size_t size () const noexcept { return m_length; }
   void *get () const noexcept { return m_mem; }
 
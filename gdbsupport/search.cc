@@ -21,6 +21,7 @@
 
 #include "gdbsupport/search.h"
 #include "gdbsupport/byte-vector.h"
+#include "gdbsupport/thread-pool.h"
 
 /* This implements a basic search of memory, reading target memory and
    performing the search here (as opposed to performing the search in on the
@@ -43,7 +44,13 @@ simple_search_memory
   if (search_space_len < search_buf_size)
     search_buf_size = search_space_len;
 
+  /* Two buffers are used so that a worker thread can scan one chunk
+     while this thread reads the next chunk from the target.  Target
+     access is not thread-safe, so the reads stay here; the worker
+     only runs memmem over a buffer this thread does not modify until
+     the scan is done.  */
   gdb::byte_vector search_buf (search_buf_size);
+  gdb::byte_vector next_buf (search_buf_size);
 
   /* Prime the search buffer.  */
 
@@ -63,45 +70,75 @@ simple_search_memory
 
   while (search_space_len >= pattern_len)
     {
-      gdb_byte *found_ptr;
       unsigned nr_search_bytes
 	= std::min (search_space_len, (ULONGEST) search_buf_size);
 
-      found_ptr = (gdb_byte *) memmem (search_buf.data (), nr_search_bytes,
-				       pattern, pattern_len);
-
-      if (found_ptr != NULL)
-	{
-	  CORE_ADDR found_addr = start_addr + (found_ptr - search_buf.data ());
-
-	  *found_addrp = found_addr;
-	  return 1;
-	}
-
-      /* Not found in this chunk, skip to next chunk.  */
-
-      /* Don't let search_space_len wrap here, it's unsigned.  */
+      /* Scan this chunk on a worker thread.  memmem is where libc
+	 keeps its vectorized substring kernel, so this is also where
+	 the SIMD happens.  With no worker threads configured the task
+	 runs inline, giving the old serial behavior.  */
+      const gdb_byte *found_ptr = nullptr;
+      gdb::future<void> scan_done
+	= gdb::thread_pool::g_thread_pool->post_task
+	    ([&] ()
+	     {
+	       found_ptr = (const gdb_byte *) memmem (search_buf.data (),
+						      nr_search_bytes,
+						      pattern, pattern_len);
+	     });
+
+      /* Meanwhile, read the next chunk from the target.  Copying the
+	 trailing PATTERN_LEN - 1 bytes of SEARCH_BUF only reads it,
+	 which is safe alongside the scan.  */
+
+      /* Don't let next_space_len wrap here, it's unsigned.  */
+      ULONGEST next_space_len;
       if (search_space_len >= chunk_size)
-	search_space_len -= chunk_size;
+	next_space_len = search_space_len - chunk_size;
       else
-	search_space_len = 0;
+	next_space_len = 0;
 
-      if (search_space_len >= pattern_len)
+      bool read_ok = true;
+      CORE_ADDR read_addr = 0;
+      int nr_to_read = 0;
+
+      if (next_space_len >= pattern_len)
 	{
 	  unsigned keep_len = search_buf_size - chunk_size;
-	  CORE_ADDR read_addr = start_addr + chunk_size + keep_len;
-	  int nr_to_read;
+
+	  read_addr = start_addr + chunk_size + keep_len;
 
 	  /* Copy the trailing part of the previous iteration to the front
 	     of the buffer for the next iteration.  */
 	  gdb_assert (keep_len == pattern_len - 1);
 	  if (keep_len > 0)
-	    memcpy (&search_buf[0], &search_buf[chunk_size], keep_len);
+	    memcpy (&next_buf[0], &search_buf[chunk_size], keep_len);
 
-	  nr_to_read = std::min (search_space_len - keep_len,
+	  nr_to_read = std::min (next_space_len - keep_len,
 				 (ULONGEST) chunk_size);
 
-	  if (!read_memory (read_addr, &search_buf[keep_len], nr_to_read))
+	  read_ok = read_memory (read_addr, &next_buf[keep_len], nr_to_read);
+	}
+
+      scan_done.wait ();
+
+      /* A match in this chunk wins over a failure to read the chunk
+	 after it, as it did when the search was serial.  */
+      if (found_ptr != NULL)
+	{
+	  CORE_ADDR found_addr = start_addr + (found_ptr - search_buf.data ());
+
+	  *found_addrp = found_addr;
+	  return 1;
+	}
+
+      /* Not found in this chunk, skip to next chunk.  */
+
+      search_space_len = next_space_len;
+
+      if (next_space_len >= pattern_len)
+	{
+	  if (!read_ok)
 	    {
 	      warning (_("Unable to access %s bytes of target "
 			 "memory at %s, halting search."),
@@ -110,6 +147,7 @@ simple_search_memory
 	      return -1;
 	    }
 
+	  std::swap (search_buf, next_buf);
 	  start_addr += chunk_size;
 	}
     }
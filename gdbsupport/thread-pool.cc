@@ -19,6 +19,10 @@
 
 #include "common-defs.h"
 #include "gdbsupport/thread-pool.h"
+#include "gdbsupport/filestuff.h"
+#ifdef HAVE_SCHED_H
+#include <sched.h>
+#endif
 
 #if CXX_STD_THREAD
 
@@ -163,9 +167,13 @@ thread_pool::set_thread_count (size_t num_threads)
       block_signals blocker;
       for (size_t i = m_thread_count; i < num_threads; ++i)
 	{
+	  /* Queues of previously terminated threads are reused.  */
+	  if (i == m_queues.size ())
+	    m_queues.emplace_back (new worker_queue);
 	  try
 	    {
-	      std::thread thread (&thread_pool::thread_function, this);
+	      std::thread thread (&thread_pool::thread_function, this,
+				  m_queues[i].get ());
 	      thread.detach ();
 	    }
 	  catch (const std::system_error &)
@@ -182,7 +190,10 @@ thread_pool::set_thread_count (size_t num_threads)
   if (num_threads < m_thread_count)
     {
       for (size_t i = num_threads; i < m_thread_count; ++i)
-	m_tasks.emplace ();
+	{
+	  std::lock_guard<std::mutex> qguard (m_queues[i]->mutex);
+	  m_queues[i]->tasks.emplace_back ();
+	}
       m_tasks_cv.notify_all ();
     }
 
@@ -195,25 +206,38 @@ thread_pool::set_thread_count (size_t num_threads)
 #if CXX_STD_THREAD
 
 void
-thread_pool::do_post_task (std::packaged_task<void ()> &&func)
+thread_pool::do_post_task (std::packaged_task<void ()> &&func,
+			   task_priority priority)
 {
   std::packaged_task<void ()> t (std::move (func));
 
-  if (m_thread_count != 0)
-    {
-      std::lock_guard<std::mutex> guard (m_tasks_mutex);
-      m_tasks.emplace (std::move (t));
-      m_tasks_cv.notify_one ();
-    }
-  else
-    {
-      /* Just execute it now.  */
-      t ();
-    }
+  {
+    std::lock_guard<std::mutex> guard (m_tasks_mutex);
+
+    if (m_thread_count != 0)
+      {
+	worker_queue *queue
+	  = m_queues[m_next_queue++ % m_thread_count].get ();
+
+	{
+	  std::lock_guard<std::mutex> qguard (queue->mutex);
+	  if (priority == task_priority::high)
+	    queue->tasks.emplace_front (std::move (t));
+	  else
+	    queue->tasks.emplace_back (std::move (t));
+	}
+
+	m_tasks_cv.notify_one ();
+	return;
+      }
+  }
+
+  /* Just execute it now.  */
+  t ();
 }
 
 void
-thread_pool::thread_function ()
+thread_pool::thread_function (worker_queue *queue)
 {
   /* This must be done here, because on macOS one can only set the
      name of the current thread.  */
@@ -225,18 +249,76 @@ thread_pool::thread_function ()
 
   while (true)
     {
+      /* An empty optional in a queue is the request for the queue's
+	 owner to terminate; FOUND tells "popped such a request" apart
+	 from "found no task at all".  We want to hold a queue's lock
+	 while examining it, but not while invoking the task
+	 function.  */
+      bool found = false;
       optional<task_t> t;
 
+      /* Our own queue first.  This is the common case and only takes
+	 the queue's own lock.  */
       {
-	/* We want to hold the lock while examining the task list, but
-	   not while invoking the task function.  */
-	std::unique_lock<std::mutex> guard (m_tasks_mutex);
-	while (m_tasks.empty ())
-	  m_tasks_cv.wait (guard);
-	t = std::move (m_tasks.front());
-	m_tasks.pop ();
+	std::lock_guard<std::mutex> guard (queue->mutex);
+	if (!queue->tasks.empty ())
+	  {
+	    t = std::move (queue->tasks.front ());
+	    queue->tasks.pop_front ();
+	    found = true;
+	  }
       }
 
+      if (!found)
+	{
+	  /* Nothing of our own, so try to steal a task from another
+	     worker, and failing that, sleep until a task is posted.
+	     m_tasks_mutex protects the shape of m_queues, and holding
+	     it from before the last look at the queues until the wait
+	     starts ensures the notification of a new task is not
+	     missed.  */
+	  std::unique_lock<std::mutex> guard (m_tasks_mutex);
+	  while (!found)
+	    {
+	      /* Check our own queue again: a task may have been
+		 posted to it while we were taking m_tasks_mutex or
+		 waiting.  */
+	      {
+		std::lock_guard<std::mutex> qguard (queue->mutex);
+		if (!queue->tasks.empty ())
+		  {
+		    t = std::move (queue->tasks.front ());
+		    queue->tasks.pop_front ();
+		    found = true;
+		    break;
+		  }
+	      }
+
+	      /* Steal from the front of another queue, so that a
+		 high-priority task posted there runs as early as
+		 possible.  A terminate request is never stolen -- it
+		 is addressed to the queue's owner.  */
+	      for (const auto &other : m_queues)
+		{
+		  if (other.get () == queue)
+		    continue;
+
+		  std::lock_guard<std::mutex> qguard (other->mutex);
+		  if (!other->tasks.empty ()
+		      && other->tasks.front ().has_value ())
+		    {
+		      t = std::move (other->tasks.front ());
+		      other->tasks.pop_front ();
+		      found = true;
+		      break;
+		    }
+		}
+
+	      if (!found)
+		m_tasks_cv.wait (guard);
+	    }
+	}
+
       if (!t.has_value ())
 	break;
       (*t) ();
@@ -245,4 +327,76 @@ thread_pool::thread_function ()
 
 #endif /* CXX_STD_THREAD */
 
+#ifdef __linux__
+
+/* Return the number of CPUs a cgroup CPU bandwidth quota amounts to,
+   rounded up, or 0 if no quota is in effect (or none could be read).
+   Try the cgroup v2 interface first, then v1.  Inside a container the
+   quota, not the hardware, determines how many workers can actually
+   make progress.  */
+
+static size_t
+cgroup_cpu_limit ()
+{
+  long long quota, period;
+
+  /* cgroup v2: "$MAX $PERIOD", where $MAX is "max" when unlimited
+     (on which the scan fails).  */
+  gdb_file_up file = gdb_fopen_cloexec ("/sys/fs/cgroup/cpu.max", "r");
+  if (file != nullptr)
+    {
+      if (fscanf (file.get (), "%lld %lld", &quota, &period) == 2
+	  && quota > 0 && period > 0)
+	return (quota + period - 1) / period;
+      return 0;
+    }
+
+  /* cgroup v1: quota and period in separate files, quota -1 when
+     unlimited.  */
+  file = gdb_fopen_cloexec ("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", "r");
+  gdb_file_up period_file
+    = gdb_fopen_cloexec ("/sys/fs/cgroup/cpu/cpu.cfs_period_us", "r");
+  if (file != nullptr && period_file != nullptr
+      && fscanf (file.get (), "%lld", &quota) == 1
+      && fscanf (period_file.get (), "%lld", &period) == 1
+      && quota > 0 && period > 0)
+    return (quota + period - 1) / period;
+
+  return 0;
+}
+
+#endif /* __linux__ */
+
+/* See thread-pool.h.  */
+
+size_t
+default_thread_count ()
+{
+#if CXX_STD_THREAD
+  size_t n_threads = std::thread::hardware_concurrency ();
+
+#if defined (HAVE_SCHED_H) && defined (CPU_COUNT)
+  /* The affinity mask can restrict us to fewer CPUs than the machine
+     has (taskset, cpusets).  */
+  cpu_set_t mask;
+  if (sched_getaffinity (0, sizeof (mask), &mask) == 0)
+    {
+      int n_affine = CPU_COUNT (&mask);
+      if (n_affine > 0 && (size_t) n_affine < n_threads)
+	n_threads = n_affine;
+    }
+#endif
+
+#ifdef __linux__
+  size_t limit = cgroup_cpu_limit ();
+  if (limit > 0 && limit < n_threads)
+    n_threads = limit;
+#endif
+
+  return n_threads;
+#else
+  return 0;
+#endif /* CXX_STD_THREAD */
+}
+
 } /* namespace gdb */
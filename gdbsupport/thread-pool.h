@@ -20,7 +20,8 @@
 #ifndef GDBSUPPORT_THREAD_POOL_H
 #define GDBSUPPORT_THREAD_POOL_H
 
-#include <queue>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <functional>
 #include <chrono>
@@ -118,6 +119,19 @@ public:
 #endif /* CXX_STD_THREAD */
 
 
+/* The priority of a task.  A high-priority task runs before any
+   normal-priority task that is still queued; tasks of equal priority
+   run approximately in posting order.  Bulk work whose completion
+   nothing is waiting on -- background DWARF indexing, say -- should
+   use the default, so that tasks a user-visible command is blocked on
+   do not have to wait behind it.  */
+
+enum class task_priority
+{
+  normal,
+  high,
+};
+
 /* A thread pool.
 
    There is a single global thread pool, see g_thread_pool.  Tasks can
@@ -148,12 +162,13 @@ public:
 
   /* Post a task to the thread pool.  A future is returned, which can
      be used to wait for the result.  */
-  future<void> post_task (std::function<void ()> &&func)
+  future<void> post_task (std::function<void ()> &&func,
+			  task_priority priority = task_priority::normal)
   {
 #if CXX_STD_THREAD
     std::packaged_task<void ()> task (std::move (func));
     future<void> result = task.get_future ();
-    do_post_task (std::packaged_task<void ()> (std::move (task)));
+    do_post_task (std::packaged_task<void ()> (std::move (task)), priority);
     return result;
 #else
     func ();
@@ -164,12 +179,13 @@ public:
   /* Post a task to the thread pool.  A future is returned, which can
      be used to wait for the result.  */
   template<typename T>
-  future<T> post_task (std::function<T ()> &&func)
+  future<T> post_task (std::function<T ()> &&func,
+		       task_priority priority = task_priority::normal)
   {
 #if CXX_STD_THREAD
     std::packaged_task<T ()> task (std::move (func));
     future<T> result = task.get_future ();
-    do_post_task (std::packaged_task<void ()> (std::move (task)));
+    do_post_task (std::packaged_task<void ()> (std::move (task)), priority);
     return result;
 #else
     return future<T> (func ());
@@ -181,32 +197,63 @@ private:
   thread_pool () = default;
 
 #if CXX_STD_THREAD
-  /* The callback for each worker thread.  */
-  void thread_function ();
+  /* A convenience typedef for the type of a task.  */
+  typedef std::packaged_task<void ()> task_t;
+
+  /* The queue of one worker thread, with the mutex that protects it.
+     Giving every worker its own queue and lock keeps threads posting
+     and taking fine-grained tasks from funneling through a single
+     mutex.  An optional is used to represent a task.  If the optional
+     is empty, then this means that the thread owning the queue should
+     terminate.  If the optional is non-empty, then it is an actual
+     task to evaluate.  High-priority tasks are pushed at the front of
+     the deque, all others at the back; tasks are taken from the
+     front.  */
+  struct worker_queue
+  {
+    std::mutex mutex;
+    std::deque<optional<task_t>> tasks;
+  };
+
+  /* The callback for each worker thread.  QUEUE is the queue the
+     thread owns; the thread prefers tasks from it, and only the
+     owning thread may take a terminate request from it.  */
+  void thread_function (worker_queue *queue);
 
   /* Post a task to the thread pool.  A future is returned, which can
      be used to wait for the result.  */
-  void do_post_task (std::packaged_task<void ()> &&func);
+  void do_post_task (std::packaged_task<void ()> &&func,
+		     task_priority priority);
 
   /* The current thread count.  */
   size_t m_thread_count = 0;
 
-  /* A convenience typedef for the type of a task.  */
-  typedef std::packaged_task<void ()> task_t;
+  /* One queue per worker thread, the worker owning queue I being the
+     Ith thread started.  The vector never shrinks, so that an idle
+     worker can steal the leftover tasks of a terminated one; only its
+     first M_THREAD_COUNT queues receive new tasks.  The vector's
+     shape is protected by m_tasks_mutex.  */
+  std::vector<std::unique_ptr<worker_queue>> m_queues;
 
-  /* The tasks that have not been processed yet.  An optional is used
-     to represent a task.  If the optional is empty, then this means
-     that the receiving thread should terminate.  If the optional is
-     non-empty, then it is an actual task to evaluate.  */
-  std::queue<optional<task_t>> m_tasks;
+  /* The queue that do_post_task will use next.  Tasks are distributed
+     round-robin.  */
+  size_t m_next_queue = 0;
 
-  /* A condition variable and mutex that are used for communication
-     between the main thread and the worker threads.  */
+  /* A condition variable and mutex that are used to wake idle worker
+     threads.  */
   std::condition_variable m_tasks_cv;
   std::mutex m_tasks_mutex;
 #endif /* CXX_STD_THREAD */
 };
 
+/* Return the number of worker threads that the pool should use by
+   default: the hardware concurrency, reduced to the number of CPUs
+   actually available to this process when the host can tell us --
+   the CPU affinity mask, and any cgroup CPU bandwidth quota, on
+   GNU/Linux.  */
+
+extern size_t default_thread_count ();
+
 }
 
 #endif /* GDBSUPPORT_THREAD_POOL_H */